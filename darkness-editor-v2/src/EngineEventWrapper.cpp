@@ -25,6 +25,9 @@ namespace editor
 		canMove(ui::AllowedMovement::None);
 		forceRootFrame(true, parent->api());
 		drawBackground(false);
+
+		// the engine output changes every frame
+		retained(false);
 		//backgroundColor({ 1.0f, 0.0f, 0.0f });
 		
 #ifdef ENGINE_ENABLED
@@ -36,6 +36,7 @@ namespace engine
         Property m_meshPath;
         Property m_meshIndex;
         engine::shared_ptr<engine::SubMeshInstance> m_mesh;
+        engine::shared_ptr<engine::MeshRequest> m_meshRequest;
 
         MeshBuffers m_meshBuffers;
         
@@ -107,6 +108,12 @@ namespace engine
             return m_meshBuffers;
         }
 
+        // the mesh file is still being read. nullptr once it is in
+        engine::shared_ptr<engine::MeshRequest> meshRequest() const
+        {
+            return m_mesh ? nullptr : m_meshRequest;
+        }
+
         /*const SubMesh& subMesh() const
         {
             return m_mesh->subMeshes()[m_meshIndex.value<int>()];
@@ -137,10 +144,11 @@ namespace engine
                     bool foundFile = fileExists(meshPathStr);
                     if (foundFile)
                     {
-                        m_mesh = device.createMesh(
+                        // the file is read on the streaming thread
+                        m_mesh = nullptr;
+                        m_meshRequest = device.requestMesh(
                             tools::hash(pathClean(meshPathStr)),
-                            meshPathStr,
-                            static_cast<uint32_t>(m_meshIndex.value<int>()));
+                            meshPathStr);
                         m_gpuDirty = true;
                     }
                     else
@@ -152,7 +160,19 @@ namespace engine
         bool gpuRefresh(Device& device)
         {
             bool change = false;
-            if(m_gpuDirty)
+
+            if (m_meshRequest && !m_mesh && (m_meshRequest->ready() || m_meshRequest->failed()))
+            {
+                // nullptr when the read failed or the file has no such submesh
+                m_mesh = device.createMesh(*m_meshRequest, static_cast<uint32_t>(m_meshIndex.value<int>()));
+                if (!m_mesh)
+                    m_meshRequest = nullptr;
+            }
+
+            // the mesh is still being read or its uploads are in flight.
+            // try again on the next refresh
+            bool meshRead = !m_meshRequest || m_mesh;
+            if(m_gpuDirty && meshRead && (!m_mesh || m_mesh->resident()))
             {
                 m_gpuDirty = false;
                 change = true;
@@ -14,6 +14,7 @@
 #include "engine/rendering/ImguiRenderer.h"
 #include "engine/rendering/DebugView.h"
 #include "engine/rendering/LogWindow.h"
+#include "engine/rendering/culling/OcclusionBuffer.h"
 #include "engine/rendering/ViewportRenderer.h"
 #include "engine/rendering/DebugMenu.h"
 #include "engine/RenderSetup.h"
@@ -153,6 +154,7 @@ private:
 
     engine::unique_ptr<engine::MaterialComponent> m_defaultMaterial;
     engine::shared_ptr<engine::LightData> m_lightData;
+    engine::shared_ptr<engine::OcclusionBuffer> m_occlusionBuffer;
 
     bool render();
     void clear(engine::CommandList& cmd);
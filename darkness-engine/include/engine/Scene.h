@@ -73,6 +73,7 @@ namespace engine
     };
 
     class LightData;
+    class OcclusionBuffer;
     struct FlatScene
     {
         engine::vector<FlatSceneNode> nodes;
@@ -93,6 +94,9 @@ namespace engine
 
         engine::shared_ptr<LightData> lightData;
 
+        // rendered from the culling camera after the camera update
+        engine::shared_ptr<OcclusionBuffer> occlusion;
+
         bool refreshed = false;
         int64_t selectedObject;
         void clear()
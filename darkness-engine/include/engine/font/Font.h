@@ -2,38 +2,50 @@
 
 #include "containers/string.h"
 #include "containers/unordered_map.h"
+#include "containers/memory.h"
+#include "containers/vector.h"
+#include "engine/font/GlyphAtlas.h"
 #include "engine/primitives/Vector2.h"
 #include "engine/graphics/Resources.h"
 #include "tools/RingBuffer.h"
+#include "tools/JobSystem.h"
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
 
+#include <cstdint>
+#include <mutex>
+
 namespace engine
 {
-	class FontAtlas;
 	class Device;
+	class TextLayoutCache;
 
 	class Font
 	{
 	public:
-		Font(Device& device, FT_Library library, const engine::string& fontPath);
+		Font(Device& device, FT_Library library, const engine::string& fontPath, JobSystem& jobs = JobSystem::instance());
 
 		void freeTemporaryAllocations();
 	private:
 		int pointSizeFromPixel(float pixelSize);
-		int validGlyphCount();
-		Vector2<int> maxGlyphSize();
-		void createAtlasWithInitialSize(const engine::Vector2<int>& maxGlyphSize, int validGlyphCount);
-		void loadGlyphsToAtlas();
 		void createAtlasWithFontSize(float pixelHeight);
 
 	public:
 		~Font();
 
+		// first atlas page
 		TextureSRV fontAtlas();
 
+		// rasterizes the glyphs of characters as a job. they are
+		// uploaded when a string first uses them
+		void prefetch(const engine::string& characters);
+
+		// strings are utf-8. a byte that doesn't start a valid sequence is
+		// taken as a latin-1 character. advances index past the character
+		static uint32_t decodeUtf8(const char* text, size_t length, size_t& index);
+
 	public:
 		struct GlyphRenderNodeData
 		{
@@ -50,26 +62,98 @@ namespace engine
 			int nodeCount;
 		};
 
-		GlyphRenderData renderText(const engine::string& text);
+		// one run per atlas page the string uses. a run has one node per
+		// codepoint, which is less than the byte count for non ascii text
+		engine::vector<GlyphRenderData> renderText(const engine::string& text);
+
+		// lays out many null terminated strings at once. the runs of text i
+		// are runs[firstRun[i]] .. runs[firstRun[i + 1]]. the nodes are valid
+		// until freeTemporaryAllocations
+		void renderTexts(
+			const char* const* texts,
+			size_t count,
+			engine::vector<GlyphRenderData>& runs,
+			engine::vector<uint32_t>& firstRun);
+
+		const TextLayoutCache& layoutCache() const { return *m_layoutCache; }
 
 	private:
 		Device& m_device;
 		FT_Face m_face;
-		engine::shared_ptr<FontAtlas> m_atlas;
+		engine::unique_ptr<GlyphAtlas> m_atlas;
+		float m_pixelHeight;
+		int m_baseline;
+
+		// glyphs are rasterized and uploaded on first use. the ones that
+		// haven't been used for a while give their cell to new glyphs
+		// when the atlas is out of pages
+		enum class GlyphState : uint8_t
+		{
+			Unknown,
+			Empty,
+			Resident
+		};
 
 		struct GlyphStore
 		{
-			int x;
-			int y;
+			GlyphState state;
+			GlyphAtlas::Cell cell;
 			int width;
 			int height;
-			int cellHeight;
 			int xAdvance;
 			int brearingX;
 			int bitmapTop;
-			bool validBitmap;
+			uint64_t lastUsed;
 		};
-		engine::unordered_map<unsigned long, GlyphStore> m_glyphs;
+
+		struct RasterizedGlyph
+		{
+			int width;
+			int height;
+			int xAdvance;
+			int brearingX;
+			int bitmapTop;
+			engine::vector<uint8_t> bitmap;
+			bool ready;
+		};
+
+		// ascii and latin-1 codepoints index these directly. the nodes are
+		// positioned at pen 0 and normalized to the page size
+		static constexpr uint32_t GlyphTableSize = 256;
+		GlyphStore m_glyphs[GlyphTableSize];
+		GlyphRenderNodeData m_glyphNodes[GlyphTableSize];
+		float m_glyphAdvances[GlyphTableSize];
+
+		// every codepoint past the table
+		struct ExtendedGlyph
+		{
+			GlyphStore store;
+			GlyphRenderNodeData node;
+			float advance;
+		};
+		engine::unordered_map<uint32_t, ExtendedGlyph> m_extendedGlyphs;
+		uint64_t m_frame;
+
+		GlyphStore& glyphStore(uint32_t codepoint);
+		GlyphRenderNodeData& glyphNode(uint32_t codepoint);
+		float& glyphAdvance(uint32_t codepoint);
+
+		void rasterizeGlyph(uint32_t codepoint, RasterizedGlyph& glyph);
+		bool takePrefetched(uint32_t codepoint, RasterizedGlyph& glyph);
+		void makeResident(const engine::vector<uint32_t>& codepoints);
+		bool evictGlyph();
+		void updateGlyphNode(uint32_t codepoint);
+
+		// freetype faces aren't thread safe
+		std::mutex m_faceMutex;
+		std::mutex m_prefetchMutex;
+		JobGroup m_prefetchJobs;
+		engine::unordered_map<uint32_t, RasterizedGlyph> m_prefetched;
+
+		void layoutText(const char* text, size_t length, GlyphRenderNodeData* nodes);
+		const engine::vector<GlyphRenderNodeData>& cachedLayout(const char* text, size_t length, size_t glyphCount);
+		engine::unique_ptr<TextLayoutCache> m_layoutCache;
+
 		engine::vector<GlyphRenderNodeData> m_renderNodeData;
 		tools::RingBuffer m_ringBuffer;
 		engine::vector<tools::RingBuffer::AllocStruct> m_allocations;
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "engine/font/FontAtlas.h"
+#include "containers/vector.h"
+#include "containers/memory.h"
+
+namespace engine
+{
+	// glyph cells spread over fixed size atlas pages.
+	//
+	// there is always at least one page. every page has the same size so
+	// normalized uvs stay valid for the lifetime of a glyph. pages are
+	// created when the existing ones are full, up to maxPages. after that
+	// the owner has to free cells.
+	class GlyphAtlas
+	{
+	public:
+		GlyphAtlas(
+			Device& device,
+			int cellWidth,
+			int cellHeight,
+			int pageSize = 512,
+			int maxPages = 4);
+
+		struct Cell
+		{
+			int page;
+			AtlasAllocator::AtlasAllocation allocation;
+		};
+
+		// false when all pages are full and at the page limit.
+		// force goes over the limit
+		bool allocate(Cell& cell, bool force = false);
+		void free(const Cell& cell);
+
+		int pageSize() const { return m_pageSize; }
+		int cellWidth() const { return m_cellWidth; }
+		int cellHeight() const { return m_cellHeight; }
+
+		size_t pageCount() const { return m_pages.size(); }
+		TextureSRV page(size_t index);
+
+	private:
+		Device& m_device;
+		int m_cellWidth;
+		int m_cellHeight;
+		int m_pageSize;
+		int m_maxPages;
+		engine::vector<engine::shared_ptr<FontAtlas>> m_pages;
+		void addPage();
+	};
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "engine/font/Font.h"
+#include "containers/vector.h"
+#include "containers/string.h"
+#include "containers/unordered_map.h"
+#include <cstdint>
+
+namespace engine
+{
+	// glyph runs of strings that have been laid out before.
+	//
+	// runs are kept in least recently used order. the oldest ones are
+	// evicted when either the run count or the total glyph count goes
+	// over its limit.
+	class TextLayoutCache
+	{
+	public:
+		struct Key
+		{
+			const Font* font;
+			float pixelHeight;
+			uint64_t hash;
+
+			bool operator==(const Key& key) const
+			{
+				return font == key.font && pixelHeight == key.pixelHeight && hash == key.hash;
+			}
+		};
+
+		TextLayoutCache(size_t maxRuns = 4096, size_t maxGlyphs = 256 * 1024);
+
+		static uint64_t hash(const char* text, size_t length);
+
+		// nullptr when the run isn't cached
+		const engine::vector<Font::GlyphRenderNodeData>* find(const Key& key, const char* text, size_t length);
+
+		// returns the run of glyphCount nodes to fill. may evict older runs
+		engine::vector<Font::GlyphRenderNodeData>& insert(const Key& key, const char* text, size_t length, size_t glyphCount);
+
+		void clear();
+
+		size_t runCount() const { return m_lookup.size(); }
+		size_t glyphCount() const { return m_glyphs; }
+
+		size_t hits() const { return m_hits; }
+		size_t misses() const { return m_misses; }
+
+	private:
+		static constexpr uint32_t InvalidRun = 0xffffffff;
+
+		struct KeyHasher
+		{
+			size_t operator()(const Key& key) const
+			{
+				return static_cast<size_t>(key.hash ^ (reinterpret_cast<uintptr_t>(key.font) >> 4));
+			}
+		};
+
+		struct Run
+		{
+			Key key;
+			engine::string text;
+			engine::vector<Font::GlyphRenderNodeData> nodes;
+			uint32_t previous;
+			uint32_t next;
+		};
+
+		size_t m_maxRuns;
+		size_t m_maxGlyphs;
+		size_t m_glyphs;
+
+		engine::vector<Run> m_runs;
+		engine::vector<uint32_t> m_freeRuns;
+		engine::unordered_map<Key, uint32_t, KeyHasher> m_lookup;
+
+		// most and least recently used
+		uint32_t m_head;
+		uint32_t m_tail;
+
+		size_t m_hits;
+		size_t m_misses;
+
+		void unlink(uint32_t run);
+		void pushFront(uint32_t run);
+		void evict(uint32_t run);
+	};
+}
@@ -45,6 +45,7 @@ namespace engine
     struct Rectangle;
     struct CorePipelines;
     struct QueryResultTicks;
+    struct TransitionStatistics;
 
     struct ShaderDebugOutput
     {
@@ -286,6 +287,7 @@ namespace engine
         friend class Device;
         friend class implementation::DeviceImplDX12;
         friend class implementation::DeviceImplVulkan;
+        friend class implementation::DeviceImplNull;
         CommandList(const Device& device, const char* name, CommandListType type = CommandListType::Direct, GraphicsApi api = GraphicsApi::DX12);
         CommandList(implementation::CommandListImplIf* impl, const Device& device, const char* name, CommandListType type = CommandListType::Direct, GraphicsApi api = GraphicsApi::DX12);
 
@@ -297,6 +299,15 @@ namespace engine
         
         void savePipeline(shaders::PipelineConfiguration* configuration);
 
+        // transitions the subresources a binding covers. promoteCommon sets
+        // common state subresources directly without a barrier
+        void transitionBinding(
+            Texture texture,
+            const SubResource& subResource,
+            ResourceState state,
+            bool promoteCommon,
+            TransitionStatistics& statistics);
+
         void transitionCommonSRV(TextureSRV srv, ResourceState state);
         void transitionCommonUAV(TextureUAV uav, ResourceState state);
     private:
@@ -7,7 +7,8 @@ namespace engine
     enum class GraphicsApi
     {
         DX12,
-        Vulkan
+        Vulkan,
+        Null
     };
 
     enum class ResourceState
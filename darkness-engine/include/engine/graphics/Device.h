@@ -66,6 +66,7 @@
 
 #include <queue>
 #include <mutex>
+#include <atomic>
 
 namespace platform
 {
@@ -240,6 +241,26 @@ namespace engine
         engine::shared_ptr<BufferMath> bufferMath;
     };
 
+    // resource state transitions of one frame
+    struct TransitionStatistics
+    {
+        uint32_t requested = 0;     // transitions pipeline bindings asked for
+        uint32_t skipped = 0;       // already in the requested state
+        uint32_t wholeResource = 0; // done as one whole resource transition
+        uint32_t barriers = 0;      // barriers recorded to command lists
+        uint32_t flushes = 0;       // batched barrier calls
+    };
+
+    // command lists are recorded from several threads so these are atomic
+    struct TransitionCounters
+    {
+        std::atomic<uint32_t> requested{ 0 };
+        std::atomic<uint32_t> skipped{ 0 };
+        std::atomic<uint32_t> wholeResource{ 0 };
+        std::atomic<uint32_t> barriers{ 0 };
+        std::atomic<uint32_t> flushes{ 0 };
+    };
+
     class Device
     {
     public:
@@ -351,6 +372,11 @@ namespace engine
         void uploadBuffer(CommandList& commandList, BufferIBV buffer, const tools::ByteRange& data, uint32_t startElement = 0);
         void uploadBuffer(CommandList& commandList, BufferVBV buffer, const tools::ByteRange& data, uint32_t startElement = 0);
 
+        // reserved buffers get memory page by page without moving.
+        // committing is queued on the graphics queue and does not wait for the gpu
+        bool reservedBuffersSupported() const;
+        void commitBuffer(Buffer buffer, size_t bytes);
+
         template<typename T>
         Pipeline<T> createPipeline()
         {
@@ -360,6 +386,12 @@ namespace engine
         uint64_t frameNumber() const;
         void frameNumber(uint64_t frame);
 
+        // counters of the frame being recorded
+        TransitionCounters& transitionCounters() const { return m_transitionCounters; }
+
+        // counters of the last presented frame
+        const TransitionStatistics& transitionStatistics() const { return m_transitionStatistics; }
+
         void processCommandLists(bool fetchQueryResults);
 
         engine::vector<engine::vector<QueryResultTicks>> fetchQueryResults();
@@ -391,11 +423,22 @@ namespace engine
             int mips = -1,
 			image::ImageType imageType = image::ImageType::DDS);
 
+        // does not block, nullptr until the mesh has streamed in
         engine::shared_ptr<SubMeshInstance> createMesh(
             ResourceKey key,
             const engine::string& filename,
             uint32_t meshIndex);
 
+        // asynchronous mesh loading, see ResourceCache::requestMesh
+        engine::shared_ptr<MeshRequest> requestMesh(
+            ResourceKey key,
+            const engine::string& filename,
+            ResidencyPriority priority = ResidencyPriority::Visible);
+        engine::shared_ptr<SubMeshInstance> createMesh(
+            MeshRequest& request,
+            uint32_t meshIndex);
+        void streamMeshes();
+
         Fence createFence(const char* name) const;
         Semaphore createSemaphore() const;
 
@@ -467,6 +510,8 @@ namespace engine
         Fence m_submitCopyQueueFence;
         Fence m_frameFence;
         uint64_t m_frameNumber;
+        mutable TransitionCounters m_transitionCounters;
+        TransitionStatistics m_transitionStatistics;
         bool m_waitingForClose;
         bool m_destroy;
         std::unordered_map<CommandListType, engine::vector<uint32_t>> m_listCounts;
@@ -476,11 +521,13 @@ namespace engine
         friend class CommandList;
 		friend class implementation::DeviceImplDX12;
         friend class implementation::DeviceImplVulkan;
+        friend class implementation::DeviceImplNull;
         void returnCommandList(implementation::CommandListImplIf* cmd, CommandListType type, const char* name);
         //engine::shared_ptr<std::map<CommandListType, engine::vector<CommandList>>> m_freeCommandLists;
         //engine::shared_ptr<std::map<CommandListType, engine::vector<CommandList>>> m_inUseCommandLists;
 
         void clearCommandLists();
+        void resolveTransitionStatistics();
         engine::shared_ptr<engine::vector<CommandList>> m_freeCommandListsDirect;
         engine::shared_ptr<engine::vector<CommandList>> m_inUseCommandListsDirect;
         engine::shared_ptr<engine::vector<CommandList>> m_freeCommandListsCopy;
@@ -534,6 +581,7 @@ namespace engine
 
 		friend class implementation::SwapChainImplDX12;
         friend class implementation::SwapChainImplVulkan;
+        friend class implementation::SwapChainImplNull;
 		friend class RenderSetup;
 		void clearReturnedResources() const;
 
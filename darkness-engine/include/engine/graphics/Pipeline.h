@@ -323,6 +323,7 @@ namespace engine
         friend class CommandList;
 
         void configure(implementation::CommandListImplIf* commandList, shaders::PipelineConfiguration* configuration);
+        void prewarm(shaders::PipelineConfiguration* configuration);
 
         void setRenderTargetFormat(Format RTVFormat, Format DSVFormat = Format::UNKNOWN, unsigned int msaaCount = 1, unsigned int msaaQuality = 0);
 
@@ -345,5 +346,9 @@ namespace engine
             GraphicsApi api)
             : PipelineAbs(device, storage, api)
         {}
+
+        // creates the api pipeline of the current permutation ahead of the first bind.
+        // set the permutation options first. see PipelinePrewarm
+        void prewarm() { PipelineAbs::prewarm(this); }
     };
 }
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "tools/JobSystem.h"
+#include <functional>
+
+namespace engine
+{
+    // creates pipelines on the job system workers while the scene loads.
+    //
+    // a job sets the permutation options of one pipeline and calls prewarm()
+    // for each permutation it wants ready. the options are state of the
+    // pipeline object so a pipeline belongs to a single job and must not be
+    // bound before wait() returns.
+    class PipelinePrewarm
+    {
+    public:
+        using Job = std::function<void()>;
+
+        PipelinePrewarm(JobSystem& jobs = JobSystem::instance());
+
+        PipelinePrewarm(const PipelinePrewarm&) = delete;
+        PipelinePrewarm(PipelinePrewarm&&) = delete;
+        PipelinePrewarm& operator=(const PipelinePrewarm&) = delete;
+        PipelinePrewarm& operator=(PipelinePrewarm&&) = delete;
+
+        void add(Job job);
+
+        // blocks until all added jobs have finished
+        void wait();
+
+    private:
+        JobGroup m_group;
+    };
+}
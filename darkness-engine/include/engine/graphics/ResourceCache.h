@@ -3,6 +3,7 @@
 #include "engine/graphics/Resources.h"
 #include "engine/graphics/ResourceOwners.h"
 #include "engine/rendering/Mesh.h"
+#include "engine/rendering/MeshStreaming.h"
 #include "tools/image/Image.h"
 #include <functional>
 #include "containers/unordered_map.h"
@@ -37,12 +38,31 @@ namespace engine
             int mips = -1,
 			image::ImageType imageType = image::ImageType::DDS);
 
+        // does not block. requests the mesh on first use and returns
+        // nullptr until streamMeshes() has made it ready
         engine::shared_ptr<SubMeshInstance> createMesh(
             Device& device,
             ResourceKey key,
             const engine::string& filename,
             uint32_t meshIndex);
 
+        // starts reading the mesh file on the streaming thread.
+        // every key has one request, asking again returns the same one
+        engine::shared_ptr<MeshRequest> requestMesh(
+            ResourceKey key,
+            const engine::string& filename,
+            ResidencyPriority priority);
+
+        // does not block. nullptr until streamMeshes() has made the
+        // request ready or when it failed
+        engine::shared_ptr<SubMeshInstance> createMesh(
+            Device& device,
+            MeshRequest& request,
+            uint32_t meshIndex);
+
+        // issues the uploads of the meshes read so far. once per frame
+        void streamMeshes(Device& device);
+
         template<typename T>
         bool cachedDataExists(ResourceKey key) const;
 
@@ -55,5 +75,10 @@ namespace engine
         engine::unordered_map<ResourceKey, BufferIBVOwner> m_bufferIBV;
         engine::unordered_map<ResourceKey, engine::shared_ptr<image::ImageIf>> m_images;
         engine::unordered_map<ResourceKey, engine::shared_ptr<Mesh>> m_meshes;
+        engine::unordered_map<ResourceKey, engine::shared_ptr<MeshRequest>> m_meshRequests;
+        engine::vector<ResourceKey> m_streamingMeshes;
+        MeshStreamer m_meshStreamer;
+
+        engine::shared_ptr<SubMeshInstance> createInstance(Device& device, Mesh& mesh, uint32_t meshIndex);
     };
 }
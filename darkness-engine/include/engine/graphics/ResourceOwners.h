@@ -29,6 +29,7 @@ namespace engine
 
 		class DeviceImplDX12;
 		class DeviceImplVulkan;
+		class DeviceImplNull;
 	}
 
 	template<typename T>
@@ -80,8 +81,10 @@ namespace engine
 		friend class Device;
 		friend class implementation::DeviceImplDX12;
 		friend class implementation::DeviceImplVulkan;
+		friend class implementation::DeviceImplNull;
 		friend class implementation::SwapChainImplDX12;
 		friend class implementation::SwapChainImplVulkan;
+		friend class implementation::SwapChainImplNull;
 		BufferOwner(
 			engine::shared_ptr<implementation::BufferImplIf> impl,
 			std::function<void(engine::shared_ptr<implementation::BufferImplIf>)> returnImplementation);
@@ -93,6 +96,7 @@ namespace engine
 		friend class BufferVBVOwner;
 		friend class DeviceImplDX12;
 		friend class DeviceImplVulkan;
+		friend class DeviceImplNull;
 		BufferOwner(engine::shared_ptr<implementation::BufferImplIf> implementation,
 					engine::shared_ptr<Returner<implementation::BufferImplIf>> returner);
 
@@ -122,8 +126,10 @@ namespace engine
 		friend class Device;
 		friend class implementation::DeviceImplDX12;
 		friend class implementation::DeviceImplVulkan;
+		friend class implementation::DeviceImplNull;
 		friend class implementation::SwapChainImplDX12;
 		friend class implementation::SwapChainImplVulkan;
+		friend class implementation::SwapChainImplNull;
 		BufferSRVOwner(
 			engine::shared_ptr<implementation::BufferSRVImplIf> impl,
 			std::function<void(engine::shared_ptr<implementation::BufferSRVImplIf>)> returnImplementation,
@@ -158,8 +164,10 @@ namespace engine
 		friend class Device;
 		friend class implementation::DeviceImplDX12;
 		friend class implementation::DeviceImplVulkan;
+		friend class implementation::DeviceImplNull;
 		friend class implementation::SwapChainImplDX12;
 		friend class implementation::SwapChainImplVulkan;
+		friend class implementation::SwapChainImplNull;
 		BufferUAVOwner(
 			engine::shared_ptr<implementation::BufferUAVImplIf> impl,
 			std::function<void(engine::shared_ptr<implementation::BufferUAVImplIf>)> returnImplementation,
@@ -194,8 +202,10 @@ namespace engine
 		friend class Device;
 		friend class implementation::DeviceImplDX12;
 		friend class implementation::DeviceImplVulkan;
+		friend class implementation::DeviceImplNull;
 		friend class implementation::SwapChainImplDX12;
 		friend class implementation::SwapChainImplVulkan;
+		friend class implementation::SwapChainImplNull;
 		BufferIBVOwner(
 			engine::shared_ptr<implementation::BufferIBVImplIf> impl,
 			std::function<void(engine::shared_ptr<implementation::BufferIBVImplIf>)> returnImplementation,
@@ -230,8 +240,10 @@ namespace engine
 		friend class Device;
 		friend class implementation::DeviceImplDX12;
 		friend class implementation::DeviceImplVulkan;
+		friend class implementation::DeviceImplNull;
 		friend class implementation::SwapChainImplDX12;
 		friend class implementation::SwapChainImplVulkan;
+		friend class implementation::SwapChainImplNull;
 		BufferCBVOwner(
 			engine::shared_ptr<implementation::BufferCBVImplIf> impl,
 			std::function<void(engine::shared_ptr<implementation::BufferCBVImplIf>)> returnImplementation,
@@ -266,8 +278,10 @@ namespace engine
 		friend class Device;
 		friend class implementation::DeviceImplDX12;
 		friend class implementation::DeviceImplVulkan;
+		friend class implementation::DeviceImplNull;
 		friend class implementation::SwapChainImplDX12;
 		friend class implementation::SwapChainImplVulkan;
+		friend class implementation::SwapChainImplNull;
 		BufferVBVOwner(
 			engine::shared_ptr<implementation::BufferVBVImplIf> impl,
 			std::function<void(engine::shared_ptr<implementation::BufferVBVImplIf>)> returnImplementation,
@@ -300,12 +314,14 @@ namespace engine
         friend class Device;
         friend class implementation::DeviceImplDX12;
 		friend class implementation::DeviceImplVulkan;
+		friend class implementation::DeviceImplNull;
         BindlessBufferSRVOwner(
             engine::shared_ptr<implementation::BindlessBufferSRVImplIf> impl,
             std::function<void(engine::shared_ptr<implementation::BindlessBufferSRVImplIf>)> returnImplementation);
     private:
         friend class DeviceImplDX12;
 		friend class DeviceImplVulkan;
+		friend class DeviceImplNull;
         BindlessBufferSRVOwner(
             engine::shared_ptr<implementation::BindlessBufferSRVImplIf> implementation,
             engine::shared_ptr<Returner<implementation::BindlessBufferSRVImplIf>> returner);
@@ -334,12 +350,14 @@ namespace engine
         friend class Device;
         friend class implementation::DeviceImplDX12;
 		friend class implementation::DeviceImplVulkan;
+		friend class implementation::DeviceImplNull;
         BindlessBufferUAVOwner(
             engine::shared_ptr<implementation::BindlessBufferUAVImplIf> impl,
             std::function<void(engine::shared_ptr<implementation::BindlessBufferUAVImplIf>)> returnImplementation);
     private:
         friend class DeviceImplDX12;
 		friend class DeviceImplVulkan;
+		friend class DeviceImplNull;
         BindlessBufferUAVOwner(
             engine::shared_ptr<implementation::BindlessBufferUAVImplIf> implementation,
             engine::shared_ptr<Returner<implementation::BindlessBufferUAVImplIf>> returner);
@@ -366,14 +384,17 @@ namespace engine
 		friend class Device;
 		friend class implementation::DeviceImplDX12;
 		friend class implementation::DeviceImplVulkan;
+		friend class implementation::DeviceImplNull;
 		friend class implementation::SwapChainImplDX12;
 		friend class implementation::SwapChainImplVulkan;
+		friend class implementation::SwapChainImplNull;
 		RaytracingAccelerationStructureOwner(
 			engine::shared_ptr<implementation::RaytracingAccelerationStructureImplIf> impl,
 			std::function<void(engine::shared_ptr<implementation::RaytracingAccelerationStructureImplIf>)> returnImplementation);
 	private:
 		friend class DeviceImplDX12;
 		friend class DeviceImplVulkan;
+		friend class DeviceImplNull;
 		RaytracingAccelerationStructureOwner(engine::shared_ptr<implementation::RaytracingAccelerationStructureImplIf> implementation,
 			engine::shared_ptr<Returner<implementation::RaytracingAccelerationStructureImplIf>> returner);
 
@@ -404,8 +425,10 @@ namespace engine
 		friend class Device;
 		friend class implementation::DeviceImplDX12;
 		friend class implementation::DeviceImplVulkan;
+		friend class implementation::DeviceImplNull;
 		friend class implementation::SwapChainImplDX12;
 		friend class implementation::SwapChainImplVulkan;
+		friend class implementation::SwapChainImplNull;
 		TextureOwner(
 			engine::shared_ptr<implementation::TextureImplIf> impl,
 			std::function<void(engine::shared_ptr<implementation::TextureImplIf>)> returnImplementation);
@@ -444,8 +467,10 @@ namespace engine
 		friend class Device;
 		friend class implementation::DeviceImplDX12;
 		friend class implementation::DeviceImplVulkan;
+		friend class implementation::DeviceImplNull;
 		friend class implementation::SwapChainImplDX12;
 		friend class implementation::SwapChainImplVulkan;
+		friend class implementation::SwapChainImplNull;
 		TextureSRVOwner(
 			engine::shared_ptr<implementation::TextureSRVImplIf> impl,
 			std::function<void(engine::shared_ptr<implementation::TextureSRVImplIf>)> returnImplementation,
@@ -480,8 +505,10 @@ namespace engine
 		friend class Device;
 		friend class implementation::DeviceImplDX12;
 		friend class implementation::DeviceImplVulkan;
+		friend class implementation::DeviceImplNull;
 		friend class implementation::SwapChainImplDX12;
 		friend class implementation::SwapChainImplVulkan;
+		friend class implementation::SwapChainImplNull;
 		TextureUAVOwner(
 			engine::shared_ptr<implementation::TextureUAVImplIf> impl,
 			std::function<void(engine::shared_ptr<implementation::TextureUAVImplIf>)> returnImplementation,
@@ -516,8 +543,10 @@ namespace engine
 		friend class Device;
 		friend class implementation::DeviceImplDX12;
 		friend class implementation::DeviceImplVulkan;
+		friend class implementation::DeviceImplNull;
 		friend class implementation::SwapChainImplDX12;
 		friend class implementation::SwapChainImplVulkan;
+		friend class implementation::SwapChainImplNull;
 		TextureDSVOwner(
 			engine::shared_ptr<implementation::TextureDSVImplIf> impl,
 			std::function<void(engine::shared_ptr<implementation::TextureDSVImplIf>)> returnImplementation,
@@ -552,8 +581,10 @@ namespace engine
 		friend class Device;
 		friend class implementation::DeviceImplDX12;
 		friend class implementation::DeviceImplVulkan;
+		friend class implementation::DeviceImplNull;
 		friend class implementation::SwapChainImplDX12;
 		friend class implementation::SwapChainImplVulkan;
+		friend class implementation::SwapChainImplNull;
 		TextureRTVOwner(
 			engine::shared_ptr<implementation::TextureRTVImplIf> impl,
 			std::function<void(engine::shared_ptr<implementation::TextureRTVImplIf>)> returnImplementation,
@@ -586,6 +617,7 @@ namespace engine
         friend class Device;
         friend class implementation::DeviceImplDX12;
 		friend class implementation::DeviceImplVulkan;
+		friend class implementation::DeviceImplNull;
         BindlessTextureSRVOwner(
             engine::shared_ptr<implementation::BindlessTextureSRVImplIf> impl,
             std::function<void(engine::shared_ptr<implementation::BindlessTextureSRVImplIf>)> returnImplementation);
@@ -593,6 +625,7 @@ namespace engine
     private:
         friend class DeviceImplDX12;
 		friend class DeviceImplVulkan;
+		friend class DeviceImplNull;
         BindlessTextureSRVOwner(
             engine::shared_ptr<implementation::BindlessTextureSRVImplIf> implementation,
             engine::shared_ptr<Returner<implementation::BindlessTextureSRVImplIf>> returner);
@@ -621,12 +654,14 @@ namespace engine
         friend class Device;
         friend class implementation::DeviceImplDX12;
 		friend class implementation::DeviceImplVulkan;
+		friend class implementation::DeviceImplNull;
         BindlessTextureUAVOwner(
             engine::shared_ptr<implementation::BindlessTextureUAVImplIf> impl,
             std::function<void(engine::shared_ptr<implementation::BindlessTextureUAVImplIf>)> returnImplementation);
     private:
         friend class DeviceImplDX12;
 		friend class DeviceImplVulkan;
+		friend class DeviceImplNull;
         BindlessTextureUAVOwner(
             engine::shared_ptr<implementation::BindlessTextureUAVImplIf> implementation,
             engine::shared_ptr<Returner<implementation::BindlessTextureUAVImplIf>> returner);
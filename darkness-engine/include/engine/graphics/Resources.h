@@ -42,84 +42,118 @@ namespace engine
     {
         class SwapChainImplDX12;
         class SwapChainImplVulkan;
+        class SwapChainImplNull;
         class DeviceImplDX12;
         class DeviceImplVulkan;
+        class DeviceImplNull;
         class BarrierImplDX12;
         class BarrierImplVulkan;
+        class BarrierImplNull;
         class CommandListImplDX12;
         class CommandListImplVulkan;
+        class CommandListImplNull;
         class PipelineImplDX12;
         class PipelineImplVulkan;
+        class PipelineImplNull;
         class DescriptorHeapImplDX12;
         class DescriptorHeapImplVulkan;
 
         class BufferSRVImplDX12;
         class BufferSRVImplVulkan;
+        class BufferSRVImplNull;
         class BufferUAVImplDX12;
         class BufferUAVImplVulkan;
+        class BufferUAVImplNull;
         class BufferIBVImplDX12;
         class BufferIBVImplVulkan;
+        class BufferIBVImplNull;
         class BufferVBVImplDX12;
         class BufferVBVImplVulkan;
+        class BufferVBVImplNull;
         class BufferCBVImplDX12;
         class BufferCBVImplVulkan;
+        class BufferCBVImplNull;
         class BindlessBufferSRVImplDX12;
         class BindlessBufferSRVImplVulkan;
+        class BindlessBufferSRVImplNull;
         class BindlessBufferUAVImplDX12;
         class BindlessBufferUAVImplVulkan;
+        class BindlessBufferUAVImplNull;
         class RaytracingAccelerationStructureImplDX12;
         class RaytracingAccelerationStructureImplVulkan;
+        class RaytracingAccelerationStructureImplNull;
 
         class TextureSRVImplDX12;
         class TextureSRVImplVulkan;
+        class TextureSRVImplNull;
         class TextureUAVImplDX12;
         class TextureUAVImplVulkan;
+        class TextureUAVImplNull;
         class TextureDSVImplDX12;
         class TextureDSVImplVulkan;
+        class TextureDSVImplNull;
         class TextureRTVImplDX12;
         class TextureRTVImplVulkan;
+        class TextureRTVImplNull;
         class BindlessTextureSRVImplDX12;
         class BindlessTextureSRVImplVulkan;
+        class BindlessTextureSRVImplNull;
         class BindlessTextureUAVImplDX12;
         class BindlessTextureUAVImplVulkan;
+        class BindlessTextureUAVImplNull;
 
 #define ImplementationFriendAccess \
         friend class implementation::SwapChainImplDX12; \
         friend class implementation::SwapChainImplVulkan; \
+        friend class implementation::SwapChainImplNull; \
         friend class implementation::DeviceImplDX12; \
         friend class implementation::DeviceImplVulkan; \
+        friend class implementation::DeviceImplNull; \
         friend class implementation::BarrierImplDX12; \
         friend class implementation::BarrierImplVulkan; \
+        friend class implementation::BarrierImplNull; \
         friend class implementation::CommandListImplDX12; \
         friend class implementation::CommandListImplVulkan; \
+        friend class implementation::CommandListImplNull; \
         friend class implementation::PipelineImplDX12; \
         friend class implementation::PipelineImplVulkan; \
+        friend class implementation::PipelineImplNull; \
         friend class implementation::DescriptorHeapImplDX12; \
         friend class implementation::DescriptorHeapImplVulkan
 
 #define BufferViewImplementationFriendAccess \
         friend class implementation::BufferSRVImplDX12; \
         friend class implementation::BufferSRVImplVulkan; \
+        friend class implementation::BufferSRVImplNull; \
         friend class implementation::BufferUAVImplDX12; \
         friend class implementation::BufferUAVImplVulkan; \
+        friend class implementation::BufferUAVImplNull; \
         friend class implementation::BufferIBVImplDX12; \
         friend class implementation::BufferIBVImplVulkan; \
+        friend class implementation::BufferIBVImplNull; \
         friend class implementation::BufferVBVImplDX12; \
         friend class implementation::BufferVBVImplVulkan; \
+        friend class implementation::BufferVBVImplNull; \
         friend class implementation::BufferCBVImplDX12; \
         friend class implementation::BufferCBVImplVulkan; \
+        friend class implementation::BufferCBVImplNull; \
         friend class implementation::RaytracingAccelerationStructureImplDX12; \
-        friend class implementation::RaytracingAccelerationStructureImplVulkan
+        friend class implementation::RaytracingAccelerationStructureImplVulkan; \
+        friend class implementation::RaytracingAccelerationStructureImplNull
 
 #define TextureViewImplementationFriendAccess \
         friend class implementation::TextureSRVImplDX12; \
         friend class implementation::TextureSRVImplVulkan; \
+        friend class implementation::TextureSRVImplNull; \
         friend class implementation::TextureUAVImplDX12; \
         friend class implementation::TextureUAVImplVulkan; \
+        friend class implementation::TextureUAVImplNull; \
         friend class implementation::TextureDSVImplDX12; \
         friend class implementation::TextureDSVImplVulkan; \
+        friend class implementation::TextureDSVImplNull; \
         friend class implementation::TextureRTVImplDX12; \
-        friend class implementation::TextureRTVImplVulkan
+        friend class implementation::TextureRTVImplVulkan; \
+        friend class implementation::TextureRTVImplNull
 
     }
 
@@ -135,6 +169,7 @@ namespace engine
         const BufferDescription::Descriptor& description() const;
         ResourceState state() const;
         void state(ResourceState state) const;
+        size_t committedBytes() const;
 
 		bool operator==(const Buffer& buffer) const;
 		bool operator!=(const Buffer& buffer) const;
@@ -169,6 +204,7 @@ namespace engine
         ImplementationFriendAccess;
         friend class implementation::BindlessBufferSRVImplDX12;
         friend class implementation::BindlessBufferSRVImplVulkan;
+        friend class implementation::BindlessBufferSRVImplNull;
 		friend class RaytracingAccelerationStructure;
 		friend class BufferSRVOwner;
 
@@ -196,6 +232,7 @@ namespace engine
         ImplementationFriendAccess;
         friend class implementation::BindlessBufferUAVImplDX12;
         friend class implementation::BindlessBufferUAVImplVulkan;
+        friend class implementation::BindlessBufferUAVImplNull;
 		friend class BufferUAVOwner;
 
         BufferUAV(implementation::BufferUAVImplIf* impl);
@@ -352,6 +389,8 @@ namespace engine
         const TextureDescription::Descriptor& description() const;
         ResourceState state(int slice, int mip) const;
         void state(int slice, int mip, ResourceState state) const;
+        void state(ResourceState state) const;
+        bool uniformState(ResourceState& state) const;
 
 		bool operator==(const Texture& texture) const;
 		bool operator!=(const Texture& texture) const;
@@ -390,6 +429,7 @@ namespace engine
         ImplementationFriendAccess;
         friend class implementation::BindlessTextureSRVImplDX12;
         friend class implementation::BindlessTextureSRVImplVulkan;
+        friend class implementation::BindlessTextureSRVImplNull;
 		friend class TextureSRVOwner;
 
         TextureSRV(implementation::TextureSRVImplIf* view);
@@ -422,6 +462,7 @@ namespace engine
         ImplementationFriendAccess;
         friend class implementation::BindlessTextureUAVImplDX12;
         friend class implementation::BindlessTextureUAVImplVulkan;
+        friend class implementation::BindlessTextureUAVImplNull;
 		friend class TextureUAVOwner;
 
         TextureUAV(implementation::TextureUAVImplIf* view);
@@ -32,7 +32,7 @@ namespace engine
             }
 
             string apiPath;
-            if (api == GraphicsApi::DX12)
+            if (api == GraphicsApi::DX12 || api == GraphicsApi::Null)
                 apiPath = m_settings.get<string>("apiShaderPathDX12");
             else if (api == GraphicsApi::Vulkan)
                 apiPath = m_settings.get<string>("apiShaderPathVulkan");
@@ -1,61 +1,156 @@
 #pragma once
 
-#include "shaders/core/model/ClusterRender.h"
-#include "shaders/core/model/ClusterShadowRenderer.h"
-#include "engine/graphics/Pipeline.h"
-#include "engine/rendering/culling/ModelDataLine.h"
+#include "engine/primitives/Vector3.h"
+#include "engine/primitives/Matrix4.h"
+#include "tools/JobSystem.h"
+#include "containers/vector.h"
+#include <cstdint>
 
 namespace engine
 {
-	class Device;
-	class CommandList;
-	class ModelResources;
-	class GBuffer;
-	class TextureDSV;
-
-	struct ClusterRendererArguments
-	{
-		CommandList& cmd;
-		Camera* camera;
-
-		GBuffer* gBuffer;
-		TextureDSV* depthBuffer;
-		uint64_t frameNumber;
-		Vector2<int> virtualResolution;
-
-		// temporal stuff
-		Matrix4f previousViewMatrix;
-		Matrix4f previousProjectionMatrix;
-
-		int currentRenderMode;
-		bool zPrepass = false;
-		bool debugCamera = false;
-		bool alphaclipped = false;
-		bool gbufferEqual = false;
-	};
-
-	class ClusterRenderer
-	{
-	public:
-		ClusterRenderer(Device& device);
-
-		void render(
-			ClusterRendererArguments args,
-			ClusterDataLine& clusters,
-			IndexDataLine& indexes,
-			DrawDataLine& draws);
-
-	private:
-		Device & m_device;
-		engine::Pipeline<shaders::ClusterRender> m_fullRender;
-		engine::Pipeline<shaders::ClusterRender> m_fullEqualRender;
-		engine::Pipeline<shaders::ClusterRender> m_gbufferRender;
-		engine::Pipeline<shaders::ClusterRender> m_debugCamerafullRender;
-		engine::Pipeline<shaders::ClusterRender> m_debugCameragbufferRender;
-		engine::Pipeline<shaders::ClusterShadowRenderer> m_depthRender;
-		engine::Pipeline<shaders::ClusterRender> m_clusterDebugRender;
-		engine::Pipeline<shaders::ClusterRender> m_zPrepass;
-		engine::Pipeline<shaders::ClusterRender> m_alphaclipped;
-		engine::Pipeline<shaders::ClusterRender> m_alphaclippedShadow;
-	};
+    class Camera;
+    class LightData;
+
+    // screen tiles are the size of the gpu light bins (binSize() in ShapeRenderer)
+    constexpr uint32_t LightBinTileSize = 8;
+    constexpr uint32_t DefaultLightBinSlices = 16;
+
+    struct LightBinningView
+    {
+        Matrix4f viewMatrix;
+        Matrix4f projectionMatrix;
+        int width;
+        int height;
+        float nearPlane;
+        float farPlane;
+
+        static LightBinningView fromCamera(const Camera& camera);
+    };
+
+    struct LightBinningStatistics
+    {
+        uint64_t lightsBinned;
+        uint64_t lightsOutside;
+        uint64_t entries;
+        double milliseconds;
+
+        void reset();
+    };
+
+    // light indexes of one cluster, in increasing order
+    struct LightBinList
+    {
+        const uint32_t* first;
+        uint32_t count;
+
+        const uint32_t* begin() const { return first; }
+        const uint32_t* end() const { return first + count; }
+        bool contains(uint32_t light) const;
+    };
+
+    // cpu version of the light bins for the systems that want to know
+    // which lights reach a point without going through the gpu.
+    //
+    // the screen is split into the same 8x8 pixel tiles as the gpu bins and
+    // the view depth into exponential slices (1 slice is the gpu layout).
+    // like the gpu bins, only spot and point lights are binned and they use
+    // the same volumes, the sphere scaled by 1.1 and the cone opened by a
+    // degree. the tests are conservative, a cluster can list a light that
+    // only comes close to it. slices are binned in parallel.
+    class LightBinning
+    {
+    public:
+        LightBinning(uint32_t slices = DefaultLightBinSlices, JobSystem& jobs = JobSystem::instance());
+
+        LightBinning(const LightBinning&) = delete;
+        LightBinning(LightBinning&&) = delete;
+        LightBinning& operator=(const LightBinning&) = delete;
+        LightBinning& operator=(LightBinning&&) = delete;
+
+        // light indexes are LightData slots
+        void update(const LightBinningView& view, const LightData& lights);
+
+        LightBinList lights(uint32_t x, uint32_t y, uint32_t slice) const;
+
+        // the lights of the cluster position is in. empty outside the view
+        LightBinList lightsAt(const Vector3f& position) const;
+
+        uint32_t binsX() const { return m_binsX; }
+        uint32_t binsY() const { return m_binsY; }
+        uint32_t slices() const { return m_slices; }
+
+        // the slice view depth falls in, clamped to the slices
+        uint32_t slice(float depth) const;
+
+        const LightBinningStatistics& statistics() const { return m_statistics; }
+        size_t workerCount() const { return m_jobs.workerCount(); }
+
+        static constexpr float PointLightBinScale = 1.1f;
+        static constexpr float SpotLightBinAngle = 1.0f;
+    private:
+        // view space volume of a light and what it covers
+        struct BinnedLight
+        {
+            uint32_t index;
+            bool spot;
+
+            // bounding sphere
+            Vector3f center;
+            float radius;
+
+            // cone
+            Vector3f apex;
+            Vector3f axis;
+            float range;
+            float cosAngle;
+            float sinAngle;
+
+            uint32_t x0, x1, y0, y1;
+        };
+
+        struct Span
+        {
+            uint32_t light;
+            uint32_t x0, x1, y0, y1;
+        };
+
+        // froxel bounds of one slice. x and y are separable, padded to 4
+        struct Slice
+        {
+            float nearDepth;
+            float farDepth;
+            engine::vector<float> minX;
+            engine::vector<float> maxX;
+            engine::vector<float> minY;
+            engine::vector<float> maxY;
+
+            // m_lights that reach the slice and the tiles they can touch
+            engine::vector<uint32_t> lights;
+            engine::vector<Span> spans;
+            engine::vector<uint32_t> rowOffsets;
+            engine::vector<uint32_t> rowSpans;
+            engine::vector<uint64_t> rowHits;
+
+            // the light lists of the tiles, offsets has one more than tiles
+            engine::vector<uint32_t> offsets;
+            engine::vector<uint32_t> indexes;
+        };
+
+        uint32_t m_slices;
+        uint32_t m_binsX;
+        uint32_t m_binsY;
+        LightBinningView m_view;
+        float m_depthScale;
+        engine::vector<BinnedLight> m_lights;
+        engine::vector<Slice> m_sliceData;
+        LightBinningStatistics m_statistics;
+
+        void resize(int width, int height);
+        void updateSlices();
+        bool binLight(uint32_t index, const Vector3f& position, const Vector3f& direction, float range, bool spot, float angleDegrees);
+        void binSlice(size_t slice);
+        uint32_t testTiles(const Slice& slice, const BinnedLight& light, uint32_t x, uint32_t y) const;
+
+        JobSystem& m_jobs;
+    };
 }
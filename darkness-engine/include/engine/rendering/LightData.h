@@ -4,19 +4,54 @@
 #include "engine/Scene.h"
 #include "engine/primitives/Matrix4.h"
 #include "containers/vector.h"
+#include "containers/unordered_map.h"
+#include "containers/memory.h"
 #include <queue>
 
 namespace engine
 {
+    struct LightUploadStatistics
+    {
+        uint32_t lightsAdded;
+        uint32_t lightsRemoved;
+        uint32_t lightsChanged;
+        uint32_t uploads;
+        size_t bytes;
+    };
+
+    // gpu light buffers kept up to date one light at a time.
+    //
+    // every light component owns a slot for as long as it is in the scene,
+    // so the index of a light does not change when other lights come and
+    // go. removed lights leave a free slot (FreeLightType, nothing else set)
+    // that the next new light takes. count() covers the free slots too.
+    //
+    // only the lights that changed are written to the cpu arrays and only
+    // their elements are uploaded. neighbouring changes go out as one copy.
     class LightData
     {
     public:
+        LightData();
+
         void updateLightInfo(
-			Device& device, 
-			CommandList& commandList, 
+			Device& device,
+			CommandList& commandList,
 			const engine::vector<FlatSceneLightNode>& lights);
 
+        // the two halves of updateLightInfo. stage only touches cpu memory
+        void stage(const engine::vector<FlatSceneLightNode>& lights);
+        void upload(Device& device, CommandList& commandList);
+
         uint32_t count() const;
+        uint32_t activeCount() const;
+        uint32_t spotCount() const;
+        uint32_t pointCount() const;
+
+        // InvalidLightIndex when the light is not staged
+        uint32_t index(const LightComponent* light) const;
+
+        // what the last stage() queued for upload
+        const LightUploadStatistics& uploadStatistics() const;
 
         BufferSRV transforms();
 
@@ -43,6 +78,7 @@ namespace engine
 
         const engine::vector<float>& cpuranges() const;
 
+        // ranges of the spot and point lights only, in spotIds/pointIds order
         const engine::vector<float>& cpuspotranges() const;
 
         const engine::vector<float>& cpupointranges() const;
@@ -55,9 +91,43 @@ namespace engine
 
         bool changeHappened() const;
 
+        static constexpr uint32_t InvalidLightIndex = 0xffffffff;
+        static constexpr unsigned int FreeLightType = 0xffffffff;
+
     private:
+        enum Field
+        {
+            FieldTransform,
+            FieldPosition,
+            FieldDirection,
+            FieldColor,
+            FieldIntensity,
+            FieldRange,
+            FieldType,
+            FieldParameters,
+            SlotFieldCount,
+
+            FieldSpotTransform = SlotFieldCount,
+            FieldSpotRange,
+            FieldSpotId,
+            FieldPointRange,
+            FieldPointId,
+            FieldCount
+        };
+
+        struct PendingUpload
+        {
+            Field field;
+            uint32_t first;
+            uint32_t count;
+        };
+
         bool m_changeHappened = false;
         uint32_t m_lightCount;
+        uint32_t m_activeCount;
+        uint64_t m_frame;
+        LightUploadStatistics m_statistics;
+
 		BufferSRVOwner m_lightTransforms;
         BufferSRVOwner m_lightWorlPositions;
         BufferSRVOwner m_lightDirections;
@@ -72,15 +142,57 @@ namespace engine
         BufferSRVOwner m_lightParameters;
 		BufferSRVOwner m_spotLightTransforms;
 
+        // buffer sizes in elements. buffers are created again when they
+        // have to grow and get everything uploaded
+        uint32_t m_capacity;
+        uint32_t m_spotCapacity;
+        uint32_t m_pointCapacity;
+        bool m_recreate;
+        bool m_recreateSpots;
+        bool m_recreatePoints;
+
+        // slot arrays, cpu side
         engine::vector<engine::Matrix4f> m_transforms;
         engine::vector<engine::Vector3f> m_positions;
         engine::vector<engine::Vector3f> m_directions;
         engine::vector<float> m_ranges;
-		engine::vector<float> m_spotranges;
-		engine::vector<float> m_pointranges;
         engine::vector<unsigned int> m_types;
         engine::vector<bool> m_shadowCaster;
-		engine::vector<Matrix4f> m_spottransforms;
 		engine::vector<Vector4f> m_parameters;
+
+        // slot arrays in the gpu formats
+        engine::vector<Vector4f> m_gpuPositions;
+        engine::vector<Vector4f> m_gpuDirections;
+        engine::vector<Vector4f> m_colors;
+        engine::vector<float> m_intensities;
+
+        // spot and point lights packed by slot order
+		engine::vector<float> m_spotranges;
+		engine::vector<float> m_pointranges;
+		engine::vector<Matrix4f> m_spottransforms;
+        engine::vector<uint32_t> m_spotids;
+        engine::vector<uint32_t> m_pointids;
+        engine::vector<uint32_t> m_packedIndex;
+
+        // slot bookkeeping
+        engine::vector<engine::shared_ptr<LightComponent>> m_components;
+        engine::unordered_map<const LightComponent*, uint32_t> m_slots;
+        engine::vector<uint32_t> m_freeSlots;
+        engine::vector<uint64_t> m_seen;
+        engine::vector<uint16_t> m_dirty;
+        engine::vector<uint32_t> m_dirtySlots;
+        engine::vector<uint32_t> m_dirtySpots;
+        engine::vector<uint32_t> m_dirtyPoints;
+        engine::vector<PendingUpload> m_uploads;
+
+        uint32_t allocateSlot(const engine::shared_ptr<LightComponent>& light);
+        void freeSlot(uint32_t slot);
+        void markDirty(uint32_t slot, uint16_t fields);
+        void packSpotsAndPoints();
+        void queueUploads(bool repacked);
+        void queueRuns(Field field, const engine::vector<uint32_t>& sortedIndexes, uint16_t slotFields);
+        void queueUpload(Field field, uint32_t first, uint32_t count);
+        size_t elementSize(Field field) const;
+        void createBuffers(Device& device);
     };
 }
@@ -10,7 +10,30 @@ namespace engine
     typedef uint32_t MeshVersion;
     MeshVersion getMeshVersion(const engine::string& filename);
 
+    // concatenates the submeshes of several in-memory mesh files
+    // (as written by Mesh::saveToMemory) into one mesh file.
+    // submesh order follows the order of the parts.
+    void mergeMeshMemory(engine::vector<engine::vector<char>>& parts, engine::vector<char>& mem);
+
+    // models with fewer indexes than this are processed as a single part
+    constexpr uint64_t ModelPartIndexes = 1024u * 1024u;
+
+    struct ModelPartMeshes
+    {
+        uint32_t first;
+        uint32_t count;
+    };
+
+    // splits the meshes of a model to contiguous ranges of roughly equal index count.
+    // every started partIndexes adds a part up to maxParts and the mesh count,
+    // as a mesh is never split between parts.
+    engine::vector<ModelPartMeshes> splitModelParts(
+        const engine::vector<uint32_t>& meshIndexCounts,
+        size_t maxParts,
+        uint64_t partIndexes = ModelPartIndexes);
+
 	class ResidencyManagerV2;
+    class SubMeshUploadBackend;
 
     class Mesh
     {
@@ -23,8 +46,17 @@ namespace engine
         void save();
         void saveToMemory(engine::vector<char>& mem);
         void load(ResidencyManagerV2& residency, ModelResources& modelResources);
+
+        // load() in two steps, see SubMesh::read. read() returns false
+        // when the file is missing or has an unsupported version
+        bool read();
+        void schedule(SubMeshUploadBackend& backend);
+        size_t stagedBytes() const;
         engine::vector<SubMesh>& subMeshes();
         const engine::vector<SubMesh>& subMeshes() const;
+
+        // true once all submeshes have landed on the GPU. does not block
+        bool resident() const;
     private:
         engine::string m_filename;
         engine::vector<SubMesh> m_subMeshes;
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "engine/rendering/ResidencyManager.h"
+#include "containers/vector.h"
+#include "containers/string.h"
+#include "containers/memory.h"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace engine
+{
+    class Mesh;
+    class SubMeshUploadBackend;
+
+    // mesh files read but not scheduled yet. the reader stops
+    // reading ahead when it has this much waiting for update()
+    constexpr size_t MeshReadAheadBytes = 64u * 1024u * 1024u;
+
+    enum class MeshRequestState
+    {
+        Queued,
+        Read,
+        Ready,
+        Failed
+    };
+
+    // one mesh file asked from the MeshStreamer
+    class MeshRequest
+    {
+    public:
+        MeshRequest(const engine::string& filename, ResidencyPriority priority);
+
+        const engine::string& filename() const;
+        MeshRequestState state() const;
+
+        // true once the file has been read and its uploads issued.
+        // the submeshes are resident when Mesh::resident() says so
+        bool ready() const;
+
+        // the file was missing or could not be read
+        bool failed() const;
+
+        // valid once ready()
+        engine::shared_ptr<Mesh> mesh() const;
+
+        // moves the request in the read queue. has no effect once
+        // the reader has picked it up
+        ResidencyPriority priority() const;
+        void priority(ResidencyPriority priority);
+
+    private:
+        friend class MeshStreamer;
+        engine::string m_filename;
+        std::atomic<ResidencyPriority> m_priority;
+        std::atomic<MeshRequestState> m_state;
+        uint64_t m_sequence;
+        engine::shared_ptr<Mesh> m_mesh;
+    };
+
+    struct MeshStreamerStatistics
+    {
+        size_t queued;
+        size_t read;
+        size_t readBytes;
+    };
+
+    // reads and decodes mesh files on a thread of its own, most urgent
+    // priority first and in request order within a priority. the reader
+    // runs ahead of update() until MeshReadAheadBytes are waiting.
+    // update() issues the uploads on the calling thread so the upload
+    // backend is only used from there.
+    class MeshStreamer
+    {
+    public:
+        MeshStreamer(size_t readAheadBytes = MeshReadAheadBytes);
+        ~MeshStreamer();
+
+        MeshStreamer(const MeshStreamer&) = delete;
+        MeshStreamer(MeshStreamer&&) = delete;
+        MeshStreamer& operator=(const MeshStreamer&) = delete;
+        MeshStreamer& operator=(MeshStreamer&&) = delete;
+
+        engine::shared_ptr<MeshRequest> request(
+            const engine::string& filename,
+            ResidencyPriority priority = ResidencyPriority::Visible);
+
+        // schedules the meshes read so far. does not block.
+        // returns how many requests finished
+        size_t update(SubMeshUploadBackend& backend);
+
+        // raises request to Visible and returns when it is ready or failed
+        void blockUntilReady(MeshRequest& request, SubMeshUploadBackend& backend);
+
+        // fails every request that has not been scheduled yet and drops
+        // what was read for them. a file the reader is in the middle of
+        // fails when the read finishes. scheduled meshes are not touched
+        void cancel();
+
+        MeshStreamerStatistics statistics() const;
+
+    private:
+        mutable std::mutex m_mutex;
+        std::condition_variable m_work;
+        std::condition_variable m_finished;
+
+        engine::vector<engine::shared_ptr<MeshRequest>> m_queued;
+        engine::vector<engine::shared_ptr<MeshRequest>> m_read;
+        size_t m_readAheadBytes;
+        size_t m_readBytes;
+        uint64_t m_sequence;
+
+        // bumped by cancel() so that a read in progress knows to throw its result away
+        uint64_t m_generation;
+        bool m_alive;
+        std::thread m_reader;
+
+        void reader();
+
+        // most urgent queued request. m_mutex is held
+        engine::shared_ptr<MeshRequest> next();
+    };
+}
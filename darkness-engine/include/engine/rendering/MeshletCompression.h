@@ -0,0 +1,79 @@
+#pragma once
+
+#include "engine/rendering/ModelCpu.h"
+#include "engine/primitives/Vector2.h"
+#include "engine/primitives/Vector3.h"
+#include "engine/primitives/Vector4.h"
+#include "engine/primitives/BoundingBox.h"
+#include "containers/vector.h"
+#include <cstdint>
+
+namespace engine
+{
+    // same triangle count as the fixed clusters (ClusterMaxSize / 3).
+    // meshlet local indexes are 8 bits so the vertex count has room to grow
+    constexpr uint32_t MeshletMaxVertices = 64;
+    constexpr uint32_t MeshletMaxTriangles = 64;
+
+    // positions are 16 bits per axis inside the meshlet bounds
+    constexpr uint32_t MeshletPositionSteps = 65535;
+
+    struct CompressedMeshlet
+    {
+        Vector3f boundsMin;
+        Vector3f boundsRange;
+        uint32_t vertexStart;
+        uint32_t triangleStart;
+        uint32_t vertexCount;
+        uint32_t triangleCount;
+    };
+
+    // mesh split into meshlets with every stream quantised. vertexes that
+    // are shared between meshlets are stored once per meshlet.
+    //
+    // position:  3 x 16 bit unorm in the meshlet bounds
+    // normal:    octahedral 2 x 16 bit unorm
+    // tangent:   octahedral 2 x 16 bit unorm
+    // uv:        2 x half float
+    // color:     4 x 8 bit unorm
+    // index:     3 x 8 bit, local to the meshlet
+    //
+    // every stream has a fixed stride so a meshlet vertex can be decoded
+    // on its own, which is what the gpu decode needs.
+    struct CompressedMesh
+    {
+        engine::vector<CompressedMeshlet> meshlets;
+        engine::vector<uint16_t> position;
+        engine::vector<uint32_t> normal;
+        engine::vector<uint32_t> tangent;
+        engine::vector<engine::vector<uint32_t>> uv;
+        engine::vector<engine::vector<engine::Vector4<unsigned char>>> color;
+        engine::vector<uint8_t> index;
+        engine::BoundingBox boundingBox;
+
+        size_t vertexCount() const;
+        size_t triangleCount() const;
+        size_t sizeBytes() const;
+    };
+
+    // meshlets are cut from the triangles in index order, so the order
+    // ModelTask gives the triangles is kept
+    CompressedMesh compressMeshlets(const ModelCpu& model);
+
+    // appends the vertexes and triangles of one meshlet to output
+    void decodeMeshlet(const CompressedMesh& mesh, size_t meshlet, ModelCpu& output);
+
+    // every meshlet, triangles come out in the order they went in
+    ModelCpu decompressMeshlets(const CompressedMesh& mesh);
+
+    // largest position error per axis in a meshlet, half a quantisation step
+    Vector3f meshletPositionError(const CompressedMeshlet& meshlet);
+
+    // one blob with all the streams. entropy coding runs it through zstd,
+    // without it the streams can be uploaded straight from the blob
+    engine::vector<char> packMeshlets(const CompressedMesh& mesh, bool entropyCode);
+    bool unpackMeshlets(const engine::vector<char>& data, CompressedMesh& mesh);
+
+    uint16_t floatToHalf(float value);
+    float halfToFloat(uint16_t value);
+}
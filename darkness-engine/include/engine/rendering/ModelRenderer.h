@@ -98,6 +98,11 @@ namespace engine
             CommandList& cmd,
             unsigned int mouseX,
             unsigned int mouseY);
+
+        // light bins, ssao and ssr can be recorded concurrently after
+        // this has moved the gbuffer targets they share to a read state
+        void prepareScreenSpace(CommandList& cmd);
+
         void renderSSAO(
             Device& device, 
             CommandList& cmd, 
@@ -243,6 +248,11 @@ namespace engine
 			return &m_forwardRendering;
 		}
 
+        bool* parallelRecording()
+        {
+            return &m_parallelRecording;
+        }
+
         bool histogramDebug() const
         {
             return m_histogramDebug;
@@ -583,6 +593,7 @@ namespace engine
         bool m_logEnabled;
         bool m_debugMenuOpen;
 		bool m_forwardRendering;
+        bool m_parallelRecording;
         bool m_voxelize;
         bool m_debugVoxels;
         bool m_debugVoxelGrids;
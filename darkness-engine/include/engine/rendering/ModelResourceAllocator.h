@@ -30,6 +30,13 @@ namespace engine
         size_t count;
     };
 
+    // buffers for the streams of the model data, indexed by gpuIndex.
+    //
+    // when the device supports reserved buffers, address space for the
+    // largest possible size is reserved up front and growing only commits
+    // more pages. the buffers and views never change so nothing is copied
+    // and the gpu is not waited on. without them growing creates new buffers
+    // and copies the old contents over.
     class ModelResourceAllocator
     {
     public:
@@ -51,6 +58,9 @@ namespace engine
         size_t elements() const;
         size_t usedElements() const;
         size_t elementSizeBytes() const;
+
+        bool reserved() const;
+        size_t reservedElements() const;
     private:
 		Device& m_device;
         size_t m_maxElements;
@@ -72,7 +82,11 @@ namespace engine
         size_t m_size;
         size_t m_inUse;
         size_t m_elementSizeBytes;
+        bool m_reserved;
+        size_t m_reservedElements;
 
+        void createBuffers();
+        void commit(size_t elements);
 		void resize(size_t newElements);
         size_t biggestFormatSize() const;
     };
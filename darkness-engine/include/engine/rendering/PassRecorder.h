@@ -0,0 +1,96 @@
+#pragma once
+
+#include "engine/graphics/CommandList.h"
+#include "tools/JobSystem.h"
+#include "containers/vector.h"
+#include <functional>
+#include <thread>
+#include <chrono>
+
+namespace engine
+{
+    class Device;
+
+    enum class PassThread
+    {
+        Any,
+        // pass touches state owned by the calling thread (ImGui for example)
+        Main
+    };
+
+    struct PassTiming
+    {
+        const char* name;
+        size_t stage;
+        bool worker;
+        double milliseconds;
+    };
+
+    // records render passes into their own command lists.
+    //
+    // passes are grouped into stages. the passes of one stage are recorded
+    // concurrently and the stages one after another, so a pass sees the
+    // resource states left by the stages before it. two passes of the same
+    // stage must not transition the same resource. all lists are submitted
+    // in the order the passes were added.
+    class PassRecorder
+    {
+    public:
+        using RecordFunction = std::function<void(CommandList&)>;
+
+        PassRecorder(Device& device, JobSystem& jobs = JobSystem::instance());
+
+        PassRecorder(const PassRecorder&) = delete;
+        PassRecorder(PassRecorder&&) = delete;
+        PassRecorder& operator=(const PassRecorder&) = delete;
+        PassRecorder& operator=(PassRecorder&&) = delete;
+
+        // starts a new stage. prepare is recorded on the calling thread
+        // before any pass of the stage and can be used to move shared
+        // resources to the state all of the passes expect.
+        void stage(RecordFunction prepare = nullptr);
+        void pass(const char* name, RecordFunction record, PassThread thread = PassThread::Any);
+
+        // records and clears the added passes.
+        // parallel: cmd is submitted, every pass is recorded into a list of
+        // its own and submitted after it. cmd is then replaced with a new list
+        // so no gpu markers may be open on cmd.
+        // otherwise the passes are recorded into cmd one after another.
+        void record(CommandList& cmd, bool parallel);
+
+        const engine::vector<PassTiming>& timings() const { return m_timings; }
+
+        // wall time of the last record() call
+        double milliseconds() const { return m_milliseconds; }
+
+        size_t workerCount() const { return m_jobs.workerCount(); }
+    private:
+        struct Pass
+        {
+            const char* name;
+            size_t stage;
+            PassThread thread;
+            RecordFunction record;
+        };
+
+        struct Stage
+        {
+            RecordFunction prepare;
+            size_t firstPass;
+            size_t passCount;
+        };
+
+        Device& m_device;
+        engine::vector<Pass> m_passes;
+        engine::vector<Stage> m_stages;
+        engine::vector<CommandList> m_lists;
+        engine::vector<PassTiming> m_timings;
+        double m_milliseconds;
+
+        JobSystem& m_jobs;
+        std::thread::id m_callingThread;
+
+        void recordPass(size_t index, CommandList& cmd);
+        void recordStage(Stage& stage, CommandList& prepareList);
+    };
+}
@@ -4,12 +4,15 @@
 #include "engine/graphics/ResourceOwners.h"
 #include "engine/rendering/BufferSettings.h"
 #include "engine/graphics/Fence.h"
+#include "engine/graphics/CommandList.h"
 #include "tools/RingBuffer.h"
 #include "containers/vector.h"
 #include "containers/queue.h"
 
 #include <mutex>
 #include <thread>
+#include <condition_variable>
+#include <chrono>
 
 namespace engine
 {
@@ -66,6 +69,47 @@ namespace engine
     };
 
 	constexpr size_t ResidencyUploadSize = 1024ull * 1024ull * 5ull;
+
+	// the worker records queued tasks to one copy command list
+	// until either of these limits is reached. the byte limit is
+	// the upload ring size divided by ResidencyBatchRingDivisor
+	constexpr size_t ResidencyBatchRingDivisor = 4ull;
+	constexpr size_t ResidencyBatchTasks = 256ull;
+
+	enum class ResidencyPriority
+	{
+		Visible,	// needed for what is on screen now
+		Prefetch,	// likely needed soon
+		Background
+	};
+	constexpr size_t ResidencyPriorityCount = 3;
+
+	struct ResidencyStatistics
+	{
+		// tasks waiting for the worker, per ResidencyPriority
+		size_t queueDepth[ResidencyPriorityCount];
+
+		// batches submitted but not yet retired
+		size_t inFlightBatches;
+
+		size_t batches;
+		size_t tasks;
+		size_t bytes;
+		double bytesPerSecond;
+
+		// tasks with a piece that did not fit to the upload ring
+		size_t failedTasks;
+	};
+
+	// one destination range of a gathered buffer upload
+	struct ResidencyBufferCopy
+	{
+		Buffer dst;
+		size_t dstIndexBytes;
+		size_t srcOffsetBytes;
+		size_t bytes;
+	};
+
 	class ResidencyManagerV2
 	{
 	private:
@@ -80,6 +124,9 @@ namespace engine
 			size_t dstIndexBytes;
 			size_t bytes;
 
+			// gathered buffer data. ranges of ptr to many destinations
+			engine::vector<ResidencyBufferCopy> copies;
+
 			// texture data
 			Texture dstTexture;
 			size_t dstMip;
@@ -90,11 +137,19 @@ namespace engine
 			size_t srcWidth;
 			size_t srcHeight;
 
-			engine::unique_ptr<Fence> fence;
+			ResidencyPriority priority;
+
+			// set by the worker once the batch holding the last
+			// piece of this task has retired. guarded by m_mutex
+			bool uploaded = false;
+
+			// set by the worker when a piece of this task did not
+			// fit to the upload ring. guarded by m_mutex
+			bool failed = false;
 		};
 
 	public:
-		ResidencyManagerV2(Device& device);
+		ResidencyManagerV2(Device& device, size_t uploadBytes = ResidencyUploadSize);
 		~ResidencyManagerV2();
 
 		class ResidencyFuture
@@ -107,6 +162,14 @@ namespace engine
 			~ResidencyFuture();
 
 			void blockUntilUploaded();
+
+			// does not block
+			bool uploaded() const;
+
+			// the upload was too big for the upload ring and the
+			// destination was not (fully) written. uploaded() is
+			// true for it too so that nobody waits forever
+			bool failed() const;
 		private:
 			friend class ResidencyManagerV2;
 			ResidencyFuture();
@@ -119,7 +182,16 @@ namespace engine
 		ResidencyFuture uploadTemp(
 			Buffer dst,
 			size_t dstIndexBytes,
-			void* ptr, size_t bytes);
+			void* ptr, size_t bytes,
+			ResidencyPriority priority = ResidencyPriority::Visible);
+
+		// all copies are one task with one future. the source ranges
+		// must be in ascending order and the worker copies neighbouring
+		// ones to the ring with a single memcpy
+		ResidencyFuture uploadTemp(
+			void* ptr,
+			engine::vector<ResidencyBufferCopy>&& copies,
+			ResidencyPriority priority = ResidencyPriority::Visible);
 
 		ResidencyFuture upload(
 			void* srcPointer,
@@ -132,52 +204,72 @@ namespace engine
 			size_t dstMip,
 			size_t dstSlice,
 			size_t dstMipLevels,
-			bool copyOnUpload = false);
+			bool copyOnUpload = false,
+			ResidencyPriority priority = ResidencyPriority::Visible);
+
+		ResidencyStatistics statistics() const;
 
 	private:
 		friend class ResidencyFuture;
 		Device& m_device;
-		engine::queue<std::shared_ptr<ResidencyTask>> m_tasks;
+		engine::queue<std::shared_ptr<ResidencyTask>> m_tasks[ResidencyPriorityCount];
 		engine::vector<std::shared_ptr<ResidencyTask>> m_finishedTasks;
 
+		ResidencyFuture enqueue(engine::shared_ptr<ResidencyTask>&& task);
 		void finishTaskFromConsumer(ResidencyTask* task);
+		void blockUntilUploaded(ResidencyTask* task);
+		bool uploaded(ResidencyTask* task);
+		bool failed(ResidencyTask* task);
 
 	private:
-		/*class RingBuffer
+		struct InFlightBatch
 		{
-		public:
-			RingBuffer(int size);
-			int allocate(int bytes);
-			void free(int allocation);
-			int space() const;
-			int maxAllocationSpace() const;
+			FenceValue copyValue;
+			FenceValue directValue;
+			size_t bytes;
+			engine::vector<tools::RingBuffer::AllocStruct> allocations;
+			engine::vector<engine::shared_ptr<ResidencyTask>> tasks;
+		};
 
-		private:
-			struct AllocStruct
-			{
-				int start;
-				int size;
-			};
-			engine::vector<AllocStruct> m_allocations;
-			int m_size;
-			int m_writePtr;
-			int m_freePtr;
-		};*/
+		// state of the batch the worker is currently recording
+		struct RecordingBatch
+		{
+			CommandList copy;
+			CommandList direct;
+			bool copyWork = false;
+			bool directWork = false;
+			InFlightBatch batch = {};
+		};
 
-	private:
+		size_t m_uploadBytes;
+		size_t m_batchBytes;
 		BufferOwner m_uploadBuffer;
 		uint8_t* m_uploadMemory;
 		tools::RingBuffer m_ringBuffer;
 		Fence m_workerFence;
 		Fence m_workerFenceDirect;
-		engine::vector<tools::RingBuffer::AllocStruct> m_ringAllocations;
+		engine::queue<InFlightBatch> m_inFlight;
 		bool m_alive;
-		std::mutex m_mutex;
+		mutable std::mutex m_mutex;
+		std::condition_variable m_taskAvailable;
+		std::condition_variable m_taskUploaded;
+
+		// statistics. guarded by m_mutex
+		size_t m_inFlightCount;
+		size_t m_batchCount;
+		size_t m_taskCount;
+		size_t m_byteCount;
+		size_t m_failedCount;
+		double m_bytesPerSecond;
+		size_t m_rateBytes;
+		std::chrono::high_resolution_clock::time_point m_rateStart;
+
 		std::thread m_thread;
 
 		void worker();
-		void workOnTask(engine::shared_ptr<ResidencyTask>&& task);
-
-	
+		bool recordTask(RecordingBatch& recording, ResidencyTask& task);
+		tools::RingBuffer::AllocStruct allocate(RecordingBatch& recording, size_t bytes, size_t alignment);
+		void submit(RecordingBatch& recording);
+		bool retire(bool block);
 	};
 }
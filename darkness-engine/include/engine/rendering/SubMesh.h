@@ -11,12 +11,16 @@
 #include "tools/CompressedFile.h"
 #include "engine/rendering/ResidencyManager.h"
 #include "containers/vector.h"
+#include "containers/memory.h"
 #include "containers/string.h"
 
 namespace engine
 {
     class ModelResources;
 	class ResidencyManagerV2;
+    class SubMeshStreamState;
+    class SubMeshUploadBackend;
+    class SubMeshStreamer;
 
     enum class MeshBlockType
     {
@@ -50,6 +54,15 @@ namespace engine
         ModelResource lodBindingData;
         engine::vector<const ModelResource*> uvData;
         uint32_t clusterCount;
+
+        // uploads of the submesh this instance was created from.
+        // the instance should not be rendered before resident() returns true
+        engine::shared_ptr<SubMeshStreamState> stream;
+        bool resident() const;
+
+        // model space bounds of the submesh. inverted, so not valid(),
+        // when the instance was not created from a SubMesh
+        BoundingBox boundingBox{ Vector3f{ 1.0f, 1.0f, 1.0f }, Vector3f{ -1.0f, -1.0f, -1.0f } };
     };
 
     class SubMesh
@@ -80,6 +93,21 @@ namespace engine
         void save(CompressedFile& file) const;
         bool load(ResidencyManagerV2& residency, ModelResources& modelResources, CompressedFile& file);
 
+        // issues all GPU uploads of the submesh and returns without waiting for them
+        bool load(SubMeshUploadBackend& backend, CompressedFile& file);
+
+        // load() in two steps. read() only touches the file and CPU memory
+        // so it can run on a streaming thread, schedule() issues the uploads
+        bool read(CompressedFile& file);
+        void schedule(SubMeshUploadBackend& backend);
+
+        // bytes read into staging memory and not uploaded yet
+        size_t stagedBytes() const;
+
+        // true once every upload issued by load() has landed. does not block
+        bool resident() const;
+        void blockUntilResident() const;
+
         engine::shared_ptr<SubMeshInstance> createInstance(Device& device);
         void freeInstance(Device& device, SubMeshInstance* instance);
 
@@ -98,6 +126,9 @@ namespace engine
 
         size_t instanceCount() const;
     private:
+        friend class SubMeshStreamer;
+        engine::shared_ptr<SubMeshStreamState> m_stream;
+
         void writeBlockHeader(CompressedFile& file, MeshBlockHeader header) const;
         MeshBlockHeader readBlockHeader(CompressedFile& file);
 
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "engine/rendering/ResidencyManager.h"
+#include "engine/rendering/ModelResourceAllocator.h"
+#include "tools/CompressedFile.h"
+#include "containers/vector.h"
+#include "containers/memory.h"
+
+namespace engine
+{
+    class SubMesh;
+    class ModelResources;
+
+    // GPU buffers that submesh data ends up in
+    enum class SubMeshStream
+    {
+        Vertex,
+        Normal,
+        Tangent,
+        Color,
+        Uv,
+        Index,
+        Adjacency,
+        ClusterBinding,
+        ClusterBoundingBox,
+        ClusterCone,
+        SubMeshAdjacency,
+        SubMeshData,
+        SubMeshBoundingBox,
+        SubMeshBoundingSphere,
+        Lod
+    };
+
+    // allocators the GPU ranges of the streams come from
+    enum class SubMeshAllocator
+    {
+        VertexData,
+        UvData,
+        Index,
+        Adjacency,
+        ClusterData,
+        SubMeshData,
+        Lod
+    };
+
+    struct SubMeshStagedBlock
+    {
+        SubMeshStream stream;
+        uint32_t lod;
+        size_t elements;
+        size_t elementBytes;
+
+        // byte offset into SubMeshStaging::memory
+        size_t stagingOffset;
+
+        // element index in the destination buffer. valid after schedule()
+        size_t dstIndex;
+    };
+
+    // every GPU bound byte of one submesh lives in a single allocation
+    struct SubMeshStaging
+    {
+        engine::vector<uint8_t> memory;
+        engine::vector<SubMeshStagedBlock> blocks;
+        uint32_t lodCount = 0;
+
+        size_t stage(SubMeshStream stream, uint32_t lod, size_t elements, size_t elementBytes);
+        uint8_t* ptr(const SubMeshStagedBlock& block);
+    };
+
+    // uploads of one submesh. upload() collects the copies and submit()
+    // sends them from the staging memory as one request. the staging
+    // memory must stay alive until uploaded() returns true
+    class SubMeshUploadBatch
+    {
+    public:
+        virtual ~SubMeshUploadBatch() {};
+        virtual void upload(SubMeshStream stream, size_t dstIndexBytes, size_t stagingOffset, size_t bytes) = 0;
+        virtual void submit(const uint8_t* staging) = 0;
+        virtual bool uploaded() = 0;
+        virtual void blockUntilUploaded() = 0;
+    };
+
+    class SubMeshUploadBackend
+    {
+    public:
+        virtual ~SubMeshUploadBackend() {};
+        virtual ModelResourceAllocation allocate(SubMeshAllocator allocator, size_t elements) = 0;
+        virtual engine::unique_ptr<SubMeshUploadBatch> createBatch() = 0;
+    };
+
+    // backend used by the engine. a batch is one gathered ResidencyManagerV2
+    // upload to the ModelResources GPU buffers
+    class ResidencySubMeshUploadBackend : public SubMeshUploadBackend
+    {
+    public:
+        ResidencySubMeshUploadBackend(ResidencyManagerV2& residency, ModelResources& modelResources);
+        ModelResourceAllocation allocate(SubMeshAllocator allocator, size_t elements) override;
+        engine::unique_ptr<SubMeshUploadBatch> createBatch() override;
+    private:
+        ResidencyManagerV2& m_residency;
+        ModelResources& m_modelResources;
+    };
+
+    // keeps the staging memory alive while the uploads are in flight.
+    // shared between the SubMesh and its instances.
+    class SubMeshStreamState
+    {
+    public:
+        SubMeshStaging staging;
+
+        // declared after staging so the batch (and any pending
+        // upload waiting in it) goes away before the memory does
+        engine::unique_ptr<SubMeshUploadBatch> batch;
+
+        // read but not scheduled yet counts as not uploaded
+        bool scheduled = false;
+
+        // does not block. releases the staging memory once everything has landed
+        bool uploaded();
+        void blockUntilUploaded();
+    };
+
+    // CPU side of submesh loading.
+    // read() decodes one submesh from the mesh file into staging memory and the
+    // SubMesh CPU fields. schedule() allocates the GPU ranges, writes the cluster,
+    // submesh and lod tables to the same staging allocation and issues all uploads.
+    // neither waits for the GPU.
+    class SubMeshStreamer
+    {
+    public:
+        static bool read(CompressedFile& file, SubMesh& subMesh, SubMeshStaging& staging);
+        static engine::unique_ptr<SubMeshUploadBatch> schedule(SubMesh& subMesh, SubMeshStaging& staging, SubMeshUploadBackend& backend);
+    };
+}
@@ -6,6 +6,7 @@
 #include "engine/rendering/Postprocess.h"
 #include "engine/rendering/DepthPyramid.h"
 #include "engine/rendering/debug/DebugBoundingBoxes.h"
+#include "engine/rendering/PassRecorder.h"
 
 #include "engine/rendering/LightData.h"
 
@@ -73,6 +74,16 @@ namespace engine
             return m_modelRenderer.logEnabled();
         }
 
+        bool* parallelRecording()
+        {
+            return m_modelRenderer.parallelRecording();
+        }
+
+        const PassRecorder& passRecorder() const
+        {
+            return m_passRecorder;
+        }
+
 		TextureSRV ssrResult();
         FrameStatistics getStatistics();
 
@@ -99,6 +110,7 @@ namespace engine
         RenderCubemap m_renderCubemap;
         Postprocess m_postProcess;
 		DebugBoundingBoxes m_debugBoundingBoxes;
+        PassRecorder m_passRecorder;
 
 		int m_ssrDebugPhase;
     };
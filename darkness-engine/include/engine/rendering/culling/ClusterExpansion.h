@@ -10,12 +10,16 @@ namespace engine
 {
     class Device;
     class CommandList;
+    class PipelinePrewarm;
 
     class ClusterExpansion
     {
     public:
         ClusterExpansion(Device& device);
 
+        // creates both expansion pipelines on the prewarm jobs
+        void prewarm(PipelinePrewarm& prewarm);
+
         void expandClusters(
             CommandList& cmd,
             BufferSRV frustumCullingOutput,
@@ -0,0 +1,272 @@
+#pragma once
+
+#include "engine/graphics/HLSLTypeConversions.h"
+#include "engine/primitives/BoundingBox.h"
+#include "engine/primitives/Vector2.h"
+#include "engine/primitives/Vector3.h"
+#include "engine/primitives/Vector4.h"
+#include "engine/primitives/Matrix4.h"
+#include "tools/JobSystem.h"
+#include "containers/vector.h"
+#include <functional>
+#include <cstdint>
+
+namespace engine
+{
+    #include "shaders/core/shared_types/TransformHistory.hlsli"
+    #include "shaders/core/shared_types/LodBinding.hlsli"
+    #include "shaders/core/shared_types/SubMeshUVLod.hlsli"
+    #include "shaders/core/shared_types/SubMeshData.hlsli"
+    #include "shaders/core/shared_types/InstanceMaterial.hlsli"
+    #include "shaders/core/shared_types/ClusterInstanceData.hlsli"
+    #include "shaders/core/shared_types/FrustumCullingOutput.hlsli"
+
+    class Camera;
+
+    // min depth pyramid like DepthPyramid builds on the gpu.
+    //
+    // mip 0 is the depth buffer in the top left corner of a power of two
+    // texture. the rest of it is far depth (0) so it never occludes.
+    class SoftwareDepthPyramid
+    {
+    public:
+        SoftwareDepthPyramid(int width = 1, int height = 1);
+
+        void resize(int width, int height);
+
+        // pitch is in floats. rebuilds all the mips
+        void update(const float* depth, size_t pitch);
+
+        // point sampled with clamped addressing
+        float sample(float u, float v, uint32_t mip) const;
+
+        // the texel sample() reads, split so that the rows and columns
+        // of a sample grid can be found once
+        int column(float u, uint32_t mip) const;
+        int row(float v, uint32_t mip) const;
+        float load(int column, int row, uint32_t mip) const;
+
+        int width() const { return m_width; }
+        int height() const { return m_height; }
+        int widthPow2() const { return m_widthPow2; }
+        int heightPow2() const { return m_heightPow2; }
+        uint32_t mipLevels() const { return static_cast<uint32_t>(m_mips.size()); }
+
+    private:
+        struct Mip
+        {
+            int width;
+            int height;
+            engine::vector<float> data;
+        };
+
+        int m_width;
+        int m_height;
+        int m_widthPow2;
+        int m_heightPow2;
+        engine::vector<Mip> m_mips;
+    };
+
+    // the culling constants the gpu passes get
+    struct CpuCullingView
+    {
+        Matrix4f viewMatrix;
+        Matrix4f projectionMatrix;
+        Vector3f cameraPosition;
+        float farPlaneDistance;
+        Vector4f planes[6];
+        Vector2f size;
+        Vector2f pow2size;
+
+        static CpuCullingView fromCamera(const Camera& camera, Vector2<int> virtualResolution);
+    };
+
+    // the model resource buffers the culling shaders read
+    struct CpuCullingScene
+    {
+        const TransformHistory* transforms;
+        const LodBinding* instanceLodBindings;
+        const InstanceMaterial* instanceMaterials;
+        size_t instanceCount;
+
+        const SubMeshUVLod* lodBindings;
+        const SubMeshData* subMeshData;
+        const ::BoundingBox* subMeshBoundingBoxes;
+
+        const ::BoundingBox* clusterBoundingBoxes;
+        const Vector4f* clusterCones;
+    };
+
+    // accurate cluster tracking. one bit per cluster of every instance,
+    // instanceOffset tells where the bits of an instance start
+    struct CpuClusterTracking
+    {
+        engine::vector<uint32_t> instanceOffset;
+        engine::vector<uint32_t> bits;
+
+        void reset();
+    };
+
+    struct CpuClusterOutput
+    {
+        // every cluster that passed. the occlusion pass outputs these as
+        // the basis of the next frame
+        engine::vector<ClusterInstanceData> all;
+
+        // passed clusters that weren't drawn already, split by material
+        engine::vector<ClusterInstanceData> opaque;
+        engine::vector<ClusterInstanceData> alphaClipped;
+        engine::vector<ClusterInstanceData> transparent;
+        engine::vector<ClusterInstanceData> terrain;
+
+        void clear();
+    };
+
+    struct CullingStatistics
+    {
+        uint64_t instancesTested;
+        uint64_t instancesFrustumCulled;
+        uint64_t instancesOcclusionCulled;
+        uint64_t instancesPassed;
+
+        uint64_t clustersTested;
+        uint64_t clustersLodRejected;
+        uint64_t clustersFrustumCulled;
+        uint64_t clustersOcclusionCulled;
+        uint64_t clustersAlreadyDrawn;
+        uint64_t clustersPassed;
+
+        double milliseconds;
+
+        // share of the tested work that was culled, 0 - 1
+        double instanceEfficiency() const;
+        double clusterEfficiency() const;
+
+        void reset();
+        CullingStatistics& operator+=(const CullingStatistics& stats);
+    };
+
+    // cpu version of the gpu culling pipeline.
+    //
+    // every test mirrors its shader (InstanceFrustum, ClusterFrustum and
+    // OcclusionCull) so the survivors are the same ones the gpu keeps.
+    // the gpu appends in whatever order its threads finish, the outputs
+    // here are in input order. the tests run over chunks of the input as
+    // jobs, the tracking bits and outputs are written after that on the
+    // calling thread.
+    class CpuCuller
+    {
+    public:
+        CpuCuller(JobSystem& jobs = JobSystem::instance());
+
+        CpuCuller(const CpuCuller&) = delete;
+        CpuCuller(CpuCuller&&) = delete;
+        CpuCuller& operator=(const CpuCuller&) = delete;
+        CpuCuller& operator=(CpuCuller&&) = delete;
+
+        // InstanceFrustum.cs.hlsl. depth can be null to skip occlusion.
+        // outputPointer is the running cluster count
+        void instanceCull(
+            const CpuCullingView& view,
+            const CpuCullingScene& scene,
+            const SoftwareDepthPyramid* depth,
+            engine::vector<FrustumCullingOutput>& output);
+
+        // InstanceToClusterExpand.cs.hlsl
+        static void expandClusters(
+            const engine::vector<FrustumCullingOutput>& instances,
+            engine::vector<ClusterInstanceData>& clusters);
+
+        // ClusterFrustum.cs.hlsl. passed clusters are marked in tracking
+        void clusterCull(
+            const CpuCullingView& view,
+            const CpuCullingScene& scene,
+            const engine::vector<ClusterInstanceData>& input,
+            CpuClusterTracking& tracking,
+            CpuClusterOutput& output);
+
+        // OcclusionCull.cs.hlsl
+        void occlusionCull(
+            const CpuCullingView& view,
+            const CpuCullingScene& scene,
+            const SoftwareDepthPyramid& depth,
+            const engine::vector<ClusterInstanceData>& input,
+            const CpuClusterTracking& tracking,
+            CpuClusterOutput& output);
+
+        // accumulated over the calls since the last reset
+        const CullingStatistics& statistics() const { return m_statistics; }
+        void resetStatistics();
+
+        size_t workerCount() const { return m_jobs.workerCount(); }
+    private:
+        using ChunkFunction = std::function<void(size_t begin, size_t end, CullingStatistics& stats)>;
+
+        struct Chunk
+        {
+            size_t begin;
+            size_t end;
+            CullingStatistics stats;
+        };
+
+        CullingStatistics m_statistics;
+        engine::vector<uint8_t> m_passed;
+        engine::vector<uint32_t> m_lodPointer;
+        engine::vector<Chunk> m_chunks;
+        JobSystem& m_jobs;
+
+        // runs function over [0, count) in chunks and sums the chunk stats
+        void parallel(size_t count, ChunkFunction function);
+    };
+
+    // the shader functions the culler is built from
+    namespace culling
+    {
+        // CullingFunctions.hlsli frustumCull
+        bool frustumCull(
+            const Vector3f& bbmin, const Vector3f& bbmax,
+            const Matrix4f& transform,
+            const Vector3f& cameraPosition,
+            float farPlaneDistance,
+            const Vector4f* planes);
+
+        // CullingFunctions.hlsli coneCull. the shader returns before its
+        // cone test so every cluster passes here too
+        bool coneCull(
+            const Matrix4f& transform,
+            const Vector4f& cone,
+            const Vector3f& cameraPosition,
+            const Vector3f& bbmin, const Vector3f& bbmax);
+
+        // Common.hlsli screenMinMaxXYZ
+        void screenMinMaxXYZ(
+            const Matrix4f& viewMatrix,
+            const Matrix4f& projectionMatrix,
+            const Matrix4f& transform,
+            const Vector3f& bbmin, const Vector3f& bbmax,
+            const Vector2f& screenSize,
+            Vector2f& minXY,
+            Vector2f& maxXY,
+            float& maxDepth);
+
+        // same with projection * view * transform done by the caller
+        void screenMinMaxXYZ(
+            const Matrix4f& viewProj,
+            const Vector3f& bbmin, const Vector3f& bbmax,
+            const Vector2f& screenSize,
+            Vector2f& minXY,
+            Vector2f& maxXY,
+            float& maxDepth);
+
+        // Common.hlsli lodFromScreenSize
+        uint32_t lodFromScreenSize(const Vector2f& size);
+
+        // the 4x4 block hi-z test of the occlusion shaders
+        bool occlusionVisible(
+            const SoftwareDepthPyramid& depth,
+            const Vector2f& pow2size,
+            const Vector2f& minXY,
+            const Vector2f& maxXY,
+            float maxDepth);
+    }
+}
@@ -19,6 +19,7 @@ namespace engine
 {
     class Device;
     class CommandList;
+    class PipelinePrewarm;
     class Camera;
     class ModelResources;
     class ClusterExpansion;
@@ -29,6 +30,9 @@ namespace engine
     public:
         FrustumCuller(Device& device);
 
+        // queues the culling pipelines, and the cluster expansion ones, on prewarm
+        void prewarm(PipelinePrewarm& prewarm);
+
         void instanceCull(
             CommandList& cmd,
             Camera& camera,
@@ -14,6 +14,7 @@
 namespace engine
 {
     class CommandList;
+    class PipelinePrewarm;
     class Camera;
     class ModelResources;
     class ClusterExpansion;
@@ -24,6 +25,9 @@ namespace engine
     public:
         IndexExpansion(Device& device);
 
+        // queues the index expansion pipelines on prewarm
+        void prewarm(PipelinePrewarm& prewarm);
+
         void expandIndexes(
             Device& device,
             CommandList& cmd,
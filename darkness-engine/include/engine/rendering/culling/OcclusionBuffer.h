@@ -0,0 +1,127 @@
+#pragma once
+
+#include "engine/primitives/BoundingBox.h"
+#include "engine/primitives/Vector3.h"
+#include "engine/primitives/Vector4.h"
+#include "engine/primitives/Matrix4.h"
+#include "tools/JobSystem.h"
+#include "containers/vector.h"
+#include <cstdint>
+
+namespace engine
+{
+    class Camera;
+    struct FlatScene;
+    enum class ResidencyPriority;
+
+    struct OcclusionStatistics
+    {
+        uint64_t occluders;
+        uint64_t triangles;
+        uint64_t trianglesNearClipped;
+        double milliseconds;
+
+        void reset();
+    };
+
+    // low resolution depth buffer rasterized on the cpu from a few big
+    // occluders. for the cpu side work that wants to know if something
+    // is hidden before the gpu culling has run, like picking what to
+    // stream in.
+    //
+    // depth is reversed like the gpu buffers (near 1, far 0). the screen
+    // is split into tiles that are rasterized in parallel. triangles that
+    // reach behind the camera are dropped and pixel centers on an edge
+    // are not covered, so an occluder can only cover less than it should.
+    class OcclusionBuffer
+    {
+    public:
+        // width has to be a multiple of 64 and height a multiple of 32
+        OcclusionBuffer(int width = 256, int height = 128, JobSystem& jobs = JobSystem::instance());
+
+        OcclusionBuffer(const OcclusionBuffer&) = delete;
+        OcclusionBuffer(OcclusionBuffer&&) = delete;
+        OcclusionBuffer& operator=(const OcclusionBuffer&) = delete;
+        OcclusionBuffer& operator=(OcclusionBuffer&&) = delete;
+
+        // starts a new frame. viewProjection is projection * view
+        void begin(const Matrix4f& viewProjection);
+        void begin(const Camera& camera);
+
+        // the box is scaled around its center by BoxOccluderScale so that
+        // meshes that don't fill their bounds occlude less
+        void addOccluder(const BoundingBox& box, const Matrix4f& transform);
+
+        // a simplified hull. three indices per triangle
+        void addOccluder(
+            const Vector3f* vertices, size_t vertexCount,
+            const uint32_t* indices, size_t indexCount,
+            const Matrix4f& transform);
+
+        // the opaque submeshes that cover the most of the screen
+        void addOccluders(const FlatScene& scene);
+
+        // rasterizes the occluders added since begin()
+        void render();
+
+        // begin, addOccluders and render
+        void update(const FlatScene& scene, const Camera& camera);
+
+        // box is in world space. anything off screen, behind the camera or
+        // invalid is not occluded
+        bool isOccluded(const BoundingBox& box) const;
+        bool isOccluded(const BoundingBox& box, const Matrix4f& transform) const;
+
+        // occluded things are only a camera move away, they get prefetched
+        ResidencyPriority priority(const BoundingBox& box, const Matrix4f& transform) const;
+
+        // reorders the meshes of scene that are still queued for reading.
+        // the bounds come with the file, so until then a node is tested
+        // as a unit box at its origin
+        void prioritizeStreaming(const FlatScene& scene) const;
+
+        size_t maxOccluders() const { return m_maxOccluders; }
+        void maxOccluders(size_t count) { m_maxOccluders = count; }
+
+        // smallest screen area, in buffer pixels, that addOccluders takes
+        float minOccluderArea() const { return m_minOccluderArea; }
+        void minOccluderArea(float pixels) { m_minOccluderArea = pixels; }
+
+        int width() const { return m_width; }
+        int height() const { return m_height; }
+        float depth(int x, int y) const { return m_depth[static_cast<size_t>(y * m_width + x)]; }
+
+        const OcclusionStatistics& statistics() const { return m_statistics; }
+        size_t workerCount() const { return m_jobs.workerCount(); }
+
+        static constexpr float BoxOccluderScale = 0.9f;
+    private:
+        struct Triangle
+        {
+            float x[3];
+            float y[3];
+            float z[3];
+        };
+
+        int m_width;
+        int m_height;
+        int m_tilesX;
+        int m_tilesY;
+        size_t m_maxOccluders;
+        float m_minOccluderArea;
+
+        Matrix4f m_viewProjection;
+        engine::vector<float> m_depth;
+        engine::vector<float> m_blockMin;
+        engine::vector<Triangle> m_triangles;
+        engine::vector<engine::vector<uint32_t>> m_bins;
+        engine::vector<Vector4f> m_clip;
+        OcclusionStatistics m_statistics;
+
+        void addTriangles(const Vector4f* clip, const uint32_t* indices, size_t indexCount);
+        void rasterizeTile(size_t tile);
+        bool screenBounds(const Matrix4f& transform, const BoundingBox& box, int& x0, int& y0, int& x1, int& y1, float& depth) const;
+
+        JobSystem& m_jobs;
+    };
+}
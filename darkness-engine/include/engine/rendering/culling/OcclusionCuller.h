@@ -16,6 +16,7 @@ namespace engine
 {
     class Device;
     class CommandList;
+    class PipelinePrewarm;
     class Camera;
     class ModelResources;
     class ClusterExpansion;
@@ -26,6 +27,9 @@ namespace engine
     public:
         OcclusionCuller(Device& device);
 
+        // load time creation of the occlusion pipelines
+        void prewarm(PipelinePrewarm& prewarm);
+
         void occlusionCull(
             CommandList& cmd,
             Camera& camera,
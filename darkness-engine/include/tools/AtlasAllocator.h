@@ -27,6 +27,9 @@ namespace engine
         AtlasAllocation allocate();
         void free(const AtlasAllocation& allocation);
 
+        // cells that can be allocated without growing the atlas
+        int freeCount() const;
+
         Vector2<int> simulateSize(int allocationCount);
     protected:
         struct AtlasData
@@ -32,11 +32,14 @@ private:
     int m_mode;
     bool m_memoryFile;
 
+    // a memory file that did not decode
+    bool m_failed;
+
     engine::unique_ptr<engine::vector<char>> m_fileContents;
     engine::vector<char>* m_fileContentsActive;
     bool m_eof;
     size_t m_filePosition;
 
     void encode();
-    void decode();
+    bool decode();
 };
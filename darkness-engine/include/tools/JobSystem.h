@@ -0,0 +1,85 @@
+#pragma once
+
+#include "containers/vector.h"
+#include "containers/queue.h"
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace engine
+{
+    class JobSystem;
+
+    // jobs that are waited for together. the group has to outlive its jobs,
+    // the destructor waits for them.
+    class JobGroup
+    {
+    public:
+        using Job = std::function<void()>;
+
+        JobGroup(JobSystem& jobs);
+        ~JobGroup();
+
+        JobGroup(const JobGroup&) = delete;
+        JobGroup(JobGroup&&) = delete;
+        JobGroup& operator=(const JobGroup&) = delete;
+        JobGroup& operator=(JobGroup&&) = delete;
+
+        void run(Job job);
+
+        // runs the jobs of this group that no worker has picked up on the
+        // calling thread and returns when all of them are done. jobs of
+        // other groups are left to the workers.
+        void wait();
+
+    private:
+        friend class JobSystem;
+        JobSystem& m_jobs;
+        engine::queue<Job> m_pending;
+        size_t m_unfinished;
+        std::condition_variable m_done;
+    };
+
+    // the worker threads of the engine. systems that split their work into
+    // jobs share these instead of running threads of their own so the
+    // cores are not oversubscribed.
+    class JobSystem
+    {
+    public:
+        // shared by the engine. one worker per hardware thread but one,
+        // the thread that waits for the jobs is the last one.
+        static JobSystem& instance();
+
+        // with 0 workers every job runs on the thread that waits for it
+        JobSystem(size_t workerCount);
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem(JobSystem&&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+        JobSystem& operator=(JobSystem&&) = delete;
+
+        size_t workerCount() const { return m_workers.size(); }
+
+        // runs function(i) for every i in [0, count) and returns when all of
+        // them are done. the calling thread runs index 0 and helps with the rest
+        void parallelFor(size_t count, const std::function<void(size_t)>& function);
+
+    private:
+        friend class JobGroup;
+        std::mutex m_mutex;
+        std::condition_variable m_jobAvailable;
+
+        // groups with pending jobs, taken in turns
+        engine::vector<JobGroup*> m_ready;
+        bool m_alive;
+        engine::vector<std::thread> m_workers;
+
+        void worker();
+
+        // takes the next job of group. m_mutex is held
+        JobGroup::Job take(JobGroup& group);
+        void finished(JobGroup& group);
+    };
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "engine/rendering/ModelCpu.h"
+#include "engine/primitives/Vector3.h"
+#include "tools/JobSystem.h"
+#include "containers/vector.h"
+#include <cstdint>
+
+namespace engine
+{
+    // fifo post transform cache the statistics are measured with
+    constexpr uint32_t VertexCacheStatisticsSize = 16;
+
+    struct VertexCacheStatistics
+    {
+        // transformed vertexes per triangle. 0.5 is ideal for large meshes, 3 the worst
+        float acmr;
+
+        // transformed vertexes per referenced vertex. 1.0 is ideal
+        float atvr;
+    };
+
+    VertexCacheStatistics meshAnalyzeVertexCache(const uint32_t* index, size_t indexCount, uint32_t cacheSize = VertexCacheStatisticsSize);
+
+    // reorders the triangles for post transform cache reuse (Forsyth)
+    void meshOptimizeVertexCache(uint32_t* index, size_t indexCount);
+
+    // reorders runs of cache optimised triangles so that the outward facing
+    // ones draw first. the cache may get up to threshold times worse
+    void meshOptimizeOverdraw(uint32_t* index, size_t indexCount, const engine::vector<Vector3f>& vertex, float threshold = 1.05f);
+
+    // orders the vertex streams of the model by first use in index and
+    // remaps index and model.index. vertexes not in index go last
+    void meshOptimizeVertexFetch(ModelCpu& model, engine::vector<uint32_t>& index);
+
+    // cache and overdraw optimises every ClusterMaxSize chunk of clusterIndex
+    // on its own as jobs, then orders the vertexes by first use.
+    void meshOptimizeClusters(ModelCpu& model, engine::vector<uint32_t>& clusterIndex, JobSystem& jobs = JobSystem::instance());
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "engine/rendering/ModelCpu.h"
+#include "containers/vector.h"
+#include <limits>
+#include <cstdint>
+
+namespace engine
+{
+    struct SimplifySettings
+    {
+        // simplification stops at whichever is reached first
+        size_t targetTriangleCount = 0;
+        float targetError = std::numeric_limits<float>::max();
+
+        // model units that a difference of 1.0 in the attribute costs.
+        // zero leaves the attribute out of the error
+        float normalWeight = 0.0f;
+        float uvWeight = 0.0f;
+
+        // vertexes on the open edges of the index don't move. when the index
+        // is a part of a mesh this keeps the part border where it is
+        bool lockBorder = true;
+    };
+
+    struct SimplifyResult
+    {
+        // triangles that are left, in the order they were in the input
+        engine::vector<uint32_t> index;
+
+        // largest collapse error in model units
+        float error;
+    };
+
+    // quadric error edge collapse. vertexes collapse onto other vertexes,
+    // no new vertexes are created, so the result indexes the same vertex
+    // streams as the input. collapses that would flip a triangle or change
+    // the topology are not done. vertexes on uv or normal seams are locked.
+    SimplifyResult meshSimplify(const ModelCpu& model, const engine::vector<uint32_t>& index, const SimplifySettings& settings);
+}
@@ -4,6 +4,14 @@
 #include "containers/vector.h"
 #include "containers/unordered_map.h"
 #include "containers/memory.h"
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+
+namespace engine
+{
+    class MappedFile;
+}
 
 namespace tools
 {
@@ -14,45 +22,90 @@ namespace tools
     };
 
     class Settings;
+    template<typename T>
+    class SettingHandle;
+
     namespace implementation
     {
-        class SettingsContainer : public std::enable_shared_from_this<SettingsContainer>
+        enum class SettingType : uint32_t
         {
-        private:
-            mutable engine::unordered_map<engine::string, bool> m_bools;
-            mutable engine::unordered_map<engine::string, char> m_chars;
-            mutable engine::unordered_map<engine::string, short> m_shorts;
-            mutable engine::unordered_map<engine::string, int> m_ints;
-            mutable engine::unordered_map<engine::string, int64_t> m_bigints;
-            mutable engine::unordered_map<engine::string, unsigned char> m_uchars;
-            mutable engine::unordered_map<engine::string, unsigned short> m_ushorts;
-            mutable engine::unordered_map<engine::string, unsigned int> m_uints;
-            mutable engine::unordered_map<engine::string, uint64_t> m_biguints;
-            mutable engine::unordered_map<engine::string, float> m_floats;
-            mutable engine::unordered_map<engine::string, double> m_doubles;
-            mutable engine::unordered_map<engine::string, engine::string> m_strings;
-            
-            mutable engine::unordered_map<engine::string, engine::vector<bool>> m_boolVectors;
-            mutable engine::unordered_map<engine::string, engine::vector<char>> m_charVectors;
-            mutable engine::unordered_map<engine::string, engine::vector<short>> m_shortVectors;
-            mutable engine::unordered_map<engine::string, engine::vector<int>> m_intVectors;
-            mutable engine::unordered_map<engine::string, engine::vector<int64_t>> m_bigintVectors;
-            mutable engine::unordered_map<engine::string, engine::vector<unsigned char>> m_ucharVectors;
-            mutable engine::unordered_map<engine::string, engine::vector<unsigned short>> m_ushortVectors;
-            mutable engine::unordered_map<engine::string, engine::vector<unsigned int>> m_uintVectors;
-            mutable engine::unordered_map<engine::string, engine::vector<uint64_t>> m_biguintVectors;
-            mutable engine::unordered_map<engine::string, engine::vector<float>> m_floatVectors;
-            mutable engine::unordered_map<engine::string, engine::vector<double>> m_doubleVectors;
-            mutable engine::unordered_map<engine::string, engine::vector<engine::string>> m_stringVectors;
+            Bool,
+            Char,
+            Short,
+            Int,
+            Int64,
+            UChar,
+            UShort,
+            UInt,
+            UInt64,
+            Float,
+            Double,
+            String,
+
+            BoolVector,
+            CharVector,
+            ShortVector,
+            IntVector,
+            Int64Vector,
+            UCharVector,
+            UShortVector,
+            UIntVector,
+            UInt64Vector,
+            FloatVector,
+            DoubleVector,
+            StringVector,
+
+            Count
+        };
+
+        template<typename T> struct SettingTypeOf;
+        template<> struct SettingTypeOf<bool> { static constexpr SettingType value = SettingType::Bool; };
+        template<> struct SettingTypeOf<char> { static constexpr SettingType value = SettingType::Char; };
+        template<> struct SettingTypeOf<short> { static constexpr SettingType value = SettingType::Short; };
+        template<> struct SettingTypeOf<int> { static constexpr SettingType value = SettingType::Int; };
+        template<> struct SettingTypeOf<int64_t> { static constexpr SettingType value = SettingType::Int64; };
+        template<> struct SettingTypeOf<unsigned char> { static constexpr SettingType value = SettingType::UChar; };
+        template<> struct SettingTypeOf<unsigned short> { static constexpr SettingType value = SettingType::UShort; };
+        template<> struct SettingTypeOf<unsigned int> { static constexpr SettingType value = SettingType::UInt; };
+        template<> struct SettingTypeOf<uint64_t> { static constexpr SettingType value = SettingType::UInt64; };
+        template<> struct SettingTypeOf<float> { static constexpr SettingType value = SettingType::Float; };
+        template<> struct SettingTypeOf<double> { static constexpr SettingType value = SettingType::Double; };
+        template<> struct SettingTypeOf<engine::string> { static constexpr SettingType value = SettingType::String; };
+
+        template<> struct SettingTypeOf<engine::vector<bool>> { static constexpr SettingType value = SettingType::BoolVector; };
+        template<> struct SettingTypeOf<engine::vector<char>> { static constexpr SettingType value = SettingType::CharVector; };
+        template<> struct SettingTypeOf<engine::vector<short>> { static constexpr SettingType value = SettingType::ShortVector; };
+        template<> struct SettingTypeOf<engine::vector<int>> { static constexpr SettingType value = SettingType::IntVector; };
+        template<> struct SettingTypeOf<engine::vector<int64_t>> { static constexpr SettingType value = SettingType::Int64Vector; };
+        template<> struct SettingTypeOf<engine::vector<unsigned char>> { static constexpr SettingType value = SettingType::UCharVector; };
+        template<> struct SettingTypeOf<engine::vector<unsigned short>> { static constexpr SettingType value = SettingType::UShortVector; };
+        template<> struct SettingTypeOf<engine::vector<unsigned int>> { static constexpr SettingType value = SettingType::UIntVector; };
+        template<> struct SettingTypeOf<engine::vector<uint64_t>> { static constexpr SettingType value = SettingType::UInt64Vector; };
+        template<> struct SettingTypeOf<engine::vector<float>> { static constexpr SettingType value = SettingType::FloatVector; };
+        template<> struct SettingTypeOf<engine::vector<double>> { static constexpr SettingType value = SettingType::DoubleVector; };
+        template<> struct SettingTypeOf<engine::vector<engine::string>> { static constexpr SettingType value = SettingType::StringVector; };
+
+        // entries are kept sorted by hash, type and key so a lookup is a
+        // binary search that only compares strings once the hashes match.
+        // offsets are relative to the key and data blocks of the container,
+        // the same way they are stored in the binary file.
+        struct SettingEntry
+        {
+            uint64_t hash;
+            uint32_t keyOffset;
+            uint32_t keyLength;
+            uint32_t type;
+            uint32_t size;
+            uint64_t offset;
+        };
 
+        class SettingsContainer : public std::enable_shared_from_this<SettingsContainer>
+        {
         public:
             SettingsContainer(const engine::string& groupName);
             engine::vector<engine::string> keys() const;
             engine::vector<engine::string> groups() const;
 
-            template<typename T>
-            void set(const engine::string& key, const engine::vector<T>& value);
-
             template<typename T>
             void set(const engine::string& key, const T& value);
 
@@ -63,7 +116,10 @@ namespace tools
             bool hasKey(const engine::string& key) const;
 
         protected:
-            friend class Settings;
+            friend class tools::Settings;
+            template<typename T>
+            friend class tools::SettingHandle;
+
             engine::shared_ptr<implementation::SettingsContainer> m_parent;
             engine::string m_groupName;
             engine::unordered_map<engine::string, engine::shared_ptr<implementation::SettingsContainer>> m_childs;
@@ -71,10 +127,94 @@ namespace tools
             void readJson(void* _obj);
             void writeJson(void* _writer);
 
-            void writeBinary();
+            // appends the entries, keys and values of this container only
+            void writeBinary(
+                engine::vector<SettingEntry>& entries,
+                engine::vector<char>& keys,
+                engine::vector<uint8_t>& data) const;
+
+            // use the entries, keys and values of a mapped file as they are
+            void readBinary(
+                const engine::shared_ptr<engine::MappedFile>& file,
+                SettingEntry* entries, size_t entryCount,
+                const char* keys, size_t keyBytes,
+                uint8_t* data, size_t dataBytes);
+
+            // copy everything out of the mapped file, in the whole tree
+            void detach();
+
+            bool changed() const;
+            void clearChanged();
+
+            const SettingEntry* find(const engine::string& key, SettingType type) const;
+
+        private:
+            // these point either to the owned vectors or into a mapped file.
+            // values are 8 byte aligned
+            SettingEntry* m_entries;
+            size_t m_entryCount;
+            const char* m_keys;
+            size_t m_keyBytes;
+            uint8_t* m_data;
+            size_t m_dataBytes;
+
+            engine::vector<SettingEntry> m_ownedEntries;
+            engine::vector<char> m_ownedKeys;
+            engine::vector<uint64_t> m_ownedData;
+            engine::shared_ptr<engine::MappedFile> m_file;
+            bool m_changed;
+
+            size_t lowerBound(uint64_t hash, SettingType type, const engine::string& key) const;
+            uint8_t* storage(const engine::string& key, SettingType type, uint32_t size);
+            void detachContainer();
+            void updateViews();
         };
     }
 
+    // a value resolved once from a settings group. get and set go straight
+    // to the value, the key is not looked up again. the handle stays valid
+    // when keys are added to the group and when the settings are saved.
+    template<typename T>
+    class SettingHandle
+    {
+        static_assert(std::is_arithmetic<T>::value, "SettingHandle supports only scalar types");
+    public:
+        SettingHandle()
+            : m_container{ nullptr }
+            , m_offset{ 0 }
+        {}
+
+        bool valid() const
+        {
+            return m_container != nullptr;
+        }
+
+        T get() const
+        {
+            if (std::is_same<T, bool>::value)
+                return static_cast<T>(m_container->m_data[m_offset] != 0);
+            T value;
+            memcpy(&value, m_container->m_data + m_offset, sizeof(T));
+            return value;
+        }
+
+        void set(const T& value)
+        {
+            memcpy(m_container->m_data + m_offset, &value, sizeof(T));
+            m_container->m_changed = true;
+        }
+
+    private:
+        friend class Settings;
+        SettingHandle(const engine::shared_ptr<implementation::SettingsContainer>& container, uint64_t offset)
+            : m_container{ container }
+            , m_offset{ offset }
+        {}
+
+        engine::shared_ptr<implementation::SettingsContainer> m_container;
+        uint64_t m_offset;
+    };
+
     class Settings
     {
     public:
@@ -84,6 +224,10 @@ namespace tools
 
         void save();
 
+        // save to another file and keep using it from now on.
+        // also converts between the backends
+        void save(const engine::string& settingsPath, SettingsBackend backend);
+
         Settings(const Settings&) = default;
         Settings(Settings&&) = default;
         Settings& operator=(const Settings&) = default;
@@ -127,6 +271,21 @@ namespace tools
                 return defaultValue;
             }
         }
+
+        // key in the current group, added with the default value if missing
+        template<typename T>
+        SettingHandle<T> handle(const engine::string& key, const T& defaultValue = T{})
+        {
+            auto type = implementation::SettingTypeOf<T>::value;
+            auto entry = m_currentNode->find(key, type);
+            if (!entry)
+            {
+                m_currentNode->set(key, defaultValue);
+                m_changed = true;
+                entry = m_currentNode->find(key, type);
+            }
+            return SettingHandle<T>(m_currentNode, entry->offset);
+        }
     private:
         engine::shared_ptr<implementation::SettingsContainer> m_rootNode;
         engine::shared_ptr<implementation::SettingsContainer> m_currentNode;
@@ -162,6 +162,9 @@ namespace engine
             virtual void copyTexture(Device& device, const CpuTexture& texture, TextureSRV dst) = 0;
 
             virtual TextureBufferCopyDesc getTextureBufferCopyDesc(size_t width, size_t height, Format format) = 0;
+
+            virtual bool reservedBuffersSupported() const = 0;
+            virtual void commitBuffer(Buffer buffer, size_t bytes) = 0;
         };
     }
 }
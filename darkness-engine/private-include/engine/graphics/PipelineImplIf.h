@@ -82,6 +82,10 @@ namespace engine
             virtual void setRenderTargetFormat(Format RTVFormat, Format DSVFormat, unsigned int msaaCount = 1, unsigned int msaaQuality = 0) = 0;
             virtual void setRenderTargetFormats(engine::vector<Format> RTVFormats, Format DSVFormat, unsigned int msaaCount = 1, unsigned int msaaQuality = 0) = 0;
             virtual void configure(CommandListImplIf* commandList, shaders::PipelineConfiguration* configuration) = 0;
+
+            // create the api pipeline of the current permutation before the first bind.
+            // backends that create pipelines cheaply at bind time don't need this
+            virtual void prewarm(shaders::PipelineConfiguration* /*configuration*/) {};
         };
     }
 }
\ No newline at end of file
@@ -53,6 +53,9 @@ namespace engine
 
     constexpr const std::size_t InvalidElementsValue = static_cast<std::size_t>(-1);
     constexpr const std::size_t InvalidElementSizeValue = static_cast<std::size_t>(-1);
+
+    // reserved buffers are committed in pages of this size (the D3D12 tile size)
+    constexpr const std::size_t ReservedBufferPageBytes = 64u * 1024u;
     struct BufferDescription
     {
 
@@ -68,6 +71,7 @@ namespace engine
             bool indirectArgument = false;
             bool indexBuffer = false;
             bool vertexBuffer = false;
+            bool reserved = false;
             const char* name = nullptr;
         };
         Descriptor descriptor;
@@ -112,6 +116,13 @@ namespace engine
             descriptor.indirectArgument = value;
             return *this;
         }
+        // only address space is reserved for the elements.
+        // memory is added with Device::commitBuffer
+        BufferDescription& reserved(bool value)
+        {
+            descriptor.reserved = value;
+            return *this;
+        }
         BufferDescription& name(const char* value)
         {
             descriptor.name = value;
@@ -325,6 +336,9 @@ namespace engine
             virtual const BufferDescription::Descriptor& description() const = 0;
             virtual ResourceState state() const = 0;
             virtual void state(ResourceState _state) = 0;
+
+            // bytes backed by memory. all of them unless the buffer is reserved
+            virtual size_t committedBytes() const = 0;
         };
 
         class BufferSRVImplIf
@@ -431,6 +445,12 @@ namespace engine
 
             virtual ResourceState state(int slice, int mip) const = 0;
             virtual void state(int slice, int mip, ResourceState state) = 0;
+
+            // whole resource
+            virtual void state(ResourceState state) = 0;
+
+            // true when every subresource is in the same state. constant time
+            virtual bool uniformState(ResourceState& state) const = 0;
         };
 
         class TextureSRVImplIf
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "engine/graphics/CommonNoDep.h"
+#include "containers/vector.h"
+#include <cstddef>
+
+namespace engine
+{
+    namespace implementation
+    {
+        // per subresource resource states of a texture.
+        //
+        // keeps count of the subresources that differ from the first one
+        // so asking if the whole texture is in one state doesn't walk
+        // every slice and mip.
+        class SubresourceStates
+        {
+        public:
+            SubresourceStates(size_t slices, size_t mips, ResourceState initial = ResourceState::Common)
+                : m_states(slices * mips, initial)
+                , m_mips{ mips }
+                , m_differing{ 0 }
+            {}
+
+            ResourceState state(int slice, int mip) const
+            {
+                return m_states[index(slice, mip)];
+            }
+
+            void state(int slice, int mip, ResourceState state)
+            {
+                auto i = index(slice, mip);
+                if (m_states[i] == state)
+                    return;
+
+                if (i == 0)
+                {
+                    // the reference changed. recount
+                    m_states[0] = state;
+                    m_differing = 0;
+                    for (auto&& s : m_states)
+                        if (s != state)
+                            ++m_differing;
+                    return;
+                }
+
+                if (m_states[i] == m_states[0])
+                    ++m_differing;
+                else if (state == m_states[0])
+                    --m_differing;
+                m_states[i] = state;
+            }
+
+            // whole resource
+            void state(ResourceState state)
+            {
+                for (auto&& s : m_states)
+                    s = state;
+                m_differing = 0;
+            }
+
+            // true when every subresource is in the same state
+            bool uniform() const { return m_differing == 0; }
+
+            // only meaningful when uniform
+            ResourceState uniformState() const { return m_states[0]; }
+
+        private:
+            engine::vector<ResourceState> m_states;
+            size_t m_mips;
+            size_t m_differing;
+
+            size_t index(int slice, int mip) const
+            {
+                return static_cast<size_t>(mip) + (static_cast<size_t>(slice) * m_mips);
+            }
+        };
+    }
+}
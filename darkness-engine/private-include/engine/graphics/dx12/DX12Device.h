@@ -117,6 +117,9 @@ namespace engine
             void copyTexture(Device& device, const CpuTexture& texture, TextureSRV dst) override;
 
             TextureBufferCopyDesc getTextureBufferCopyDesc(size_t width, size_t height, Format format) override;
+
+            bool reservedBuffersSupported() const override;
+            void commitBuffer(Buffer buffer, size_t bytes) override;
         public:
             ID3D12Device* device() const;
 #ifdef DXR_BUILD
@@ -143,6 +146,7 @@ namespace engine
 #endif
 			engine::shared_ptr<Fence> m_graphicsQueueUploadFence;
             engine::shared_ptr<Fence> m_copyQueueUploadFence;
+            engine::shared_ptr<Fence> m_commitFence;
 			Queue* m_deviceGraphicsQueue;
             Queue* m_deviceCopyQueue;
             BufferSRVOwner m_grabBuffer;
@@ -153,6 +157,7 @@ namespace engine
             engine::shared_ptr<NullResources> m_nullResources;
             FenceStorageDX12 m_fenceStorage;
             int m_currentHeap;
+            bool m_reservedBuffers;
             GpuMarkerStorage m_gpuMarkerStorage;
 
 			struct UploadAllocation
@@ -166,6 +171,8 @@ namespace engine
 
 #ifdef UPLOADBUFFER_MEMORYALLOCATOR_RINGBUFFER
             tools::RingBuffer m_allocator;
+            std::mutex m_uploadMutex;
+            tools::RingBuffer::AllocStruct allocateUpload(size_t bytes);
 #endif
 
 #ifdef UPLOADBUFFER_MEMORYALLOCATOR_ALIGNEDCHUNKS
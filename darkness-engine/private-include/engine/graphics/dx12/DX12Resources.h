@@ -1,6 +1,7 @@
 #pragma once
 
 #include "engine/graphics/ResourcesImplIf.h"
+#include "engine/graphics/SubresourceStates.h"
 #include "engine/graphics/Resources.h"
 #include "engine/graphics/Device.h"
 #include "engine/graphics/dx12/DX12Headers.h"
@@ -42,6 +43,10 @@ namespace engine
             const BufferDescription::Descriptor& description() const override;
             ResourceState state() const override;
             void state(ResourceState _state) override;
+            size_t committedBytes() const override;
+
+            // maps memory to the reserved buffer up to bytes
+            void commit(const DeviceImplDX12& device, ID3D12CommandQueue* queue, size_t bytes);
 
             ID3D12Resource* native() const;
 			bool operator==(const BufferImplDX12& buff) const;
@@ -51,6 +56,8 @@ namespace engine
             tools::ComPtr<ID3D12Resource> m_buffer;
             ResourceState m_state;
             size_t m_bufferSize;
+            size_t m_committedBytes;
+            engine::vector<tools::ComPtr<ID3D12Heap>> m_heaps;
         };
 
         class BufferSRVImplDX12 : public BufferSRVImplIf
@@ -308,13 +315,15 @@ namespace engine
 
             ResourceState state(int slice, int mip) const override;
             void state(int slice, int mip, ResourceState state) override;
+            void state(ResourceState state) override;
+            bool uniformState(ResourceState& state) const override;
 
 			bool operator==(const TextureImplDX12& tex) const;
 
         protected:
             TextureDescription::Descriptor m_description;
             tools::ComPtr<ID3D12Resource> m_texture;
-            engine::vector<ResourceState> m_state;
+            SubresourceStates m_state;
 			bool m_attached;
         };
 
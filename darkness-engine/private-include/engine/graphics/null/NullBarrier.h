@@ -0,0 +1,48 @@
+#pragma once
+
+#include "engine/graphics/BarrierImplIf.h"
+
+namespace engine
+{
+    class CommandList;
+    class TextureRTV;
+    class Semaphore;
+    enum class ResourceBarrierFlags;
+    enum class ResourceState;
+
+    namespace implementation
+    {
+        class TextureImplIf;
+
+        // applies the state change right away and counts it
+        class BarrierImplNull : public BarrierImplIf
+        {
+        public:
+            BarrierImplNull(
+                const CommandList& commandList,
+                ResourceBarrierFlags flags,
+                const TextureRTV& resource,
+                ResourceState before,
+                ResourceState after,
+                unsigned int subResource,
+                const Semaphore& waitSemaphore,
+                const Semaphore& signalSemaphore);
+
+            BarrierImplNull(const BarrierImplNull&) = delete;
+            BarrierImplNull(BarrierImplNull&&) = delete;
+            BarrierImplNull& operator=(const BarrierImplNull&) = delete;
+            BarrierImplNull& operator=(BarrierImplNull&&) = delete;
+
+            void update(
+                ResourceState before,
+                ResourceState after) override;
+        private:
+            const CommandList& m_commandList;
+            TextureImplIf* m_texture;
+            int m_slice;
+            int m_mip;
+
+            void apply(ResourceState after);
+        };
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "engine/graphics/CommandAllocatorImplIf.h"
+#include "engine/graphics/CommonNoDep.h"
+
+namespace engine
+{
+    namespace implementation
+    {
+        class DeviceImplNull;
+        class CommandAllocatorImplNull : public CommandAllocatorImplIf
+        {
+        public:
+            CommandAllocatorImplNull(const DeviceImplNull& device, CommandListType type, const char* name);
+
+            void reset() override;
+            CommandListType type() const override;
+        private:
+            CommandListType m_type;
+        };
+    }
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "engine/graphics/CommandListImplIf.h"
+#include "engine/graphics/CommonNoDep.h"
+#include "engine/graphics/CommandListAbs.h"
+#include "engine/graphics/GpuMarkerStorage.h"
+#include "engine/graphics/Resources.h"
+#include "engine/graphics/Viewport.h"
+#include "engine/graphics/Rect.h"
+
+#include "containers/vector.h"
+#include "containers/memory.h"
+
+namespace engine
+{
+    namespace shaders
+    {
+        class PipelineConfiguration;
+    }
+
+    enum class ResourceState;
+    class Color4f;
+    class Device;
+    struct QueryResultTicks;
+
+    namespace implementation
+    {
+        class DeviceImplNull;
+        class CommandAllocatorImplNull;
+
+        // executes copies and clears on the CPU copies of the resources as they
+        // are recorded. draws and dispatches are only counted.
+        class CommandListImplNull : public CommandListImplIf
+        {
+        public:
+            CommandListAbs& abs() override { return m_abs; };
+
+            CommandListImplNull(Device* device, CommandListType type, const char* name);
+            CommandListImplNull(const CommandListImplNull&) = delete;
+            CommandListImplNull(CommandListImplNull&&) = delete;
+            CommandListImplNull& operator=(const CommandListImplNull&) = delete;
+            CommandListImplNull& operator=(CommandListImplNull&&) = delete;
+            ~CommandListImplNull();
+
+            CommandListType type() const override;
+            void reset(implementation::PipelineImplIf* pipelineState) override;
+            void clear() override;
+            bool isOpen() const override;
+            const char* name() const { return m_abs.m_name; }
+
+            void setRenderTargets(engine::vector<TextureRTV> targets) override;
+            void setRenderTargets(engine::vector<TextureRTV> targets, TextureDSV dsv) override;
+            void setRenderTargets(TextureDSV target) override;
+
+            void copyBuffer(Buffer srcBuffer, Buffer dstBuffer, uint64_t elements, size_t srcStartElement = 0, size_t dstStartElement = 0) override;
+            void copyBufferBytes(Buffer srcBuffer, Buffer dstBuffer, uint64_t bytes, size_t srcStartByte = 0, size_t dstStartByte = 0) override;
+
+            void clearBuffer(BufferUAV buffer, uint32_t value, size_t startElement, size_t numElements) override;
+
+            void copyTexture(TextureSRV src, TextureUAV dst) override;
+            void copyTexture(TextureSRV src, TextureSRV dst) override;
+            void copyTexture(TextureSRV src, TextureDSV dst) override;
+            void copyTexture(TextureSRV src, BufferUAV dst) override;
+            void copyTexture(TextureSRV src, BufferSRV dst) override;
+            void copyTexture(
+                Buffer      srcBuffer,
+                size_t      srcOffset,
+                size_t      srcWidth,
+                size_t      srcHeight,
+                size_t      srcRowPitch,
+                Texture     dst,
+                size_t      dstX,
+                size_t      dstY,
+                size_t      dstMip,
+                size_t      dstSlice,
+                size_t      dstMipCount) override;
+
+            void clearTextureUAV(TextureUAV texture, const Color4f& color) override;
+            void clearTextureDSV(TextureDSV texture, float depth, uint8_t stencil) override;
+            void clearTextureRTV(TextureRTV texture, const Color4f& color) override;
+
+            void draw(size_t vertexCount) override;
+            void drawIndirect(Buffer indirectArguments, uint64_t argumentBufferOffset) override;
+            void drawIndexedInstanced(size_t indexCount, size_t instanceCount, size_t firstIndex, int32_t vertexOffset, size_t firstInstance) override;
+            void drawIndexedIndirect(Buffer indirectArguments, uint64_t argumentBufferOffset) override;
+            void drawIndexedInstancedIndirect(
+                BufferIBV indexBuffer,
+                Buffer indirectArguments,
+                uint64_t argumentBufferOffset,
+                Buffer indirectArgumentsCountBuffer,
+                uint64_t countBufferOffset) override;
+            void executeIndexedIndirect(BufferIBV indexBuffer, Buffer indirectArguments, uint64_t argumentBufferOffset, Buffer countBuffer, uint64_t countBufferOffsetBytes) override;
+
+            void dispatch(size_t threadGroupCountX, size_t threadGroupCountY, size_t threadGroupCountZ) override;
+            void dispatchIndirect(Buffer indirectArguments, uint64_t argumentBufferOffset) override;
+            void executeBundle(CommandListImplIf* commandList) override;
+            void dispatchMesh(size_t threadGroupCountX, size_t threadGroupCountY, size_t threadGroupCountZ) override;
+
+            void transition(Texture resource, ResourceState state, const SubResource& subResource = SubResource()) override;
+            void transition(TextureRTV resource, ResourceState state) override;
+            void transition(TextureSRV resource, ResourceState state) override;
+            void transition(TextureDSV resource, ResourceState state) override;
+
+            void transition(Buffer resource, ResourceState state) override;
+            void transition(BufferSRV resource, ResourceState state) override;
+            void transition(BufferIBV resource, ResourceState state) override;
+            void transition(BufferCBV resource, ResourceState state) override;
+            void transition(BufferVBV resource, ResourceState state) override;
+
+            void setPredicate(BufferSRV buffer, uint64_t offset, PredicationOp op) override;
+
+            void applyBarriers() override;
+
+            void bindPipe(
+                implementation::PipelineImplIf* pipelineImpl,
+                shaders::PipelineConfiguration* configuration) override;
+
+            void setViewPorts(const engine::vector<Viewport>& viewports) override;
+            void setScissorRects(const engine::vector<Rectangle>& rects) override;
+
+            void bindVertexBuffer(BufferVBV buffer) override;
+            void bindIndexBuffer(BufferIBV buffer) override;
+
+            void setStructureCounter(BufferUAV buffer, uint32_t value) override;
+            void copyStructureCounter(BufferUAV srcBuffer, Buffer dst, uint32_t dstByteOffset) override;
+
+            void begin() override;
+            void end() override;
+
+            void beginRenderPass(implementation::PipelineImplIf* pipeline, int frameBufferIndex) override;
+            void endRenderPass() override;
+
+            uint32_t startQuery(const char* query) override;
+            void stopQuery(uint32_t queryId) override;
+            void resolveQueries() override;
+
+            engine::vector<QueryResultTicks> fetchQueryResults(uint64_t freq) override;
+
+            // what the recorded work left bound. useful for checking a renderer
+            // without a GPU.
+            const engine::vector<TextureRTV>& renderTargets() const { return m_renderTargets; }
+            TextureDSV depthStencil() const { return m_depthStencil; }
+            BufferVBV vertexBuffer() const { return m_vertexBuffer; }
+            BufferIBV indexBuffer() const { return m_indexBuffer; }
+            const engine::vector<Viewport>& viewports() const { return m_viewports; }
+            const engine::vector<Rectangle>& scissorRects() const { return m_scissorRects; }
+            implementation::PipelineImplIf* pipeline() const { return m_pipeline; }
+            size_t pendingBarriers() const { return m_barriers; }
+        private:
+            Device* m_device;
+            const DeviceImplNull& m_nullDevice;
+            CommandListType m_type;
+            CommandListAbs m_abs;
+            engine::unique_ptr<GpuMarkerContainer> m_gpuMarkers;
+            engine::shared_ptr<CommandAllocatorImplNull> m_allocator;
+            bool m_open;
+            bool m_resolved;
+            bool m_pipeBound;
+            size_t m_barriers;
+
+            implementation::PipelineImplIf* m_pipeline;
+            engine::vector<TextureRTV> m_renderTargets;
+            TextureDSV m_depthStencil;
+            BufferVBV m_vertexBuffer;
+            BufferIBV m_indexBuffer;
+            engine::vector<Viewport> m_viewports;
+            engine::vector<Rectangle> m_scissorRects;
+            engine::vector<uint64_t> m_timestamps;
+
+            void copyBytes(Buffer dst, size_t dstByte, const uint8_t* src, size_t bytes);
+            void copySubresource(Texture src, Texture dst);
+            void copyToBuffer(Texture src, Buffer dst, size_t rowPitch);
+            void writeTimestamp(uint32_t queryId);
+        };
+    }
+}
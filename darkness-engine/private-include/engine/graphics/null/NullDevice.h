@@ -0,0 +1,111 @@
+#pragma once
+
+#include "engine/graphics/DeviceImplIf.h"
+#include "engine/graphics/null/NullStatistics.h"
+#include "engine/graphics/GpuMarkerStorage.h"
+#include "engine/graphics/ResourceOwners.h"
+#include "tools/ByteRange.h"
+#include "containers/memory.h"
+#include "containers/vector.h"
+#include "containers/string.h"
+#include <mutex>
+
+namespace platform
+{
+    class Window;
+}
+
+namespace engine
+{
+    class Buffer;
+    class BufferSRV;
+    class BufferUAV;
+    class BufferIBV;
+    class BufferCBV;
+    class BufferVBV;
+    class Queue;
+    class Device;
+    class CommandList;
+    struct NullResources;
+    enum class Format;
+    struct TextureDescription;
+
+    namespace implementation
+    {
+        // size reported when the device has no window
+        constexpr int NullDeviceDefaultWidth = 1280;
+        constexpr int NullDeviceDefaultHeight = 720;
+
+        // device without a GPU. resources live in CPU memory, work is
+        // executed (or just counted) at record time and fences complete
+        // as soon as they are signaled.
+        class DeviceImplNull : public DeviceImplIf
+        {
+        public:
+            DeviceImplNull(engine::shared_ptr<platform::Window> window);
+
+            void createFences(Device& device) override;
+
+            DeviceImplNull(const DeviceImplNull&) = delete;
+            DeviceImplNull(DeviceImplNull&&) = delete;
+            DeviceImplNull& operator=(const DeviceImplNull&) = delete;
+            DeviceImplNull& operator=(DeviceImplNull&&) = delete;
+
+            void nullResources(engine::shared_ptr<NullResources> nullResources) override;
+            NullResources& nullResources() override;
+
+            engine::shared_ptr<TextureImplIf> createTexture(const Device& device, Queue& queue, const TextureDescription& desc) override;
+            void uploadBuffer(CommandList& commandList, BufferSRV buffer, const tools::ByteRange& data, size_t startElement = 0) override;
+            void uploadBuffer(CommandList& commandList, BufferUAV buffer, const tools::ByteRange& data, size_t startElement = 0) override;
+            void uploadBuffer(CommandList& commandList, BufferCBV buffer, const tools::ByteRange& data, size_t startElement = 0) override;
+            void uploadBuffer(CommandList& commandList, BufferIBV buffer, const tools::ByteRange& data, size_t startElement = 0) override;
+            void uploadBuffer(CommandList& commandList, BufferVBV buffer, const tools::ByteRange& data, size_t startElement = 0) override;
+
+            void uploadRawBuffer(CommandListImplIf* commandList, Buffer buffer, const tools::ByteRange& data, size_t startBytes) override;
+
+            const platform::Window& window() const override;
+            void window(engine::shared_ptr<platform::Window> window) override;
+            int width() const override;
+            int height() const override;
+
+            void waitForIdle() override;
+
+            engine::shared_ptr<CommandAllocatorImplIf> createCommandAllocator(CommandListType type, const char* name) override;
+            void freeCommandAllocator(engine::shared_ptr<CommandAllocatorImplIf> allocator) override;
+
+            engine::unique_ptr<GpuMarkerContainer> getMarkerContainer() override;
+            void returnMarkerContainer(engine::unique_ptr<GpuMarkerContainer>&& container) override;
+
+            void setCurrentFenceValue(CommandListType type, engine::FenceValue value) override;
+            void processUploads(engine::FenceValue value, bool force = false) override;
+
+            CpuTexture grabTexture(Device& device, TextureSRV texture) override;
+            TextureSRVOwner loadTexture(Device& device, const CpuTexture& texture) override;
+            void copyTexture(Device& device, const CpuTexture& texture, TextureSRV dst) override;
+
+            TextureBufferCopyDesc getTextureBufferCopyDesc(size_t width, size_t height, Format format) override;
+
+            bool reservedBuffersSupported() const override;
+            void commitBuffer(Buffer buffer, size_t bytes) override;
+
+            NullStatistics& statistics() const { return m_statistics; }
+
+            // names of the submitted command lists in submit order. only
+            // kept while logging is on so long runs do not grow the log
+            void logSubmits(bool enabled);
+            void submitted(const char* commandList) const;
+            engine::vector<engine::string> submits() const;
+        private:
+            engine::shared_ptr<platform::Window> m_window;
+            engine::shared_ptr<NullResources> m_nullResources;
+            GpuMarkerStorage m_gpuMarkerStorage;
+            mutable NullStatistics m_statistics;
+
+            mutable std::mutex m_submitMutex;
+            bool m_logSubmits;
+            mutable engine::vector<engine::string> m_submits;
+
+            void uploadBufferInternal(Buffer buffer, const tools::ByteRange& data, size_t startBytes);
+        };
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "engine/graphics/FenceImplIf.h"
+#include <mutex>
+#include <condition_variable>
+
+namespace engine
+{
+    namespace implementation
+    {
+        class DeviceImplIf;
+        class DeviceImplNull;
+
+        // completes when a queue signals it. there is no GPU behind the
+        // queue so that happens at submit time.
+        class FenceImplNull : public FenceImplIf
+        {
+        public:
+            FenceImplNull(const DeviceImplIf* device, const char* name);
+
+            FenceImplNull(const FenceImplNull&) = delete;
+            FenceImplNull(FenceImplNull&&) = delete;
+            FenceImplNull& operator=(const FenceImplNull&) = delete;
+            FenceImplNull& operator=(FenceImplNull&&) = delete;
+
+            void increaseCPUValue() override;
+            engine::FenceValue currentCPUValue() const override;
+            engine::FenceValue currentGPUValue() const override;
+
+            void blockUntilSignaled() override;
+            void blockUntilSignaled(engine::FenceValue value) override;
+
+            bool signaled() const override;
+            bool signaled(engine::FenceValue value) const override;
+
+            void reset() override;
+
+            void signal(engine::FenceValue value);
+
+        private:
+            const DeviceImplNull* m_device;
+            mutable std::mutex m_mutex;
+            std::condition_variable m_signal;
+            FenceValue m_fenceValue;
+            FenceValue m_completedValue;
+        };
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "engine/graphics/GpuMarkerImplIf.h"
+#include <cstdint>
+
+namespace engine
+{
+    class CommandList;
+
+    namespace implementation
+    {
+        class CommandListImplNull;
+
+        class GpuMarkerImplNull : public GpuMarkerImplIf
+        {
+        public:
+            GpuMarkerImplNull(CommandList& cmd, const char* msg);
+            ~GpuMarkerImplNull();
+
+        private:
+            CommandListImplNull* cmdList;
+            uint32_t m_queryId;
+        };
+
+        class CpuMarkerImplNull
+        {
+        public:
+            CpuMarkerImplNull(const char* msg);
+            ~CpuMarkerImplNull();
+        };
+    }
+}
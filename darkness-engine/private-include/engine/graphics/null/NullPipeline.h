@@ -0,0 +1,72 @@
+#pragma once
+
+#include "engine/graphics/PipelineImplIf.h"
+#include "engine/graphics/Pipeline.h"
+#include "containers/vector.h"
+
+namespace engine
+{
+    namespace shaders
+    {
+        class PipelineConfiguration;
+        class Shader;
+    }
+
+    class Device;
+    class ShaderStorage;
+
+    namespace implementation
+    {
+        class CommandListImplIf;
+        class CommandListImplNull;
+        class DeviceImplNull;
+
+        // keeps the state it was given and counts the resources the shaders bind
+        class PipelineImplNull : public PipelineImplIf
+        {
+        public:
+            PipelineImplNull(
+                Device& device,
+                ShaderStorage& storage);
+
+            void setBlendState(const BlendDescription& desc) override;
+            void setRasterizerState(const RasterizerDescription& desc) override;
+            void setDepthStencilState(const DepthStencilDescription& desc) override;
+            void setSampleMask(unsigned int mask) override;
+            void setPrimitiveTopologyType(PrimitiveTopologyType type, bool adjacency = false) override;
+            void setPrimitiveRestart(IndexBufferStripCutValue value) override;
+            void setRenderTargetFormat(Format RTVFormat, Format DSVFormat, unsigned int msaaCount = 1, unsigned int msaaQuality = 0) override;
+            void setRenderTargetFormats(engine::vector<Format> RTVFormats, Format DSVFormat, unsigned int msaaCount = 1, unsigned int msaaQuality = 0) override;
+
+            void configure(CommandListImplIf* cmdList, shaders::PipelineConfiguration* configuration) override;
+            void prewarm(shaders::PipelineConfiguration* configuration) override;
+
+            bool compute() const { return m_compute; }
+            PrimitiveTopologyType topology() const { return m_topology; }
+            const engine::vector<Format>& renderTargetFormats() const { return m_rtvFormats; }
+            Format depthStencilFormat() const { return m_dsvFormat; }
+
+            // bindings written by the last configure
+            size_t bindingCount() const { return m_bindingCount; }
+            size_t constantBytes() const { return m_constantBytes; }
+        private:
+            const DeviceImplNull& m_device;
+            BlendDescription m_blend;
+            RasterizerDescription m_rasterizer;
+            DepthStencilDescription m_depthStencil;
+            unsigned int m_sampleMask;
+            PrimitiveTopologyType m_topology;
+            IndexBufferStripCutValue m_primitiveRestart;
+            engine::vector<Format> m_rtvFormats;
+            Format m_dsvFormat;
+            unsigned int m_msaaCount;
+            unsigned int m_msaaQuality;
+
+            bool m_compute;
+            size_t m_bindingCount;
+            size_t m_constantBytes;
+
+            void countBindings(shaders::Shader* shader);
+        };
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "engine/graphics/QueueImplIf.h"
+
+namespace engine
+{
+    class Device;
+    class CommandList;
+    class Semaphore;
+    class SwapChain;
+    class Fence;
+    enum class CommandListType;
+
+    namespace implementation
+    {
+        class DeviceImplNull;
+
+        // command lists are executed as they are recorded, so submitting one
+        // only closes it and completes whatever the submit signals.
+        class QueueImplNull : public QueueImplIf
+        {
+        public:
+            QueueImplNull(Device& device, CommandListType type, const char* queueName);
+
+            QueueImplNull(const QueueImplNull&) = delete;
+            QueueImplNull(QueueImplNull&&) = delete;
+            QueueImplNull& operator=(const QueueImplNull&) = delete;
+            QueueImplNull& operator=(QueueImplNull&&) = delete;
+
+            void submit(CommandList& commandList) override;
+            void submit(CommandList& commandList, Fence& fence) override;
+            void submit(CommandList& commandList, Semaphore& semaphore) override;
+            void submit(CommandList& commandList, Semaphore& waitSemaphore, Semaphore& signalSemaphore) override;
+            void submit(CommandList& commandList, Semaphore& waitSemaphore, Semaphore& signalSemaphore, Fence& fence) override;
+            void submit(CommandList& commandList, Semaphore& semaphore, Fence& fence) override;
+
+            void waitForIdle() const override;
+
+            void signal(const Semaphore& semaphore) override;
+            void signal(const Fence& fence, unsigned long long value) override;
+
+            void present(
+                Semaphore& signalSemaphore,
+                SwapChain& swapChain,
+                unsigned int chainIndex) override;
+
+            bool needRefresh() const override;
+
+            // queries are counted in microseconds
+            uint64_t timeStampFrequency() const override { return 1000000u; }
+
+            engine::Vector3<size_t> transferGranularity() const override { return { 1ull, 1ull, 1ull }; }
+
+        private:
+            const DeviceImplNull& m_device;
+            const char* m_queueName;
+
+            void execute(CommandList& commandList);
+            void signalFence(Fence& fence);
+            void signalSemaphore(Semaphore& semaphore);
+        };
+    }
+}
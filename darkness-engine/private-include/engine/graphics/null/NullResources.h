@@ -0,0 +1,357 @@
+#pragma once
+
+#include "engine/graphics/ResourcesImplIf.h"
+#include "engine/graphics/SubresourceStates.h"
+#include "engine/graphics/Resources.h"
+#include "engine/graphics/ResourceOwners.h"
+#include "containers/vector.h"
+
+namespace engine
+{
+    class Device;
+
+    namespace implementation
+    {
+        class DeviceImplNull;
+
+        class BufferImplNull : public BufferImplIf
+        {
+        public:
+            BufferImplNull(
+                const DeviceImplNull& device,
+                const BufferDescription& desc);
+
+            void* map(const DeviceImplIf* device) override;
+            void unmap(const DeviceImplIf* device) override;
+
+            const BufferDescription::Descriptor& description() const override;
+            ResourceState state() const override;
+            void state(ResourceState _state) override;
+            size_t committedBytes() const override;
+
+            // reserved buffers only have memory for the committed pages
+            void commit(const DeviceImplNull& device, size_t bytes);
+
+            uint8_t* data() { return m_memory.data(); }
+            size_t sizeBytes() const { return m_memory.size(); }
+        private:
+            BufferDescription::Descriptor m_description;
+            engine::vector<uint8_t> m_memory;
+            ResourceState m_state;
+        };
+
+        class BufferSRVImplNull : public BufferSRVImplIf
+        {
+        public:
+            BufferSRVImplNull(
+                const DeviceImplNull& device,
+                const Buffer& buffer,
+                const BufferDescription& desc);
+
+            const BufferDescription::Descriptor& description() const override;
+            Buffer buffer() const override;
+            uint64_t uniqueId() const override { return m_uniqueId; }
+        private:
+            BufferDescription::Descriptor m_description;
+            Buffer m_buffer;
+            uint64_t m_uniqueId;
+        };
+
+        class BufferUAVImplNull : public BufferUAVImplIf
+        {
+        public:
+            BufferUAVImplNull(
+                const DeviceImplNull& device,
+                const Buffer& buffer,
+                const BufferDescription& desc);
+
+            const BufferDescription::Descriptor& description() const override;
+            Buffer buffer() const override;
+            uint64_t uniqueId() const override { return m_uniqueId; }
+            size_t structureCounterOffsetBytes() const override { return 0; }
+
+            // append buffers keep their hidden counter on the CPU
+            uint32_t counter() const { return m_counter; }
+            void counter(uint32_t value) { m_counter = value; }
+        private:
+            BufferDescription::Descriptor m_description;
+            Buffer m_buffer;
+            uint64_t m_uniqueId;
+            uint32_t m_counter;
+        };
+
+        class BufferIBVImplNull : public BufferIBVImplIf
+        {
+        public:
+            BufferIBVImplNull(
+                const DeviceImplNull& device,
+                const Buffer& buffer,
+                const BufferDescription& desc);
+
+            const BufferDescription::Descriptor& description() const override;
+            Buffer buffer() const override;
+            uint64_t uniqueId() const override { return m_uniqueId; }
+        private:
+            BufferDescription::Descriptor m_description;
+            Buffer m_buffer;
+            uint64_t m_uniqueId;
+        };
+
+        class BufferCBVImplNull : public BufferCBVImplIf
+        {
+        public:
+            BufferCBVImplNull(
+                const DeviceImplNull& device,
+                const Buffer& buffer,
+                const BufferDescription& desc);
+
+            const BufferDescription::Descriptor& description() const override;
+            Buffer buffer() const override;
+            uint64_t uniqueId() const override { return m_uniqueId; }
+        private:
+            BufferDescription::Descriptor m_description;
+            Buffer m_buffer;
+            uint64_t m_uniqueId;
+        };
+
+        class BufferVBVImplNull : public BufferVBVImplIf
+        {
+        public:
+            BufferVBVImplNull(
+                const DeviceImplNull& device,
+                const Buffer& buffer,
+                const BufferDescription& desc);
+
+            const BufferDescription::Descriptor& description() const override;
+            Buffer buffer() const override;
+            uint64_t uniqueId() const override { return m_uniqueId; }
+        private:
+            BufferDescription::Descriptor m_description;
+            Buffer m_buffer;
+            uint64_t m_uniqueId;
+        };
+
+        class BindlessBufferSRVImplNull : public BindlessBufferSRVImplIf
+        {
+        public:
+            BindlessBufferSRVImplNull(const DeviceImplNull& device);
+
+            uint32_t push(BufferSRVOwner buffer) override;
+            size_t size() const override;
+            BufferSRV get(size_t index) override;
+            uint64_t resourceId() const override;
+
+            void updateDescriptors(DeviceImplIf* device) override;
+            bool change() const override;
+            void change(bool value) override;
+        private:
+            engine::vector<BufferSRVOwner> m_buffers;
+            uint64_t m_resourceId;
+            bool m_change;
+        };
+
+        class BindlessBufferUAVImplNull : public BindlessBufferUAVImplIf
+        {
+        public:
+            BindlessBufferUAVImplNull(const DeviceImplNull& device);
+
+            uint32_t push(BufferUAVOwner buffer) override;
+            size_t size() const override;
+            BufferUAV get(size_t index) override;
+            uint64_t resourceId() const override;
+
+            void updateDescriptors(DeviceImplIf* device) override;
+            bool change() const override;
+            void change(bool value) override;
+        private:
+            engine::vector<BufferUAVOwner> m_buffers;
+            uint64_t m_resourceId;
+            bool m_change;
+        };
+
+        class RaytracingAccelerationStructureImplNull : public RaytracingAccelerationStructureImplIf
+        {
+        public:
+            RaytracingAccelerationStructureImplNull(
+                const Device& device,
+                BufferSRV vertexBuffer,
+                BufferIBV indexBuffer,
+                const BufferDescription& desc);
+
+            const BufferDescription::Descriptor& description() const override;
+            ResourceState state() const override;
+            void state(ResourceState _state) override;
+            uint64_t resourceId() const override;
+        private:
+            BufferDescription::Descriptor m_description;
+            ResourceState m_state;
+            uint64_t m_resourceId;
+        };
+
+        class TextureImplNull : public TextureImplIf
+        {
+        public:
+            TextureImplNull(
+                const DeviceImplNull& device,
+                const TextureDescription& desc);
+
+            void* map(const DeviceImplIf* device) override;
+            void unmap(const DeviceImplIf* device) override;
+
+            const TextureDescription::Descriptor& description() const override;
+
+            ResourceState state(int slice, int mip) const override;
+            void state(int slice, int mip, ResourceState state) override;
+            void state(ResourceState state) override;
+            bool uniformState(ResourceState& state) const override;
+
+            // subresources are stored tightly packed, slice major
+            uint8_t* data(int slice, int mip);
+            size_t sizeBytes(int mip) const;
+            size_t sizeBytes() const { return m_memory.size(); }
+        private:
+            TextureDescription::Descriptor m_description;
+            engine::vector<uint8_t> m_memory;
+            engine::vector<size_t> m_offsets;
+            SubresourceStates m_state;
+        };
+
+        class TextureSRVImplNull : public TextureSRVImplIf
+        {
+        public:
+            TextureSRVImplNull(
+                const DeviceImplNull& device,
+                const Texture& texture,
+                const TextureDescription& desc,
+                SubResource subResources = SubResource());
+
+            const TextureDescription::Descriptor& description() const override;
+
+            Texture texture() const override;
+            Format format() const override;
+            size_t width() const override;
+            size_t height() const override;
+            size_t depth() const override;
+            ResourceDimension dimension() const override;
+            uint64_t uniqueId() const override { return m_uniqueId; }
+            const SubResource& subResource() const override { return m_subResources; }
+        private:
+            TextureDescription::Descriptor m_description;
+            Texture m_texture;
+            SubResource m_subResources;
+            uint64_t m_uniqueId;
+        };
+
+        class TextureUAVImplNull : public TextureUAVImplIf
+        {
+        public:
+            TextureUAVImplNull(
+                const DeviceImplNull& device,
+                const Texture& texture,
+                const TextureDescription& desc,
+                SubResource subResources = SubResource());
+
+            const TextureDescription::Descriptor& description() const override;
+
+            Texture texture() const override;
+            Format format() const override;
+            size_t width() const override;
+            size_t height() const override;
+            size_t depth() const override;
+            ResourceDimension dimension() const override;
+            uint64_t uniqueId() const override { return m_uniqueId; }
+            const SubResource& subResource() const override { return m_subResources; }
+        private:
+            TextureDescription::Descriptor m_description;
+            Texture m_texture;
+            SubResource m_subResources;
+            uint64_t m_uniqueId;
+        };
+
+        class TextureDSVImplNull : public TextureDSVImplIf
+        {
+        public:
+            TextureDSVImplNull(
+                const DeviceImplNull& device,
+                const Texture& texture,
+                const TextureDescription& desc,
+                SubResource subResources = SubResource());
+
+            const TextureDescription::Descriptor& description() const override;
+
+            Texture texture() const override;
+            Format format() const override;
+            size_t width() const override;
+            size_t height() const override;
+            uint64_t uniqueId() const override { return m_uniqueId; }
+            const SubResource& subResource() const override { return m_subResources; }
+        private:
+            TextureDescription::Descriptor m_description;
+            Texture m_texture;
+            SubResource m_subResources;
+            uint64_t m_uniqueId;
+        };
+
+        class TextureRTVImplNull : public TextureRTVImplIf
+        {
+        public:
+            TextureRTVImplNull(
+                const DeviceImplNull& device,
+                const Texture& texture,
+                const TextureDescription& desc,
+                SubResource subResources = SubResource());
+
+            const TextureDescription::Descriptor& description() const override;
+
+            Texture texture() const override;
+            Format format() const override;
+            size_t width() const override;
+            size_t height() const override;
+            uint64_t uniqueId() const override { return m_uniqueId; }
+            const SubResource& subResource() const override { return m_subResources; }
+        private:
+            TextureDescription::Descriptor m_description;
+            Texture m_texture;
+            SubResource m_subResources;
+            uint64_t m_uniqueId;
+        };
+
+        class BindlessTextureSRVImplNull : public BindlessTextureSRVImplIf
+        {
+        public:
+            BindlessTextureSRVImplNull(const DeviceImplNull& device);
+
+            uint32_t push(TextureSRVOwner texture) override;
+            size_t size() const override;
+            TextureSRV get(size_t index) override;
+            uint64_t resourceId() const override;
+
+            void updateDescriptors(DeviceImplIf* device) override;
+            bool change() const override;
+            void change(bool value) override;
+        private:
+            engine::vector<TextureSRVOwner> m_textures;
+            uint64_t m_resourceId;
+            bool m_change;
+        };
+
+        class BindlessTextureUAVImplNull : public BindlessTextureUAVImplIf
+        {
+        public:
+            BindlessTextureUAVImplNull(const DeviceImplNull& device);
+
+            uint32_t push(TextureUAVOwner texture) override;
+            size_t size() const override;
+            TextureUAV get(size_t index) override;
+            uint64_t resourceId() const override;
+
+            void updateDescriptors(DeviceImplIf* device) override;
+            bool change() const override;
+            void change(bool value) override;
+        private:
+            engine::vector<TextureUAVOwner> m_textures;
+            uint64_t m_resourceId;
+            bool m_change;
+        };
+    }
+}
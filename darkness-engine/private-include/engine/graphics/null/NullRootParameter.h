@@ -0,0 +1,40 @@
+#pragma once
+
+#include "engine/graphics/RootParameterImplIf.h"
+#include "engine/graphics/CommonNoDep.h"
+
+namespace engine
+{
+    enum class DescriptorRangeType;
+
+    namespace implementation
+    {
+        // only remembers what it was told. the null device has no root signature
+        // to build from it.
+        class RootParameterImplNull : public RootParameterImplIf
+        {
+        public:
+            RootParameterImplNull();
+
+            void binding(unsigned int index) override;
+            unsigned int binding() const override;
+
+            void visibility(ShaderVisibility visibility) override;
+            ShaderVisibility visibility() const override;
+
+            void initAsConstants(unsigned int reg, unsigned int num32BitValues, ShaderVisibility visibility) override;
+            void initAsCBV(unsigned int reg, ShaderVisibility visibility) override;
+            void initAsSRV(unsigned int reg, ShaderVisibility visibility) override;
+            void initAsUAV(unsigned int reg, ShaderVisibility visibility) override;
+            void initAsDescriptorRange(DescriptorRangeType type, unsigned int reg, unsigned int count, ShaderVisibility visibility) override;
+            void initAsDescriptorTable(unsigned int rangeCount, ShaderVisibility visibility) override;
+            void setTableRange(unsigned int rangeIndex, DescriptorRangeType type, unsigned int reg, unsigned int count, unsigned int space = 0) override;
+
+            unsigned int descriptorCount() const { return m_descriptorCount; }
+        private:
+            unsigned int m_binding;
+            ShaderVisibility m_visibility;
+            unsigned int m_descriptorCount;
+        };
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "engine/graphics/RootSignatureImplIf.h"
+#include "engine/graphics/SamplerDescription.h"
+#include "engine/graphics/RootParameter.h"
+#include "engine/graphics/RootSignature.h"
+#include "containers/vector.h"
+
+namespace engine
+{
+    class Device;
+    namespace implementation
+    {
+        class RootSignatureImplNull : public RootSignatureImplIf
+        {
+        public:
+            RootSignatureImplNull(const Device& device, int rootParameterCount = 0, int staticSamplerCount = 0);
+
+            void reset(int rootParameterCount, int staticSamplerCount) override;
+            void initStaticSampler(int samplerNum, const SamplerDescription& description, ShaderVisibility visibility) override;
+            void finalize(RootSignatureFlags flags = RootSignatureFlags::None) override;
+            void enableNullDescriptors(bool texture, bool writeable) override;
+            size_t rootParameterCount() const override;
+            RootParameter& operator[](size_t index) override;
+            const RootParameter& operator[](size_t index) const override;
+
+            RootSignatureImplNull(const RootSignatureImplNull&) = delete;
+            RootSignatureImplNull(RootSignatureImplNull&&) = delete;
+            RootSignatureImplNull& operator=(const RootSignatureImplNull&) = delete;
+            RootSignatureImplNull& operator=(RootSignatureImplNull&&) = delete;
+
+            bool finalized() const { return m_finalized; }
+        private:
+            engine::vector<RootParameter> m_parameters;
+            engine::vector<SamplerDescription> m_samplers;
+            bool m_finalized;
+        };
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "engine/graphics/SamplerImplIf.h"
+#include "engine/graphics/SamplerDescription.h"
+#include <cstdint>
+
+namespace engine
+{
+    class Device;
+
+    namespace implementation
+    {
+        class SamplerImplNull : public SamplerImplIf
+        {
+        public:
+            SamplerImplNull(
+                const Device& device,
+                const SamplerDescription& desc);
+
+            const SamplerDescription& description() const { return m_description; }
+            uint64_t uniqueId() const { return m_uniqueId; }
+        private:
+            SamplerDescription m_description;
+            uint64_t m_uniqueId;
+        };
+    }
+}
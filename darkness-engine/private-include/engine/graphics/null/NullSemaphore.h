@@ -0,0 +1,24 @@
+#pragma once
+
+#include "engine/graphics/SemaphoreImplIf.h"
+#include <atomic>
+
+namespace engine
+{
+    class Device;
+    namespace implementation
+    {
+        class SemaphoreImplNull : public SemaphoreImplIf
+        {
+        public:
+            SemaphoreImplNull(const Device& device);
+
+            void reset() override;
+            bool signaled() const override;
+
+            void signal();
+        private:
+            std::atomic<bool> m_signaled;
+        };
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "engine/graphics/ShaderBinaryImplIf.h"
+#include "containers/string.h"
+#include "containers/vector.h"
+#include "containers/unordered_map.h"
+#include "platform/FileWatcher.h"
+
+namespace engine
+{
+    class Device;
+
+    namespace implementation
+    {
+        // the null device never executes shaders so the binary is not loaded.
+        // this keeps pipelines working without compiled shaders on disk.
+        class ShaderBinaryImplNull : public ShaderBinaryImplIf
+        {
+        public:
+            ShaderBinaryImplNull(
+                const Device& device,
+                const engine::string& binaryPath,
+                const engine::string& supportPath,
+                int permutationId,
+                const engine::vector<engine::string>& defines,
+                platform::FileWatcher& watcher);
+
+            void registerForChange(void* client, std::function<void(void)> change) const override;
+            void unregisterForChange(void* client) const override;
+
+            const engine::string& binaryPath() const { return m_binaryPath; }
+            int permutationId() const { return m_permutationId; }
+        private:
+            engine::string m_binaryPath;
+            int m_permutationId;
+            engine::vector<engine::string> m_defines;
+            mutable engine::unordered_map<void*, std::function<void(void)>> m_change;
+        };
+    }
+}
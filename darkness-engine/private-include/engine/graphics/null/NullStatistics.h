@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace engine
+{
+    namespace implementation
+    {
+        // counters of everything the null device was asked to do.
+        // command lists can be recorded from several threads so these are atomic.
+        struct NullStatistics
+        {
+            std::atomic<uint64_t> calls{ 0 };
+
+            std::atomic<uint64_t> commandListsCreated{ 0 };
+            std::atomic<uint64_t> commandListsSubmitted{ 0 };
+
+            std::atomic<uint64_t> draws{ 0 };
+            std::atomic<uint64_t> dispatches{ 0 };
+            std::atomic<uint64_t> copies{ 0 };
+            std::atomic<uint64_t> clears{ 0 };
+            std::atomic<uint64_t> barriers{ 0 };
+            std::atomic<uint64_t> pipelineBinds{ 0 };
+            std::atomic<uint64_t> pipelinesPrewarmed{ 0 };
+            std::atomic<uint64_t> descriptorBinds{ 0 };
+            std::atomic<uint64_t> queries{ 0 };
+
+            std::atomic<uint64_t> buffers{ 0 };
+            std::atomic<uint64_t> bufferBytes{ 0 };
+            std::atomic<uint64_t> textures{ 0 };
+            std::atomic<uint64_t> textureBytes{ 0 };
+            std::atomic<uint64_t> views{ 0 };
+            std::atomic<uint64_t> commits{ 0 };
+            std::atomic<uint64_t> committedBytes{ 0 };
+
+            std::atomic<uint64_t> uploadBytes{ 0 };
+            std::atomic<uint64_t> copyBytes{ 0 };
+
+            std::atomic<uint64_t> fenceSignals{ 0 };
+            std::atomic<uint64_t> presents{ 0 };
+
+            void reset()
+            {
+                calls = 0;
+                commandListsCreated = 0;
+                commandListsSubmitted = 0;
+                draws = 0;
+                dispatches = 0;
+                copies = 0;
+                clears = 0;
+                barriers = 0;
+                pipelineBinds = 0;
+                pipelinesPrewarmed = 0;
+                descriptorBinds = 0;
+                queries = 0;
+                buffers = 0;
+                bufferBytes = 0;
+                textures = 0;
+                textureBytes = 0;
+                views = 0;
+                commits = 0;
+                committedBytes = 0;
+                uploadBytes = 0;
+                copyBytes = 0;
+                fenceSignals = 0;
+                presents = 0;
+            }
+        };
+    }
+}
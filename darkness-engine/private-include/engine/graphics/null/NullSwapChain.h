@@ -0,0 +1,65 @@
+#pragma once
+
+#include "engine/graphics/SwapChainImplIf.h"
+#include "engine/graphics/SwapChain.h"
+#include "engine/graphics/ResourceOwners.h"
+#include "engine/graphics/Semaphore.h"
+#include "containers/vector.h"
+
+namespace engine
+{
+    class Device;
+    class Queue;
+    class SwapChain;
+
+    namespace implementation
+    {
+        constexpr int NullBackBufferCount = 2;
+
+        // back buffers are plain textures. present only flips the index.
+        class SwapChainImplNull : public SwapChainImplIf
+        {
+        public:
+            SwapChainImplNull(
+                const Device& device,
+                Queue& commandQueue,
+                bool fullscreen = false,
+                bool vsync = true,
+                SwapChain* oldSwapChain = nullptr);
+
+            Semaphore& backBufferReadySemaphore() override;
+
+            TextureRTV renderTarget(int index) override;
+            TextureSRV renderTargetSRV(int index) override;
+            TextureRTVOwner& renderTargetOwner(int index) override;
+            unsigned int currentBackBufferIndex() const override;
+            void present() override;
+
+            bool needRefresh() override;
+            Size size() const override;
+
+            void resize(Device& device, Size size) override;
+
+            bool vsync() const override
+            {
+                return m_vsync;
+            };
+            void vsync(bool enabled) override
+            {
+                m_vsync = enabled;
+            };
+        private:
+            const Device& m_device;
+            Semaphore m_backBufferReadySemaphore;
+            Size m_size;
+            unsigned int m_backBufferIndex;
+            bool m_vsync;
+
+            engine::vector<TextureOwner> m_swapChainTextures;
+            engine::vector<TextureRTVOwner> m_swapChainTextureRTVs;
+            engine::vector<TextureSRVOwner> m_swapChainTextureSRVs;
+
+            void createSwapChainTextures(const Device& device);
+        };
+    }
+}
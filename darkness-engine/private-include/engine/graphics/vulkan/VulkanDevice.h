@@ -6,6 +6,7 @@
 #include "engine/graphics/vulkan/VulkanCommon.h"
 #include "engine/graphics/vulkan/VulkanFencePool.h"
 #include "engine/graphics/vulkan/VulkanDescriptorHeap.h"
+#include "engine/graphics/vulkan/VulkanPipelineCache.h"
 #include "engine/graphics/Common.h"
 #include "engine/graphics/Fence.h"
 #include "engine/graphics/ResourceOwners.h"
@@ -109,6 +110,7 @@ namespace engine
             void waitForIdle() override;
 
             DescriptorHeapImplVulkan& descriptorHeap();
+            PipelineCacheVulkan& pipelineCache();
 
             void setCurrentFenceValue(CommandListType type, engine::FenceValue value) override;
             void processUploads(engine::FenceValue value, bool force = false) override;
@@ -124,6 +126,9 @@ namespace engine
             void copyTexture(Device& device, const CpuTexture& texture, TextureSRV dst) override;
 
             TextureBufferCopyDesc getTextureBufferCopyDesc(size_t width, size_t height, Format format) override;
+
+            bool reservedBuffersSupported() const override;
+            void commitBuffer(Buffer buffer, size_t bytes) override;
         private:
             std::mutex m_mutex;
             VulkanInstance m_instance;
@@ -151,6 +156,8 @@ namespace engine
             Queue* m_deviceQueue;
 
             tools::RingBuffer m_uploadAllocator;
+            std::mutex m_uploadMutex;
+            tools::RingBuffer::AllocStruct allocateUpload(size_t bytes, size_t alignment);
             BufferOwner m_uploadBuffer;
             engine::shared_ptr<NullResources> m_nullResources;
 
@@ -174,6 +181,9 @@ namespace engine
             engine::vector<engine::shared_ptr<CommandAllocatorImplVulkan>> m_inUseCommandAllocatorsCopy; // these are referenced by command buffers
 
             engine::unique_ptr<DescriptorHeapImplVulkan> m_descriptorHeap;
+
+            // last so it's saved and destroyed before the device
+            engine::unique_ptr<PipelineCacheVulkan> m_pipelineCache;
         };
     }
 }
@@ -7,6 +7,8 @@
 #include "containers/memory.h"
 #include "containers/vector.h"
 #include "containers/string.h"
+#include "containers/unordered_map.h"
+#include <mutex>
 
 namespace engine
 {
@@ -86,6 +88,10 @@ namespace engine
                 shaders::PipelineConfiguration* configuration) override;
 
             void finalize(CommandListImplVulkan& cmd, shaders::PipelineConfiguration* configuration);
+
+            // compute pipelines only. graphics pipelines need the render pass
+            // which is known at bind time, those rely on the on-disk pipeline cache
+            void prewarm(shaders::PipelineConfiguration* configuration) override;
             
             const engine::vector<VkDescriptorSet>& descriptorSet() const;
 
@@ -133,6 +139,7 @@ namespace engine
             void setRootSignature();
 
             int countPipelineSets(shaders::PipelineConfiguration* configuration);
+            void createPipelineLayout(shaders::PipelineConfiguration* configuration);
             void createGraphicsPipeline();
             void createBindings(CommandListImplVulkan& cmd, shaders::PipelineConfiguration* configuration);
 
@@ -168,6 +175,10 @@ namespace engine
             engine::unordered_map<uint64_t, PipelineCache> m_hashResourceStorage;
             PipelineCache* m_currentPipelineCache;
 
+            // created by prewarm, moved to m_hashResourceStorage on first bind
+            engine::unordered_map<uint64_t, PipelineCache> m_prewarmedPipelines;
+            std::mutex m_mutex;
+
             engine::shared_ptr<TextureDSV> m_depthBufferView;
 
             //engine::vector<engine::shared_ptr<VkFramebuffer>> m_framebuffers;
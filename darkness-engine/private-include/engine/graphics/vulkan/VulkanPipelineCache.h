@@ -0,0 +1,54 @@
+#pragma once
+
+#include "engine/graphics/vulkan/VulkanHeaders.h"
+#include "containers/string.h"
+#include <mutex>
+
+namespace engine
+{
+    namespace implementation
+    {
+        // VkPipelineCache that is stored on disk between runs.
+        //
+        // the file starts with the vendor, device, driver version and
+        // pipeline cache uuid of the device that wrote it. data from any
+        // other device or driver is thrown away instead of handed to the driver.
+        class PipelineCacheVulkan
+        {
+        public:
+            PipelineCacheVulkan(
+                VkPhysicalDevice physicalDevice,
+                VkDevice device,
+                const engine::string& path);
+            ~PipelineCacheVulkan();
+
+            PipelineCacheVulkan(const PipelineCacheVulkan&) = delete;
+            PipelineCacheVulkan(PipelineCacheVulkan&&) = delete;
+            PipelineCacheVulkan& operator=(const PipelineCacheVulkan&) = delete;
+            PipelineCacheVulkan& operator=(PipelineCacheVulkan&&) = delete;
+
+            // vkCreate*Pipelines synchronize access to the cache internally
+            VkPipelineCache native() const { return m_cache; }
+
+            void save();
+
+        private:
+            struct Header
+            {
+                uint32_t magic;
+                uint32_t version;
+                uint32_t vendorID;
+                uint32_t deviceID;
+                uint32_t driverVersion;
+                uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+                uint64_t dataSize;
+            };
+
+            VkDevice m_device;
+            engine::string m_path;
+            Header m_header;
+            VkPipelineCache m_cache;
+            std::mutex m_mutex;
+        };
+    }
+}
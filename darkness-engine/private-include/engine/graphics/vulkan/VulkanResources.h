@@ -1,6 +1,7 @@
 #pragma once
 
 #include "engine/graphics/ResourcesImplIf.h"
+#include "engine/graphics/SubresourceStates.h"
 #include "engine/graphics/Resources.h"
 #include "engine/graphics/Device.h"
 #include "engine/graphics/vulkan/VulkanHeaders.h"
@@ -37,6 +38,7 @@ namespace engine
 
             ResourceState state() const override;
             void state(ResourceState state) override;
+            size_t committedBytes() const override;
 
             VkBuffer& native();
             const VkBuffer& native() const;
@@ -292,11 +294,13 @@ namespace engine
             
             ResourceState state(int slice, int mip) const;
             void state(int slice, int mip, ResourceState state);
+            void state(ResourceState state);
+            bool uniformState(ResourceState& state) const;
         protected:
             const TextureDescription::Descriptor m_description;
             engine::shared_ptr<VkImage> m_image{ nullptr };
             engine::shared_ptr<VkDeviceMemory> m_memory{ nullptr };
-            engine::vector<ResourceState> m_state;
+            SubresourceStates m_state;
         };
 
         class TextureSRVImplVulkan : public TextureSRVImplIf
@@ -179,6 +179,9 @@ namespace engine
 
                 m_commandList->ResourceBarrier(static_cast<UINT>(barriers.size()), &barriers[0]);
                 m_lastAppliedBarrierIndex = m_barriers.size();
+
+                m_device->transitionCounters().barriers += static_cast<uint32_t>(barriers.size());
+                ++m_device->transitionCounters().flushes;
             }
 #else
 			auto barrierCount = m_barriers.size() - m_lastAppliedBarrierIndex;
@@ -186,6 +189,9 @@ namespace engine
 			{
 				m_commandList->ResourceBarrier(static_cast<UINT>(barrierCount), &m_barriers[m_lastAppliedBarrierIndex]);
 				m_lastAppliedBarrierIndex = m_barriers.size();
+
+				m_device->transitionCounters().barriers += static_cast<uint32_t>(barrierCount);
+				++m_device->transitionCounters().flushes;
 			}
 #endif
         }
@@ -349,66 +355,34 @@ namespace engine
 
             auto localSubRes = subResource;
 
-            if ((localSubRes.arraySliceCount == AllArraySlices) &&
-                (localSubRes.mipCount == AllMipLevels))
+            // a whole resource transition is a single barrier when every subresource
+            // is in the same state. otherwise go through the subresources one by one
+            ResourceState currentState = state;
+            bool wholeResource =
+                (localSubRes.arraySliceCount == AllArraySlices) &&
+                (localSubRes.mipCount == AllMipLevels);
+            if (wholeResource && !impl->uniformState(currentState))
             {
-                bool forceIndividual = false;
-                auto firstState = impl->state(0, 0);
-                for (int slice = 0; slice < static_cast<int>(resource.arraySlices()); ++slice)
-                {
-                    for (int mip = 0; mip < static_cast<int>(resource.mipLevels()); ++mip)
-                    {
-                        if (firstState != impl->state(slice, mip))
-                        {
-                            forceIndividual = true;
-                            break;
-                        }
-                    }
-                    if (forceIndividual)
-                        break;
-                }
-
-                if (forceIndividual)
-                {
-                    localSubRes.firstArraySlice = 0;
-                    localSubRes.firstMipLevel = 0;
-                    localSubRes.arraySliceCount = static_cast<int32_t>(resource.arraySlices());
-                    localSubRes.mipCount = static_cast<int32_t>(resource.mipLevels());
-                }
+                wholeResource = false;
+                localSubRes.firstArraySlice = 0;
+                localSubRes.firstMipLevel = 0;
+                localSubRes.arraySliceCount = static_cast<int32_t>(resource.arraySlices());
+                localSubRes.mipCount = static_cast<int32_t>(resource.mipLevels());
             }
 
-            if ((localSubRes.arraySliceCount == AllArraySlices) &&
-                (localSubRes.mipCount == AllMipLevels))
+            if (wholeResource)
             {
-                ResourceState anystate = state;
-                for (int slice = 0; slice < static_cast<int>(resource.arraySlices()); ++slice)
-                {
-                    for (int mip = 0; mip < static_cast<int>(resource.mipLevels()); ++mip)
-                    {
-                        if (impl->state(slice, mip) != anystate)
-                        {
-                            anystate = impl->state(slice, mip);
-                            break;
-                        }
-                    }
-                }
-                if (anystate != state)
+                if (currentState != state)
                 {
                     D3D12_RESOURCE_BARRIER barrier = {};
                     barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
                     barrier.Transition.pResource = static_cast<TextureImplDX12*>(impl)->native();
-                    barrier.Transition.StateBefore = dxResourceStates(anystate);
+                    barrier.Transition.StateBefore = dxResourceStates(currentState);
                     barrier.Transition.StateAfter = dxResourceStates(state);
                     barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
                     m_barriers.emplace_back(barrier);
 
-                    for (int slice = 0; slice < static_cast<int>(resource.arraySlices()); ++slice)
-                    {
-                        for (int mip = 0; mip < static_cast<int>(resource.mipLevels()); ++mip)
-                        {
-                            impl->state(slice, mip, state);
-                        }
-                    }
+                    impl->state(state);
                 }
             }
             else
@@ -6,6 +6,8 @@
 #include "engine/graphics/dx12/DX12Debug.h"
 #include "engine/graphics/dx12/DX12DescriptorHeap.h"
 #include "engine/graphics/dx12/DX12CommandAllocator.h"
+#include "engine/graphics/dx12/DX12Queue.h"
+#include "engine/graphics/dx12/DX12Fence.h"
 #include "engine/graphics/CommandListImplIf.h"
 
 #include "engine/graphics/Resources.h"
@@ -54,10 +56,12 @@ namespace engine
             , m_device{}
 			, m_graphicsQueueUploadFence{ nullptr }
             , m_copyQueueUploadFence{ nullptr }
+            , m_commitFence{ nullptr }
 			, m_deviceGraphicsQueue{ nullptr }
             , m_deviceCopyQueue{ nullptr }
             , m_window{ window }
             , m_currentHeap{ 0 }
+            , m_reservedBuffers{ false }
 			, m_currentFenceValue{ 0 }
             , m_currentCopyFenceValue{ 0 }
         {
@@ -148,6 +152,11 @@ namespace engine
 
 #endif
 
+            D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
+            m_reservedBuffers =
+                SUCCEEDED(m_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options))) &&
+                options.TiledResourcesTier != D3D12_TILED_RESOURCES_TIER_NOT_SUPPORTED;
+
 #if defined(PERFORMANCE_MEASURING_MODE) && !defined(_DURANGO)
             m_device->SetStablePowerState(true);
 #endif
@@ -277,6 +286,7 @@ namespace engine
 		{
             m_graphicsQueueUploadFence = engine::make_shared<Fence>(device.createFence("Graphics Upload fence"));
             m_copyQueueUploadFence = engine::make_shared<Fence>(device.createFence("Copy Upload fence"));
+            m_commitFence = engine::make_shared<Fence>(device.createFence("Reserved buffer commit fence"));
             m_deviceGraphicsQueue = &device.queue(CommandListType::Direct);
             m_deviceCopyQueue = &device.queue(CommandListType::Copy);
 
@@ -615,6 +625,7 @@ namespace engine
         {
             m_graphicsQueueUploadFence = nullptr;
             m_copyQueueUploadFence = nullptr;
+            m_commitFence = nullptr;
             m_uploadBuffer = BufferSRVOwner();
 
             for (auto&& p : m_executeIndirectClusterSignature)
@@ -777,6 +788,38 @@ namespace engine
             return *m_nullResources;
         }
 
+#ifdef UPLOADBUFFER_MEMORYALLOCATOR_RINGBUFFER
+        tools::RingBuffer::AllocStruct DeviceImplDX12::allocateUpload(size_t bytes)
+        {
+            ASSERT(bytes <= UploadBufferSizeBytes, "Upload does not fit the upload buffer");
+
+            // command lists can be recorded from several threads. one allocation
+            // at a time so a flush and the allocation after it stay together.
+            // the ring and the allocation list are also touched under the device lock
+            std::lock_guard<std::mutex> uploadLock(m_uploadMutex);
+            while (true)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    auto uploadData = m_allocator.allocate(bytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+                    if (uploadData.ptr)
+                    {
+                        m_uploadAllocations.emplace_back(UploadAllocation{ uploadData, m_currentFenceValue });
+                        return uploadData;
+                    }
+                }
+
+                m_graphicsQueueUploadFence->increaseCPUValue();
+                m_deviceGraphicsQueue->signal(*m_graphicsQueueUploadFence, m_graphicsQueueUploadFence->currentCPUValue());
+                m_graphicsQueueUploadFence->blockUntilSignaled();
+                processUploads(0, true);
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_allocator.reset();
+            }
+        }
+#endif
+
 		void DeviceImplDX12::processUploads(engine::FenceValue value, bool force)
 		{
             std::lock_guard<std::mutex> lock(m_mutex);
@@ -802,6 +845,26 @@ namespace engine
 			}
 		}
 
+        bool DeviceImplDX12::reservedBuffersSupported() const
+        {
+            return m_reservedBuffers;
+        }
+
+        void DeviceImplDX12::commitBuffer(Buffer buffer, size_t bytes)
+        {
+            // the mapping goes to the graphics queue in order with the work submitted after it
+            auto graphicsQueue = static_cast<QueueImplDX12*>(m_deviceGraphicsQueue->native())->native();
+            static_cast<BufferImplDX12*>(buffer.m_impl)->commit(*this, graphicsQueue, bytes);
+
+            // the new pages are filled from the copy queue too. it waits on the gpu
+            // for the mapping so no copy lands on unmapped pages
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_commitFence->increaseCPUValue();
+            auto fence = static_cast<FenceImplDX12*>(m_commitFence->native())->native();
+            graphicsQueue->Signal(fence, m_commitFence->currentCPUValue());
+            static_cast<QueueImplDX12*>(m_deviceCopyQueue->native())->native()->Wait(fence, m_commitFence->currentCPUValue());
+        }
+
         TextureBufferCopyDesc DeviceImplDX12::getTextureBufferCopyDesc(size_t width, size_t height, Format format)
         {
             TextureBufferCopyDesc result;
@@ -966,25 +1029,7 @@ namespace engine
                     static_cast<size_t>(D3D12XBOX_TEXTURE_DATA_PITCH_ALIGNMENT)));
 #endif
 
-                auto uploadData = m_allocator.allocate(info.numBytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
-                if (!uploadData.ptr)
-                {
-                    m_graphicsQueueUploadFence->increaseCPUValue();
-                    m_deviceGraphicsQueue->signal(*m_graphicsQueueUploadFence, m_graphicsQueueUploadFence->currentCPUValue());
-                    m_graphicsQueueUploadFence->blockUntilSignaled();
-
-                    processUploads(0, true);
-                    m_allocator.reset();
-                    uploadData = m_allocator.allocate(info.numBytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
-                    if (!uploadData.ptr)
-                    {
-                        ASSERT(false, "Ran out of memory");
-                    }
-                }
-                {
-                    std::lock_guard<std::mutex> lock(m_mutex);
-                    m_uploadAllocations.emplace_back(UploadAllocation{ uploadData, m_currentFenceValue });
-                }
+                auto uploadData = allocateUpload(info.numBytes);
 
                 D3D12_PLACED_SUBRESOURCE_FOOTPRINT placedTexture2D = { 0 };
                 placedTexture2D.Offset = m_allocator.offset(uploadData.ptr);
@@ -1066,22 +1111,7 @@ namespace engine
 #endif
 
 #ifdef UPLOADBUFFER_MEMORYALLOCATOR_RINGBUFFER
-			auto uploadData = m_allocator.allocate(data.sizeBytes(), D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
-
-			if (!uploadData.ptr)
-			{
-                m_graphicsQueueUploadFence->increaseCPUValue();
-                m_deviceGraphicsQueue->signal(*m_graphicsQueueUploadFence, m_graphicsQueueUploadFence->currentCPUValue());
-                m_graphicsQueueUploadFence->blockUntilSignaled();
-
-				processUploads(0, true);
-				m_allocator.reset();
-				uploadData = m_allocator.allocate(data.sizeBytes(), D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
-				if (!uploadData.ptr)
-				{
-					ASSERT(false, "Ran out of memory");
-				}
-			}
+			auto uploadData = allocateUpload(data.sizeBytes());
 
 			memcpy(uploadData.ptr, reinterpret_cast<uint8_t*>(data.start), data.sizeBytes());
 			commandList->transition(buffer, ResourceState::CopyDest);
@@ -1091,11 +1121,6 @@ namespace engine
 				startBytes,
                 static_cast<BufferImplDX12*>(m_uploadBuffer.m_implementation.get())->native(),
 				m_allocator.offset(uploadData.ptr), data.sizeBytes());
-
-            {
-                std::lock_guard<std::mutex> lock(m_mutex);
-                m_uploadAllocations.emplace_back(UploadAllocation{ uploadData, m_currentFenceValue });
-            }
 #endif
         }
 
@@ -1168,22 +1193,7 @@ namespace engine
 #endif
 
 #ifdef UPLOADBUFFER_MEMORYALLOCATOR_RINGBUFFER
-			auto uploadData = m_allocator.allocate(data.sizeBytes(), D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
-
-            if (!uploadData.ptr)
-			{
-                m_graphicsQueueUploadFence->increaseCPUValue();
-                m_deviceGraphicsQueue->signal(*m_graphicsQueueUploadFence, m_graphicsQueueUploadFence->currentCPUValue());
-                m_graphicsQueueUploadFence->blockUntilSignaled();
-
-				processUploads(0, true);
-				m_allocator.reset();
-				uploadData = m_allocator.allocate(data.sizeBytes(), D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
-				if (!uploadData.ptr)
-				{
-					ASSERT(false, "Ran out of memory");
-				}
-			}
+			auto uploadData = allocateUpload(data.sizeBytes());
 
 			memcpy(uploadData.ptr, reinterpret_cast<uint8_t*>(data.start), data.sizeBytes());
 			commandList.transition(buffer, ResourceState::CopyDest);
@@ -1193,12 +1203,6 @@ namespace engine
 				startElement * buffer.description().elementSize,
                 static_cast<BufferImplDX12*>(m_uploadBuffer.m_implementation.get())->native(),
 				m_allocator.offset(uploadData.ptr), data.sizeBytes());
-
-            {
-                std::lock_guard<std::mutex> lock(m_mutex);
-                m_uploadAllocations.emplace_back(UploadAllocation{ uploadData, m_currentFenceValue });
-            }
-			
 #endif
 		}
 
@@ -1286,25 +1290,7 @@ namespace engine
 									static_cast<size_t>(D3D12XBOX_TEXTURE_DATA_PITCH_ALIGNMENT)));
 #endif
 
-								auto uploadData = m_allocator.allocate(info.numBytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
-                                if (!uploadData.ptr)
-								{
-                                    m_graphicsQueueUploadFence->increaseCPUValue();
-                                    m_deviceGraphicsQueue->signal(*m_graphicsQueueUploadFence, m_graphicsQueueUploadFence->currentCPUValue());
-                                    m_graphicsQueueUploadFence->blockUntilSignaled();
-
-									processUploads(0, true);
-									m_allocator.reset();
-									uploadData = m_allocator.allocate(info.numBytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
-									if (!uploadData.ptr)
-									{
-										ASSERT(false, "Ran out of memory");
-									}
-								}
-                                {
-                                    std::lock_guard<std::mutex> lock(m_mutex);
-                                    m_uploadAllocations.emplace_back(UploadAllocation{ uploadData, m_currentFenceValue });
-                                }
+								auto uploadData = allocateUpload(info.numBytes);
 
 								D3D12_PLACED_SUBRESOURCE_FOOTPRINT placedTexture2D = { 0 };
 								placedTexture2D.Offset = m_allocator.offset(uploadData.ptr);
@@ -11,6 +11,7 @@
 #include "tools/Debug.h"
 
 #include <inttypes.h>
+#include <algorithm>
 
 using namespace tools;
 
@@ -232,15 +233,30 @@ namespace engine
                 resState = D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE;
 #endif
 
-            auto success = device.device()->CreateCommittedResource(
-                &heapProperties, 
-                D3D12_HEAP_FLAG_NONE,
-                &res,
-                resState,
-                nullptr, 
-                DARKNESS_IID_PPV_ARGS(m_buffer.GetAddressOf()));
-
-            ASSERT(SUCCEEDED(success));
+            if (m_description.reserved)
+            {
+                // pages are mapped in by commit()
+                ASSERT(heapProperties.Type == D3D12_HEAP_TYPE_DEFAULT, "Reserved buffers need to live in the default heap");
+                auto success = device.device()->CreateReservedResource(
+                    &res,
+                    resState,
+                    nullptr,
+                    DARKNESS_IID_PPV_ARGS(m_buffer.GetAddressOf()));
+                ASSERT(SUCCEEDED(success));
+                m_committedBytes = 0;
+            }
+            else
+            {
+                auto success = device.device()->CreateCommittedResource(
+                    &heapProperties, 
+                    D3D12_HEAP_FLAG_NONE,
+                    &res,
+                    resState,
+                    nullptr, 
+                    DARKNESS_IID_PPV_ARGS(m_buffer.GetAddressOf()));
+                ASSERT(SUCCEEDED(success));
+                m_committedBytes = static_cast<size_t>(res.Width);
+            }
 
 #ifndef RELEASE
 
@@ -314,6 +330,53 @@ namespace engine
             m_state = _state;
         }
 
+        size_t BufferImplDX12::committedBytes() const
+        {
+            return m_committedBytes;
+        }
+
+        void BufferImplDX12::commit(const DeviceImplDX12& device, ID3D12CommandQueue* queue, size_t bytes)
+        {
+            ASSERT(m_description.reserved, "Only reserved buffers can be committed");
+            auto committed = std::min(
+                roundUpToMultiple(bytes, D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES),
+                roundUpToMultiple(m_bufferSize, D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES));
+            if (committed <= m_committedBytes)
+                return;
+
+            // every commit gets its own heap so the existing pages stay where they are
+            D3D12_HEAP_DESC heapDesc = {};
+            heapDesc.SizeInBytes = committed - m_committedBytes;
+            heapDesc.Properties.Type = D3D12_HEAP_TYPE_DEFAULT;
+            heapDesc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+            heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+
+            tools::ComPtr<ID3D12Heap> heap;
+            auto success = device.device()->CreateHeap(&heapDesc, DARKNESS_IID_PPV_ARGS(heap.GetAddressOf()));
+            ASSERT(SUCCEEDED(success), "Could not create a heap for reserved buffer pages");
+
+            D3D12_TILED_RESOURCE_COORDINATE coordinate = {};
+            coordinate.X = static_cast<UINT>(m_committedBytes / D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES);
+
+            D3D12_TILE_REGION_SIZE region = {};
+            region.NumTiles = static_cast<UINT>(heapDesc.SizeInBytes / D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES);
+            region.UseBox = FALSE;
+
+            D3D12_TILE_RANGE_FLAGS rangeFlags = D3D12_TILE_RANGE_FLAG_NONE;
+            UINT heapStartTile = 0;
+            UINT rangeTiles = region.NumTiles;
+
+            queue->UpdateTileMappings(
+                m_buffer.Get(),
+                1, &coordinate, &region,
+                heap.Get(),
+                1, &rangeFlags, &heapStartTile, &rangeTiles,
+                D3D12_TILE_MAPPING_FLAG_NONE);
+
+            m_heaps.emplace_back(heap);
+            m_committedBytes = committed;
+        }
+
 		bool BufferImplDX12::operator==(const BufferImplDX12& buff) const
 		{
 			return m_buffer.Get() == buff.m_buffer.Get();
@@ -1005,16 +1068,9 @@ namespace engine
             const DeviceImplDX12& device,
             const TextureDescription& desc)
             : m_description(desc.descriptor)
+            , m_state{ desc.descriptor.arraySlices, desc.descriptor.mipLevels, ResourceState::Common }
 			, m_attached{ false }
         {
-            for (int slice = 0; slice < static_cast<int>(m_description.arraySlices); ++slice)
-            {
-                for (int mip = 0; mip < static_cast<int>(m_description.mipLevels); ++mip)
-                {
-                    m_state.emplace_back(ResourceState::Common);
-                }
-            }
-
 #ifdef RESOURCE_MEMORY_DEBUGGING
             auto bytesAllocated = imageBytes(
                 m_description.format, 
@@ -1155,7 +1211,7 @@ namespace engine
             ID3D12Resource* resource,
             ResourceState currentState)
             : m_description(desc.descriptor)
-            , m_state{ currentState }
+            , m_state{ desc.descriptor.arraySlices, desc.descriptor.mipLevels, currentState }
 			, m_attached{ true }
         {
             m_texture.Attach(resource);
@@ -1192,12 +1248,25 @@ namespace engine
 
         ResourceState TextureImplDX12::state(int slice, int mip) const
         {
-            return m_state[mip + (slice * m_description.mipLevels)];
+            return m_state.state(slice, mip);
         }
 
         void TextureImplDX12::state(int slice, int mip, ResourceState state)
         {
-            m_state[mip + (slice * m_description.mipLevels)] = state;
+            m_state.state(slice, mip, state);
+        }
+
+        void TextureImplDX12::state(ResourceState state)
+        {
+            m_state.state(state);
+        }
+
+        bool TextureImplDX12::uniformState(ResourceState& state) const
+        {
+            if (!m_state.uniform())
+                return false;
+            state = m_state.uniformState();
+            return true;
         }
 
 		bool TextureImplDX12::operator==(const TextureImplDX12& tex) const
@@ -0,0 +1,46 @@
+#include "engine/graphics/null/NullBarrier.h"
+#include "engine/graphics/null/NullDevice.h"
+
+#include "engine/graphics/Barrier.h"
+#include "engine/graphics/CommandList.h"
+#include "engine/graphics/CommandListAbs.h"
+#include "engine/graphics/Device.h"
+#include "engine/graphics/Resources.h"
+
+namespace engine
+{
+    namespace implementation
+    {
+        BarrierImplNull::BarrierImplNull(
+            const CommandList& commandList,
+            ResourceBarrierFlags /*flags*/,
+            const TextureRTV& resource,
+            ResourceState /*before*/,
+            ResourceState after,
+            unsigned int subResource,
+            const Semaphore& /*waitSemaphore*/,
+            const Semaphore& /*signalSemaphore*/)
+            : m_commandList{ commandList }
+            , m_texture{ resource.texture().m_impl }
+            , m_slice{ static_cast<int>(subResource / resource.texture().mipLevels()) }
+            , m_mip{ static_cast<int>(subResource % resource.texture().mipLevels()) }
+        {
+            apply(after);
+        }
+
+        void BarrierImplNull::update(
+            ResourceState /*before*/,
+            ResourceState after)
+        {
+            apply(after);
+        }
+
+        void BarrierImplNull::apply(ResourceState after)
+        {
+            m_texture->state(m_slice, m_mip, after);
+
+            auto cmd = const_cast<CommandList&>(m_commandList).native();
+            ++static_cast<const DeviceImplNull*>(cmd->abs().m_device->native())->statistics().barriers;
+        }
+    }
+}
@@ -0,0 +1,22 @@
+#include "engine/graphics/null/NullCommandAllocator.h"
+#include "engine/graphics/null/NullDevice.h"
+
+namespace engine
+{
+    namespace implementation
+    {
+        CommandAllocatorImplNull::CommandAllocatorImplNull(const DeviceImplNull& /*device*/, CommandListType type, const char* /*name*/)
+            : m_type{ type }
+        {
+        }
+
+        void CommandAllocatorImplNull::reset()
+        {
+        }
+
+        CommandListType CommandAllocatorImplNull::type() const
+        {
+            return m_type;
+        }
+    }
+}
@@ -0,0 +1,756 @@
+#include "engine/graphics/null/NullCommandList.h"
+#include "engine/graphics/null/NullCommandAllocator.h"
+#include "engine/graphics/null/NullDevice.h"
+#include "engine/graphics/null/NullPipeline.h"
+#include "engine/graphics/null/NullResources.h"
+
+#include "engine/graphics/Device.h"
+#include "engine/graphics/Resources.h"
+#include "engine/graphics/Semaphore.h"
+#include "engine/graphics/Common.h"
+#include "engine/primitives/Color.h"
+#include "shaders/ShaderTypes.h"
+
+#include "tools/Debug.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+constexpr int NullQueryBufferElements = 10000;
+
+namespace engine
+{
+    namespace implementation
+    {
+        namespace
+        {
+            BufferImplNull& nullBuffer(BufferImplIf* impl)
+            {
+                return *static_cast<BufferImplNull*>(impl);
+            }
+
+            TextureImplNull& nullTexture(TextureImplIf* impl)
+            {
+                return *static_cast<TextureImplNull*>(impl);
+            }
+
+            size_t mipSize(size_t size, size_t mip)
+            {
+                return std::max<size_t>(1u, size >> mip);
+            }
+
+            size_t elementSize(const Buffer& buffer)
+            {
+                auto size = buffer.description().elementSize;
+                if (size == InvalidElementSizeValue)
+                    return formatBytes(buffer.description().format);
+                return static_cast<size_t>(size);
+            }
+
+            // writes one texel of a clear color. formats that are not
+            // handled here are cleared to zero.
+            void clearTexel(Format format, const Color4f& color, uint8_t* dst, size_t bytes)
+            {
+                switch (format)
+                {
+                    case Format::R32G32B32A32_FLOAT:
+                    case Format::R32G32B32_FLOAT:
+                    case Format::R32G32_FLOAT:
+                    case Format::R32_FLOAT:
+                    {
+                        memcpy(dst, color.get(), bytes);
+                        return;
+                    }
+                    case Format::R8G8B8A8_UNORM:
+                    case Format::R8G8B8A8_UNORM_SRGB:
+                    case Format::B8G8R8A8_UNORM:
+                    case Format::B8G8R8A8_UNORM_SRGB:
+                    {
+                        for (int i = 0; i < 4; ++i)
+                            dst[i] = static_cast<uint8_t>(std::min(std::max(color.get()[i], 0.0f), 1.0f) * 255.0f + 0.5f);
+                        if (format == Format::B8G8R8A8_UNORM || format == Format::B8G8R8A8_UNORM_SRGB)
+                            std::swap(dst[0], dst[2]);
+                        return;
+                    }
+                    default:
+                    {
+                        memset(dst, 0, bytes);
+                        return;
+                    }
+                }
+            }
+
+            void insertInto(const uint64_t* ptr, uint64_t freq, engine::vector<QueryResultTicks>& list, GpuMarkerContainer::MarkerItem& marker)
+            {
+                for (auto& item : list)
+                {
+                    if (marker.start > item.start && marker.start < item.stop)
+                    {
+                        insertInto(ptr, freq, item.childs, marker);
+                        return;
+                    }
+                }
+
+                uint64_t start = *(ptr + marker.start);
+                uint64_t stop = *(ptr + marker.stop);
+                list.emplace_back(QueryResultTicks{
+                        marker.query,
+                        static_cast<float>(static_cast<double>((stop - start) * 1000) / static_cast<double>(freq)),
+                        marker.start, marker.stop,
+                        start, stop });
+            }
+        }
+
+        CommandListImplNull::CommandListImplNull(Device* device, CommandListType type, const char* name)
+            : m_device{ device }
+            , m_nullDevice{ *static_cast<const DeviceImplNull*>(device->native()) }
+            , m_type{ type }
+            , m_gpuMarkers{ static_cast<DeviceImplNull*>(device->native())->getMarkerContainer() }
+            , m_open{ true }
+            , m_resolved{ false }
+            , m_pipeBound{ false }
+            , m_barriers{ 0 }
+            , m_pipeline{ nullptr }
+            , m_timestamps(NullQueryBufferElements, 0)
+        {
+            m_allocator = static_pointer_cast<CommandAllocatorImplNull>(static_cast<DeviceImplNull*>(device->native())->createCommandAllocator(type, name));
+            ++m_nullDevice.statistics().commandListsCreated;
+        }
+
+        CommandListImplNull::~CommandListImplNull()
+        {
+            end();
+            clear();
+            static_cast<DeviceImplNull*>(m_device->native())->returnMarkerContainer(std::move(m_gpuMarkers));
+        }
+
+        CommandListType CommandListImplNull::type() const
+        {
+            return m_type;
+        }
+
+        void CommandListImplNull::reset(implementation::PipelineImplIf* /*pipelineState*/)
+        {
+        }
+
+        void CommandListImplNull::clear()
+        {
+            ASSERT(!m_open, "Tried to clear open list");
+            m_open = true;
+            m_barriers = 0;
+            m_pipeBound = false;
+            m_pipeline = nullptr;
+            m_renderTargets.clear();
+            m_depthStencil = TextureDSV();
+            m_vertexBuffer = BufferVBV();
+            m_indexBuffer = BufferIBV();
+            m_viewports.clear();
+            m_scissorRects.clear();
+
+            m_abs.m_debugBuffers.clear();
+
+            m_abs.m_lastSetRTVFormats.clear();
+            if (m_abs.commandListSemaphore)
+                m_abs.commandListSemaphore->reset();
+            m_allocator->reset();
+
+            m_gpuMarkers->reset();
+            m_resolved = false;
+        }
+
+        bool CommandListImplNull::isOpen() const
+        {
+            return m_open;
+        }
+
+        void CommandListImplNull::begin()
+        {
+        }
+
+        void CommandListImplNull::end()
+        {
+            m_open = false;
+        }
+
+        void CommandListImplNull::beginRenderPass(implementation::PipelineImplIf* /*pipeline*/, int /*frameBufferIndex*/)
+        {
+        }
+
+        void CommandListImplNull::endRenderPass()
+        {
+        }
+
+        void CommandListImplNull::applyBarriers()
+        {
+            if (m_barriers > 0)
+            {
+                m_device->transitionCounters().barriers += static_cast<uint32_t>(m_barriers);
+                ++m_device->transitionCounters().flushes;
+            }
+            m_nullDevice.statistics().barriers += m_barriers;
+            m_barriers = 0;
+        }
+
+        void CommandListImplNull::executeBundle(CommandListImplIf* /*commandList*/)
+        {
+            applyBarriers();
+        }
+
+        void CommandListImplNull::transition(Texture resource, ResourceState state, const SubResource& subResource)
+        {
+            TextureImplIf* impl = resource.m_impl;
+
+            // whole resource in one state is a single barrier, same as dx12
+            ResourceState currentState;
+            if ((subResource.arraySliceCount == AllArraySlices) &&
+                (subResource.mipCount == AllMipLevels) &&
+                impl->uniformState(currentState))
+            {
+                if (currentState != state)
+                {
+                    impl->state(state);
+                    ++m_barriers;
+                }
+                return;
+            }
+
+            uint32_t sliceCount = subResource.arraySliceCount == AllArraySlices ?
+                static_cast<uint32_t>(resource.arraySlices()) :
+                static_cast<uint32_t>(std::min(subResource.arraySliceCount, static_cast<int32_t>(resource.arraySlices() - static_cast<size_t>(subResource.firstArraySlice))));
+
+            uint32_t mipCount = subResource.mipCount == AllMipLevels ?
+                static_cast<uint32_t>(resource.mipLevels()) :
+                static_cast<uint32_t>(std::min(subResource.mipCount, static_cast<int32_t>(resource.mipLevels() - static_cast<size_t>(subResource.firstMipLevel))));
+
+            for (int slice = static_cast<int>(subResource.firstArraySlice); slice < static_cast<int>(subResource.firstArraySlice + sliceCount); ++slice)
+            {
+                for (int mip = static_cast<int>(subResource.firstMipLevel); mip < static_cast<int>(subResource.firstMipLevel + mipCount); ++mip)
+                {
+                    if (impl->state(slice, mip) != state)
+                    {
+                        impl->state(slice, mip, state);
+                        ++m_barriers;
+                    }
+                }
+            }
+        }
+
+        void CommandListImplNull::transition(TextureRTV resource, ResourceState state)
+        {
+            transition(resource.texture(), state, resource.subResource());
+        }
+
+        void CommandListImplNull::transition(TextureSRV resource, ResourceState state)
+        {
+            transition(resource.texture(), state, resource.subResource());
+        }
+
+        void CommandListImplNull::transition(TextureDSV resource, ResourceState state)
+        {
+            transition(resource.texture(), state, resource.subResource());
+        }
+
+        void CommandListImplNull::transition(Buffer resource, ResourceState state)
+        {
+            BufferImplIf* impl = resource.m_impl;
+            if (impl->state() == state)
+                return;
+
+            impl->state(state);
+            ++m_barriers;
+        }
+
+        void CommandListImplNull::transition(BufferSRV resource, ResourceState state)
+        {
+            transition(resource.buffer(), state);
+        }
+
+        void CommandListImplNull::transition(BufferIBV resource, ResourceState state)
+        {
+            transition(resource.buffer(), state);
+        }
+
+        void CommandListImplNull::transition(BufferCBV resource, ResourceState state)
+        {
+            transition(resource.buffer(), state);
+        }
+
+        void CommandListImplNull::transition(BufferVBV resource, ResourceState state)
+        {
+            transition(resource.buffer(), state);
+        }
+
+        void CommandListImplNull::setPredicate(BufferSRV /*buffer*/, uint64_t /*offset*/, PredicationOp /*op*/)
+        {
+            applyBarriers();
+            ++m_nullDevice.statistics().calls;
+        }
+
+        void CommandListImplNull::setRenderTargets(TextureDSV target)
+        {
+            applyBarriers();
+            m_renderTargets.clear();
+            m_depthStencil = target;
+
+            setViewPorts({
+                engine::Viewport{
+                0, 0,
+                static_cast<float>(target.width()),
+                static_cast<float>(target.height()),
+                0.0f, 1.0f } });
+            setScissorRects({ engine::Rectangle{ 0, 0,
+                static_cast<int>(target.width()),
+                static_cast<int>(target.height()) } });
+        }
+
+        void CommandListImplNull::setRenderTargets(engine::vector<TextureRTV> targets)
+        {
+            applyBarriers();
+            m_renderTargets = targets;
+            m_depthStencil = TextureDSV();
+
+            if (targets.size() > 0)
+            {
+                setViewPorts({
+                    engine::Viewport{
+                    0, 0,
+                    static_cast<float>(targets[0].width()),
+                    static_cast<float>(targets[0].height()),
+                    0.0f, 1.0f } });
+                setScissorRects({ engine::Rectangle{ 0, 0,
+                    static_cast<int>(targets[0].width()),
+                    static_cast<int>(targets[0].height()) } });
+            }
+        }
+
+        void CommandListImplNull::setRenderTargets(engine::vector<TextureRTV> targets, TextureDSV dsv)
+        {
+            applyBarriers();
+            m_renderTargets.clear();
+            for (auto&& target : targets)
+                if (target.valid())
+                    m_renderTargets.emplace_back(target);
+            m_depthStencil = dsv;
+
+            auto width = targets.size() > 0 ? targets[0].width() : dsv.texture().width();
+            auto height = targets.size() > 0 ? targets[0].height() : dsv.texture().height();
+            setViewPorts({
+                engine::Viewport{
+                0, 0,
+                static_cast<float>(width),
+                static_cast<float>(height),
+                0.0f, 1.0f } });
+            setScissorRects({ engine::Rectangle{ 0, 0,
+                static_cast<int>(width),
+                static_cast<int>(height) } });
+        }
+
+        void CommandListImplNull::copyBytes(Buffer dst, size_t dstByte, const uint8_t* src, size_t bytes)
+        {
+            auto& dstBuffer = nullBuffer(dst.m_impl);
+            ASSERT(dstByte + bytes <= dstBuffer.sizeBytes(), "Trying to write outside destination buffer");
+            memcpy(dstBuffer.data() + dstByte, src, bytes);
+
+            ++m_nullDevice.statistics().copies;
+            m_nullDevice.statistics().copyBytes += bytes;
+        }
+
+        void CommandListImplNull::copyBuffer(
+            Buffer srcBuffer,
+            Buffer dstBuffer,
+            uint64_t elements,
+            size_t srcStartElement,
+            size_t dstStartElement)
+        {
+            applyBarriers();
+
+            auto srcElementSize = elementSize(srcBuffer);
+            auto dstElementSize = elementSize(dstBuffer);
+            auto& src = nullBuffer(srcBuffer.m_impl);
+
+            auto bytes = static_cast<size_t>(elements) * srcElementSize;
+            ASSERT((srcStartElement * srcElementSize) + bytes <= src.sizeBytes(), "Trying to read from outside source buffer");
+            copyBytes(dstBuffer, dstStartElement * dstElementSize, src.data() + srcStartElement * srcElementSize, bytes);
+        }
+
+        void CommandListImplNull::copyBufferBytes(Buffer srcBuffer, Buffer dstBuffer, uint64_t bytes, size_t srcStartByte, size_t dstStartByte)
+        {
+            applyBarriers();
+
+            auto& src = nullBuffer(srcBuffer.m_impl);
+            ASSERT(srcStartByte + bytes <= src.sizeBytes(), "Trying to read from outside source buffer");
+            copyBytes(dstBuffer, dstStartByte, src.data() + srcStartByte, static_cast<size_t>(bytes));
+        }
+
+        void CommandListImplNull::bindPipe(
+            implementation::PipelineImplIf* pipelineImpl,
+            shaders::PipelineConfiguration* configuration)
+        {
+            applyBarriers();
+
+            static_cast<PipelineImplNull*>(pipelineImpl)->configure(this, configuration);
+            m_pipeline = pipelineImpl;
+            m_pipeBound = true;
+            ++m_nullDevice.statistics().pipelineBinds;
+        }
+
+        void CommandListImplNull::setViewPorts(const engine::vector<Viewport>& viewports)
+        {
+            m_viewports = viewports;
+        }
+
+        void CommandListImplNull::setScissorRects(const engine::vector<Rectangle>& rects)
+        {
+            m_scissorRects = rects;
+        }
+
+        void CommandListImplNull::bindVertexBuffer(BufferVBV buffer)
+        {
+            applyBarriers();
+            m_vertexBuffer = buffer;
+            ++m_nullDevice.statistics().descriptorBinds;
+        }
+
+        void CommandListImplNull::bindIndexBuffer(BufferIBV buffer)
+        {
+            applyBarriers();
+            m_indexBuffer = buffer;
+            ++m_nullDevice.statistics().descriptorBinds;
+        }
+
+        void CommandListImplNull::clearBuffer(BufferUAV buffer, uint32_t value, size_t startElement, size_t numElements)
+        {
+            applyBarriers();
+
+            auto& dst = nullBuffer(buffer.buffer().m_impl);
+            auto size = elementSize(buffer.buffer());
+            auto start = startElement * size;
+            auto bytes = numElements * size;
+            ASSERT(start + bytes <= dst.sizeBytes(), "Trying to clear outside buffer");
+
+            auto ptr = dst.data() + start;
+            for (size_t i = 0; i < bytes; i += sizeof(uint32_t))
+                memcpy(ptr + i, &value, std::min(sizeof(uint32_t), bytes - i));
+
+            ++m_nullDevice.statistics().clears;
+        }
+
+        void CommandListImplNull::clearTextureUAV(TextureUAV texture, const Color4f& color)
+        {
+            applyBarriers();
+
+            auto& dst = nullTexture(texture.texture().m_impl);
+            auto texelBytes = formatBytes(texture.format());
+            for (int slice = 0; slice < static_cast<int>(texture.texture().arraySlices()); ++slice)
+            {
+                for (int mip = 0; mip < static_cast<int>(texture.texture().mipLevels()); ++mip)
+                {
+                    auto ptr = dst.data(slice, mip);
+                    auto bytes = dst.sizeBytes(mip);
+                    for (size_t i = 0; i + texelBytes <= bytes; i += texelBytes)
+                        clearTexel(texture.format(), color, ptr + i, texelBytes);
+                }
+            }
+            ++m_nullDevice.statistics().clears;
+        }
+
+        void CommandListImplNull::clearTextureDSV(TextureDSV texture, float depth, uint8_t stencil)
+        {
+            transition(texture, ResourceState::DepthWrite);
+            applyBarriers();
+
+            auto& dst = nullTexture(texture.texture().m_impl);
+            auto subResource = texture.subResource();
+            auto slice = static_cast<int>(subResource.firstArraySlice);
+            auto mip = static_cast<int>(subResource.firstMipLevel);
+            auto ptr = dst.data(slice, mip);
+            auto bytes = dst.sizeBytes(mip);
+
+            if (texture.format() == Format::D32_FLOAT)
+            {
+                for (size_t i = 0; i + sizeof(float) <= bytes; i += sizeof(float))
+                    memcpy(ptr + i, &depth, sizeof(float));
+            }
+            else if (texture.format() == Format::D24_UNORM_S8_UINT)
+            {
+                uint32_t value = (static_cast<uint32_t>(std::min(std::max(depth, 0.0f), 1.0f) * 16777215.0f) & 0xffffff) | (static_cast<uint32_t>(stencil) << 24);
+                for (size_t i = 0; i + sizeof(uint32_t) <= bytes; i += sizeof(uint32_t))
+                    memcpy(ptr + i, &value, sizeof(uint32_t));
+            }
+            else
+                memset(ptr, 0, bytes);
+
+            ++m_nullDevice.statistics().clears;
+        }
+
+        void CommandListImplNull::clearTextureRTV(TextureRTV texture, const Color4f& color)
+        {
+            transition(texture, ResourceState::RenderTarget);
+            applyBarriers();
+
+            auto& dst = nullTexture(texture.texture().m_impl);
+            auto subResource = texture.subResource();
+            auto slice = static_cast<int>(subResource.firstArraySlice);
+            auto mip = static_cast<int>(subResource.firstMipLevel);
+            auto ptr = dst.data(slice, mip);
+            auto bytes = dst.sizeBytes(mip);
+            auto texelBytes = formatBytes(texture.format());
+
+            for (size_t i = 0; i + texelBytes <= bytes; i += texelBytes)
+                clearTexel(texture.format(), color, ptr + i, texelBytes);
+
+            ++m_nullDevice.statistics().clears;
+        }
+
+        void CommandListImplNull::setStructureCounter(BufferUAV buffer, uint32_t value)
+        {
+            applyBarriers();
+            static_cast<BufferUAVImplNull*>(buffer.m_impl)->counter(value);
+            m_nullDevice.statistics().uploadBytes += sizeof(uint32_t);
+        }
+
+        void CommandListImplNull::copyStructureCounter(BufferUAV srcBuffer, Buffer dst, uint32_t dstByteOffset)
+        {
+            applyBarriers();
+            auto value = static_cast<BufferUAVImplNull*>(srcBuffer.m_impl)->counter();
+            copyBytes(dst, dstByteOffset, reinterpret_cast<const uint8_t*>(&value), sizeof(uint32_t));
+        }
+
+        void CommandListImplNull::draw(size_t /*vertexCount*/)
+        {
+            if (!m_pipeBound)
+                return;
+            applyBarriers();
+            ++m_nullDevice.statistics().draws;
+        }
+
+        void CommandListImplNull::drawIndirect(Buffer /*indirectArguments*/, uint64_t /*argumentBufferOffset*/)
+        {
+            if (!m_pipeBound)
+                return;
+            applyBarriers();
+            ++m_nullDevice.statistics().draws;
+        }
+
+        void CommandListImplNull::drawIndexedInstanced(
+            size_t /*indexCount*/,
+            size_t /*instanceCount*/,
+            size_t /*firstIndex*/,
+            int32_t /*vertexOffset*/,
+            size_t /*firstInstance*/)
+        {
+            if (!m_pipeBound)
+                return;
+            applyBarriers();
+            ++m_nullDevice.statistics().draws;
+        }
+
+        void CommandListImplNull::drawIndexedIndirect(Buffer /*indirectArguments*/, uint64_t /*argumentBufferOffset*/)
+        {
+            if (!m_pipeBound)
+                return;
+            applyBarriers();
+            ++m_nullDevice.statistics().draws;
+        }
+
+        void CommandListImplNull::drawIndexedInstancedIndirect(
+            BufferIBV indexBuffer,
+            Buffer /*indirectArguments*/,
+            uint64_t /*argumentBufferOffset*/,
+            Buffer /*indirectArgumentsCountBuffer*/,
+            uint64_t /*countBufferOffset*/)
+        {
+            if (!m_pipeBound)
+                return;
+            bindIndexBuffer(indexBuffer);
+            ++m_nullDevice.statistics().draws;
+        }
+
+        void CommandListImplNull::executeIndexedIndirect(
+            BufferIBV indexBuffer,
+            Buffer /*indirectArguments*/,
+            uint64_t /*argumentBufferOffset*/,
+            Buffer /*countBuffer*/,
+            uint64_t /*countBufferOffsetBytes*/)
+        {
+            if (!m_pipeBound)
+                return;
+            bindIndexBuffer(indexBuffer);
+            ++m_nullDevice.statistics().draws;
+        }
+
+        void CommandListImplNull::dispatch(
+            size_t /*threadGroupCountX*/,
+            size_t /*threadGroupCountY*/,
+            size_t /*threadGroupCountZ*/)
+        {
+            if (!m_pipeBound)
+                return;
+            applyBarriers();
+            ++m_nullDevice.statistics().dispatches;
+        }
+
+        void CommandListImplNull::dispatchIndirect(
+            Buffer /*indirectArguments*/,
+            uint64_t /*argumentBufferOffset*/)
+        {
+            if (!m_pipeBound)
+                return;
+            applyBarriers();
+            ++m_nullDevice.statistics().dispatches;
+        }
+
+        void CommandListImplNull::dispatchMesh(
+            size_t /*threadGroupCountX*/,
+            size_t /*threadGroupCountY*/,
+            size_t /*threadGroupCountZ*/)
+        {
+            if (!m_pipeBound)
+                return;
+            applyBarriers();
+            ++m_nullDevice.statistics().draws;
+        }
+
+        void CommandListImplNull::copySubresource(Texture src, Texture dst)
+        {
+            applyBarriers();
+            auto& srcTexture = nullTexture(src.m_impl);
+            auto& dstTexture = nullTexture(dst.m_impl);
+
+            auto bytes = std::min(srcTexture.sizeBytes(0), dstTexture.sizeBytes(0));
+            memcpy(dstTexture.data(0, 0), srcTexture.data(0, 0), bytes);
+
+            ++m_nullDevice.statistics().copies;
+            m_nullDevice.statistics().copyBytes += bytes;
+        }
+
+        void CommandListImplNull::copyToBuffer(Texture src, Buffer dst, size_t rowPitch)
+        {
+            applyBarriers();
+            auto& srcTexture = nullTexture(src.m_impl);
+            auto& dstBuffer = nullBuffer(dst.m_impl);
+
+            auto info = surfaceInformation(src.format(), src.width(), src.height());
+            auto rowBytes = std::min(info.rowBytes, rowPitch);
+            size_t copied = 0;
+            for (size_t row = 0; row < info.numRows; ++row)
+            {
+                if ((row * rowPitch) + rowBytes > dstBuffer.sizeBytes())
+                    break;
+                memcpy(dstBuffer.data() + (row * rowPitch), srcTexture.data(0, 0) + (row * info.rowBytes), rowBytes);
+                copied += rowBytes;
+            }
+
+            ++m_nullDevice.statistics().copies;
+            m_nullDevice.statistics().copyBytes += copied;
+        }
+
+        void CommandListImplNull::copyTexture(TextureSRV src, TextureDSV dst)
+        {
+            copySubresource(src.texture(), dst.texture());
+        }
+
+        void CommandListImplNull::copyTexture(TextureSRV src, TextureUAV dst)
+        {
+            copySubresource(src.texture(), dst.texture());
+        }
+
+        void CommandListImplNull::copyTexture(TextureSRV src, TextureSRV dst)
+        {
+            copySubresource(src.texture(), dst.texture());
+        }
+
+        void CommandListImplNull::copyTexture(TextureSRV src, BufferUAV dst)
+        {
+            copyToBuffer(src.texture(), dst.buffer(), elementSize(dst.buffer()) * src.width());
+        }
+
+        void CommandListImplNull::copyTexture(TextureSRV src, BufferSRV dst)
+        {
+            // rows are tightly packed. matches DeviceImplNull::getTextureBufferCopyDesc
+            copyToBuffer(src.texture(), dst.buffer(), elementSize(dst.buffer()) * src.width());
+        }
+
+        void CommandListImplNull::copyTexture(
+            Buffer      srcBuffer,
+            size_t      srcOffset,
+            size_t      srcWidth,
+            size_t      srcHeight,
+            size_t      srcRowPitch,
+            Texture     dst,
+            size_t      dstX,
+            size_t      dstY,
+            size_t      dstMip,
+            size_t      dstSlice,
+            size_t      /*dstMipCount*/)
+        {
+            applyBarriers();
+            auto& src = nullBuffer(srcBuffer.m_impl);
+            auto& dstTexture = nullTexture(dst.m_impl);
+
+            auto mipWidth = mipSize(dst.width(), dstMip);
+            auto mipHeight = mipSize(dst.height(), dstMip);
+            auto dstInfo = surfaceInformation(dst.format(), mipWidth, mipHeight);
+            auto srcInfo = surfaceInformation(dst.format(), srcWidth, srcHeight);
+
+            // block compressed formats address whole blocks
+            auto dstRow = dstY * dstInfo.numRows / mipHeight;
+            auto dstRowOffset = dstX * dstInfo.rowBytes / mipWidth;
+
+            auto ptr = dstTexture.data(static_cast<int>(dstSlice), static_cast<int>(dstMip));
+            size_t copied = 0;
+            for (size_t row = 0; row < srcInfo.numRows && dstRow + row < dstInfo.numRows; ++row)
+            {
+                auto bytes = std::min(srcInfo.rowBytes, dstInfo.rowBytes - dstRowOffset);
+                auto srcStart = srcOffset + (row * srcRowPitch);
+                ASSERT(srcStart + bytes <= src.sizeBytes(), "Trying to read from outside source buffer");
+                memcpy(ptr + ((dstRow + row) * dstInfo.rowBytes) + dstRowOffset, src.data() + srcStart, bytes);
+                copied += bytes;
+            }
+
+            ++m_nullDevice.statistics().copies;
+            m_nullDevice.statistics().copyBytes += copied;
+        }
+
+        void CommandListImplNull::writeTimestamp(uint32_t queryId)
+        {
+            if (queryId < m_timestamps.size())
+                m_timestamps[queryId] = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+            ++m_nullDevice.statistics().queries;
+        }
+
+        uint32_t CommandListImplNull::startQuery(const char* query)
+        {
+            auto res = m_gpuMarkers->startQuery(query);
+            writeTimestamp(res);
+            return res;
+        }
+
+        void CommandListImplNull::stopQuery(uint32_t queryId)
+        {
+            writeTimestamp(m_gpuMarkers->stopQuery(queryId));
+        }
+
+        void CommandListImplNull::resolveQueries()
+        {
+            if (m_gpuMarkers->queryCount() == 0)
+                return;
+
+            ASSERT(!m_resolved, "Command list already resolved");
+            m_resolved = true;
+        }
+
+        engine::vector<QueryResultTicks> CommandListImplNull::fetchQueryResults(uint64_t freq)
+        {
+            engine::vector<QueryResultTicks> res;
+            engine::vector<GpuMarkerContainer::MarkerItem>& items = m_gpuMarkers->items();
+            for (uint32_t i = 0; i < m_gpuMarkers->markerCount(); ++i)
+            {
+                insertInto(m_timestamps.data(), freq, res, items[i]);
+            }
+            return res;
+        }
+    }
+}
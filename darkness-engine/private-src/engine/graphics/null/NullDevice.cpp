@@ -0,0 +1,241 @@
+#include "engine/graphics/null/NullDevice.h"
+#include "engine/graphics/null/NullResources.h"
+#include "engine/graphics/null/NullCommandAllocator.h"
+#include "engine/graphics/CommandListImplIf.h"
+#include "engine/graphics/Resources.h"
+#include "engine/graphics/Device.h"
+#include "engine/graphics/CommandList.h"
+#include "tools/Debug.h"
+#include "platform/window/Window.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace tools;
+
+namespace engine
+{
+    namespace implementation
+    {
+        DeviceImplNull::DeviceImplNull(engine::shared_ptr<platform::Window> window)
+            : m_window{ window }
+            , m_nullResources{}
+            , m_gpuMarkerStorage{}
+            , m_statistics{}
+            , m_logSubmits{ false }
+        {
+        }
+
+        void DeviceImplNull::createFences(Device& /*device*/)
+        {
+            // fences complete when they are signaled so there are no
+            // upload fences to track
+        }
+
+        void DeviceImplNull::nullResources(engine::shared_ptr<NullResources> nullResources)
+        {
+            m_nullResources = nullResources;
+        }
+
+        NullResources& DeviceImplNull::nullResources()
+        {
+            return *m_nullResources;
+        }
+
+        engine::shared_ptr<TextureImplIf> DeviceImplNull::createTexture(const Device& /*device*/, Queue& /*queue*/, const TextureDescription& desc)
+        {
+            auto texture = engine::make_shared<TextureImplNull>(*this, desc);
+            if (desc.initialData)
+            {
+                // initial data is laid out slice major like the texture memory
+                auto bytes = std::min(desc.initialData.data.sizeBytes(), texture->sizeBytes());
+                memcpy(texture->data(0, 0), reinterpret_cast<const uint8_t*>(desc.initialData.data.start), bytes);
+                m_statistics.uploadBytes += bytes;
+            }
+            return texture;
+        }
+
+        void DeviceImplNull::uploadBuffer(CommandList& /*commandList*/, BufferSRV buffer, const ByteRange& data, size_t startElement)
+        {
+            uploadBufferInternal(buffer.buffer(), data, startElement * buffer.buffer().description().elementSize);
+        }
+
+        void DeviceImplNull::uploadBuffer(CommandList& /*commandList*/, BufferUAV buffer, const ByteRange& data, size_t startElement)
+        {
+            uploadBufferInternal(buffer.buffer(), data, startElement * buffer.buffer().description().elementSize);
+        }
+
+        void DeviceImplNull::uploadBuffer(CommandList& /*commandList*/, BufferCBV buffer, const ByteRange& data, size_t startElement)
+        {
+            uploadBufferInternal(buffer.buffer(), data, startElement * buffer.buffer().description().elementSize);
+        }
+
+        void DeviceImplNull::uploadBuffer(CommandList& /*commandList*/, BufferIBV buffer, const ByteRange& data, size_t startElement)
+        {
+            uploadBufferInternal(buffer.buffer(), data, startElement * buffer.buffer().description().elementSize);
+        }
+
+        void DeviceImplNull::uploadBuffer(CommandList& /*commandList*/, BufferVBV buffer, const ByteRange& data, size_t startElement)
+        {
+            uploadBufferInternal(buffer.buffer(), data, startElement * buffer.buffer().description().elementSize);
+        }
+
+        void DeviceImplNull::uploadRawBuffer(CommandListImplIf* /*commandList*/, Buffer buffer, const ByteRange& data, size_t startBytes)
+        {
+            uploadBufferInternal(buffer, data, startBytes);
+        }
+
+        void DeviceImplNull::uploadBufferInternal(Buffer buffer, const ByteRange& data, size_t startBytes)
+        {
+            auto impl = static_cast<BufferImplNull*>(buffer.m_impl);
+            ASSERT(startBytes + data.sizeBytes() <= impl->sizeBytes(), "Trying to upload outside buffer");
+            memcpy(impl->data() + startBytes, reinterpret_cast<const uint8_t*>(data.start), data.sizeBytes());
+            m_statistics.uploadBytes += data.sizeBytes();
+        }
+
+        const platform::Window& DeviceImplNull::window() const
+        {
+            ASSERT(m_window, "Null device was created without a window");
+            return *m_window;
+        }
+
+        void DeviceImplNull::window(engine::shared_ptr<platform::Window> window)
+        {
+            m_window = window;
+        }
+
+        int DeviceImplNull::width() const
+        {
+            if (m_window)
+                return m_window->width();
+            return NullDeviceDefaultWidth;
+        }
+
+        int DeviceImplNull::height() const
+        {
+            if (m_window)
+                return m_window->height();
+            return NullDeviceDefaultHeight;
+        }
+
+        void DeviceImplNull::waitForIdle()
+        {
+        }
+
+        engine::shared_ptr<CommandAllocatorImplIf> DeviceImplNull::createCommandAllocator(CommandListType type, const char* name)
+        {
+            return engine::make_shared<CommandAllocatorImplNull>(*this, type, name);
+        }
+
+        void DeviceImplNull::freeCommandAllocator(engine::shared_ptr<CommandAllocatorImplIf> /*allocator*/)
+        {
+        }
+
+        engine::unique_ptr<GpuMarkerContainer> DeviceImplNull::getMarkerContainer()
+        {
+            return m_gpuMarkerStorage.getNewContainer();
+        }
+
+        void DeviceImplNull::returnMarkerContainer(engine::unique_ptr<GpuMarkerContainer>&& container)
+        {
+            m_gpuMarkerStorage.returnContainer(std::move(container));
+        }
+
+        void DeviceImplNull::setCurrentFenceValue(CommandListType /*type*/, engine::FenceValue /*value*/)
+        {
+        }
+
+        void DeviceImplNull::processUploads(engine::FenceValue /*value*/, bool /*force*/)
+        {
+            // uploads are copied immediately
+        }
+
+        CpuTexture DeviceImplNull::grabTexture(Device& /*device*/, TextureSRV texture)
+        {
+            auto impl = static_cast<TextureImplNull*>(texture.texture().m_impl);
+
+            CpuTexture result;
+            result.width = texture.width();
+            result.height = texture.height();
+            result.pitch = texture.width();
+            result.pitchBytes = result.pitch * formatBytes(texture.format());
+            result.format = texture.format();
+            result.zeroUp = true;
+            result.data = engine::make_shared<vector<uint8_t>>();
+            result.data->resize(impl->sizeBytes(0));
+            memcpy(result.data->data(), impl->data(0, 0), result.data->size());
+            return result;
+        }
+
+        TextureSRVOwner DeviceImplNull::loadTexture(Device& device, const CpuTexture& texture)
+        {
+            auto tex = texture.zeroUp ? texture.tightPack() : texture.tightPack().flipYAxis();
+            return device.createTextureSRV(TextureDescription()
+                .name("Device loadTexture srv")
+                .width(tex.width)
+                .height(tex.height)
+                .format(tex.format)
+                .arraySlices(1ull)
+                .mipLevels(1)
+                .setInitialData(TextureDescription::InitialData(
+                    *tex.data,
+                    tex.pitch,
+                    tex.pitch * tex.height)));
+        }
+
+        void DeviceImplNull::copyTexture(Device& /*device*/, const CpuTexture& texture, TextureSRV dst)
+        {
+            auto tex = texture.tightPack();
+            auto impl = static_cast<TextureImplNull*>(dst.texture().m_impl);
+            auto bytes = std::min(tex.data->size(), impl->sizeBytes(0));
+            memcpy(impl->data(0, 0), tex.data->data(), bytes);
+            m_statistics.uploadBytes += bytes;
+        }
+
+        TextureBufferCopyDesc DeviceImplNull::getTextureBufferCopyDesc(size_t width, size_t height, Format format)
+        {
+            // no pitch alignment requirements on the CPU
+            TextureBufferCopyDesc result;
+            result.elementSize = engine::formatBytes(format);
+            result.elements = width * height;
+            result.bufferSize = result.elementSize * result.elements;
+            result.width = width;
+            result.height = height;
+            result.pitch = width;
+            result.pitchBytes = result.pitch * result.elementSize;
+            result.format = format;
+            result.zeroUp = true;
+            return result;
+        }
+
+        bool DeviceImplNull::reservedBuffersSupported() const
+        {
+            return true;
+        }
+
+        void DeviceImplNull::commitBuffer(Buffer buffer, size_t bytes)
+        {
+            static_cast<BufferImplNull*>(buffer.m_impl)->commit(*this, bytes);
+        }
+
+        void DeviceImplNull::logSubmits(bool enabled)
+        {
+            std::lock_guard<std::mutex> lock(m_submitMutex);
+            m_logSubmits = enabled;
+            m_submits.clear();
+        }
+
+        void DeviceImplNull::submitted(const char* commandList) const
+        {
+            std::lock_guard<std::mutex> lock(m_submitMutex);
+            if (m_logSubmits)
+                m_submits.emplace_back(commandList ? commandList : "");
+        }
+
+        engine::vector<engine::string> DeviceImplNull::submits() const
+        {
+            std::lock_guard<std::mutex> lock(m_submitMutex);
+            return m_submits;
+        }
+    }
+}
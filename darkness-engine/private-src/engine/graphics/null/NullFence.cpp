@@ -0,0 +1,77 @@
+#include "engine/graphics/null/NullFence.h"
+#include "engine/graphics/null/NullDevice.h"
+
+#include "tools/Debug.h"
+
+namespace engine
+{
+    namespace implementation
+    {
+        FenceImplNull::FenceImplNull(const DeviceImplIf* device, const char* /*name*/)
+            : m_device{ static_cast<const DeviceImplNull*>(device) }
+            , m_fenceValue{ 0 }
+            , m_completedValue{ 0 }
+        {
+        }
+
+        void FenceImplNull::increaseCPUValue()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_fenceValue++;
+        }
+
+        FenceValue FenceImplNull::currentCPUValue() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_fenceValue;
+        }
+
+        FenceValue FenceImplNull::currentGPUValue() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_completedValue;
+        }
+
+        void FenceImplNull::blockUntilSignaled()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            auto value = m_fenceValue;
+            m_signal.wait(lock, [&]() { return m_completedValue >= value; });
+        }
+
+        void FenceImplNull::blockUntilSignaled(engine::FenceValue value)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_signal.wait(lock, [&]() { return m_completedValue >= value; });
+        }
+
+        void FenceImplNull::reset()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_fenceValue = m_completedValue;
+        }
+
+        bool FenceImplNull::signaled() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_completedValue >= m_fenceValue;
+        }
+
+        bool FenceImplNull::signaled(FenceValue value) const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_completedValue >= value;
+        }
+
+        void FenceImplNull::signal(engine::FenceValue value)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (value > m_completedValue)
+                    m_completedValue = value;
+            }
+            m_signal.notify_all();
+            ++m_device->statistics().fenceSignals;
+        }
+    }
+}
@@ -0,0 +1,29 @@
+#include "engine/graphics/null/NullGpuMarker.h"
+#include "engine/graphics/null/NullCommandList.h"
+
+#include "engine/graphics/CommandList.h"
+
+namespace engine
+{
+    namespace implementation
+    {
+        GpuMarkerImplNull::GpuMarkerImplNull(CommandList& cmd, const char* msg)
+            : cmdList{ static_cast<CommandListImplNull*>(cmd.native()) }
+            , m_queryId{ cmdList->startQuery(msg) }
+        {
+        }
+
+        GpuMarkerImplNull::~GpuMarkerImplNull()
+        {
+            cmdList->stopQuery(m_queryId);
+        }
+
+        CpuMarkerImplNull::CpuMarkerImplNull(const char* /*msg*/)
+        {
+        }
+
+        CpuMarkerImplNull::~CpuMarkerImplNull()
+        {
+        }
+    }
+}
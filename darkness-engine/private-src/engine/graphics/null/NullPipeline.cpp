@@ -0,0 +1,141 @@
+#include "engine/graphics/null/NullPipeline.h"
+#include "engine/graphics/null/NullDevice.h"
+
+#include "engine/graphics/Device.h"
+#include "engine/graphics/Resources.h"
+#include "shaders/ShaderTypes.h"
+
+namespace engine
+{
+    namespace implementation
+    {
+        PipelineImplNull::PipelineImplNull(
+            Device& device,
+            ShaderStorage& /*storage*/)
+            : m_device{ *static_cast<const DeviceImplNull*>(device.native()) }
+            , m_blend{}
+            , m_rasterizer{}
+            , m_depthStencil{}
+            , m_sampleMask{ 0xffffffff }
+            , m_topology{ PrimitiveTopologyType::TriangleList }
+            , m_primitiveRestart{ IndexBufferStripCutValue::ValueDisabled }
+            , m_dsvFormat{ Format::UNKNOWN }
+            , m_msaaCount{ 1 }
+            , m_msaaQuality{ 0 }
+            , m_compute{ false }
+            , m_bindingCount{ 0 }
+            , m_constantBytes{ 0 }
+        {
+        }
+
+        void PipelineImplNull::setBlendState(const BlendDescription& desc)
+        {
+            m_blend = desc;
+        }
+
+        void PipelineImplNull::setRasterizerState(const RasterizerDescription& desc)
+        {
+            m_rasterizer = desc;
+        }
+
+        void PipelineImplNull::setDepthStencilState(const DepthStencilDescription& desc)
+        {
+            m_depthStencil = desc;
+        }
+
+        void PipelineImplNull::setSampleMask(unsigned int mask)
+        {
+            m_sampleMask = mask;
+        }
+
+        void PipelineImplNull::setPrimitiveTopologyType(PrimitiveTopologyType type, bool /*adjacency*/)
+        {
+            m_topology = type;
+        }
+
+        void PipelineImplNull::setPrimitiveRestart(IndexBufferStripCutValue value)
+        {
+            m_primitiveRestart = value;
+        }
+
+        void PipelineImplNull::setRenderTargetFormat(Format RTVFormat, Format DSVFormat, unsigned int msaaCount, unsigned int msaaQuality)
+        {
+            m_rtvFormats = { RTVFormat };
+            m_dsvFormat = DSVFormat;
+            m_msaaCount = msaaCount;
+            m_msaaQuality = msaaQuality;
+        }
+
+        void PipelineImplNull::setRenderTargetFormats(engine::vector<Format> RTVFormats, Format DSVFormat, unsigned int msaaCount, unsigned int msaaQuality)
+        {
+            m_rtvFormats = RTVFormats;
+            m_dsvFormat = DSVFormat;
+            m_msaaCount = msaaCount;
+            m_msaaQuality = msaaQuality;
+        }
+
+        void PipelineImplNull::countBindings(shaders::Shader* shader)
+        {
+            for (auto&& srv : shader->texture_srvs())
+                if (srv.valid())
+                    ++m_bindingCount;
+            for (auto&& uav : shader->texture_uavs())
+                if (uav.valid())
+                    ++m_bindingCount;
+            for (auto&& srv : shader->buffer_srvs())
+                if (srv.valid())
+                    ++m_bindingCount;
+            for (auto&& uav : shader->buffer_uavs())
+                if (uav.valid())
+                    ++m_bindingCount;
+
+            for (auto&& srv : shader->bindless_texture_srvs())
+                m_bindingCount += srv->size();
+            for (auto&& uav : shader->bindless_texture_uavs())
+                m_bindingCount += uav->size();
+            for (auto&& srv : shader->bindless_buffer_srvs())
+                m_bindingCount += srv->size();
+            for (auto&& uav : shader->bindless_buffer_uavs())
+                m_bindingCount += uav->size();
+
+            m_bindingCount += shader->samplers().size();
+
+            for (auto&& constant : shader->constants())
+            {
+                ++m_bindingCount;
+                m_constantBytes += constant.range.sizeBytes();
+            }
+        }
+
+        void PipelineImplNull::configure(CommandListImplIf* /*cmdList*/, shaders::PipelineConfiguration* configuration)
+        {
+            m_bindingCount = 0;
+            m_constantBytes = 0;
+            m_compute = configuration->hasComputeShader();
+
+            const shaders::Shader* shaders[] = {
+                configuration->hasVertexShader() ? configuration->vertexShader() : nullptr,
+                configuration->hasPixelShader() ? configuration->pixelShader() : nullptr,
+                configuration->hasGeometryShader() ? configuration->geometryShader() : nullptr,
+                configuration->hasHullShader() ? configuration->hullShader() : nullptr,
+                configuration->hasDomainShader() ? configuration->domainShader() : nullptr,
+                configuration->hasComputeShader() ? configuration->computeShader() : nullptr,
+                configuration->hasAmplificationShader() ? configuration->amplificationShader() : nullptr,
+                configuration->hasMeshShader() ? configuration->meshShader() : nullptr
+            };
+            for (auto&& shader : shaders)
+                if (shader)
+                    countBindings(const_cast<shaders::Shader*>(shader));
+
+            m_device.statistics().descriptorBinds += m_bindingCount;
+            m_device.statistics().uploadBytes += m_constantBytes;
+        }
+
+        void PipelineImplNull::prewarm(shaders::PipelineConfiguration* configuration)
+        {
+            // same rule as vulkan. graphics pipelines need the render pass
+            if (configuration->hasComputeShader())
+                ++m_device.statistics().pipelinesPrewarmed;
+        }
+    }
+}
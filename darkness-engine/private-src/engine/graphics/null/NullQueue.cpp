@@ -0,0 +1,112 @@
+#include "engine/graphics/null/NullQueue.h"
+#include "engine/graphics/null/NullCommandList.h"
+#include "engine/graphics/null/NullDevice.h"
+#include "engine/graphics/null/NullFence.h"
+#include "engine/graphics/null/NullSemaphore.h"
+#include "engine/graphics/null/NullSwapChain.h"
+
+#include "engine/graphics/Device.h"
+#include "engine/graphics/CommandList.h"
+#include "engine/graphics/Fence.h"
+#include "engine/graphics/Semaphore.h"
+#include "engine/graphics/SwapChain.h"
+
+namespace engine
+{
+    namespace implementation
+    {
+        QueueImplNull::QueueImplNull(Device& device, CommandListType /*type*/, const char* queueName)
+            : m_device{ *static_cast<const DeviceImplNull*>(device.native()) }
+            , m_queueName{ queueName }
+        {
+        }
+
+        void QueueImplNull::execute(CommandList& commandList)
+        {
+            auto cmd = static_cast<CommandListImplNull*>(commandList.native());
+            if (cmd->isOpen())
+            {
+                cmd->applyBarriers();
+                cmd->resolveQueries();
+                cmd->end();
+            }
+            ++m_device.statistics().commandListsSubmitted;
+            m_device.submitted(cmd->name());
+        }
+
+        void QueueImplNull::signalFence(Fence& fence)
+        {
+            auto impl = static_cast<FenceImplNull*>(fence.native());
+            impl->signal(impl->currentCPUValue());
+        }
+
+        void QueueImplNull::signalSemaphore(Semaphore& semaphore)
+        {
+            static_cast<SemaphoreImplNull*>(semaphore.native())->signal();
+        }
+
+        void QueueImplNull::submit(CommandList& commandList)
+        {
+            execute(commandList);
+        }
+
+        void QueueImplNull::submit(CommandList& commandList, Fence& fence)
+        {
+            execute(commandList);
+            signalFence(fence);
+        }
+
+        void QueueImplNull::submit(CommandList& commandList, Semaphore& semaphore)
+        {
+            execute(commandList);
+            signalSemaphore(semaphore);
+        }
+
+        void QueueImplNull::submit(CommandList& commandList, Semaphore& /*waitSemaphore*/, Semaphore& signalSemaphore)
+        {
+            execute(commandList);
+            this->signalSemaphore(signalSemaphore);
+        }
+
+        void QueueImplNull::submit(CommandList& commandList, Semaphore& /*waitSemaphore*/, Semaphore& signalSemaphore, Fence& fence)
+        {
+            execute(commandList);
+            this->signalSemaphore(signalSemaphore);
+            signalFence(fence);
+        }
+
+        void QueueImplNull::submit(CommandList& commandList, Semaphore& semaphore, Fence& fence)
+        {
+            execute(commandList);
+            signalSemaphore(semaphore);
+            signalFence(fence);
+        }
+
+        void QueueImplNull::waitForIdle() const
+        {
+        }
+
+        void QueueImplNull::signal(const Semaphore& semaphore)
+        {
+            signalSemaphore(const_cast<Semaphore&>(semaphore));
+        }
+
+        void QueueImplNull::signal(const Fence& fence, unsigned long long value)
+        {
+            static_cast<FenceImplNull*>(const_cast<Fence&>(fence).native())->signal(value);
+        }
+
+        void QueueImplNull::present(
+            Semaphore& /*signalSemaphore*/,
+            SwapChain& swapChain,
+            unsigned int /*chainIndex*/)
+        {
+            static_cast<SwapChainImplNull*>(swapChain.native())->present();
+        }
+
+        bool QueueImplNull::needRefresh() const
+        {
+            return false;
+        }
+    }
+}
@@ -0,0 +1,651 @@
+#include "engine/graphics/null/NullResources.h"
+#include "engine/graphics/null/NullDevice.h"
+#include "engine/graphics/Device.h"
+#include "engine/graphics/Common.h"
+
+#include "tools/Debug.h"
+#include "tools/ToolsCommon.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace engine
+{
+    namespace implementation
+    {
+        namespace
+        {
+            size_t mipSize(size_t size, int mip)
+            {
+                return std::max<size_t>(1u, size >> static_cast<size_t>(mip));
+            }
+
+            BufferDescription::Descriptor viewDescription(const Buffer& buffer, const BufferDescription& desc)
+            {
+                auto result = desc.descriptor;
+                if (result.elements == InvalidElementsValue)
+                    result.elements = buffer.description().elements;
+                if (result.elementSize == InvalidElementSizeValue)
+                    result.elementSize = buffer.description().elementSize;
+                if (result.format == Format::UNKNOWN)
+                    result.format = buffer.description().format;
+                return result;
+            }
+        }
+
+        BufferImplNull::BufferImplNull(
+            const DeviceImplNull& device,
+            const BufferDescription& desc)
+            : m_description(desc.descriptor)
+            , m_state{ ResourceState::Common }
+        {
+            if (m_description.elementSize == InvalidElementSizeValue)
+                m_description.elementSize = formatBytes(m_description.format);
+            ASSERT(m_description.elements != InvalidElementsValue, "Buffer needs an element count");
+
+            if (!m_description.reserved)
+                m_memory.resize(m_description.elements * m_description.elementSize, 0);
+
+            ++device.statistics().buffers;
+            device.statistics().bufferBytes += m_memory.size();
+        }
+
+        void BufferImplNull::commit(const DeviceImplNull& device, size_t bytes)
+        {
+            ASSERT(m_description.reserved, "Only reserved buffers can be committed");
+            auto virtualBytes = m_description.elements * m_description.elementSize;
+            auto committed = std::min(roundUpToMultiple(bytes, ReservedBufferPageBytes), virtualBytes);
+            if (committed <= m_memory.size())
+                return;
+
+            device.statistics().committedBytes += committed - m_memory.size();
+            device.statistics().bufferBytes += committed - m_memory.size();
+            ++device.statistics().commits;
+            m_memory.resize(committed, 0);
+        }
+
+        size_t BufferImplNull::committedBytes() const
+        {
+            return m_memory.size();
+        }
+
+        void* BufferImplNull::map(const DeviceImplIf* /*device*/)
+        {
+            return m_memory.data();
+        }
+
+        void BufferImplNull::unmap(const DeviceImplIf* /*device*/)
+        {
+        }
+
+        const BufferDescription::Descriptor& BufferImplNull::description() const
+        {
+            return m_description;
+        }
+
+        ResourceState BufferImplNull::state() const
+        {
+            return m_state;
+        }
+
+        void BufferImplNull::state(ResourceState _state)
+        {
+            m_state = _state;
+        }
+
+        BufferSRVImplNull::BufferSRVImplNull(
+            const DeviceImplNull& device,
+            const Buffer& buffer,
+            const BufferDescription& desc)
+            : m_description(viewDescription(buffer, desc))
+            , m_buffer{ buffer }
+            , m_uniqueId{ GlobalUniqueHandleId++ }
+        {
+            ++device.statistics().views;
+        }
+
+        const BufferDescription::Descriptor& BufferSRVImplNull::description() const
+        {
+            return m_description;
+        }
+
+        Buffer BufferSRVImplNull::buffer() const
+        {
+            return m_buffer;
+        }
+
+        BufferUAVImplNull::BufferUAVImplNull(
+            const DeviceImplNull& device,
+            const Buffer& buffer,
+            const BufferDescription& desc)
+            : m_description(viewDescription(buffer, desc))
+            , m_buffer{ buffer }
+            , m_uniqueId{ GlobalUniqueHandleId++ }
+            , m_counter{ 0 }
+        {
+            ++device.statistics().views;
+        }
+
+        const BufferDescription::Descriptor& BufferUAVImplNull::description() const
+        {
+            return m_description;
+        }
+
+        Buffer BufferUAVImplNull::buffer() const
+        {
+            return m_buffer;
+        }
+
+        BufferIBVImplNull::BufferIBVImplNull(
+            const DeviceImplNull& device,
+            const Buffer& buffer,
+            const BufferDescription& desc)
+            : m_description(viewDescription(buffer, desc))
+            , m_buffer{ buffer }
+            , m_uniqueId{ GlobalUniqueHandleId++ }
+        {
+            ++device.statistics().views;
+        }
+
+        const BufferDescription::Descriptor& BufferIBVImplNull::description() const
+        {
+            return m_description;
+        }
+
+        Buffer BufferIBVImplNull::buffer() const
+        {
+            return m_buffer;
+        }
+
+        BufferCBVImplNull::BufferCBVImplNull(
+            const DeviceImplNull& device,
+            const Buffer& buffer,
+            const BufferDescription& desc)
+            : m_description(viewDescription(buffer, desc))
+            , m_buffer{ buffer }
+            , m_uniqueId{ GlobalUniqueHandleId++ }
+        {
+            ++device.statistics().views;
+        }
+
+        const BufferDescription::Descriptor& BufferCBVImplNull::description() const
+        {
+            return m_description;
+        }
+
+        Buffer BufferCBVImplNull::buffer() const
+        {
+            return m_buffer;
+        }
+
+        BufferVBVImplNull::BufferVBVImplNull(
+            const DeviceImplNull& device,
+            const Buffer& buffer,
+            const BufferDescription& desc)
+            : m_description(viewDescription(buffer, desc))
+            , m_buffer{ buffer }
+            , m_uniqueId{ GlobalUniqueHandleId++ }
+        {
+            ++device.statistics().views;
+        }
+
+        const BufferDescription::Descriptor& BufferVBVImplNull::description() const
+        {
+            return m_description;
+        }
+
+        Buffer BufferVBVImplNull::buffer() const
+        {
+            return m_buffer;
+        }
+
+        BindlessBufferSRVImplNull::BindlessBufferSRVImplNull(const DeviceImplNull& /*device*/)
+            : m_resourceId{ GlobalUniqueHandleId++ }
+            , m_change{ true }
+        {}
+
+        uint32_t BindlessBufferSRVImplNull::push(BufferSRVOwner buffer)
+        {
+            auto res = m_buffers.size();
+            m_buffers.emplace_back(buffer);
+            m_resourceId = GlobalUniqueHandleId++;
+            m_change = true;
+            return static_cast<uint32_t>(res);
+        }
+
+        size_t BindlessBufferSRVImplNull::size() const
+        {
+            return m_buffers.size();
+        }
+
+        BufferSRV BindlessBufferSRVImplNull::get(size_t index)
+        {
+            return m_buffers[index];
+        }
+
+        uint64_t BindlessBufferSRVImplNull::resourceId() const
+        {
+            return m_resourceId;
+        }
+
+        void BindlessBufferSRVImplNull::updateDescriptors(DeviceImplIf* device)
+        {
+            static_cast<DeviceImplNull*>(device)->statistics().descriptorBinds += m_buffers.size();
+        }
+
+        bool BindlessBufferSRVImplNull::change() const
+        {
+            return m_change;
+        }
+
+        void BindlessBufferSRVImplNull::change(bool value)
+        {
+            m_change = value;
+        }
+
+        BindlessBufferUAVImplNull::BindlessBufferUAVImplNull(const DeviceImplNull& /*device*/)
+            : m_resourceId{ GlobalUniqueHandleId++ }
+            , m_change{ true }
+        {}
+
+        uint32_t BindlessBufferUAVImplNull::push(BufferUAVOwner buffer)
+        {
+            auto res = m_buffers.size();
+            m_buffers.emplace_back(buffer);
+            m_resourceId = GlobalUniqueHandleId++;
+            m_change = true;
+            return static_cast<uint32_t>(res);
+        }
+
+        size_t BindlessBufferUAVImplNull::size() const
+        {
+            return m_buffers.size();
+        }
+
+        BufferUAV BindlessBufferUAVImplNull::get(size_t index)
+        {
+            return m_buffers[index];
+        }
+
+        uint64_t BindlessBufferUAVImplNull::resourceId() const
+        {
+            return m_resourceId;
+        }
+
+        void BindlessBufferUAVImplNull::updateDescriptors(DeviceImplIf* device)
+        {
+            static_cast<DeviceImplNull*>(device)->statistics().descriptorBinds += m_buffers.size();
+        }
+
+        bool BindlessBufferUAVImplNull::change() const
+        {
+            return m_change;
+        }
+
+        void BindlessBufferUAVImplNull::change(bool value)
+        {
+            m_change = value;
+        }
+
+        RaytracingAccelerationStructureImplNull::RaytracingAccelerationStructureImplNull(
+            const Device& /*device*/,
+            BufferSRV /*vertexBuffer*/,
+            BufferIBV /*indexBuffer*/,
+            const BufferDescription& desc)
+            : m_description(desc.descriptor)
+            , m_state{ ResourceState::Common }
+            , m_resourceId{ GlobalUniqueHandleId++ }
+        {}
+
+        const BufferDescription::Descriptor& RaytracingAccelerationStructureImplNull::description() const
+        {
+            return m_description;
+        }
+
+        ResourceState RaytracingAccelerationStructureImplNull::state() const
+        {
+            return m_state;
+        }
+
+        void RaytracingAccelerationStructureImplNull::state(ResourceState _state)
+        {
+            m_state = _state;
+        }
+
+        uint64_t RaytracingAccelerationStructureImplNull::resourceId() const
+        {
+            return m_resourceId;
+        }
+
+        TextureImplNull::TextureImplNull(
+            const DeviceImplNull& device,
+            const TextureDescription& desc)
+            : m_description(desc.descriptor)
+            , m_state{ desc.descriptor.arraySlices, desc.descriptor.mipLevels, ResourceState::Common }
+        {
+            size_t bytes = 0;
+            for (int slice = 0; slice < static_cast<int>(m_description.arraySlices); ++slice)
+            {
+                for (int mip = 0; mip < static_cast<int>(m_description.mipLevels); ++mip)
+                {
+                    m_offsets.emplace_back(bytes);
+                    bytes += sizeBytes(mip);
+                }
+            }
+            m_memory.resize(bytes, 0);
+
+            ++device.statistics().textures;
+            device.statistics().textureBytes += bytes;
+        }
+
+        void* TextureImplNull::map(const DeviceImplIf* /*device*/)
+        {
+            return m_memory.data();
+        }
+
+        void TextureImplNull::unmap(const DeviceImplIf* /*device*/)
+        {
+        }
+
+        const TextureDescription::Descriptor& TextureImplNull::description() const
+        {
+            return m_description;
+        }
+
+        ResourceState TextureImplNull::state(int slice, int mip) const
+        {
+            return m_state.state(slice, mip);
+        }
+
+        void TextureImplNull::state(int slice, int mip, ResourceState state)
+        {
+            m_state.state(slice, mip, state);
+        }
+
+        void TextureImplNull::state(ResourceState state)
+        {
+            m_state.state(state);
+        }
+
+        bool TextureImplNull::uniformState(ResourceState& state) const
+        {
+            if (!m_state.uniform())
+                return false;
+            state = m_state.uniformState();
+            return true;
+        }
+
+        uint8_t* TextureImplNull::data(int slice, int mip)
+        {
+            return m_memory.data() + m_offsets[mip + (slice * m_description.mipLevels)];
+        }
+
+        size_t TextureImplNull::sizeBytes(int mip) const
+        {
+            return formatBytes(
+                m_description.format,
+                mipSize(m_description.width, mip),
+                mipSize(m_description.height, mip)) * mipSize(m_description.depth, mip);
+        }
+
+        TextureSRVImplNull::TextureSRVImplNull(
+            const DeviceImplNull& device,
+            const Texture& texture,
+            const TextureDescription& desc,
+            SubResource subResources)
+            : m_description(desc.descriptor)
+            , m_texture{ texture }
+            , m_subResources{ subResources }
+            , m_uniqueId{ GlobalUniqueHandleId++ }
+        {
+            ++device.statistics().views;
+        }
+
+        const TextureDescription::Descriptor& TextureSRVImplNull::description() const
+        {
+            return m_description;
+        }
+
+        Texture TextureSRVImplNull::texture() const
+        {
+            return m_texture;
+        }
+
+        Format TextureSRVImplNull::format() const
+        {
+            return m_description.format;
+        }
+
+        size_t TextureSRVImplNull::width() const
+        {
+            return m_description.width;
+        }
+
+        size_t TextureSRVImplNull::height() const
+        {
+            return m_description.height;
+        }
+
+        size_t TextureSRVImplNull::depth() const
+        {
+            return m_description.depth;
+        }
+
+        ResourceDimension TextureSRVImplNull::dimension() const
+        {
+            return m_description.dimension;
+        }
+
+        TextureUAVImplNull::TextureUAVImplNull(
+            const DeviceImplNull& device,
+            const Texture& texture,
+            const TextureDescription& desc,
+            SubResource subResources)
+            : m_description(desc.descriptor)
+            , m_texture{ texture }
+            , m_subResources{ subResources }
+            , m_uniqueId{ GlobalUniqueHandleId++ }
+        {
+            ++device.statistics().views;
+        }
+
+        const TextureDescription::Descriptor& TextureUAVImplNull::description() const
+        {
+            return m_description;
+        }
+
+        Texture TextureUAVImplNull::texture() const
+        {
+            return m_texture;
+        }
+
+        Format TextureUAVImplNull::format() const
+        {
+            return m_description.format;
+        }
+
+        size_t TextureUAVImplNull::width() const
+        {
+            return m_description.width;
+        }
+
+        size_t TextureUAVImplNull::height() const
+        {
+            return m_description.height;
+        }
+
+        size_t TextureUAVImplNull::depth() const
+        {
+            return m_description.depth;
+        }
+
+        ResourceDimension TextureUAVImplNull::dimension() const
+        {
+            return m_description.dimension;
+        }
+
+        TextureDSVImplNull::TextureDSVImplNull(
+            const DeviceImplNull& device,
+            const Texture& texture,
+            const TextureDescription& desc,
+            SubResource subResources)
+            : m_description(desc.descriptor)
+            , m_texture{ texture }
+            , m_subResources{ subResources }
+            , m_uniqueId{ GlobalUniqueHandleId++ }
+        {
+            ++device.statistics().views;
+        }
+
+        const TextureDescription::Descriptor& TextureDSVImplNull::description() const
+        {
+            return m_description;
+        }
+
+        Texture TextureDSVImplNull::texture() const
+        {
+            return m_texture;
+        }
+
+        Format TextureDSVImplNull::format() const
+        {
+            return m_description.format;
+        }
+
+        size_t TextureDSVImplNull::width() const
+        {
+            return m_description.width;
+        }
+
+        size_t TextureDSVImplNull::height() const
+        {
+            return m_description.height;
+        }
+
+        TextureRTVImplNull::TextureRTVImplNull(
+            const DeviceImplNull& device,
+            const Texture& texture,
+            const TextureDescription& desc,
+            SubResource subResources)
+            : m_description(desc.descriptor)
+            , m_texture{ texture }
+            , m_subResources{ subResources }
+            , m_uniqueId{ GlobalUniqueHandleId++ }
+        {
+            ++device.statistics().views;
+        }
+
+        const TextureDescription::Descriptor& TextureRTVImplNull::description() const
+        {
+            return m_description;
+        }
+
+        Texture TextureRTVImplNull::texture() const
+        {
+            return m_texture;
+        }
+
+        Format TextureRTVImplNull::format() const
+        {
+            return m_description.format;
+        }
+
+        size_t TextureRTVImplNull::width() const
+        {
+            return m_description.width;
+        }
+
+        size_t TextureRTVImplNull::height() const
+        {
+            return m_description.height;
+        }
+
+        BindlessTextureSRVImplNull::BindlessTextureSRVImplNull(const DeviceImplNull& /*device*/)
+            : m_resourceId{ GlobalUniqueHandleId++ }
+            , m_change{ true }
+        {}
+
+        uint32_t BindlessTextureSRVImplNull::push(TextureSRVOwner texture)
+        {
+            auto res = m_textures.size();
+            m_textures.emplace_back(texture);
+            m_resourceId = GlobalUniqueHandleId++;
+            m_change = true;
+            return static_cast<uint32_t>(res);
+        }
+
+        size_t BindlessTextureSRVImplNull::size() const
+        {
+            return m_textures.size();
+        }
+
+        TextureSRV BindlessTextureSRVImplNull::get(size_t index)
+        {
+            return m_textures[index];
+        }
+
+        uint64_t BindlessTextureSRVImplNull::resourceId() const
+        {
+            return m_resourceId;
+        }
+
+        void BindlessTextureSRVImplNull::updateDescriptors(DeviceImplIf* device)
+        {
+            static_cast<DeviceImplNull*>(device)->statistics().descriptorBinds += m_textures.size();
+        }
+
+        bool BindlessTextureSRVImplNull::change() const
+        {
+            return m_change;
+        }
+
+        void BindlessTextureSRVImplNull::change(bool value)
+        {
+            m_change = value;
+        }
+
+        BindlessTextureUAVImplNull::BindlessTextureUAVImplNull(const DeviceImplNull& /*device*/)
+            : m_resourceId{ GlobalUniqueHandleId++ }
+            , m_change{ true }
+        {}
+
+        uint32_t BindlessTextureUAVImplNull::push(TextureUAVOwner texture)
+        {
+            auto res = m_textures.size();
+            m_textures.emplace_back(texture);
+            m_resourceId = GlobalUniqueHandleId++;
+            m_change = true;
+            return static_cast<uint32_t>(res);
+        }
+
+        size_t BindlessTextureUAVImplNull::size() const
+        {
+            return m_textures.size();
+        }
+
+        TextureUAV BindlessTextureUAVImplNull::get(size_t index)
+        {
+            return m_textures[index];
+        }
+
+        uint64_t BindlessTextureUAVImplNull::resourceId() const
+        {
+            return m_resourceId;
+        }
+
+        void BindlessTextureUAVImplNull::updateDescriptors(DeviceImplIf* device)
+        {
+            static_cast<DeviceImplNull*>(device)->statistics().descriptorBinds += m_textures.size();
+        }
+
+        bool BindlessTextureUAVImplNull::change() const
+        {
+            return m_change;
+        }
+
+        void BindlessTextureUAVImplNull::change(bool value)
+        {
+            m_change = value;
+        }
+    }
+}
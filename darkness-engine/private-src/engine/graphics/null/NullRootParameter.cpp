@@ -0,0 +1,80 @@
+#include "engine/graphics/null/NullRootParameter.h"
+
+namespace engine
+{
+    namespace implementation
+    {
+        RootParameterImplNull::RootParameterImplNull()
+            : m_binding{ 0 }
+            , m_visibility{ 0 }
+            , m_descriptorCount{ 0 }
+        {
+        }
+
+        void RootParameterImplNull::binding(unsigned int index)
+        {
+            m_binding = index;
+        }
+
+        unsigned int RootParameterImplNull::binding() const
+        {
+            return m_binding;
+        }
+
+        void RootParameterImplNull::visibility(ShaderVisibility visibility)
+        {
+            m_visibility = visibility;
+        }
+
+        ShaderVisibility RootParameterImplNull::visibility() const
+        {
+            return m_visibility;
+        }
+
+        void RootParameterImplNull::initAsConstants(unsigned int reg, unsigned int /*num32BitValues*/, ShaderVisibility visibility)
+        {
+            m_binding = reg;
+            m_visibility = visibility;
+            m_descriptorCount = 1;
+        }
+
+        void RootParameterImplNull::initAsCBV(unsigned int reg, ShaderVisibility visibility)
+        {
+            m_binding = reg;
+            m_visibility = visibility;
+            m_descriptorCount = 1;
+        }
+
+        void RootParameterImplNull::initAsSRV(unsigned int reg, ShaderVisibility visibility)
+        {
+            m_binding = reg;
+            m_visibility = visibility;
+            m_descriptorCount = 1;
+        }
+
+        void RootParameterImplNull::initAsUAV(unsigned int reg, ShaderVisibility visibility)
+        {
+            m_binding = reg;
+            m_visibility = visibility;
+            m_descriptorCount = 1;
+        }
+
+        void RootParameterImplNull::initAsDescriptorRange(DescriptorRangeType /*type*/, unsigned int reg, unsigned int count, ShaderVisibility visibility)
+        {
+            m_binding = reg;
+            m_visibility = visibility;
+            m_descriptorCount = count;
+        }
+
+        void RootParameterImplNull::initAsDescriptorTable(unsigned int /*rangeCount*/, ShaderVisibility visibility)
+        {
+            m_visibility = visibility;
+            m_descriptorCount = 0;
+        }
+
+        void RootParameterImplNull::setTableRange(unsigned int /*rangeIndex*/, DescriptorRangeType /*type*/, unsigned int /*reg*/, unsigned int count, unsigned int /*space*/)
+        {
+            m_descriptorCount += count;
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#include "engine/graphics/null/NullRootSignature.h"
+
+#include "tools/Debug.h"
+
+namespace engine
+{
+    namespace implementation
+    {
+        RootSignatureImplNull::RootSignatureImplNull(const Device& /*device*/, int rootParameterCount, int staticSamplerCount)
+            : m_parameters{}
+            , m_samplers{}
+            , m_finalized{ false }
+        {
+            reset(rootParameterCount, staticSamplerCount);
+        }
+
+        void RootSignatureImplNull::reset(int rootParameterCount, int staticSamplerCount)
+        {
+            m_parameters.clear();
+            for (int i = 0; i < rootParameterCount; ++i)
+                m_parameters.emplace_back(RootParameter(GraphicsApi::Null));
+
+            m_samplers.clear();
+            m_samplers.reserve(static_cast<size_t>(staticSamplerCount));
+            m_finalized = false;
+        }
+
+        void RootSignatureImplNull::initStaticSampler(int /*samplerNum*/, const SamplerDescription& description, ShaderVisibility /*visibility*/)
+        {
+            ASSERT(m_samplers.size() < m_samplers.capacity(), "Too many static samplers");
+            m_samplers.emplace_back(description);
+        }
+
+        void RootSignatureImplNull::finalize(RootSignatureFlags /*flags*/)
+        {
+            m_finalized = true;
+        }
+
+        void RootSignatureImplNull::enableNullDescriptors(bool /*texture*/, bool /*writeable*/)
+        {
+        }
+
+        size_t RootSignatureImplNull::rootParameterCount() const
+        {
+            return m_parameters.size();
+        }
+
+        RootParameter& RootSignatureImplNull::operator[](size_t index)
+        {
+            return m_parameters[index];
+        }
+
+        const RootParameter& RootSignatureImplNull::operator[](size_t index) const
+        {
+            return m_parameters[index];
+        }
+    }
+}
@@ -0,0 +1,20 @@
+#include "engine/graphics/null/NullSampler.h"
+#include "engine/graphics/null/NullDevice.h"
+
+#include "engine/graphics/Device.h"
+#include "engine/graphics/Common.h"
+
+namespace engine
+{
+    namespace implementation
+    {
+        SamplerImplNull::SamplerImplNull(
+            const Device& device,
+            const SamplerDescription& desc)
+            : m_description{ desc }
+            , m_uniqueId{ GlobalUniqueHandleId++ }
+        {
+            ++static_cast<const DeviceImplNull*>(device.native())->statistics().views;
+        }
+    }
+}
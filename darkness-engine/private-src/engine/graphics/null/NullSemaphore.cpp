@@ -0,0 +1,29 @@
+#include "engine/graphics/null/NullSemaphore.h"
+
+#include "engine/graphics/Device.h"
+
+namespace engine
+{
+    namespace implementation
+    {
+        SemaphoreImplNull::SemaphoreImplNull(const Device& /*device*/)
+            : m_signaled{ false }
+        {
+        }
+
+        void SemaphoreImplNull::reset()
+        {
+            m_signaled = false;
+        }
+
+        bool SemaphoreImplNull::signaled() const
+        {
+            return m_signaled;
+        }
+
+        void SemaphoreImplNull::signal()
+        {
+            m_signaled = true;
+        }
+    }
+}
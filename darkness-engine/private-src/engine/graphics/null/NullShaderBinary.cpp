@@ -0,0 +1,32 @@
+#include "engine/graphics/null/NullShaderBinary.h"
+
+namespace engine
+{
+    namespace implementation
+    {
+        ShaderBinaryImplNull::ShaderBinaryImplNull(
+            const Device& /*device*/,
+            const engine::string& binaryPath,
+            const engine::string& /*supportPath*/,
+            int permutationId,
+            const engine::vector<engine::string>& defines,
+            platform::FileWatcher& /*watcher*/)
+            : m_binaryPath{ binaryPath }
+            , m_permutationId{ permutationId }
+            , m_defines{ defines }
+        {
+        }
+
+        void ShaderBinaryImplNull::registerForChange(void* client, std::function<void(void)> change) const
+        {
+            m_change[client] = change;
+        }
+
+        void ShaderBinaryImplNull::unregisterForChange(void* client) const
+        {
+            auto found = m_change.find(client);
+            if (found != m_change.end())
+                m_change.erase(found);
+        }
+    }
+}
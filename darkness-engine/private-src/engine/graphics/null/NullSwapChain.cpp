@@ -0,0 +1,116 @@
+#include "engine/graphics/null/NullSwapChain.h"
+#include "engine/graphics/null/NullDevice.h"
+#include "engine/graphics/null/NullResources.h"
+
+#include "engine/graphics/Device.h"
+#include "engine/graphics/Queue.h"
+#include "engine/graphics/Resources.h"
+
+namespace engine
+{
+    namespace implementation
+    {
+        SwapChainImplNull::SwapChainImplNull(
+            const Device& device,
+            Queue& /*queue*/,
+            bool /*fullscreen*/,
+            bool vsync,
+            SwapChain* /*oldSwapChain*/)
+            : m_device{ device }
+            , m_backBufferReadySemaphore{ device.createSemaphore() }
+            , m_size{
+                static_cast<uint32_t>(device.native()->width()),
+                static_cast<uint32_t>(device.native()->height()) }
+            , m_backBufferIndex{ 0u }
+            , m_vsync{ vsync }
+        {
+            createSwapChainTextures(device);
+        }
+
+        void SwapChainImplNull::createSwapChainTextures(const Device& device)
+        {
+            TextureDescription chainImageDesc;
+            chainImageDesc.descriptor.append = false;
+            chainImageDesc.descriptor.arraySlices = 1;
+            chainImageDesc.descriptor.depth = 1;
+            chainImageDesc.descriptor.dimension = ResourceDimension::Texture2D;
+            chainImageDesc.descriptor.format = Format::R8G8B8A8_UNORM;
+            chainImageDesc.descriptor.height = m_size.height;
+            chainImageDesc.descriptor.width = m_size.width;
+            chainImageDesc.descriptor.mipLevels = 1;
+            chainImageDesc.descriptor.name = "SwapChainImage";
+            chainImageDesc.descriptor.samples = 1;
+            chainImageDesc.descriptor.usage = ResourceUsage::GpuRenderTargetReadWrite;
+
+            for (int i = 0; i < NullBackBufferCount; ++i)
+            {
+                auto texture = engine::make_shared<TextureImplNull>(
+                    *static_cast<const DeviceImplNull*>(device.native()),
+                    chainImageDesc);
+                texture->state(0, 0, ResourceState::Present);
+
+                m_swapChainTextures.emplace_back(TextureOwner(
+                    static_pointer_cast<TextureImplIf>(texture),
+                    [](engine::shared_ptr<TextureImplIf>) {}));
+            }
+
+            for (auto&& tex : m_swapChainTextures)
+            {
+                m_swapChainTextureRTVs.emplace_back(device.createTextureRTV(tex));
+                m_swapChainTextureSRVs.emplace_back(device.createTextureSRV(tex));
+            }
+        }
+
+        Semaphore& SwapChainImplNull::backBufferReadySemaphore()
+        {
+            return m_backBufferReadySemaphore;
+        }
+
+        TextureRTV SwapChainImplNull::renderTarget(int index)
+        {
+            return m_swapChainTextureRTVs[index].resource();
+        }
+
+        TextureSRV SwapChainImplNull::renderTargetSRV(int index)
+        {
+            return m_swapChainTextureSRVs[index].resource();
+        }
+
+        TextureRTVOwner& SwapChainImplNull::renderTargetOwner(int index)
+        {
+            return m_swapChainTextureRTVs[index];
+        }
+
+        unsigned int SwapChainImplNull::currentBackBufferIndex() const
+        {
+            return m_backBufferIndex;
+        }
+
+        void SwapChainImplNull::present()
+        {
+            m_backBufferIndex = (m_backBufferIndex + 1) % NullBackBufferCount;
+            ++static_cast<const DeviceImplNull*>(m_device.native())->statistics().presents;
+        }
+
+        bool SwapChainImplNull::needRefresh()
+        {
+            return false;
+        }
+
+        Size SwapChainImplNull::size() const
+        {
+            return m_size;
+        }
+
+        void SwapChainImplNull::resize(Device& device, Size size)
+        {
+            m_swapChainTextureRTVs.clear();
+            m_swapChainTextureSRVs.clear();
+            m_swapChainTextures.clear();
+
+            m_size = size;
+            m_backBufferIndex = 0u;
+            createSwapChainTextures(device);
+        }
+    }
+}
@@ -703,50 +703,24 @@ namespace engine
 
             auto localSubRes = subResource;
 
-            if ((localSubRes.arraySliceCount == AllArraySlices) &&
-                (localSubRes.mipCount == AllMipLevels))
+            // a whole resource transition is a single barrier when every subresource
+            // is in the same state. otherwise go through the subresources one by one
+            ResourceState currentState = state;
+            bool wholeResource =
+                (localSubRes.arraySliceCount == AllArraySlices) &&
+                (localSubRes.mipCount == AllMipLevels);
+            if (wholeResource && !impl->uniformState(currentState))
             {
-                bool forceIndividual = false;
-                auto firstState = impl->state(0, 0);
-                for (int slice = 0; slice < static_cast<int>(resource.arraySlices()); ++slice)
-                {
-                    for (int mip = 0; mip < static_cast<int>(resource.mipLevels()); ++mip)
-                    {
-                        if (firstState != impl->state(slice, mip))
-                        {
-                            forceIndividual = true;
-                            break;
-                        }
-                    }
-                    if (forceIndividual)
-                        break;
-                }
-
-                if (forceIndividual)
-                {
-                    localSubRes.firstArraySlice = 0;
-                    localSubRes.firstMipLevel = 0;
-                    localSubRes.arraySliceCount = static_cast<int32_t>(resource.arraySlices());
-                    localSubRes.mipCount = static_cast<int32_t>(resource.mipLevels());
-                }
+                wholeResource = false;
+                localSubRes.firstArraySlice = 0;
+                localSubRes.firstMipLevel = 0;
+                localSubRes.arraySliceCount = static_cast<int32_t>(resource.arraySlices());
+                localSubRes.mipCount = static_cast<int32_t>(resource.mipLevels());
             }
 
-            if ((localSubRes.arraySliceCount == AllArraySlices) &&
-                (localSubRes.mipCount == AllMipLevels))
+            if (wholeResource)
             {
-                ResourceState anystate = state;
-                for (int slice = 0; slice < static_cast<int>(resource.arraySlices()); ++slice)
-                {
-                    for (int mip = 0; mip < static_cast<int>(resource.mipLevels()); ++mip)
-                    {
-                        if (impl->state(slice, mip) != anystate)
-                        {
-                            anystate = impl->state(slice, mip);
-                            break;
-                        }
-                    }
-                }
-                if (anystate != state)
+                if (currentState != state)
                 {
                     uint32_t sliceCount = localSubRes.arraySliceCount == AllArraySlices ?
                         static_cast<uint32_t>(resource.arraySlices()) :
@@ -761,12 +735,12 @@ namespace engine
 
                     VkImageMemoryBarrier barrier = {};
                     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-                    barrier.oldLayout = vulkanResourceStates(anystate);
+                    barrier.oldLayout = vulkanResourceStates(currentState);
                     barrier.newLayout = vulkanResourceStates(state);
                     barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
                     barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
                     barrier.image = static_cast<TextureImplVulkan*>(resource.m_impl)->native();
-                    barrier.srcAccessMask = vulkanAccessFlags(anystate);
+                    barrier.srcAccessMask = vulkanAccessFlags(currentState);
                     barrier.dstAccessMask = vulkanAccessFlags(state);
                     barrier.subresourceRange.aspectMask = vulkanFormatAspects(resource.format());
                     barrier.subresourceRange.baseMipLevel = 0;
@@ -778,16 +752,10 @@ namespace engine
                         barrier.image,
                         resource.description().descriptor.name,
                         sliceCount - 1, mipCount - 1,
-                        imageLayoutToString(vulkanResourceStates(anystate)).c_str(),
+                        imageLayoutToString(vulkanResourceStates(currentState)).c_str(),
                         imageLayoutToString(vulkanResourceStates(state)).c_str());*/
 
-                    for (int slice = 0; slice < static_cast<int>(resource.arraySlices()); ++slice)
-                    {
-                        for (int mip = 0; mip < static_cast<int>(resource.mipLevels()); ++mip)
-                        {
-                            impl->state(slice, mip, state);
-                        }
-                    }
+                    impl->state(state);
                 }
             }
             else
@@ -963,6 +931,9 @@ namespace engine
                 //LOG("BARRIER APPLY END");
 
                 m_lastAppliedImageBarrierIndex = m_imageBarriers.size();
+
+                m_device->transitionCounters().barriers += static_cast<uint32_t>(barriers.size());
+                ++m_device->transitionCounters().flushes;
             }
 
             auto bufferBarrierCount = m_bufferBarriers.size() - m_lastAppliedBufferBarrierIndex;
@@ -979,6 +950,9 @@ namespace engine
                 );
 
                 m_lastAppliedBufferBarrierIndex = m_bufferBarriers.size();
+
+                m_device->transitionCounters().barriers += static_cast<uint32_t>(bufferBarrierCount);
+                ++m_device->transitionCounters().flushes;
             }
         }
 
@@ -13,6 +13,7 @@
 #include "engine/graphics/Fence.h"
 #include "engine/graphics/Queue.h"
 #include "engine/graphics/GpuMarkerStorage.h"
+#include "engine/graphics/ShaderLocator.h"
 
 #include "platform/Platform.h"
 #ifdef _WIN32
@@ -98,6 +99,7 @@ namespace engine
             }
             , m_descriptorHeap{ nullptr }
             , m_currentFenceValue{ 0 }
+            , m_pipelineCache{ nullptr }
         {
             createSurface();
 
@@ -120,6 +122,11 @@ namespace engine
 
             createLogicalDevice();
 
+            m_pipelineCache = engine::make_unique<PipelineCacheVulkan>(
+                m_physicalDevice,
+                *m_device,
+                pathJoin(ShaderLocator::instance().getCoreShaderPath(GraphicsApi::Vulkan), "pipelines.vkcache"));
+
             m_allocator = engine::make_shared<CommandAllocatorImplVulkan>(*this, CommandListType::Direct);
 
             m_descriptorHeap = engine::make_unique<DescriptorHeapImplVulkan>(*this);
@@ -230,6 +237,35 @@ namespace engine
             }
         }
 
+        tools::RingBuffer::AllocStruct DeviceImplVulkan::allocateUpload(size_t bytes, size_t alignment)
+        {
+            ASSERT(bytes <= UploadBufferSizeBytes, "Upload does not fit the upload buffer");
+
+            // same as DX12. command lists can be recorded from several threads
+            // so a flush and the allocation after it happen under one lock
+            std::lock_guard<std::mutex> uploadLock(m_uploadMutex);
+            while (true)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    auto uploadData = m_uploadAllocator.allocate(bytes, alignment);
+                    if (uploadData.ptr)
+                    {
+                        m_uploadAllocations.emplace_back(UploadAllocation{ uploadData, m_currentFenceValue });
+                        return uploadData;
+                    }
+                }
+
+                m_uploadFence->increaseCPUValue();
+                m_deviceQueue->signal(*m_uploadFence, m_uploadFence->currentCPUValue());
+                m_uploadFence->blockUntilSignaled();
+                processUploads(0, true);
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_uploadAllocator.reset();
+            }
+        }
+
         void DeviceImplVulkan::setCurrentFenceValue(CommandListType type, engine::FenceValue value)
         {
             if (type == CommandListType::Direct)
@@ -240,23 +276,7 @@ namespace engine
 
         void DeviceImplVulkan::uploadRawBuffer(CommandListImplIf* commandList, Buffer buffer, const ByteRange& data, size_t startBytes)
         {
-            //auto uploadData = m_uploadAllocator.allocate(data.sizeBytes(), 4);
-            auto uploadData = m_uploadAllocator.allocate(data.sizeBytes(), 4);
-
-            if (!uploadData.ptr)
-            {
-                m_uploadFence->increaseCPUValue();
-                m_deviceQueue->signal(*m_uploadFence, m_uploadFence->currentCPUValue());
-                m_uploadFence->blockUntilSignaled();
-
-                processUploads(0, true);
-                m_uploadAllocator.reset();
-                uploadData = m_uploadAllocator.allocate(data.sizeBytes(), 4);
-                if (!uploadData.ptr)
-                {
-                    ASSERT(false, "Ran out of memory");
-                }
-            }
+            auto uploadData = allocateUpload(data.sizeBytes(), 4);
 
             memcpy(uploadData.ptr, reinterpret_cast<uint8_t*>(data.start), data.sizeBytes());
             commandList->transition(buffer, ResourceState::CopyDest);
@@ -325,23 +345,7 @@ namespace engine
 
         void DeviceImplVulkan::uploadBuffer(CommandListImplVulkan& commandList, Buffer buffer, const tools::ByteRange& data, size_t startElement)
         {
-            //auto uploadData = m_uploadAllocator.allocate(data.sizeBytes(), 4);
-            auto uploadData = m_uploadAllocator.allocate(data.sizeBytes(), 4);
-
-            if (!uploadData.ptr)
-            {
-                m_uploadFence->increaseCPUValue();
-                m_deviceQueue->signal(*m_uploadFence, m_uploadFence->currentCPUValue());
-                m_uploadFence->blockUntilSignaled();
-
-                processUploads(0, true);
-                m_uploadAllocator.reset();
-                uploadData = m_uploadAllocator.allocate(data.sizeBytes(), 4);
-                if (!uploadData.ptr)
-                {
-                    ASSERT(false, "Ran out of memory");
-                }
-            }
+            auto uploadData = allocateUpload(data.sizeBytes(), 4);
 
             memcpy(uploadData.ptr, reinterpret_cast<uint8_t*>(data.start), data.sizeBytes());
             commandList.transition(buffer, ResourceState::CopyDest);
@@ -391,27 +395,7 @@ namespace engine
                     for (size_t mip = 0; mip < desc.descriptor.mipLevels; ++mip)
                     {
                         auto info = surfaceInformation(desc.descriptor.format, width, height);
-						//auto uploadData = m_uploadAllocator.allocate(info.numBytes, formatBytes(desc.descriptor.format));
-                        auto uploadData = m_uploadAllocator.allocate(info.numBytes, formatBytes(desc.descriptor.format));
-
-                        if (!uploadData.ptr)
-                        {
-                            m_uploadFence->increaseCPUValue();
-                            m_deviceQueue->signal(*m_uploadFence, m_uploadFence->currentCPUValue());
-                            m_uploadFence->blockUntilSignaled();
-
-                            processUploads(0, true);
-                            m_uploadAllocator.reset();
-                            uploadData = m_uploadAllocator.allocate(info.numBytes, formatBytes(desc.descriptor.format));
-                            if (!uploadData.ptr)
-                            {
-                                ASSERT(false, "Ran out of memory");
-                            }
-                        }
-                        {
-                            std::lock_guard<std::mutex> lock(m_mutex);
-                            m_uploadAllocations.emplace_back(UploadAllocation{ uploadData, m_currentFenceValue });
-                        }
+						auto uploadData = allocateUpload(info.numBytes, formatBytes(desc.descriptor.format));
 
 						// memcpy the buffer data to upload buffer
 						const uint8_t* srcData = &descmod.initialData.data[dataIndex];
@@ -788,6 +772,11 @@ namespace engine
             return *m_descriptorHeap;
         }
 
+        PipelineCacheVulkan& DeviceImplVulkan::pipelineCache()
+        {
+            return *m_pipelineCache;
+        }
+
         engine::unique_ptr<GpuMarkerContainer> DeviceImplVulkan::getMarkerContainer()
         {
             return {};
@@ -813,6 +802,17 @@ namespace engine
             return result;
         }
 
+        bool DeviceImplVulkan::reservedBuffersSupported() const
+        {
+            // sparse binding is not enabled on the queues
+            return false;
+        }
+
+        void DeviceImplVulkan::commitBuffer(Buffer /*buffer*/, size_t /*bytes*/)
+        {
+            ASSERT(false, "DeviceImplVulkan::commitBuffer not implemented");
+        }
+
         CpuTexture DeviceImplVulkan::grabTexture(Device& device, TextureSRV texture)
         {
             auto elementSize = engine::formatBytes(texture.format());
@@ -970,27 +970,7 @@ namespace engine
 
 
             auto info = surfaceInformation(desc.descriptor.format, width, height);
-            //auto uploadData = m_uploadAllocator.allocate(info.numBytes, formatBytes(desc.descriptor.format));
-            auto uploadData = m_uploadAllocator.allocate(info.numBytes, formatBytes(desc.descriptor.format));
-
-            if (!uploadData.ptr)
-            {
-                m_uploadFence->increaseCPUValue();
-                m_deviceQueue->signal(*m_uploadFence, m_uploadFence->currentCPUValue());
-                m_uploadFence->blockUntilSignaled();
-
-                processUploads(0, true);
-                m_uploadAllocator.reset();
-                uploadData = m_uploadAllocator.allocate(info.numBytes, formatBytes(desc.descriptor.format));
-                if (!uploadData.ptr)
-                {
-                    ASSERT(false, "Ran out of memory");
-                }
-            }
-            {
-                std::lock_guard<std::mutex> lock(m_mutex);
-                m_uploadAllocations.emplace_back(UploadAllocation{ uploadData, m_currentFenceValue });
-            }
+            auto uploadData = allocateUpload(info.numBytes, formatBytes(desc.descriptor.format));
 
             // memcpy the buffer data to upload buffer
             const uint8_t* srcData = texture.data->data();
@@ -81,6 +81,7 @@ namespace engine
             , m_pipelineLayout{ vulkanPtr<VkPipelineLayout>(static_cast<DeviceImplVulkan*>(device.native())->device(), vkDestroyPipelineLayout) }
             , m_hashResourceStorage{}
             , m_currentPipelineCache{ nullptr }
+            , m_prewarmedPipelines{}
             
             //, m_pipeline{ vulkanPtr<VkPipeline>(DeviceImplGet::impl(device).device(), vkDestroyPipeline) }
 
@@ -391,6 +392,7 @@ namespace engine
         {
             m_finalized = false;
             m_hashResourceStorage.clear();
+            m_prewarmedPipelines.clear();
 
 #if 0
             auto pipelineHash = configuration->hash();
@@ -477,33 +479,10 @@ namespace engine
                 m_pipelineDescriptions.size()),
                 m_pipelineDescriptions.data());*/
 #endif
-            m_configuration = configuration;
-            if (!m_finalized)
-            {
-                m_finalized = true;
-
-                // create pipeline layout
+            std::lock_guard<std::mutex> lock(m_mutex);
 
-                loadShaders(configuration);
-                setShaderStages(configuration);
-                createRootSignature();
-
-                auto result = vkCreatePipelineLayout(
-                    static_cast<DeviceImplVulkan*>(m_device.native())->device(),
-                    &m_pipelineLayoutInfo,
-                    nullptr,
-                    m_pipelineLayout.get());
-                ASSERT(result == VK_SUCCESS);
-
-                VkDebugUtilsObjectNameInfoEXT debInfo = {};
-                debInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
-                debInfo.objectHandle = reinterpret_cast<uint64_t>(*m_pipelineLayout.get());
-                debInfo.pObjectName = configuration->pipelineName();
-                debInfo.objectType = VK_OBJECT_TYPE_PIPELINE_LAYOUT;
-                auto res = SetDebugUtilsObjectNameEXT(
-                    static_cast<const DeviceImplVulkan*>(m_device.native())->device(), &debInfo);
-                ASSERT(res == VK_SUCCESS);
-            }
+            m_configuration = configuration;
+            createPipelineLayout(configuration);
 
             auto pipelineHash = configuration->hash();
             //pipelineHash = m_pipelineState.hash(pipelineHash, configuration->computeShader() != nullptr);
@@ -518,6 +497,19 @@ namespace engine
             }
             else
             {
+                auto prewarmed = m_prewarmedPipelines.find(pipelineHash);
+                if (prewarmed != m_prewarmedPipelines.end())
+                {
+                    //LOG("Using prewarmed pipeline: %s", m_configuration->pipelineName());
+                    m_hashResourceStorage.insert(std::pair<uint64_t, PipelineCache>{ pipelineHash, std::move(prewarmed->second) });
+                    m_prewarmedPipelines.erase(prewarmed);
+                    storedPipeline = m_hashResourceStorage.find(pipelineHash);
+                    m_currentPipelineCache = &storedPipeline->second;
+
+                    createBindings(cmd, configuration);
+                    return;
+                }
+
                 //LOG("Using new pipeline: %s", m_configuration->pipelineName());
                 PipelineCache newPipeline(static_cast<DeviceImplVulkan*>(m_device.native())->device());
                 auto temp = m_hashResourceStorage.insert(std::pair<uint64_t, PipelineCache>{ pipelineHash, std::move(newPipeline) });
@@ -529,6 +521,57 @@ namespace engine
             }
         }
 
+        void PipelineImplVulkan::prewarm(shaders::PipelineConfiguration* configuration)
+        {
+            if (!configuration->hasComputeShader())
+                return;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            auto pipelineHash = configuration->hash();
+            if (m_hashResourceStorage.find(pipelineHash) != m_hashResourceStorage.end() ||
+                m_prewarmedPipelines.find(pipelineHash) != m_prewarmedPipelines.end())
+                return;
+
+            m_configuration = configuration;
+            createPipelineLayout(configuration);
+
+            PipelineCache newPipeline(static_cast<DeviceImplVulkan*>(m_device.native())->device());
+            m_prewarmedPipelines.insert(std::pair<uint64_t, PipelineCache>{ pipelineHash, std::move(newPipeline) });
+
+            auto current = m_currentPipelineCache;
+            m_currentPipelineCache = &m_prewarmedPipelines.find(pipelineHash)->second;
+            createGraphicsPipeline();
+            m_currentPipelineCache = current;
+        }
+
+        void PipelineImplVulkan::createPipelineLayout(shaders::PipelineConfiguration* configuration)
+        {
+            if (m_finalized)
+                return;
+            m_finalized = true;
+
+            loadShaders(configuration);
+            setShaderStages(configuration);
+            createRootSignature();
+
+            auto result = vkCreatePipelineLayout(
+                static_cast<DeviceImplVulkan*>(m_device.native())->device(),
+                &m_pipelineLayoutInfo,
+                nullptr,
+                m_pipelineLayout.get());
+            ASSERT(result == VK_SUCCESS);
+
+            VkDebugUtilsObjectNameInfoEXT debInfo = {};
+            debInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
+            debInfo.objectHandle = reinterpret_cast<uint64_t>(*m_pipelineLayout.get());
+            debInfo.pObjectName = configuration->pipelineName();
+            debInfo.objectType = VK_OBJECT_TYPE_PIPELINE_LAYOUT;
+            auto res = SetDebugUtilsObjectNameEXT(
+                static_cast<const DeviceImplVulkan*>(m_device.native())->device(), &debInfo);
+            ASSERT(res == VK_SUCCESS);
+        }
+
         int PipelineImplVulkan::countPipelineSets(shaders::PipelineConfiguration* configuration)
         {
             int res = 0;
@@ -1443,7 +1486,7 @@ namespace engine
 
 				auto result = vkCreateComputePipelines(
                     static_cast<DeviceImplVulkan*>(m_device.native())->device(),
-					VK_NULL_HANDLE, // VkPipelineCache object
+					static_cast<DeviceImplVulkan*>(m_device.native())->pipelineCache().native(),
 					1,
 					&pipelineInfo,
 					nullptr,
@@ -1535,7 +1578,7 @@ namespace engine
 
 				auto result = vkCreateGraphicsPipelines(
                     static_cast<DeviceImplVulkan*>(m_device.native())->device(),
-					VK_NULL_HANDLE, // VkPipelineCache object
+					static_cast<DeviceImplVulkan*>(m_device.native())->pipelineCache().native(),
 					1,
 					&pipelineInfo,
 					nullptr,
@@ -0,0 +1,124 @@
+#include "engine/graphics/vulkan/VulkanPipelineCache.h"
+#include "containers/vector.h"
+#include "platform/File.h"
+#include "tools/Debug.h"
+#include <fstream>
+#include <cstring>
+
+namespace engine
+{
+    namespace implementation
+    {
+        // "DKPC"
+        constexpr uint32_t PipelineCacheMagic = 0x43504b44;
+
+        // bump when the header changes
+        constexpr uint32_t PipelineCacheVersion = 1;
+
+        PipelineCacheVulkan::PipelineCacheVulkan(
+            VkPhysicalDevice physicalDevice,
+            VkDevice device,
+            const engine::string& path)
+            : m_device{ device }
+            , m_path{ path }
+            , m_header{}
+            , m_cache{ VK_NULL_HANDLE }
+        {
+            VkPhysicalDeviceProperties properties;
+            vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+            m_header.magic = PipelineCacheMagic;
+            m_header.version = PipelineCacheVersion;
+            m_header.vendorID = properties.vendorID;
+            m_header.deviceID = properties.deviceID;
+            m_header.driverVersion = properties.driverVersion;
+            memcpy(m_header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+            engine::vector<char> data;
+            std::ifstream file(m_path.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+            if (file.is_open())
+            {
+                auto fileSize = static_cast<uint64_t>(file.tellg());
+                file.seekg(0, std::ios::beg);
+
+                Header stored;
+                if (file.read(reinterpret_cast<char*>(&stored), sizeof(Header)) &&
+                    stored.magic == m_header.magic &&
+                    stored.version == m_header.version &&
+                    stored.vendorID == m_header.vendorID &&
+                    stored.deviceID == m_header.deviceID &&
+                    stored.driverVersion == m_header.driverVersion &&
+                    memcmp(stored.pipelineCacheUUID, m_header.pipelineCacheUUID, VK_UUID_SIZE) == 0)
+                {
+                    // a truncated or corrupted file can claim any size
+                    if (stored.dataSize > fileSize - sizeof(Header))
+                        LOG_WARNING("Vulkan pipeline cache is truncated. Starting a new one.");
+                    else
+                    {
+                        data.resize(static_cast<size_t>(stored.dataSize));
+                        if (!file.read(data.data(), static_cast<std::streamsize>(data.size())))
+                            data.clear();
+                    }
+                }
+                else
+                    LOG_INFO("Vulkan pipeline cache is from another device or driver. Starting a new one.");
+            }
+
+            VkPipelineCacheCreateInfo createInfo = {};
+            createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+            createInfo.initialDataSize = data.size();
+            createInfo.pInitialData = data.size() > 0 ? data.data() : nullptr;
+            auto result = vkCreatePipelineCache(m_device, &createInfo, nullptr, &m_cache);
+            if (result != VK_SUCCESS && data.size() > 0)
+            {
+                // the driver did not accept the data. start empty
+                createInfo.initialDataSize = 0;
+                createInfo.pInitialData = nullptr;
+                result = vkCreatePipelineCache(m_device, &createInfo, nullptr, &m_cache);
+            }
+            ASSERT(result == VK_SUCCESS, "Could not create Vulkan pipeline cache");
+        }
+
+        PipelineCacheVulkan::~PipelineCacheVulkan()
+        {
+            save();
+            vkDestroyPipelineCache(m_device, m_cache, nullptr);
+        }
+
+        void PipelineCacheVulkan::save()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            size_t size = 0;
+            auto result = vkGetPipelineCacheData(m_device, m_cache, &size, nullptr);
+            if (result != VK_SUCCESS || size == 0)
+                return;
+
+            engine::vector<char> data(size);
+            result = vkGetPipelineCacheData(m_device, m_cache, &size, data.data());
+            if (result != VK_SUCCESS)
+                return;
+
+            Header header = m_header;
+            header.dataSize = static_cast<uint64_t>(size);
+
+            // write next to the old one so a crash mid write doesn't leave a broken cache
+            auto temporary = m_path + ".temporary";
+            {
+                std::ofstream file(temporary.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+                if (!file.is_open())
+                {
+                    LOG_WARNING("Could not write Vulkan pipeline cache: %s", m_path.c_str());
+                    return;
+                }
+                file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+                file.write(data.data(), static_cast<std::streamsize>(size));
+            }
+
+            if (engine::fileExists(m_path))
+                engine::fileDelete(m_path);
+            engine::fileCopy(temporary, m_path);
+            engine::fileDelete(temporary);
+        }
+    }
+}
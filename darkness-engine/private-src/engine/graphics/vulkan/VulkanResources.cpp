@@ -97,6 +97,7 @@ namespace engine
             , m_state{ getResourceStateFromUsage(m_description.usage) }
         {
             updateDescFromInitialData(desc, m_description);
+            ASSERT(!m_description.reserved, "Vulkan backend does not support reserved buffers");
 
             const VkDevice& dev = device.device();
 
@@ -216,6 +217,11 @@ namespace engine
             m_state = state;
         }
 
+        size_t BufferImplVulkan::committedBytes() const
+        {
+            return m_description.elements * m_description.elementSize;
+        }
+
         VkBuffer& BufferImplVulkan::native()
         {
             return *m_buffer;
@@ -813,16 +819,8 @@ namespace engine
             : m_description( desc.descriptor )
             , m_image{ vulkanPtr<VkImage>(device.device(), vkDestroyImage) }
             , m_memory{ vulkanPtr<VkDeviceMemory>(device.device(), vkFreeMemory) }
-            //, m_state{ getResourceStateFromUsage(m_description.usage) }
+            , m_state{ desc.descriptor.arraySlices, desc.descriptor.mipLevels, ResourceState::Undefined }
         {
-			for (int slice = 0; slice < static_cast<int>(m_description.arraySlices); ++slice)
-			{
-				for (int mip = 0; mip < static_cast<int>(m_description.mipLevels); ++mip)
-				{
-					m_state.emplace_back(ResourceState::Undefined);
-				}
-			}
-
             const VkDevice& dev = device.device();
 
             VkImageCreateInfo imageInfo = {};
@@ -941,14 +939,8 @@ namespace engine
             : m_description(desc.descriptor)
             , m_image{ image }
             , m_memory{ nullptr }
+            , m_state{ desc.descriptor.arraySlices, desc.descriptor.mipLevels, ResourceState::Undefined }
         {
-			for (int slice = 0; slice < static_cast<int>(m_description.arraySlices); ++slice)
-			{
-				for (int mip = 0; mip < static_cast<int>(m_description.mipLevels); ++mip)
-				{
-					m_state.emplace_back(ResourceState::Undefined);
-				}
-			}
         }
 
         void* TextureImplVulkan::map(const DeviceImplIf* /*device*/)
@@ -982,12 +974,25 @@ namespace engine
 
         ResourceState TextureImplVulkan::state(int slice, int mip) const
         {
-            return m_state[mip + (slice * m_description.mipLevels)];
+            return m_state.state(slice, mip);
         }
 
         void TextureImplVulkan::state(int slice, int mip, ResourceState state)
         {
-            m_state[mip + (slice * m_description.mipLevels)] = state;
+            m_state.state(slice, mip, state);
+        }
+
+        void TextureImplVulkan::state(ResourceState state)
+        {
+            m_state.state(state);
+        }
+
+        bool TextureImplVulkan::uniformState(ResourceState& state) const
+        {
+            if (!m_state.uniform())
+                return false;
+            state = m_state.uniformState();
+            return true;
         }
 
         TextureSRVImplVulkan::TextureSRVImplVulkan(
@@ -19,8 +19,10 @@ namespace engine
     {
         class PipelineImplDX12;
         class PipelineImplVulkan;
+        class PipelineImplNull;
         class CommandListImplDX12;
         class CommandListImplVulkan;
+        class CommandListImplNull;
         class DescriptorHeapImplDX12;
         class DescriptorHeapImplVulkan;
         class PipelineShadersDX12;
@@ -92,12 +94,14 @@ namespace engine
         protected:
             friend class implementation::PipelineImplDX12;
             friend class implementation::PipelineImplVulkan;
+            friend class implementation::PipelineImplNull;
             friend class implementation::PipelineShadersDX12;
             friend class implementation::PipelineShadersVulkan;
             friend class implementation::PipelineRootSignatureDX12;
             friend class implementation::PipelineRootSignatureVulkan;
             friend class implementation::CommandListImplDX12;
             friend class implementation::CommandListImplVulkan;
+            friend class implementation::CommandListImplNull;
             friend class implementation::DescriptorHeapImplDX12;
             friend class implementation::DescriptorHeapImplVulkan;
             friend class engine::CommandList;
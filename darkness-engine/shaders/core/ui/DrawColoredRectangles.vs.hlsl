@@ -0,0 +1,45 @@
+
+struct ColoredRectangleItem
+{
+	float2 position;
+	float2 size;
+	float4 color;
+};
+
+StructuredBuffer<ColoredRectangleItem> rectangles;
+
+cbuffer DrawColoredRectanglesConstants
+{
+	float2 screenSize;
+	uint startIndex;
+	float padding;
+};
+
+struct VSOutput
+{
+	float4 position : SV_Position0;
+	float4 color	: COLOR0;
+};
+
+VSOutput main(uint id : SV_VertexID)
+{
+	int rectangleId = id / 6;
+	int indexId = id % 6;
+	ColoredRectangleItem rec = rectangles[startIndex + rectangleId];
+
+	// two triangles. 0, 1, 2 and 2, 1, 3 of the quad
+	float2 corner = float2(0.0f, 0.0f);
+	if (indexId == 1 || indexId == 4)
+		corner = float2(1.0f, 0.0f);
+	else if (indexId == 2 || indexId == 3)
+		corner = float2(0.0f, 1.0f);
+	else if (indexId == 5)
+		corner = float2(1.0f, 1.0f);
+
+	float2 pixel = rec.position + corner * rec.size;
+
+	VSOutput output;
+	output.position = float4((pixel / screenSize) * float2(2, -2) + float2(-1, 1), 0, 1);
+	output.color = rec.color;
+	return output;
+}
@@ -49,6 +49,7 @@ Engine::Engine(
     , m_cycleTransforms{ engine::make_unique<engine::Pipeline<engine::shaders::CycleTransforms>>(m_renderSetup->device().createPipeline<shaders::CycleTransforms>()) }
     , m_frameCapturer{ (m_mode == EngineMode::OwnThreadNoPresent) ? engine::make_unique<engine::FrameCpuCapturer>(m_renderSetup->device()) : nullptr }
     , m_lightData{ engine::make_shared<LightData>() }
+    , m_occlusionBuffer{ engine::make_shared<OcclusionBuffer>() }
     , m_inputManager{ inputManager != nullptr ? inputManager : engine::make_shared<InputManager>(m_renderSetup->device().width(), m_renderSetup->device().height()) }
     //, m_cameraTransform{ engine::make_shared<engine::Transform>() }
     //, m_camera{ engine::make_unique<Camera>(m_cameraTransform) }
@@ -434,6 +435,10 @@ bool Engine::render()
 
     {
         CPU_MARKER(m_renderSetup->device().api(), "Cpu/Gpu refresh");
+
+        // meshes read on the streaming thread since the last frame
+        device.streamMeshes();
+
         for (auto&& node : flatScene.nodes)
         {
             if (node.rigidBody && node.rigidBody->body())
@@ -566,6 +571,14 @@ bool Engine::render()
 
     flatScene.lightData = m_lightData;
 
+    if (flatScene.validScene())
+    {
+        CPU_MARKER(m_renderSetup->device().api(), "Occlusion buffer");
+        m_occlusionBuffer->update(flatScene, flatScene.cullingCamera());
+        m_occlusionBuffer->prioritizeStreaming(flatScene);
+        flatScene.occlusion = m_occlusionBuffer;
+    }
+
     if (m_updateEnvironmentOnNextFrame >= 0)
         --m_updateEnvironmentOnNextFrame;
 
@@ -626,12 +639,17 @@ bool Engine::render()
 
         // lighting update
         updateLighting(cmd, flatScene);
+    }
+
+    // render viewport. with parallel recording the viewport submits cmd
+    // and continues in a new list so no gpu markers can be open here.
+    m_viewportRenderer->render(cmd, flatScene, m_renderSetup->currentRTV(), 
+        m_cameraInput->mousePosition().first,
+        m_cameraInput->mousePosition().second);
 
-        
-        // render viewport
-        m_viewportRenderer->render(cmd, flatScene, m_renderSetup->currentRTV(), 
-            m_cameraInput->mousePosition().first,
-            m_cameraInput->mousePosition().second);
+    {
+        CPU_MARKER(cmd.api(), "Render overlays");
+        GPU_MARKER(cmd, "Render overlays");
 
         // render debug view
         renderDebugView(cmd);
@@ -645,6 +663,30 @@ bool Engine::render()
                 if (ImGui::Begin("Gpu Measures", m_viewportRenderer->measuresEnabled(), ImGuiWindowFlags_AlwaysAutoResize))
                 {
                     drawMeasureImgui(m_lastFrameResults);
+
+                    auto& recorder = m_viewportRenderer->passRecorder();
+                    if (ImGui::TreeNode("Viewport recording (cpu)"))
+                    {
+                        ImGui::SameLine();
+                        ImGui::Text("%.3f", recorder.milliseconds());
+                        for (auto&& timing : recorder.timings())
+                        {
+                            ImGui::Text("%s", timing.name);
+                            ImGui::SameLine();
+                            ImGui::Text("%.3f%s", timing.milliseconds, timing.worker ? " (worker)" : "");
+                        }
+                        ImGui::TreePop();
+                    }
+                    else
+                    {
+                        ImGui::SameLine();
+                        ImGui::Text("%.3f", recorder.milliseconds());
+                    }
+
+                    const auto& transitions = m_renderSetup->device().transitionStatistics();
+                    ImGui::Text("Transitions: %u requested, %u skipped, %u whole resource",
+                        transitions.requested, transitions.skipped, transitions.wholeResource);
+                    ImGui::Text("Barriers: %u in %u batches", transitions.barriers, transitions.flushes);
                 }
                 ImGui::End();
             }
@@ -1266,6 +1308,7 @@ void Engine::shutdown()
     m_frameCapturer = nullptr;
 
 	m_lightData = nullptr;
+	m_occlusionBuffer = nullptr;
 	//m_camera = nullptr;
 
     m_debugViewer.reset(nullptr);
@@ -1,6 +1,8 @@
 #include "engine/font/Font.h"
-#include "engine/font/FontAtlas.h"
-#include "tools/AtlasAllocator.h"
+#include "engine/font/GlyphAtlas.h"
+#include "engine/font/TextLayoutCache.h"
+#include "engine/graphics/Device.h"
+#include "engine/rendering/ResidencyManager.h"
 #include "tools/PathTools.h"
 #include "platform/File.h"
 #include "tools/Debug.h"
@@ -9,12 +11,24 @@
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
 
+#include <algorithm>
+#include <cstring>
+
 namespace engine
 {
-	Font::Font(Device& device, FT_Library library, const engine::string& fontPath)
+	Font::Font(Device& device, FT_Library library, const engine::string& fontPath, JobSystem& jobs)
 		: m_device{ device }
 		, m_face{}
 		, m_atlas{ nullptr }
+		, m_pixelHeight{ 0.0f }
+		, m_baseline{ 0 }
+		, m_glyphs{}
+		, m_glyphNodes{}
+		, m_glyphAdvances{}
+		, m_frame{ 0 }
+		, m_prefetchJobs{ jobs }
+		, m_prefetched{}
+		, m_layoutCache{ engine::make_unique<TextLayoutCache>() }
 	{
 		ASSERT(engine::fileExists(fontPath), "Tried to create font from: %s, but the file doesn't exist", fontPath.c_str());
 		m_renderNodeData.resize(1024 * 1024);
@@ -48,338 +62,425 @@ namespace engine
 		return static_cast<int>(((pixelSize * 72.0f) / 300.0f) * 64.0f);
 	}
 
-	int Font::validGlyphCount()
+	void Font::createAtlasWithFontSize(float pixelHeight)
 	{
-		int result = 0;
-		for (int n = 0; n < 255; n++)
-		{
-			//auto glyph_index = FT_Get_Char_Index(m_face, n);
-
-			/* load glyph image into the slot (erase previous one) */
-			auto error = FT_Load_Char(m_face, n, FT_LOAD_RENDER);
-			if (error)
-				continue;  /* ignore errors */
-
-			//auto error = FT_Load_Glyph(m_face, glyph_index, FT_LOAD_DEFAULT);
-			//if (error)
-			//	continue;  /* ignore errors, jump to next glyph */
-			//
-			//FT_Glyph      glyph;
-			//error = FT_Get_Glyph(m_face->glyph, &glyph);
-			//if (error)
-			//	continue;  /* ignore errors, jump to next glyph */
-			//
-			//
-
-#if 0
-
-
-
-
-			FT_GlyphSlot  slot;
-			FT_Matrix     matrix;              /* transformation matrix */
-			FT_UInt       glyph_index;
-			FT_Vector     pen;                 /* untransformed origin */
-			int           n;
-
-			slot = m_face->glyph;                /* a small shortcut */
+		const int fontSize = pointSizeFromPixel(pixelHeight);
+		m_pixelHeight = pixelHeight;
 
-/* set up matrix */
-			float angle = 0.0f;
-			matrix.xx = (FT_Fixed)(cos(angle) * 0x10000L);
-			matrix.xy = (FT_Fixed)(-sin(angle) * 0x10000L);
-			matrix.yx = (FT_Fixed)(sin(angle) * 0x10000L);
-			matrix.yy = (FT_Fixed)(cos(angle) * 0x10000L);
+		auto error = FT_Set_Char_Size(
+			m_face,    /* handle to face object           */
+			0,       /* char_width in 1/64th of points  */
+			fontSize,   /* char_height in 1/64th of points */
+			300,     /* horizontal device resolution    */
+			300);   /* vertical device resolution      */
+		if (error)
+			LOG("FreeType complained about something. We're not that interested.");
 
-			long my_target_height = fontSize;
+		// the cell comes from the face bounding box so no glyph has to be
+		// loaded to size the atlas
+		auto& metrics = m_face->size->metrics;
+		int cellWidth = static_cast<int>((FT_MulFix(m_face->bbox.xMax - m_face->bbox.xMin, metrics.x_scale) + 63) >> 6);
+		int cellHeight = static_cast<int>((FT_MulFix(m_face->bbox.yMax - m_face->bbox.yMin, metrics.y_scale) + 63) >> 6);
+		m_baseline = static_cast<int>((metrics.ascender + 63) >> 6);
 
-			/* the pen position in 26.6 cartesian space coordinates */
-			/* start at (300,200)                                   */
-			pen.x = 0 * 64;
-			pen.y = 0;// (my_target_height - 200) * 64;
+		m_atlas = engine::make_unique<GlyphAtlas>(
+			m_device,
+			std::max(cellWidth, 1),
+			std::max(cellHeight, 1));
 
-			int maxWidth = 0;
-			int maxHeight = 0;
+		for (auto&& glyph : m_glyphs)
+			glyph = GlyphStore{};
+		m_extendedGlyphs.clear();
+		m_layoutCache->clear();
+	}
 
-			int glyphCount = 0;
+	Font::~Font()
+	{
+		m_prefetchJobs.wait();
+		FT_Done_Face(m_face);
+	}
 
+	TextureSRV Font::fontAtlas()
+	{
+		return m_atlas->page(0);
+	}
 
-			FT_Vector     pen;
-			int xPos = 0;
-			int yPos = 0;
+	void Font::freeTemporaryAllocations()
+	{
+		m_ringBuffer.reset();
+		++m_frame;
+	}
 
-			engine::vector<engine::ResidencyManagerV2::ResidencyFuture> futures;
+	void Font::prefetch(const engine::string& characters)
+	{
+		m_prefetchJobs.wait();
 
-			for (int n = 0; n < 255; n++)
+		m_prefetchJobs.run([this, characters]()
+		{
+			for (size_t i = 0; i < characters.size();)
 			{
-				/* set transformation */
-				FT_Set_Transform(m_face, &matrix, &pen);
-
-				/* load glyph image into the slot (erase previous one) */
-				error = FT_Load_Char(m_face, n, FT_LOAD_RENDER);
-				if (error)
-					continue;  /* ignore errors */
-
-					/* now, draw to our target surface (convert position) */
-				//my_draw_bitmap(&slot->bitmap,
-				//	slot->bitmap_left,
-				//	my_target_height - slot->bitmap_top);
-				if (slot->bitmap.buffer)
+				auto codepoint = decodeUtf8(characters.data(), characters.size(), i);
 				{
-					auto atlasAlloc = m_atlas->allocate();
-					futures.emplace_back(m_device.residencyV2().upload(
-						static_cast<void*>(slot->bitmap.buffer),
-						slot->bitmap.width,
-						slot->bitmap.rows,
-						m_atlas->atlas().texture(),
-						//xPos, yPos,
-						atlasAlloc.x, atlasAlloc.y,
-						0, 0, 1, true));
-
-					GlyphStore store;
-					store.x = atlasAlloc.x;
-					store.y = atlasAlloc.y;
-					store.width = slot->bitmap.width;
-					store.height = slot->bitmap.rows;
-					m_glyphs[n] = store;
+					std::lock_guard<std::mutex> lock(m_prefetchMutex);
+					auto prefetched = m_prefetched.find(codepoint);
+					if (prefetched != m_prefetched.end() && prefetched->second.ready)
+						continue;
 				}
-				/*auto cmd = device.createCommandList("Glyph upload cmd");
-				cmd.copyTexture()
-				device.submitBlocking(cmd);*/
 
-				/* increment pen position */
-				pen.x += slot->advance.x;
-				pen.y += slot->advance.y;
+				RasterizedGlyph glyph;
+				rasterizeGlyph(codepoint, glyph);
 
+				std::lock_guard<std::mutex> lock(m_prefetchMutex);
+				auto& stored = m_prefetched[codepoint];
+				stored = std::move(glyph);
+				stored.ready = true;
 			}
+		});
+	}
 
-			for (auto&& future : futures)
-				future.blockUntilUploaded();
+	uint32_t Font::decodeUtf8(const char* text, size_t length, size_t& index)
+	{
+		auto byte = static_cast<uint8_t>(text[index]);
+		if (byte < 0x80)
+		{
+			++index;
+			return byte;
+		}
 
-#endif
+		int extra = 0;
+		uint32_t codepoint = 0;
+		if (byte >= 0xc2 && byte <= 0xdf)
+		{
+			extra = 1;
+			codepoint = byte & 0x1fu;
+		}
+		else if (byte >= 0xe0 && byte <= 0xef)
+		{
+			extra = 2;
+			codepoint = byte & 0x0fu;
+		}
+		else if (byte >= 0xf0 && byte <= 0xf4)
+		{
+			extra = 3;
+			codepoint = byte & 0x07u;
+		}
 
-			if (m_face->glyph->bitmap.buffer)
-				++result;
+		bool valid = extra > 0 && index + extra < length;
+		for (int i = 1; valid && i <= extra; ++i)
+		{
+			auto next = static_cast<uint8_t>(text[index + i]);
+			valid = (next & 0xc0u) == 0x80u;
+			codepoint = (codepoint << 6) | (next & 0x3fu);
 		}
-		return result;
-	}
 
-	Vector2<int> Font::maxGlyphSize()
-	{
-		Vector2<int> result{ 0, 0 };
+		// overlong forms, surrogates and past the last codepoint
+		if (valid)
+			valid = !(extra == 2 && codepoint < 0x800u) &&
+				!(extra == 3 && (codepoint < 0x10000u || codepoint > 0x10ffffu)) &&
+				!(codepoint >= 0xd800u && codepoint <= 0xdfffu);
 
-		for (int n = 0; n < 255; n++)
+		if (!valid)
 		{
-			auto glyph_index = FT_Get_Char_Index(m_face, n);
+			++index;
+			return byte;
+		}
+		index += static_cast<size_t>(extra) + 1;
+		return codepoint;
+	}
 
-			FT_Glyph      glyph;
+	Font::GlyphStore& Font::glyphStore(uint32_t codepoint)
+	{
+		return codepoint < GlyphTableSize ? m_glyphs[codepoint] : m_extendedGlyphs[codepoint].store;
+	}
 
-			auto error = FT_Load_Glyph(m_face, glyph_index, FT_LOAD_DEFAULT);
-			if (error)
-				continue;  /* ignore errors, jump to next glyph */
+	Font::GlyphRenderNodeData& Font::glyphNode(uint32_t codepoint)
+	{
+		return codepoint < GlyphTableSize ? m_glyphNodes[codepoint] : m_extendedGlyphs[codepoint].node;
+	}
 
-			error = FT_Get_Glyph(m_face->glyph, &glyph);
-			if (error)
-				continue;  /* ignore errors, jump to next glyph */
+	float& Font::glyphAdvance(uint32_t codepoint)
+	{
+		return codepoint < GlyphTableSize ? m_glyphAdvances[codepoint] : m_extendedGlyphs[codepoint].advance;
+	}
 
-			FT_BBox  glyph_bbox;
-			FT_Glyph_Get_CBox(glyph, ft_glyph_bbox_pixels, &glyph_bbox);
+	void Font::rasterizeGlyph(uint32_t codepoint, RasterizedGlyph& glyph)
+	{
+		std::lock_guard<std::mutex> lock(m_faceMutex);
 
-			if (result.x < glyph_bbox.xMax - glyph_bbox.xMin)
-				result.x = glyph_bbox.xMax - glyph_bbox.xMin;
+		glyph.width = 0;
+		glyph.height = 0;
+		glyph.xAdvance = 0;
+		glyph.brearingX = 0;
+		glyph.bitmapTop = 0;
+		glyph.bitmap.clear();
+		glyph.ready = false;
 
-			if (result.y < glyph_bbox.yMax - glyph_bbox.yMin)
-				result.y = glyph_bbox.yMax - glyph_bbox.yMin;
-		}
+		auto error = FT_Load_Char(m_face, codepoint, FT_LOAD_RENDER);
+		if (error)
+			return;  /* ignore errors */
 
-		return result;
+		FT_GlyphSlot slot = m_face->glyph;
+		glyph.xAdvance = slot->advance.x >> 6;
+		glyph.brearingX = slot->metrics.horiBearingX;
+		glyph.bitmapTop = slot->bitmap_top;
+		if (!slot->bitmap.buffer)
+			return;
+
+		// a glyph going past the face bounding box is cut to the cell
+		glyph.width = std::min(static_cast<int>(slot->bitmap.width), m_atlas->cellWidth());
+		glyph.height = std::min(static_cast<int>(slot->bitmap.rows), m_atlas->cellHeight());
+		glyph.bitmap.resize(static_cast<size_t>(glyph.width * glyph.height));
+		for (int y = 0; y < glyph.height; ++y)
+			memcpy(
+				&glyph.bitmap[static_cast<size_t>(y * glyph.width)],
+				slot->bitmap.buffer + y * slot->bitmap.pitch,
+				static_cast<size_t>(glyph.width));
 	}
 
-	void Font::createAtlasWithInitialSize(const engine::Vector2<int>& maxGlyphSize, int validGlyphCount)
+	bool Font::takePrefetched(uint32_t codepoint, RasterizedGlyph& glyph)
 	{
-		engine::Vector2<int> initialSize;
-		{
-			AtlasAllocator atlas(maxGlyphSize.x, maxGlyphSize.y);
-			initialSize = atlas.simulateSize(validGlyphCount);
-		}
-
-		m_atlas = engine::make_shared<FontAtlas>(
-			m_device,
-			maxGlyphSize.x,
-			maxGlyphSize.y,
-			initialSize.x,
-			initialSize.y);
+		std::lock_guard<std::mutex> lock(m_prefetchMutex);
+		auto prefetched = m_prefetched.find(codepoint);
+		if (prefetched == m_prefetched.end() || !prefetched->second.ready)
+			return false;
+
+		glyph = std::move(prefetched->second);
+		m_prefetched.erase(prefetched);
+		return true;
 	}
 
-	void Font::loadGlyphsToAtlas()
+	void Font::makeResident(const engine::vector<uint32_t>& codepoints)
 	{
-		FT_Matrix     matrix;
-		float angle = 0.0f;
-		matrix.xx = (FT_Fixed)(cos(angle) * 0x10000L);
-		matrix.xy = (FT_Fixed)(-sin(angle) * 0x10000L);
-		matrix.yx = (FT_Fixed)(sin(angle) * 0x10000L);
-		matrix.yy = (FT_Fixed)(cos(angle) * 0x10000L);
-
-		FT_Vector     pen{ 0, 0 };
-		FT_GlyphSlot slot = m_face->glyph;
-
+		// bitmaps are kept until the whole batch has been uploaded
+		engine::vector<RasterizedGlyph> rasterized(codepoints.size());
 		engine::vector<engine::ResidencyManagerV2::ResidencyFuture> futures;
+		futures.reserve(codepoints.size());
 
-		for (int n = 0; n < 255; n++)
+		for (size_t i = 0; i < codepoints.size(); ++i)
 		{
-			FT_Set_Transform(m_face, &matrix, &pen);
-
-			auto error = FT_Load_Char(m_face, n, FT_LOAD_RENDER);
-			if (error)
-				continue;  /* ignore errors */
-
-			//FT_Render_Glyph(slot, FT_Render_Mode::FT_RENDER_MODE_NORMAL);
-
-			GlyphStore store;
-			store.width = m_face->glyph->bitmap.width;
-			store.height = m_face->glyph->bitmap.rows;
-			store.xAdvance = slot->advance.x >> 6;
-			store.brearingX = slot->metrics.horiBearingX;
-			store.bitmapTop = slot->bitmap_top - store.height;
-			if (m_face->glyph->bitmap.buffer)
+			auto codepoint = codepoints[i];
+			auto& glyph = rasterized[i];
+			if (!takePrefetched(codepoint, glyph))
+				rasterizeGlyph(codepoint, glyph);
+
+			GlyphStore& store = glyphStore(codepoint);
+			store.width = glyph.width;
+			store.height = glyph.height;
+			store.xAdvance = glyph.xAdvance;
+			store.brearingX = glyph.brearingX;
+			store.bitmapTop = glyph.bitmapTop;
+			store.state = GlyphState::Empty;
+
+			if (glyph.bitmap.size() > 0)
 			{
-				auto atlasAlloc = m_atlas->allocate();
+				GlyphAtlas::Cell cell;
+				if (!m_atlas->allocate(cell) && !(evictGlyph() && m_atlas->allocate(cell)))
+				{
+					LOG_WARNING("Font atlas is out of pages and every glyph is in use. Adding a page over the limit");
+					m_atlas->allocate(cell, true);
+				}
+
 				futures.emplace_back(m_device.residencyV2().upload(
-					static_cast<void*>(m_face->glyph->bitmap.buffer),
-					m_face->glyph->bitmap.width,
-					m_face->glyph->bitmap.rows,
-					m_atlas->atlas().texture(),
-					//xPos, yPos,
-					atlasAlloc.x, atlasAlloc.y,
+					static_cast<void*>(glyph.bitmap.data()),
+					glyph.width,
+					glyph.height,
+					m_atlas->page(cell.page).texture(),
+					cell.allocation.x, cell.allocation.y,
 					0, 0, 1, true));
 
-				
-				store.x = atlasAlloc.x;
-				store.y = atlasAlloc.y;
-				store.cellHeight = atlasAlloc.height;
-				store.validBitmap = true;
-			}
-			else
-			{
-				store.x = 0;
-				store.y = 0;
-				store.validBitmap = false;
+				store.cell = cell;
+				store.state = GlyphState::Resident;
 			}
-			m_glyphs[n] = store;
-
-			//pen.x += slot->advance.x;
-			//pen.y += slot->advance.y;
-
+			updateGlyphNode(codepoint);
 		}
 
 		for (auto&& future : futures)
 			future.blockUntilUploaded();
 	}
 
-	void Font::createAtlasWithFontSize(float pixelHeight)
+	bool Font::evictGlyph()
 	{
-		const int fontSize = pointSizeFromPixel(pixelHeight);
+		// the gpu may still be reading cells of the last few frames
+		constexpr uint64_t EvictionDelayFrames = 3;
 
-		auto error = FT_Set_Char_Size(
-			m_face,    /* handle to face object           */
-			0,       /* char_width in 1/64th of points  */
-			fontSize,   /* char_height in 1/64th of points */
-			300,     /* horizontal device resolution    */
-			300);   /* vertical device resolution      */
-		if (error)
-			LOG("FreeType complained about something. We're not that interested.");
-
-		auto maxSize = maxGlyphSize();
-		auto glyphCount = validGlyphCount();
+		GlyphStore* victim = nullptr;
+		uint32_t victimCodepoint = 0;
+		auto consider = [&](uint32_t codepoint, GlyphStore& store)
+		{
+			if (store.state == GlyphState::Resident &&
+				store.lastUsed + EvictionDelayFrames <= m_frame &&
+				(!victim || store.lastUsed < victim->lastUsed))
+			{
+				victim = &store;
+				victimCodepoint = codepoint;
+			}
+		};
+		for (uint32_t i = 0; i < GlyphTableSize; ++i)
+			consider(i, m_glyphs[i]);
+		for (auto&& glyph : m_extendedGlyphs)
+			consider(glyph.first, glyph.second.store);
+		if (!victim)
+			return false;
+
+		m_atlas->free(victim->cell);
+		victim->state = GlyphState::Unknown;
+		updateGlyphNode(victimCodepoint);
+
+		// cached runs may point to the cell
+		m_layoutCache->clear();
+		return true;
+	}
 
-		createAtlasWithInitialSize(maxSize, glyphCount);
-		loadGlyphsToAtlas();
+	void Font::updateGlyphNode(uint32_t codepoint)
+	{
+		const GlyphStore& store = glyphStore(codepoint);
+		GlyphRenderNodeData& node = glyphNode(codepoint);
+		if (store.state == GlyphState::Resident)
+		{
+			const float pageSize = static_cast<float>(m_atlas->pageSize());
+			node.uvTopLeft = {
+				static_cast<float>(store.cell.allocation.x) / pageSize,
+				static_cast<float>(store.cell.allocation.y) / pageSize };
+			node.uvBottomRight = {
+				static_cast<float>(store.cell.allocation.x + store.width) / pageSize,
+				static_cast<float>(store.cell.allocation.y + store.height) / pageSize };
+			node.size = { static_cast<float>(store.width), static_cast<float>(store.height) };
+			node.dstPosition = { static_cast<float>(store.brearingX >> 6), static_cast<float>(m_baseline - store.bitmapTop) };
+		}
+		else
+			node = GlyphRenderNodeData{};
+		glyphAdvance(codepoint) = static_cast<float>(store.xAdvance);
 	}
 
-	Font::~Font()
+	void Font::layoutText(const char* text, size_t length, GlyphRenderNodeData* nodes)
 	{
-		FT_Done_Face(m_face);
+		// copies the glyph of every codepoint and moves it by the pen
+		float pen = 0.0f;
+		for (size_t i = 0; i < length; ++nodes)
+		{
+			auto codepoint = decodeUtf8(text, length, i);
+			*nodes = glyphNode(codepoint);
+			nodes->dstPosition.x += pen;
+			pen += glyphAdvance(codepoint);
+		}
 	}
 
-	TextureSRV Font::fontAtlas()
+	const engine::vector<Font::GlyphRenderNodeData>& Font::cachedLayout(const char* text, size_t length, size_t glyphCount)
 	{
-		return m_atlas->atlas();
+		TextLayoutCache::Key key{ this, m_pixelHeight, TextLayoutCache::hash(text, length) };
+		if (auto cached = m_layoutCache->find(key, text, length))
+			return *cached;
+
+		auto& nodes = m_layoutCache->insert(key, text, length, glyphCount);
+		layoutText(text, length, nodes.data());
+		return nodes;
 	}
 
-	void Font::freeTemporaryAllocations()
+	engine::vector<Font::GlyphRenderData> Font::renderText(const engine::string& text)
 	{
-		m_ringBuffer.reset();
+		const char* texts[] = { text.c_str() };
+		engine::vector<GlyphRenderData> runs;
+		engine::vector<uint32_t> firstRun;
+		renderTexts(texts, 1, runs, firstRun);
+		return runs;
 	}
 
-	Font::GlyphRenderData Font::renderText(const engine::string& text)
+	void Font::renderTexts(
+		const char* const* texts,
+		size_t count,
+		engine::vector<GlyphRenderData>& runs,
+		engine::vector<uint32_t>& firstRun)
 	{
-		//FT_GlyphSlot slot = m_face->glyph;
-		//
-		//FT_Matrix     matrix;
-		//float angle = 0.0f;
-		//matrix.xx = (FT_Fixed)(cos(angle) * 0x10000L);
-		//matrix.xy = (FT_Fixed)(-sin(angle) * 0x10000L);
-		//matrix.yx = (FT_Fixed)(sin(angle) * 0x10000L);
-		//matrix.yy = (FT_Fixed)(cos(angle) * 0x10000L);
-		//
-		//FT_UInt       previous;
-		FT_Vector     pen;
-		pen.x = 0 * 64;
-		pen.y = 0;
-		//
-		GlyphRenderData result;
-		result.texture = m_atlas->atlas();
-
-		//bool use_kerning = FT_HAS_KERNING(m_face);
-
-		//result.nodes.reserve(text.length());
-		auto allocation = m_ringBuffer.allocate(sizeof(GlyphRenderNodeData) * text.length());
-		result.nodes = reinterpret_cast<GlyphRenderNodeData*>(allocation.ptr);
-		result.nodeCount = static_cast<int>(text.length());
-		int nodeIndex = 0;
-		for (int i = 0; i < text.length(); ++i)
+		runs.clear();
+		firstRun.resize(count + 1);
+
+		// every used glyph is stamped before anything is made resident
+		// so the new glyphs can't evict glyphs of this frame
+		engine::vector<size_t> lengths(count);
+		engine::vector<size_t> glyphCounts(count);
+		engine::vector<uint32_t> missing;
+		bool missingListed[GlyphTableSize] = {};
+		size_t totalGlyphs = 0;
+		for (size_t i = 0; i < count; ++i)
 		{
-			//auto glyph_index = FT_Get_Char_Index(m_face, text[i]);
-			//if (use_kerning && previous && glyph_index)
-			//{
-			//	FT_Vector  delta;
-			//
-			//
-			//	FT_Get_Kerning(m_face, previous, glyph_index,
-			//		FT_KERNING_DEFAULT, &delta);
-			//
-			//	pen.x += delta.x >> 6;
-			//}
-			//
-			//FT_Set_Transform(m_face, &matrix, &pen);
-			//
-			//auto error = FT_Load_Glyph(m_face, glyph_index, FT_LOAD_RENDER);
-			//if (error) continue;
-			//
-			
-
-			GlyphRenderNodeData& node = result.nodes[nodeIndex];
-			GlyphStore& store = m_glyphs[text[i]];
-			if (store.validBitmap)
+			lengths[i] = texts[i] ? strlen(texts[i]) : 0;
+			size_t glyphs = 0;
+			for (size_t c = 0; c < lengths[i]; ++glyphs)
 			{
-				node.uvTopLeft = {
-					static_cast<float>(store.x) / static_cast<float>(result.texture.width()),
-					static_cast<float>(store.y) / static_cast<float>(result.texture.height()) };
-				node.uvBottomRight = {
-					static_cast<float>(store.x + store.width) / static_cast<float>(result.texture.width()),
-					static_cast<float>(store.y + store.height) / static_cast<float>(result.texture.height()) };
-				node.size = { static_cast<float>(store.width), static_cast<float>(store.height) };
-				node.dstPosition = { static_cast<float>(pen.x + (store.brearingX >> 6)), static_cast<float>(pen.y + (store.cellHeight - store.height) - store.bitmapTop) };
+				auto codepoint = decodeUtf8(texts[i], lengths[i], c);
+				GlyphStore& store = glyphStore(codepoint);
+				store.lastUsed = m_frame;
+				if (store.state != GlyphState::Unknown)
+					continue;
+
+				// the table has flags, the rare codepoints past it are looked up from the list
+				bool listed = codepoint < GlyphTableSize ?
+					missingListed[codepoint] :
+					std::find(missing.begin(), missing.end(), codepoint) != missing.end();
+				if (!listed)
+				{
+					if (codepoint < GlyphTableSize)
+						missingListed[codepoint] = true;
+					missing.emplace_back(codepoint);
+				}
 			}
-			pen.x += store.xAdvance;
-			++nodeIndex;
-			//pen.x += slot->advance.x >> 6;
-			//pen.y += slot->advance.y;
-			//
-			//previous = glyph_index;
+			glyphCounts[i] = glyphs;
+			totalGlyphs += glyphs;
 		}
+		if (missing.size() > 0)
+			makeResident(missing);
 
-		return result;
-	}
+		// one allocation for all the strings
+		GlyphRenderNodeData* nodes = nullptr;
+		if (totalGlyphs > 0)
+		{
+			auto allocation = m_ringBuffer.allocate(sizeof(GlyphRenderNodeData) * totalGlyphs);
+			ASSERT(allocation.size > 0, "Ran out of glyph render node space");
+			nodes = reinterpret_cast<GlyphRenderNodeData*>(allocation.ptr);
+		}
 
+		const size_t pageCount = m_atlas->pageCount();
+		engine::vector<int> pageNodes(pageCount);
+		for (size_t i = 0; i < count; ++i)
+		{
+			firstRun[i] = static_cast<uint32_t>(runs.size());
+			if (lengths[i] == 0)
+				continue;
+
+			auto& layout = cachedLayout(texts[i], lengths[i], glyphCounts[i]);
+			if (pageCount == 1)
+			{
+				memcpy(nodes, layout.data(), sizeof(GlyphRenderNodeData) * glyphCounts[i]);
+				runs.emplace_back(GlyphRenderData{ m_atlas->page(0), nodes, static_cast<int>(glyphCounts[i]) });
+				nodes += glyphCounts[i];
+				continue;
+			}
+
+			// a string spanning pages gets one run per page. glyphs
+			// without a bitmap are left out
+			std::fill(pageNodes.begin(), pageNodes.end(), 0);
+			for (size_t c = 0; c < lengths[i];)
+			{
+				const GlyphStore& store = glyphStore(decodeUtf8(texts[i], lengths[i], c));
+				if (store.state == GlyphState::Resident)
+					++pageNodes[store.cell.page];
+			}
+
+			for (size_t page = 0; page < pageCount; ++page)
+			{
+				if (pageNodes[page] == 0)
+					continue;
+
+				runs.emplace_back(GlyphRenderData{ m_atlas->page(page), nodes, pageNodes[page] });
+				size_t glyph = 0;
+				for (size_t c = 0; c < lengths[i]; ++glyph)
+				{
+					const GlyphStore& store = glyphStore(decodeUtf8(texts[i], lengths[i], c));
+					if (store.state == GlyphState::Resident && store.cell.page == static_cast<int>(page))
+						*nodes++ = layout[glyph];
+				}
+			}
+		}
+		firstRun[count] = static_cast<uint32_t>(runs.size());
+	}
 }
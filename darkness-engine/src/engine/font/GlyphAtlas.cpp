@@ -0,0 +1,64 @@
+#include "engine/font/GlyphAtlas.h"
+#include "tools/ToolsCommon.h"
+#include "tools/Debug.h"
+
+namespace engine
+{
+	GlyphAtlas::GlyphAtlas(
+		Device& device,
+		int cellWidth,
+		int cellHeight,
+		int pageSize,
+		int maxPages)
+		: m_device{ device }
+		, m_cellWidth{ cellWidth }
+		, m_cellHeight{ cellHeight }
+		, m_pageSize{ roundUpToPow2(pageSize) }
+		, m_maxPages{ maxPages }
+	{
+		ASSERT(cellWidth <= m_pageSize && cellHeight <= m_pageSize, "Glyph cell doesn't fit on an atlas page");
+		addPage();
+	}
+
+	void GlyphAtlas::addPage()
+	{
+		// the page is created at its final size and never grows
+		m_pages.emplace_back(engine::make_shared<FontAtlas>(
+			m_device,
+			m_cellWidth,
+			m_cellHeight,
+			m_pageSize,
+			m_pageSize));
+	}
+
+	bool GlyphAtlas::allocate(Cell& cell, bool force)
+	{
+		for (size_t i = 0; i < m_pages.size(); ++i)
+		{
+			if (m_pages[i]->freeCount() > 0)
+			{
+				cell.page = static_cast<int>(i);
+				cell.allocation = m_pages[i]->allocate();
+				return true;
+			}
+		}
+
+		if (static_cast<int>(m_pages.size()) >= m_maxPages && !force)
+			return false;
+
+		addPage();
+		cell.page = static_cast<int>(m_pages.size() - 1);
+		cell.allocation = m_pages.back()->allocate();
+		return true;
+	}
+
+	void GlyphAtlas::free(const Cell& cell)
+	{
+		m_pages[cell.page]->free(cell.allocation);
+	}
+
+	TextureSRV GlyphAtlas::page(size_t index)
+	{
+		return m_pages[index]->atlas();
+	}
+}
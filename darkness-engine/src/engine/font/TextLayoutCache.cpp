@@ -0,0 +1,138 @@
+#include "engine/font/TextLayoutCache.h"
+#include <cstring>
+
+namespace engine
+{
+	TextLayoutCache::TextLayoutCache(size_t maxRuns, size_t maxGlyphs)
+		: m_maxRuns{ maxRuns }
+		, m_maxGlyphs{ maxGlyphs }
+		, m_glyphs{ 0 }
+		, m_head{ InvalidRun }
+		, m_tail{ InvalidRun }
+		, m_hits{ 0 }
+		, m_misses{ 0 }
+	{
+		m_runs.reserve(maxRuns);
+	}
+
+	uint64_t TextLayoutCache::hash(const char* text, size_t length)
+	{
+		// fnv-1a
+		uint64_t result = 0xcbf29ce484222325ull;
+		for (size_t i = 0; i < length; ++i)
+		{
+			result ^= static_cast<uint8_t>(text[i]);
+			result *= 0x100000001b3ull;
+		}
+		return result;
+	}
+
+	const engine::vector<Font::GlyphRenderNodeData>* TextLayoutCache::find(const Key& key, const char* text, size_t length)
+	{
+		auto found = m_lookup.find(key);
+		if (found == m_lookup.end())
+		{
+			++m_misses;
+			return nullptr;
+		}
+
+		auto& run = m_runs[found->second];
+		if (run.text.length() != length || memcmp(run.text.data(), text, length) != 0)
+		{
+			// hash collision. insert() replaces the run
+			++m_misses;
+			return nullptr;
+		}
+
+		if (m_head != found->second)
+		{
+			unlink(found->second);
+			pushFront(found->second);
+		}
+		++m_hits;
+		return &run.nodes;
+	}
+
+	engine::vector<Font::GlyphRenderNodeData>& TextLayoutCache::insert(const Key& key, const char* text, size_t length, size_t glyphCount)
+	{
+		auto found = m_lookup.find(key);
+		if (found != m_lookup.end())
+			evict(found->second);
+
+		while (m_tail != InvalidRun &&
+			(m_lookup.size() >= m_maxRuns || m_glyphs + glyphCount > m_maxGlyphs))
+			evict(m_tail);
+
+		uint32_t index;
+		if (m_freeRuns.size() > 0)
+		{
+			index = m_freeRuns.back();
+			m_freeRuns.pop_back();
+		}
+		else
+		{
+			index = static_cast<uint32_t>(m_runs.size());
+			m_runs.emplace_back();
+		}
+
+		auto& run = m_runs[index];
+		run.key = key;
+		run.text.assign(text, length);
+		run.nodes.resize(glyphCount);
+		m_glyphs += glyphCount;
+
+		m_lookup[key] = index;
+		pushFront(index);
+		return run.nodes;
+	}
+
+	void TextLayoutCache::clear()
+	{
+		m_runs.clear();
+		m_freeRuns.clear();
+		m_lookup.clear();
+		m_head = InvalidRun;
+		m_tail = InvalidRun;
+		m_glyphs = 0;
+	}
+
+	void TextLayoutCache::unlink(uint32_t run)
+	{
+		auto& r = m_runs[run];
+		if (r.previous != InvalidRun)
+			m_runs[r.previous].next = r.next;
+		else
+			m_head = r.next;
+
+		if (r.next != InvalidRun)
+			m_runs[r.next].previous = r.previous;
+		else
+			m_tail = r.previous;
+
+		r.previous = InvalidRun;
+		r.next = InvalidRun;
+	}
+
+	void TextLayoutCache::pushFront(uint32_t run)
+	{
+		auto& r = m_runs[run];
+		r.previous = InvalidRun;
+		r.next = m_head;
+		if (m_head != InvalidRun)
+			m_runs[m_head].previous = run;
+		m_head = run;
+		if (m_tail == InvalidRun)
+			m_tail = run;
+	}
+
+	void TextLayoutCache::evict(uint32_t run)
+	{
+		unlink(run);
+		auto& r = m_runs[run];
+		m_lookup.erase(r.key);
+		m_glyphs -= r.nodes.size();
+		r.text.clear();
+		r.nodes.clear();
+		m_freeRuns.emplace_back(run);
+	}
+}
@@ -10,6 +10,8 @@
 #include "engine/graphics/vulkan/VulkanBarrier.h"
 #endif
 
+#include "engine/graphics/null/NullBarrier.h"
+
 #ifdef __APPLE__
 #include "engine/graphics/metal/MetalBarrier.h"
 #endif
@@ -80,6 +82,17 @@ namespace engine
                 waitSemaphore,
                 signalSemaphore
                 );
+        else if (api == GraphicsApi::Null)
+            m_impl = engine::make_unique<BarrierImplNull>(
+                commandList,
+                flags,
+                resource,
+                before,
+                after,
+                subResource,
+                waitSemaphore,
+                signalSemaphore
+                );
     }
 
     void Barrier::update(
@@ -17,6 +17,8 @@
 #include "engine/graphics/vulkan/VulkanCommandList.h"
 #endif
 
+#include "engine/graphics/null/NullCommandList.h"
+
 #ifdef __APPLE__
 #include "engine/graphics/metal/MetalCommandList.h"
 #endif
@@ -51,6 +53,11 @@ namespace engine
                 const_cast<Device*>(&device), type, name),
                 [&device, this, type](CommandListImplIf* impl)
                 { const_cast<Device*>(&device)->returnCommandList(impl, type, impl->abs().m_name); });
+        else if (api == GraphicsApi::Null)
+            m_impl = engine::shared_ptr<CommandListImplIf>(new CommandListImplNull(
+                const_cast<Device*>(&device), type, name),
+                [&device, this, type](CommandListImplIf* impl)
+                { const_cast<Device*>(&device)->returnCommandList(impl, type, impl->abs().m_name); });
 
         m_impl->abs().m_device = &device;
         m_impl->abs().m_name = name;
@@ -1313,7 +1320,7 @@ namespace engine
         implementation::PipelineImplIf* pipelineImpl,
         shaders::PipelineConfiguration* configuration)
     {
-        if (m_impl->abs().m_api == GraphicsApi::DX12)
+        if (m_impl->abs().m_api == GraphicsApi::DX12 || m_impl->abs().m_api == GraphicsApi::Null)
         {
             setDebugBuffers(configuration);
             m_impl->bindPipe(pipelineImpl, configuration);
@@ -1380,7 +1387,24 @@ namespace engine
 
     void CommandList::savePipeline(shaders::PipelineConfiguration* configuration)
     {
-        auto saveBinding = [this](shaders::Shader* shader, bool pixelShader)
+        // transitions are recorded here and flushed as one batched barrier
+        // call by the backend right before the draw or dispatch
+        TransitionStatistics statistics;
+
+        auto depthState = (m_impl->abs().m_api == GraphicsApi::Vulkan) ?
+            ResourceState::PixelShaderResource :
+            ResourceState::GenericRead;
+
+        auto transitionBuffer = [this, &statistics](Buffer buffer, ResourceState state)
+        {
+            ++statistics.requested;
+            if (buffer.state() == state)
+                ++statistics.skipped;
+            else
+                this->transition(buffer, state);
+        };
+
+        auto saveBinding = [this, &statistics, depthState, &transitionBuffer](shaders::Shader* shader, bool pixelShader)
         {
             const auto& srvs = shader->texture_srvs();
             const auto& uavs = shader->texture_uavs();
@@ -1392,46 +1416,16 @@ namespace engine
             const auto& bindless_bsrvs = shader->bindless_buffer_srvs();
             const auto& bindless_buavs = shader->bindless_buffer_uavs();
 
+            auto srvState = pixelShader ? ResourceState::PixelShaderResource : ResourceState::NonPixelShaderResource;
+
             for (auto&& srv : srvs)
             {
                 if (srv.valid())
                 {
                     if (srv.texture().description().usage != ResourceUsage::DepthStencil)
-                    {
-                        auto localSubRes = srv.subResource();
-
-                        uint32_t sliceCount = localSubRes.arraySliceCount == AllArraySlices ?
-                            static_cast<uint32_t>(srv.texture().arraySlices()) :
-                            static_cast<uint32_t>(std::min(static_cast<uint32_t>(localSubRes.arraySliceCount), static_cast<uint32_t>(srv.texture().arraySlices()) - localSubRes.firstArraySlice));
-
-                        uint32_t mipCount = localSubRes.mipCount == AllMipLevels ?
-                            static_cast<uint32_t>(srv.texture().mipLevels()) :
-                            static_cast<uint32_t>(std::min(static_cast<uint32_t>(localSubRes.mipCount), static_cast<uint32_t>(srv.texture().mipLevels()) - localSubRes.firstMipLevel));
-
-                        for (uint32_t slice = localSubRes.firstArraySlice; slice < localSubRes.firstArraySlice + sliceCount; ++slice)
-                        {
-                            for (uint32_t mip = localSubRes.firstMipLevel; mip < localSubRes.firstMipLevel + mipCount; ++mip)
-                            {
-                                if (srv.texture().state(slice, mip) != ResourceState::Common)
-                                    this->transition(srv.texture(), 
-                                        pixelShader ? ResourceState::PixelShaderResource : ResourceState::NonPixelShaderResource,
-                                        SubResource{ mip, 1, slice, 1 });
-                                else
-                                    srv.texture().state(slice, mip, pixelShader ? ResourceState::PixelShaderResource : ResourceState::NonPixelShaderResource);
-                            }
-                        }
-                    }
+                        this->transitionBinding(srv.texture(), srv.subResource(), srvState, true, statistics);
                     else
-                    {
-                        if (m_impl->abs().m_api == GraphicsApi::DX12)
-                        {
-                            this->transition(srv.texture(), ResourceState::GenericRead);
-                        }
-                        else if (m_impl->abs().m_api == GraphicsApi::Vulkan)
-                        {
-                            this->transition(srv.texture(), ResourceState::PixelShaderResource);
-                        }
-                    }
+                        this->transitionBinding(srv.texture(), SubResource(), depthState, false, statistics);
                 }
             }
 
@@ -1440,27 +1434,9 @@ namespace engine
                 if (uav.valid())
                 {
                     if (uav.texture().description().usage != ResourceUsage::DepthStencil)
-                    {
-                        auto localSubRes = uav.subResource();
-
-                        uint32_t sliceCount = localSubRes.arraySliceCount == AllArraySlices ?
-                            static_cast<uint32_t>(uav.texture().arraySlices()) :
-                            static_cast<uint32_t>(std::min(static_cast<uint32_t>(localSubRes.arraySliceCount), static_cast<uint32_t>(uav.texture().arraySlices()) - localSubRes.firstArraySlice));
-
-                        uint32_t mipCount = localSubRes.mipCount == AllMipLevels ?
-                            static_cast<uint32_t>(uav.texture().mipLevels()) :
-                            static_cast<uint32_t>(std::min(static_cast<uint32_t>(localSubRes.mipCount), static_cast<uint32_t>(uav.texture().mipLevels()) - localSubRes.firstMipLevel));
-
-                        for (uint32_t slice = localSubRes.firstArraySlice; slice < localSubRes.firstArraySlice + sliceCount; ++slice)
-                        {
-                            for (uint32_t mip = localSubRes.firstMipLevel; mip < localSubRes.firstMipLevel + mipCount; ++mip)
-                            {
-                                this->transition(uav.texture(), ResourceState::UnorderedAccess, SubResource{ mip, 1, slice, 1 });
-                            }
-                        }
-                    }
+                        this->transitionBinding(uav.texture(), uav.subResource(), ResourceState::UnorderedAccess, false, statistics);
                     else
-                        this->transition(uav.texture(), ResourceState::UnorderedAccess);
+                        this->transitionBinding(uav.texture(), SubResource(), ResourceState::UnorderedAccess, false, statistics);
                 }
             }
             
@@ -1469,11 +1445,14 @@ namespace engine
                 if (bsrv.valid())
                 {
                     if (bsrv.buffer().state() != ResourceState::Common)
-                        this->transition(bsrv.buffer(), ResourceState::GenericRead);
+                        transitionBuffer(bsrv.buffer(), ResourceState::GenericRead);
                         //this->transition(bsrv.buffer(), pixelShader ? ResourceState::PixelShaderResource : ResourceState::NonPixelShaderResource);
                     else
+                    {
+                        ++statistics.requested;
                         bsrv.buffer().state(ResourceState::GenericRead);
                         //bsrv.buffer().state(pixelShader ? ResourceState::PixelShaderResource : ResourceState::NonPixelShaderResource);
+                    }
                 }
             }
             
@@ -1481,7 +1460,7 @@ namespace engine
             { 
                 if (buav.valid())
                 {
-                    this->transition(buav.buffer(), ResourceState::UnorderedAccess);
+                    transitionBuffer(buav.buffer(), ResourceState::UnorderedAccess);
                 }
             }
 
@@ -1498,38 +1477,10 @@ namespace engine
 						TextureSRV texsrv = srv.get(i);
 						if (texsrv.valid())
 						{
-							auto localSubRes = texsrv.subResource();
-
-							uint32_t sliceCount = localSubRes.arraySliceCount == AllArraySlices ?
-								static_cast<uint32_t>(texsrv.texture().arraySlices()) :
-								static_cast<uint32_t>(std::min(static_cast<uint32_t>(localSubRes.arraySliceCount), static_cast<uint32_t>(texsrv.texture().arraySlices()) - localSubRes.firstArraySlice));
-
-							uint32_t mipCount = localSubRes.mipCount == AllMipLevels ?
-								static_cast<uint32_t>(texsrv.texture().mipLevels()) :
-								static_cast<uint32_t>(std::min(static_cast<uint32_t>(localSubRes.mipCount), static_cast<uint32_t>(texsrv.texture().mipLevels()) - localSubRes.firstMipLevel));
-
-							for (uint32_t slice = localSubRes.firstArraySlice; slice < localSubRes.firstArraySlice + sliceCount; ++slice)
-							{
-								for (uint32_t mip = localSubRes.firstMipLevel; mip < localSubRes.firstMipLevel + mipCount; ++mip)
-								{
-									if (texsrv.texture().description().usage != ResourceUsage::DepthStencil)
-										this->transition(
-											texsrv.texture(),
-											pixelShader ? ResourceState::PixelShaderResource : ResourceState::NonPixelShaderResource,
-											SubResource{ mip, 1, slice, 1 });
-                                    else
-                                    {
-                                        if (m_impl->abs().m_api == GraphicsApi::DX12)
-                                        {
-                                            this->transition(texsrv.texture(), ResourceState::GenericRead);
-                                        }
-                                        else if (m_impl->abs().m_api == GraphicsApi::Vulkan)
-                                        {
-                                            this->transition(texsrv.texture(), ResourceState::PixelShaderResource);
-                                        }
-                                    }
-								}
-							}
+							if (texsrv.texture().description().usage != ResourceUsage::DepthStencil)
+								this->transitionBinding(texsrv.texture(), texsrv.subResource(), srvState, false, statistics);
+							else
+								this->transitionBinding(texsrv.texture(), SubResource(), depthState, false, statistics);
 						}
 					}
 					srv.change(false);
@@ -1546,29 +1497,10 @@ namespace engine
 						TextureUAV texsrv = uav.get(i);
 						if (texsrv.valid())
 						{
-							auto localSubRes = texsrv.subResource();
-
-							uint32_t sliceCount = localSubRes.arraySliceCount == AllArraySlices ?
-								static_cast<uint32_t>(texsrv.texture().arraySlices()) :
-								static_cast<uint32_t>(std::min(static_cast<uint32_t>(localSubRes.arraySliceCount), static_cast<uint32_t>(texsrv.texture().arraySlices()) - localSubRes.firstArraySlice));
-
-							uint32_t mipCount = localSubRes.mipCount == AllMipLevels ?
-								static_cast<uint32_t>(texsrv.texture().mipLevels()) :
-								static_cast<uint32_t>(std::min(static_cast<uint32_t>(localSubRes.mipCount), static_cast<uint32_t>(texsrv.texture().mipLevels()) - localSubRes.firstMipLevel));
-
-							for (uint32_t slice = localSubRes.firstArraySlice; slice < localSubRes.firstArraySlice + sliceCount; ++slice)
-							{
-								for (uint32_t mip = localSubRes.firstMipLevel; mip < localSubRes.firstMipLevel + mipCount; ++mip)
-								{
-									if (texsrv.texture().description().usage != ResourceUsage::DepthStencil)
-										this->transition(
-											texsrv.texture(),
-											ResourceState::UnorderedAccess,
-											SubResource{ mip, 1, slice, 1 });
-									else
-										this->transition(texsrv.texture(), ResourceState::UnorderedAccess);
-								}
-							}
+							if (texsrv.texture().description().usage != ResourceUsage::DepthStencil)
+								this->transitionBinding(texsrv.texture(), texsrv.subResource(), ResourceState::UnorderedAccess, false, statistics);
+							else
+								this->transitionBinding(texsrv.texture(), SubResource(), ResourceState::UnorderedAccess, false, statistics);
 						}
 					}
 					//uav.change(false);
@@ -1584,7 +1516,7 @@ namespace engine
 					{
 						if (bsrv.get(i).valid())
 						{
-							this->transition(bsrv.get(i).buffer(), pixelShader ? ResourceState::PixelShaderResource : ResourceState::NonPixelShaderResource);
+							transitionBuffer(bsrv.get(i).buffer(), srvState);
 						}
 					}
 					//bsrv.change(false);
@@ -1600,7 +1532,7 @@ namespace engine
 					{
 						if (buav.get(i).valid())
 						{
-							this->transition(buav.get(i).buffer(), ResourceState::UnorderedAccess);
+							transitionBuffer(buav.get(i).buffer(), ResourceState::UnorderedAccess);
 						}
 					}
 					//buav.change(false);
@@ -1661,6 +1593,11 @@ namespace engine
                     this->transition(range.buffer->buffer(), ResourceState::VertexAndConstantBuffer);
             }*/
         }
+
+        auto& counters = m_impl->abs().m_device->transitionCounters();
+        counters.requested += statistics.requested;
+        counters.skipped += statistics.skipped;
+        counters.wholeResource += statistics.wholeResource;
     }
 
     void CommandList::setViewPorts(const engine::vector<Viewport>& viewports)
@@ -2251,6 +2188,64 @@ namespace engine
         }
     }
 
+    void CommandList::transitionBinding(
+        Texture texture,
+        const SubResource& subResource,
+        ResourceState state,
+        bool promoteCommon,
+        TransitionStatistics& statistics)
+    {
+        ++statistics.requested;
+
+        uint32_t sliceCount = subResource.arraySliceCount == AllArraySlices ?
+            static_cast<uint32_t>(texture.arraySlices()) :
+            static_cast<uint32_t>(std::min(static_cast<uint32_t>(subResource.arraySliceCount), static_cast<uint32_t>(texture.arraySlices()) - subResource.firstArraySlice));
+
+        uint32_t mipCount = subResource.mipCount == AllMipLevels ?
+            static_cast<uint32_t>(texture.mipLevels()) :
+            static_cast<uint32_t>(std::min(static_cast<uint32_t>(subResource.mipCount), static_cast<uint32_t>(texture.mipLevels()) - subResource.firstMipLevel));
+
+        // the view covers the whole texture and the texture is in one state.
+        // skip it or do it with one whole resource transition
+        ResourceState current;
+        if (subResource.firstArraySlice == 0 &&
+            subResource.firstMipLevel == 0 &&
+            sliceCount == static_cast<uint32_t>(texture.arraySlices()) &&
+            mipCount == static_cast<uint32_t>(texture.mipLevels()) &&
+            texture.uniformState(current))
+        {
+            if (current == state)
+                ++statistics.skipped;
+            else if (promoteCommon && current == ResourceState::Common)
+                texture.state(state);
+            else
+            {
+                ++statistics.wholeResource;
+                transition(texture, state);
+            }
+            return;
+        }
+
+        bool changed = false;
+        for (uint32_t slice = subResource.firstArraySlice; slice < subResource.firstArraySlice + sliceCount; ++slice)
+        {
+            for (uint32_t mip = subResource.firstMipLevel; mip < subResource.firstMipLevel + mipCount; ++mip)
+            {
+                current = texture.state(slice, mip);
+                if (current == state)
+                    continue;
+
+                changed = true;
+                if (promoteCommon && current == ResourceState::Common)
+                    texture.state(slice, mip, state);
+                else
+                    transition(texture, state, SubResource{ mip, 1, slice, 1 });
+            }
+        }
+        if (!changed)
+            ++statistics.skipped;
+    }
+
     void CommandList::transitionCommonSRV(TextureSRV srv, ResourceState state)
     {
         auto localSubRes = srv.subResource();
@@ -16,6 +16,8 @@
 #include "engine/graphics/vulkan/VulkanCpuMarker.h"
 #endif
 
+#include "engine/graphics/null/NullGpuMarker.h"
+
 std::atomic<uint64_t> GlobalUniqueHandleId = 1;
 
 namespace engine
@@ -451,6 +453,8 @@ namespace engine
             ptr = new implementation::GpuMarkerImplDX12(cmd, msg);
         else if (m_api == GraphicsApi::Vulkan)
             ptr = new implementation::GpuMarkerImplVulkan(cmd, msg);
+        else if (m_api == GraphicsApi::Null)
+            ptr = new implementation::GpuMarkerImplNull(cmd, msg);
     }
 
     GpuMarker::~GpuMarker()
@@ -459,6 +463,8 @@ namespace engine
             delete reinterpret_cast<implementation::GpuMarkerImplDX12*>(ptr);
         else if (m_api == GraphicsApi::Vulkan)
             delete reinterpret_cast<implementation::GpuMarkerImplVulkan*>(ptr);
+        else if (m_api == GraphicsApi::Null)
+            delete reinterpret_cast<implementation::GpuMarkerImplNull*>(ptr);
         ptr = nullptr;
     }
 
@@ -469,6 +475,8 @@ namespace engine
             ptr = new implementation::CpuMarkerImplDX12(msg);
         else if (m_api == GraphicsApi::Vulkan)
             ptr = new implementation::CpuMarkerImplVulkan(msg);
+        else if (m_api == GraphicsApi::Null)
+            ptr = new implementation::CpuMarkerImplNull(msg);
     }
 
     CpuMarker::~CpuMarker()
@@ -477,6 +485,8 @@ namespace engine
             delete reinterpret_cast<implementation::CpuMarkerImplDX12*>(ptr);
         else if (m_api == GraphicsApi::Vulkan)
             delete reinterpret_cast<implementation::CpuMarkerImplVulkan*>(ptr);
+        else if (m_api == GraphicsApi::Null)
+            delete reinterpret_cast<implementation::CpuMarkerImplNull*>(ptr);
         ptr = nullptr;
     }
 }
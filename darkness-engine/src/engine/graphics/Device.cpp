@@ -31,6 +31,11 @@
 #include "engine/graphics/vulkan/VulkanCommandList.h"
 #endif
 
+#include "engine/graphics/null/NullDevice.h"
+#include "engine/graphics/null/NullResources.h"
+#include "engine/graphics/null/NullPipeline.h"
+#include "engine/graphics/null/NullCommandList.h"
+
 #ifdef __APPLE__
 #include "engine/graphics/metal/MetalDevice.h"
 #include "engine/graphics/metal/MetalBuffer.h"
@@ -53,6 +58,8 @@ namespace engine
         : m_api{ api }
         , m_impl( (m_api == GraphicsApi::DX12) ? 
             static_pointer_cast<DeviceImplIf>(engine::shared_ptr<implementation::DeviceImplDX12>(new implementation::DeviceImplDX12(window, preferredAdapter))) :
+            (m_api == GraphicsApi::Null) ?
+                static_pointer_cast<DeviceImplIf>(engine::shared_ptr<implementation::DeviceImplNull>(new implementation::DeviceImplNull(window))) :
             static_pointer_cast<DeviceImplIf>(engine::shared_ptr<implementation::DeviceImplVulkan>(new implementation::DeviceImplVulkan(window))) )
         , m_mutex{}
         , m_swapChain{}
@@ -475,6 +482,7 @@ namespace engine
         //m_queue->signal(signalSemaphore);
         m_queue->present(signalSemaphore, swapChain, chainIndex);
 
+        resolveTransitionStatistics();
         ++m_frameNumber;
         m_queue->signal(m_frameFence, m_frameNumber);
 
@@ -483,10 +491,20 @@ namespace engine
 
     void Device::passivePresent()
     {
+        resolveTransitionStatistics();
         ++m_frameNumber;
         m_queue->signal(m_frameFence, m_frameNumber);
     }
 
+    void Device::resolveTransitionStatistics()
+    {
+        m_transitionStatistics.requested = m_transitionCounters.requested.exchange(0);
+        m_transitionStatistics.skipped = m_transitionCounters.skipped.exchange(0);
+        m_transitionStatistics.wholeResource = m_transitionCounters.wholeResource.exchange(0);
+        m_transitionStatistics.barriers = m_transitionCounters.barriers.exchange(0);
+        m_transitionStatistics.flushes = m_transitionCounters.flushes.exchange(0);
+    }
+
     void Device::getNewFrame()
     {
         // if we have less than 2 CPU generated frames
@@ -620,6 +638,8 @@ namespace engine
 		BufferOwner buffer(
             (m_api == GraphicsApi::DX12) ? 
                 static_pointer_cast<BufferImplIf>(engine::make_shared<BufferImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), desc)) : 
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<BufferImplIf>(engine::make_shared<BufferImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), desc)) :
                 static_pointer_cast<BufferImplIf>(engine::make_shared<BufferImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), desc)),
 			[&](engine::shared_ptr<BufferImplIf> im)
 			{
@@ -642,6 +662,8 @@ namespace engine
         return BufferSRVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<BufferSRVImplIf>(engine::make_shared<BufferSRVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), buffer, desc)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<BufferSRVImplIf>(engine::make_shared<BufferSRVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), buffer, desc)) :
                 static_pointer_cast<BufferSRVImplIf>(engine::make_shared<BufferSRVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), buffer, desc)),
 			[&](engine::shared_ptr<BufferSRVImplIf> im)
 			{
@@ -661,6 +683,8 @@ namespace engine
         return BufferUAVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<BufferUAVImplIf>(engine::make_shared<BufferUAVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), buffer, copyDesc)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<BufferUAVImplIf>(engine::make_shared<BufferUAVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), buffer, copyDesc)) :
                 static_pointer_cast<BufferUAVImplIf>(engine::make_shared<BufferUAVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), buffer, copyDesc)),
 			[&](engine::shared_ptr<BufferUAVImplIf> im)
 			{
@@ -678,6 +702,8 @@ namespace engine
 		return BufferIBVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<BufferIBVImplIf>(engine::make_shared<BufferIBVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), buffer, temp)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<BufferIBVImplIf>(engine::make_shared<BufferIBVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), buffer, temp)) :
                 static_pointer_cast<BufferIBVImplIf>(engine::make_shared<BufferIBVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), buffer, temp)),
 			[&](engine::shared_ptr<BufferIBVImplIf> im)
 			{
@@ -693,6 +719,8 @@ namespace engine
 		return BufferCBVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<BufferCBVImplIf>(engine::make_shared<BufferCBVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), buffer, desc)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<BufferCBVImplIf>(engine::make_shared<BufferCBVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), buffer, desc)) :
                 static_pointer_cast<BufferCBVImplIf>(engine::make_shared<BufferCBVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), buffer, desc)),
 			[&](engine::shared_ptr<BufferCBVImplIf> im)
 			{
@@ -710,6 +738,8 @@ namespace engine
 		return BufferVBVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<BufferVBVImplIf>(engine::make_shared<BufferVBVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), buffer, temp)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<BufferVBVImplIf>(engine::make_shared<BufferVBVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), buffer, temp)) :
                 static_pointer_cast<BufferVBVImplIf>(engine::make_shared<BufferVBVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), buffer, temp)),
 			[&](engine::shared_ptr<BufferVBVImplIf> im)
 			{
@@ -726,6 +756,8 @@ namespace engine
 		auto temp =  BufferSRVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<BufferSRVImplIf>(engine::make_shared<BufferSRVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), buffer, desc)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<BufferSRVImplIf>(engine::make_shared<BufferSRVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), buffer, desc)) :
                 static_pointer_cast<BufferSRVImplIf>(engine::make_shared<BufferSRVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), buffer, desc)),
 			[&](engine::shared_ptr<BufferSRVImplIf> im)
 			{
@@ -748,6 +780,8 @@ namespace engine
 		return BufferUAVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<BufferUAVImplIf>(engine::make_shared<BufferUAVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), buffer, copyDesc)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<BufferUAVImplIf>(engine::make_shared<BufferUAVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), buffer, copyDesc)) :
                 static_pointer_cast<BufferUAVImplIf>(engine::make_shared<BufferUAVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), buffer, copyDesc)),
 			[&](engine::shared_ptr<BufferUAVImplIf> im)
 			{
@@ -767,6 +801,8 @@ namespace engine
 		return BufferIBVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<BufferIBVImplIf>(engine::make_shared<BufferIBVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), buffer, temp)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<BufferIBVImplIf>(engine::make_shared<BufferIBVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), buffer, temp)) :
                 static_pointer_cast<BufferIBVImplIf>(engine::make_shared<BufferIBVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), buffer, temp)),
 			[&](engine::shared_ptr<BufferIBVImplIf> im)
 			{
@@ -784,6 +820,8 @@ namespace engine
 		return BufferCBVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<BufferCBVImplIf>(engine::make_shared<BufferCBVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), buffer, desc)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<BufferCBVImplIf>(engine::make_shared<BufferCBVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), buffer, desc)) :
                 static_pointer_cast<BufferCBVImplIf>(engine::make_shared<BufferCBVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), buffer, desc)),
 			[&](engine::shared_ptr<BufferCBVImplIf> im)
 			{
@@ -803,6 +841,8 @@ namespace engine
 		return BufferVBVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<BufferVBVImplIf>(engine::make_shared<BufferVBVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), buffer, temp)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<BufferVBVImplIf>(engine::make_shared<BufferVBVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), buffer, temp)) :
                 static_pointer_cast<BufferVBVImplIf>(engine::make_shared<BufferVBVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), buffer, temp)),
 			[&](engine::shared_ptr<BufferVBVImplIf> im)
 			{
@@ -853,6 +893,8 @@ namespace engine
 		return RaytracingAccelerationStructureOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<RaytracingAccelerationStructureImplIf>(engine::make_shared<RaytracingAccelerationStructureImplDX12>(*this, vertexBuffer, indexBuffer, desc)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<RaytracingAccelerationStructureImplIf>(engine::make_shared<RaytracingAccelerationStructureImplNull>(*this, vertexBuffer, indexBuffer, desc)) :
                 static_pointer_cast<RaytracingAccelerationStructureImplIf>(engine::make_shared<RaytracingAccelerationStructureImplVulkan>(*this, vertexBuffer, indexBuffer, desc)),
 			[&](engine::shared_ptr<RaytracingAccelerationStructureImplIf> im)
 		{
@@ -913,6 +955,8 @@ namespace engine
         return BindlessBufferSRVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<BindlessBufferSRVImplIf>(engine::make_shared<BindlessBufferSRVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()))) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<BindlessBufferSRVImplIf>(engine::make_shared<BindlessBufferSRVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()))) :
                 static_pointer_cast<BindlessBufferSRVImplIf>(engine::make_shared<BindlessBufferSRVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()))),
             [&](engine::shared_ptr<BindlessBufferSRVImplIf> im)
             {
@@ -925,6 +969,8 @@ namespace engine
         return BindlessBufferUAVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<BindlessBufferUAVImplIf>(engine::make_shared<BindlessBufferUAVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()))) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<BindlessBufferUAVImplIf>(engine::make_shared<BindlessBufferUAVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()))) :
                 static_pointer_cast<BindlessBufferUAVImplIf>(engine::make_shared<BindlessBufferUAVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()))),
             [&](engine::shared_ptr<BindlessBufferUAVImplIf> im)
             {
@@ -981,6 +1027,8 @@ namespace engine
 		return TextureSRVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<TextureSRVImplIf>(engine::make_shared<TextureSRVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), texture, desc)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<TextureSRVImplIf>(engine::make_shared<TextureSRVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), texture, desc)) :
                 static_pointer_cast<TextureSRVImplIf>(engine::make_shared<TextureSRVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), texture, desc)),
 			[&](engine::shared_ptr<TextureSRVImplIf> im) {
 			m_returnedTexturesSRV.push(ReturnedResourceTextureSRV{ im, getResourceReturnFrame() }); },
@@ -998,6 +1046,8 @@ namespace engine
 		return TextureUAVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<TextureUAVImplIf>(engine::make_shared<TextureUAVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), texture, descCopy)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<TextureUAVImplIf>(engine::make_shared<TextureUAVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), texture, descCopy)) :
                 static_pointer_cast<TextureUAVImplIf>(engine::make_shared<TextureUAVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), texture, descCopy)),
 			[&](engine::shared_ptr<TextureUAVImplIf> im) {
 			m_returnedTexturesUAV.push(ReturnedResourceTextureUAV{ im, getResourceReturnFrame() }); },
@@ -1012,6 +1062,8 @@ namespace engine
 		return TextureDSVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<TextureDSVImplIf>(engine::make_shared<TextureDSVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), texture, desc, subResources)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<TextureDSVImplIf>(engine::make_shared<TextureDSVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), texture, desc, subResources)) :
                 static_pointer_cast<TextureDSVImplIf>(engine::make_shared<TextureDSVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), texture, desc, subResources)),
 			[&](engine::shared_ptr<TextureDSVImplIf> im) {
 			m_returnedTexturesDSV.push(ReturnedResourceTextureDSV{ im, getResourceReturnFrame() }); },
@@ -1026,6 +1078,8 @@ namespace engine
 		return TextureRTVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<TextureRTVImplIf>(engine::make_shared<TextureRTVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), texture, desc, subResources)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<TextureRTVImplIf>(engine::make_shared<TextureRTVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), texture, desc, subResources)) :
                 static_pointer_cast<TextureRTVImplIf>(engine::make_shared<TextureRTVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), texture, desc, subResources)),
 			[&](engine::shared_ptr<TextureRTVImplIf> im) {
 			m_returnedTexturesRTV.push(ReturnedResourceTextureRTV{ im, getResourceReturnFrame() }); },
@@ -1038,6 +1092,8 @@ namespace engine
 		return TextureSRVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<TextureSRVImplIf>(engine::make_shared<TextureSRVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), texture, desc)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<TextureSRVImplIf>(engine::make_shared<TextureSRVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), texture, desc)) :
                 static_pointer_cast<TextureSRVImplIf>(engine::make_shared<TextureSRVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), texture, desc)),
 			[&](engine::shared_ptr<TextureSRVImplIf> im) {
 			m_returnedTexturesSRV.push(ReturnedResourceTextureSRV{ im, getResourceReturnFrame() }); },
@@ -1050,6 +1106,8 @@ namespace engine
 		return TextureUAVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<TextureUAVImplIf>(engine::make_shared<TextureUAVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), texture, desc)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<TextureUAVImplIf>(engine::make_shared<TextureUAVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), texture, desc)) :
                 static_pointer_cast<TextureUAVImplIf>(engine::make_shared<TextureUAVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), texture, desc)),
 			[&](engine::shared_ptr<TextureUAVImplIf> im) {
 			m_returnedTexturesUAV.push(ReturnedResourceTextureUAV{ im, getResourceReturnFrame() }); },
@@ -1062,6 +1120,8 @@ namespace engine
 		return TextureDSVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<TextureDSVImplIf>(engine::make_shared<TextureDSVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), texture, desc, subResources)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<TextureDSVImplIf>(engine::make_shared<TextureDSVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), texture, desc, subResources)) :
                 static_pointer_cast<TextureDSVImplIf>(engine::make_shared<TextureDSVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), texture, desc, subResources)),
 			[&](engine::shared_ptr<TextureDSVImplIf> im) {
 			m_returnedTexturesDSV.push(ReturnedResourceTextureDSV{ im, getResourceReturnFrame() }); },
@@ -1074,6 +1134,8 @@ namespace engine
 		return TextureRTVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<TextureRTVImplIf>(engine::make_shared<TextureRTVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), texture, desc, subResources)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<TextureRTVImplIf>(engine::make_shared<TextureRTVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), texture, desc, subResources)) :
                 static_pointer_cast<TextureRTVImplIf>(engine::make_shared<TextureRTVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), texture, desc, subResources)),
 			[&](engine::shared_ptr<TextureRTVImplIf> im) {
 			m_returnedTexturesRTV.push(ReturnedResourceTextureRTV{ im, getResourceReturnFrame() }); },
@@ -1086,6 +1148,8 @@ namespace engine
 		return TextureSRVOwner(
             (m_api == GraphicsApi::DX12) ?
             static_pointer_cast<TextureSRVImplIf>(engine::make_shared<TextureSRVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), texture, TextureDescription{ texture.resource().description() })) :
+            (m_api == GraphicsApi::Null) ?
+                static_pointer_cast<TextureSRVImplIf>(engine::make_shared<TextureSRVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), texture, TextureDescription{ texture.resource().description() })) :
             static_pointer_cast<TextureSRVImplIf>(engine::make_shared<TextureSRVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), texture, TextureDescription{ texture.resource().description() })),
 			[&](engine::shared_ptr<TextureSRVImplIf> im) {
 			m_returnedTexturesSRV.push(ReturnedResourceTextureSRV{ im, getResourceReturnFrame() }); },
@@ -1098,6 +1162,8 @@ namespace engine
 		return TextureUAVOwner(
             (m_api == GraphicsApi::DX12) ?
             static_pointer_cast<TextureUAVImplIf>(engine::make_shared<TextureUAVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), texture, TextureDescription{ texture.resource().description() })) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<TextureUAVImplIf>(engine::make_shared<TextureUAVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), texture, TextureDescription{ texture.resource().description() })) :
                 static_pointer_cast<TextureUAVImplIf>(engine::make_shared<TextureUAVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), texture, TextureDescription{ texture.resource().description() })),
 			[&](engine::shared_ptr<TextureUAVImplIf> im) {
 			m_returnedTexturesUAV.push(ReturnedResourceTextureUAV{ im, getResourceReturnFrame() }); },
@@ -1110,6 +1176,8 @@ namespace engine
 		return TextureDSVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<TextureDSVImplIf>(engine::make_shared<TextureDSVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), texture, TextureDescription{ texture.resource().description() }, subResources)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<TextureDSVImplIf>(engine::make_shared<TextureDSVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), texture, TextureDescription{ texture.resource().description() }, subResources)) :
                 static_pointer_cast<TextureDSVImplIf>(engine::make_shared<TextureDSVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), texture, TextureDescription{ texture.resource().description() }, subResources)),
 			[&](engine::shared_ptr<TextureDSVImplIf> im) {
 			m_returnedTexturesDSV.push(ReturnedResourceTextureDSV{ im, getResourceReturnFrame() }); },
@@ -1122,6 +1190,8 @@ namespace engine
 		return TextureRTVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<TextureRTVImplIf>(engine::make_shared<TextureRTVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), texture, TextureDescription{ texture.resource().description() }, subResources)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<TextureRTVImplIf>(engine::make_shared<TextureRTVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), texture, TextureDescription{ texture.resource().description() }, subResources)) :
                 static_pointer_cast<TextureRTVImplIf>(engine::make_shared<TextureRTVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), texture, TextureDescription{ texture.resource().description() }, subResources)),
 			[&](engine::shared_ptr<TextureRTVImplIf> im) {
 			m_returnedTexturesRTV.push(ReturnedResourceTextureRTV{ im, getResourceReturnFrame() }); },
@@ -1134,6 +1204,8 @@ namespace engine
 		return TextureSRVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<TextureSRVImplIf>(engine::make_shared<TextureSRVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), texture, TextureDescription{ texture.resource().description() }, subResources)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<TextureSRVImplIf>(engine::make_shared<TextureSRVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), texture, TextureDescription{ texture.resource().description() }, subResources)) :
                 static_pointer_cast<TextureSRVImplIf>(engine::make_shared<TextureSRVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), texture, TextureDescription{ texture.resource().description() }, subResources)),
 			[&](engine::shared_ptr<TextureSRVImplIf> im) {
 			m_returnedTexturesSRV.push(ReturnedResourceTextureSRV{ im, getResourceReturnFrame() }); },
@@ -1146,6 +1218,8 @@ namespace engine
 		return TextureSRVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<TextureSRVImplIf>(engine::make_shared<TextureSRVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), texture, desc, subResources)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<TextureSRVImplIf>(engine::make_shared<TextureSRVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), texture, desc, subResources)) :
                 static_pointer_cast<TextureSRVImplIf>(engine::make_shared<TextureSRVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), texture, desc, subResources)),
 			[&](engine::shared_ptr<TextureSRVImplIf> im) {
 			m_returnedTexturesSRV.push(ReturnedResourceTextureSRV{ im, getResourceReturnFrame() }); },
@@ -1158,6 +1232,8 @@ namespace engine
 		return TextureUAVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<TextureUAVImplIf>(engine::make_shared<TextureUAVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), texture, TextureDescription{ texture.resource().description() }, subResources)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<TextureUAVImplIf>(engine::make_shared<TextureUAVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), texture, TextureDescription{ texture.resource().description() }, subResources)) :
                 static_pointer_cast<TextureUAVImplIf>(engine::make_shared<TextureUAVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), texture, TextureDescription{ texture.resource().description() }, subResources)),
 			[&](engine::shared_ptr<TextureUAVImplIf> im) {
 			m_returnedTexturesUAV.push(ReturnedResourceTextureUAV{ im, getResourceReturnFrame() }); },
@@ -1170,6 +1246,8 @@ namespace engine
 		return TextureUAVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<TextureUAVImplIf>(engine::make_shared<TextureUAVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), texture, desc, subResources)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<TextureUAVImplIf>(engine::make_shared<TextureUAVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), texture, desc, subResources)) :
                 static_pointer_cast<TextureUAVImplIf>(engine::make_shared<TextureUAVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), texture, desc, subResources)),
 			[&](engine::shared_ptr<TextureUAVImplIf> im) {
 			m_returnedTexturesUAV.push(ReturnedResourceTextureUAV{ im, getResourceReturnFrame() }); },
@@ -1251,6 +1329,26 @@ namespace engine
         return m_resourceCache->createMesh(*this, key, pathClean(filename), meshIndex);
     }
 
+    engine::shared_ptr<MeshRequest> Device::requestMesh(
+        ResourceKey key,
+        const string& filename,
+        ResidencyPriority priority)
+    {
+        return m_resourceCache->requestMesh(key, pathClean(filename), priority);
+    }
+
+    engine::shared_ptr<SubMeshInstance> Device::createMesh(
+        MeshRequest& request,
+        uint32_t meshIndex)
+    {
+        return m_resourceCache->createMesh(*this, request, meshIndex);
+    }
+
+    void Device::streamMeshes()
+    {
+        m_resourceCache->streamMeshes(*this);
+    }
+
 	TextureSRVOwner Device::createTextureSRV(const TextureDSVOwner& texture) const
     {
         TextureDescription desc = { texture.resource().texture().description() };
@@ -1273,6 +1371,8 @@ namespace engine
 		return TextureSRVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<TextureSRVImplIf>(engine::make_shared<TextureSRVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()), textureOwner, desc)) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<TextureSRVImplIf>(engine::make_shared<TextureSRVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()), textureOwner, desc)) :
                 static_pointer_cast<TextureSRVImplIf>(engine::make_shared<TextureSRVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()), textureOwner, desc)),
 			[&](engine::shared_ptr<TextureSRVImplIf> im) {
 			m_returnedTexturesSRV.push(ReturnedResourceTextureSRV{ im, getResourceReturnFrame() }); },
@@ -1285,6 +1385,8 @@ namespace engine
         return BindlessTextureSRVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<BindlessTextureSRVImplIf>(engine::make_shared<BindlessTextureSRVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()))) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<BindlessTextureSRVImplIf>(engine::make_shared<BindlessTextureSRVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()))) :
                 static_pointer_cast<BindlessTextureSRVImplIf>(engine::make_shared<BindlessTextureSRVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()))),
             [&](engine::shared_ptr<BindlessTextureSRVImplIf> im)
             {
@@ -1297,6 +1399,8 @@ namespace engine
         return BindlessTextureUAVOwner(
             (m_api == GraphicsApi::DX12) ?
                 static_pointer_cast<BindlessTextureUAVImplIf>(engine::make_shared<BindlessTextureUAVImplDX12>(*static_cast<const implementation::DeviceImplDX12*>(native()))) :
+                (m_api == GraphicsApi::Null) ?
+                    static_pointer_cast<BindlessTextureUAVImplIf>(engine::make_shared<BindlessTextureUAVImplNull>(*static_cast<const implementation::DeviceImplNull*>(native()))) :
                 static_pointer_cast<BindlessTextureUAVImplIf>(engine::make_shared<BindlessTextureUAVImplVulkan>(*static_cast<const implementation::DeviceImplVulkan*>(native()))),
             [&](engine::shared_ptr<BindlessTextureUAVImplIf> im)
             {
@@ -1334,6 +1438,17 @@ namespace engine
         m_impl->uploadBuffer(commandList, buffer, data, startElement);
     }
 
+    bool Device::reservedBuffersSupported() const
+    {
+        return m_impl->reservedBuffersSupported();
+    }
+
+    void Device::commitBuffer(Buffer buffer, size_t bytes)
+    {
+        ASSERT(buffer.description().reserved, "Only reserved buffers can be committed");
+        m_impl->commitBuffer(buffer, bytes);
+    }
+
     int Device::width() const
     {
         return m_impl->width();
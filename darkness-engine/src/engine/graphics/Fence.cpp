@@ -10,6 +10,8 @@
 #include "engine/graphics/vulkan/VulkanFence.h"
 #endif
 
+#include "engine/graphics/null/NullFence.h"
+
 #ifdef __APPLE__
 #include "engine/graphics/metal/MetalFence.h"
 #endif
@@ -27,6 +29,8 @@ namespace engine
             m_impl = engine::make_unique<FenceImplDX12>(device.native(), name);
         else if (api == GraphicsApi::Vulkan)
             m_impl = engine::make_unique<FenceImplVulkan>(device.native(), name);
+        else if (api == GraphicsApi::Null)
+            m_impl = engine::make_unique<FenceImplNull>(device.native(), name);
     }
 
     void Fence::increaseCPUValue()
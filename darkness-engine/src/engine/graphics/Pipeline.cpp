@@ -13,6 +13,8 @@
 #include "engine/graphics/vulkan/VulkanSampler.h"
 #endif
 
+#include "engine/graphics/null/NullPipeline.h"
+
 #ifdef __APPLE__
 #include "engine/graphics/metal/MetalPipeline.h"
 #endif
@@ -32,6 +34,8 @@ namespace engine
             m_impl = engine::make_shared<implementation::PipelineImplDX12>(device, storage);
         else if (api == GraphicsApi::Vulkan)
             m_impl = engine::make_shared<implementation::PipelineImplVulkan>(device, storage);
+        else if (api == GraphicsApi::Null)
+            m_impl = engine::make_shared<implementation::PipelineImplNull>(device, storage);
 
     };
 
@@ -84,4 +88,9 @@ namespace engine
         m_impl->configure(commandList, configuration);
     };
 
+    void PipelineAbs::prewarm(shaders::PipelineConfiguration* configuration)
+    {
+        m_impl->prewarm(configuration);
+    };
+
 }
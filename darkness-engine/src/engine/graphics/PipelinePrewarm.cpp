@@ -0,0 +1,19 @@
+#include "engine/graphics/PipelinePrewarm.h"
+
+namespace engine
+{
+    PipelinePrewarm::PipelinePrewarm(JobSystem& jobs)
+        : m_group{ jobs }
+    {
+    }
+
+    void PipelinePrewarm::add(Job job)
+    {
+        m_group.run(std::move(job));
+    }
+
+    void PipelinePrewarm::wait()
+    {
+        m_group.wait();
+    }
+}
@@ -18,6 +18,8 @@
 #include "engine/graphics/vulkan/VulkanQueue.h"
 #endif
 
+#include "engine/graphics/null/NullQueue.h"
+
 #ifdef __APPLE__
 #include "engine/graphics/metal/MetalQueue.h"
 #endif
@@ -36,6 +38,8 @@ namespace engine
             m_impl = engine::make_unique<QueueImplDX12>(device, type, queueName);
         else if (api == GraphicsApi::Vulkan)
             m_impl = engine::make_unique<QueueImplVulkan>(device, type, queueName);
+        else if (api == GraphicsApi::Null)
+            m_impl = engine::make_unique<QueueImplNull>(device, type, queueName);
     }
 
     /*void Queue::submit(engine::vector<CommandList>& commandLists)
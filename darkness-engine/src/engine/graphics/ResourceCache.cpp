@@ -1,6 +1,8 @@
 #include "engine/graphics/ResourceCache.h"
 #include "engine/rendering/Mesh.h"
 #include "engine/graphics/Device.h"
+#include "engine/rendering/SubMeshStreaming.h"
+#include "tools/Debug.h"
 
 namespace engine
 {
@@ -147,23 +149,83 @@ namespace engine
         auto existing = m_meshes.find(key);
         if (existing != m_meshes.end())
         {
-            return existing->second->subMeshes()[meshIndex].createInstance(device);
+            return createInstance(device, *existing->second, meshIndex);
         }
 
-        engine::shared_ptr<Mesh> result = engine::make_shared<Mesh>(device.residencyV2(), device.modelResources(), filename);
-        m_meshes[key] = result;
-        return result->subMeshes()[meshIndex].createInstance(device);
+        auto request = requestMesh(key, filename, ResidencyPriority::Visible);
+        return createMesh(device, *request, meshIndex);
 #else
         return engine::make_shared<Mesh>(filename);
 #endif
     }
 
+    engine::shared_ptr<MeshRequest> ResourceCache::requestMesh(
+        ResourceKey key,
+        const engine::string& filename,
+        ResidencyPriority priority)
+    {
+        auto existing = m_meshRequests.find(key);
+        if (existing != m_meshRequests.end())
+        {
+            return existing->second;
+        }
+
+        auto result = m_meshStreamer.request(filename, priority);
+        m_meshRequests[key] = result;
+        m_streamingMeshes.emplace_back(key);
+        return result;
+    }
+
+    engine::shared_ptr<SubMeshInstance> ResourceCache::createMesh(
+        Device& device,
+        MeshRequest& request,
+        uint32_t meshIndex)
+    {
+        if (!request.ready())
+            return nullptr;
+        return createInstance(device, *request.mesh(), meshIndex);
+    }
+
+    void ResourceCache::streamMeshes(Device& device)
+    {
+        ResidencySubMeshUploadBackend backend(device.residencyV2(), device.modelResources());
+        m_meshStreamer.update(backend);
+
+        // finished meshes join the cache
+        for (auto key = m_streamingMeshes.begin(); key != m_streamingMeshes.end();)
+        {
+            auto& request = *m_meshRequests[*key];
+            if (request.ready())
+                m_meshes[*key] = request.mesh();
+            if (request.ready() || request.failed())
+                key = m_streamingMeshes.erase(key);
+            else
+                ++key;
+        }
+    }
+
+    engine::shared_ptr<SubMeshInstance> ResourceCache::createInstance(Device& device, Mesh& mesh, uint32_t meshIndex)
+    {
+        if (meshIndex >= mesh.subMeshes().size())
+        {
+            LOG_WARNING("Mesh has no submesh %u", meshIndex);
+            return nullptr;
+        }
+        return mesh.subMeshes()[meshIndex].createInstance(device);
+    }
+
     void ResourceCache::clear()
     {
         m_textureSRV.clear();
         m_bufferSRV.clear();
         m_bufferIBV.clear();
         m_images.clear();
+
+        // nothing is going to pick up what is still streaming. meshes that
+        // were scheduled wait for their uploads when they are destroyed
+        m_meshStreamer.cancel();
         m_meshes.clear();
+        m_meshRequests.clear();
+        m_streamingMeshes.clear();
     }
 }
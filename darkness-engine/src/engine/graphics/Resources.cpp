@@ -49,6 +49,11 @@ namespace engine
         m_impl->state(state);
     }
 
+    size_t Buffer::committedBytes() const
+    {
+        return m_impl->committedBytes();
+    }
+
 	bool Buffer::operator==(const Buffer& buffer) const
 	{
 		return m_impl == buffer.m_impl;
@@ -458,6 +463,16 @@ namespace engine
         m_impl->state(slice, mip, state);
     }
 
+    void Texture::state(ResourceState state) const
+    {
+        m_impl->state(state);
+    }
+
+    bool Texture::uniformState(ResourceState& state) const
+    {
+        return m_impl->uniformState(state);
+    }
+
 	bool Texture::operator==(const Texture& texture) const
 	{
 		return m_impl == texture.m_impl;
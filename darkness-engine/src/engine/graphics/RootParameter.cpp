@@ -9,6 +9,8 @@
 #include "engine/graphics/vulkan/VulkanRootParameter.h"
 #endif
 
+#include "engine/graphics/null/NullRootParameter.h"
+
 #ifdef __APPLE__
 #include "engine/graphics/metal/MetalRootParameter.h"
 #endif
@@ -29,6 +31,8 @@ namespace engine
             m_impl = engine::make_unique<RootParameterImplDX12>();
         else if (api == GraphicsApi::Vulkan)
             m_impl = engine::make_unique<RootParameterImplVulkan>();
+        else if (api == GraphicsApi::Null)
+            m_impl = engine::make_unique<RootParameterImplNull>();
     }
 
     void RootParameter::binding(unsigned int index)
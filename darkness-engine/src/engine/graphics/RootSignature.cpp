@@ -10,6 +10,8 @@
 #include "engine/graphics/vulkan/VulkanRootSignature.h"
 #endif
 
+#include "engine/graphics/null/NullRootSignature.h"
+
 #ifdef __APPLE__
 #include "engine/graphics/metal/MetalRootSignature.h"
 #endif
@@ -26,6 +28,8 @@ namespace engine
             m_impl = engine::make_unique<RootSignatureImplDX12>(device, rootParameterCount, staticSamplerCount);
         else if (api == GraphicsApi::Vulkan)
             m_impl = engine::make_unique<RootSignatureImplVulkan>(device, rootParameterCount, staticSamplerCount);
+        else if (api == GraphicsApi::Null)
+            m_impl = engine::make_unique<RootSignatureImplNull>(device, rootParameterCount, staticSamplerCount);
     }
 
     void RootSignature::reset(int rootParameterCount, int staticSamplerCount)
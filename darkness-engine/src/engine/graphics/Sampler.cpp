@@ -8,6 +8,8 @@
 #include "engine/graphics/vulkan/VulkanSampler.h"
 #endif
 
+#include "engine/graphics/null/NullSampler.h"
+
 #ifdef __APPLE__
 #include "engine/graphics/metal/MetalSampler.h"
 #endif
@@ -28,6 +30,8 @@ namespace engine
             m_impl = engine::make_unique<SamplerImplDX12>(device, desc);
         else if (api == GraphicsApi::Vulkan)
             m_impl = engine::make_unique<SamplerImplVulkan>(device, desc);
+        else if (api == GraphicsApi::Null)
+            m_impl = engine::make_unique<SamplerImplNull>(device, desc);
     }
 
     bool Sampler::valid() const
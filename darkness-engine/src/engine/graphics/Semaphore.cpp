@@ -9,6 +9,8 @@
 #include "engine/graphics/vulkan/VulkanSemaphore.h"
 #endif
 
+#include "engine/graphics/null/NullSemaphore.h"
+
 #ifdef __APPLE__
 #include "engine/graphics/metal/MetalSemaphore.h"
 #endif
@@ -26,6 +28,8 @@ namespace engine
             m_impl = engine::make_unique<SemaphoreImplDX12>(device);
         else if (api == GraphicsApi::Vulkan)
             m_impl = engine::make_unique<SemaphoreImplVulkan>(device);
+        else if (api == GraphicsApi::Null)
+            m_impl = engine::make_unique<SemaphoreImplNull>(device);
     }
 
     void Semaphore::reset()
@@ -9,6 +9,8 @@
 #include "engine/graphics/vulkan/VulkanShaderBinary.h"
 #endif
 
+#include "engine/graphics/null/NullShaderBinary.h"
+
 #ifdef __APPLE__
 #include "engine/graphics/metal/MetalShaderBinary.h"
 #endif
@@ -32,6 +34,8 @@ namespace engine
             m_impl = engine::make_unique<ShaderBinaryImplDX12>(device, binaryPath, supportPath, permutationId, defines, watcher);
         else if (api == GraphicsApi::Vulkan)
             m_impl = engine::make_unique<ShaderBinaryImplVulkan>(device, binaryPath, supportPath, permutationId, defines, watcher);
+        else if (api == GraphicsApi::Null)
+            m_impl = engine::make_unique<ShaderBinaryImplNull>(device, binaryPath, supportPath, permutationId, defines, watcher);
     }
 
     void ShaderBinary::registerForChange(void* client, std::function<void(void)> change) const
@@ -11,6 +11,8 @@
 #include "engine/graphics/vulkan/VulkanSwapChain.h"
 #endif
 
+#include "engine/graphics/null/NullSwapChain.h"
+
 #ifdef __APPLE__
 #include "engine/graphics/metal/MetalSwapChain.h"
 #endif
@@ -37,6 +39,9 @@ namespace engine
         else if (api == GraphicsApi::Vulkan)
             m_impl = engine::make_unique<implementation::SwapChainImplVulkan>(
                 device, queue, fullscreen, vsync, oldSwapChain);
+        else if (api == GraphicsApi::Null)
+            m_impl = engine::make_unique<implementation::SwapChainImplNull>(
+                device, queue, fullscreen, vsync, oldSwapChain);
     }
 
     void SwapChain::recreate()
@@ -47,6 +52,9 @@ namespace engine
         else if (m_api == GraphicsApi::Vulkan)
             m_impl = engine::make_unique<implementation::SwapChainImplVulkan>(
                 m_device, m_queue, m_fullscreen, m_vsync, this);
+        else if (m_api == GraphicsApi::Null)
+            m_impl = engine::make_unique<implementation::SwapChainImplNull>(
+                m_device, m_queue, m_fullscreen, m_vsync, this);
     }
 
     Semaphore& SwapChain::backBufferReadySemaphore()
@@ -0,0 +1,460 @@
+#include "engine/rendering/LightBinning.h"
+#include "engine/rendering/LightData.h"
+#include "engine/primitives/Vector4.h"
+#include "engine/primitives/Simd.h"
+#include "components/LightComponent.h"
+#include "components/Camera.h"
+#include "tools/ToolsCommon.h"
+#include "tools/Debug.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace engine
+{
+
+    // wider cones are binned as a half space in front of the light
+    constexpr float MaxSpotLightBinAngle = 89.0f;
+
+    namespace
+    {
+        constexpr float DegreesToRadians = 3.14159265358979f / 180.0f;
+
+        uint32_t tile(float ndc, float size, uint32_t bins)
+        {
+            float pixel = (ndc * 0.5f + 0.5f) * size;
+            float index = std::floor(pixel / static_cast<float>(LightBinTileSize));
+            return static_cast<uint32_t>(std::min(std::max(index, 0.0f), static_cast<float>(bins - 1)));
+        }
+    }
+
+    LightBinningView LightBinningView::fromCamera(const Camera& camera)
+    {
+        LightBinningView view;
+        view.viewMatrix = camera.viewMatrix();
+        view.projectionMatrix = camera.projectionMatrix();
+        view.width = camera.width();
+        view.height = camera.height();
+        view.nearPlane = camera.nearPlane();
+        view.farPlane = camera.farPlane();
+        return view;
+    }
+
+    void LightBinningStatistics::reset()
+    {
+        lightsBinned = 0;
+        lightsOutside = 0;
+        entries = 0;
+        milliseconds = 0.0;
+    }
+
+    bool LightBinList::contains(uint32_t light) const
+    {
+        return std::binary_search(begin(), end(), light);
+    }
+
+    LightBinning::LightBinning(uint32_t slices, JobSystem& jobs)
+        : m_slices{ slices }
+        , m_binsX{ 0 }
+        , m_binsY{ 0 }
+        , m_view{}
+        , m_depthScale{ 0.0f }
+        , m_sliceData(slices)
+        , m_statistics{}
+        , m_jobs{ jobs }
+    {
+        ASSERT(slices > 0, "LightBinning needs at least one depth slice");
+    }
+
+    void LightBinning::resize(int width, int height)
+    {
+        auto binsX = std::max((static_cast<uint32_t>(width) + LightBinTileSize - 1) / LightBinTileSize, 1u);
+        auto binsY = std::max((static_cast<uint32_t>(height) + LightBinTileSize - 1) / LightBinTileSize, 1u);
+        if (binsX == m_binsX && binsY == m_binsY)
+            return;
+
+        m_binsX = binsX;
+        m_binsY = binsY;
+        auto paddedX = roundUpToMultiple(m_binsX, 4u);
+        for (auto&& slice : m_sliceData)
+        {
+            slice.minX.resize(paddedX, 0.0f);
+            slice.maxX.resize(paddedX, 0.0f);
+            slice.minY.resize(m_binsY);
+            slice.maxY.resize(m_binsY);
+            slice.offsets.resize(m_binsX * m_binsY + 1);
+        }
+    }
+
+    void LightBinning::updateSlices()
+    {
+        const auto& p = m_view.projectionMatrix;
+        const float nearPlane = m_view.nearPlane;
+        const float farPlane = m_view.farPlane;
+        const float width = static_cast<float>(m_view.width);
+        const float height = static_cast<float>(m_view.height);
+        m_depthScale = static_cast<float>(m_slices) / std::log(farPlane / nearPlane);
+
+        for (uint32_t s = 0; s < m_slices; ++s)
+        {
+            auto& slice = m_sliceData[s];
+            slice.nearDepth = nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(s) / static_cast<float>(m_slices));
+            slice.farDepth = nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(s + 1) / static_cast<float>(m_slices));
+
+            // view x = depth * (ndc x + m02) / m00, the extremes are at the slice ends
+            for (uint32_t x = 0; x < m_binsX; ++x)
+            {
+                float left = static_cast<float>(x * LightBinTileSize) / width * 2.0f - 1.0f + p.m02;
+                float right = std::min(static_cast<float>((x + 1) * LightBinTileSize) / width, 1.0f) * 2.0f - 1.0f + p.m02;
+                slice.minX[x] = std::min(left * slice.nearDepth, left * slice.farDepth) / p.m00;
+                slice.maxX[x] = std::max(right * slice.nearDepth, right * slice.farDepth) / p.m00;
+            }
+            for (uint32_t y = 0; y < m_binsY; ++y)
+            {
+                float top = 1.0f - static_cast<float>(y * LightBinTileSize) / height * 2.0f + p.m12;
+                float bottom = 1.0f - std::min(static_cast<float>((y + 1) * LightBinTileSize) / height, 1.0f) * 2.0f + p.m12;
+                slice.minY[y] = std::min(bottom * slice.nearDepth, bottom * slice.farDepth) / p.m11;
+                slice.maxY[y] = std::max(top * slice.nearDepth, top * slice.farDepth) / p.m11;
+            }
+        }
+    }
+
+    uint32_t LightBinning::slice(float depth) const
+    {
+        if (depth <= m_view.nearPlane)
+            return 0;
+        auto index = std::log(depth / m_view.nearPlane) * m_depthScale;
+        return std::min(static_cast<uint32_t>(index), m_slices - 1);
+    }
+
+    bool LightBinning::binLight(uint32_t index, const Vector3f& position, const Vector3f& direction, float range, bool spot, float angleDegrees)
+    {
+        if (range <= 0.0f)
+            return false;
+
+        BinnedLight light;
+        light.index = index;
+        light.spot = spot;
+        light.apex = (m_view.viewMatrix * Vector4f(position, 1.0f)).xyz();
+        light.range = range;
+        light.center = light.apex;
+        light.radius = range;
+
+        if (spot)
+        {
+            // the light shines against its direction
+            light.axis = (m_view.viewMatrix * Vector4f(direction * -1.0f, 0.0f)).xyz();
+            if (light.axis.magnitude() == 0.0f)
+                return false;
+            light.axis.normalize();
+
+            float angle = std::min(angleDegrees, MaxSpotLightBinAngle) * DegreesToRadians;
+            light.cosAngle = std::cos(angle);
+            light.sinAngle = std::sin(angle);
+
+            // the smallest sphere around the cone
+            if (angle > 0.25f * 3.14159265358979f)
+            {
+                light.center = light.apex + light.axis * (light.cosAngle * range);
+                light.radius = light.sinAngle * range;
+            }
+            else
+            {
+                light.radius = range / (2.0f * light.cosAngle);
+                light.center = light.apex + light.axis * light.radius;
+            }
+        }
+
+        float depth = -light.center.z;
+        float nearDepth = depth - light.radius;
+        float farDepth = depth + light.radius;
+        if (farDepth < m_view.nearPlane || nearDepth > m_view.farPlane)
+            return false;
+
+        light.x0 = 0;
+        light.x1 = m_binsX - 1;
+        light.y0 = 0;
+        light.y1 = m_binsY - 1;
+
+        // spheres that reach the camera plane can cover any tile
+        if (nearDepth > m_view.nearPlane)
+        {
+            const auto& p = m_view.projectionMatrix;
+            float left = std::min((light.center.x - light.radius) / nearDepth, (light.center.x - light.radius) / farDepth) * p.m00 - p.m02;
+            float right = std::max((light.center.x + light.radius) / nearDepth, (light.center.x + light.radius) / farDepth) * p.m00 - p.m02;
+            float bottom = std::min((light.center.y - light.radius) / nearDepth, (light.center.y - light.radius) / farDepth) * p.m11 - p.m12;
+            float top = std::max((light.center.y + light.radius) / nearDepth, (light.center.y + light.radius) / farDepth) * p.m11 - p.m12;
+            if (right < -1.0f || left > 1.0f || top < -1.0f || bottom > 1.0f)
+                return false;
+
+            light.x0 = tile(left, static_cast<float>(m_view.width), m_binsX);
+            light.x1 = tile(right, static_cast<float>(m_view.width), m_binsX);
+            light.y0 = tile(-top, static_cast<float>(m_view.height), m_binsY);
+            light.y1 = tile(-bottom, static_cast<float>(m_view.height), m_binsY);
+        }
+
+        auto binned = static_cast<uint32_t>(m_lights.size());
+        m_lights.emplace_back(light);
+
+        auto lastSlice = slice(farDepth);
+        for (auto s = slice(nearDepth); s <= lastSlice; ++s)
+            m_sliceData[s].lights.emplace_back(binned);
+        return true;
+    }
+
+    void LightBinning::update(const LightBinningView& view, const LightData& lights)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        m_statistics.reset();
+        m_view = view;
+        resize(view.width, view.height);
+        updateSlices();
+
+        m_lights.clear();
+        for (auto&& slice : m_sliceData)
+            slice.lights.clear();
+
+        const auto& types = lights.engineTypes();
+        const auto& positions = lights.positions();
+        const auto& directions = lights.directionVectors();
+        const auto& ranges = lights.cpuranges();
+        const auto& parameters = lights.cpuparameters();
+        for (uint32_t i = 0; i < lights.count(); ++i)
+        {
+            bool binned = false;
+            if (types[i] == static_cast<unsigned int>(LightType::Spot))
+            {
+                float angle = std::max(parameters[i].x, parameters[i].y) + SpotLightBinAngle;
+                binned = binLight(i, positions[i], directions[i], ranges[i], true, angle);
+            }
+            else if (types[i] == static_cast<unsigned int>(LightType::Point))
+                binned = binLight(i, positions[i], directions[i], ranges[i] * PointLightBinScale, false, 0.0f);
+            else
+                continue;
+
+            if (!binned)
+                ++m_statistics.lightsOutside;
+        }
+        m_statistics.lightsBinned = m_lights.size();
+
+        m_jobs.parallelFor(m_sliceData.size(), [&](size_t slice) { binSlice(slice); });
+
+        for (auto&& slice : m_sliceData)
+            m_statistics.entries += slice.indexes.size();
+
+        m_statistics.milliseconds = std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    uint32_t LightBinning::testTiles(const Slice& slice, const BinnedLight& light, uint32_t x, uint32_t y) const
+    {
+        // froxel in view space. the camera looks down -z
+        const float minZ = -slice.farDepth;
+        const float maxZ = -slice.nearDepth;
+
+        float dy = std::max(std::max(slice.minY[y] - light.center.y, light.center.y - slice.maxY[y]), 0.0f);
+        float dz = std::max(std::max(minZ - light.center.z, light.center.z - maxZ), 0.0f);
+
+#if defined(DARKNESS_SIMD)
+        // sphere against the froxel boxes of four tiles
+        auto zero = simd::splat(0.0f);
+        auto minX = simd::load(&slice.minX[x]);
+        auto maxX = simd::load(&slice.maxX[x]);
+        auto centerX = simd::splat(light.center.x);
+        auto dx = simd::max(simd::max(simd::sub(minX, centerX), simd::sub(centerX, maxX)), zero);
+        auto distanceSqr = simd::add(simd::mul(dx, dx), simd::splat(dy * dy + dz * dz));
+        int mask = simd::greaterEqual(simd::splat(light.radius * light.radius), distanceSqr);
+        if (!light.spot || mask == 0)
+            return static_cast<uint32_t>(mask);
+
+        // cone against the bounding spheres of the froxels
+        auto half = simd::splat(0.5f);
+        auto halfX = simd::mul(simd::sub(maxX, minX), half);
+        float halfY = (slice.maxY[y] - slice.minY[y]) * 0.5f;
+        float halfZ = (maxZ - minZ) * 0.5f;
+        auto radius = simd::sqrt(simd::add(simd::mul(halfX, halfX), simd::splat(halfY * halfY + halfZ * halfZ)));
+
+        auto vx = simd::sub(simd::mul(simd::add(minX, maxX), half), simd::splat(light.apex.x));
+        float vy = (slice.minY[y] + slice.maxY[y]) * 0.5f - light.apex.y;
+        float vz = (minZ + maxZ) * 0.5f - light.apex.z;
+        auto lengthSqr = simd::add(simd::mul(vx, vx), simd::splat(vy * vy + vz * vz));
+        auto alongAxis = simd::add(simd::mul(vx, simd::splat(light.axis.x)), simd::splat(vy * light.axis.y + vz * light.axis.z));
+        auto closest = simd::sub(
+            simd::mul(simd::splat(light.cosAngle), simd::sqrt(simd::max(simd::sub(lengthSqr, simd::mul(alongAxis, alongAxis)), zero))),
+            simd::mul(alongAxis, simd::splat(light.sinAngle)));
+
+        int outside =
+            simd::less(radius, closest) |
+            simd::less(simd::add(radius, simd::splat(light.range)), alongAxis) |
+            simd::less(alongAxis, simd::sub(zero, radius));
+        return static_cast<uint32_t>(mask & ~outside & 0xf);
+#else
+        uint32_t mask = 0;
+        for (uint32_t lane = 0; lane < 4; ++lane)
+        {
+            float minX = slice.minX[x + lane];
+            float maxX = slice.maxX[x + lane];
+            float dx = std::max(std::max(minX - light.center.x, light.center.x - maxX), 0.0f);
+            if (dx * dx + dy * dy + dz * dz > light.radius * light.radius)
+                continue;
+
+            if (light.spot)
+            {
+                float halfX = (maxX - minX) * 0.5f;
+                float halfY = (slice.maxY[y] - slice.minY[y]) * 0.5f;
+                float halfZ = (maxZ - minZ) * 0.5f;
+                float radius = std::sqrt(halfX * halfX + halfY * halfY + halfZ * halfZ);
+
+                float vx = (minX + maxX) * 0.5f - light.apex.x;
+                float vy = (slice.minY[y] + slice.maxY[y]) * 0.5f - light.apex.y;
+                float vz = (minZ + maxZ) * 0.5f - light.apex.z;
+                float lengthSqr = vx * vx + vy * vy + vz * vz;
+                float alongAxis = vx * light.axis.x + vy * light.axis.y + vz * light.axis.z;
+                float closest = light.cosAngle * std::sqrt(std::max(lengthSqr - alongAxis * alongAxis, 0.0f)) - alongAxis * light.sinAngle;
+                if (closest > radius || alongAxis > radius + light.range || alongAxis < -radius)
+                    continue;
+            }
+            mask |= 1u << lane;
+        }
+        return mask;
+#endif
+    }
+
+    void LightBinning::binSlice(size_t index)
+    {
+        auto& slice = m_sliceData[index];
+        auto minX = slice.minX.begin();
+        auto maxX = slice.maxX.begin();
+        auto minY = slice.minY.begin();
+        auto maxY = slice.maxY.begin();
+
+        // the tiles each light can touch in this slice
+        slice.spans.clear();
+        for (auto&& binned : slice.lights)
+        {
+            const auto& light = m_lights[binned];
+
+            // the sphere is a disc in the slice. the columns and rows it
+            // touches are found from the froxel bounds, which grow with x
+            // and shrink with y
+            float depth = -light.center.z;
+            float outside = std::max(std::max(slice.nearDepth - depth, depth - slice.farDepth), 0.0f);
+            float radius = std::sqrt(std::max(light.radius * light.radius - outside * outside, 0.0f));
+
+            Span span;
+            span.light = binned;
+            span.x0 = static_cast<uint32_t>(std::partition_point(maxX, maxX + m_binsX,
+                [&](float value) { return value < light.center.x - radius; }) - maxX);
+            span.x1 = static_cast<uint32_t>(std::partition_point(minX, minX + m_binsX,
+                [&](float value) { return value <= light.center.x + radius; }) - minX);
+            span.y0 = static_cast<uint32_t>(std::partition_point(minY, minY + m_binsY,
+                [&](float value) { return value > light.center.y + radius; }) - minY);
+            span.y1 = static_cast<uint32_t>(std::partition_point(maxY, maxY + m_binsY,
+                [&](float value) { return value >= light.center.y - radius; }) - maxY);
+            if (span.x1 == 0 || span.y1 == 0)
+                continue;
+
+            span.x0 = std::max(span.x0, light.x0);
+            span.y0 = std::max(span.y0, light.y0);
+            span.x1 = std::min(span.x1 - 1, light.x1);
+            span.y1 = std::min(span.y1 - 1, light.y1);
+            if (span.x0 <= span.x1 && span.y0 <= span.y1)
+                slice.spans.emplace_back(span);
+        }
+
+        // spans by row, in light order
+        slice.rowOffsets.assign(m_binsY + 1, 0u);
+        for (auto&& span : slice.spans)
+            for (uint32_t y = span.y0; y <= span.y1; ++y)
+                ++slice.rowOffsets[y + 1];
+        for (size_t i = 1; i < slice.rowOffsets.size(); ++i)
+            slice.rowOffsets[i] += slice.rowOffsets[i - 1];
+        slice.rowSpans.resize(slice.rowOffsets.back());
+        for (uint32_t i = 0; i < static_cast<uint32_t>(slice.spans.size()); ++i)
+            for (uint32_t y = slice.spans[i].y0; y <= slice.spans[i].y1; ++y)
+                slice.rowSpans[slice.rowOffsets[y]++] = i;
+        for (size_t i = slice.rowOffsets.size() - 1; i > 0; --i)
+            slice.rowOffsets[i] = slice.rowOffsets[i - 1];
+        slice.rowOffsets[0] = 0;
+
+        // a row at a time so that the sorting stays in the cache. the rows
+        // are written out in order, a tile's lights stay in light order
+        slice.indexes.clear();
+        for (uint32_t y = 0; y < m_binsY; ++y)
+        {
+            slice.rowHits.clear();
+            for (auto i = slice.rowOffsets[y]; i < slice.rowOffsets[y + 1]; ++i)
+            {
+                const auto& span = slice.spans[slice.rowSpans[i]];
+                const auto& light = m_lights[span.light];
+                for (uint32_t x = span.x0 & ~3u; x <= span.x1; x += 4)
+                {
+                    auto mask = testTiles(slice, light, x, y);
+                    for (uint32_t lane = 0; lane < 4; ++lane)
+                    {
+                        auto tileX = x + lane;
+                        if ((mask & (1u << lane)) && tileX >= span.x0 && tileX <= span.x1)
+                            slice.rowHits.emplace_back((static_cast<uint64_t>(tileX) << 32) | light.index);
+                    }
+                }
+            }
+
+            auto offsets = slice.offsets.begin() + y * m_binsX;
+            auto rowStart = static_cast<uint32_t>(slice.indexes.size());
+            std::fill(offsets, offsets + m_binsX, 0u);
+            for (auto&& hit : slice.rowHits)
+                ++offsets[static_cast<size_t>(hit >> 32)];
+
+            uint32_t position = rowStart;
+            for (uint32_t x = 0; x < m_binsX; ++x)
+            {
+                auto count = offsets[x];
+                offsets[x] = position;
+                position += count;
+            }
+
+            slice.indexes.resize(position);
+            for (auto&& hit : slice.rowHits)
+                slice.indexes[offsets[static_cast<size_t>(hit >> 32)]++] = static_cast<uint32_t>(hit);
+
+            // the offsets moved to the end of their tile
+            for (uint32_t x = m_binsX - 1; x > 0; --x)
+                offsets[x] = offsets[x - 1];
+            offsets[0] = rowStart;
+        }
+        slice.offsets[m_binsX * m_binsY] = static_cast<uint32_t>(slice.indexes.size());
+    }
+
+    LightBinList LightBinning::lights(uint32_t x, uint32_t y, uint32_t slice) const
+    {
+        const auto& data = m_sliceData[slice];
+        auto tileIndex = static_cast<size_t>(y * m_binsX + x);
+        if (tileIndex + 1 >= data.offsets.size())
+            return { nullptr, 0 };
+        return { data.indexes.data() + data.offsets[tileIndex], data.offsets[tileIndex + 1] - data.offsets[tileIndex] };
+    }
+
+    LightBinList LightBinning::lightsAt(const Vector3f& position) const
+    {
+        if (m_binsX == 0)
+            return { nullptr, 0 };
+
+        auto viewPosition = m_view.viewMatrix * Vector4f(position, 1.0f);
+        float depth = -viewPosition.z;
+        if (depth < m_view.nearPlane || depth > m_view.farPlane)
+            return { nullptr, 0 };
+
+        auto clip = m_view.projectionMatrix * viewPosition;
+        float x = clip.x / clip.w;
+        float y = clip.y / clip.w;
+        if (x < -1.0f || x > 1.0f || y < -1.0f || y > 1.0f)
+            return { nullptr, 0 };
+
+        return lights(
+            tile(x, static_cast<float>(m_view.width), m_binsX),
+            tile(-y, static_cast<float>(m_view.height), m_binsY),
+            slice(depth));
+    }
+}
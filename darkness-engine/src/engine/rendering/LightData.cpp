@@ -1,15 +1,81 @@
 #include "engine/rendering/LightData.h"
+#include "engine/graphics/Device.h"
+#include "tools/ToolsCommon.h"
 #include "tools/ByteRange.h"
 
+#include <algorithm>
+#include <cstring>
+
 using namespace tools;
 
 namespace engine
 {
+    constexpr uint32_t MinLightCapacity = 64;
+    constexpr uint32_t MinPackedLightCapacity = 16;
+
+    // clean elements between two changed ones that are still sent in the
+    // same copy rather than starting a new one
+    constexpr uint32_t MaxLightUploadGap = 16;
+
+    namespace
+    {
+        constexpr uint16_t fieldBit(int field)
+        {
+            return static_cast<uint16_t>(1u << field);
+        }
+
+        uint32_t grow(uint32_t capacity, uint32_t count, uint32_t minimum)
+        {
+            if (count <= capacity && capacity > 0)
+                return capacity;
+            return std::max(roundUpToPow2(count), minimum);
+        }
+    }
+
+    LightData::LightData()
+        : m_lightCount{ 0 }
+        , m_activeCount{ 0 }
+        , m_frame{ 0 }
+        , m_statistics{}
+        , m_capacity{ 0 }
+        , m_spotCapacity{ 0 }
+        , m_pointCapacity{ 0 }
+        , m_recreate{ false }
+        , m_recreateSpots{ false }
+        , m_recreatePoints{ false }
+    {}
+
     uint32_t LightData::count() const
     {
         return m_lightCount;
     }
 
+    uint32_t LightData::activeCount() const
+    {
+        return m_activeCount;
+    }
+
+    uint32_t LightData::spotCount() const
+    {
+        return static_cast<uint32_t>(m_spotids.size());
+    }
+
+    uint32_t LightData::pointCount() const
+    {
+        return static_cast<uint32_t>(m_pointids.size());
+    }
+
+    uint32_t LightData::index(const LightComponent* light) const
+    {
+        auto slot = m_slots.find(light);
+        return slot != m_slots.end() ? slot->second : InvalidLightIndex;
+    }
+
+    const LightUploadStatistics& LightData::uploadStatistics() const
+    {
+        return m_statistics;
+    }
+
     BufferSRV LightData::transforms()
     {
         return m_lightTransforms;
@@ -118,275 +184,520 @@ namespace engine
 
     void LightData::updateLightInfo(Device& device, CommandList& commandList, const engine::vector<FlatSceneLightNode>& lights)
     {
-        bool sizeChanged = static_cast<uint32_t>(lights.size()) != m_lightCount;
-        engine::vector<Vector4f> positions;
-        engine::vector<Vector4f> directions;
-        engine::vector<Vector4f> colors;
-        engine::vector<float> intensities;
-        engine::vector<float> ranges;
-		engine::vector<float> spotranges;
-		engine::vector<float> pointranges;
-        engine::vector<Matrix4f> transforms;
-		engine::vector<Matrix4f> spottransforms;
-		engine::vector<uint32_t> spotids;
-		engine::vector<uint32_t> pointids;
-        engine::vector<unsigned int> types;
-        engine::vector<Vector4f> parameters;
-
-        bool positionsChanged = false;
-        bool directionsChanged = false;
-        bool colorsChanged = false;
-        bool intensitiesChanged = false;
-        bool parametersChanged = false;
-        bool rangesChanged = false;
-        bool typesChanged = false;
-        for (auto&& light : lights)
+        stage(lights);
+        upload(device, commandList);
+    }
+
+    uint32_t LightData::allocateSlot(const engine::shared_ptr<LightComponent>& light)
+    {
+        uint32_t slot = 0;
+        if (m_freeSlots.size() > 0)
         {
-            positionsChanged |= light.positionChanged;
-            directionsChanged |= light.rotationChanged;
-            colorsChanged |= light.light->colorChanged(true);
-            intensitiesChanged |= light.light->intensityChanged(true);
-            rangesChanged |= light.light->rangeChanged(true);
-            typesChanged |= light.light->lightTypeChanged(true);
-            parametersChanged |= light.light->lightParametersChanged(true);
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
         }
-
-        m_changeHappened =
-            //positionsChanged |
-            //directionsChanged |
-            //colorsChanged |
-            //intensitiesChanged |
-            rangesChanged |
-            typesChanged |
-            parametersChanged;
-
-        m_transforms.clear();
-        m_positions.clear();
-        m_directions.clear();
-        m_ranges.clear();
-		m_spotranges.clear();
-		m_pointranges.clear();
-		m_spottransforms.clear();
-		m_parameters.clear();
-
-        m_types.clear();
-        m_shadowCaster.clear();
-
-		uint32_t index = 0u;
-        for (auto&& light : lights)
+        else
         {
-            if (sizeChanged || positionsChanged)
-                positions.emplace_back(Vector4f(light.position, 1.0f));
-
-            if (sizeChanged || directionsChanged)
-                directions.emplace_back(Vector4f(light.direction, 1.0f));
-
-            if (sizeChanged || colorsChanged)
-                colors.emplace_back(Vector4f(light.light->color(), 1.0f));
-
-            if (sizeChanged || intensitiesChanged)
-                intensities.emplace_back(light.light->intensity());
-
-			if (sizeChanged || positionsChanged || directionsChanged)
-				transforms.emplace_back(light.transform);
-
-            if ((sizeChanged || positionsChanged || directionsChanged) && (light.light->lightType() == LightType::Spot))
-                spottransforms.emplace_back(light.transform);
-
-			if (sizeChanged || rangesChanged)
-			{
-				ranges.emplace_back(light.light->range());
-				if (light.light->lightType() == LightType::Spot)
-				{
-					spotranges.emplace_back(light.light->range());
-					spotids.emplace_back(index);
-				}
-				else if (light.light->lightType() == LightType::Point)
-				{
-					pointranges.emplace_back(light.light->range());
-					pointids.emplace_back(index);
-				}
-			}
-
-            if (sizeChanged || typesChanged)
-                types.emplace_back(static_cast<unsigned int>(light.light->lightType()));
-
-            if (sizeChanged || parametersChanged)
-                parameters.emplace_back(light.light->parameters());
-
-            m_transforms.emplace_back(light.transform);
-            m_positions.emplace_back(light.position);
-            m_directions.emplace_back(light.direction);
-            m_ranges.emplace_back(light.range);
-			m_spotranges.emplace_back(light.range);
-			m_pointranges.emplace_back(light.range);
-            m_types.emplace_back(static_cast<unsigned int>(light.type));
-            m_shadowCaster.emplace_back(light.shadowCaster);
-			m_spottransforms.emplace_back(light.transform);
-			m_parameters.emplace_back(light.light->parameters());
-
-			++index;
+            slot = m_lightCount++;
+            m_transforms.emplace_back(Matrix4f{});
+            m_positions.emplace_back(Vector3f{ 0.0f, 0.0f, 0.0f });
+            m_directions.emplace_back(Vector3f{ 0.0f, 0.0f, 0.0f });
+            m_ranges.emplace_back(0.0f);
+            m_types.emplace_back(FreeLightType);
+            m_shadowCaster.emplace_back(false);
+            m_parameters.emplace_back(Vector4f{ 0.0f, 0.0f, 0.0f, 0.0f });
+            m_gpuPositions.emplace_back(Vector4f{ 0.0f, 0.0f, 0.0f, 0.0f });
+            m_gpuDirections.emplace_back(Vector4f{ 0.0f, 0.0f, 0.0f, 0.0f });
+            m_colors.emplace_back(Vector4f{ 0.0f, 0.0f, 0.0f, 0.0f });
+            m_intensities.emplace_back(0.0f);
+            m_packedIndex.emplace_back(InvalidLightIndex);
+            m_components.emplace_back(nullptr);
+            m_seen.emplace_back(0u);
+            m_dirty.emplace_back(static_cast<uint16_t>(0u));
         }
+        m_components[slot] = light;
+        m_slots[light.get()] = slot;
+        ++m_activeCount;
+        return slot;
+    }
 
-        if (sizeChanged)
-        {
-            m_lightCount = static_cast<uint32_t>(lights.size());
+    void LightData::freeSlot(uint32_t slot)
+    {
+        m_slots.erase(m_components[slot].get());
+        m_components[slot] = nullptr;
+
+        m_transforms[slot] = Matrix4f{};
+        m_positions[slot] = Vector3f{ 0.0f, 0.0f, 0.0f };
+        m_directions[slot] = Vector3f{ 0.0f, 0.0f, 0.0f };
+        m_ranges[slot] = 0.0f;
+        m_types[slot] = FreeLightType;
+        m_shadowCaster[slot] = false;
+        m_parameters[slot] = Vector4f{ 0.0f, 0.0f, 0.0f, 0.0f };
+        m_gpuPositions[slot] = Vector4f{ 0.0f, 0.0f, 0.0f, 0.0f };
+        m_gpuDirections[slot] = Vector4f{ 0.0f, 0.0f, 0.0f, 0.0f };
+        m_colors[slot] = Vector4f{ 0.0f, 0.0f, 0.0f, 0.0f };
+        m_intensities[slot] = 0.0f;
+
+        markDirty(slot, static_cast<uint16_t>(fieldBit(SlotFieldCount) - 1u));
+        m_freeSlots.emplace_back(slot);
+        --m_activeCount;
+    }
+
+    void LightData::markDirty(uint32_t slot, uint16_t fields)
+    {
+        if (m_dirty[slot] == 0)
+            m_dirtySlots.emplace_back(slot);
+        m_dirty[slot] |= fields;
+    }
 
-            if (m_lightCount > 0)
+    void LightData::stage(const engine::vector<FlatSceneLightNode>& lights)
+    {
+        m_statistics = LightUploadStatistics{};
+        m_changeHappened = false;
+        m_uploads.clear();
+        ++m_frame;
+
+        const uint16_t allFields = static_cast<uint16_t>(fieldBit(SlotFieldCount) - 1u);
+        const uint16_t changeFields = fieldBit(FieldRange) | fieldBit(FieldType) | fieldBit(FieldParameters);
+
+        bool repack = false;
+        uint32_t seen = 0;
+        for (auto&& node : lights)
+        {
+            auto& light = node.light;
+            if (!light)
+                continue;
+
+            uint16_t dirty = 0;
+            uint32_t slot = 0;
+            auto found = m_slots.find(light.get());
+            if (found == m_slots.end())
             {
-                m_lightTransforms = device.createBufferSRV(BufferDescription()
-                    .name("lightTransforms")
-                    .usage(ResourceUsage::GpuReadWrite)
-                    .structured(true)
-                    .elements(transforms.size())
-                    .elementSize(sizeof(float4x4))
-                    .setInitialData(BufferDescription::InitialData(transforms)));
-
-                m_lightWorlPositions = device.createBufferSRV(BufferDescription()
-                    .name("lightPositions")
-                    .format(Format::R32G32B32A32_FLOAT)
-                    .setInitialData(BufferDescription::InitialData(positions)));
-
-                m_lightDirections = device.createBufferSRV(BufferDescription()
-                    .name("lightDirections")
-                    .format(Format::R32G32B32A32_FLOAT)
-                    .setInitialData(BufferDescription::InitialData(directions)));
-
-                m_lightColors = device.createBufferSRV(BufferDescription()
-                    .name("lightColors")
-                    .format(Format::R32G32B32A32_FLOAT)
-                    .setInitialData(BufferDescription::InitialData(colors)));
-
-                m_lightIntensities = device.createBufferSRV(BufferDescription()
-                    .name("lightIntensities")
-                    .format(Format::R32_FLOAT)
-                    .setInitialData(BufferDescription::InitialData(intensities)));
-
-				if(ranges.size() > 0)
-                m_lightRanges = device.createBufferSRV(BufferDescription()
-                    .name("lightRanges")
-                    .format(Format::R32_FLOAT)
-                    .setInitialData(BufferDescription::InitialData(ranges)));
-
-				if(spotranges.size() > 0)
-					m_spotLightRanges = device.createBufferSRV(BufferDescription()
-						.name("spotLightRanges")
-						.format(Format::R32_FLOAT)
-						.setInitialData(BufferDescription::InitialData(spotranges)));
-
-				if(pointranges.size() > 0)
-					m_pointLightRanges = device.createBufferSRV(BufferDescription()
-						.name("pointLightRanges")
-						.format(Format::R32_FLOAT)
-						.setInitialData(BufferDescription::InitialData(pointranges)));
-
-				if (spotids.size() > 0)
-					m_spotLightIds = device.createBufferSRV(BufferDescription()
-						.name("spotLightIds")
-						.format(Format::R32_UINT)
-						.setInitialData(BufferDescription::InitialData(spotids)));
-
-				if (pointids.size() > 0)
-					m_pointLightIds = device.createBufferSRV(BufferDescription()
-						.name("pointLightIds")
-						.format(Format::R32_UINT)
-						.setInitialData(BufferDescription::InitialData(pointids)));
-
-                m_lightTypes = device.createBufferSRV(BufferDescription()
-                    .name("lightTypes")
-                    .format(Format::R32_UINT)
-                    .setInitialData(BufferDescription::InitialData(types)));
-
-                m_lightParameters = device.createBufferSRV(BufferDescription()
-                    .name("lightParameters")
-                    .format(Format::R32G32B32A32_FLOAT)
-                    .setInitialData(BufferDescription::InitialData(parameters)));
-
-				if(spottransforms.size() > 0)
-					m_spotLightTransforms = device.createBufferSRV(BufferDescription()
-						.name("spotTransforms")
-						.usage(ResourceUsage::GpuReadWrite)
-						.structured(true)
-						.elements(spottransforms.size())
-						.elementSize(sizeof(float4x4))
-						.setInitialData(BufferDescription::InitialData(spottransforms)));
+                slot = allocateSlot(light);
+                dirty = allFields;
+                repack = true;
+                ++m_statistics.lightsAdded;
             }
             else
+                slot = found->second;
+
+            if (m_seen[slot] == m_frame)
+                continue;
+            m_seen[slot] = m_frame;
+            ++seen;
+
+            // the scene flags every light as moved, so compare instead
+            if (memcmp(&m_transforms[slot], &node.transform, sizeof(Matrix4f)) != 0)
+                dirty |= fieldBit(FieldTransform);
+            if (m_positions[slot] != node.position)
+                dirty |= fieldBit(FieldPosition);
+            if (m_directions[slot] != node.direction)
+                dirty |= fieldBit(FieldDirection);
+
+            // these clear the flags, so all of them have to be asked
+            if (light->colorChanged(true))
+                dirty |= fieldBit(FieldColor);
+            if (light->intensityChanged(true))
+                dirty |= fieldBit(FieldIntensity);
+            if (light->rangeChanged(true))
+                dirty |= fieldBit(FieldRange);
+            if (light->lightTypeChanged(true))
+                dirty |= fieldBit(FieldType);
+            if (light->lightParametersChanged(true))
+                dirty |= fieldBit(FieldParameters);
+
+            m_shadowCaster[slot] = node.shadowCaster;
+
+            if (dirty == 0)
+                continue;
+
+            if (dirty & fieldBit(FieldTransform))
+                m_transforms[slot] = node.transform;
+            if (dirty & fieldBit(FieldPosition))
+            {
+                m_positions[slot] = node.position;
+                m_gpuPositions[slot] = Vector4f(node.position, 1.0f);
+            }
+            if (dirty & fieldBit(FieldDirection))
+            {
+                m_directions[slot] = node.direction;
+                m_gpuDirections[slot] = Vector4f(node.direction, 1.0f);
+            }
+            if (dirty & fieldBit(FieldColor))
+                m_colors[slot] = Vector4f(light->color(), 1.0f);
+            if (dirty & fieldBit(FieldIntensity))
+                m_intensities[slot] = light->intensity();
+            if (dirty & fieldBit(FieldRange))
+                m_ranges[slot] = light->range();
+            if (dirty & fieldBit(FieldType))
             {
-				m_lightWorlPositions = {};
-                m_lightDirections = {};
-                m_lightColors = {};
-                m_lightIntensities = {};
-                m_lightRanges = {};
-				m_spotLightRanges = {};
-				m_pointLightRanges = {};
-				m_spotLightIds = {};
-				m_pointLightIds = {};
-                m_lightTypes = {};
-                m_lightParameters = {};
-				m_spotLightTransforms = {};
+                auto type = static_cast<unsigned int>(light->lightType());
+                repack |= m_types[slot] != type;
+                m_types[slot] = type;
             }
+            if (dirty & fieldBit(FieldParameters))
+                m_parameters[slot] = light->parameters();
+
+            if (dirty != allFields)
+                ++m_statistics.lightsChanged;
+            m_changeHappened |= (dirty & changeFields) != 0;
+            markDirty(slot, dirty);
         }
-        else
+
+        // the lights that were not in the list are gone
+        if (seen < m_activeCount)
         {
-            if (m_lightCount == 0)
+            for (uint32_t slot = 0; slot < m_lightCount; ++slot)
             {
-                m_lightWorlPositions = {};
-                m_lightDirections = {};
-                m_lightColors = {};
-                m_lightIntensities = {};
-                m_lightRanges = {};
-				m_spotLightRanges = {};
-				m_pointLightRanges = {};
-				m_spotLightIds = {};
-				m_pointLightIds = {};
-                m_lightTypes = {};
-                m_lightParameters = {};
-				m_spotLightTransforms = {};
+                if (m_components[slot] && m_seen[slot] != m_frame)
+                {
+                    freeSlot(slot);
+                    ++m_statistics.lightsRemoved;
+                }
             }
-            else
+            repack = true;
+
+            // free slots at the end are dropped so that count() follows
+            // the scene down again
+            uint32_t count = m_lightCount;
+            while (count > 0 && !m_components[count - 1])
+                --count;
+            if (count < m_lightCount)
             {
-                // update existing
-                if (positionsChanged)
-                    device.uploadBuffer(commandList, m_lightWorlPositions, ByteRange{ positions });
+                m_freeSlots.erase(std::remove_if(m_freeSlots.begin(), m_freeSlots.end(),
+                    [count](uint32_t slot) { return slot >= count; }), m_freeSlots.end());
+                m_dirtySlots.erase(std::remove_if(m_dirtySlots.begin(), m_dirtySlots.end(),
+                    [count](uint32_t slot) { return slot >= count; }), m_dirtySlots.end());
+
+                m_lightCount = count;
+                m_transforms.resize(count);
+                m_positions.resize(count);
+                m_directions.resize(count);
+                m_ranges.resize(count);
+                m_types.resize(count);
+                m_shadowCaster.resize(count);
+                m_parameters.resize(count);
+                m_gpuPositions.resize(count);
+                m_gpuDirections.resize(count);
+                m_colors.resize(count);
+                m_intensities.resize(count);
+                m_packedIndex.resize(count);
+                m_components.resize(count);
+                m_seen.resize(count);
+                m_dirty.resize(count);
+            }
+        }
+
+        if (repack)
+        {
+            m_changeHappened = true;
+            packSpotsAndPoints();
+        }
+        else
+        {
+            m_dirtySpots.clear();
+            m_dirtyPoints.clear();
+            for (auto&& slot : m_dirtySlots)
+            {
+                auto packed = m_packedIndex[slot];
+                if (m_types[slot] == static_cast<unsigned int>(LightType::Spot) &&
+                    (m_dirty[slot] & (fieldBit(FieldTransform) | fieldBit(FieldRange))))
+                {
+                    m_spottransforms[packed] = m_transforms[slot];
+                    m_spotranges[packed] = m_ranges[slot];
+                    m_dirtySpots.emplace_back(packed);
+                }
+                else if (m_types[slot] == static_cast<unsigned int>(LightType::Point) &&
+                    (m_dirty[slot] & fieldBit(FieldRange)))
+                {
+                    m_pointranges[packed] = m_ranges[slot];
+                    m_dirtyPoints.emplace_back(packed);
+                }
+            }
+        }
+
+        queueUploads(repack);
 
-                if (directionsChanged)
-                    device.uploadBuffer(commandList, m_lightDirections, ByteRange{ directions });
+        for (auto&& slot : m_dirtySlots)
+            m_dirty[slot] = 0;
+        m_dirtySlots.clear();
+    }
 
-                if (colorsChanged)
-                    device.uploadBuffer(commandList, m_lightColors, ByteRange{ colors });
+    void LightData::packSpotsAndPoints()
+    {
+        m_spotids.clear();
+        m_spotranges.clear();
+        m_spottransforms.clear();
+        m_pointids.clear();
+        m_pointranges.clear();
 
-                if (intensitiesChanged)
-                    device.uploadBuffer(commandList, m_lightIntensities, ByteRange{ intensities });
+        for (uint32_t slot = 0; slot < m_lightCount; ++slot)
+        {
+            if (m_types[slot] == static_cast<unsigned int>(LightType::Spot))
+            {
+                m_packedIndex[slot] = static_cast<uint32_t>(m_spotids.size());
+                m_spotids.emplace_back(slot);
+                m_spotranges.emplace_back(m_ranges[slot]);
+                m_spottransforms.emplace_back(m_transforms[slot]);
+            }
+            else if (m_types[slot] == static_cast<unsigned int>(LightType::Point))
+            {
+                m_packedIndex[slot] = static_cast<uint32_t>(m_pointids.size());
+                m_pointids.emplace_back(slot);
+                m_pointranges.emplace_back(m_ranges[slot]);
+            }
+            else
+                m_packedIndex[slot] = InvalidLightIndex;
+        }
+    }
 
-                if (rangesChanged && m_lightRanges)
-                    device.uploadBuffer(commandList, m_lightRanges, ByteRange{ ranges });
+    void LightData::queueUploads(bool repacked)
+    {
+        if (m_lightCount == 0)
+            return;
 
-				if (rangesChanged && m_spotLightRanges)
-					device.uploadBuffer(commandList, m_spotLightRanges, ByteRange{ spotranges });
+        // new buffers start empty, so they get everything
+        auto capacity = grow(m_capacity, m_lightCount, MinLightCapacity);
+        bool recreate = capacity != m_capacity;
+        m_capacity = capacity;
 
-				if (rangesChanged && m_pointLightRanges)
-					device.uploadBuffer(commandList, m_pointLightRanges, ByteRange{ pointranges });
+        capacity = grow(m_spotCapacity, spotCount(), MinPackedLightCapacity);
+        bool recreateSpots = capacity != m_spotCapacity;
+        m_spotCapacity = capacity;
 
-				if (rangesChanged && m_spotLightIds)
-					device.uploadBuffer(commandList, m_spotLightIds, ByteRange{ spotids });
+        capacity = grow(m_pointCapacity, pointCount(), MinPackedLightCapacity);
+        bool recreatePoints = capacity != m_pointCapacity;
+        m_pointCapacity = capacity;
 
-				if (rangesChanged && m_pointLightIds)
-					device.uploadBuffer(commandList, m_pointLightIds, ByteRange{ pointids });
+        m_recreate |= recreate;
+        m_recreateSpots |= recreateSpots;
+        m_recreatePoints |= recreatePoints;
 
-                if (typesChanged)
-                    device.uploadBuffer(commandList, m_lightTypes, ByteRange{ types });
+        if (recreate)
+        {
+            for (int field = 0; field < SlotFieldCount; ++field)
+                queueUpload(static_cast<Field>(field), 0, m_lightCount);
+        }
+        else
+        {
+            std::sort(m_dirtySlots.begin(), m_dirtySlots.end());
+            for (int field = 0; field < SlotFieldCount; ++field)
+                queueRuns(static_cast<Field>(field), m_dirtySlots, fieldBit(field));
+        }
 
-                if (parametersChanged)
-                    device.uploadBuffer(commandList, m_lightParameters, ByteRange{ parameters });
+        if (recreateSpots || repacked)
+        {
+            queueUpload(FieldSpotTransform, 0, spotCount());
+            queueUpload(FieldSpotRange, 0, spotCount());
+            queueUpload(FieldSpotId, 0, spotCount());
+        }
+        else
+        {
+            std::sort(m_dirtySpots.begin(), m_dirtySpots.end());
+            queueRuns(FieldSpotTransform, m_dirtySpots, 0);
+            queueRuns(FieldSpotRange, m_dirtySpots, 0);
+        }
 
-                if (rangesChanged || positionsChanged || directionsChanged)
-                    device.uploadBuffer(commandList, m_lightTransforms, ByteRange{ transforms });
+        if (recreatePoints || repacked)
+        {
+            queueUpload(FieldPointRange, 0, pointCount());
+            queueUpload(FieldPointId, 0, pointCount());
+        }
+        else
+        {
+            std::sort(m_dirtyPoints.begin(), m_dirtyPoints.end());
+            queueRuns(FieldPointRange, m_dirtyPoints, 0);
+        }
+    }
 
-				if ((rangesChanged || positionsChanged || directionsChanged) && m_spotLightTransforms)
-					device.uploadBuffer(commandList, m_spotLightTransforms, ByteRange{ spottransforms });
+    void LightData::queueRuns(Field field, const engine::vector<uint32_t>& sortedIndexes, uint16_t slotFields)
+    {
+        uint32_t first = 0;
+        uint32_t last = 0;
+        bool open = false;
+        for (auto&& index : sortedIndexes)
+        {
+            if (slotFields && !(m_dirty[index] & slotFields))
+                continue;
+
+            if (open && index <= last + MaxLightUploadGap + 1)
+            {
+                last = index;
+                continue;
             }
+            if (open)
+                queueUpload(field, first, last - first + 1);
+            first = last = index;
+            open = true;
+        }
+        if (open)
+            queueUpload(field, first, last - first + 1);
+    }
+
+    void LightData::queueUpload(Field field, uint32_t first, uint32_t count)
+    {
+        if (count == 0)
+            return;
+        m_uploads.emplace_back(PendingUpload{ field, first, count });
+        ++m_statistics.uploads;
+        m_statistics.bytes += count * elementSize(field);
+    }
+
+    size_t LightData::elementSize(Field field) const
+    {
+        switch (field)
+        {
+            case FieldTransform:
+            case FieldSpotTransform: return sizeof(Matrix4f);
+            case FieldPosition:
+            case FieldDirection:
+            case FieldColor:
+            case FieldParameters: return sizeof(Vector4f);
+            case FieldIntensity:
+            case FieldRange:
+            case FieldSpotRange:
+            case FieldPointRange: return sizeof(float);
+            case FieldType: return sizeof(unsigned int);
+            case FieldSpotId:
+            case FieldPointId: return sizeof(uint32_t);
+            default: return 0;
+        }
+    }
+
+    void LightData::createBuffers(Device& device)
+    {
+        if (m_recreate)
+        {
+            m_lightTransforms = device.createBufferSRV(BufferDescription()
+                .name("lightTransforms")
+                .usage(ResourceUsage::GpuReadWrite)
+                .structured(true)
+                .elements(m_capacity)
+                .elementSize(sizeof(float4x4)));
+
+            m_lightWorlPositions = device.createBufferSRV(BufferDescription()
+                .name("lightPositions")
+                .format(Format::R32G32B32A32_FLOAT)
+                .elements(m_capacity));
+
+            m_lightDirections = device.createBufferSRV(BufferDescription()
+                .name("lightDirections")
+                .format(Format::R32G32B32A32_FLOAT)
+                .elements(m_capacity));
+
+            m_lightColors = device.createBufferSRV(BufferDescription()
+                .name("lightColors")
+                .format(Format::R32G32B32A32_FLOAT)
+                .elements(m_capacity));
+
+            m_lightIntensities = device.createBufferSRV(BufferDescription()
+                .name("lightIntensities")
+                .format(Format::R32_FLOAT)
+                .elements(m_capacity));
+
+            m_lightRanges = device.createBufferSRV(BufferDescription()
+                .name("lightRanges")
+                .format(Format::R32_FLOAT)
+                .elements(m_capacity));
+
+            m_lightTypes = device.createBufferSRV(BufferDescription()
+                .name("lightTypes")
+                .format(Format::R32_UINT)
+                .elements(m_capacity));
+
+            m_lightParameters = device.createBufferSRV(BufferDescription()
+                .name("lightParameters")
+                .format(Format::R32G32B32A32_FLOAT)
+                .elements(m_capacity));
+
+            m_recreate = false;
+        }
+
+        if (m_recreateSpots)
+        {
+            m_spotLightRanges = device.createBufferSRV(BufferDescription()
+                .name("spotLightRanges")
+                .format(Format::R32_FLOAT)
+                .elements(m_spotCapacity));
+
+            m_spotLightIds = device.createBufferSRV(BufferDescription()
+                .name("spotLightIds")
+                .format(Format::R32_UINT)
+                .elements(m_spotCapacity));
+
+            m_spotLightTransforms = device.createBufferSRV(BufferDescription()
+                .name("spotTransforms")
+                .usage(ResourceUsage::GpuReadWrite)
+                .structured(true)
+                .elements(m_spotCapacity)
+                .elementSize(sizeof(float4x4)));
+
+            m_recreateSpots = false;
         }
 
+        if (m_recreatePoints)
+        {
+            m_pointLightRanges = device.createBufferSRV(BufferDescription()
+                .name("pointLightRanges")
+                .format(Format::R32_FLOAT)
+                .elements(m_pointCapacity));
+
+            m_pointLightIds = device.createBufferSRV(BufferDescription()
+                .name("pointLightIds")
+                .format(Format::R32_UINT)
+                .elements(m_pointCapacity));
+
+            m_recreatePoints = false;
+        }
+    }
+
+    void LightData::upload(Device& device, CommandList& commandList)
+    {
+        if (m_lightCount == 0)
+        {
+            m_lightTransforms = {};
+            m_lightWorlPositions = {};
+            m_lightDirections = {};
+            m_lightColors = {};
+            m_lightIntensities = {};
+            m_lightRanges = {};
+            m_spotLightRanges = {};
+            m_pointLightRanges = {};
+            m_spotLightIds = {};
+            m_pointLightIds = {};
+            m_lightTypes = {};
+            m_lightParameters = {};
+            m_spotLightTransforms = {};
+            m_capacity = 0;
+            m_spotCapacity = 0;
+            m_pointCapacity = 0;
+            return;
+        }
+
+        createBuffers(device);
+
+        for (auto&& upload : m_uploads)
+        {
+            auto first = upload.first;
+            auto end = upload.first + upload.count;
+            switch (upload.field)
+            {
+                case FieldTransform: device.uploadBuffer(commandList, m_lightTransforms, ByteRange{ m_transforms.data() + first, m_transforms.data() + end }, first); break;
+                case FieldPosition: device.uploadBuffer(commandList, m_lightWorlPositions, ByteRange{ m_gpuPositions.data() + first, m_gpuPositions.data() + end }, first); break;
+                case FieldDirection: device.uploadBuffer(commandList, m_lightDirections, ByteRange{ m_gpuDirections.data() + first, m_gpuDirections.data() + end }, first); break;
+                case FieldColor: device.uploadBuffer(commandList, m_lightColors, ByteRange{ m_colors.data() + first, m_colors.data() + end }, first); break;
+                case FieldIntensity: device.uploadBuffer(commandList, m_lightIntensities, ByteRange{ m_intensities.data() + first, m_intensities.data() + end }, first); break;
+                case FieldRange: device.uploadBuffer(commandList, m_lightRanges, ByteRange{ m_ranges.data() + first, m_ranges.data() + end }, first); break;
+                case FieldType: device.uploadBuffer(commandList, m_lightTypes, ByteRange{ m_types.data() + first, m_types.data() + end }, first); break;
+                case FieldParameters: device.uploadBuffer(commandList, m_lightParameters, ByteRange{ m_parameters.data() + first, m_parameters.data() + end }, first); break;
+                case FieldSpotTransform: device.uploadBuffer(commandList, m_spotLightTransforms, ByteRange{ m_spottransforms.data() + first, m_spottransforms.data() + end }, first); break;
+                case FieldSpotRange: device.uploadBuffer(commandList, m_spotLightRanges, ByteRange{ m_spotranges.data() + first, m_spotranges.data() + end }, first); break;
+                case FieldSpotId: device.uploadBuffer(commandList, m_spotLightIds, ByteRange{ m_spotids.data() + first, m_spotids.data() + end }, first); break;
+                case FieldPointRange: device.uploadBuffer(commandList, m_pointLightRanges, ByteRange{ m_pointranges.data() + first, m_pointranges.data() + end }, first); break;
+                case FieldPointId: device.uploadBuffer(commandList, m_pointLightIds, ByteRange{ m_pointids.data() + first, m_pointids.data() + end }, first); break;
+                default: break;
+            }
+        }
+        m_uploads.clear();
     }
 }
@@ -1,5 +1,7 @@
 #include "engine/rendering/Mesh.h"
+#include "engine/rendering/SubMeshStreaming.h"
 #include "tools/Debug.h"
+#include <algorithm>
 
 using namespace engine;
 
@@ -19,6 +21,99 @@ namespace engine
         return MeshVersion{};
     }
 
+    void mergeMeshMemory(engine::vector<engine::vector<char>>& parts, engine::vector<char>& mem)
+    {
+        // the mesh file is a version header followed by submeshes.
+        // each submesh is a block count and that many (header, payload) blocks
+        // so we can copy them through without understanding the contents.
+        using BlockCount = int;
+
+        CompressedFile dst;
+        dst.open(mem, std::ios::out | std::ios::binary);
+        if (!dst.is_open())
+            return;
+
+        dst.write(reinterpret_cast<const char*>(&Mesh::SupportedMeshVersion), sizeof(MeshVersion));
+
+        engine::vector<char> payload;
+        for (auto&& part : parts)
+        {
+            if (part.size() == 0)
+                continue;
+
+            CompressedFile src;
+            src.open(part, std::ios::in | std::ios::binary);
+            if (!src.is_open())
+                continue;
+
+            MeshVersion version;
+            src.read(reinterpret_cast<char*>(&version), sizeof(MeshVersion));
+            ASSERT(version == Mesh::SupportedMeshVersion, "Tried to merge unsupported mesh version: %u", version);
+
+            while (true)
+            {
+                BlockCount blocks;
+                src.read(reinterpret_cast<char*>(&blocks), sizeof(BlockCount));
+                if (src.eof())
+                    break;
+
+                dst.write(reinterpret_cast<const char*>(&blocks), sizeof(BlockCount));
+                for (BlockCount i = 0; i < blocks; ++i)
+                {
+                    MeshBlockHeader header;
+                    src.read(reinterpret_cast<char*>(&header), sizeof(MeshBlockHeader));
+                    payload.resize(header.size_bytes);
+                    if (header.size_bytes > 0)
+                        src.read(payload.data(), static_cast<std::streamsize>(header.size_bytes));
+
+                    dst.write(reinterpret_cast<const char*>(&header), sizeof(MeshBlockHeader));
+                    if (header.size_bytes > 0)
+                        dst.write(payload.data(), static_cast<std::streamsize>(header.size_bytes));
+                }
+            }
+            src.close();
+        }
+        dst.close();
+    }
+
+    engine::vector<ModelPartMeshes> splitModelParts(
+        const engine::vector<uint32_t>& meshIndexCounts,
+        size_t maxParts,
+        uint64_t partIndexes)
+    {
+        uint64_t totalIndexes = 0;
+        for (auto&& count : meshIndexCounts)
+            totalIndexes += count;
+
+        partIndexes = std::max(partIndexes, static_cast<uint64_t>(1));
+        auto partCount = (totalIndexes + partIndexes - 1) / partIndexes;
+        partCount = std::min(partCount, static_cast<uint64_t>(std::max(maxParts, static_cast<size_t>(1))));
+        partCount = std::min(partCount, static_cast<uint64_t>(meshIndexCounts.size()));
+        partCount = std::max(partCount, static_cast<uint64_t>(1));
+
+        // a part ends at the first mesh that reaches it's share of the indexes.
+        // every part keeps at least one mesh so the ones after it have some left.
+        engine::vector<ModelPartMeshes> parts;
+        uint32_t meshCount = static_cast<uint32_t>(meshIndexCounts.size());
+        uint32_t mesh = 0;
+        uint64_t accumulated = 0;
+        for (uint64_t part = 0; part < partCount; ++part)
+        {
+            ModelPartMeshes range{ mesh, 0 };
+            auto target = (totalIndexes * (part + 1)) / partCount;
+            auto partsLeft = static_cast<uint32_t>(partCount - part - 1);
+            while (mesh < meshCount - partsLeft &&
+                (range.count == 0 || accumulated < target || part == partCount - 1))
+            {
+                accumulated += meshIndexCounts[mesh];
+                ++mesh;
+                ++range.count;
+            }
+            parts.emplace_back(range);
+        }
+        return parts;
+    }
+
     Mesh::Mesh()
     {
     }
@@ -26,32 +121,58 @@ namespace engine
     Mesh::Mesh(ResidencyManagerV2& residency, ModelResources& modelResources, const string& filename)
         : m_filename{ filename }
     {
-        if (getMeshVersion(filename) == SupportedMeshVersion)
+        load(residency, modelResources);
+    }
+
+    void Mesh::load(ResidencyManagerV2& residency, ModelResources& modelResources)
+    {
+        if (read())
         {
-            load(residency, modelResources);
+            ResidencySubMeshUploadBackend backend(residency, modelResources);
+            schedule(backend);
         }
     }
 
-    void Mesh::load(ResidencyManagerV2& residency, ModelResources& modelResources)
+    bool Mesh::read()
     {
         CompressedFile file;
         file.open(m_filename, std::ios::in | std::ios::binary);
-        if (file.is_open())
+        if (!file.is_open())
+            return false;
+
+        MeshVersion version;
+        file.read(reinterpret_cast<char*>(&version), sizeof(MeshVersion));
+        if (file.eof() || version != SupportedMeshVersion)
         {
-            MeshVersion version;
-            file.read(reinterpret_cast<char*>(&version), sizeof(MeshVersion));
+            file.close();
+            return false;
+        }
 
-            while (!file.eof())
+        while (!file.eof())
+        {
+            m_subMeshes.emplace_back(SubMesh());
+            if (!m_subMeshes.back().read(file))
             {
-                m_subMeshes.emplace_back(SubMesh());
-                if (!m_subMeshes.back().load(residency, modelResources, file))
-                {
-                    m_subMeshes.pop_back();
-                }
+                m_subMeshes.pop_back();
             }
-
-            file.close();
         }
+
+        file.close();
+        return true;
+    }
+
+    void Mesh::schedule(SubMeshUploadBackend& backend)
+    {
+        for (auto&& subMesh : m_subMeshes)
+            subMesh.schedule(backend);
+    }
+
+    size_t Mesh::stagedBytes() const
+    {
+        size_t bytes = 0;
+        for (auto&& subMesh : m_subMeshes)
+            bytes += subMesh.stagedBytes();
+        return bytes;
     }
 
     void Mesh::save()
@@ -101,4 +222,12 @@ namespace engine
         return m_subMeshes;
     }
 
+    bool Mesh::resident() const
+    {
+        for (auto&& subMesh : m_subMeshes)
+            if (!subMesh.resident())
+                return false;
+        return true;
+    }
+
 }
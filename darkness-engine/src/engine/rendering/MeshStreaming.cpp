@@ -0,0 +1,217 @@
+#include "engine/rendering/MeshStreaming.h"
+#include "engine/rendering/Mesh.h"
+#include "engine/rendering/SubMeshStreaming.h"
+#include "tools/Debug.h"
+
+using namespace engine;
+
+namespace engine
+{
+    MeshRequest::MeshRequest(const engine::string& filename, ResidencyPriority priority)
+        : m_filename{ filename }
+        , m_priority{ priority }
+        , m_state{ MeshRequestState::Queued }
+        , m_sequence{ 0 }
+    {}
+
+    const engine::string& MeshRequest::filename() const
+    {
+        return m_filename;
+    }
+
+    MeshRequestState MeshRequest::state() const
+    {
+        return m_state;
+    }
+
+    bool MeshRequest::ready() const
+    {
+        return m_state == MeshRequestState::Ready;
+    }
+
+    bool MeshRequest::failed() const
+    {
+        return m_state == MeshRequestState::Failed;
+    }
+
+    engine::shared_ptr<Mesh> MeshRequest::mesh() const
+    {
+        return ready() ? m_mesh : nullptr;
+    }
+
+    ResidencyPriority MeshRequest::priority() const
+    {
+        return m_priority;
+    }
+
+    void MeshRequest::priority(ResidencyPriority priority)
+    {
+        m_priority = priority;
+    }
+
+    MeshStreamer::MeshStreamer(size_t readAheadBytes)
+        : m_readAheadBytes{ readAheadBytes }
+        , m_readBytes{ 0 }
+        , m_sequence{ 0 }
+        , m_generation{ 0 }
+        , m_alive{ true }
+    {
+        m_reader = std::thread([this]() { this->reader(); });
+    }
+
+    MeshStreamer::~MeshStreamer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_alive = false;
+        }
+        m_work.notify_all();
+        m_reader.join();
+
+        // nobody is going to read these anymore
+        for (auto&& request : m_queued)
+            request->m_state = MeshRequestState::Failed;
+    }
+
+    engine::shared_ptr<MeshRequest> MeshStreamer::request(const engine::string& filename, ResidencyPriority priority)
+    {
+        auto request = engine::make_shared<MeshRequest>(filename, priority);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            request->m_sequence = m_sequence++;
+            m_queued.emplace_back(request);
+        }
+        m_work.notify_one();
+        return request;
+    }
+
+    engine::shared_ptr<MeshRequest> MeshStreamer::next()
+    {
+        auto best = m_queued.begin();
+        for (auto request = m_queued.begin(); request != m_queued.end(); ++request)
+        {
+            auto priority = (*request)->priority();
+            auto bestPriority = (*best)->priority();
+            if (priority < bestPriority ||
+                (priority == bestPriority && (*request)->m_sequence < (*best)->m_sequence))
+                best = request;
+        }
+        auto result = *best;
+        m_queued.erase(best);
+        return result;
+    }
+
+    void MeshStreamer::reader()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            // the first read always goes through so a mesh bigger
+            // than the read-ahead does not stall the reader
+            m_work.wait(lock, [&]() { return !m_alive || (m_queued.size() > 0 && m_readBytes < m_readAheadBytes); });
+            if (!m_alive)
+                return;
+
+            auto request = next();
+            auto generation = m_generation;
+            lock.unlock();
+
+            auto mesh = engine::make_shared<Mesh>();
+            mesh->setFilename(request->filename());
+            bool read = mesh->read();
+            if (!read)
+                LOG_WARNING("Could not read mesh: %s", request->filename().c_str());
+
+            lock.lock();
+            if (generation != m_generation)
+            {
+                request->m_state = MeshRequestState::Failed;
+                m_finished.notify_all();
+                continue;
+            }
+
+            if (read)
+            {
+                request->m_mesh = mesh;
+                request->m_state = MeshRequestState::Read;
+                m_readBytes += mesh->stagedBytes();
+            }
+            else
+                request->m_state = MeshRequestState::Failed;
+            m_read.emplace_back(request);
+            m_finished.notify_all();
+        }
+    }
+
+    size_t MeshStreamer::update(SubMeshUploadBackend& backend)
+    {
+        engine::vector<engine::shared_ptr<MeshRequest>> read;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            read.swap(m_read);
+        }
+
+        size_t bytes = 0;
+        for (auto&& request : read)
+        {
+            if (request->m_state != MeshRequestState::Read)
+                continue;
+            bytes += request->m_mesh->stagedBytes();
+            request->m_mesh->schedule(backend);
+            request->m_state = MeshRequestState::Ready;
+        }
+
+        if (bytes > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_readBytes -= bytes;
+            }
+            m_work.notify_one();
+        }
+        return read.size();
+    }
+
+    void MeshStreamer::blockUntilReady(MeshRequest& request, SubMeshUploadBackend& backend)
+    {
+        request.priority(ResidencyPriority::Visible);
+        while (true)
+        {
+            // scheduling what has been read frees the read-ahead
+            // for the request we are waiting for
+            update(backend);
+            if (request.ready() || request.failed())
+                return;
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_finished.wait(lock, [&]() { return m_read.size() > 0 || request.failed() || !m_alive; });
+            if (!m_alive)
+                return;
+        }
+    }
+
+    void MeshStreamer::cancel()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto&& request : m_queued)
+                request->m_state = MeshRequestState::Failed;
+            for (auto&& request : m_read)
+            {
+                request->m_state = MeshRequestState::Failed;
+                request->m_mesh = nullptr;
+            }
+            m_queued.clear();
+            m_read.clear();
+            m_readBytes = 0;
+            ++m_generation;
+        }
+        m_finished.notify_all();
+    }
+
+    MeshStreamerStatistics MeshStreamer::statistics() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return { m_queued.size(), m_read.size(), m_readBytes };
+    }
+}
@@ -0,0 +1,541 @@
+#include "engine/rendering/MeshletCompression.h"
+#include "tools/MeshTools.h"
+#include "tools/CompressedFile.h"
+#include "tools/Debug.h"
+#include "zstd.h"
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+namespace engine
+{
+    namespace
+    {
+        constexpr uint32_t MeshletBlobMagic = 0x4c4d5344; // DSML
+        constexpr uint32_t MeshletBlobVersion = 1;
+        constexpr uint32_t InvalidLocalIndex = 0xffffffff;
+
+        // MeshletBlobHeader::flags
+        constexpr uint32_t EntropyCoded = 1;
+        constexpr uint32_t HasNormals = 2;
+        constexpr uint32_t HasTangents = 4;
+
+        // limits for blobs from outside. the decoded payload is
+        // allocated before anything in it can be checked
+        constexpr uint32_t MeshletMaxChannels = 16;
+        constexpr uint64_t MeshletMaxPayloadBytes = 1ull << 30;
+
+        struct MeshletBlobHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t flags;
+            uint32_t meshletCount;
+            uint32_t vertexCount;
+            uint32_t triangleCount;
+            uint32_t uvChannels;
+            uint32_t colorChannels;
+            float boundsMin[3];
+            float boundsMax[3];
+            uint64_t payloadBytes;
+        };
+        static_assert(sizeof(MeshletBlobHeader) == 64, "MeshletBlobHeader is part of the blob format");
+        static_assert(sizeof(CompressedMeshlet) == 40, "CompressedMeshlet is part of the blob format");
+
+        // streams in the payload start 8 byte aligned
+        size_t alignStream(size_t bytes)
+        {
+            return (bytes + 7) & ~static_cast<size_t>(7);
+        }
+
+        uint16_t quantizeUnorm16(float value)
+        {
+            return static_cast<uint16_t>(std::min(std::max(value, 0.0f), 1.0f) * 65535.0f + 0.5f);
+        }
+
+        uint32_t packOctahedron(const Vector3f& value)
+        {
+            auto oct = packNormalOctahedron(value);
+            return static_cast<uint32_t>(quantizeUnorm16(oct.x)) | (static_cast<uint32_t>(quantizeUnorm16(oct.y)) << 16);
+        }
+
+        Vector3f unpackOctahedron(uint32_t value)
+        {
+            return unpackNormalOctahedron(Vector2f{
+                static_cast<float>(value & 0xffff) / 65535.0f,
+                static_cast<float>(value >> 16) / 65535.0f });
+        }
+
+        unsigned char quantizeUnorm8(float value)
+        {
+            return static_cast<unsigned char>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+        }
+
+        template<typename T>
+        void writeStream(engine::vector<char>& payload, const engine::vector<T>& data)
+        {
+            auto start = payload.size();
+            payload.resize(alignStream(start + data.size() * sizeof(T)), 0);
+            if (data.size())
+                memcpy(payload.data() + start, data.data(), data.size() * sizeof(T));
+        }
+
+        uint64_t streamBytes(uint64_t count, uint64_t elementBytes)
+        {
+            return alignStream(static_cast<size_t>(count * elementBytes));
+        }
+
+        // payload size writeStream gives for the counts in header. channel
+        // counts are checked first so this can not wrap
+        uint64_t expectedPayloadBytes(const MeshletBlobHeader& header)
+        {
+            uint64_t vertices = header.vertexCount;
+            return
+                streamBytes(header.meshletCount, sizeof(CompressedMeshlet)) +
+                streamBytes(vertices * 3, sizeof(uint16_t)) +
+                ((header.flags & HasNormals) ? streamBytes(vertices, sizeof(uint32_t)) : 0) +
+                ((header.flags & HasTangents) ? streamBytes(vertices, sizeof(uint32_t)) : 0) +
+                header.uvChannels * streamBytes(vertices, sizeof(uint32_t)) +
+                header.colorChannels * streamBytes(vertices, sizeof(engine::Vector4<unsigned char>)) +
+                streamBytes(static_cast<uint64_t>(header.triangleCount) * 3, sizeof(uint8_t));
+        }
+
+        template<typename T>
+        bool readStream(const char*& src, const char* end, engine::vector<T>& data, size_t count)
+        {
+            auto bytes = count * sizeof(T);
+            if (static_cast<size_t>(end - src) < bytes)
+                return false;
+            data.resize(count);
+            if (bytes)
+                memcpy(data.data(), src, bytes);
+            src += std::min(alignStream(bytes), static_cast<size_t>(end - src));
+            return true;
+        }
+    }
+
+    uint16_t floatToHalf(float value)
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(float));
+
+        uint32_t sign = (bits >> 16) & 0x8000;
+        uint32_t exponent = (bits >> 23) & 0xff;
+        uint32_t mantissa = bits & 0x7fffff;
+
+        // inf and nan
+        if (exponent == 0xff)
+            return static_cast<uint16_t>(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+
+        int halfExponent = static_cast<int>(exponent) - 127 + 15;
+        if (halfExponent >= 31)
+            return static_cast<uint16_t>(sign | 0x7c00);
+
+        // denormals, rounded to nearest even
+        if (halfExponent <= 0)
+        {
+            if (halfExponent < -10)
+                return static_cast<uint16_t>(sign);
+            mantissa |= 0x800000;
+            uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+            uint32_t half = mantissa >> shift;
+            uint32_t remainder = mantissa & ((1u << shift) - 1);
+            uint32_t halfway = 1u << (shift - 1);
+            if (remainder > halfway || (remainder == halfway && (half & 1)))
+                ++half;
+            return static_cast<uint16_t>(sign | half);
+        }
+
+        // rounding can carry into the exponent, up to inf
+        uint32_t half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+        uint32_t remainder = mantissa & 0x1fff;
+        if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+            ++half;
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    float halfToFloat(uint16_t value)
+    {
+        uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+        uint32_t exponent = (value >> 10) & 0x1f;
+        uint32_t mantissa = value & 0x3ff;
+
+        if (exponent == 0)
+        {
+            float res = std::ldexp(static_cast<float>(mantissa), -24);
+            return sign ? -res : res;
+        }
+
+        uint32_t bits = exponent == 31 ?
+            sign | 0x7f800000 | (mantissa << 13) :
+            sign | ((exponent + 112) << 23) | (mantissa << 13);
+        float res;
+        memcpy(&res, &bits, sizeof(float));
+        return res;
+    }
+
+    size_t CompressedMesh::vertexCount() const
+    {
+        return position.size() / 3;
+    }
+
+    size_t CompressedMesh::triangleCount() const
+    {
+        return index.size() / 3;
+    }
+
+    size_t CompressedMesh::sizeBytes() const
+    {
+        size_t bytes =
+            meshlets.size() * sizeof(CompressedMeshlet) +
+            position.size() * sizeof(uint16_t) +
+            normal.size() * sizeof(uint32_t) +
+            tangent.size() * sizeof(uint32_t) +
+            index.size() * sizeof(uint8_t);
+        for (auto&& channel : uv)
+            bytes += channel.size() * sizeof(uint32_t);
+        for (auto&& channel : color)
+            bytes += channel.size() * sizeof(engine::Vector4<unsigned char>);
+        return bytes;
+    }
+
+    Vector3f meshletPositionError(const CompressedMeshlet& meshlet)
+    {
+        return meshlet.boundsRange * (0.5f / static_cast<float>(MeshletPositionSteps));
+    }
+
+    CompressedMesh compressMeshlets(const ModelCpu& model)
+    {
+        CompressedMesh mesh;
+        mesh.boundingBox = model.boundingBox;
+        mesh.uv.resize(model.uv.size());
+        mesh.color.resize(model.color.size());
+
+        bool normals = model.normal.size() == model.vertex.size() && model.vertex.size() > 0;
+        bool tangents = model.tangent.size() == model.vertex.size() && model.vertex.size() > 0;
+        ASSERT(model.index.size() % 3 == 0, "Meshlets need whole triangles");
+
+        engine::vector<uint32_t> localIndex(model.vertex.size(), InvalidLocalIndex);
+        engine::vector<uint32_t> vertices;
+        engine::vector<uint8_t> indexes;
+        vertices.reserve(MeshletMaxVertices);
+        indexes.reserve(MeshletMaxTriangles * 3);
+
+        auto flush = [&]()
+        {
+            if (indexes.size() == 0)
+                return;
+
+            CompressedMeshlet meshlet;
+            meshlet.vertexStart = static_cast<uint32_t>(mesh.position.size() / 3);
+            meshlet.triangleStart = static_cast<uint32_t>(mesh.index.size() / 3);
+            meshlet.vertexCount = static_cast<uint32_t>(vertices.size());
+            meshlet.triangleCount = static_cast<uint32_t>(indexes.size() / 3);
+
+            Vector3f minPos = model.vertex[vertices[0]];
+            Vector3f maxPos = minPos;
+            for (auto&& vertex : vertices)
+            {
+                const auto& pos = model.vertex[vertex];
+                minPos = Vector3f{ std::min(minPos.x, pos.x), std::min(minPos.y, pos.y), std::min(minPos.z, pos.z) };
+                maxPos = Vector3f{ std::max(maxPos.x, pos.x), std::max(maxPos.y, pos.y), std::max(maxPos.z, pos.z) };
+            }
+            meshlet.boundsMin = minPos;
+            meshlet.boundsRange = maxPos - minPos;
+
+            Vector3f scale{
+                meshlet.boundsRange.x > 0.0f ? 1.0f / meshlet.boundsRange.x : 0.0f,
+                meshlet.boundsRange.y > 0.0f ? 1.0f / meshlet.boundsRange.y : 0.0f,
+                meshlet.boundsRange.z > 0.0f ? 1.0f / meshlet.boundsRange.z : 0.0f };
+
+            for (auto&& vertex : vertices)
+            {
+                Vector3f local = (model.vertex[vertex] - minPos) * scale;
+                mesh.position.emplace_back(quantizeUnorm16(local.x));
+                mesh.position.emplace_back(quantizeUnorm16(local.y));
+                mesh.position.emplace_back(quantizeUnorm16(local.z));
+
+                if (normals)
+                    mesh.normal.emplace_back(packOctahedron(model.normal[vertex]));
+                if (tangents)
+                    mesh.tangent.emplace_back(packOctahedron(model.tangent[vertex]));
+
+                for (size_t channel = 0; channel < model.uv.size(); ++channel)
+                {
+                    const auto& uv = model.uv[channel][vertex];
+                    mesh.uv[channel].emplace_back(
+                        static_cast<uint32_t>(floatToHalf(uv.x)) |
+                        (static_cast<uint32_t>(floatToHalf(uv.y)) << 16));
+                }
+
+                for (size_t channel = 0; channel < model.color.size(); ++channel)
+                {
+                    const auto& color = model.color[channel][vertex];
+                    mesh.color[channel].emplace_back(engine::Vector4<unsigned char>{
+                        quantizeUnorm8(color.x), quantizeUnorm8(color.y), quantizeUnorm8(color.z), quantizeUnorm8(color.w) });
+                }
+
+                localIndex[vertex] = InvalidLocalIndex;
+            }
+            mesh.index.insert(mesh.index.end(), indexes.begin(), indexes.end());
+            mesh.meshlets.emplace_back(meshlet);
+
+            vertices.clear();
+            indexes.clear();
+        };
+
+        for (size_t i = 0; i + 2 < model.index.size(); i += 3)
+        {
+            const uint32_t* triangle = &model.index[i];
+
+            uint32_t newVertices = 0;
+            for (int c = 0; c < 3; ++c)
+            {
+                bool repeated = (c > 0 && triangle[c] == triangle[0]) || (c > 1 && triangle[c] == triangle[1]);
+                if (localIndex[triangle[c]] == InvalidLocalIndex && !repeated)
+                    ++newVertices;
+            }
+
+            if (vertices.size() + newVertices > MeshletMaxVertices ||
+                indexes.size() == MeshletMaxTriangles * 3)
+                flush();
+
+            for (int c = 0; c < 3; ++c)
+            {
+                auto& local = localIndex[triangle[c]];
+                if (local == InvalidLocalIndex)
+                {
+                    local = static_cast<uint32_t>(vertices.size());
+                    vertices.emplace_back(triangle[c]);
+                }
+                indexes.emplace_back(static_cast<uint8_t>(local));
+            }
+        }
+        flush();
+
+        return mesh;
+    }
+
+    void decodeMeshlet(const CompressedMesh& mesh, size_t meshletIndex, ModelCpu& output)
+    {
+        const auto& meshlet = mesh.meshlets[meshletIndex];
+        auto base = static_cast<uint32_t>(output.vertex.size());
+        auto first = meshlet.vertexStart;
+        auto count = meshlet.vertexCount;
+
+        Vector3f scale = meshlet.boundsRange * (1.0f / static_cast<float>(MeshletPositionSteps));
+        const uint16_t* position = &mesh.position[first * 3];
+        for (uint32_t v = 0; v < count; ++v)
+        {
+            output.vertex.emplace_back(Vector3f{
+                meshlet.boundsMin.x + static_cast<float>(position[v * 3 + 0]) * scale.x,
+                meshlet.boundsMin.y + static_cast<float>(position[v * 3 + 1]) * scale.y,
+                meshlet.boundsMin.z + static_cast<float>(position[v * 3 + 2]) * scale.z });
+        }
+
+        if (mesh.normal.size())
+        {
+            for (uint32_t v = 0; v < count; ++v)
+                output.normal.emplace_back(unpackOctahedron(mesh.normal[first + v]));
+        }
+        if (mesh.tangent.size())
+        {
+            for (uint32_t v = 0; v < count; ++v)
+                output.tangent.emplace_back(unpackOctahedron(mesh.tangent[first + v]));
+        }
+
+        if (output.uv.size() < mesh.uv.size())
+            output.uv.resize(mesh.uv.size());
+        for (size_t channel = 0; channel < mesh.uv.size(); ++channel)
+        {
+            for (uint32_t v = 0; v < count; ++v)
+            {
+                auto uv = mesh.uv[channel][first + v];
+                output.uv[channel].emplace_back(Vector2f{
+                    halfToFloat(static_cast<uint16_t>(uv & 0xffff)),
+                    halfToFloat(static_cast<uint16_t>(uv >> 16)) });
+            }
+        }
+
+        if (output.color.size() < mesh.color.size())
+            output.color.resize(mesh.color.size());
+        for (size_t channel = 0; channel < mesh.color.size(); ++channel)
+        {
+            for (uint32_t v = 0; v < count; ++v)
+            {
+                const auto& color = mesh.color[channel][first + v];
+                output.color[channel].emplace_back(Vector4f{
+                    static_cast<float>(color.x) / 255.0f,
+                    static_cast<float>(color.y) / 255.0f,
+                    static_cast<float>(color.z) / 255.0f,
+                    static_cast<float>(color.w) / 255.0f });
+            }
+        }
+
+        const uint8_t* index = &mesh.index[meshlet.triangleStart * 3];
+        for (uint32_t i = 0; i < meshlet.triangleCount * 3; ++i)
+            output.index.emplace_back(base + index[i]);
+    }
+
+    ModelCpu decompressMeshlets(const CompressedMesh& mesh)
+    {
+        ModelCpu model;
+        auto vertexCount = mesh.vertexCount();
+        model.vertex.reserve(vertexCount);
+        if (mesh.normal.size())
+            model.normal.reserve(vertexCount);
+        if (mesh.tangent.size())
+            model.tangent.reserve(vertexCount);
+        model.uv.resize(mesh.uv.size());
+        for (auto&& channel : model.uv)
+            channel.reserve(vertexCount);
+        model.color.resize(mesh.color.size());
+        for (auto&& channel : model.color)
+            channel.reserve(vertexCount);
+        model.index.reserve(mesh.index.size());
+
+        for (size_t meshlet = 0; meshlet < mesh.meshlets.size(); ++meshlet)
+            decodeMeshlet(mesh, meshlet, model);
+
+        model.boundingBox = mesh.boundingBox;
+        return model;
+    }
+
+    engine::vector<char> packMeshlets(const CompressedMesh& mesh, bool entropyCode)
+    {
+        MeshletBlobHeader header;
+        header.magic = MeshletBlobMagic;
+        header.version = MeshletBlobVersion;
+        header.flags =
+            (entropyCode ? EntropyCoded : 0u) |
+            (mesh.normal.size() ? HasNormals : 0u) |
+            (mesh.tangent.size() ? HasTangents : 0u);
+        header.meshletCount = static_cast<uint32_t>(mesh.meshlets.size());
+        header.vertexCount = static_cast<uint32_t>(mesh.vertexCount());
+        header.triangleCount = static_cast<uint32_t>(mesh.triangleCount());
+        header.uvChannels = static_cast<uint32_t>(mesh.uv.size());
+        header.colorChannels = static_cast<uint32_t>(mesh.color.size());
+        header.boundsMin[0] = mesh.boundingBox.min.x;
+        header.boundsMin[1] = mesh.boundingBox.min.y;
+        header.boundsMin[2] = mesh.boundingBox.min.z;
+        header.boundsMax[0] = mesh.boundingBox.max.x;
+        header.boundsMax[1] = mesh.boundingBox.max.y;
+        header.boundsMax[2] = mesh.boundingBox.max.z;
+
+        engine::vector<char> payload;
+        payload.reserve(mesh.sizeBytes() + 64);
+        writeStream(payload, mesh.meshlets);
+        writeStream(payload, mesh.position);
+        writeStream(payload, mesh.normal);
+        writeStream(payload, mesh.tangent);
+        for (auto&& channel : mesh.uv)
+            writeStream(payload, channel);
+        for (auto&& channel : mesh.color)
+            writeStream(payload, channel);
+        writeStream(payload, mesh.index);
+        header.payloadBytes = payload.size();
+
+        engine::vector<char> result(sizeof(MeshletBlobHeader));
+        memcpy(result.data(), &header, sizeof(MeshletBlobHeader));
+        if (entropyCode)
+        {
+            engine::vector<char> compressed;
+            CompressedFile file;
+            file.open(compressed, std::ios::out | std::ios::binary);
+            file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+            file.close();
+            result.insert(result.end(), compressed.begin(), compressed.end());
+        }
+        else
+            result.insert(result.end(), payload.begin(), payload.end());
+        return result;
+    }
+
+    bool unpackMeshlets(const engine::vector<char>& data, CompressedMesh& mesh)
+    {
+        MeshletBlobHeader header;
+        if (data.size() < sizeof(MeshletBlobHeader))
+        {
+            LOG("Meshlet data was malformed");
+            return false;
+        }
+        memcpy(&header, data.data(), sizeof(MeshletBlobHeader));
+        if (header.magic != MeshletBlobMagic || header.version != MeshletBlobVersion ||
+            header.uvChannels > MeshletMaxChannels || header.colorChannels > MeshletMaxChannels ||
+            header.payloadBytes != expectedPayloadBytes(header) ||
+            header.payloadBytes > MeshletMaxPayloadBytes)
+        {
+            LOG("Meshlet data was malformed");
+            return false;
+        }
+
+        engine::vector<char> decoded;
+        const char* src = data.data() + sizeof(MeshletBlobHeader);
+        const char* end = data.data() + data.size();
+        if (header.flags & EntropyCoded)
+        {
+            // the zstd frame has to say it decodes to exactly the payload
+            // before anything is allocated for it
+            auto frameBytes = ZSTD_getFrameContentSize(src, static_cast<size_t>(end - src));
+            if (frameBytes != header.payloadBytes)
+            {
+                LOG("Meshlet data was malformed");
+                return false;
+            }
+
+            decoded.assign(src, end);
+            CompressedFile file;
+            file.open(decoded, std::ios::in | std::ios::binary, CompressionTypes::Zstd);
+            if (!file.is_open())
+            {
+                LOG("Meshlet data was malformed");
+                return false;
+            }
+            src = decoded.data();
+            end = decoded.data() + decoded.size();
+        }
+        if (static_cast<uint64_t>(end - src) != header.payloadBytes)
+        {
+            LOG("Meshlet data was malformed");
+            return false;
+        }
+
+        size_t vertexCount = header.vertexCount;
+        bool valid =
+            readStream(src, end, mesh.meshlets, header.meshletCount) &&
+            readStream(src, end, mesh.position, vertexCount * 3) &&
+            readStream(src, end, mesh.normal, (header.flags & HasNormals) ? vertexCount : 0) &&
+            readStream(src, end, mesh.tangent, (header.flags & HasTangents) ? vertexCount : 0);
+
+        mesh.uv.resize(header.uvChannels);
+        for (auto&& channel : mesh.uv)
+            valid = valid && readStream(src, end, channel, vertexCount);
+        mesh.color.resize(header.colorChannels);
+        for (auto&& channel : mesh.color)
+            valid = valid && readStream(src, end, channel, vertexCount);
+        valid = valid && readStream(src, end, mesh.index, static_cast<size_t>(header.triangleCount) * 3);
+
+        // the decode trusts the meshlets, so they are checked here
+        for (size_t i = 0; valid && i < mesh.meshlets.size(); ++i)
+        {
+            const auto& meshlet = mesh.meshlets[i];
+            valid =
+                meshlet.vertexCount <= 256 &&
+                meshlet.vertexStart <= vertexCount && meshlet.vertexCount <= vertexCount - meshlet.vertexStart &&
+                meshlet.triangleStart <= header.triangleCount && meshlet.triangleCount <= header.triangleCount - meshlet.triangleStart;
+            for (uint32_t index = 0; valid && index < meshlet.triangleCount * 3; ++index)
+                valid = mesh.index[meshlet.triangleStart * 3 + index] < meshlet.vertexCount;
+        }
+        if (!valid)
+        {
+            LOG("Meshlet data was malformed");
+            mesh = CompressedMesh();
+            return false;
+        }
+
+        mesh.boundingBox = BoundingBox(
+            Vector3f{ header.boundsMin[0], header.boundsMin[1], header.boundsMin[2] },
+            Vector3f{ header.boundsMax[0], header.boundsMax[1], header.boundsMax[2] });
+        return true;
+    }
+}
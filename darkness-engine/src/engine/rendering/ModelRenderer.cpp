@@ -7,6 +7,7 @@
 #include "engine/graphics/Viewport.h"
 #include "engine/graphics/Rect.h"
 #include "engine/graphics/Pipeline.h"
+#include "engine/graphics/PipelinePrewarm.h"
 #include "engine/graphics/Common.h"
 #include "engine/graphics/SwapChain.h"
 #include "shaders/core/shared_types/DebugModes.hlsli"
@@ -227,6 +228,7 @@ namespace engine
         , m_logEnabled{ false }
         , m_debugMenuOpen{ true }
 		, m_forwardRendering{ true }
+        , m_parallelRecording{ false }
         , m_voxelize{ false }
         , m_debugVoxels{ false }
         , m_debugVoxelGrids{ false }
@@ -421,6 +423,13 @@ namespace engine
             m_temporalResolve.emplace_back(std::move(temporalPipe));
         }
 
+        // the culling compute pipelines are created in parallel on the
+        // job system here instead of one by one on the first frame
+        PipelinePrewarm prewarm;
+        m_frustumCuller.prewarm(prewarm);
+        m_occlusionCuller.prewarm(prewarm);
+        m_indexExpansion.prewarm(prewarm);
+        prewarm.wait();
     }
 
     void ModelRenderer::resize(uint32_t width, uint32_t height)
@@ -570,6 +579,7 @@ namespace engine
                 ImGui::Checkbox("SSR Enabled", &m_ssrEnabled);
 				ImGui::Checkbox("Vsync Enabled", &m_vsyncEnabled);
 				ImGui::Checkbox("Forward rendering", &m_forwardRendering);
+				ImGui::Checkbox("Parallel recording", &m_parallelRecording);
                 ImGui::Checkbox("Render transparency", &m_renderTransparency);
                 ImGui::Checkbox("Render histogram debug", &m_histogramDebug);
 				ImGui::Checkbox("Debug bounding boxes", &m_debugBoundingBoxes);
@@ -2528,6 +2538,12 @@ namespace engine
         m_picker.pick(m_gbuffer.get(), cmd, mouseX, mouseY);
     }
 
+    void ModelRenderer::prepareScreenSpace(CommandList& cmd)
+    {
+        // ssao and ssr both sample the normals in a pixel shader
+        cmd.transition(m_gbuffer->srv(GBufferType::Normal), ResourceState::PixelShaderResource);
+    }
+
     void ModelRenderer::renderSSAO(
         Device& device, 
         CommandList& cmd, 
@@ -6,6 +6,12 @@
 namespace engine
 {
 	constexpr int IncreaseMemorySizeBytes = 1024 * 1024 * 1;
+
+    // address space reserved for every buffer when the device has reserved buffers.
+    // typed views can not address more than 2^27 elements
+    constexpr size_t ReservedElementsMax = 1ull << 27;
+    constexpr size_t ReservedBytesMax = 1ull << 31;
+
     ModelResourceAllocator::ModelResourceAllocator(
         Device& device,
 		size_t maxElements,
@@ -22,40 +28,11 @@ namespace engine
         , m_size{ maxElements }
         , m_inUse{ 0ull }
         , m_elementSizeBytes{ 0ull }
+        , m_reserved{ device.reservedBuffersSupported() }
+        , m_reservedElements{ 0ull }
     {
 		if (maxElements > 0)
-		{
-			for (auto&& format : formats)
-			{
-				m_bufferOwnersUAV.emplace_back(device.createBufferUAV(BufferDescription()
-					.format(format)
-					.name(resourceName)
-					.elements(maxElements)
-					.elementSize(formatBytes(format))));
-				m_elementSizeBytes += formatBytes(format);
-
-				m_bufferOwners.emplace_back(device.createBufferSRV(m_bufferOwnersUAV.back()));
-				m_bufferHandles.emplace_back(m_bufferOwners.back());
-				m_bufferHandlesUAV.emplace_back(m_bufferOwnersUAV.back());
-			}
-
-			for (auto&& extraView : extraViews)
-			{
-				for (size_t i = extraView.start; i < extraView.start + extraView.count; ++i)
-				{
-					if (extraView.type == ExtraViewType::Vertex)
-					{
-						m_vertexBufferOwners.emplace_back(device.createBufferVBV(m_bufferOwners[i]));
-						m_vertexBufferHandles.emplace_back(m_vertexBufferOwners.back());
-					}
-					else if (extraView.type == ExtraViewType::Index)
-					{
-						m_indexBufferOwners.emplace_back(device.createBufferIBV(m_bufferOwners[i]));
-						m_indexBufferHandles.emplace_back(m_indexBufferOwners.back());
-					}
-				}
-			}
-		}
+            createBuffers();
     }
 
     ModelResourceAllocator::ModelResourceAllocator(
@@ -72,24 +49,11 @@ namespace engine
         , m_size{ maxElements }
         , m_inUse{ 0ull }
         , m_elementSizeBytes{ 0ull }
+        , m_reserved{ device.reservedBuffersSupported() }
+        , m_reservedElements{ 0ull }
     {
 		if (maxElements > 0)
-		{
-			for (auto&& size : elementSize)
-			{
-				m_bufferOwnersUAV.emplace_back(device.createBufferUAV(BufferDescription()
-					.usage(ResourceUsage::GpuRead)
-					.name(resourceName)
-					.structured(true)
-					.elements(maxElements)
-					.elementSize(size)));
-				m_elementSizeBytes += size;
-
-				m_bufferOwners.emplace_back(device.createBufferSRV(m_bufferOwnersUAV.back()));
-				m_bufferHandles.emplace_back(m_bufferOwners.back());
-				m_bufferHandlesUAV.emplace_back(m_bufferOwnersUAV.back());
-			}
-		}
+            createBuffers();
     }
 
     ModelResourceAllocator::ModelResourceAllocator(
@@ -108,38 +72,100 @@ namespace engine
         , m_size{ maxElements }
         , m_inUse{ 0ull }
         , m_elementSizeBytes{ 0ull }
+        , m_reserved{ device.reservedBuffersSupported() }
+        , m_reservedElements{ 0ull }
     {
 		if (maxElements > 0)
-		{
-			for (auto&& format : formats)
-			{
-				m_bufferOwnersUAV.emplace_back(device.createBufferUAV(BufferDescription()
-					.usage(ResourceUsage::GpuRead)
-					.format(format)
-					.name(resourceName)
-					.elements(maxElements)
-					.elementSize(formatBytes(format))));
-				m_elementSizeBytes += formatBytes(format);
-
-				m_bufferOwners.emplace_back(device.createBufferSRV(m_bufferOwnersUAV.back()));
-				m_bufferHandles.emplace_back(m_bufferOwners.back());
-				m_bufferHandlesUAV.emplace_back(m_bufferOwnersUAV.back());
-			}
-			for (auto&& size : elementSize)
-			{
-				m_bufferOwnersUAV.emplace_back(device.createBufferUAV(BufferDescription()
-					.usage(ResourceUsage::GpuRead)
-					.name(resourceName)
-					.structured(true)
-					.elements(maxElements)
-					.elementSize(size)));
-				m_elementSizeBytes += size;
-
-				m_bufferOwners.emplace_back(device.createBufferSRV(m_bufferOwnersUAV.back()));
-				m_bufferHandles.emplace_back(m_bufferOwners.back());
-				m_bufferHandlesUAV.emplace_back(m_bufferOwnersUAV.back());
-			}
-		}
+            createBuffers();
+    }
+
+    void ModelResourceAllocator::createBuffers()
+    {
+        // reserved buffers get all the address space they can grow to up front.
+        // otherwise the buffers are exactly m_maxElements
+        if (m_reserved)
+            m_reservedElements = std::max(m_maxElements, std::min(ReservedElementsMax, ReservedBytesMax / biggestFormatSize()));
+        auto elements = m_reserved ? m_reservedElements : m_maxElements;
+
+        m_bufferOwners.clear();
+        m_bufferOwnersUAV.clear();
+        m_bufferHandles.clear();
+        m_bufferHandlesUAV.clear();
+        m_vertexBufferOwners.clear();
+        m_indexBufferOwners.clear();
+        m_vertexBufferHandles.clear();
+        m_indexBufferHandles.clear();
+        m_elementSizeBytes = 0;
+
+        if (m_constructor == 0 || m_constructor == 2)
+        {
+            for (auto&& format : m_formats)
+            {
+                m_bufferOwnersUAV.emplace_back(m_device.createBufferUAV(BufferDescription()
+                    .usage(ResourceUsage::GpuRead)
+                    .format(format)
+                    .name(m_resourceName)
+                    .elements(elements)
+                    .elementSize(formatBytes(format))
+                    .reserved(m_reserved)));
+                m_elementSizeBytes += formatBytes(format);
+
+                m_bufferOwners.emplace_back(m_device.createBufferSRV(m_bufferOwnersUAV.back()));
+                m_bufferHandles.emplace_back(m_bufferOwners.back());
+                m_bufferHandlesUAV.emplace_back(m_bufferOwnersUAV.back());
+            }
+        }
+
+        if (m_constructor == 1 || m_constructor == 2)
+        {
+            for (auto&& size : m_elementSizes)
+            {
+                m_bufferOwnersUAV.emplace_back(m_device.createBufferUAV(BufferDescription()
+                    .usage(ResourceUsage::GpuRead)
+                    .name(m_resourceName)
+                    .structured(true)
+                    .elements(elements)
+                    .elementSize(size)
+                    .reserved(m_reserved)));
+                m_elementSizeBytes += size;
+
+                m_bufferOwners.emplace_back(m_device.createBufferSRV(m_bufferOwnersUAV.back()));
+                m_bufferHandles.emplace_back(m_bufferOwners.back());
+                m_bufferHandlesUAV.emplace_back(m_bufferOwnersUAV.back());
+            }
+        }
+
+        if (m_constructor == 0)
+        {
+            for (auto&& extraView : m_extraViews)
+            {
+                for (size_t i = extraView.start; i < extraView.start + extraView.count; ++i)
+                {
+                    if (extraView.type == ExtraViewType::Vertex)
+                    {
+                        m_vertexBufferOwners.emplace_back(m_device.createBufferVBV(m_bufferOwners[i]));
+                        m_vertexBufferHandles.emplace_back(m_vertexBufferOwners.back());
+                    }
+                    else if (extraView.type == ExtraViewType::Index)
+                    {
+                        m_indexBufferOwners.emplace_back(m_device.createBufferIBV(m_bufferOwners[i]));
+                        m_indexBufferHandles.emplace_back(m_indexBufferOwners.back());
+                    }
+                }
+            }
+        }
+
+        if (m_reserved)
+            commit(m_maxElements);
+    }
+
+    void ModelResourceAllocator::commit(size_t elements)
+    {
+        for (auto&& buffer : m_bufferOwnersUAV)
+        {
+            auto gpuBuffer = buffer.resource().buffer();
+            m_device.commitBuffer(gpuBuffer, elements * gpuBuffer.description().elementSize);
+        }
     }
 
     size_t ModelResourceAllocator::elements() const
@@ -157,6 +183,16 @@ namespace engine
         return m_elementSizeBytes;
     }
 
+    bool ModelResourceAllocator::reserved() const
+    {
+        return m_reserved;
+    }
+
+    size_t ModelResourceAllocator::reservedElements() const
+    {
+        return m_reservedElements;
+    }
+
     engine::vector<BufferSRV>& ModelResourceAllocator::gpuBuffers()
     {
         return m_bufferHandles;
@@ -265,172 +301,40 @@ namespace engine
 
 		m_allocator->resize(tools::ByteRange{ 0ull, newSize });
 
-		switch (m_constructor)
-		{
-			case 0:
-			{
-				m_maxElements = newSize;
-				m_elementSizeBytes = 0;
-
-				engine::vector<BufferSRVOwner> bufferOwners;
-				engine::vector<BufferUAVOwner> bufferOwnersUAV;
-				engine::vector<BufferSRV> bufferHandles;
-				engine::vector<BufferUAV> bufferHandlesUAV;
-				engine::vector<BufferVBVOwner> vertexBufferOwners;
-				engine::vector<BufferIBVOwner> indexBufferOwners;
-				engine::vector<BufferVBV> vertexBufferHandles;
-				engine::vector<BufferIBV> indexBufferHandles;
-				for (auto&& format : m_formats)
-				{
-					bufferOwnersUAV.emplace_back(m_device.createBufferUAV(BufferDescription()
-						.usage(ResourceUsage::GpuRead)
-						.format(format)
-						.name(m_resourceName)
-						.elements(m_maxElements)
-						.elementSize(formatBytes(format))));
-					m_elementSizeBytes += formatBytes(format);
-
-					bufferOwners.emplace_back(m_device.createBufferSRV(bufferOwnersUAV.back()));
-					bufferHandles.emplace_back(bufferOwners.back());
-					bufferHandlesUAV.emplace_back(bufferOwnersUAV.back());
-				}
-
-				for (auto&& extraView : m_extraViews)
-				{
-					for (size_t i = extraView.start; i < extraView.start + extraView.count; ++i)
-					{
-						if (extraView.type == ExtraViewType::Vertex)
-						{
-							vertexBufferOwners.emplace_back(m_device.createBufferVBV(bufferOwners[i]));
-							vertexBufferHandles.emplace_back(vertexBufferOwners.back());
-						}
-						else if (extraView.type == ExtraViewType::Index)
-						{
-							indexBufferOwners.emplace_back(m_device.createBufferIBV(bufferOwners[i]));
-							indexBufferHandles.emplace_back(indexBufferOwners.back());
-						}
-					}
-				}
-
-				auto cmd = m_device.createCommandList("ModelResourceAllocator resize");
-				for (int i = 0; i < m_bufferOwners.size(); ++i)
-				{
-					cmd.copyBuffer(
-						m_bufferOwners[i].resource().buffer(), 
-						bufferOwners[i].resource().buffer(), m_size);
-				}
-				m_device.submitBlocking(cmd);
-
-				m_size = m_maxElements;
-				m_bufferOwners = bufferOwners;
-				m_bufferOwnersUAV = bufferOwnersUAV;
-				m_bufferHandles = bufferHandles;
-				m_bufferHandlesUAV = bufferHandlesUAV;
-				m_vertexBufferOwners = vertexBufferOwners;
-				m_indexBufferOwners = indexBufferOwners;
-				m_vertexBufferHandles = vertexBufferHandles;
-				m_indexBufferHandles = indexBufferHandles;
-
-				break;
-			}
-			case 1:
-			{
-				m_maxElements = newSize;
-				m_elementSizeBytes = 0;
-
-				engine::vector<BufferSRVOwner> bufferOwners;
-				engine::vector<BufferUAVOwner> bufferOwnersUAV;
-				engine::vector<BufferSRV> bufferHandles;
-				engine::vector<BufferUAV> bufferHandlesUAV;
-
-				for (auto&& size : m_elementSizes)
-				{
-					bufferOwnersUAV.emplace_back(m_device.createBufferUAV(BufferDescription()
-						.usage(ResourceUsage::GpuRead)
-						.name(m_resourceName)
-						.structured(true)
-						.elements(m_maxElements)
-						.elementSize(size)));
-					m_elementSizeBytes += size;
-
-					bufferOwners.emplace_back(m_device.createBufferSRV(bufferOwnersUAV.back()));
-					bufferHandles.emplace_back(bufferOwners.back());
-					bufferHandlesUAV.emplace_back(bufferOwnersUAV.back());
-				}
-
-				auto cmd = m_device.createCommandList("ModelResourceAllocator resize");
-				for (int i = 0; i < m_bufferOwners.size(); ++i)
-				{
-					cmd.copyBuffer(
-						m_bufferOwners[i].resource().buffer(),
-						bufferOwners[i].resource().buffer(), m_size);
-				}
-				m_device.submitBlocking(cmd);
-
-				m_size = m_maxElements;
-				m_bufferOwners = bufferOwners;
-				m_bufferOwnersUAV = bufferOwnersUAV;
-				m_bufferHandles = bufferHandles;
-				m_bufferHandlesUAV = bufferHandlesUAV;
-
-				break;
-			}
-			case 2:
-			{
-				m_maxElements = newSize;
-				m_elementSizeBytes = 0;
+        if (m_reserved && newSize <= m_reservedElements && m_bufferOwners.size() > 0)
+        {
+            // the buffers already span newSize elements. they only need memory
+            // behind the new pages so nothing moves and the gpu is not waited on
+            commit(newSize);
+            m_maxElements = newSize;
+            m_size = newSize;
+            return;
+        }
 
-				engine::vector<BufferSRVOwner> bufferOwners;
-				engine::vector<BufferUAVOwner> bufferOwnersUAV;
-				engine::vector<BufferSRV> bufferHandles;
-				engine::vector<BufferUAV> bufferHandlesUAV;
-				for (auto&& format : m_formats)
-				{
-					bufferOwnersUAV.emplace_back(m_device.createBufferUAV(BufferDescription()
-						.usage(ResourceUsage::GpuRead)
-						.format(format)
-						.name(m_resourceName)
-						.elements(m_maxElements)
-						.elementSize(formatBytes(format))));
-					m_elementSizeBytes += formatBytes(format);
-
-					bufferOwners.emplace_back(m_device.createBufferSRV(bufferOwnersUAV.back()));
-					bufferHandles.emplace_back(bufferOwners.back());
-					bufferHandlesUAV.emplace_back(bufferOwnersUAV.back());
-				}
+        // no reserved buffers or they ran out of address space.
+        // new buffers and a copy of everything in the old ones.
+        // the old buffers stay alive until the copy is done
+        auto oldBufferOwners = m_bufferOwners;
+        auto oldBufferOwnersUAV = m_bufferOwnersUAV;
+        auto oldVertexBufferOwners = m_vertexBufferOwners;
+        auto oldIndexBufferOwners = m_indexBufferOwners;
 
-				for (auto&& size : m_elementSizes)
-				{
-					bufferOwnersUAV.emplace_back(m_device.createBufferUAV(BufferDescription()
-						.usage(ResourceUsage::GpuRead)
-						.name(m_resourceName)
-						.structured(true)
-						.elements(m_maxElements)
-						.elementSize(size)));
-					m_elementSizeBytes += size;
-
-					bufferOwners.emplace_back(m_device.createBufferSRV(bufferOwnersUAV.back()));
-					bufferHandles.emplace_back(bufferOwners.back());
-					bufferHandlesUAV.emplace_back(bufferOwnersUAV.back());
-				}
+        m_maxElements = newSize;
+        createBuffers();
 
-				auto cmd = m_device.createCommandList("ModelResourceAllocator resize");
-				for (int i = 0; i < m_bufferOwners.size(); ++i)
-				{
-					cmd.copyBuffer(
-						m_bufferOwners[i].resource().buffer(),
-						bufferOwners[i].resource().buffer(), m_size);
-				}
-				m_device.submitBlocking(cmd);
+        if (oldBufferOwners.size() > 0)
+        {
+            auto cmd = m_device.createCommandList("ModelResourceAllocator resize");
+            for (int i = 0; i < oldBufferOwners.size(); ++i)
+            {
+                cmd.copyBuffer(
+                    oldBufferOwners[i].resource().buffer(),
+                    m_bufferOwners[i].resource().buffer(), m_size);
+            }
+            m_device.submitBlocking(cmd);
+        }
 
-				m_size = m_maxElements;
-				m_bufferOwners = bufferOwners;
-				m_bufferOwnersUAV = bufferOwnersUAV;
-				m_bufferHandles = bufferHandles;
-				m_bufferHandlesUAV = bufferHandlesUAV;
-				break;
-			}
-		}
+        m_size = m_maxElements;
 	}
 
     void ModelResourceAllocator::free(ModelResourceAllocation allocation)
@@ -0,0 +1,118 @@
+#include "engine/rendering/PassRecorder.h"
+#include "engine/graphics/Device.h"
+#include "engine/graphics/Common.h"
+#include "tools/Debug.h"
+
+#include <algorithm>
+
+namespace engine
+{
+    PassRecorder::PassRecorder(Device& device, JobSystem& jobs)
+        : m_device{ device }
+        , m_milliseconds{ 0.0 }
+        , m_jobs{ jobs }
+    {
+    }
+
+    void PassRecorder::stage(RecordFunction prepare)
+    {
+        m_stages.emplace_back(Stage{ prepare, m_passes.size(), 0u });
+    }
+
+    void PassRecorder::pass(const char* name, RecordFunction record, PassThread thread)
+    {
+        if (m_stages.size() == 0)
+            stage();
+        m_passes.emplace_back(Pass{ name, m_stages.size() - 1, thread, record });
+        ++m_stages.back().passCount;
+    }
+
+    void PassRecorder::recordPass(size_t index, CommandList& cmd)
+    {
+        auto& pass = m_passes[index];
+        auto start = std::chrono::high_resolution_clock::now();
+        {
+            CPU_MARKER(cmd.api(), pass.name);
+            GPU_MARKER(cmd, pass.name);
+            pass.record(cmd);
+        }
+        auto stop = std::chrono::high_resolution_clock::now();
+        m_timings[index] = PassTiming{
+            pass.name,
+            pass.stage,
+            std::this_thread::get_id() != m_callingThread,
+            std::chrono::duration<double, std::milli>(stop - start).count() };
+    }
+
+    void PassRecorder::recordStage(Stage& stage, CommandList& prepareList)
+    {
+        if (stage.prepare)
+            stage.prepare(prepareList);
+
+        JobGroup group(m_jobs);
+        engine::vector<size_t> calling;
+        for (size_t i = stage.firstPass; i < stage.firstPass + stage.passCount; ++i)
+        {
+            // the first pass is always recorded here so that a stage
+            // of one pass never waits for a worker
+            if (m_passes[i].thread == PassThread::Main || m_jobs.workerCount() == 0 || i == stage.firstPass)
+                calling.emplace_back(i);
+            else
+                group.run([this, i]() { recordPass(i, m_lists[i]); });
+        }
+
+        for (auto&& index : calling)
+            recordPass(index, m_lists[index]);
+
+        // passes no worker has picked up yet are recorded here
+        group.wait();
+    }
+
+    void PassRecorder::record(CommandList& cmd, bool parallel)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        m_timings.resize(m_passes.size());
+        m_callingThread = std::this_thread::get_id();
+
+        if (!parallel)
+        {
+            for (auto&& stage : m_stages)
+            {
+                if (stage.prepare)
+                    stage.prepare(cmd);
+                for (size_t i = stage.firstPass; i < stage.firstPass + stage.passCount; ++i)
+                    recordPass(i, cmd);
+            }
+        }
+        else
+        {
+            m_lists.clear();
+            for (auto&& pass : m_passes)
+                m_lists.emplace_back(m_device.createCommandList(pass.name));
+
+            for (auto&& stage : m_stages)
+            {
+                if (stage.passCount == 0)
+                {
+                    if (stage.prepare)
+                        stage.prepare(stage.firstPass > 0 ? m_lists[stage.firstPass - 1] : cmd);
+                    continue;
+                }
+                recordStage(stage, stage.firstPass > 0 ? m_lists[stage.firstPass - 1] : cmd);
+            }
+
+            auto name = cmd.name();
+            m_device.submit(cmd);
+            for (auto&& list : m_lists)
+                m_device.submit(list);
+            m_lists.clear();
+            cmd = m_device.createCommandList(name);
+        }
+
+        m_passes.clear();
+        m_stages.clear();
+
+        auto stop = std::chrono::high_resolution_clock::now();
+        m_milliseconds = std::chrono::duration<double, std::milli>(stop - start).count();
+    }
+}
@@ -5,6 +5,7 @@
 #include "engine/graphics/CommandList.h"
 #include "engine/graphics/dx12/DX12Headers.h"
 #include "tools/ByteRange.h"
+#include "tools/Debug.h"
 
 #include <thread>
 #include <chrono>
@@ -95,7 +96,7 @@ namespace engine
 	{
 		if (m_task)
 		{
-			m_task->fence->blockUntilSignaled();
+			m_manager->blockUntilUploaded(m_task);
 			m_manager->finishTaskFromConsumer(m_task);
 		}
 	}
@@ -117,7 +118,18 @@ namespace engine
 
 	void ResidencyManagerV2::ResidencyFuture::blockUntilUploaded()
 	{
-		m_task->fence->blockUntilSignaled();
+		if (m_task)
+			m_manager->blockUntilUploaded(m_task);
+	}
+
+	bool ResidencyManagerV2::ResidencyFuture::uploaded() const
+	{
+		return !m_task || m_manager->uploaded(m_task);
+	}
+
+	bool ResidencyManagerV2::ResidencyFuture::failed() const
+	{
+		return m_task && m_manager->failed(m_task);
 	}
 
 	ResidencyManagerV2::ResidencyFuture::ResidencyFuture(ResidencyManagerV2 * manager, ResidencyTask * task)
@@ -125,19 +137,29 @@ namespace engine
 		, m_task{ task }
 	{}
 
-	ResidencyManagerV2::ResidencyManagerV2(Device& device)
+	ResidencyManagerV2::ResidencyManagerV2(Device& device, size_t uploadBytes)
 		: m_device{ device }
+		, m_uploadBytes{ uploadBytes }
+		, m_batchBytes{ uploadBytes / ResidencyBatchRingDivisor }
 		, m_uploadBuffer{ device.createBuffer(BufferDescription()
 			.elementSize(1)
-			.elements(ResidencyUploadSize)
+			.elements(uploadBytes)
 			.usage(ResourceUsage::Upload)
 			.name("ResidencyManager UploadBuffer")) }
 		, m_uploadMemory{ static_cast<uint8_t*>(m_uploadBuffer.resource().map(device)) }
-		, m_ringBuffer{ tools::ByteRange{ reinterpret_cast<uint8_t*>(0ull), reinterpret_cast<uint8_t*>(ResidencyUploadSize) }, 1 }
+		, m_ringBuffer{ tools::ByteRange{ reinterpret_cast<uint8_t*>(0ull), reinterpret_cast<uint8_t*>(uploadBytes) }, 1 }
 		, m_workerFence{ m_device.createFence("ResidencyManagerV2 worker fence") }
 		, m_workerFenceDirect{ m_device.createFence("ResidencyManagerV2 worker direct fence") }
 		, m_alive{ true }
 		, m_mutex{}
+		, m_inFlightCount{ 0 }
+		, m_batchCount{ 0 }
+		, m_taskCount{ 0 }
+		, m_byteCount{ 0 }
+		, m_failedCount{ 0 }
+		, m_bytesPerSecond{ 0.0 }
+		, m_rateBytes{ 0 }
+		, m_rateStart{ std::chrono::high_resolution_clock::now() }
 		, m_thread{[this]() { this->worker(); } }
 	{}
 
@@ -147,44 +169,83 @@ namespace engine
 			std::lock_guard<std::mutex> lock(m_mutex);
 			m_alive = false;
 		}
+		m_taskAvailable.notify_all();
+		m_taskUploaded.notify_all();
 		m_thread.join();
-		while (m_tasks.size() > 0) m_tasks.pop();
+		for (auto&& queue : m_tasks)
+			while (queue.size() > 0) queue.pop();
 		m_finishedTasks.clear();
 	}
 
 	void ResidencyManagerV2::worker()
 	{
-		while (m_alive)
+		engine::vector<engine::shared_ptr<ResidencyTask>> tasks;
+		while (true)
 		{
-			engine::shared_ptr<ResidencyTask> task;
 			{
-				std::lock_guard<std::mutex> lock(m_mutex);
-				if (!m_tasks.empty())
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_taskAvailable.wait(lock, [&]()
 				{
-					task = std::move(m_tasks.front());
-					m_tasks.pop();
+					if (!m_alive || !m_inFlight.empty())
+						return true;
+					for (auto&& queue : m_tasks)
+						if (!queue.empty())
+							return true;
+					return false;
+				});
+
+				if (!m_alive)
+					break;
+
+				// fill the batch starting from the highest priority
+				size_t batchBytes = 0;
+				for (auto&& queue : m_tasks)
+				{
+					while (!queue.empty() &&
+						tasks.size() < ResidencyBatchTasks &&
+						batchBytes < m_batchBytes)
+					{
+						batchBytes += queue.front()->bytes;
+						tasks.emplace_back(std::move(queue.front()));
+						queue.pop();
+					}
 				}
 			}
 
-			if (task)
+			if (tasks.empty())
 			{
-				workOnTask(std::move(task));
-				m_device.processCommandLists(false);
+				// nothing new to record. wait for the oldest batch in flight
+				retire(true);
+				continue;
 			}
-			else
+
+			RecordingBatch recording;
+			for (auto&& task : tasks)
 			{
-				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				if (!recordTask(recording, *task))
+				{
+					// the pieces recorded so far stay in the batch. the task
+					// retires with it so its waiters see the failure
+					std::lock_guard<std::mutex> lock(m_mutex);
+					task->failed = true;
+					++m_failedCount;
+				}
+
+				// a task belongs to the batch that holds its last piece
+				recording.batch.tasks.emplace_back(std::move(task));
 			}
+			tasks.clear();
 
-			
+			submit(recording);
+			retire(false);
 		}
+
+		// the GPU might still be reading the upload ring
+		while (retire(true)) {}
 	}
 
-	void ResidencyManagerV2::workOnTask(engine::shared_ptr<ResidencyTask>&& _task)
+	bool ResidencyManagerV2::recordTask(RecordingBatch& recording, ResidencyTask& task)
 	{
-		ResidencyTask& task = *_task;
-		auto ptr = static_cast<uint8_t*>(task.ptr);
-
 		auto useCopyQueue = [&](const engine::Vector3<size_t>& size)->bool
 		{
 			auto gran = m_device.queue(CommandListType::Copy).transferGranularity();
@@ -194,95 +255,106 @@ namespace engine
 				(size.z % gran.z == 0ull);
 		};
 
-		bool copyQueueWork = false;
-		bool directQueueWork = false;
-
-		auto stall = [&]()
+		auto copyList = [&]()->CommandList&
 		{
-			if (copyQueueWork)
+			if (!recording.copyWork)
 			{
-				m_workerFence.blockUntilSignaled();
-				copyQueueWork = false;
+				recording.copy = m_device.createCommandList("ResidencyManagerV2 batch", CommandListType::Copy);
+				recording.copyWork = true;
 			}
-			if (directQueueWork)
+			return recording.copy;
+		};
+
+		auto directList = [&]()->CommandList&
+		{
+			if (!recording.directWork)
 			{
-				m_workerFenceDirect.blockUntilSignaled();
-				directQueueWork = false;
+				recording.direct = m_device.createCommandList("ResidencyManagerV2 batch", CommandListType::Direct);
+				recording.directWork = true;
 			}
-
-			for (auto&& a : m_ringAllocations)
-				m_ringBuffer.free(a);
-			m_ringBuffer.reset();
-			m_ringAllocations.clear();
+			return recording.direct;
 		};
 
-		if (task.dst)
+		// large buffer uploads are split so that no piece
+		// needs more than a part of the ring
+		auto copyBuffer = [&](const uint8_t* ptr, Buffer dst, size_t dstIndexBytes, size_t bytes)->bool
 		{
-			auto toCopy = task.bytes;
 			size_t doneCopying = 0;
-
-			// buffer copy
-			while (doneCopying < toCopy)
+			while (doneCopying < bytes)
 			{
-				auto copyThisTime = std::min(toCopy - doneCopying, m_ringBuffer.maxAllocationSpace());
-				if (copyThisTime == 0)
-				{
-					stall();
+				auto copyThisTime = std::min(bytes - doneCopying, m_batchBytes);
+				auto allocation = allocate(recording, copyThisTime, 1);
+				if (!allocation.size)
+					return false;
 
-					copyThisTime = std::min(toCopy - doneCopying, m_ringBuffer.maxAllocationSpace());
-					ASSERT(copyThisTime > 0, "Ran out of memory");
-				}
+				auto fromBytes = m_ringBuffer.offset(allocation.ptr);
+				memcpy(&m_uploadMemory[fromBytes], ptr + doneCopying, copyThisTime);
 
-				auto allocation = m_ringBuffer.allocate(copyThisTime);
-				if (!allocation.size)
-				{
-					stall();
+				copyList().copyBufferBytes(
+					m_uploadBuffer,
+					dst,
+					copyThisTime,
+					fromBytes,
+					dstIndexBytes + doneCopying);
+
+				recording.batch.bytes += copyThisTime;
+				doneCopying += copyThisTime;
+			}
+			return true;
+		};
+
+		if (task.copies.size() > 0)
+		{
+			// gathered buffer copy. neighbouring source ranges that fit
+			// to a piece together share one ring allocation and memcpy
+			auto ptr = static_cast<const uint8_t*>(task.ptr);
+			auto& copies = task.copies;
+			size_t first = 0;
+			while (first < copies.size())
+			{
+				auto begin = copies[first].srcOffsetBytes;
+				auto last = first;
+				while (last < copies.size() && copies[last].srcOffsetBytes + copies[last].bytes - begin <= m_batchBytes)
+					++last;
 
-					copyThisTime = std::min(toCopy - doneCopying, m_ringBuffer.maxAllocationSpace());
-					ASSERT(copyThisTime > 0, "Ran out of memory");
-					allocation = m_ringBuffer.allocate(copyThisTime);
-					ASSERT(allocation.ptr, "Invalid allocation");
+				if (last == first)
+				{
+					auto& copy = copies[first];
+					if (!copyBuffer(ptr + copy.srcOffsetBytes, copy.dst, copy.dstIndexBytes, copy.bytes))
+						return false;
+					++first;
+					continue;
 				}
 
-				m_ringAllocations.emplace_back(allocation);
-				
-				memcpy(&m_uploadMemory[m_ringBuffer.offset(allocation.ptr)], ptr + doneCopying, copyThisTime);
+				auto span = copies[last - 1].srcOffsetBytes + copies[last - 1].bytes - begin;
+				auto allocation = allocate(recording, span, 1);
+				if (!allocation.size)
+					return false;
 
-				auto cmd = m_device.createCommandList("MakeResidentTask", CommandListType::Copy);
+				auto fromBytes = m_ringBuffer.offset(allocation.ptr);
+				memcpy(&m_uploadMemory[fromBytes], ptr + begin, span);
 
-				if (task.dst)
+				for (auto i = first; i < last; ++i)
 				{
-					size_t bytes = copyThisTime;
-					size_t fromBytes = m_ringBuffer.offset(allocation.ptr);
-					size_t toBytes = task.dstIndexBytes + doneCopying;
-
-					/*LOG("Residency copy from: %s [0..%i], to: %s. [0..%i]. bytes: %i, from: %i, to: %i",
-						m_uploadBuffer.resource().description().descriptor.name,
-						m_uploadBuffer.resource().description().descriptor.elementSize * m_uploadBuffer.resource().description().descriptor.elements,
-						task.dst.description().descriptor.name,
-						task.dst.description().descriptor.elementSize * task.dst.description().descriptor.elements,
-						bytes,
-						fromBytes,
-						toBytes);*/
-
-					cmd.copyBufferBytes(
+					if (copies[i].bytes == 0)
+						continue;
+					copyList().copyBufferBytes(
 						m_uploadBuffer,
-						task.dst,
-						bytes,
-						fromBytes,
-						toBytes);
+						copies[i].dst,
+						copies[i].bytes,
+						fromBytes + copies[i].srcOffsetBytes - begin,
+						copies[i].dstIndexBytes);
 				}
 
-				m_device.submit(cmd, CommandListType::Copy);
-
-				m_workerFence.increaseCPUValue();
-				m_device.queue(CommandListType::Copy).signal(m_workerFence, m_workerFence.currentCPUValue());
-				copyQueueWork = true;
-
-				doneCopying += copyThisTime;
-				
+				recording.batch.bytes += span;
+				first = last;
 			}
 		}
+		else if (task.dst)
+		{
+			if (!copyBuffer(static_cast<const uint8_t*>(task.ptr), task.dst, task.dstIndexBytes, task.bytes))
+				return false;
+		}
 		else if (task.dstTexture)
 		{
 			// texture copy
@@ -348,13 +420,9 @@ namespace engine
 					blockCompressed ? piece.width * 4ull : piece.width,
 					blockCompressed ? piece.height * 4ull : piece.height);
 
-				if (m_ringBuffer.maxAllocationSpace() < realPieceBytes)
-					stall();
-				auto allocation = m_ringBuffer.allocate(realPieceBytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
-				if(!allocation.size)
-					ASSERT(false, "Invalid allocation");
-
-				m_ringAllocations.emplace_back(allocation);
+				auto allocation = allocate(recording, realPieceBytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+				if (!allocation.size)
+					return false;
 
 				auto offset = m_ringBuffer.offset(allocation.ptr);
 				size_t offsetInc = 0ull;
@@ -366,88 +434,188 @@ namespace engine
 					offsetInc += realPitch;
 				}
 
-				if (useCopyQueue({ piece.width, piece.height, 1ull }))
-				{
-					auto cmd = m_device.createCommandList("MakeResidentTask", CommandListType::Copy);
-
-					cmd.copyTexture(
-						m_uploadBuffer.resource(),
-						m_ringBuffer.offset(allocation.ptr),
-						blockCompressed ? piece.width * 4 : piece.width,
-						blockCompressed ? piece.height * 4 : piece.height,
-						realPitch,
-						task.dstTexture,
-						task.dstX + piece.dstX,
-						task.dstY + piece.dstY,
-						task.dstMip,
-						task.dstSlice,
-						task.dstMipLevels);
-
-					m_device.submit(cmd, CommandListType::Copy);
-
-					m_workerFence.increaseCPUValue();
-					m_device.queue(CommandListType::Copy).signal(m_workerFence, m_workerFence.currentCPUValue());
-					copyQueueWork = true;
-				}
-				else
-				{
-					auto cmd = m_device.createCommandList("MakeResidentTask", CommandListType::Direct);
-
-					cmd.copyTexture(
-						m_uploadBuffer.resource(),
-						m_ringBuffer.offset(allocation.ptr),
-						blockCompressed ? piece.width * 4 : piece.width,
-						blockCompressed ? piece.height * 4 : piece.height,
-						realPitch,
-						task.dstTexture,
-						task.dstX + piece.dstX,
-						task.dstY + piece.dstY,
-						task.dstMip,
-						task.dstSlice,
-						task.dstMipLevels);
-
-					m_device.submit(cmd, CommandListType::Direct);
-
-					m_workerFenceDirect.increaseCPUValue();
-					m_device.queue(CommandListType::Direct).signal(m_workerFenceDirect, m_workerFenceDirect.currentCPUValue());
-					directQueueWork = true;
-				}
+				auto& cmd = useCopyQueue({ piece.width, piece.height, 1ull }) ? copyList() : directList();
+				cmd.copyTexture(
+					m_uploadBuffer.resource(),
+					offset,
+					blockCompressed ? piece.width * 4 : piece.width,
+					blockCompressed ? piece.height * 4 : piece.height,
+					realPitch,
+					task.dstTexture,
+					task.dstX + piece.dstX,
+					task.dstY + piece.dstY,
+					task.dstMip,
+					task.dstSlice,
+					task.dstMipLevels);
+
+				recording.batch.bytes += realPieceBytes;
 			}
 		}
 		else
 		{
 			ASSERT(false, "Residency manager got empty task");
 		}
-	
-		stall();
+		return true;
+	}
 
+	tools::RingBuffer::AllocStruct ResidencyManagerV2::allocate(RecordingBatch& recording, size_t bytes, size_t alignment)
+	{
+		auto allocation = m_ringBuffer.allocate(bytes, alignment);
+		while (!allocation.size)
 		{
-			std::lock_guard<std::mutex> lock(m_mutex);
-			m_finishedTasks.emplace_back(std::move(_task));
+			// the ring is full. send what has been recorded so far
+			// and give back the memory of the oldest batch
+			if (recording.copyWork || recording.directWork)
+				submit(recording);
+
+			// retire() resets the ring once nothing is in flight so
+			// this piece is bigger than the whole ring
+			if (m_inFlight.empty())
+			{
+				LOG_ERROR("Residency upload of %zu bytes does not fit to the upload ring of %zu bytes", bytes, m_uploadBytes);
+				return allocation;
+			}
+
+			retire(true);
+			allocation = m_ringBuffer.allocate(bytes, alignment);
+		}
+		recording.batch.allocations.emplace_back(allocation);
+		return allocation;
+	}
+
+	void ResidencyManagerV2::submit(RecordingBatch& recording)
+	{
+		if (recording.copyWork)
+		{
+			m_device.submit(recording.copy, CommandListType::Copy);
+			m_workerFence.increaseCPUValue();
+			m_device.queue(CommandListType::Copy).signal(m_workerFence, m_workerFence.currentCPUValue());
+		}
+		if (recording.directWork)
+		{
+			m_device.submit(recording.direct, CommandListType::Direct);
+			m_workerFenceDirect.increaseCPUValue();
+			m_device.queue(CommandListType::Direct).signal(m_workerFenceDirect, m_workerFenceDirect.currentCPUValue());
 		}
+		if (recording.copyWork || recording.directWork)
+			m_device.processCommandLists(false);
 
-		m_device.queue(CommandListType::Copy).signal(*task.fence, task.fence->currentCPUValue());
+		recording.batch.copyValue = m_workerFence.currentCPUValue();
+		recording.batch.directValue = m_workerFenceDirect.currentCPUValue();
+		m_inFlight.push(std::move(recording.batch));
+
+		recording.batch = InFlightBatch{};
+		recording.copy = CommandList();
+		recording.direct = CommandList();
+		recording.copyWork = false;
+		recording.directWork = false;
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		++m_inFlightCount;
+		++m_batchCount;
+	}
+
+	bool ResidencyManagerV2::retire(bool block)
+	{
+		bool retired = false;
+		while (!m_inFlight.empty())
+		{
+			auto& batch = m_inFlight.front();
+			if (block && !retired)
+			{
+				m_workerFence.blockUntilSignaled(batch.copyValue);
+				m_workerFenceDirect.blockUntilSignaled(batch.directValue);
+			}
+			else if (!m_workerFence.signaled(batch.copyValue) || !m_workerFenceDirect.signaled(batch.directValue))
+				break;
+
+			// batches retire in submission order so the ring frees from its tail
+			for (auto&& allocation : batch.allocations)
+				m_ringBuffer.free(allocation);
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				for (auto&& task : batch.tasks)
+				{
+					task->uploaded = true;
+					m_finishedTasks.emplace_back(std::move(task));
+				}
+
+				--m_inFlightCount;
+				m_taskCount += batch.tasks.size();
+				m_byteCount += batch.bytes;
+				m_rateBytes += batch.bytes;
+
+				auto now = std::chrono::high_resolution_clock::now();
+				auto elapsed = std::chrono::duration<double>(now - m_rateStart).count();
+				if (elapsed >= 1.0)
+				{
+					m_bytesPerSecond = static_cast<double>(m_rateBytes) / elapsed;
+					m_rateBytes = 0;
+					m_rateStart = now;
+				}
+			}
+
+			m_inFlight.pop();
+			retired = true;
+		}
+
+		if (retired)
+			m_taskUploaded.notify_all();
+
+		// alignment padding is not given back by free() so start
+		// from a clean ring whenever nothing is outstanding
+		if (m_inFlight.empty())
+			m_ringBuffer.reset();
+
+		return retired;
+	}
+
+	ResidencyManagerV2::ResidencyFuture ResidencyManagerV2::enqueue(engine::shared_ptr<ResidencyTask>&& task)
+	{
+		auto ptr = task.get();
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_tasks[static_cast<size_t>(task->priority)].push(std::move(task));
+		}
+		m_taskAvailable.notify_one();
+		return ResidencyFuture(this, ptr);
 	}
 
 	ResidencyManagerV2::ResidencyFuture ResidencyManagerV2::uploadTemp(
 		Buffer dst,
 		size_t dstIndexBytes,
-		void* ptr, size_t bytes)
+		void* ptr, size_t bytes,
+		ResidencyPriority priority)
 	{
 		auto task = engine::make_shared<ResidencyTask>();
 		task->dst = dst;
 		task->dstIndexBytes = dstIndexBytes;
 		task->ptr = ptr;
 		task->bytes = bytes;
-		task->fence = engine::make_unique<Fence>(m_device.createFence("Buffer upload task finished fence"));
-		task->fence->increaseCPUValue();
+		task->priority = priority;
+		return enqueue(std::move(task));
+	};
+
+	ResidencyManagerV2::ResidencyFuture ResidencyManagerV2::uploadTemp(
+		void* ptr,
+		engine::vector<ResidencyBufferCopy>&& copies,
+		ResidencyPriority priority)
+	{
+		ASSERT(copies.size() > 0, "Residency manager got a gathered upload without copies");
+		for (size_t i = 1; i < copies.size(); ++i)
 		{
-			std::lock_guard<std::mutex> lock(m_mutex);
-			m_tasks.push(task);
+			ASSERT(copies[i].srcOffsetBytes >= copies[i - 1].srcOffsetBytes + copies[i - 1].bytes,
+				"Gathered upload source ranges are not in ascending order");
 		}
-		
-		return ResidencyFuture(this, task.get());
-	};
+
+		auto task = engine::make_shared<ResidencyTask>();
+		task->ptr = ptr;
+		task->bytes = copies.back().srcOffsetBytes + copies.back().bytes - copies.front().srcOffsetBytes;
+		task->copies = std::move(copies);
+		task->priority = priority;
+		return enqueue(std::move(task));
+	}
 
 	ResidencyManagerV2::ResidencyFuture ResidencyManagerV2::upload(
 		void* srcPointer,
@@ -460,13 +628,14 @@ namespace engine
 		size_t dstMip,
 		size_t dstSlice,
 		size_t dstMipLevels,
-		bool copyOnUpload)
+		bool copyOnUpload,
+		ResidencyPriority priority)
 	{
 		auto task = engine::make_shared<ResidencyTask>();
+		auto imageBytes = formatBytes(dst.format(), srcWidth, srcHeight);
 		
 		if (copyOnUpload)
 		{
-			auto imageBytes = formatBytes(dst.format(), srcWidth, srcHeight);
 			task->copyPtr = engine::unique_ptr<uint8_t[]>(new uint8_t[imageBytes]);
 			memcpy(task->copyPtr.get(), srcPointer, imageBytes);
 			task->ptr = nullptr;
@@ -474,6 +643,7 @@ namespace engine
 		else
 			task->ptr = srcPointer;
 
+		task->bytes = imageBytes;
 		task->dstTexture = dst;
 		task->dstMip = dstMip;
 		task->dstSlice = dstSlice;
@@ -482,16 +652,46 @@ namespace engine
 		task->dstY = dstY;
 		task->srcWidth = srcWidth;
 		task->srcHeight = srcHeight;
+		task->priority = priority;
+		return enqueue(std::move(task));
+	};
 
-		task->fence = engine::make_unique<Fence>(m_device.createFence("Texture upload task finished fence"));
-		task->fence->increaseCPUValue();
-		{
-			std::lock_guard<std::mutex> lock(m_mutex);
-			m_tasks.push(task);
-		}
+	ResidencyStatistics ResidencyManagerV2::statistics() const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		ResidencyStatistics stats = {};
+		for (size_t i = 0; i < ResidencyPriorityCount; ++i)
+			stats.queueDepth[i] = m_tasks[i].size();
+		stats.inFlightBatches = m_inFlightCount;
+		stats.batches = m_batchCount;
+		stats.tasks = m_taskCount;
+		stats.bytes = m_byteCount;
+		stats.failedTasks = m_failedCount;
+
+		// the rate is refreshed when batches retire. if nothing has
+		// retired for a while, report what the current window has seen
+		auto elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - m_rateStart).count();
+		stats.bytesPerSecond = elapsed >= 1.0 ? static_cast<double>(m_rateBytes) / elapsed : m_bytesPerSecond;
+		return stats;
+	}
 
-		return { this, task.get() };
-	};
+	void ResidencyManagerV2::blockUntilUploaded(ResidencyTask* task)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_taskUploaded.wait(lock, [&]() { return task->uploaded || !m_alive; });
+	}
+
+	bool ResidencyManagerV2::uploaded(ResidencyTask* task)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return task->uploaded;
+	}
+
+	bool ResidencyManagerV2::failed(ResidencyTask* task)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return task->failed;
+	}
 
 	void ResidencyManagerV2::finishTaskFromConsumer(ResidencyTask* task)
 	{
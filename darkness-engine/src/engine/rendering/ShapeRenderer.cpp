@@ -183,7 +183,7 @@ namespace engine
             cmd.drawIndexedInstanced(
                 m_sphere.view_indexes,
                 m_sphere.view_indexes.desc().elements,
-                static_cast<uint32_t>(lights.cputransforms().size()),
+                lights.pointCount(),
                 0, 0, 0);
         }
 
@@ -274,7 +274,7 @@ namespace engine
 			cmd.drawIndexedInstanced(
 				m_cone.view_indexes,
 				m_cone.view_indexes.desc().elements,
-				static_cast<uint32_t>(lights.cpuspotranges().size()),
+				lights.spotCount(),
 				0, 0, 0);
 		}
 
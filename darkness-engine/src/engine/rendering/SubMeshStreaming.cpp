@@ -0,0 +1,382 @@
+#include "engine/rendering/SubMeshStreaming.h"
+#include "engine/rendering/SubMesh.h"
+#include "engine/rendering/ModelResources.h"
+#include "tools/Debug.h"
+
+#include <cstring>
+
+using namespace engine;
+
+namespace engine
+{
+    namespace
+    {
+        constexpr size_t StagingAlignment = 16;
+
+        class ResidencySubMeshUploadBatch : public SubMeshUploadBatch
+        {
+        public:
+            ResidencySubMeshUploadBatch(ResidencyManagerV2& residency, ModelResources& modelResources)
+                : m_residency{ residency }
+                , m_modelResources{ modelResources }
+            {}
+
+            void upload(SubMeshStream stream, size_t dstIndexBytes, size_t stagingOffset, size_t bytes) override
+            {
+                m_copies.emplace_back(ResidencyBufferCopy{ buffer(stream), dstIndexBytes, stagingOffset, bytes });
+            }
+
+            void submit(const uint8_t* staging) override
+            {
+                if (m_copies.size() == 0)
+                    return;
+                m_upload = engine::make_unique<ResidencyManagerV2::ResidencyFuture>(
+                    m_residency.uploadTemp(const_cast<uint8_t*>(staging), std::move(m_copies)));
+                m_copies.clear();
+            }
+
+            bool uploaded() override
+            {
+                return !m_upload || m_upload->uploaded();
+            }
+
+            void blockUntilUploaded() override
+            {
+                if (m_upload)
+                    m_upload->blockUntilUploaded();
+            }
+
+        private:
+            ResidencyManagerV2& m_residency;
+            ModelResources& m_modelResources;
+            engine::vector<ResidencyBufferCopy> m_copies;
+            engine::unique_ptr<ResidencyManagerV2::ResidencyFuture> m_upload;
+
+            Buffer buffer(SubMeshStream stream)
+            {
+                auto& gpu = m_modelResources.gpuBuffers();
+                switch (stream)
+                {
+                    case SubMeshStream::Vertex: return gpu.vertex().buffer();
+                    case SubMeshStream::Normal: return gpu.normal().buffer();
+                    case SubMeshStream::Tangent: return gpu.tangent().buffer();
+                    case SubMeshStream::Color: return gpu.color().buffer();
+                    case SubMeshStream::Uv: return gpu.uv().buffer();
+                    case SubMeshStream::Index: return gpu.index().buffer();
+                    case SubMeshStream::Adjacency: return gpu.adjacency().buffer();
+                    case SubMeshStream::ClusterBinding: return gpu.clusterBinding().buffer();
+                    case SubMeshStream::ClusterBoundingBox: return gpu.clusterBoundingBox().buffer();
+                    case SubMeshStream::ClusterCone: return gpu.clusterCone().buffer();
+                    case SubMeshStream::SubMeshAdjacency: return gpu.subMeshAdjacency().buffer();
+                    case SubMeshStream::SubMeshData: return gpu.subMeshData().buffer();
+                    case SubMeshStream::SubMeshBoundingBox: return gpu.subMeshBoundingBox().buffer();
+                    case SubMeshStream::SubMeshBoundingSphere: return gpu.subMeshBoundingSphere().buffer();
+                    case SubMeshStream::Lod: return gpu.lod().buffer();
+                }
+                ASSERT(false, "Unknown submesh stream: %i", static_cast<int>(stream));
+                return {};
+            }
+        };
+    }
+
+    size_t SubMeshStaging::stage(SubMeshStream stream, uint32_t lod, size_t elements, size_t elementBytes)
+    {
+        size_t offset = (memory.size() + StagingAlignment - 1) & ~(StagingAlignment - 1);
+        memory.resize(offset + elements * elementBytes);
+        blocks.emplace_back(SubMeshStagedBlock{ stream, lod, elements, elementBytes, offset, 0 });
+        return blocks.size() - 1;
+    }
+
+    uint8_t* SubMeshStaging::ptr(const SubMeshStagedBlock& block)
+    {
+        return memory.data() + block.stagingOffset;
+    }
+
+    ResidencySubMeshUploadBackend::ResidencySubMeshUploadBackend(ResidencyManagerV2& residency, ModelResources& modelResources)
+        : m_residency{ residency }
+        , m_modelResources{ modelResources }
+    {}
+
+    ModelResourceAllocation ResidencySubMeshUploadBackend::allocate(SubMeshAllocator allocator, size_t elements)
+    {
+        auto& gpu = m_modelResources.gpuBuffers();
+        switch (allocator)
+        {
+            case SubMeshAllocator::VertexData: return gpu.vertexDataAllocator().allocate(elements);
+            case SubMeshAllocator::UvData: return gpu.uvDataAllocator().allocate(elements);
+            case SubMeshAllocator::Index: return gpu.indexAllocator().allocate(elements);
+            case SubMeshAllocator::Adjacency: return gpu.adjacencyAllocator().allocate(elements);
+            case SubMeshAllocator::ClusterData: return gpu.clusterDataAllocator().allocate(elements);
+            case SubMeshAllocator::SubMeshData: return gpu.subMeshDataAllocator().allocate(elements);
+            case SubMeshAllocator::Lod: return gpu.lodAllocator().allocate(elements);
+        }
+        ASSERT(false, "Unknown submesh allocator: %i", static_cast<int>(allocator));
+        return {};
+    }
+
+    engine::unique_ptr<SubMeshUploadBatch> ResidencySubMeshUploadBackend::createBatch()
+    {
+        return engine::make_unique<ResidencySubMeshUploadBatch>(m_residency, m_modelResources);
+    }
+
+    bool SubMeshStreamState::uploaded()
+    {
+        if (!scheduled)
+            return false;
+        if (batch && batch->uploaded())
+        {
+            batch.reset();
+            staging = SubMeshStaging();
+        }
+        return !batch;
+    }
+
+    void SubMeshStreamState::blockUntilUploaded()
+    {
+        if (batch)
+            batch->blockUntilUploaded();
+        uploaded();
+    }
+
+    bool SubMeshStreamer::read(CompressedFile& file, SubMesh& subMesh, SubMeshStaging& staging)
+    {
+        using Count = SubMesh::Count;
+        Count elements;
+        file.read(reinterpret_cast<char*>(&elements), sizeof(Count));
+
+        if (file.eof())
+            return false;
+
+        auto stageBlock = [&](SubMeshStream stream, uint32_t lod, size_t elementBytes)
+        {
+            Count count;
+            file.read(reinterpret_cast<char*>(&count), sizeof(Count));
+            auto& block = staging.blocks[staging.stage(stream, lod, static_cast<size_t>(count), elementBytes)];
+            if (count > 0)
+                file.read(reinterpret_cast<char*>(staging.ptr(block)), static_cast<std::streamsize>(elementBytes * count));
+        };
+
+        auto packed = [&](uint32_t lod)->ModelPackedCpu&
+        {
+            if (lod >= subMesh.outputData.size())
+                subMesh.outputData.resize(lod + 1);
+            return subMesh.outputData[lod];
+        };
+
+        uint32_t currentLod = 0;
+        while (elements)
+        {
+            auto blockHeader = subMesh.readBlockHeader(file);
+            switch (blockHeader.type)
+            {
+                case MeshBlockType::Position:
+                {
+                    currentLod = staging.lodCount++;
+                    stageBlock(SubMeshStream::Vertex, currentLod, sizeof(Vector2<uint32_t>));
+                    break;
+                }
+                case MeshBlockType::Normal: stageBlock(SubMeshStream::Normal, currentLod, sizeof(Vector2f)); break;
+                case MeshBlockType::Tangent: stageBlock(SubMeshStream::Tangent, currentLod, sizeof(Vector2f)); break;
+                case MeshBlockType::Uv: stageBlock(SubMeshStream::Uv, currentLod, sizeof(Vector2f)); break;
+                case MeshBlockType::Indice: stageBlock(SubMeshStream::Index, currentLod, sizeof(uint16_t)); break;
+                case MeshBlockType::AdjacencyData: stageBlock(SubMeshStream::Adjacency, currentLod, sizeof(uint32_t)); break;
+                case MeshBlockType::Color: stageBlock(SubMeshStream::Color, currentLod, sizeof(Vector4<unsigned char>)); break;
+                case MeshBlockType::Material:
+                {
+                    if (blockHeader.size_bytes > 0)
+                    {
+                        engine::vector<uint8_t> data(blockHeader.size_bytes);
+                        file.read(reinterpret_cast<char*>(&data[0]), blockHeader.size_bytes);
+                        subMesh.out_material.load(data);
+                    }
+                    else
+                    {
+                        LOG("found null material in the model file");
+                    }
+                    break;
+                }
+                case MeshBlockType::BoundingBox: subMesh.readBlock<BoundingBox>(file, subMesh.boundingBox); break;
+                case MeshBlockType::VertexScale: subMesh.readBlock<VertexScale>(file, subMesh.meshScale); break;
+                case MeshBlockType::ClusterVertexStart: subMesh.readBlock<uint32_t>(file, packed(currentLod).clusterVertexStarts); break;
+                case MeshBlockType::ClusterIndexStart: subMesh.readBlock<uint32_t>(file, packed(currentLod).clusterIndexStarts); break;
+                case MeshBlockType::ClusterIndexCount: subMesh.readBlock<uint32_t>(file, packed(currentLod).clusterIndexCount); break;
+                case MeshBlockType::ClusterBounds: subMesh.readBlock<BoundingBox>(file, packed(currentLod).clusterBounds); break;
+                case MeshBlockType::ClusterCones: subMesh.readBlock<Vector4f>(file, packed(currentLod).clusterCones); break;
+                default: file.seekg(static_cast<std::streamoff>(blockHeader.size_bytes), std::ios::cur);
+            }
+            --elements;
+        }
+
+        if (subMesh.outputData.size() < staging.lodCount)
+            subMesh.outputData.resize(staging.lodCount);
+
+        return true;
+    }
+
+    engine::unique_ptr<SubMeshUploadBatch> SubMeshStreamer::schedule(SubMesh& subMesh, SubMeshStaging& staging, SubMeshUploadBackend& backend)
+    {
+        auto allocateIfNecessary = [&](SubMeshAllocator allocator, ModelResource& data, size_t count)
+        {
+            if (!data.allocated)
+            {
+                data.modelResource = backend.allocate(allocator, count);
+                data.allocated = true;
+            }
+        };
+
+        auto& gpuData = subMesh.gpuData;
+        gpuData.resize(staging.lodCount);
+
+        // geometry. vertex, normal, tangent and color share the vertex data range
+        for (auto&& block : staging.blocks)
+        {
+            auto& lod = gpuData[block.lod];
+            switch (block.stream)
+            {
+                case SubMeshStream::Vertex:
+                case SubMeshStream::Normal:
+                case SubMeshStream::Tangent:
+                case SubMeshStream::Color:
+                {
+                    allocateIfNecessary(SubMeshAllocator::VertexData, lod.vertexData, block.elements);
+                    block.dstIndex = lod.vertexData.modelResource.gpuIndex;
+                    break;
+                }
+                case SubMeshStream::Uv:
+                {
+                    ModelResource data;
+                    allocateIfNecessary(SubMeshAllocator::UvData, data, block.elements);
+                    block.dstIndex = data.modelResource.gpuIndex;
+                    lod.uvData.emplace_back(std::move(data));
+                    break;
+                }
+                case SubMeshStream::Index:
+                {
+                    allocateIfNecessary(SubMeshAllocator::Index, lod.triangleData, block.elements);
+                    block.dstIndex = lod.triangleData.modelResource.gpuIndex;
+                    break;
+                }
+                case SubMeshStream::Adjacency:
+                {
+                    allocateIfNecessary(SubMeshAllocator::Adjacency, lod.adjacencyData, block.elements);
+                    block.dstIndex = lod.adjacencyData.modelResource.gpuIndex;
+                    break;
+                }
+                default: break;
+            }
+        }
+
+        // the cluster, submesh and lod tables point into the ranges allocated above
+        // so they are staged only now. after this the staging memory no longer grows
+        // and the block pointers stay valid.
+        auto tablesBegin = staging.blocks.size();
+        subMesh.m_clusterCount = 0;
+        for (uint32_t i = 0; i < staging.lodCount; ++i)
+        {
+            auto clusterCount = subMesh.outputData[i].clusterIndexStarts.size();
+            gpuData[i].clusterData.modelResource = backend.allocate(SubMeshAllocator::ClusterData, clusterCount);
+            gpuData[i].subMeshData.modelResource = backend.allocate(SubMeshAllocator::SubMeshData, 1);
+            subMesh.m_clusterCount += clusterCount;
+
+            staging.stage(SubMeshStream::ClusterBinding, i, clusterCount, sizeof(ClusterData));
+            staging.stage(SubMeshStream::ClusterBoundingBox, i, clusterCount, sizeof(BoundingBox));
+            staging.stage(SubMeshStream::ClusterCone, i, clusterCount, sizeof(Vector4f));
+            staging.stage(SubMeshStream::SubMeshAdjacency, i, 1, sizeof(SubMeshAdjacency));
+            staging.stage(SubMeshStream::SubMeshData, i, 1, sizeof(SubMeshData));
+            staging.stage(SubMeshStream::SubMeshBoundingBox, i, 1, sizeof(BoundingBox));
+            staging.stage(SubMeshStream::SubMeshBoundingSphere, i, 1, sizeof(BoundingSphere));
+        }
+        subMesh.lodData.modelResource = backend.allocate(SubMeshAllocator::Lod, staging.lodCount);
+        staging.stage(SubMeshStream::Lod, 0, staging.lodCount, sizeof(SubMeshUVLod));
+
+        auto lodBinding = reinterpret_cast<SubMeshUVLod*>(staging.ptr(staging.blocks.back()));
+        staging.blocks.back().dstIndex = subMesh.lodData.modelResource.gpuIndex;
+        for (size_t i = 0; i < gpuData.size(); ++i)
+        {
+            lodBinding[i].submeshPointer = static_cast<uint>(gpuData[i].subMeshData.modelResource.gpuIndex);
+            if (gpuData[i].uvData.size() > 0)
+                lodBinding[i].uvPointer = static_cast<uint>(gpuData[i].uvData[0].modelResource.gpuIndex);
+            else
+                lodBinding[i].uvPointer = 0u;
+        }
+
+        for (auto block = staging.blocks.begin() + static_cast<std::ptrdiff_t>(tablesBegin); block != staging.blocks.end() - 1; ++block)
+        {
+            auto& lod = gpuData[block->lod];
+            auto& out = subMesh.outputData[block->lod];
+            auto ptr = staging.ptr(*block);
+            switch (block->stream)
+            {
+                case SubMeshStream::ClusterBinding:
+                {
+                    block->dstIndex = lod.clusterData.modelResource.gpuIndex;
+                    auto cData = reinterpret_cast<ClusterData*>(ptr);
+                    size_t indexStart = lod.triangleData.modelResource.gpuIndex;
+                    for (size_t a = 0; a < block->elements; ++a)
+                    {
+                        cData[a].indexCount = out.clusterIndexCount[a];
+                        cData[a].indexPointer = static_cast<uint>(indexStart);
+                        cData[a].vertexPointer = static_cast<uint>(lod.vertexData.modelResource.gpuIndex + out.clusterVertexStarts[a]);
+                        indexStart += out.clusterIndexCount[a];
+                    }
+                    break;
+                }
+                case SubMeshStream::ClusterBoundingBox:
+                {
+                    block->dstIndex = lod.clusterData.modelResource.gpuIndex;
+                    if (block->elements > 0)
+                        memcpy(ptr, out.clusterBounds.data(), sizeof(BoundingBox) * block->elements);
+                    break;
+                }
+                case SubMeshStream::ClusterCone:
+                {
+                    // TODO: there actually isn't any bounding sphere data currently
+                    block->dstIndex = lod.clusterData.modelResource.gpuIndex;
+                    if (block->elements > 0)
+                        memcpy(ptr, out.clusterCones.data(), sizeof(Vector4f) * block->elements);
+                    break;
+                }
+                case SubMeshStream::SubMeshAdjacency:
+                {
+                    block->dstIndex = lod.subMeshData.modelResource.gpuIndex;
+                    auto sAdjacency = reinterpret_cast<SubMeshAdjacency*>(ptr);
+                    sAdjacency->adjacencyPointer = static_cast<uint>(lod.adjacencyData.modelResource.gpuIndex);
+                    sAdjacency->adjacencyCount = static_cast<uint>(lod.adjacencyData.modelResource.elements);
+                    sAdjacency->baseVertexPointer = static_cast<uint>(lod.vertexData.modelResource.gpuIndex);
+                    break;
+                }
+                case SubMeshStream::SubMeshData:
+                {
+                    block->dstIndex = lod.subMeshData.modelResource.gpuIndex;
+                    auto sMeshData = reinterpret_cast<SubMeshData*>(ptr);
+                    sMeshData->clusterCount = static_cast<uint>(out.clusterIndexStarts.size());
+                    sMeshData->clusterPointer = static_cast<uint>(lod.clusterData.modelResource.gpuIndex);
+                    break;
+                }
+                case SubMeshStream::SubMeshBoundingBox:
+                {
+                    block->dstIndex = lod.subMeshData.modelResource.gpuIndex;
+                    *reinterpret_cast<BoundingBox*>(ptr) = subMesh.boundingBox;
+                    break;
+                }
+                case SubMeshStream::SubMeshBoundingSphere:
+                {
+                    block->dstIndex = lod.subMeshData.modelResource.gpuIndex;
+                    *reinterpret_cast<BoundingSphere*>(ptr) = subMesh.boundingSphere;
+                    break;
+                }
+                default: break;
+            }
+        }
+
+        auto batch = backend.createBatch();
+        for (auto&& block : staging.blocks)
+        {
+            auto bytes = block.elements * block.elementBytes;
+            if (bytes > 0)
+                batch->upload(block.stream, block.dstIndex * block.elementBytes, block.stagingOffset, bytes);
+        }
+        batch->submit(staging.memory.data());
+        return batch;
+    }
+}
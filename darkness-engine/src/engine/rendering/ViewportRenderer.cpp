@@ -31,6 +31,7 @@ namespace engine
         , m_postProcess(device)
 		, m_ssrDebugPhase{ 0 }
 		, m_debugBoundingBoxes{ device }
+        , m_passRecorder{ device }
     {
     }
 
@@ -57,116 +58,150 @@ namespace engine
 		auto & camera = *scene.cameras[scene.selectedCamera];
         camera.jitteringEnabled(m_modelRenderer.taaEnabled());
 
-		{
-			CPU_MARKER(cmd.api(), "Clear viewport rtv");
-			GPU_MARKER(cmd, "Clear viewport rtv");
-			cmd.clearRenderTargetView(m_rtv, { 0.0f, 0.0f, 0.0f, 1.0f });
-		}
-
-		{
-			CPU_MARKER(cmd.api(), "Render shadows");
-			GPU_MARKER(cmd, "Render shadows");
-			if (scene.lightData->changeHappened())
-				m_shadowRenderer.refresh();
-			m_shadowRenderer.render(cmd, scene);
-		}
-
-		if (!(*m_modelRenderer.forwardRendering()))
-		{
-			m_modelRenderer.render(
-                m_device, 
-                m_depthPyramid, 
-                cmd, 
-                scene, 
-                m_shadowRenderer.shadowMap(),
-                m_shadowRenderer.shadowVP(), 
-                m_shadowRenderer.lightIndexToShadowIndex(),
-                *scene.lightData);
-			m_modelRenderer.renderLightBins(m_device, cmd, m_depthPyramid, scene, *scene.lightData);
+        // shadows and the viewport clear touch separate resources.
+        // everything after reads the shadow maps.
+        m_passRecorder.stage();
+        m_passRecorder.pass("Clear viewport rtv", [&](CommandList& cmd)
+        {
+            cmd.clearRenderTargetView(m_rtv, { 0.0f, 0.0f, 0.0f, 1.0f });
+        });
+        m_passRecorder.pass("Render shadows", [&](CommandList& cmd)
+        {
+            if (scene.lightData->changeHappened())
+                m_shadowRenderer.refresh();
+            m_shadowRenderer.render(cmd, scene);
+        });
+
+        // culling and the gbuffer share the depth pyramid and cluster datalines.
+        // the model renderer also draws its debug menu so it stays on this thread.
+        m_passRecorder.stage();
+        if (!(*m_modelRenderer.forwardRendering()))
+        {
+            m_passRecorder.pass("Render scene", [&](CommandList& cmd)
+            {
+                m_modelRenderer.render(
+                    m_device, 
+                    m_depthPyramid, 
+                    cmd, 
+                    scene, 
+                    m_shadowRenderer.shadowMap(),
+                    m_shadowRenderer.shadowVP(), 
+                    m_shadowRenderer.lightIndexToShadowIndex(),
+                    *scene.lightData);
 #ifndef _DURANGO
-			m_modelRenderer.renderPicker(cmd, mouseX, mouseY);
+                m_modelRenderer.renderPicker(cmd, mouseX, mouseY);
 #endif
-			m_modelRenderer.renderSSAO(m_device, cmd, m_depthPyramid, scene);
-			m_modelRenderer.renderSSR(m_device, cmd, m_depthPyramid, scene);
-			m_modelRenderer.renderLighting(
-				cmd, scene, m_depthPyramid, m_shadowRenderer.shadowMap(), 
-                m_shadowRenderer.shadowVP(), m_shadowRenderer.lightIndexToShadowIndex());
-
-		}
-		else
-		{
-			//m_modelRenderer.renderSSAOForward(m_device, cmd, m_depthPyramid, camera);
-			m_modelRenderer.renderForward(m_device, m_depthPyramid, cmd, scene,
-				m_shadowRenderer.shadowMap(), m_shadowRenderer.shadowVP(), m_shadowRenderer.lightIndexToShadowIndex(), *scene.lightData);
+            }, PassThread::Main);
+
+            // these read the gbuffer and write targets of their own
+            m_passRecorder.stage([&](CommandList& cmd)
+            {
+                m_modelRenderer.prepareScreenSpace(cmd);
+            });
+            m_passRecorder.pass("Render light bins", [&](CommandList& cmd)
+            {
+                m_modelRenderer.renderLightBins(m_device, cmd, m_depthPyramid, scene, *scene.lightData);
+            });
+            m_passRecorder.pass("Render SSAO", [&](CommandList& cmd)
+            {
+                m_modelRenderer.renderSSAO(m_device, cmd, m_depthPyramid, scene);
+            });
+            m_passRecorder.pass("Render SSR", [&](CommandList& cmd)
+            {
+                m_modelRenderer.renderSSR(m_device, cmd, m_depthPyramid, scene);
+            });
+
+            m_passRecorder.stage();
+            m_passRecorder.pass("Render lighting", [&](CommandList& cmd)
+            {
+                m_modelRenderer.renderLighting(
+                    cmd, scene, m_depthPyramid, m_shadowRenderer.shadowMap(), 
+                    m_shadowRenderer.shadowVP(), m_shadowRenderer.lightIndexToShadowIndex());
+            });
+        }
+        else
+        {
+            m_passRecorder.pass("Render scene", [&](CommandList& cmd)
+            {
+                //m_modelRenderer.renderSSAOForward(m_device, cmd, m_depthPyramid, camera);
+                m_modelRenderer.renderForward(m_device, m_depthPyramid, cmd, scene,
+                    m_shadowRenderer.shadowMap(), m_shadowRenderer.shadowVP(), m_shadowRenderer.lightIndexToShadowIndex(), *scene.lightData);
 
 #ifndef _DURANGO
-			m_modelRenderer.renderPicker(cmd, mouseX, mouseY);
+                m_modelRenderer.renderPicker(cmd, mouseX, mouseY);
 #endif
-		}
+            }, PassThread::Main);
+        }
 
-		{
-			CPU_MARKER(cmd.api(), "Render environment cubemap");
-			GPU_MARKER(cmd, "Render environment cubemap");
-            if(scene.cameraDebugging())
-			    m_renderCubemap.render(m_modelRenderer.lightingTargetRTV(), m_modelRenderer.debugDepth(), scene.drawCamera(), cmd);
-            else
-                m_renderCubemap.render(m_modelRenderer.lightingTargetRTV(), m_depthPyramid.dsv(), scene.drawCamera(), cmd);
-		}
+        m_passRecorder.stage();
+        m_passRecorder.pass("Render lighting target", [&](CommandList& cmd)
+        {
+            {
+                CPU_MARKER(cmd.api(), "Render environment cubemap");
+                GPU_MARKER(cmd, "Render environment cubemap");
+                if(scene.cameraDebugging())
+                    m_renderCubemap.render(m_modelRenderer.lightingTargetRTV(), m_modelRenderer.debugDepth(), scene.drawCamera(), cmd);
+                else
+                    m_renderCubemap.render(m_modelRenderer.lightingTargetRTV(), m_depthPyramid.dsv(), scene.drawCamera(), cmd);
+            }
 
 #ifdef PARTICLE_TEST_ENABLED
-        m_modelRenderer.renderParticles(
-            m_device,
-            cmd,
-            m_modelRenderer.lightingTargetRTV(),
-            m_depthPyramid.srv(),
-            scene.drawCamera(),
-            *scene.lightData,
-            m_shadowRenderer.shadowMap(), m_shadowRenderer.shadowVP());
+            m_modelRenderer.renderParticles(
+                m_device,
+                cmd,
+                m_modelRenderer.lightingTargetRTV(),
+                m_depthPyramid.srv(),
+                scene.drawCamera(),
+                *scene.lightData,
+                m_shadowRenderer.shadowMap(), m_shadowRenderer.shadowVP());
 #endif
 
-        m_modelRenderer.renderFrameDownsample(cmd);
-        m_modelRenderer.renderTransparent(
-            m_device, m_depthPyramid, 
-            cmd, scene, 
-            m_shadowRenderer.shadowMap(), m_shadowRenderer.shadowVP());
-        
-        m_modelRenderer.renderTerrain(
-            cmd,
-            scene,
-            m_modelRenderer.lightingTargetRTV(),
-            m_depthPyramid.dsv(),
-            m_shadowRenderer.shadowMap(), 
-            m_shadowRenderer.shadowVP(), 
-            m_shadowRenderer.lightIndexToShadowIndex(), 
-            *scene.lightData);
-
-        m_modelRenderer.renderDebugVoxels(
-            cmd,
-            scene,
-            m_modelRenderer.lightingTargetRTV(),
-            m_depthPyramid.dsv()
-        );
-
-		if(m_modelRenderer.debugBoundingBoxes())
-			m_debugBoundingBoxes.render(cmd, m_modelRenderer.lightingTargetRTV(),
-				m_depthPyramid.dsv(), scene.drawCamera(), virtualResolution());
-
-        m_modelRenderer.renderOutline(m_device, cmd, scene, m_depthPyramid, scene.drawCamera());
-        m_modelRenderer.renderTemporalResolve(cmd, m_depthPyramid, scene.drawCamera());
-		
-		if (*m_modelRenderer.forwardRendering())
-			m_modelRenderer.renderSSRForward(m_device, cmd, m_depthPyramid, scene.drawCamera());
-		
-        m_modelRenderer.flip();
+            m_modelRenderer.renderFrameDownsample(cmd);
+            m_modelRenderer.renderTransparent(
+                m_device, m_depthPyramid, 
+                cmd, scene, 
+                m_shadowRenderer.shadowMap(), m_shadowRenderer.shadowVP());
+            
+            m_modelRenderer.renderTerrain(
+                cmd,
+                scene,
+                m_modelRenderer.lightingTargetRTV(),
+                m_depthPyramid.dsv(),
+                m_shadowRenderer.shadowMap(), 
+                m_shadowRenderer.shadowVP(), 
+                m_shadowRenderer.lightIndexToShadowIndex(), 
+                *scene.lightData);
 
-        if(scene.postprocess)
+            m_modelRenderer.renderDebugVoxels(
+                cmd,
+                scene,
+                m_modelRenderer.lightingTargetRTV(),
+                m_depthPyramid.dsv()
+            );
+
+            if(m_modelRenderer.debugBoundingBoxes())
+                m_debugBoundingBoxes.render(cmd, m_modelRenderer.lightingTargetRTV(),
+                    m_depthPyramid.dsv(), scene.drawCamera(), virtualResolution());
+
+            m_modelRenderer.renderOutline(m_device, cmd, scene, m_depthPyramid, scene.drawCamera());
+            m_modelRenderer.renderTemporalResolve(cmd, m_depthPyramid, scene.drawCamera());
+            
+            if (*m_modelRenderer.forwardRendering())
+                m_modelRenderer.renderSSRForward(m_device, cmd, m_depthPyramid, scene.drawCamera());
+            
+            m_modelRenderer.flip();
+        });
+
+        m_passRecorder.stage();
+        m_passRecorder.pass("Render postprocess", [&](CommandList& cmd)
         {
-            CPU_MARKER(cmd.api(), "Render postprocess");
-            GPU_MARKER(cmd, "Render postprocess");
-            m_postProcess.render(destination, m_modelRenderer.finalFrame(), cmd, *scene.postprocess, m_modelRenderer.histogramDebug());
-        }
+            if(scene.postprocess)
+                m_postProcess.render(destination, m_modelRenderer.finalFrame(), cmd, *scene.postprocess, m_modelRenderer.histogramDebug());
+
+            m_modelRenderer.renderSSRDebug(cmd, destination, m_depthPyramid, m_ssrDebugPhase);
+        });
 
-		m_modelRenderer.renderSSRDebug(cmd, destination, m_depthPyramid, m_ssrDebugPhase);
+        m_passRecorder.record(cmd, *m_modelRenderer.parallelRecording());
     }
 
 	TextureSRV ViewportRenderer::ssrResult()
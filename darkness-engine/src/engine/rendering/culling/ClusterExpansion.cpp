@@ -2,6 +2,7 @@
 #include "engine/graphics/Device.h"
 #include "engine/graphics/ShaderStorage.h"
 #include "engine/graphics/CommandList.h"
+#include "engine/graphics/PipelinePrewarm.h"
 
 namespace engine
 {
@@ -27,6 +28,12 @@ namespace engine
         m_instanceToClusterExpandCreateArguments.cs.expandDispatchArgs = m_clusterExpandDispatchArgsUAV;
     }
 
+    void ClusterExpansion::prewarm(PipelinePrewarm& prewarm)
+    {
+        prewarm.add([this]() { m_clusterExpand.prewarm(); });
+        prewarm.add([this]() { m_instanceToClusterExpandCreateArguments.prewarm(); });
+    }
+
     void ClusterExpansion::expandClusters(
         CommandList& cmd,
         BufferSRV frustumCullingOutput,
@@ -0,0 +1,823 @@
+#include "engine/rendering/culling/CpuCuller.h"
+#include "engine/graphics/Common.h"
+#include "engine/primitives/Simd.h"
+#include "components/Camera.h"
+#include "tools/ToolsCommon.h"
+#include "tools/Debug.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace engine
+{
+    constexpr size_t CpuCullerChunkSize = 1024;
+    constexpr uint32_t InvalidLodPointer = 0xffffffff;
+
+    constexpr uint32_t MaterialAlphaClipped = 0x20;
+    constexpr uint32_t MaterialTransparent = 0x40;
+    constexpr uint32_t MaterialTerrain = 0x80;
+
+    namespace
+    {
+        // bounding box corners in the order the shaders use.
+        // structure of arrays so that four corners go through at once
+        struct Corners
+        {
+            float x[8];
+            float y[8];
+            float z[8];
+            float w[8];
+        };
+
+        void boxCorners(const Vector3f& bbmin, const Vector3f& bbmax, Corners& corners)
+        {
+            const float x[8] = { bbmin.x, bbmin.x, bbmin.x, bbmin.x, bbmax.x, bbmax.x, bbmax.x, bbmax.x };
+            const float y[8] = { bbmin.y, bbmax.y, bbmin.y, bbmax.y, bbmax.y, bbmin.y, bbmax.y, bbmin.y };
+            const float z[8] = { bbmin.z, bbmax.z, bbmax.z, bbmin.z, bbmax.z, bbmin.z, bbmin.z, bbmax.z };
+            for (int i = 0; i < 8; ++i)
+            {
+                corners.x[i] = x[i];
+                corners.y[i] = y[i];
+                corners.z[i] = z[i];
+                corners.w[i] = 1.0f;
+            }
+        }
+
+        // mul(m, float4(corner, 1)). same operation order as Matrix4f * Vector4f
+        void transformCorners(const Matrix4f& m, const Corners& src, Corners& dst, bool projected)
+        {
+#if defined(DARKNESS_SIMD)
+            for (int i = 0; i < 8; i += 4)
+            {
+                simd::float4 x = simd::load(&src.x[i]);
+                simd::float4 y = simd::load(&src.y[i]);
+                simd::float4 z = simd::load(&src.z[i]);
+
+                auto row = [&](float a, float b, float c, float d)
+                {
+                    return simd::add(simd::add(simd::add(
+                        simd::mul(simd::splat(a), x),
+                        simd::mul(simd::splat(b), y)),
+                        simd::mul(simd::splat(c), z)),
+                        simd::splat(d));
+                };
+                simd::store(&dst.x[i], row(m.m00, m.m01, m.m02, m.m03));
+                simd::store(&dst.y[i], row(m.m10, m.m11, m.m12, m.m13));
+                simd::store(&dst.z[i], row(m.m20, m.m21, m.m22, m.m23));
+                if (projected)
+                    simd::store(&dst.w[i], row(m.m30, m.m31, m.m32, m.m33));
+            }
+#else
+            for (int i = 0; i < 8; ++i)
+            {
+                float x = src.x[i];
+                float y = src.y[i];
+                float z = src.z[i];
+                dst.x[i] = m.m00 * x + m.m01 * y + m.m02 * z + m.m03;
+                dst.y[i] = m.m10 * x + m.m11 * y + m.m12 * z + m.m13;
+                dst.z[i] = m.m20 * x + m.m21 * y + m.m22 * z + m.m23;
+                if (projected)
+                    dst.w[i] = m.m30 * x + m.m31 * y + m.m32 * z + m.m33;
+            }
+#endif
+        }
+
+        // a < b ? a : b like simd::min
+        inline float minf(float a, float b) { return a < b ? a : b; }
+        inline float maxf(float a, float b) { return a > b ? a : b; }
+    }
+
+    namespace culling
+    {
+        bool frustumCull(
+            const Vector3f& bbmin, const Vector3f& bbmax,
+            const Matrix4f& transform,
+            const Vector3f& cameraPosition,
+            float farPlaneDistance,
+            const Vector4f* planes)
+        {
+            Corners corners;
+            boxCorners(bbmin, bbmax, corners);
+            transformCorners(transform, corners, corners, false);
+
+#if defined(DARKNESS_SIMD)
+            simd::float4 cam[3] = {
+                simd::splat(cameraPosition.x), simd::splat(cameraPosition.y), simd::splat(cameraPosition.z) };
+            simd::float4 dx[2], dy[2], dz[2];
+            for (int i = 0; i < 2; ++i)
+            {
+                dx[i] = simd::sub(simd::load(&corners.x[i * 4]), cam[0]);
+                dy[i] = simd::sub(simd::load(&corners.y[i * 4]), cam[1]);
+                dz[i] = simd::sub(simd::load(&corners.z[i * 4]), cam[2]);
+            }
+
+            const simd::float4 zero = simd::splat(0.0f);
+            for (int p = 0; p < 5; ++p)
+            {
+                simd::float4 px = simd::splat(planes[p].x);
+                simd::float4 py = simd::splat(planes[p].y);
+                simd::float4 pz = simd::splat(planes[p].z);
+                int hit = 0;
+                for (int i = 0; i < 2; ++i)
+                {
+                    simd::float4 d = simd::add(simd::add(
+                        simd::mul(px, dx[i]),
+                        simd::mul(py, dy[i])),
+                        simd::mul(pz, dz[i]));
+                    hit |= simd::greaterEqual(d, zero);
+                }
+                if (!hit)
+                    return false;
+            }
+
+            simd::float4 farPlane = simd::splat(farPlaneDistance);
+            int close = 0;
+            for (int i = 0; i < 2; ++i)
+            {
+                simd::float4 length = simd::sqrt(simd::add(simd::add(
+                    simd::mul(dx[i], dx[i]),
+                    simd::mul(dy[i], dy[i])),
+                    simd::mul(dz[i], dz[i])));
+                close |= simd::less(length, farPlane);
+            }
+            return close != 0;
+#else
+            float dx[8], dy[8], dz[8];
+            for (int c = 0; c < 8; ++c)
+            {
+                dx[c] = corners.x[c] - cameraPosition.x;
+                dy[c] = corners.y[c] - cameraPosition.y;
+                dz[c] = corners.z[c] - cameraPosition.z;
+            }
+
+            for (int p = 0; p < 5; ++p)
+            {
+                bool hit = false;
+                for (int c = 0; c < 8; ++c)
+                {
+                    if (planes[p].x * dx[c] + planes[p].y * dy[c] + planes[p].z * dz[c] >= 0.0f)
+                    {
+                        hit = true;
+                        break;
+                    }
+                }
+                if (!hit)
+                    return false;
+            }
+
+            for (int c = 0; c < 8; ++c)
+            {
+                if (std::sqrt(dx[c] * dx[c] + dy[c] * dy[c] + dz[c] * dz[c]) < farPlaneDistance)
+                    return true;
+            }
+            return false;
+#endif
+        }
+
+        bool coneCull(
+            const Matrix4f& /*transform*/,
+            const Vector4f& /*cone*/,
+            const Vector3f& /*cameraPosition*/,
+            const Vector3f& /*bbmin*/, const Vector3f& /*bbmax*/)
+        {
+            return true;
+        }
+
+        void screenMinMaxXYZ(
+            const Matrix4f& viewMatrix,
+            const Matrix4f& projectionMatrix,
+            const Matrix4f& transform,
+            const Vector3f& bbmin, const Vector3f& bbmax,
+            const Vector2f& screenSize,
+            Vector2f& minXY,
+            Vector2f& maxXY,
+            float& maxDepth)
+        {
+            screenMinMaxXYZ(
+                projectionMatrix * (viewMatrix * transform),
+                bbmin, bbmax, screenSize,
+                minXY, maxXY, maxDepth);
+        }
+
+        void screenMinMaxXYZ(
+            const Matrix4f& viewProj,
+            const Vector3f& bbmin, const Vector3f& bbmax,
+            const Vector2f& screenSize,
+            Vector2f& minXY,
+            Vector2f& maxXY,
+            float& maxDepth)
+        {
+            Corners corners;
+            boxCorners(bbmin, bbmax, corners);
+            transformCorners(viewProj, corners, corners, true);
+
+#if defined(DARKNESS_SIMD)
+            const simd::float4 zero = simd::splat(0.0f);
+            const simd::float4 one = simd::splat(1.0f);
+            const simd::float4 half = simd::splat(0.5f);
+            const simd::float4 width = simd::splat(screenSize.x);
+            const simd::float4 height = simd::splat(screenSize.y);
+
+            simd::float4 minX = simd::splat(FLT_MAX);
+            simd::float4 minY = simd::splat(FLT_MAX);
+            simd::float4 maxX = simd::splat(-1000000.0f);
+            simd::float4 maxY = simd::splat(-1000000.0f);
+            simd::float4 maxZ = simd::splat(-1000000.0f);
+            for (int i = 0; i < 8; i += 4)
+            {
+                simd::float4 w = simd::load(&corners.w[i]);
+                simd::float4 x = simd::div(simd::load(&corners.x[i]), w);
+                simd::float4 y = simd::div(simd::load(&corners.y[i]), w);
+                simd::float4 z = simd::div(simd::load(&corners.z[i]), w);
+
+                // corners behind the camera
+                z = simd::select(simd::less(z, zero), one, z);
+
+                x = simd::mul(simd::add(simd::mul(x, half), half), width);
+                y = simd::mul(simd::sub(one, simd::add(simd::mul(y, half), half)), height);
+
+                minX = simd::min(x, minX);
+                minY = simd::min(y, minY);
+                maxX = simd::max(x, maxX);
+                maxY = simd::max(y, maxY);
+                maxZ = simd::max(z, maxZ);
+            }
+
+            float lanes[5][4];
+            simd::store(lanes[0], minX);
+            simd::store(lanes[1], minY);
+            simd::store(lanes[2], maxX);
+            simd::store(lanes[3], maxY);
+            simd::store(lanes[4], maxZ);
+            minXY = { minf(minf(lanes[0][0], lanes[0][1]), minf(lanes[0][2], lanes[0][3])),
+                      minf(minf(lanes[1][0], lanes[1][1]), minf(lanes[1][2], lanes[1][3])) };
+            maxXY = { maxf(maxf(lanes[2][0], lanes[2][1]), maxf(lanes[2][2], lanes[2][3])),
+                      maxf(maxf(lanes[3][0], lanes[3][1]), maxf(lanes[3][2], lanes[3][3])) };
+            maxDepth = maxf(maxf(lanes[4][0], lanes[4][1]), maxf(lanes[4][2], lanes[4][3]));
+#else
+            minXY = { FLT_MAX, FLT_MAX };
+            maxXY = { -1000000.0f, -1000000.0f };
+            maxDepth = -1000000.0f;
+            for (int i = 0; i < 8; ++i)
+            {
+                float w = corners.w[i];
+                float x = corners.x[i] / w;
+                float y = corners.y[i] / w;
+                float z = corners.z[i] / w;
+
+                // corners behind the camera
+                if (z < 0.0f)
+                    z = 1.0f;
+
+                x = ((x * 0.5f) + 0.5f) * screenSize.x;
+                y = (1.0f - ((y * 0.5f) + 0.5f)) * screenSize.y;
+
+                minXY.x = minf(x, minXY.x);
+                minXY.y = minf(y, minXY.y);
+                maxXY.x = maxf(x, maxXY.x);
+                maxXY.y = maxf(y, maxXY.y);
+                maxDepth = maxf(z, maxDepth);
+            }
+#endif
+        }
+
+        uint32_t lodFromScreenSize(const Vector2f& size)
+        {
+            float screenSize = size.x;
+            if (screenSize < size.y) screenSize = size.y;
+            if (screenSize <= 5) return 7;
+            else if (screenSize <= 18) return 6;
+            else if (screenSize <= 32) return 5;
+            else if (screenSize <= 46) return 4;
+            else if (screenSize <= 61) return 3;
+            else if (screenSize <= 79) return 2;
+            else if (screenSize <= 105) return 1;
+            return 0;
+        }
+
+        bool occlusionVisible(
+            const SoftwareDepthPyramid& depth,
+            const Vector2f& pow2size,
+            const Vector2f& minXY,
+            const Vector2f& maxXY,
+            float maxDepth)
+        {
+            Vector2f qSize = { (maxXY.x - minXY.x) / 4.0f, (maxXY.y - minXY.y) / 4.0f };
+
+            // the same for every block
+            float biggerDimension = std::max(qSize.x, qSize.y);
+            float mipLevel = std::min(std::log2(biggerDimension) + 1.0f, static_cast<float>(depth.mipLevels() - 1));
+            uint32_t mip = mipLevel > 0.0f ? static_cast<uint32_t>(mipLevel) : 0u;
+
+            // every block samples its own corners. the columns and rows
+            // are worked out once for the 4x4 blocks
+            int minColumn[4], maxColumn[4], minRow[4], maxRow[4];
+            for (int i = 0; i < 4; ++i)
+            {
+                float localMinX = minXY.x + qSize.x * static_cast<float>(i);
+                float localMinY = minXY.y + qSize.y * static_cast<float>(i);
+                minColumn[i] = depth.column(localMinX / pow2size.x, mip);
+                maxColumn[i] = depth.column((localMinX + qSize.x) / pow2size.x, mip);
+                minRow[i] = depth.row(localMinY / pow2size.y, mip);
+                maxRow[i] = depth.row((localMinY + qSize.y) / pow2size.y, mip);
+            }
+
+            for (int x = 0; x < 4; ++x)
+            {
+                for (int y = 0; y < 4; ++y)
+                {
+                    float minBlockDepth = std::min(
+                        std::min(depth.load(minColumn[x], minRow[y], mip), depth.load(maxColumn[x], minRow[y], mip)),
+                        std::min(depth.load(minColumn[x], maxRow[y], mip), depth.load(maxColumn[x], maxRow[y], mip)));
+
+                    if (maxDepth >= minBlockDepth)
+                        return true;
+                }
+            }
+            return false;
+        }
+    }
+
+    SoftwareDepthPyramid::SoftwareDepthPyramid(int width, int height)
+        : m_width{ 0 }
+        , m_height{ 0 }
+        , m_widthPow2{ 0 }
+        , m_heightPow2{ 0 }
+    {
+        resize(width, height);
+    }
+
+    void SoftwareDepthPyramid::resize(int width, int height)
+    {
+        ASSERT(width > 0 && height > 0, "Depth pyramid needs a size");
+        if (m_width == width && m_height == height)
+            return;
+
+        m_width = width;
+        m_height = height;
+        m_widthPow2 = roundUpToPow2(width);
+        m_heightPow2 = roundUpToPow2(height);
+
+        m_mips.clear();
+        int mipWidth = m_widthPow2;
+        int mipHeight = m_heightPow2;
+        while (true)
+        {
+            m_mips.emplace_back(Mip{ mipWidth, mipHeight, engine::vector<float>(static_cast<size_t>(mipWidth) * mipHeight, 0.0f) });
+            if (mipWidth == 1 && mipHeight == 1)
+                break;
+            mipWidth = std::max(mipWidth >> 1, 1);
+            mipHeight = std::max(mipHeight >> 1, 1);
+        }
+    }
+
+    void SoftwareDepthPyramid::update(const float* depth, size_t pitch)
+    {
+        auto& top = m_mips[0];
+        for (int y = 0; y < m_height; ++y)
+            memcpy(&top.data[static_cast<size_t>(y) * top.width], &depth[static_cast<size_t>(y) * pitch], sizeof(float) * m_width);
+
+        for (size_t i = 1; i < m_mips.size(); ++i)
+        {
+            const auto& src = m_mips[i - 1];
+            auto& dst = m_mips[i];
+            for (int y = 0; y < dst.height; ++y)
+            {
+                const float* row0 = &src.data[static_cast<size_t>(std::min(y * 2, src.height - 1)) * src.width];
+                const float* row1 = &src.data[static_cast<size_t>(std::min(y * 2 + 1, src.height - 1)) * src.width];
+                float* out = &dst.data[static_cast<size_t>(y) * dst.width];
+                for (int x = 0; x < dst.width; ++x)
+                {
+                    int x0 = std::min(x * 2, src.width - 1);
+                    int x1 = std::min(x * 2 + 1, src.width - 1);
+                    out[x] = std::min(std::min(row0[x0], row0[x1]), std::min(row1[x0], row1[x1]));
+                }
+            }
+        }
+    }
+
+    float SoftwareDepthPyramid::sample(float u, float v, uint32_t mip) const
+    {
+        return load(column(u, mip), row(v, mip), mip);
+    }
+
+    int SoftwareDepthPyramid::column(float u, uint32_t mip) const
+    {
+        const auto& level = m_mips[std::min(static_cast<size_t>(mip), m_mips.size() - 1)];
+        float x = std::floor(u * static_cast<float>(level.width));
+        return x > 0.0f ? static_cast<int>(std::min(x, static_cast<float>(level.width - 1))) : 0;
+    }
+
+    int SoftwareDepthPyramid::row(float v, uint32_t mip) const
+    {
+        const auto& level = m_mips[std::min(static_cast<size_t>(mip), m_mips.size() - 1)];
+        float y = std::floor(v * static_cast<float>(level.height));
+        return y > 0.0f ? static_cast<int>(std::min(y, static_cast<float>(level.height - 1))) : 0;
+    }
+
+    float SoftwareDepthPyramid::load(int column, int row, uint32_t mip) const
+    {
+        const auto& level = m_mips[std::min(static_cast<size_t>(mip), m_mips.size() - 1)];
+        return level.data[static_cast<size_t>(row) * level.width + column];
+    }
+
+    CpuCullingView CpuCullingView::fromCamera(const Camera& camera, Vector2<int> virtualResolution)
+    {
+        CpuCullingView view;
+        view.viewMatrix = camera.viewMatrix();
+        view.projectionMatrix = camera.projectionMatrix();
+        view.cameraPosition = camera.position();
+        view.farPlaneDistance = camera.farPlane();
+
+        auto planes = extractFrustumPlanes(view.projectionMatrix * view.viewMatrix);
+        for (int i = 0; i < 6; ++i)
+            view.planes[i] = planes[i];
+
+        view.size = Vector2f{ static_cast<float>(virtualResolution.x), static_cast<float>(virtualResolution.y) };
+        view.pow2size = Vector2f{ static_cast<float>(roundUpToPow2(virtualResolution.x)), static_cast<float>(roundUpToPow2(virtualResolution.y)) };
+        return view;
+    }
+
+    void CpuClusterTracking::reset()
+    {
+        std::fill(bits.begin(), bits.end(), 0u);
+    }
+
+    void CpuClusterOutput::clear()
+    {
+        all.clear();
+        opaque.clear();
+        alphaClipped.clear();
+        transparent.clear();
+        terrain.clear();
+    }
+
+    double CullingStatistics::instanceEfficiency() const
+    {
+        if (instancesTested == 0)
+            return 0.0;
+        return static_cast<double>(instancesFrustumCulled + instancesOcclusionCulled) / static_cast<double>(instancesTested);
+    }
+
+    double CullingStatistics::clusterEfficiency() const
+    {
+        if (clustersTested == 0)
+            return 0.0;
+        return static_cast<double>(clustersTested - clustersPassed) / static_cast<double>(clustersTested);
+    }
+
+    void CullingStatistics::reset()
+    {
+        *this = CullingStatistics{};
+    }
+
+    CullingStatistics& CullingStatistics::operator+=(const CullingStatistics& stats)
+    {
+        instancesTested += stats.instancesTested;
+        instancesFrustumCulled += stats.instancesFrustumCulled;
+        instancesOcclusionCulled += stats.instancesOcclusionCulled;
+        instancesPassed += stats.instancesPassed;
+        clustersTested += stats.clustersTested;
+        clustersLodRejected += stats.clustersLodRejected;
+        clustersFrustumCulled += stats.clustersFrustumCulled;
+        clustersOcclusionCulled += stats.clustersOcclusionCulled;
+        clustersAlreadyDrawn += stats.clustersAlreadyDrawn;
+        clustersPassed += stats.clustersPassed;
+        milliseconds += stats.milliseconds;
+        return *this;
+    }
+
+    CpuCuller::CpuCuller(JobSystem& jobs)
+        : m_statistics{}
+        , m_jobs{ jobs }
+    {
+    }
+
+    void CpuCuller::resetStatistics()
+    {
+        m_statistics.reset();
+    }
+
+    void CpuCuller::parallel(size_t count, ChunkFunction function)
+    {
+        m_chunks.clear();
+        for (size_t begin = 0; begin < count; begin += CpuCullerChunkSize)
+            m_chunks.emplace_back(Chunk{ begin, std::min(begin + CpuCullerChunkSize, count), CullingStatistics{} });
+
+        m_jobs.parallelFor(m_chunks.size(), [&](size_t index)
+        {
+            auto& chunk = m_chunks[index];
+            function(chunk.begin, chunk.end, chunk.stats);
+        });
+
+        for (auto&& chunk : m_chunks)
+            m_statistics += chunk.stats;
+    }
+
+    void CpuCuller::instanceCull(
+        const CpuCullingView& view,
+        const CpuCullingScene& scene,
+        const SoftwareDepthPyramid* depth,
+        engine::vector<FrustumCullingOutput>& output)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        m_lodPointer.resize(scene.instanceCount);
+        parallel(scene.instanceCount, [&](size_t begin, size_t end, CullingStatistics& stats)
+        {
+            for (size_t instanceId = begin; instanceId < end; ++instanceId)
+            {
+                ++stats.instancesTested;
+                m_lodPointer[instanceId] = InvalidLodPointer;
+
+                const auto& transform = scene.transforms[instanceId].transform;
+                const auto& lodBind = scene.instanceLodBindings[instanceId];
+
+                // we pick the base lod to get a bounding box
+                const ::BoundingBox* bb = &scene.subMeshBoundingBoxes[scene.lodBindings[lodBind.lodPointer].submeshPointer];
+
+                Vector2f minXY;
+                Vector2f maxXY;
+                float maxDepth;
+                culling::screenMinMaxXYZ(
+                    view.viewMatrix, view.projectionMatrix, transform,
+                    bb->min, bb->max, view.size,
+                    minXY, maxXY, maxDepth);
+
+                uint32_t selectedLod = culling::lodFromScreenSize(maxXY - minXY);
+                uint32_t lodIndex = std::min(selectedLod, lodBind.lodCount - 1);
+
+                // now we get the actual LOD data
+                bb = &scene.subMeshBoundingBoxes[scene.lodBindings[lodBind.lodPointer + lodIndex].submeshPointer];
+
+                if (!culling::frustumCull(bb->min, bb->max, transform, view.cameraPosition, view.farPlaneDistance, view.planes))
+                {
+                    ++stats.instancesFrustumCulled;
+                    continue;
+                }
+
+                if (depth && !culling::occlusionVisible(*depth, view.pow2size, minXY, maxXY, maxDepth))
+                {
+                    ++stats.instancesOcclusionCulled;
+                    continue;
+                }
+
+                m_lodPointer[instanceId] = lodBind.lodPointer + lodIndex;
+            }
+        });
+
+        output.clear();
+        uint32_t outputPointer = 0;
+        for (size_t instanceId = 0; instanceId < scene.instanceCount; ++instanceId)
+        {
+            if (m_lodPointer[instanceId] == InvalidLodPointer)
+                continue;
+
+            const auto& subMeshUvLod = scene.lodBindings[m_lodPointer[instanceId]];
+            const auto& subMesh = scene.subMeshData[subMeshUvLod.submeshPointer];
+
+            FrustumCullingOutput out;
+            out.clusterPointer = subMesh.clusterPointer;
+            out.clusterCount = subMesh.clusterCount;
+            out.instancePointer = static_cast<uint32_t>(instanceId);
+            out.outputPointer = outputPointer;
+            out.uvPointer = subMeshUvLod.uvPointer;
+            out.lodPointer = m_lodPointer[instanceId];
+            out.padding1 = 0;
+            out.padding2 = 0;
+            output.emplace_back(out);
+
+            outputPointer += subMesh.clusterCount;
+            ++m_statistics.instancesPassed;
+        }
+
+        m_statistics.milliseconds += std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    void CpuCuller::expandClusters(
+        const engine::vector<FrustumCullingOutput>& instances,
+        engine::vector<ClusterInstanceData>& clusters)
+    {
+        size_t count = 0;
+        for (auto&& instance : instances)
+            count = std::max(count, static_cast<size_t>(instance.outputPointer + instance.clusterCount));
+
+        clusters.resize(count);
+        for (auto&& instance : instances)
+        {
+            for (uint32_t i = 0; i < instance.clusterCount; ++i)
+            {
+                auto& cluster = clusters[instance.outputPointer + i];
+                cluster.clusterPointer = instance.clusterPointer + i;
+                cluster.instancePointer = instance.instancePointer;
+                cluster.uvPointer = instance.uvPointer;
+                cluster.lodPointer = instance.lodPointer;
+            }
+        }
+    }
+
+    namespace
+    {
+        uint32_t trackingBit(
+            const CpuCullingScene& scene,
+            const CpuClusterTracking& tracking,
+            const ClusterInstanceData& cluster)
+        {
+            const auto& lodBind = scene.instanceLodBindings[cluster.instancePointer];
+            uint32_t zeroClusterPtr = scene.subMeshData[scene.lodBindings[lodBind.lodPointer].submeshPointer].clusterPointer;
+            return tracking.instanceOffset[cluster.instancePointer] + (cluster.clusterPointer - zeroClusterPtr);
+        }
+
+        void outputByMaterial(
+            const CpuCullingScene& scene,
+            const ClusterInstanceData& cluster,
+            CpuClusterOutput& output)
+        {
+            auto materialSet = scene.instanceMaterials[cluster.instancePointer].materialSet;
+            if ((materialSet & MaterialAlphaClipped) == MaterialAlphaClipped)
+                output.alphaClipped.emplace_back(cluster);
+            else if ((materialSet & MaterialTransparent) == MaterialTransparent)
+                output.transparent.emplace_back(cluster);
+            else if ((materialSet & MaterialTerrain) == MaterialTerrain)
+                output.terrain.emplace_back(cluster);
+            else
+                output.opaque.emplace_back(cluster);
+        }
+    }
+
+    void CpuCuller::clusterCull(
+        const CpuCullingView& view,
+        const CpuCullingScene& scene,
+        const engine::vector<ClusterInstanceData>& input,
+        CpuClusterTracking& tracking,
+        CpuClusterOutput& output)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        // the shader tests the lod bounding box of the instance for every
+        // cluster. the result only depends on the instance so it's done
+        // once per instance here. InvalidLodPointer marks culled instances
+        m_lodPointer.resize(scene.instanceCount);
+        parallel(scene.instanceCount, [&](size_t begin, size_t end, CullingStatistics&)
+        {
+            for (size_t instanceId = begin; instanceId < end; ++instanceId)
+            {
+                const auto& transform = scene.transforms[instanceId].transform;
+                const auto& lodBind = scene.instanceLodBindings[instanceId];
+
+                const ::BoundingBox* bb = &scene.subMeshBoundingBoxes[scene.lodBindings[lodBind.lodPointer].submeshPointer];
+
+                Vector2f minXY;
+                Vector2f maxXY;
+                float maxDepth;
+                culling::screenMinMaxXYZ(
+                    view.viewMatrix, view.projectionMatrix, transform,
+                    bb->min, bb->max, view.size,
+                    minXY, maxXY, maxDepth);
+
+                uint32_t selectedLod = culling::lodFromScreenSize(maxXY - minXY);
+                uint32_t lodIndex = std::min(selectedLod, lodBind.lodCount - 1);
+                bb = &scene.subMeshBoundingBoxes[scene.lodBindings[lodBind.lodPointer + lodIndex].submeshPointer];
+
+                m_lodPointer[instanceId] =
+                    culling::frustumCull(bb->min, bb->max, transform, view.cameraPosition, view.farPlaneDistance, view.planes) ?
+                    lodBind.lodPointer + lodIndex : InvalidLodPointer;
+            }
+        });
+
+        m_passed.resize(input.size());
+        parallel(input.size(), [&](size_t begin, size_t end, CullingStatistics& stats)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                ++stats.clustersTested;
+                const auto& cluster = input[i];
+                auto lodPointer = m_lodPointer[cluster.instancePointer];
+
+                m_passed[i] = 0;
+                if (lodPointer == InvalidLodPointer)
+                {
+                    ++stats.clustersFrustumCulled;
+                    continue;
+                }
+                if (lodPointer != cluster.lodPointer)
+                {
+                    // a cluster of another lod than the one the instance uses now
+                    ++stats.clustersLodRejected;
+                    continue;
+                }
+                m_passed[i] = 1;
+            }
+        });
+
+        // the gpu dedupes with an atomic or. in input order here so the
+        // first one of duplicates is the one that's kept
+        for (size_t i = 0; i < input.size(); ++i)
+        {
+            if (!m_passed[i])
+                continue;
+
+            const auto& cluster = input[i];
+            uint32_t bit = trackingBit(scene, tracking, cluster);
+            uint32_t mask = 1u << (bit % 32);
+            auto& bin = tracking.bits[bit / 32];
+            if (bin & mask)
+            {
+                ++m_statistics.clustersAlreadyDrawn;
+                continue;
+            }
+            bin |= mask;
+
+            outputByMaterial(scene, cluster, output);
+            ++m_statistics.clustersPassed;
+        }
+
+        m_statistics.milliseconds += std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    void CpuCuller::occlusionCull(
+        const CpuCullingView& view,
+        const CpuCullingScene& scene,
+        const SoftwareDepthPyramid& depth,
+        const engine::vector<ClusterInstanceData>& input,
+        const CpuClusterTracking& tracking,
+        CpuClusterOutput& output)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        m_passed.resize(input.size());
+        parallel(input.size(), [&](size_t begin, size_t end, CullingStatistics& stats)
+        {
+            // clusters of an instance are next to each other in the input
+            uint32_t viewProjInstance = 0xffffffff;
+            Matrix4f viewProj;
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                ++stats.clustersTested;
+                m_passed[i] = 0;
+
+                const auto& cluster = input[i];
+                const auto& transform = scene.transforms[cluster.instancePointer].transform;
+                const auto& bb = scene.clusterBoundingBoxes[cluster.clusterPointer];
+
+                if (!culling::frustumCull(bb.min, bb.max, transform, view.cameraPosition, view.farPlaneDistance, view.planes) ||
+                    !culling::coneCull(transform, scene.clusterCones[cluster.clusterPointer], view.cameraPosition, bb.min, bb.max))
+                {
+                    ++stats.clustersFrustumCulled;
+                    continue;
+                }
+
+                Vector2f minXY;
+                Vector2f maxXY;
+                float maxDepth;
+                if (viewProjInstance != cluster.instancePointer)
+                {
+                    viewProj = view.projectionMatrix * (view.viewMatrix * transform);
+                    viewProjInstance = cluster.instancePointer;
+                }
+                culling::screenMinMaxXYZ(
+                    viewProj,
+                    bb.min, bb.max, view.size,
+                    minXY, maxXY, maxDepth);
+
+                if (!culling::occlusionVisible(depth, view.pow2size, minXY, maxXY, maxDepth))
+                {
+                    ++stats.clustersOcclusionCulled;
+                    continue;
+                }
+                m_passed[i] = 1;
+            }
+        });
+
+        for (size_t i = 0; i < input.size(); ++i)
+        {
+            if (!m_passed[i])
+                continue;
+
+            // these are ALL clusters that pass occlusion test.
+            // this list will be used as basis for next frame
+            const auto& cluster = input[i];
+            output.all.emplace_back(cluster);
+            ++m_statistics.clustersPassed;
+
+            uint32_t bit = trackingBit(scene, tracking, cluster);
+            if (tracking.bits[bit / 32] & (1u << (bit % 32)))
+            {
+                ++m_statistics.clustersAlreadyDrawn;
+                continue;
+            }
+
+            // not yet drawn opaque clusters wait for the full depth + GBuffer pass
+            outputByMaterial(scene, cluster, output);
+        }
+
+        m_statistics.milliseconds += std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - start).count();
+    }
+}
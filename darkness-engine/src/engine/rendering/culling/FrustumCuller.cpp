@@ -2,6 +2,7 @@
 #include "engine/graphics/Device.h"
 #include "engine/graphics/ShaderStorage.h"
 #include "engine/graphics/CommandList.h"
+#include "engine/graphics/PipelinePrewarm.h"
 #include "engine/graphics/Sampler.h"
 #include "engine/graphics/SamplerDescription.h"
 #include "engine/rendering/ModelResources.h"
@@ -159,6 +160,16 @@ namespace engine
         m_clusterFrustumCreateArguments.cs.clusterFrustumDispatchArgs = m_clusterCullDispatchArgsUAV;
     }
 
+    void FrustumCuller::prewarm(PipelinePrewarm& prewarm)
+    {
+        prewarm.add([this]() { m_instanceFrustum.prewarm(); });
+        prewarm.add([this]() { m_instanceFrustumNoDepth.prewarm(); });
+        prewarm.add([this]() { m_instanceShadowFrustum.prewarm(); });
+        prewarm.add([this]() { m_clusterFrustum.prewarm(); });
+        prewarm.add([this]() { m_clusterFrustumCreateArguments.prewarm(); });
+        m_clusterExpansion->prewarm(prewarm);
+    }
+
     void FrustumCuller::instanceCull(
         CommandList& cmd,
         Camera& camera,
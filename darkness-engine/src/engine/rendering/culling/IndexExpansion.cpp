@@ -2,6 +2,7 @@
 #include "engine/graphics/Device.h"
 #include "engine/graphics/ShaderStorage.h"
 #include "engine/graphics/CommandList.h"
+#include "engine/graphics/PipelinePrewarm.h"
 #include "engine/rendering/BufferSettings.h"
 
 namespace engine
@@ -30,6 +31,12 @@ namespace engine
         m_createArguments.cs.expandDispatchArgs = m_expandDispatchArgsUAV;
     }
 
+    void IndexExpansion::prewarm(PipelinePrewarm& prewarm)
+    {
+        prewarm.add([this]() { m_indexExpand.prewarm(); });
+        prewarm.add([this]() { m_createArguments.prewarm(); });
+    }
+
     void IndexExpansion::expandIndexes(
         Device& device,
         CommandList& cmd,
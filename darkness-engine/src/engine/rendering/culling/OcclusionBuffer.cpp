@@ -0,0 +1,482 @@
+#include "engine/rendering/culling/OcclusionBuffer.h"
+#include "engine/rendering/ResidencyManager.h"
+#include "engine/rendering/SubMesh.h"
+#include "engine/primitives/MathBatch.h"
+#include "engine/primitives/Simd.h"
+#include "engine/Scene.h"
+#include "components/MeshRendererComponent.h"
+#include "components/Camera.h"
+#include "tools/Debug.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cfloat>
+#include <cmath>
+#include <utility>
+
+namespace engine
+{
+    constexpr int OcclusionTileWidth = 64;
+    constexpr int OcclusionTileHeight = 32;
+    constexpr int OcclusionBlockSize = 8;
+    constexpr size_t DefaultMaxOccluders = 128;
+    constexpr float DefaultMinOccluderArea = 64.0f;
+
+    // triangles and boxes with a vertex closer to the camera plane than
+    // this are left out. their screen positions are not usable
+    constexpr float MinOcclusionW = 0.01f;
+
+    namespace
+    {
+        // corner i has max x when bit 0 is set, max y with bit 1, max z with bit 2
+        const uint32_t BoxIndices[36] =
+        {
+            0, 2, 3, 0, 3, 1,
+            4, 5, 7, 4, 7, 6,
+            0, 1, 5, 0, 5, 4,
+            2, 6, 7, 2, 7, 3,
+            0, 4, 6, 0, 6, 2,
+            1, 3, 7, 1, 7, 5
+        };
+
+        void boxCorners(const BoundingBox& box, float scale, Vector4f* corners)
+        {
+            auto center = box.center();
+            Vector3f half{
+                (box.max.x - box.min.x) * 0.5f * scale,
+                (box.max.y - box.min.y) * 0.5f * scale,
+                (box.max.z - box.min.z) * 0.5f * scale };
+            for (int i = 0; i < 8; ++i)
+            {
+                corners[i] = Vector4f{
+                    (i & 1) ? center.x + half.x : center.x - half.x,
+                    (i & 2) ? center.y + half.y : center.y - half.y,
+                    (i & 4) ? center.z + half.z : center.z - half.z,
+                    1.0f };
+            }
+        }
+
+        // screen positions can be far outside of the buffer
+        int pixel(float value, int limit)
+        {
+            return static_cast<int>(std::floor(std::min(std::max(value, -1.0f), static_cast<float>(limit))));
+        }
+    }
+
+    void OcclusionStatistics::reset()
+    {
+        occluders = 0;
+        triangles = 0;
+        trianglesNearClipped = 0;
+        milliseconds = 0.0;
+    }
+
+    OcclusionBuffer::OcclusionBuffer(int width, int height, JobSystem& jobs)
+        : m_width{ width }
+        , m_height{ height }
+        , m_tilesX{ width / OcclusionTileWidth }
+        , m_tilesY{ height / OcclusionTileHeight }
+        , m_maxOccluders{ DefaultMaxOccluders }
+        , m_minOccluderArea{ DefaultMinOccluderArea }
+        , m_viewProjection{}
+        , m_depth(static_cast<size_t>(width * height), 0.0f)
+        , m_blockMin(static_cast<size_t>((width / OcclusionBlockSize) * (height / OcclusionBlockSize)), 0.0f)
+        , m_bins(static_cast<size_t>((width / OcclusionTileWidth) * (height / OcclusionTileHeight)))
+        , m_statistics{}
+        , m_jobs{ jobs }
+    {
+        ASSERT(width > 0 && width % OcclusionTileWidth == 0, "OcclusionBuffer width has to be a multiple of %i", OcclusionTileWidth);
+        ASSERT(height > 0 && height % OcclusionTileHeight == 0, "OcclusionBuffer height has to be a multiple of %i", OcclusionTileHeight);
+    }
+
+    void OcclusionBuffer::begin(const Matrix4f& viewProjection)
+    {
+        m_viewProjection = viewProjection;
+        m_triangles.clear();
+        m_statistics.reset();
+    }
+
+    void OcclusionBuffer::begin(const Camera& camera)
+    {
+        begin(camera.projectionMatrix() * camera.viewMatrix());
+    }
+
+    void OcclusionBuffer::addOccluder(const BoundingBox& box, const Matrix4f& transform)
+    {
+        if (!box.valid())
+            return;
+
+        Vector4f corners[8];
+        boxCorners(box, BoxOccluderScale, corners);
+        transformVectors(m_viewProjection * transform, corners, corners, 8);
+        addTriangles(corners, BoxIndices, 36);
+        ++m_statistics.occluders;
+    }
+
+    void OcclusionBuffer::addOccluder(
+        const Vector3f* vertices, size_t vertexCount,
+        const uint32_t* indices, size_t indexCount,
+        const Matrix4f& transform)
+    {
+        m_clip.resize(vertexCount);
+        for (size_t i = 0; i < vertexCount; ++i)
+            m_clip[i] = Vector4f{ vertices[i], 1.0f };
+        transformVectors(m_viewProjection * transform, m_clip.data(), m_clip.data(), vertexCount);
+        addTriangles(m_clip.data(), indices, indexCount);
+        ++m_statistics.occluders;
+    }
+
+    void OcclusionBuffer::addTriangles(const Vector4f* clip, const uint32_t* indices, size_t indexCount)
+    {
+        const float width = static_cast<float>(m_width);
+        const float height = static_cast<float>(m_height);
+
+        for (size_t i = 0; i + 2 < indexCount; i += 3)
+        {
+            const Vector4f* v[3] = { &clip[indices[i]], &clip[indices[i + 1]], &clip[indices[i + 2]] };
+            if (v[0]->w < MinOcclusionW || v[1]->w < MinOcclusionW || v[2]->w < MinOcclusionW)
+            {
+                ++m_statistics.trianglesNearClipped;
+                continue;
+            }
+
+            Triangle tri;
+            for (int a = 0; a < 3; ++a)
+            {
+                float invW = 1.0f / v[a]->w;
+                tri.x[a] = (v[a]->x * invW * 0.5f + 0.5f) * width;
+                tri.y[a] = (0.5f - v[a]->y * invW * 0.5f) * height;
+                tri.z[a] = v[a]->z * invW;
+            }
+
+            float minX = std::min(tri.x[0], std::min(tri.x[1], tri.x[2]));
+            float maxX = std::max(tri.x[0], std::max(tri.x[1], tri.x[2]));
+            float minY = std::min(tri.y[0], std::min(tri.y[1], tri.y[2]));
+            float maxY = std::max(tri.y[0], std::max(tri.y[1], tri.y[2]));
+            if (maxX <= 0.0f || maxY <= 0.0f || minX >= width || minY >= height)
+                continue;
+
+            m_triangles.emplace_back(tri);
+            ++m_statistics.triangles;
+        }
+    }
+
+    void OcclusionBuffer::addOccluders(const FlatScene& scene)
+    {
+        struct Candidate
+        {
+            float area;
+            const FlatSceneNode* node;
+            const BoundingBox* box;
+        };
+        engine::vector<Candidate> candidates;
+
+        const float screenArea = static_cast<float>(m_width * m_height);
+        for (auto&& node : scene.nodes)
+        {
+            if (!node.mesh)
+                continue;
+            auto& allocation = node.mesh->meshBuffer().modelAllocations;
+            if (!allocation || !allocation->subMeshInstance || !allocation->subMeshInstance->boundingBox.valid())
+                continue;
+
+            const auto& box = allocation->subMeshInstance->boundingBox;
+            int x0, y0, x1, y1;
+            float depth;
+            float area = screenBounds(node.transform, box, x0, y0, x1, y1, depth) ?
+                static_cast<float>((x1 - x0 + 1) * (y1 - y0 + 1)) :
+                0.0f;
+
+            // boxes around the camera don't project but can still
+            // have faces that do
+            if (depth == FLT_MAX)
+                area = screenArea;
+
+            if (area >= m_minOccluderArea)
+                candidates.emplace_back(Candidate{ area, &node, &box });
+        }
+
+        auto count = std::min(candidates.size(), m_maxOccluders);
+        std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+            [](const Candidate& a, const Candidate& b) { return a.area > b.area; });
+
+        for (size_t i = 0; i < count; ++i)
+            addOccluder(*candidates[i].box, candidates[i].node->transform);
+    }
+
+    void OcclusionBuffer::update(const FlatScene& scene, const Camera& camera)
+    {
+        begin(camera);
+        addOccluders(scene);
+        render();
+    }
+
+    void OcclusionBuffer::render()
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for (auto&& bin : m_bins)
+            bin.clear();
+
+        for (size_t i = 0; i < m_triangles.size(); ++i)
+        {
+            const auto& tri = m_triangles[i];
+            float minX = std::min(tri.x[0], std::min(tri.x[1], tri.x[2]));
+            float maxX = std::max(tri.x[0], std::max(tri.x[1], tri.x[2]));
+            float minY = std::min(tri.y[0], std::min(tri.y[1], tri.y[2]));
+            float maxY = std::max(tri.y[0], std::max(tri.y[1], tri.y[2]));
+
+            int tx0 = std::max(pixel(minX, m_width), 0) / OcclusionTileWidth;
+            int tx1 = std::min(pixel(maxX, m_width) / OcclusionTileWidth, m_tilesX - 1);
+            int ty0 = std::max(pixel(minY, m_height), 0) / OcclusionTileHeight;
+            int ty1 = std::min(pixel(maxY, m_height) / OcclusionTileHeight, m_tilesY - 1);
+
+            for (int ty = ty0; ty <= ty1; ++ty)
+                for (int tx = tx0; tx <= tx1; ++tx)
+                    m_bins[static_cast<size_t>(ty * m_tilesX + tx)].emplace_back(static_cast<uint32_t>(i));
+        }
+
+        m_jobs.parallelFor(m_bins.size(), [&](size_t tile) { rasterizeTile(tile); });
+
+        m_statistics.milliseconds = std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    void OcclusionBuffer::rasterizeTile(size_t tile)
+    {
+        const int tileX0 = static_cast<int>(tile % static_cast<size_t>(m_tilesX)) * OcclusionTileWidth;
+        const int tileY0 = static_cast<int>(tile / static_cast<size_t>(m_tilesX)) * OcclusionTileHeight;
+        const int tileX1 = tileX0 + OcclusionTileWidth - 1;
+        const int tileY1 = tileY0 + OcclusionTileHeight - 1;
+
+        for (int y = tileY0; y <= tileY1; ++y)
+            std::fill_n(&m_depth[static_cast<size_t>(y * m_width + tileX0)], OcclusionTileWidth, 0.0f);
+
+        for (auto&& index : m_bins[tile])
+        {
+            const auto& tri = m_triangles[index];
+
+            // edge i is the one opposite of vertex i. positive inside
+            float a[3];
+            float b[3];
+            float c[3];
+            for (int e = 0; e < 3; ++e)
+            {
+                int v0 = (e + 1) % 3;
+                int v1 = (e + 2) % 3;
+                a[e] = tri.y[v0] - tri.y[v1];
+                b[e] = tri.x[v1] - tri.x[v0];
+                c[e] = tri.x[v0] * tri.y[v1] - tri.y[v0] * tri.x[v1];
+            }
+            float area = a[0] * tri.x[0] + b[0] * tri.y[0] + c[0];
+            if (std::fabs(area) < FLT_EPSILON)
+                continue;
+            if (area < 0.0f)
+            {
+                for (int e = 0; e < 3; ++e)
+                {
+                    a[e] = -a[e];
+                    b[e] = -b[e];
+                    c[e] = -c[e];
+                }
+                area = -area;
+            }
+
+            // depth is linear in screen space
+            float invArea = 1.0f / area;
+            float za = (a[0] * tri.z[0] + a[1] * tri.z[1] + a[2] * tri.z[2]) * invArea;
+            float zb = (b[0] * tri.z[0] + b[1] * tri.z[1] + b[2] * tri.z[2]) * invArea;
+            float zc = (c[0] * tri.z[0] + c[1] * tri.z[1] + c[2] * tri.z[2]) * invArea;
+
+            float minX = std::min(tri.x[0], std::min(tri.x[1], tri.x[2]));
+            float maxX = std::max(tri.x[0], std::max(tri.x[1], tri.x[2]));
+            float minY = std::min(tri.y[0], std::min(tri.y[1], tri.y[2]));
+            float maxY = std::max(tri.y[0], std::max(tri.y[1], tri.y[2]));
+
+            // four pixels at a time from a four aligned start
+            int x0 = std::max(pixel(minX, m_width), tileX0) & ~3;
+            int x1 = std::min(pixel(maxX, m_width), tileX1);
+            int y0 = std::max(pixel(minY, m_height), tileY0);
+            int y1 = std::min(pixel(maxY, m_height), tileY1);
+
+#if defined(DARKNESS_SIMD)
+            const simd::float4 zero = simd::splat(0.0f);
+            const simd::float4 a0 = simd::splat(a[0]);
+            const simd::float4 a1 = simd::splat(a[1]);
+            const simd::float4 a2 = simd::splat(a[2]);
+            const simd::float4 az = simd::splat(za);
+            const simd::float4 lanes = simd::set(0.5f, 1.5f, 2.5f, 3.5f);
+#endif
+            for (int y = y0; y <= y1; ++y)
+            {
+                float py = static_cast<float>(y) + 0.5f;
+                float row0 = b[0] * py + c[0];
+                float row1 = b[1] * py + c[1];
+                float row2 = b[2] * py + c[2];
+                float rowZ = zb * py + zc;
+                float* depth = &m_depth[static_cast<size_t>(y * m_width)];
+
+#if defined(DARKNESS_SIMD)
+                const simd::float4 r0 = simd::splat(row0);
+                const simd::float4 r1 = simd::splat(row1);
+                const simd::float4 r2 = simd::splat(row2);
+                const simd::float4 rz = simd::splat(rowZ);
+                for (int x = x0; x <= x1; x += 4)
+                {
+                    simd::float4 px = simd::add(simd::splat(static_cast<float>(x)), lanes);
+                    int inside =
+                        simd::less(zero, simd::add(simd::mul(a0, px), r0)) &
+                        simd::less(zero, simd::add(simd::mul(a1, px), r1)) &
+                        simd::less(zero, simd::add(simd::mul(a2, px), r2));
+                    if (!inside)
+                        continue;
+
+                    simd::float4 z = simd::add(simd::mul(az, px), rz);
+                    simd::float4 current = simd::load(depth + x);
+                    simd::store(depth + x, simd::select(inside, simd::max(current, z), current));
+                }
+#else
+                for (int x = x0; x <= x1; ++x)
+                {
+                    float px = static_cast<float>(x) + 0.5f;
+                    if (a[0] * px + row0 > 0.0f &&
+                        a[1] * px + row1 > 0.0f &&
+                        a[2] * px + row2 > 0.0f)
+                    {
+                        float z = za * px + rowZ;
+                        depth[x] = std::max(depth[x], z);
+                    }
+                }
+#endif
+            }
+        }
+
+        const int blocksX = m_width / OcclusionBlockSize;
+        for (int by = tileY0 / OcclusionBlockSize; by <= tileY1 / OcclusionBlockSize; ++by)
+        {
+            for (int bx = tileX0 / OcclusionBlockSize; bx <= tileX1 / OcclusionBlockSize; ++bx)
+            {
+                float minDepth = FLT_MAX;
+                for (int y = by * OcclusionBlockSize; y < (by + 1) * OcclusionBlockSize; ++y)
+                    for (int x = bx * OcclusionBlockSize; x < (bx + 1) * OcclusionBlockSize; ++x)
+                        minDepth = std::min(minDepth, m_depth[static_cast<size_t>(y * m_width + x)]);
+                m_blockMin[static_cast<size_t>(by * blocksX + bx)] = minDepth;
+            }
+        }
+    }
+
+    bool OcclusionBuffer::screenBounds(
+        const Matrix4f& transform,
+        const BoundingBox& box,
+        int& x0, int& y0, int& x1, int& y1,
+        float& depth) const
+    {
+        x0 = y0 = x1 = y1 = 0;
+        depth = 0.0f;
+
+        Vector4f corners[8];
+        boxCorners(box, 1.0f, corners);
+        transformVectors(m_viewProjection * transform, corners, corners, 8);
+
+        float minX = FLT_MAX;
+        float minY = FLT_MAX;
+        float maxX = -FLT_MAX;
+        float maxY = -FLT_MAX;
+        float maxZ = -FLT_MAX;
+        for (int i = 0; i < 8; ++i)
+        {
+            // nearest possible depth for a box that reaches the camera
+            if (corners[i].w < MinOcclusionW)
+            {
+                depth = FLT_MAX;
+                return false;
+            }
+            float invW = 1.0f / corners[i].w;
+            float x = (corners[i].x * invW * 0.5f + 0.5f) * static_cast<float>(m_width);
+            float y = (0.5f - corners[i].y * invW * 0.5f) * static_cast<float>(m_height);
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+            maxZ = std::max(maxZ, corners[i].z * invW);
+        }
+
+        // every pixel the box touches
+        x0 = std::max(pixel(minX, m_width), 0);
+        y0 = std::max(pixel(minY, m_height), 0);
+        x1 = std::min(pixel(std::ceil(maxX) - 1.0f, m_width), m_width - 1);
+        y1 = std::min(pixel(std::ceil(maxY) - 1.0f, m_height), m_height - 1);
+        depth = maxZ;
+        return x0 <= x1 && y0 <= y1;
+    }
+
+    bool OcclusionBuffer::isOccluded(const BoundingBox& box) const
+    {
+        return isOccluded(box, Matrix4f::identity());
+    }
+
+    bool OcclusionBuffer::isOccluded(const BoundingBox& box, const Matrix4f& transform) const
+    {
+        if (!box.valid())
+            return false;
+
+        int x0, y0, x1, y1;
+        float depth;
+        if (!screenBounds(transform, box, x0, y0, x1, y1, depth))
+            return false;
+
+        const int blocksX = m_width / OcclusionBlockSize;
+        for (int by = y0 / OcclusionBlockSize; by <= y1 / OcclusionBlockSize; ++by)
+        {
+            for (int bx = x0 / OcclusionBlockSize; bx <= x1 / OcclusionBlockSize; ++bx)
+            {
+                // the whole block is in front of the box
+                if (m_blockMin[static_cast<size_t>(by * blocksX + bx)] > depth)
+                    continue;
+
+                int px0 = std::max(bx * OcclusionBlockSize, x0);
+                int px1 = std::min((bx + 1) * OcclusionBlockSize - 1, x1);
+                int py0 = std::max(by * OcclusionBlockSize, y0);
+                int py1 = std::min((by + 1) * OcclusionBlockSize - 1, y1);
+                for (int y = py0; y <= py1; ++y)
+                    for (int x = px0; x <= px1; ++x)
+                        if (m_depth[static_cast<size_t>(y * m_width + x)] <= depth)
+                            return false;
+            }
+        }
+        return true;
+    }
+
+    ResidencyPriority OcclusionBuffer::priority(const BoundingBox& box, const Matrix4f& transform) const
+    {
+        return isOccluded(box, transform) ? ResidencyPriority::Prefetch : ResidencyPriority::Visible;
+    }
+
+    void OcclusionBuffer::prioritizeStreaming(const FlatScene& scene) const
+    {
+        engine::vector<std::pair<MeshRequest*, ResidencyPriority>> requests;
+        const BoundingBox origin{ Vector3f{ 0.0f, 0.0f, 0.0f }, 0.5f };
+        auto addNodes = [&](const engine::vector<FlatSceneNode>& nodes)
+        {
+            for (auto&& node : nodes)
+            {
+                // the nodes keep their requests alive
+                auto request = node.mesh ? node.mesh->meshRequest() : nullptr;
+                if (request && request->state() == MeshRequestState::Queued)
+                    requests.emplace_back(request.get(), priority(origin, node.transform));
+            }
+        };
+        addNodes(scene.nodes);
+        addNodes(scene.alphaclippedNodes);
+        addNodes(scene.transparentNodes);
+
+        // nodes that share a mesh file share the request. it takes
+        // the most urgent priority of them
+        std::sort(requests.begin(), requests.end());
+        for (size_t i = 0; i < requests.size(); ++i)
+        {
+            if (i == 0 || requests[i].first != requests[i - 1].first)
+                requests[i].first->priority(requests[i].second);
+        }
+    }
+}
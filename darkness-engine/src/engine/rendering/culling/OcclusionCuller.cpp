@@ -1,6 +1,7 @@
 #include "engine/rendering/culling/OcclusionCuller.h"
 #include "engine/graphics/Device.h"
 #include "engine/graphics/CommandList.h"
+#include "engine/graphics/PipelinePrewarm.h"
 #include "engine/graphics/SamplerDescription.h"
 #include "engine/rendering/ModelResources.h"
 #include "engine/rendering/BufferSettings.h"
@@ -41,6 +42,13 @@ namespace engine
         m_occlusionCullCreateArguments.cs.occlusionDispatchArgs = m_occlusionCullingDispatchArgsUAV;
     }
 
+    void OcclusionCuller::prewarm(PipelinePrewarm& prewarm)
+    {
+        // emitAll is set once in the constructor so there is one permutation to create
+        prewarm.add([this]() { m_occlusionCull.prewarm(); });
+        prewarm.add([this]() { m_occlusionCullCreateArguments.prewarm(); });
+    }
+
     void OcclusionCuller::occlusionCull(
             CommandList& cmd,
             Camera& camera,
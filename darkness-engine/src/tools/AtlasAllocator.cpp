@@ -105,6 +105,14 @@ namespace engine
         m_free[freeListIndex].push(allocation);
     }
 
+    int AtlasAllocator::freeCount() const
+    {
+        int result = 0;
+        for (auto&& line : m_free)
+            result += static_cast<int>(line.size());
+        return result;
+    }
+
     engine::Vector2<int> AtlasAllocator::simulateSize(int allocationCount)
     {
         engine::vector<engine::queue<AtlasAllocation>> m_simulatedFree;
@@ -1,6 +1,7 @@
 #include "tools/CompressedFileZstd.h"
 #include "tools/Debug.h"
 #include "zstd.h"
+#include <limits>
 
 using namespace engine;
 
@@ -10,6 +11,7 @@ CompressedFileZstd::CompressedFileZstd()
     , m_eof{ false }
     , m_filePosition{ 0 }
     , m_memoryFile{ false }
+    , m_failed{ false }
 {
 }
 
@@ -33,7 +35,11 @@ void CompressedFileZstd::open(const string& filename, int mode)
             file.close();
         }
 
-        decode();
+        if (!decode())
+        {
+            m_fileContentsActive->clear();
+            m_file.close();
+        }
     }
 }
 
@@ -42,16 +48,21 @@ void CompressedFileZstd::open(engine::vector<char>& memory, int mode)
     m_mode = mode;
     m_memoryFile = true;
     m_fileContentsActive = &memory;
+    m_failed = false;
     if (((mode & std::ios::in) == std::ios::in) && memory.size() > 0)
     {
-        decode();
+        if (!decode())
+        {
+            memory.clear();
+            m_failed = true;
+        }
     }
 }
 
 bool CompressedFileZstd::is_open() const
 {
     if (m_memoryFile)
-        return true;
+        return !m_failed;
     return m_file.is_open();
 }
 
@@ -121,16 +132,27 @@ bool CompressedFileZstd::eof() const
     return m_eof;
 }
 
-void CompressedFileZstd::decode()
+bool CompressedFileZstd::decode()
 {
-    unsigned long long const rSize = ZSTD_getDecompressedSize(m_fileContentsActive->data(), m_fileContentsActive->size());
-	engine::vector<char> eBuff(static_cast<size_t>(rSize), 0);
+    // the size comes from the frame header. files that don't have it,
+    // or are not zstd at all, are rejected instead of trusted
+    unsigned long long const rSize = ZSTD_getFrameContentSize(m_fileContentsActive->data(), m_fileContentsActive->size());
+    if (rSize == ZSTD_CONTENTSIZE_ERROR || rSize == ZSTD_CONTENTSIZE_UNKNOWN || rSize > std::numeric_limits<size_t>::max())
+    {
+        LOG_ERROR("Compressed file has no valid zstd frame header: %s", m_filename.c_str());
+        return false;
+    }
 
+	engine::vector<char> eBuff(static_cast<size_t>(rSize), 0);
     size_t const dSize = ZSTD_decompress(eBuff.data(), static_cast<size_t>(rSize), m_fileContentsActive->data(), m_fileContentsActive->size());
-
-    ASSERT(dSize == rSize);
+    if (ZSTD_isError(dSize) || dSize != rSize)
+    {
+        LOG_ERROR("Compressed file is corrupted: %s", m_filename.c_str());
+        return false;
+    }
 
     m_fileContentsActive->swap(eBuff);
+    return true;
 }
 
 void CompressedFileZstd::encode()
@@ -0,0 +1,132 @@
+#include "tools/JobSystem.h"
+#include "tools/Debug.h"
+#include <algorithm>
+
+namespace engine
+{
+    JobGroup::JobGroup(JobSystem& jobs)
+        : m_jobs{ jobs }
+        , m_unfinished{ 0 }
+    {}
+
+    JobGroup::~JobGroup()
+    {
+        wait();
+    }
+
+    void JobGroup::run(Job job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_jobs.m_mutex);
+            m_pending.push(std::move(job));
+            ++m_unfinished;
+
+            // without workers wait() runs everything
+            if (m_pending.size() == 1 && m_jobs.m_workers.size() > 0)
+                m_jobs.m_ready.emplace_back(this);
+        }
+        m_jobs.m_jobAvailable.notify_one();
+        m_done.notify_all();
+    }
+
+    void JobGroup::wait()
+    {
+        std::unique_lock<std::mutex> lock(m_jobs.m_mutex);
+        while (m_unfinished > 0)
+        {
+            if (m_pending.size() > 0)
+            {
+                auto job = m_jobs.take(*this);
+                lock.unlock();
+                job();
+                lock.lock();
+                m_jobs.finished(*this);
+            }
+            else
+                m_done.wait(lock, [&]() { return m_unfinished == 0 || m_pending.size() > 0; });
+        }
+    }
+
+    JobSystem& JobSystem::instance()
+    {
+        static JobSystem jobs(std::max(static_cast<size_t>(std::thread::hardware_concurrency()), static_cast<size_t>(2u)) - 1);
+        return jobs;
+    }
+
+    JobSystem::JobSystem(size_t workerCount)
+        : m_alive{ true }
+    {
+        for (size_t i = 0; i < workerCount; ++i)
+            m_workers.emplace_back([this]() { this->worker(); });
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ASSERT(m_ready.size() == 0, "JobSystem destroyed with jobs left");
+            m_alive = false;
+        }
+        m_jobAvailable.notify_all();
+        for (auto&& worker : m_workers)
+            worker.join();
+    }
+
+    JobGroup::Job JobSystem::take(JobGroup& group)
+    {
+        auto job = std::move(group.m_pending.front());
+        group.m_pending.pop();
+
+        // a group is in the ready list while it has pending jobs
+        auto ready = std::find(m_ready.begin(), m_ready.end(), &group);
+        if (ready != m_ready.end())
+        {
+            m_ready.erase(ready);
+            if (group.m_pending.size() > 0)
+                m_ready.emplace_back(&group);
+        }
+        return job;
+    }
+
+    void JobSystem::finished(JobGroup& group)
+    {
+        // the group may be gone as soon as the lock is released
+        --group.m_unfinished;
+        if (group.m_unfinished == 0)
+            group.m_done.notify_all();
+    }
+
+    void JobSystem::worker()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_jobAvailable.wait(lock, [&]() { return !m_alive || m_ready.size() > 0; });
+            if (!m_alive)
+                return;
+
+            auto& group = *m_ready.front();
+            auto job = take(group);
+            lock.unlock();
+            job();
+            lock.lock();
+            finished(group);
+        }
+    }
+
+    void JobSystem::parallelFor(size_t count, const std::function<void(size_t)>& function)
+    {
+        if (m_workers.size() == 0 || count < 2)
+        {
+            for (size_t i = 0; i < count; ++i)
+                function(i);
+            return;
+        }
+
+        JobGroup group(*this);
+        for (size_t i = 1; i < count; ++i)
+            group.run([&function, i]() { function(i); });
+        function(0);
+        group.wait();
+    }
+}
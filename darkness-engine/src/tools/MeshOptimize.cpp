@@ -0,0 +1,388 @@
+#include "tools/MeshOptimize.h"
+#include "tools/Debug.h"
+#include "engine/rendering/BufferSettings.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+using namespace engine;
+
+namespace engine
+{
+    namespace
+    {
+        // Forsyth, "Linear-Speed Vertex Cache Optimisation"
+        constexpr int ForsythCacheSize = 32;
+        constexpr float CacheDecayPower = 1.5f;
+        constexpr float LastTriangleScore = 0.75f;
+        constexpr float ValenceBoostScale = 2.0f;
+        constexpr float ValenceBoostPower = 0.5f;
+
+        // overdraw runs shorter than this are not split off
+        constexpr size_t MinOverdrawRunTriangles = 4;
+
+        constexpr uint32_t Unused = std::numeric_limits<uint32_t>::max();
+
+        // the index compacted to 0..vertexCount-1 so that the per vertex
+        // data of a cluster does not scale with the whole mesh
+        struct LocalIndex
+        {
+            engine::vector<uint32_t> index;
+            uint32_t vertexCount;
+        };
+
+        LocalIndex localIndex(const uint32_t* index, size_t indexCount)
+        {
+            engine::vector<uint32_t> unique(index, index + indexCount);
+            std::sort(unique.begin(), unique.end());
+            unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+
+            LocalIndex result;
+            result.vertexCount = static_cast<uint32_t>(unique.size());
+            result.index.resize(indexCount);
+            for (size_t i = 0; i < indexCount; ++i)
+                result.index[i] = static_cast<uint32_t>(std::lower_bound(unique.begin(), unique.end(), index[i]) - unique.begin());
+            return result;
+        }
+
+        float vertexScore(int cachePosition, uint32_t remainingTriangles)
+        {
+            if (remainingTriangles == 0)
+                return -1.0f;
+
+            float score = 0.0f;
+            if (cachePosition >= 0)
+            {
+                if (cachePosition < 3)
+                    score = LastTriangleScore;
+                else
+                {
+                    const float scaler = 1.0f / static_cast<float>(ForsythCacheSize - 3);
+                    score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scaler, CacheDecayPower);
+                }
+            }
+            return score + ValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -ValenceBoostPower);
+        }
+
+        // cache misses of every triangle with a fifo cache
+        engine::vector<uint32_t> triangleMisses(const uint32_t* index, size_t indexCount, uint32_t vertexCount, uint32_t cacheSize)
+        {
+            engine::vector<uint32_t> cacheTime(vertexCount, 0);
+            engine::vector<uint32_t> misses(indexCount / 3, 0);
+            uint32_t time = cacheSize + 1;
+            for (size_t i = 0; i < indexCount; ++i)
+            {
+                auto v = index[i];
+                if (time - cacheTime[v] > cacheSize)
+                {
+                    cacheTime[v] = time++;
+                    ++misses[i / 3];
+                }
+            }
+            return misses;
+        }
+    }
+
+    VertexCacheStatistics meshAnalyzeVertexCache(const uint32_t* index, size_t indexCount, uint32_t cacheSize)
+    {
+        ASSERT(indexCount % 3 == 0, "Index count is not a multiple of 3");
+        if (indexCount == 0)
+            return { 0.0f, 0.0f };
+
+        auto local = localIndex(index, indexCount);
+        auto misses = triangleMisses(local.index.data(), indexCount, local.vertexCount, cacheSize);
+
+        size_t transformed = 0;
+        for (auto&& miss : misses)
+            transformed += miss;
+        return {
+            static_cast<float>(transformed) / static_cast<float>(indexCount / 3),
+            static_cast<float>(transformed) / static_cast<float>(local.vertexCount) };
+    }
+
+    void meshOptimizeVertexCache(uint32_t* index, size_t indexCount)
+    {
+        ASSERT(indexCount % 3 == 0, "Index count is not a multiple of 3");
+        auto triangleCount = indexCount / 3;
+        if (triangleCount < 2)
+            return;
+
+        auto local = localIndex(index, indexCount);
+        auto vertexCount = local.vertexCount;
+
+        // triangles of every vertex. the ones already emitted are swapped
+        // past the remaining count
+        engine::vector<uint32_t> remaining(vertexCount, 0);
+        for (auto&& v : local.index)
+            ++remaining[v];
+        engine::vector<uint32_t> offsets(vertexCount + 1, 0);
+        for (uint32_t v = 0; v < vertexCount; ++v)
+            offsets[v + 1] = offsets[v] + remaining[v];
+        engine::vector<uint32_t> vertexTriangles(indexCount);
+        {
+            engine::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < indexCount; ++i)
+                vertexTriangles[fill[local.index[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        engine::vector<int> cachePosition(vertexCount, -1);
+        engine::vector<float> score(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; ++v)
+            score[v] = vertexScore(-1, remaining[v]);
+
+        engine::vector<bool> emitted(triangleCount, false);
+        auto triangleScore = [&](uint32_t triangle)
+        {
+            const auto* tri = &local.index[triangle * 3];
+            return score[tri[0]] + score[tri[1]] + score[tri[2]];
+        };
+
+        engine::vector<uint32_t> output(indexCount);
+        engine::vector<uint32_t> cache;
+        engine::vector<uint32_t> newCache;
+        cache.reserve(ForsythCacheSize + 3);
+        newCache.reserve(ForsythCacheSize + 3);
+
+        uint32_t best = Unused;
+        size_t cursor = 0;
+        for (size_t out = 0; out < triangleCount; ++out)
+        {
+            if (best == Unused)
+            {
+                // nothing in the cache has triangles left, start from the
+                // next triangle in input order
+                while (emitted[cursor])
+                    ++cursor;
+                best = static_cast<uint32_t>(cursor);
+            }
+
+            emitted[best] = true;
+            const auto* tri = &local.index[best * 3];
+            for (int i = 0; i < 3; ++i)
+            {
+                output[out * 3 + i] = index[best * 3 + i];
+
+                auto v = tri[i];
+                auto begin = vertexTriangles.begin() + offsets[v];
+                auto end = begin + remaining[v];
+                auto found = std::find(begin, end, best);
+                ASSERT(found != end, "Vertex cache optimisation lost a triangle");
+                std::swap(*found, *(end - 1));
+                --remaining[v];
+            }
+
+            newCache.clear();
+            for (int i = 0; i < 3; ++i)
+                newCache.emplace_back(tri[i]);
+            for (auto&& v : cache)
+                if (v != tri[0] && v != tri[1] && v != tri[2])
+                    newCache.emplace_back(v);
+
+            for (size_t i = 0; i < newCache.size(); ++i)
+            {
+                auto v = newCache[i];
+                cachePosition[v] = i < static_cast<size_t>(ForsythCacheSize) ? static_cast<int>(i) : -1;
+                score[v] = vertexScore(cachePosition[v], remaining[v]);
+            }
+            if (newCache.size() > static_cast<size_t>(ForsythCacheSize))
+                newCache.resize(ForsythCacheSize);
+            std::swap(cache, newCache);
+
+            best = Unused;
+            float bestScore = -std::numeric_limits<float>::max();
+            for (auto&& v : cache)
+            {
+                for (uint32_t t = 0; t < remaining[v]; ++t)
+                {
+                    auto triangle = vertexTriangles[offsets[v] + t];
+                    auto s = triangleScore(triangle);
+                    if (s > bestScore)
+                    {
+                        bestScore = s;
+                        best = triangle;
+                    }
+                }
+            }
+        }
+
+        std::copy(output.begin(), output.end(), index);
+    }
+
+    void meshOptimizeOverdraw(uint32_t* index, size_t indexCount, const engine::vector<Vector3f>& vertex, float threshold)
+    {
+        ASSERT(indexCount % 3 == 0, "Index count is not a multiple of 3");
+        auto triangleCount = indexCount / 3;
+        if (triangleCount < MinOverdrawRunTriangles * 2)
+            return;
+
+        auto local = localIndex(index, indexCount);
+        auto misses = triangleMisses(local.index.data(), indexCount, local.vertexCount, VertexCacheStatisticsSize);
+        size_t totalMisses = 0;
+        for (auto&& miss : misses)
+            totalMisses += miss;
+        auto acmr = static_cast<float>(totalMisses) / static_cast<float>(triangleCount);
+
+        // split into runs where the cache starts over (all three vertexes
+        // miss) or where the run would be about as good as the whole when
+        // drawn with an empty cache. reordered runs start with one
+        engine::vector<uint32_t> runStarts;
+        {
+            engine::vector<uint32_t> cacheTime(local.vertexCount, 0);
+            uint32_t time = VertexCacheStatisticsSize + 1;
+            size_t runStart = 0;
+            size_t runMisses = 0;
+            for (size_t t = 0; t < triangleCount; ++t)
+            {
+                uint32_t coldMisses = 0;
+                for (int i = 0; i < 3; ++i)
+                {
+                    auto v = local.index[t * 3 + i];
+                    if (time - cacheTime[v] > VertexCacheStatisticsSize)
+                    {
+                        cacheTime[v] = time++;
+                        ++coldMisses;
+                    }
+                }
+                if (t > runStart && misses[t] == 3)
+                {
+                    runStarts.emplace_back(static_cast<uint32_t>(runStart));
+                    runStart = t;
+                    runMisses = coldMisses;
+                }
+                else
+                    runMisses += coldMisses;
+
+                auto runLength = t + 1 - runStart;
+                if (runLength >= MinOverdrawRunTriangles &&
+                    static_cast<float>(runMisses) / static_cast<float>(runLength) <= acmr * threshold)
+                {
+                    runStarts.emplace_back(static_cast<uint32_t>(runStart));
+                    runStart = t + 1;
+                    runMisses = 0;
+
+                    // empties the cache
+                    time += VertexCacheStatisticsSize + 1;
+                }
+            }
+            if (runStart < triangleCount)
+                runStarts.emplace_back(static_cast<uint32_t>(runStart));
+        }
+        if (runStarts.size() < 2)
+            return;
+
+        // area weighted centroid and normal of every run
+        struct Run
+        {
+            Vector3f centroid;
+            Vector3f normal;
+            float area;
+            uint32_t start;
+            uint32_t end;
+            float sortKey;
+        };
+        engine::vector<Run> runs(runStarts.size());
+        Vector3f meshCentroid{ 0.0f, 0.0f, 0.0f };
+        float meshArea = 0.0f;
+        for (size_t r = 0; r < runStarts.size(); ++r)
+        {
+            auto& run = runs[r];
+            run.start = runStarts[r];
+            run.end = r + 1 < runStarts.size() ? runStarts[r + 1] : static_cast<uint32_t>(triangleCount);
+            run.centroid = Vector3f{ 0.0f, 0.0f, 0.0f };
+            run.normal = Vector3f{ 0.0f, 0.0f, 0.0f };
+            run.area = 0.0f;
+            for (auto t = run.start; t < run.end; ++t)
+            {
+                const auto& p0 = vertex[index[t * 3 + 0]];
+                const auto& p1 = vertex[index[t * 3 + 1]];
+                const auto& p2 = vertex[index[t * 3 + 2]];
+                Vector3f normal = (p1 - p0).cross(p2 - p0);
+                auto area = normal.magnitude();
+                run.centroid += (p0 + p1 + p2) * (area / 3.0f);
+                run.normal += normal;
+                run.area += area;
+            }
+            meshCentroid += run.centroid;
+            meshArea += run.area;
+            if (run.area > 0.0f)
+                run.centroid /= run.area;
+        }
+        if (meshArea <= 0.0f)
+            return;
+        meshCentroid /= meshArea;
+
+        // runs facing away from the center occlude the ones facing in
+        for (auto&& run : runs)
+        {
+            auto length = run.normal.magnitude();
+            run.sortKey = length > 0.0f ? (run.centroid - meshCentroid).dot(run.normal) / length : 0.0f;
+        }
+        std::stable_sort(runs.begin(), runs.end(), [](const Run& a, const Run& b) { return a.sortKey > b.sortKey; });
+
+        engine::vector<uint32_t> output;
+        output.reserve(indexCount);
+        for (auto&& run : runs)
+            output.insert(output.end(), index + run.start * 3, index + run.end * 3);
+        std::copy(output.begin(), output.end(), index);
+    }
+
+    void meshOptimizeVertexFetch(ModelCpu& model, engine::vector<uint32_t>& index)
+    {
+        auto vertexCount = model.vertex.size();
+        engine::vector<uint32_t> remap(vertexCount, Unused);
+        uint32_t next = 0;
+        for (auto&& v : index)
+        {
+            ASSERT(v < vertexCount, "Index out of the vertex buffer");
+            if (remap[v] == Unused)
+                remap[v] = next++;
+        }
+        for (auto&& r : remap)
+            if (r == Unused)
+                r = next++;
+
+        auto reorder = [&](auto& stream)
+        {
+            if (stream.size() != vertexCount)
+                return;
+            typename std::remove_reference<decltype(stream)>::type reordered(vertexCount);
+            for (size_t v = 0; v < vertexCount; ++v)
+                reordered[remap[v]] = stream[v];
+            stream.swap(reordered);
+        };
+        reorder(model.vertex);
+        reorder(model.normal);
+        reorder(model.tangent);
+        for (auto&& color : model.color)
+            reorder(color);
+        for (auto&& uv : model.uv)
+            reorder(uv);
+
+        for (auto&& v : index)
+            v = remap[v];
+        for (auto&& v : model.index)
+            v = remap[v];
+    }
+
+    void meshOptimizeClusters(ModelCpu& model, engine::vector<uint32_t>& clusterIndex, JobSystem& jobs)
+    {
+        ASSERT(clusterIndex.size() % 3 == 0, "Index count is not a multiple of 3");
+        auto clusterCount = (clusterIndex.size() + ClusterMaxSize - 1) / ClusterMaxSize;
+        auto workerCount = std::min(jobs.workerCount() + 1, clusterCount);
+
+        std::atomic<size_t> nextCluster{ 0 };
+        jobs.parallelFor(workerCount, [&](size_t)
+        {
+            for (auto cluster = nextCluster++; cluster < clusterCount; cluster = nextCluster++)
+            {
+                auto start = cluster * ClusterMaxSize;
+                auto count = std::min(static_cast<size_t>(ClusterMaxSize), clusterIndex.size() - start);
+                meshOptimizeVertexCache(clusterIndex.data() + start, count);
+                meshOptimizeOverdraw(clusterIndex.data() + start, count, model.vertex);
+            }
+        });
+
+        meshOptimizeVertexFetch(model, clusterIndex);
+    }
+}
@@ -0,0 +1,694 @@
+#include "tools/MeshSimplify.h"
+#include "tools/Debug.h"
+#include "containers/unordered_map.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace engine;
+
+namespace engine
+{
+    namespace
+    {
+        // position, normal and the first uv channel
+        constexpr int MaxDimensions = 8;
+        constexpr int MaxQuadricTerms = MaxDimensions * (MaxDimensions + 1) / 2;
+
+        // collapsing a triangle may not turn it more than this (cosine)
+        constexpr double MinNormalCosine = 0.1;
+
+        // open edges that are not locked keep their place with this weight
+        constexpr double BorderWeight = 10.0;
+
+        // Garland & Heckbert 1998, the triangle is a plane in the
+        // position and attribute space. error = v'Av + 2b'v + c
+        struct Quadric
+        {
+            double a[MaxQuadricTerms];
+            double b[MaxDimensions];
+            double c;
+        };
+
+        void clear(Quadric& q)
+        {
+            memset(&q, 0, sizeof(Quadric));
+        }
+
+        void add(Quadric& dst, const Quadric& src)
+        {
+            for (int i = 0; i < MaxQuadricTerms; ++i)
+                dst.a[i] += src.a[i];
+            for (int i = 0; i < MaxDimensions; ++i)
+                dst.b[i] += src.b[i];
+            dst.c += src.c;
+        }
+
+        double dot(const double* a, const double* b, int n)
+        {
+            double res = 0.0;
+            for (int i = 0; i < n; ++i)
+                res += a[i] * b[i];
+            return res;
+        }
+
+        double evaluate(const Quadric& q, const double* v, int n)
+        {
+            double res = q.c;
+            int term = 0;
+            for (int i = 0; i < n; ++i)
+            {
+                res += q.a[term++] * v[i] * v[i];
+                for (int j = i + 1; j < n; ++j)
+                    res += 2.0 * q.a[term++] * v[i] * v[j];
+                res += 2.0 * q.b[i] * v[i];
+            }
+            return res;
+        }
+
+        // A = I - e1e1' - e2e2', b = (p.e1)e1 + (p.e2)e2 - p, c = p.p - (p.e1)^2 - (p.e2)^2
+        void addTriangle(Quadric& q, const double* p0, const double* p1, const double* p2, int n, double weight)
+        {
+            double e1[MaxDimensions];
+            double e2[MaxDimensions];
+            for (int i = 0; i < n; ++i)
+            {
+                e1[i] = p1[i] - p0[i];
+                e2[i] = p2[i] - p0[i];
+            }
+            double len = std::sqrt(dot(e1, e1, n));
+            if (len <= 0.0)
+                return;
+            for (int i = 0; i < n; ++i)
+                e1[i] /= len;
+
+            double along = dot(e1, e2, n);
+            for (int i = 0; i < n; ++i)
+                e2[i] -= along * e1[i];
+            len = std::sqrt(dot(e2, e2, n));
+            if (len <= 0.0)
+                return;
+            for (int i = 0; i < n; ++i)
+                e2[i] /= len;
+
+            double pe1 = dot(p0, e1, n);
+            double pe2 = dot(p0, e2, n);
+
+            int term = 0;
+            for (int i = 0; i < n; ++i)
+            {
+                for (int j = i; j < n; ++j)
+                    q.a[term++] += weight * ((i == j ? 1.0 : 0.0) - e1[i] * e1[j] - e2[i] * e2[j]);
+                q.b[i] += weight * (pe1 * e1[i] + pe2 * e2[i] - p0[i]);
+            }
+            q.c += weight * (dot(p0, p0, n) - pe1 * pe1 - pe2 * pe2);
+        }
+
+        // plane through the position part only
+        void addPlane(Quadric& q, const double* normal, const double* point, int n, double weight)
+        {
+            double d = -dot(normal, point, 3);
+            int term = 0;
+            for (int i = 0; i < n; ++i)
+            {
+                for (int j = i; j < n; ++j)
+                {
+                    if (i < 3 && j < 3)
+                        q.a[term] += weight * normal[i] * normal[j];
+                    ++term;
+                }
+                if (i < 3)
+                    q.b[i] += weight * d * normal[i];
+            }
+            q.c += weight * d * d;
+        }
+
+        void cross(const double* a, const double* b, double* res)
+        {
+            res[0] = a[1] * b[2] - a[2] * b[1];
+            res[1] = a[2] * b[0] - a[0] * b[2];
+            res[2] = a[0] * b[1] - a[1] * b[0];
+        }
+
+        void triangleNormal(const double* p0, const double* p1, const double* p2, double* res)
+        {
+            double e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+            double e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+            cross(e1, e2, res);
+        }
+
+        struct Collapse
+        {
+            double cost;
+            uint32_t from;
+            uint32_t to;
+        };
+
+        class Simplifier
+        {
+        public:
+            Simplifier(const ModelCpu& model, const engine::vector<uint32_t>& index, const SimplifySettings& settings)
+                : m_settings{ settings }
+                , m_dimensions{ 3 }
+                , m_extent{ 1.0 }
+                , m_liveTriangles{ 0 }
+            {
+                buildVertexes(model, index);
+                buildTopology();
+                buildQuadrics();
+            }
+
+            SimplifyResult run()
+            {
+                double maxCost = std::numeric_limits<double>::max();
+                if (m_settings.targetError < std::numeric_limits<float>::max())
+                {
+                    double relative = static_cast<double>(m_settings.targetError) / m_extent;
+                    maxCost = relative * relative;
+                }
+
+                double error = 0.0;
+                engine::vector<Collapse> candidates;
+                engine::vector<uint8_t> touched;
+                while (m_liveTriangles > m_settings.targetTriangleCount)
+                {
+                    compactTriangleLists();
+
+                    // the cheapest collapse of each vertex. every half edge is in
+                    // one triangle, so each vertex sees each of its neighbours once.
+                    // open edges collapse only in their own direction
+                    for (size_t v = 0; v < m_globalVertex.size(); ++v)
+                    {
+                        if (!m_vertexAlive[v])
+                            continue;
+                        m_best[v] = Collapse{ std::numeric_limits<double>::max(), static_cast<uint32_t>(v), static_cast<uint32_t>(v) };
+                        m_selfCost[v] = evaluate(m_quadrics[v], coords(static_cast<uint32_t>(v)), m_dimensions);
+                    }
+                    for (uint32_t t = 0; t < m_triangleAlive.size(); ++t)
+                    {
+                        if (!m_triangleAlive[t])
+                            continue;
+                        for (int e = 0; e < 3; ++e)
+                            consider(m_triangles[t * 3 + e], m_triangles[t * 3 + (e + 1) % 3]);
+                    }
+
+                    candidates.clear();
+                    for (size_t v = 0; v < m_globalVertex.size(); ++v)
+                        if (m_vertexAlive[v] && m_best[v].from != m_best[v].to)
+                            candidates.emplace_back(m_best[v]);
+                    if (candidates.empty())
+                        break;
+
+                    std::sort(candidates.begin(), candidates.end(), [](const Collapse& a, const Collapse& b)
+                    {
+                        if (a.cost != b.cost) return a.cost < b.cost;
+                        if (a.from != b.from) return a.from < b.from;
+                        return a.to < b.to;
+                    });
+
+                    // a vertex takes part in one collapse per pass, so the
+                    // costs sorted above stay exact
+                    touched.assign(m_weldCount, 0);
+                    size_t collapsed = 0;
+                    for (auto&& candidate : candidates)
+                    {
+                        if (m_liveTriangles <= m_settings.targetTriangleCount || candidate.cost > maxCost)
+                            break;
+                        if (touched[m_weld[candidate.from]] || touched[m_weld[candidate.to]])
+                            continue;
+                        if (!canCollapse(candidate.from, candidate.to))
+                            continue;
+
+                        collapse(candidate.from, candidate.to);
+                        for (auto&& neighbour : m_neighbours)
+                            touched[neighbour] = 1;
+                        touched[m_weld[candidate.from]] = 1;
+                        touched[m_weld[candidate.to]] = 1;
+
+                        error = std::max(error, candidate.cost);
+                        ++collapsed;
+                    }
+                    if (collapsed == 0)
+                        break;
+                }
+
+                SimplifyResult result;
+                result.error = static_cast<float>(std::sqrt(std::max(error, 0.0)) * m_extent);
+                result.index.reserve(m_liveTriangles * 3);
+                for (uint32_t t = 0; t < m_triangleAlive.size(); ++t)
+                {
+                    if (m_triangleAlive[t])
+                    {
+                        for (int i = 0; i < 3; ++i)
+                            result.index.emplace_back(m_globalVertex[m_triangles[t * 3 + i]]);
+                    }
+                }
+                return result;
+            }
+
+        private:
+            const SimplifySettings& m_settings;
+            int m_dimensions;
+            double m_extent;
+            size_t m_liveTriangles;
+
+            // vertexes that the index uses, the simplifier works on these
+            engine::vector<uint32_t> m_globalVertex;
+            engine::vector<double> m_coords;
+            engine::vector<Quadric> m_quadrics;
+            engine::vector<uint8_t> m_locked;
+            engine::vector<uint8_t> m_vertexAlive;
+            engine::vector<Collapse> m_best;
+            engine::vector<double> m_selfCost;
+
+            // vertexes in the same position share a weld id
+            engine::vector<uint32_t> m_weld;
+            uint32_t m_weldCount;
+            engine::vector<engine::vector<uint32_t>> m_weldTriangles;
+
+            engine::vector<uint32_t> m_triangles;
+            engine::vector<uint8_t> m_triangleAlive;
+
+            // welded neighbours of the last canCollapse()
+            engine::vector<uint32_t> m_neighbours;
+            engine::vector<uint32_t> m_otherNeighbours;
+            engine::vector<uint32_t> m_opposite;
+            engine::vector<uint32_t> m_ring;
+
+            const double* coords(uint32_t vertex) const
+            {
+                return &m_coords[vertex * m_dimensions];
+            }
+
+            void buildVertexes(const ModelCpu& model, const engine::vector<uint32_t>& index)
+            {
+                ASSERT(index.size() % 3 == 0, "Invalid index count. Needs to be divisible with 3");
+
+                engine::unordered_map<uint32_t, uint32_t> localVertex;
+                engine::vector<uint32_t> triangles;
+                triangles.reserve(index.size());
+                for (auto&& vertex : index)
+                {
+                    auto found = localVertex.find(vertex);
+                    if (found == localVertex.end())
+                    {
+                        found = localVertex.emplace(vertex, static_cast<uint32_t>(m_globalVertex.size())).first;
+                        m_globalVertex.emplace_back(vertex);
+                    }
+                    triangles.emplace_back(found->second);
+                }
+
+                bool normals = m_settings.normalWeight > 0.0f && model.normal.size() == model.vertex.size();
+                bool uvs = m_settings.uvWeight > 0.0f && model.uv.size() > 0 && model.uv[0].size() == model.vertex.size();
+                m_dimensions = 3 + (normals ? 3 : 0) + (uvs ? 2 : 0);
+
+                // positions go to a unit box so the quadrics keep their precision
+                Vector3f minPos{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+                Vector3f maxPos{ std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+                for (auto&& vertex : m_globalVertex)
+                {
+                    const auto& pos = model.vertex[vertex];
+                    minPos = Vector3f{ std::min(minPos.x, pos.x), std::min(minPos.y, pos.y), std::min(minPos.z, pos.z) };
+                    maxPos = Vector3f{ std::max(maxPos.x, pos.x), std::max(maxPos.y, pos.y), std::max(maxPos.z, pos.z) };
+                }
+                m_extent = std::max(std::max(maxPos.x - minPos.x, maxPos.y - minPos.y), maxPos.z - minPos.z);
+                if (!(m_extent > 0.0))
+                    m_extent = 1.0;
+
+                double normalScale = static_cast<double>(m_settings.normalWeight) / m_extent;
+                double uvScale = static_cast<double>(m_settings.uvWeight) / m_extent;
+                m_coords.resize(m_globalVertex.size() * m_dimensions);
+                for (size_t v = 0; v < m_globalVertex.size(); ++v)
+                {
+                    auto vertex = m_globalVertex[v];
+                    double* dst = &m_coords[v * m_dimensions];
+                    *dst++ = (model.vertex[vertex].x - minPos.x) / m_extent;
+                    *dst++ = (model.vertex[vertex].y - minPos.y) / m_extent;
+                    *dst++ = (model.vertex[vertex].z - minPos.z) / m_extent;
+                    if (normals)
+                    {
+                        *dst++ = model.normal[vertex].x * normalScale;
+                        *dst++ = model.normal[vertex].y * normalScale;
+                        *dst++ = model.normal[vertex].z * normalScale;
+                    }
+                    if (uvs)
+                    {
+                        *dst++ = model.uv[0][vertex].x * uvScale;
+                        *dst++ = model.uv[0][vertex].y * uvScale;
+                    }
+                }
+
+                // weld by exact position
+                engine::vector<uint32_t> order(m_globalVertex.size());
+                for (uint32_t i = 0; i < order.size(); ++i)
+                    order[i] = i;
+                auto position = [&](uint32_t v)->const Vector3f& { return model.vertex[m_globalVertex[v]]; };
+                std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+                {
+                    const auto& pa = position(a);
+                    const auto& pb = position(b);
+                    if (pa.x != pb.x) return pa.x < pb.x;
+                    if (pa.y != pb.y) return pa.y < pb.y;
+                    if (pa.z != pb.z) return pa.z < pb.z;
+                    return a < b;
+                });
+
+                m_weld.resize(m_globalVertex.size());
+                m_locked.resize(m_globalVertex.size(), 0);
+                m_weldCount = 0;
+                for (size_t i = 0; i < order.size(); ++m_weldCount)
+                {
+                    size_t end = i + 1;
+                    while (end < order.size() && position(order[end]) == position(order[i]))
+                        ++end;
+                    for (size_t a = i; a < end; ++a)
+                    {
+                        m_weld[order[a]] = m_weldCount;
+
+                        // seam vertexes would tear the seam open if they moved
+                        if (end - i > 1)
+                            m_locked[order[a]] = 1;
+                    }
+                    i = end;
+                }
+
+                // triangles with zero area in position are left out
+                for (size_t t = 0; t < triangles.size(); t += 3)
+                {
+                    auto w0 = m_weld[triangles[t]];
+                    auto w1 = m_weld[triangles[t + 1]];
+                    auto w2 = m_weld[triangles[t + 2]];
+                    if (w0 == w1 || w1 == w2 || w2 == w0)
+                        continue;
+                    m_triangles.insert(m_triangles.end(), { triangles[t], triangles[t + 1], triangles[t + 2] });
+                }
+                m_triangleAlive.resize(m_triangles.size() / 3, 1);
+                m_liveTriangles = m_triangleAlive.size();
+            }
+
+            void buildTopology()
+            {
+                m_weldTriangles.resize(m_weldCount);
+                for (uint32_t t = 0; t < m_triangleAlive.size(); ++t)
+                    for (int i = 0; i < 3; ++i)
+                        m_weldTriangles[m_weld[m_triangles[t * 3 + i]]].emplace_back(t);
+            }
+
+            uint64_t edgeKey(uint32_t a, uint32_t b) const
+            {
+                auto wa = m_weld[a];
+                auto wb = m_weld[b];
+                return wa < wb ?
+                    (static_cast<uint64_t>(wa) << 32) | wb :
+                    (static_cast<uint64_t>(wb) << 32) | wa;
+            }
+
+            void buildQuadrics()
+            {
+                m_quadrics.resize(m_globalVertex.size());
+                m_vertexAlive.resize(m_globalVertex.size(), 1);
+                m_best.resize(m_globalVertex.size());
+                m_selfCost.resize(m_globalVertex.size());
+                for (auto&& q : m_quadrics)
+                    clear(q);
+
+                for (uint32_t t = 0; t < m_triangleAlive.size(); ++t)
+                {
+                    auto v0 = m_triangles[t * 3];
+                    auto v1 = m_triangles[t * 3 + 1];
+                    auto v2 = m_triangles[t * 3 + 2];
+
+                    double normal[3];
+                    triangleNormal(coords(v0), coords(v1), coords(v2), normal);
+                    double area = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]) * 0.5;
+
+                    Quadric q;
+                    clear(q);
+                    addTriangle(q, coords(v0), coords(v1), coords(v2), m_dimensions, area);
+                    add(m_quadrics[v0], q);
+                    add(m_quadrics[v1], q);
+                    add(m_quadrics[v2], q);
+                }
+
+                // edges that only one triangle uses are open. more than two is
+                // non-manifold and those never move
+                engine::vector<std::pair<uint64_t, uint32_t>> edges;
+                edges.reserve(m_triangles.size());
+                for (uint32_t t = 0; t < m_triangleAlive.size(); ++t)
+                    for (int e = 0; e < 3; ++e)
+                        edges.emplace_back(edgeKey(m_triangles[t * 3 + e], m_triangles[t * 3 + (e + 1) % 3]), t * 3 + e);
+                std::sort(edges.begin(), edges.end());
+
+                for (size_t i = 0; i < edges.size();)
+                {
+                    size_t end = i + 1;
+                    while (end < edges.size() && edges[end].first == edges[i].first)
+                        ++end;
+
+                    auto corner = edges[i].second;
+                    auto t = corner / 3;
+                    auto a = m_triangles[corner];
+                    auto b = m_triangles[t * 3 + (corner % 3 + 1) % 3];
+                    if (end - i > 2 || (end - i == 1 && m_settings.lockBorder))
+                    {
+                        m_locked[a] = 1;
+                        m_locked[b] = 1;
+                    }
+                    else if (end - i == 1)
+                    {
+                        // plane along the open edge, perpendicular to the triangle
+                        auto c = m_triangles[t * 3 + (corner % 3 + 2) % 3];
+                        double normal[3];
+                        triangleNormal(coords(a), coords(b), coords(c), normal);
+                        double edge[3] = { coords(b)[0] - coords(a)[0], coords(b)[1] - coords(a)[1], coords(b)[2] - coords(a)[2] };
+                        double plane[3];
+                        cross(edge, normal, plane);
+                        double len = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+                        if (len > 0.0)
+                        {
+                            for (auto&& p : plane)
+                                p /= len;
+                            Quadric q;
+                            clear(q);
+                            addPlane(q, plane, coords(a), m_dimensions, BorderWeight * dot(edge, edge, 3));
+                            add(m_quadrics[a], q);
+                            add(m_quadrics[b], q);
+                        }
+                    }
+                    i = end;
+                }
+            }
+
+            // error of the merged quadric at the target vertex
+            void consider(uint32_t from, uint32_t to)
+            {
+                if (m_locked[from])
+                    return;
+                auto cost = std::max(evaluate(m_quadrics[from], coords(to), m_dimensions) + m_selfCost[to], 0.0);
+                if (cost < m_best[from].cost)
+                    m_best[from] = Collapse{ cost, from, to };
+            }
+
+            bool hasWeld(uint32_t triangle, uint32_t weld) const
+            {
+                return
+                    m_weld[m_triangles[triangle * 3]] == weld ||
+                    m_weld[m_triangles[triangle * 3 + 1]] == weld ||
+                    m_weld[m_triangles[triangle * 3 + 2]] == weld;
+            }
+
+            void neighbours(uint32_t weld, engine::vector<uint32_t>& result) const
+            {
+                result.clear();
+                for (auto&& t : m_weldTriangles[weld])
+                {
+                    if (!m_triangleAlive[t])
+                        continue;
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        auto w = m_weld[m_triangles[t * 3 + i]];
+                        if (w != weld)
+                            result.emplace_back(w);
+                    }
+                }
+                std::sort(result.begin(), result.end());
+                result.erase(std::unique(result.begin(), result.end()), result.end());
+            }
+
+            // every edge inside the surface is in two triangles around the vertex
+            bool onBorder(uint32_t weld)
+            {
+                m_ring.clear();
+                for (auto&& t : m_weldTriangles[weld])
+                {
+                    if (!m_triangleAlive[t])
+                        continue;
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        auto w = m_weld[m_triangles[t * 3 + i]];
+                        if (w != weld)
+                            m_ring.emplace_back(w);
+                    }
+                }
+                std::sort(m_ring.begin(), m_ring.end());
+                for (size_t i = 0; i < m_ring.size();)
+                {
+                    size_t end = i + 1;
+                    while (end < m_ring.size() && m_ring[end] == m_ring[i])
+                        ++end;
+                    if (end - i == 1)
+                        return true;
+                    i = end;
+                }
+                return false;
+            }
+
+            bool canCollapse(uint32_t from, uint32_t to)
+            {
+                auto w0 = m_weld[from];
+                auto w1 = m_weld[to];
+
+                // link condition. the only vertexes both ends see are the
+                // ones opposite of the edge, otherwise the collapse would
+                // pinch the surface or close a hole
+                m_opposite.clear();
+                size_t fromTriangles = 0;
+                size_t sharedTriangles = 0;
+                for (auto&& t : m_weldTriangles[w0])
+                {
+                    if (!m_triangleAlive[t])
+                        continue;
+                    ++fromTriangles;
+                    if (!hasWeld(t, w1))
+                        continue;
+                    ++sharedTriangles;
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        auto w = m_weld[m_triangles[t * 3 + i]];
+                        if (w != w0 && w != w1)
+                            m_opposite.emplace_back(w);
+                    }
+                }
+                if (m_opposite.empty())
+                    return false;
+
+                // the last triangles of a separate piece stay
+                if (fromTriangles == sharedTriangles)
+                {
+                    size_t toTriangles = 0;
+                    for (auto&& t : m_weldTriangles[w1])
+                        toTriangles += m_triangleAlive[t];
+                    if (toTriangles == sharedTriangles)
+                        return false;
+                }
+                std::sort(m_opposite.begin(), m_opposite.end());
+                m_opposite.erase(std::unique(m_opposite.begin(), m_opposite.end()), m_opposite.end());
+
+                neighbours(w0, m_neighbours);
+                neighbours(w1, m_otherNeighbours);
+                size_t common = 0;
+                for (size_t a = 0, b = 0; a < m_neighbours.size() && b < m_otherNeighbours.size();)
+                {
+                    if (m_neighbours[a] < m_otherNeighbours[b]) ++a;
+                    else if (m_neighbours[a] > m_otherNeighbours[b]) ++b;
+                    else
+                    {
+                        if (m_neighbours[a] != w1)
+                            ++common;
+                        ++a;
+                        ++b;
+                    }
+                }
+                if (common != m_opposite.size())
+                    return false;
+
+                // the open edges count as connected to one more vertex outside.
+                // two open vertexes can only collapse along an open edge
+                bool toBorder = onBorder(w1);
+                if (!m_settings.lockBorder && onBorder(w0) && toBorder && m_opposite.size() > 1)
+                    return false;
+
+                // with the border locked the index is a part of a mesh. the edge
+                // between two border vertexes could already be in the rest of
+                // the mesh, so the collapse may not create one
+                if (m_settings.lockBorder && toBorder)
+                {
+                    for (auto&& neighbour : m_neighbours)
+                    {
+                        if (neighbour != w1 &&
+                            !std::binary_search(m_otherNeighbours.begin(), m_otherNeighbours.end(), neighbour) &&
+                            onBorder(neighbour))
+                            return false;
+                    }
+                }
+
+                // the triangles that stay may not flip or fold
+                for (auto&& t : m_weldTriangles[w0])
+                {
+                    if (!m_triangleAlive[t] || hasWeld(t, w1))
+                        continue;
+
+                    const double* before[3];
+                    const double* after[3];
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        auto v = m_triangles[t * 3 + i];
+                        before[i] = coords(v);
+                        after[i] = v == from ? coords(to) : coords(v);
+                    }
+                    double nb[3];
+                    double na[3];
+                    triangleNormal(before[0], before[1], before[2], nb);
+                    triangleNormal(after[0], after[1], after[2], na);
+                    double lengths = std::sqrt(dot(nb, nb, 3) * dot(na, na, 3));
+                    if (!(lengths > 0.0) || dot(nb, na, 3) < MinNormalCosine * lengths)
+                        return false;
+                }
+                return true;
+            }
+
+            void collapse(uint32_t from, uint32_t to)
+            {
+                auto w0 = m_weld[from];
+                auto w1 = m_weld[to];
+                for (auto&& t : m_weldTriangles[w0])
+                {
+                    if (!m_triangleAlive[t])
+                        continue;
+                    bool degenerate = hasWeld(t, w1);
+                    for (int i = 0; i < 3; ++i)
+                        if (m_triangles[t * 3 + i] == from)
+                            m_triangles[t * 3 + i] = to;
+
+                    if (degenerate)
+                    {
+                        m_triangleAlive[t] = 0;
+                        --m_liveTriangles;
+                    }
+                    else
+                        m_weldTriangles[w1].emplace_back(t);
+                }
+                m_weldTriangles[w0].clear();
+                m_vertexAlive[from] = 0;
+                add(m_quadrics[to], m_quadrics[from]);
+            }
+
+            void compactTriangleLists()
+            {
+                for (auto&& triangles : m_weldTriangles)
+                {
+                    triangles.erase(std::remove_if(triangles.begin(), triangles.end(), [&](uint32_t t)
+                    {
+                        return !m_triangleAlive[t];
+                    }), triangles.end());
+                }
+            }
+        };
+    }
+
+    SimplifyResult meshSimplify(const ModelCpu& model, const engine::vector<uint32_t>& index, const SimplifySettings& settings)
+    {
+        Simplifier simplifier(model, index, settings);
+        return simplifier.run();
+    }
+}
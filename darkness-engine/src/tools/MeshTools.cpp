@@ -1921,7 +1921,8 @@ namespace engine
         f = f * 2.0f - 1.0f;
         Vector3f n = Vector3f(f.x, f.y, 1.0f - abs(f.x) - abs(f.y));
         float t = std::min(1.0f, std::max(0.0f, (-n.z)));
-        n.xy(n.xy() + (n.xy() >= 0.0f ? -t : t));
+        n.x += n.x >= 0.0f ? -t : t;
+        n.y += n.y >= 0.0f ? -t : t;
         return n.normalize();
     };
 }
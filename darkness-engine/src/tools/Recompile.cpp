@@ -85,9 +85,10 @@ namespace engine
             return engine::pathReplaceExtension(binaryPath, "syntax_support");
         };
 
+        // the stage we're reloading is compiled before the rest of its pipeline
         std::wstring wideParams = toWideString(
             support.executable + " -log=recompile -input=" +
-            support.sourceFile);
+            support.sourceFile + " -priority=" + support.sourceFile);
         auto wideRoot = toWideString(engine::pathExtractFolder(support.rootPath));
 
         //auto temp = toUtf8String(wideParams);
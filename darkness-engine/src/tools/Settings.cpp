@@ -1,5 +1,7 @@
 #include "tools/Settings.h"
 #include "tools/Debug.h"
+#include "tools/hash/Hash.h"
+#include "platform/File.h"
 #include "containers/unordered_map.h"
 #include <algorithm>
 #include <fstream>
@@ -19,312 +21,561 @@ namespace tools
 {
     namespace implementation
     {
-        SettingsContainer::SettingsContainer(const string& groupName)
-            : m_parent{ nullptr }
-            , m_groupName{ groupName }
-        {}
-
-        engine::vector<string> SettingsContainer::keys() const
+        namespace
         {
-			engine::vector<string> res;
-            for (auto&& keyValPair : m_ints) { res.emplace_back(keyValPair.first); }
-            for (auto&& keyValPair : m_intVectors) { res.emplace_back(keyValPair.first); }
-            for (auto&& keyValPair : m_floats) { res.emplace_back(keyValPair.first); }
-            for (auto&& keyValPair : m_floatVectors) { res.emplace_back(keyValPair.first); }
-            for (auto&& keyValPair : m_strings) { res.emplace_back(keyValPair.first); }
-            for (auto&& keyValPair : m_stringVectors) { res.emplace_back(keyValPair.first); }
-            return res;
-        }
+            constexpr uint32_t SettingsFileMagic = 0x54455344; // DSET
+            constexpr uint32_t SettingsFileVersion = 1;
+            constexpr size_t SettingsValueAlignment = 8;
 
-		engine::vector<string> SettingsContainer::groups() const
-        {
-			engine::vector<string> res;
-            for (auto&& child : m_childs) { res.emplace_back(child.second->m_groupName); }
-            return res;
-        }
+            struct SettingsFileHeader
+            {
+                uint32_t magic;
+                uint32_t version;
+                uint32_t groupCount;
+                uint32_t entryCount;
+                uint64_t groupsOffset;
+                uint64_t entriesOffset;
+                uint64_t keysOffset;
+                uint64_t keysBytes;
+                uint64_t dataOffset;
+                uint64_t dataBytes;
+            };
+
+            // groups are stored breadth first so the children of a group are
+            // next to each other. key and data offsets are from the start of
+            // the key and data blocks of the file
+            struct SettingsFileGroup
+            {
+                uint32_t parent;
+                uint32_t firstChild;
+                uint32_t childCount;
+                uint32_t firstEntry;
+                uint32_t entryCount;
+                uint32_t nameLength;
+                uint64_t nameOffset;
+                uint64_t keysOffset;
+                uint64_t keysBytes;
+                uint64_t dataOffset;
+                uint64_t dataBytes;
+            };
+
+            static_assert(sizeof(SettingEntry) == 32, "SettingEntry is part of the binary settings file");
+            static_assert(sizeof(SettingsFileHeader) == 64, "SettingsFileHeader changed size");
+            static_assert(sizeof(SettingsFileGroup) == 64, "SettingsFileGroup changed size");
+
+            const char* SettingTypeNames[] =
+            {
+                "bool", "char", "short", "int", "int64", "uchar", "ushort", "uint", "uint64", "float", "double", "string",
+                "vector_bool", "vector_char", "vector_short", "vector_int", "vector_int64", "vector_uchar",
+                "vector_ushort", "vector_uint", "vector_uint64", "vector_float", "vector_double", "vector_string"
+            };
+            static_assert(sizeof(SettingTypeNames) / sizeof(SettingTypeNames[0]) == static_cast<size_t>(SettingType::Count), "SettingTypeNames is missing a type");
 
-        void SettingsContainer::readJson(void* _obj)
-        {
-            rapidjson::Value& doc = *static_cast<rapidjson::Value*>(_obj);
-            if (!doc.IsObject())
+            size_t alignValue(size_t bytes)
             {
-                LOG("Settings container was malformed");
-                return;
+                return (bytes + SettingsValueAlignment - 1) & ~(SettingsValueAlignment - 1);
             }
 
-            if (doc.HasMember("groupName") && doc["groupName"].IsString())
+            uint64_t keyHash(const string& key)
             {
-                m_groupName = string(doc["groupName"].GetString(), doc["groupName"].GetStringLength());
+                return static_cast<uint64_t>(tools::hash(reinterpret_cast<const uint8_t*>(key.data()), static_cast<unsigned int>(key.size())));
+            }
+
+            int compareKey(const char* keys, const SettingEntry& entry, const string& key)
+            {
+                auto res = memcmp(keys + entry.keyOffset, key.data(), std::min(static_cast<size_t>(entry.keyLength), key.size()));
+                if (res != 0)
+                    return res;
+                if (entry.keyLength == key.size())
+                    return 0;
+                return entry.keyLength < key.size() ? -1 : 1;
             }
 
-            for (auto member = doc.MemberBegin(); member != doc.MemberEnd(); ++member)
+            // how the values are laid out in the data block
+            template<typename T>
+            struct SettingCodec
+            {
+                static uint32_t size(const T&) { return sizeof(T); }
+                static bool validSize(uint32_t size) { return size == sizeof(T); }
+                static void write(uint8_t* dst, const T& value) { memcpy(dst, &value, sizeof(T)); }
+                static T read(const uint8_t* src, uint32_t) { T value; memcpy(&value, src, sizeof(T)); return value; }
+            };
+
+            template<>
+            struct SettingCodec<bool>
+            {
+                static uint32_t size(const bool&) { return 1; }
+                static bool validSize(uint32_t size) { return size == 1; }
+                static void write(uint8_t* dst, const bool& value) { *dst = value ? 1 : 0; }
+                static bool read(const uint8_t* src, uint32_t) { return *src != 0; }
+            };
+
+            template<>
+            struct SettingCodec<string>
+            {
+                static uint32_t size(const string& value) { return static_cast<uint32_t>(value.size()); }
+                static bool validSize(uint32_t) { return true; }
+                static void write(uint8_t* dst, const string& value) { if (value.size()) memcpy(dst, value.data(), value.size()); }
+                static string read(const uint8_t* src, uint32_t size) { return string(reinterpret_cast<const char*>(src), size); }
+            };
+
+            template<typename T>
+            struct SettingCodec<engine::vector<T>>
             {
-                engine::string name(member->name.GetString(), member->name.GetStringLength());
-                if (name != "groupName" &&
-                    name != "childs")
+                static uint32_t size(const engine::vector<T>& value) { return static_cast<uint32_t>(value.size() * sizeof(T)); }
+                static bool validSize(uint32_t size) { return size % sizeof(T) == 0; }
+                static void write(uint8_t* dst, const engine::vector<T>& value) { if (value.size()) memcpy(dst, value.data(), value.size() * sizeof(T)); }
+                static engine::vector<T> read(const uint8_t* src, uint32_t size)
                 {
-                    const Value& list = doc[name.data()];
-                    for (SizeType i = 0; i < list.Size(); ++i)
-                    {
-                        auto obj = list[i].GetObject();
-                        for (auto objmember = obj.MemberBegin(); objmember != obj.MemberEnd(); ++objmember)
-                        {
-                            auto memberName = engine::string(objmember->name.GetString(), objmember->name.GetStringLength());
-                            if (name == "bool") m_bools[memberName] = static_cast<bool>(objmember->value.GetBool());
-                            if (name == "char") m_chars[memberName] = static_cast<char>(objmember->value.GetInt());
-                            if (name == "short") m_shorts[memberName] = static_cast<short>(objmember->value.GetInt());
-                            if (name == "int") m_ints[memberName] = objmember->value.GetInt();
-                            if (name == "int64") m_bigints[memberName] = objmember->value.GetInt64();
-                            if (name == "uchar") m_uchars[memberName] = static_cast<unsigned char>(objmember->value.GetUint());
-                            if (name == "ushort") m_ushorts[memberName] = static_cast<unsigned short>(objmember->value.GetUint());
-                            if (name == "uint") m_uints[memberName] = objmember->value.GetUint();
-                            if (name == "uint64") m_biguints[memberName] = objmember->value.GetUint64();
-                            if (name == "float") m_floats[memberName] = objmember->value.GetFloat();
-                            if (name == "double") m_doubles[memberName] = objmember->value.GetDouble();
-                            if (name == "string") { m_strings[memberName] = engine::string(objmember->value.GetString(), objmember->value.GetStringLength()); }
-                        }
-                    }
+                    engine::vector<T> res(size / sizeof(T));
+                    if (res.size())
+                        memcpy(res.data(), src, res.size() * sizeof(T));
+                    return res;
                 }
-            }
+            };
 
-            for (auto member = doc.MemberBegin(); member != doc.MemberEnd(); ++member)
+            template<>
+            struct SettingCodec<engine::vector<bool>>
             {
-                engine::string name(member->name.GetString(), member->name.GetStringLength());
-                if (name != "groupName" &&
-                    name != "childs")
+                static uint32_t size(const engine::vector<bool>& value) { return static_cast<uint32_t>(value.size()); }
+                static bool validSize(uint32_t) { return true; }
+                static void write(uint8_t* dst, const engine::vector<bool>& value) { for (auto&& v : value) { *dst++ = v ? 1 : 0; } }
+                static engine::vector<bool> read(const uint8_t* src, uint32_t size)
                 {
-                    const Value& list = doc[name.data()];
-                    for (SizeType i = 0; i < list.Size(); ++i)
-                    {
-                        auto obj = list[i].GetObject();
-                        for (auto objmember = obj.MemberBegin(); objmember != obj.MemberEnd(); ++objmember)
-                        {
-                            if (objmember->value.IsArray())
-                            {
-                                auto memberName = engine::string(objmember->name.GetString(), objmember->name.GetStringLength());
-                                auto arr = objmember->value.GetArray();
-                                if (name == "vector_bool") { engine::vector<bool> cur;                for (SizeType a = 0; a < arr.Size(); ++a) { cur.emplace_back(arr[a].GetBool()); } m_boolVectors[memberName] = cur; }
-                                if (name == "vector_char") { engine::vector<char> cur;                for (SizeType a = 0; a < arr.Size(); ++a) { cur.emplace_back(static_cast<char>(arr[a].GetInt())); } m_charVectors[memberName] = cur; }
-                                if (name == "vector_short") { engine::vector<short> cur;            for (SizeType a = 0; a < arr.Size(); ++a) { cur.emplace_back(static_cast<short>(arr[a].GetInt())); } m_shortVectors[memberName] = cur; }
-                                if (name == "vector_int") { engine::vector<int> cur;                for (SizeType a = 0; a < arr.Size(); ++a) { cur.emplace_back(arr[a].GetInt()); } m_intVectors[memberName] = cur; }
-                                if (name == "vector_int64") { engine::vector<int64_t> cur;            for (SizeType a = 0; a < arr.Size(); ++a) { cur.emplace_back(arr[a].GetInt64()); } m_bigintVectors[memberName] = cur; }
-                                if (name == "vector_uchar") { engine::vector<unsigned char> cur;    for (SizeType a = 0; a < arr.Size(); ++a) { cur.emplace_back(static_cast<unsigned char>(arr[a].GetUint())); } m_ucharVectors[memberName] = cur; }
-                                if (name == "vector_ushort") { engine::vector<unsigned short> cur;    for (SizeType a = 0; a < arr.Size(); ++a) { cur.emplace_back(static_cast<unsigned short>(arr[a].GetUint())); } m_ushortVectors[memberName] = cur; }
-                                if (name == "vector_uint") { engine::vector<unsigned int> cur;        for (SizeType a = 0; a < arr.Size(); ++a) { cur.emplace_back(arr[a].GetUint()); } m_uintVectors[memberName] = cur; }
-                                if (name == "vector_uint64") { engine::vector<uint64_t> cur;            for (SizeType a = 0; a < arr.Size(); ++a) { cur.emplace_back(arr[a].GetUint64()); } m_biguintVectors[memberName] = cur; }
-                                if (name == "vector_float") { engine::vector<float> cur;            for (SizeType a = 0; a < arr.Size(); ++a) { cur.emplace_back(arr[a].GetFloat()); } m_floatVectors[memberName] = cur; }
-                                if (name == "vector_double") { engine::vector<double> cur;            for (SizeType a = 0; a < arr.Size(); ++a) { cur.emplace_back(arr[a].GetDouble()); } m_doubleVectors[memberName] = cur; }
-                                if (name == "vector_string") { engine::vector<engine::string> cur;        for (SizeType a = 0; a < arr.Size(); ++a) { cur.emplace_back(engine::string(arr[a].GetString(), arr[a].GetStringLength())); } m_stringVectors[memberName] = cur; }
-                            }
-                        }
-                    }
+                    engine::vector<bool> res(size);
+                    for (uint32_t i = 0; i < size; ++i) { res[i] = src[i] != 0; }
+                    return res;
                 }
-            }
+            };
 
-            if (doc.HasMember("childs"))
+            // [uint32 length][characters] for every string
+            template<>
+            struct SettingCodec<engine::vector<string>>
             {
-                const Value& list = doc["childs"];
-                for (SizeType i = 0; i < list.Size(); ++i)
+                static uint32_t size(const engine::vector<string>& value)
                 {
-                    if (list[i].HasMember("groupName") && list[i]["groupName"].IsString())
+                    size_t bytes = 0;
+                    for (auto&& v : value) { bytes += sizeof(uint32_t) + v.size(); }
+                    return static_cast<uint32_t>(bytes);
+                }
+                static bool validSize(uint32_t) { return true; }
+                static void write(uint8_t* dst, const engine::vector<string>& value)
+                {
+                    for (auto&& v : value)
                     {
-                        auto groupName = string(list[i]["groupName"].GetString(),
-                                                     list[i]["groupName"].GetStringLength());
-                        m_childs[groupName] = engine::make_shared<SettingsContainer>(groupName);
-                        m_childs[groupName]->m_parent = shared_from_this();
-                        m_childs[groupName]->readJson(&const_cast<Value&>(list[i]));
+                        uint32_t length = static_cast<uint32_t>(v.size());
+                        memcpy(dst, &length, sizeof(uint32_t));
+                        dst += sizeof(uint32_t);
+                        if (length)
+                            memcpy(dst, v.data(), length);
+                        dst += length;
                     }
                 }
-            }
-        }
-
-        void SettingsContainer::writeJson(void* _writer)
-        {
-            rapidjson::PrettyWriter<rapidjson::StringBuffer>& writer = *static_cast<rapidjson::PrettyWriter<rapidjson::StringBuffer>*>(_writer);
-            writer.StartObject();
-
-            writer.Key("groupName");
-            writer.String(m_groupName.data());
-
-            if (m_bools.size() > 0)     { writer.Key("bool");    writer.StartArray(); for (auto&& value : m_bools)   { writer.StartObject(); writer.Key(value.first.data()); writer.Bool(value.second); writer.EndObject(); } writer.EndArray(); }
-            if (m_chars.size() > 0)        { writer.Key("char");    writer.StartArray(); for (auto&& value : m_chars)    { writer.StartObject(); writer.Key(value.first.data()); writer.Int(value.second); writer.EndObject(); } writer.EndArray(); }
-            if (m_shorts.size() > 0)    { writer.Key("short");    writer.StartArray(); for (auto&& value : m_shorts)    { writer.StartObject(); writer.Key(value.first.data()); writer.Int(value.second); writer.EndObject(); } writer.EndArray(); }
-            if (m_ints.size() > 0)        { writer.Key("int");    writer.StartArray(); for (auto&& value : m_ints)    { writer.StartObject(); writer.Key(value.first.data()); writer.Int(value.second); writer.EndObject(); } writer.EndArray(); }
-            if (m_bigints.size() > 0)    { writer.Key("int64");    writer.StartArray(); for (auto&& value : m_bigints)    { writer.StartObject(); writer.Key(value.first.data()); writer.Int64(value.second); writer.EndObject(); } writer.EndArray(); }
-            if (m_uchars.size() > 0)    { writer.Key("uchar");    writer.StartArray(); for (auto&& value : m_uchars)    { writer.StartObject(); writer.Key(value.first.data()); writer.Uint(value.second); writer.EndObject(); } writer.EndArray(); }
-            if (m_ushorts.size() > 0)    { writer.Key("ushort"); writer.StartArray(); for (auto&& value : m_ushorts) { writer.StartObject(); writer.Key(value.first.data()); writer.Uint(value.second); writer.EndObject(); } writer.EndArray(); }
-            if (m_uints.size() > 0)        { writer.Key("uint");    writer.StartArray(); for (auto&& value : m_uints)    { writer.StartObject(); writer.Key(value.first.data()); writer.Uint(value.second); writer.EndObject(); } writer.EndArray(); }
-            if (m_biguints.size() > 0)    { writer.Key("uint64");    writer.StartArray(); for (auto&& value : m_biguints){ writer.StartObject(); writer.Key(value.first.data()); writer.Uint64(value.second); writer.EndObject(); } writer.EndArray(); }
-            if (m_floats.size() > 0)    { writer.Key("float");    writer.StartArray(); for (auto&& value : m_floats)    { writer.StartObject(); writer.Key(value.first.data()); writer.Double(value.second); writer.EndObject(); } writer.EndArray(); }
-            if (m_doubles.size() > 0)    { writer.Key("double"); writer.StartArray(); for (auto&& value : m_doubles) { writer.StartObject(); writer.Key(value.first.data()); writer.Double(value.second); writer.EndObject(); } writer.EndArray(); }
-            if (m_strings.size() > 0)    { writer.Key("string"); writer.StartArray(); for (auto&& value : m_strings) { writer.StartObject(); writer.Key(value.first.data()); writer.String(value.second.data()); writer.EndObject(); } writer.EndArray(); }
-
-            if (m_boolVectors.size() > 0)
-            {
-                writer.Key("vector_bool"); writer.StartArray();
-                for (auto&& vec : m_boolVectors)
+                static engine::vector<string> read(const uint8_t* src, uint32_t size)
                 {
-                    writer.StartObject(); writer.Key(vec.first.data());
-                    writer.StartArray();
-                    for (auto&& value : vec.second) { writer.Bool(value); }
-                    writer.EndArray();
-                    writer.EndObject();
+                    engine::vector<string> res;
+                    const uint8_t* end = src + size;
+                    while (static_cast<size_t>(end - src) >= sizeof(uint32_t))
+                    {
+                        uint32_t length;
+                        memcpy(&length, src, sizeof(uint32_t));
+                        src += sizeof(uint32_t);
+                        length = std::min(length, static_cast<uint32_t>(end - src));
+                        res.emplace_back(string(reinterpret_cast<const char*>(src), length));
+                        src += length;
+                    }
+                    return res;
                 }
-                writer.EndArray();
-            }
+            };
+
+            template<typename T>
+            struct SettingTag
+            {
+                using type = T;
+            };
 
-            if (m_charVectors.size() > 0)
+            template<typename Func>
+            void visitSettingType(SettingType type, Func&& func)
             {
-                writer.Key("vector_char"); writer.StartArray();
-                for (auto&& vec : m_charVectors)
+                switch (type)
                 {
-                    writer.StartObject(); writer.Key(vec.first.data());
-                    writer.StartArray();
-                    for (auto&& value : vec.second) { writer.Int(value); }
-                    writer.EndArray(); 
-                    writer.EndObject();
+                case SettingType::Bool: { func(SettingTag<bool>()); break; }
+                case SettingType::Char: { func(SettingTag<char>()); break; }
+                case SettingType::Short: { func(SettingTag<short>()); break; }
+                case SettingType::Int: { func(SettingTag<int>()); break; }
+                case SettingType::Int64: { func(SettingTag<int64_t>()); break; }
+                case SettingType::UChar: { func(SettingTag<unsigned char>()); break; }
+                case SettingType::UShort: { func(SettingTag<unsigned short>()); break; }
+                case SettingType::UInt: { func(SettingTag<unsigned int>()); break; }
+                case SettingType::UInt64: { func(SettingTag<uint64_t>()); break; }
+                case SettingType::Float: { func(SettingTag<float>()); break; }
+                case SettingType::Double: { func(SettingTag<double>()); break; }
+                case SettingType::String: { func(SettingTag<string>()); break; }
+                case SettingType::BoolVector: { func(SettingTag<engine::vector<bool>>()); break; }
+                case SettingType::CharVector: { func(SettingTag<engine::vector<char>>()); break; }
+                case SettingType::ShortVector: { func(SettingTag<engine::vector<short>>()); break; }
+                case SettingType::IntVector: { func(SettingTag<engine::vector<int>>()); break; }
+                case SettingType::Int64Vector: { func(SettingTag<engine::vector<int64_t>>()); break; }
+                case SettingType::UCharVector: { func(SettingTag<engine::vector<unsigned char>>()); break; }
+                case SettingType::UShortVector: { func(SettingTag<engine::vector<unsigned short>>()); break; }
+                case SettingType::UIntVector: { func(SettingTag<engine::vector<unsigned int>>()); break; }
+                case SettingType::UInt64Vector: { func(SettingTag<engine::vector<uint64_t>>()); break; }
+                case SettingType::FloatVector: { func(SettingTag<engine::vector<float>>()); break; }
+                case SettingType::DoubleVector: { func(SettingTag<engine::vector<double>>()); break; }
+                case SettingType::StringVector: { func(SettingTag<engine::vector<string>>()); break; }
+                default: ASSERT(false, "Settings did not handle setting type");
                 }
-                writer.EndArray();
             }
 
-            if (m_shortVectors.size() > 0)
+            using JsonWriter = rapidjson::PrettyWriter<rapidjson::StringBuffer>;
+
+            void writeJsonValue(JsonWriter& writer, bool value) { writer.Bool(value); }
+            void writeJsonValue(JsonWriter& writer, char value) { writer.Int(value); }
+            void writeJsonValue(JsonWriter& writer, short value) { writer.Int(value); }
+            void writeJsonValue(JsonWriter& writer, int value) { writer.Int(value); }
+            void writeJsonValue(JsonWriter& writer, int64_t value) { writer.Int64(value); }
+            void writeJsonValue(JsonWriter& writer, unsigned char value) { writer.Uint(value); }
+            void writeJsonValue(JsonWriter& writer, unsigned short value) { writer.Uint(value); }
+            void writeJsonValue(JsonWriter& writer, unsigned int value) { writer.Uint(value); }
+            void writeJsonValue(JsonWriter& writer, uint64_t value) { writer.Uint64(value); }
+            void writeJsonValue(JsonWriter& writer, float value) { writer.Double(value); }
+            void writeJsonValue(JsonWriter& writer, double value) { writer.Double(value); }
+            void writeJsonValue(JsonWriter& writer, const string& value) { writer.String(value.data(), static_cast<SizeType>(value.size())); }
+
+            template<typename T>
+            void writeJsonValue(JsonWriter& writer, const engine::vector<T>& value)
             {
-                writer.Key("vector_short"); writer.StartArray();
-                for (auto&& vec : m_shortVectors)
-                {
-                    writer.StartObject(); writer.Key(vec.first.data());
-                    writer.StartArray();
-                    for (auto&& value : vec.second) { writer.Int(value); }
-                    writer.EndArray();
-                    writer.EndObject();
-                }
+                writer.StartArray();
+                for (auto&& v : value) { writeJsonValue(writer, static_cast<T>(v)); }
                 writer.EndArray();
             }
 
-            if (m_intVectors.size() > 0)
+            bool readJsonValue(const Value& value, bool& res) { if (!value.IsBool()) return false; res = value.GetBool(); return true; }
+            bool readJsonValue(const Value& value, char& res) { if (!value.IsInt()) return false; res = static_cast<char>(value.GetInt()); return true; }
+            bool readJsonValue(const Value& value, short& res) { if (!value.IsInt()) return false; res = static_cast<short>(value.GetInt()); return true; }
+            bool readJsonValue(const Value& value, int& res) { if (!value.IsInt()) return false; res = value.GetInt(); return true; }
+            bool readJsonValue(const Value& value, int64_t& res) { if (!value.IsInt64()) return false; res = value.GetInt64(); return true; }
+            bool readJsonValue(const Value& value, unsigned char& res) { if (!value.IsUint()) return false; res = static_cast<unsigned char>(value.GetUint()); return true; }
+            bool readJsonValue(const Value& value, unsigned short& res) { if (!value.IsUint()) return false; res = static_cast<unsigned short>(value.GetUint()); return true; }
+            bool readJsonValue(const Value& value, unsigned int& res) { if (!value.IsUint()) return false; res = value.GetUint(); return true; }
+            bool readJsonValue(const Value& value, uint64_t& res) { if (!value.IsUint64()) return false; res = value.GetUint64(); return true; }
+            bool readJsonValue(const Value& value, float& res) { if (!value.IsNumber()) return false; res = value.GetFloat(); return true; }
+            bool readJsonValue(const Value& value, double& res) { if (!value.IsNumber()) return false; res = value.GetDouble(); return true; }
+            bool readJsonValue(const Value& value, string& res) { if (!value.IsString()) return false; res = string(value.GetString(), value.GetStringLength()); return true; }
+
+            template<typename T>
+            bool readJsonValue(const Value& value, engine::vector<T>& res)
             {
-                writer.Key("vector_int"); writer.StartArray();
-                for (auto&& vec : m_intVectors)
+                if (!value.IsArray())
+                    return false;
+                auto arr = value.GetArray();
+                for (SizeType a = 0; a < arr.Size(); ++a)
                 {
-                    writer.StartObject(); writer.Key(vec.first.data());
-                    writer.StartArray();
-                    for (auto&& value : vec.second) { writer.Int(value); }
-                    writer.EndArray();
-                    writer.EndObject();
+                    T v{};
+                    if (readJsonValue(arr[a], v))
+                        res.emplace_back(v);
                 }
-                writer.EndArray();
+                return true;
             }
+        }
+
+        SettingsContainer::SettingsContainer(const string& groupName)
+            : m_parent{ nullptr }
+            , m_groupName{ groupName }
+            , m_entries{ nullptr }
+            , m_entryCount{ 0 }
+            , m_keys{ nullptr }
+            , m_keyBytes{ 0 }
+            , m_data{ nullptr }
+            , m_dataBytes{ 0 }
+            , m_file{ nullptr }
+            , m_changed{ false }
+        {}
+
+        engine::vector<string> SettingsContainer::keys() const
+        {
+            engine::vector<string> res;
+            for (size_t i = 0; i < m_entryCount; ++i)
+                res.emplace_back(string(m_keys + m_entries[i].keyOffset, m_entries[i].keyLength));
+            return res;
+        }
+
+        engine::vector<string> SettingsContainer::groups() const
+        {
+            engine::vector<string> res;
+            for (auto&& child : m_childs) { res.emplace_back(child.second->m_groupName); }
+            return res;
+        }
 
-            if (m_bigintVectors.size() > 0)
+        size_t SettingsContainer::lowerBound(uint64_t hash, SettingType type, const string& key) const
+        {
+            auto keys = m_keys;
+            auto entry = std::lower_bound(m_entries, m_entries + m_entryCount, hash, [&](const SettingEntry& a, uint64_t)
             {
-                writer.Key("vector_int64"); writer.StartArray();
-                for (auto&& vec : m_bigintVectors)
-                {
-                    writer.StartObject(); writer.Key(vec.first.data());
-                    writer.StartArray();
-                    for (auto&& value : vec.second) { writer.Int64(value); }
-                    writer.EndArray();
-                    writer.EndObject();
-                }
-                writer.EndArray();
+                if (a.hash != hash)
+                    return a.hash < hash;
+                if (a.type != static_cast<uint32_t>(type))
+                    return a.type < static_cast<uint32_t>(type);
+                return compareKey(keys, a, key) < 0;
+            });
+            return static_cast<size_t>(entry - m_entries);
+        }
+
+        const SettingEntry* SettingsContainer::find(const string& key, SettingType type) const
+        {
+            auto hash = keyHash(key);
+            auto index = lowerBound(hash, type, key);
+            if (index < m_entryCount &&
+                m_entries[index].hash == hash &&
+                m_entries[index].type == static_cast<uint32_t>(type) &&
+                compareKey(m_keys, m_entries[index], key) == 0)
+                return &m_entries[index];
+            return nullptr;
+        }
+
+        uint8_t* SettingsContainer::storage(const string& key, SettingType type, uint32_t size)
+        {
+            auto hash = keyHash(key);
+            auto index = lowerBound(hash, type, key);
+            bool found = index < m_entryCount &&
+                m_entries[index].hash == hash &&
+                m_entries[index].type == static_cast<uint32_t>(type) &&
+                compareKey(m_keys, m_entries[index], key) == 0;
+
+            // a value that fits is overwritten where it is. this never moves
+            // the value of a handle because scalars always fit
+            if (found && size <= m_entries[index].size)
+            {
+                m_entries[index].size = size;
+                return m_data + m_entries[index].offset;
             }
 
-            if (m_ucharVectors.size() > 0)
+            detachContainer();
+
+            // offsets stay the same when the data grows. the old bytes of
+            // a value that did not fit are left behind until the next save
+            auto offset = m_dataBytes;
+            m_dataBytes += alignValue(size);
+            m_ownedData.resize(m_dataBytes / sizeof(uint64_t));
+
+            if (found)
             {
-                writer.Key("vector_uchar"); writer.StartArray();
-                for (auto&& vec : m_ucharVectors)
-                {
-                    writer.StartObject(); writer.Key(vec.first.data());
-                    writer.StartArray();
-                    for (auto&& value : vec.second) { writer.Uint(value); }
-                    writer.EndArray();
-                    writer.EndObject();
-                }
-                writer.EndArray();
+                m_ownedEntries[index].size = size;
+                m_ownedEntries[index].offset = offset;
             }
+            else
+            {
+                SettingEntry entry;
+                entry.hash = hash;
+                entry.keyOffset = static_cast<uint32_t>(m_ownedKeys.size());
+                entry.keyLength = static_cast<uint32_t>(key.size());
+                entry.type = static_cast<uint32_t>(type);
+                entry.size = size;
+                entry.offset = offset;
+                m_ownedKeys.insert(m_ownedKeys.end(), key.begin(), key.end());
+                m_ownedEntries.insert(m_ownedEntries.begin() + index, entry);
+            }
+            updateViews();
+            return m_data + offset;
+        }
+
+        void SettingsContainer::updateViews()
+        {
+            m_entries = m_ownedEntries.data();
+            m_entryCount = m_ownedEntries.size();
+            m_keys = m_ownedKeys.data();
+            m_keyBytes = m_ownedKeys.size();
+            m_data = reinterpret_cast<uint8_t*>(m_ownedData.data());
+        }
+
+        void SettingsContainer::detachContainer()
+        {
+            if (!m_file)
+                return;
+
+            m_ownedEntries.assign(m_entries, m_entries + m_entryCount);
+            m_ownedKeys.assign(m_keys, m_keys + m_keyBytes);
+            m_ownedData.resize(m_dataBytes / sizeof(uint64_t));
+            if (m_dataBytes)
+                memcpy(m_ownedData.data(), m_data, m_dataBytes);
+            m_file = nullptr;
+            updateViews();
+        }
+
+        void SettingsContainer::detach()
+        {
+            detachContainer();
+            for (auto&& child : m_childs)
+                child.second->detach();
+        }
 
-            if (m_ushortVectors.size() > 0)
+        bool SettingsContainer::changed() const
+        {
+            if (m_changed)
+                return true;
+            for (auto&& child : m_childs)
             {
-                writer.Key("vector_ushort"); writer.StartArray();
-                for (auto&& vec : m_ushortVectors)
-                {
-                    writer.StartObject(); writer.Key(vec.first.data());
-                    writer.StartArray();
-                    for (auto&& value : vec.second) { writer.Uint(value); }
-                    writer.EndArray();
-                    writer.EndObject();
-                }
-                writer.EndArray();
+                if (child.second->changed())
+                    return true;
             }
+            return false;
+        }
+
+        void SettingsContainer::clearChanged()
+        {
+            m_changed = false;
+            for (auto&& child : m_childs)
+                child.second->clearChanged();
+        }
+
+        template<typename T>
+        void SettingsContainer::set(const string& key, const T& value)
+        {
+            auto dst = storage(key, SettingTypeOf<T>::value, SettingCodec<T>::size(value));
+            SettingCodec<T>::write(dst, value);
+            m_changed = true;
+        }
+
+        template<typename T>
+        T SettingsContainer::get(const string& key) const
+        {
+            auto entry = find(key, SettingTypeOf<T>::value);
+            if (!entry)
+                return T{};
+            return SettingCodec<T>::read(m_data + entry->offset, entry->size);
+        }
+
+        template<typename T>
+        bool SettingsContainer::hasKey(const string& key) const
+        {
+            return find(key, SettingTypeOf<T>::value) != nullptr;
+        }
+
+#define SETTINGS_INSTANTIATE(type) \
+        template void SettingsContainer::set<type>(const string& key, const type& value); \
+        template type SettingsContainer::get<type>(const string& key) const; \
+        template bool SettingsContainer::hasKey<type>(const string& key) const;
+
+        SETTINGS_INSTANTIATE(bool)
+        SETTINGS_INSTANTIATE(char)
+        SETTINGS_INSTANTIATE(short)
+        SETTINGS_INSTANTIATE(int)
+        SETTINGS_INSTANTIATE(int64_t)
+        SETTINGS_INSTANTIATE(unsigned char)
+        SETTINGS_INSTANTIATE(unsigned short)
+        SETTINGS_INSTANTIATE(unsigned int)
+        SETTINGS_INSTANTIATE(uint64_t)
+        SETTINGS_INSTANTIATE(float)
+        SETTINGS_INSTANTIATE(double)
+        SETTINGS_INSTANTIATE(string)
+
+        SETTINGS_INSTANTIATE(engine::vector<bool>)
+        SETTINGS_INSTANTIATE(engine::vector<char>)
+        SETTINGS_INSTANTIATE(engine::vector<short>)
+        SETTINGS_INSTANTIATE(engine::vector<int>)
+        SETTINGS_INSTANTIATE(engine::vector<int64_t>)
+        SETTINGS_INSTANTIATE(engine::vector<unsigned char>)
+        SETTINGS_INSTANTIATE(engine::vector<unsigned short>)
+        SETTINGS_INSTANTIATE(engine::vector<unsigned int>)
+        SETTINGS_INSTANTIATE(engine::vector<uint64_t>)
+        SETTINGS_INSTANTIATE(engine::vector<float>)
+        SETTINGS_INSTANTIATE(engine::vector<double>)
+        SETTINGS_INSTANTIATE(engine::vector<string>)
+
+#undef SETTINGS_INSTANTIATE
 
-            if (m_uintVectors.size() > 0)
+        void SettingsContainer::readJson(void* _obj)
+        {
+            rapidjson::Value& doc = *static_cast<rapidjson::Value*>(_obj);
+            if (!doc.IsObject())
             {
-                writer.Key("vector_uint"); writer.StartArray();
-                for (auto&& vec : m_uintVectors)
-                {
-                    writer.StartObject(); writer.Key(vec.first.data());
-                    writer.StartArray();
-                    for (auto&& value : vec.second) { writer.Uint(value); }
-                    writer.EndArray();
-                    writer.EndObject();
-                }
-                writer.EndArray();
+                LOG("Settings container was malformed");
+                return;
             }
 
-            if (m_biguintVectors.size() > 0)
+            if (doc.HasMember("groupName") && doc["groupName"].IsString())
             {
-                writer.Key("vector_uint64"); writer.StartArray();
-                for (auto&& vec : m_biguintVectors)
-                {
-                    writer.StartObject(); writer.Key(vec.first.data());
-                    writer.StartArray();
-                    for (auto&& value : vec.second) { writer.Uint64(value); }
-                    writer.EndArray();
-                    writer.EndObject();
-                }
-                writer.EndArray();
+                m_groupName = string(doc["groupName"].GetString(), doc["groupName"].GetStringLength());
             }
 
-            if (m_floatVectors.size() > 0)
+            for (uint32_t type = 0; type < static_cast<uint32_t>(SettingType::Count); ++type)
             {
-                writer.Key("vector_float"); writer.StartArray();
-                for (auto&& vec : m_floatVectors)
+                auto member = doc.FindMember(SettingTypeNames[type]);
+                if (member == doc.MemberEnd() || !member->value.IsArray())
+                    continue;
+
+                const Value& list = member->value;
+                for (SizeType i = 0; i < list.Size(); ++i)
                 {
-                    writer.StartObject(); writer.Key(vec.first.data());
-                    writer.StartArray();
-                    for (auto&& value : vec.second) { writer.Double(value); }
-                    writer.EndArray();
-                    writer.EndObject();
+                    if (!list[i].IsObject())
+                        continue;
+
+                    auto obj = list[i].GetObject();
+                    for (auto objmember = obj.MemberBegin(); objmember != obj.MemberEnd(); ++objmember)
+                    {
+                        auto memberName = string(objmember->name.GetString(), objmember->name.GetStringLength());
+                        visitSettingType(static_cast<SettingType>(type), [&](auto tag)
+                        {
+                            typename decltype(tag)::type value{};
+                            if (readJsonValue(objmember->value, value))
+                                set(memberName, value);
+                        });
+                    }
                 }
-                writer.EndArray();
             }
 
-            if (m_doubleVectors.size() > 0)
+            if (doc.HasMember("childs"))
             {
-                writer.Key("vector_double"); writer.StartArray();
-                for (auto&& vec : m_doubleVectors)
+                const Value& list = doc["childs"];
+                for (SizeType i = 0; i < list.Size(); ++i)
                 {
-                    writer.StartObject(); writer.Key(vec.first.data());
-                    writer.StartArray();
-                    for (auto&& value : vec.second) { writer.Double(value); }
-                    writer.EndArray();
-                    writer.EndObject();
+                    if (list[i].HasMember("groupName") && list[i]["groupName"].IsString())
+                    {
+                        auto groupName = string(list[i]["groupName"].GetString(),
+                                                     list[i]["groupName"].GetStringLength());
+                        m_childs[groupName] = engine::make_shared<SettingsContainer>(groupName);
+                        m_childs[groupName]->m_parent = shared_from_this();
+                        m_childs[groupName]->readJson(&const_cast<Value&>(list[i]));
+                    }
                 }
-                writer.EndArray();
             }
+        }
 
-            if (m_stringVectors.size() > 0)
+        void SettingsContainer::writeJson(void* _writer)
+        {
+            JsonWriter& writer = *static_cast<JsonWriter*>(_writer);
+            writer.StartObject();
+
+            writer.Key("groupName");
+            writer.String(m_groupName.data(), static_cast<SizeType>(m_groupName.size()));
+
+            for (uint32_t type = 0; type < static_cast<uint32_t>(SettingType::Count); ++type)
             {
-                writer.Key("vector_string"); writer.StartArray();
-                for (auto&& vec : m_stringVectors)
+                bool started = false;
+                for (size_t i = 0; i < m_entryCount; ++i)
                 {
-                    writer.StartObject(); writer.Key(vec.first.data());
-                    writer.StartArray();
-                    for (auto&& value : vec.second) { writer.String(value.data()); }
-                    writer.EndArray();
+                    const SettingEntry& entry = m_entries[i];
+                    if (entry.type != type)
+                        continue;
+
+                    if (!started)
+                    {
+                        writer.Key(SettingTypeNames[type]);
+                        writer.StartArray();
+                        started = true;
+                    }
+
+                    writer.StartObject();
+                    writer.Key(m_keys + entry.keyOffset, entry.keyLength);
+                    visitSettingType(static_cast<SettingType>(type), [&](auto tag)
+                    {
+                        using T = typename decltype(tag)::type;
+                        writeJsonValue(writer, SettingCodec<T>::read(m_data + entry.offset, entry.size));
+                    });
                     writer.EndObject();
                 }
-                writer.EndArray();
+                if (started)
+                    writer.EndArray();
             }
 
             writer.Key("childs");
@@ -338,98 +589,49 @@ namespace tools
             writer.EndObject();
         }
 
-        void SettingsContainer::writeBinary()
-        {
-        }
-
-        template<> void SettingsContainer::set(const string& key, const bool& value)            { m_bools[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const char& value)            { m_chars[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const short& value)            { m_shorts[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const int& value)                { m_ints[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const int64_t& value)            { m_bigints[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const unsigned char& value)    { m_uchars[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const unsigned short& value)    { m_ushorts[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const unsigned int& value)    { m_uints[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const uint64_t& value)        { m_biguints[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const float& value)            { m_floats[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const double& value)            { m_doubles[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const string& value)            { m_strings[key] = value; }
-
-        template<> void SettingsContainer::set(const string& key, const engine::vector<bool>& value)            { m_boolVectors[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const engine::vector<char>& value)            { m_charVectors[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const engine::vector<short>& value)            { m_shortVectors[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const engine::vector<int>& value)                { m_intVectors[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const engine::vector<int64_t>& value)            { m_bigintVectors[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const engine::vector<unsigned char>& value)    { m_ucharVectors[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const engine::vector<unsigned short>& value)    { m_ushortVectors[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const engine::vector<unsigned int>& value)    { m_uintVectors[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const engine::vector<uint64_t>& value)        { m_biguintVectors[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const engine::vector<float>& value)            { m_floatVectors[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const engine::vector<double>& value)            { m_doubleVectors[key] = value; }
-        template<> void SettingsContainer::set(const string& key, const engine::vector<string>& value)          { m_stringVectors[key] = value; }
-
-        template<> bool                SettingsContainer::get<bool>(const string& key) const { return m_bools[key]; }
-        template<> char                SettingsContainer::get<char>(const string& key) const { return m_chars[key]; }
-        template<> short            SettingsContainer::get<short>(const string& key) const { return m_shorts[key]; }
-        template<> int                SettingsContainer::get<int>(const string& key) const { return m_ints[key]; }
-        template<> int64_t            SettingsContainer::get<int64_t>(const string& key) const { return m_bigints[key]; }
-        template<> unsigned char    SettingsContainer::get<unsigned char>(const string& key) const { return m_uchars[key]; }
-        template<> unsigned short    SettingsContainer::get<unsigned short>(const string& key) const { return m_ushorts[key]; }
-        template<> unsigned int        SettingsContainer::get<unsigned int>(const string& key) const { return m_uints[key]; }
-        template<> uint64_t            SettingsContainer::get<uint64_t>(const string& key) const { return m_biguints[key]; }
-        template<> float            SettingsContainer::get<float>(const string& key) const { return m_floats[key]; }
-        template<> double            SettingsContainer::get<double>(const string& key) const { return m_doubles[key]; }
-        template<> string            SettingsContainer::get<string>(const string& key) const { return m_strings[key]; }
-
-        template<> engine::vector<bool> SettingsContainer::get<engine::vector<bool>>(const string& key) const { return m_boolVectors[key]; }
-        template<> engine::vector<char> SettingsContainer::get<engine::vector<char>>(const string& key) const { return m_charVectors[key]; }
-        template<> engine::vector<short> SettingsContainer::get<engine::vector<short>>(const string& key) const { return m_shortVectors[key]; }
-        template<> engine::vector<int> SettingsContainer::get<engine::vector<int>>(const string& key) const { return m_intVectors[key]; }
-        template<> engine::vector<int64_t> SettingsContainer::get<engine::vector<int64_t>>(const string& key) const { return m_bigintVectors[key]; }
-        template<> engine::vector<unsigned char> SettingsContainer::get<engine::vector<unsigned char>>(const string& key) const { return m_ucharVectors[key]; }
-        template<> engine::vector<unsigned short> SettingsContainer::get<engine::vector<unsigned short>>(const string& key) const { return m_ushortVectors[key]; }
-        template<> engine::vector<unsigned int> SettingsContainer::get<engine::vector<unsigned int>>(const string& key) const { return m_uintVectors[key]; }
-        template<> engine::vector<uint64_t> SettingsContainer::get<engine::vector<uint64_t>>(const string& key) const { return m_biguintVectors[key]; }
-        template<> engine::vector<float> SettingsContainer::get<engine::vector<float>>(const string& key) const { return m_floatVectors[key]; }
-        template<> engine::vector<double> SettingsContainer::get<engine::vector<double>>(const string& key) const { return m_doubleVectors[key]; }
-        template<> engine::vector<string> SettingsContainer::get<engine::vector<string>>(const string& key) const { return m_stringVectors[key]; }
-
-        template<typename T>
-        bool hasKeyGeneric(engine::unordered_map<string, T> map, const string& key)
+        void SettingsContainer::writeBinary(
+            engine::vector<SettingEntry>& entries,
+            engine::vector<char>& keys,
+            engine::vector<uint8_t>& data) const
         {
-            for (auto&& keyVal : map)
+            // only the live bytes are written, values that were replaced
+            // with bigger ones are dropped here
+            auto keyStart = keys.size();
+            auto dataStart = data.size();
+            for (size_t i = 0; i < m_entryCount; ++i)
             {
-                if (keyVal.first == key)
-                    return true;
+                SettingEntry entry = m_entries[i];
+                auto keyOffset = keys.size() - keyStart;
+                keys.insert(keys.end(), m_keys + entry.keyOffset, m_keys + entry.keyOffset + entry.keyLength);
+                entry.keyOffset = static_cast<uint32_t>(keyOffset);
+
+                auto offset = data.size() - dataStart;
+                data.resize(data.size() + alignValue(entry.size), 0);
+                if (entry.size)
+                    memcpy(data.data() + dataStart + offset, m_data + entry.offset, entry.size);
+                entry.offset = offset;
+
+                entries.emplace_back(entry);
             }
-            return false;
         }
 
-        template<> bool SettingsContainer::hasKey<bool>(const string& key) const { return hasKeyGeneric(m_bools, key); }
-        template<> bool SettingsContainer::hasKey<char>(const string& key) const { return hasKeyGeneric(m_chars, key); }
-        template<> bool SettingsContainer::hasKey<short>(const string& key) const { return hasKeyGeneric(m_shorts, key); }
-        template<> bool SettingsContainer::hasKey<int>(const string& key) const { return hasKeyGeneric(m_ints, key); }
-        template<> bool SettingsContainer::hasKey<int64_t>(const string& key) const { return hasKeyGeneric(m_bigints, key); }
-        template<> bool SettingsContainer::hasKey<unsigned char>(const string& key) const { return hasKeyGeneric(m_uchars, key); }
-        template<> bool SettingsContainer::hasKey<unsigned short>(const string& key) const { return hasKeyGeneric(m_ushorts, key); }
-        template<> bool SettingsContainer::hasKey<unsigned int>(const string& key) const { return hasKeyGeneric(m_uints, key); }
-        template<> bool SettingsContainer::hasKey<uint64_t>(const string& key) const { return hasKeyGeneric(m_biguints, key); }
-        template<> bool SettingsContainer::hasKey<float>(const string& key) const { return hasKeyGeneric(m_floats, key); }
-        template<> bool SettingsContainer::hasKey<double>(const string& key) const { return hasKeyGeneric(m_doubles, key); }
-        template<> bool SettingsContainer::hasKey<string>(const string& key) const { return hasKeyGeneric(m_strings, key); }
-
-        template<> bool SettingsContainer::hasKey<engine::vector<bool>>(const string& key) const { return hasKeyGeneric(m_boolVectors, key); }
-        template<> bool SettingsContainer::hasKey<engine::vector<char>>(const string& key) const { return hasKeyGeneric(m_charVectors, key); }
-        template<> bool SettingsContainer::hasKey<engine::vector<short>>(const string& key) const { return hasKeyGeneric(m_shortVectors, key); }
-        template<> bool SettingsContainer::hasKey<engine::vector<int>>(const string& key) const { return hasKeyGeneric(m_intVectors, key); }
-        template<> bool SettingsContainer::hasKey<engine::vector<int64_t>>(const string& key) const { return hasKeyGeneric(m_bigintVectors, key); }
-        template<> bool SettingsContainer::hasKey<engine::vector<unsigned char>>(const string& key) const { return hasKeyGeneric(m_ucharVectors, key); }
-        template<> bool SettingsContainer::hasKey<engine::vector<unsigned short>>(const string& key) const { return hasKeyGeneric(m_ushortVectors, key); }
-        template<> bool SettingsContainer::hasKey<engine::vector<unsigned int>>(const string& key) const { return hasKeyGeneric(m_uintVectors, key); }
-        template<> bool SettingsContainer::hasKey<engine::vector<uint64_t>>(const string& key) const { return hasKeyGeneric(m_biguintVectors, key); }
-        template<> bool SettingsContainer::hasKey<engine::vector<float>>(const string& key) const { return hasKeyGeneric(m_floatVectors, key); }
-        template<> bool SettingsContainer::hasKey<engine::vector<double>>(const string& key) const { return hasKeyGeneric(m_doubleVectors, key); }
-        template<> bool SettingsContainer::hasKey<engine::vector<string>>(const string& key) const { return hasKeyGeneric(m_stringVectors, key); }
+        void SettingsContainer::readBinary(
+            const engine::shared_ptr<MappedFile>& file,
+            SettingEntry* entries, size_t entryCount,
+            const char* keys, size_t keyBytes,
+            uint8_t* data, size_t dataBytes)
+        {
+            m_ownedEntries.clear();
+            m_ownedKeys.clear();
+            m_ownedData.clear();
+            m_file = file;
+            m_entries = entries;
+            m_entryCount = entryCount;
+            m_keys = keys;
+            m_keyBytes = keyBytes;
+            m_data = data;
+            m_dataBytes = dataBytes;
+        }
     }
 
     Settings::Settings()
@@ -453,11 +655,12 @@ namespace tools
         case SettingsBackend::Binary: { readBinary(); break; }
         default: ASSERT(false, "Settings destructor did not handle backend type");
         }
+        m_rootNode->clearChanged();
     }
 
     Settings::~Settings()
     {
-        if(m_changed)
+        if(m_changed || m_rootNode->changed())
             save();
     }
 
@@ -469,13 +672,25 @@ namespace tools
         case SettingsBackend::Binary: { writeBinary(); break; }
         default: ASSERT(false, "Settings destructor did not handle backend type");
         }
+        m_changed = false;
+        m_rootNode->clearChanged();
+    }
+
+    void Settings::save(const string& settingsPath, SettingsBackend backend)
+    {
+        m_settingsPath = settingsPath;
+        m_backend = backend;
+        save();
     }
 
     void Settings::writeJson()
     {
         StringBuffer buffer;
         PrettyWriter<StringBuffer> writer(buffer);
-        m_currentNode->writeJson(&writer);
+        m_rootNode->writeJson(&writer);
+
+        // the file might be the one we have mapped
+        m_rootNode->detach();
 
 		std::ofstream out;
         out.open(m_settingsPath.c_str());
@@ -484,7 +699,74 @@ namespace tools
     }
 
     void Settings::writeBinary()
-    {}
+    {
+        engine::vector<SettingsContainer*> containers{ m_rootNode.get() };
+        engine::vector<SettingsFileGroup> groups;
+        engine::vector<SettingEntry> entries;
+        engine::vector<char> keys;
+        engine::vector<uint8_t> data;
+
+        for (size_t i = 0; i < containers.size(); ++i)
+        {
+            auto container = containers[i];
+
+            SettingsFileGroup group;
+            group.parent = 0;
+            group.firstChild = static_cast<uint32_t>(containers.size());
+            group.childCount = static_cast<uint32_t>(container->m_childs.size());
+            group.nameLength = static_cast<uint32_t>(container->m_groupName.size());
+            group.nameOffset = keys.size();
+            keys.insert(keys.end(), container->m_groupName.begin(), container->m_groupName.end());
+
+            group.firstEntry = static_cast<uint32_t>(entries.size());
+            group.keysOffset = keys.size();
+            group.dataOffset = data.size();
+            container->writeBinary(entries, keys, data);
+            group.entryCount = static_cast<uint32_t>(entries.size()) - group.firstEntry;
+            group.keysBytes = keys.size() - group.keysOffset;
+            group.dataBytes = data.size() - group.dataOffset;
+            groups.emplace_back(group);
+
+            for (auto&& child : container->m_childs)
+                containers.emplace_back(child.second.get());
+        }
+        for (auto&& group : groups)
+        {
+            for (uint32_t child = 0; child < group.childCount; ++child)
+                groups[group.firstChild + child].parent = static_cast<uint32_t>(&group - groups.data());
+        }
+
+        SettingsFileHeader header;
+        header.magic = SettingsFileMagic;
+        header.version = SettingsFileVersion;
+        header.groupCount = static_cast<uint32_t>(groups.size());
+        header.entryCount = static_cast<uint32_t>(entries.size());
+        header.groupsOffset = sizeof(SettingsFileHeader);
+        header.entriesOffset = header.groupsOffset + groups.size() * sizeof(SettingsFileGroup);
+        header.keysOffset = header.entriesOffset + entries.size() * sizeof(SettingEntry);
+        header.keysBytes = keys.size();
+        header.dataOffset = alignValue(header.keysOffset + header.keysBytes);
+        header.dataBytes = data.size();
+
+        engine::vector<uint8_t> file(header.dataOffset + header.dataBytes, 0);
+        memcpy(file.data(), &header, sizeof(SettingsFileHeader));
+        if (groups.size())
+            memcpy(file.data() + header.groupsOffset, groups.data(), groups.size() * sizeof(SettingsFileGroup));
+        if (entries.size())
+            memcpy(file.data() + header.entriesOffset, entries.data(), entries.size() * sizeof(SettingEntry));
+        if (keys.size())
+            memcpy(file.data() + header.keysOffset, keys.data(), keys.size());
+        if (data.size())
+            memcpy(file.data() + header.dataOffset, data.data(), data.size());
+
+        // the file can't be replaced while it's mapped
+        m_rootNode->detach();
+
+        std::ofstream out;
+        out.open(m_settingsPath.c_str(), std::ios::binary);
+        out.write(reinterpret_cast<const char*>(file.data()), file.size());
+        out.close();
+    }
 
     void Settings::readJson()
     {
@@ -508,7 +790,115 @@ namespace tools
     }
 
     void Settings::readBinary()
-    {}
+    {
+        auto file = engine::make_shared<MappedFile>(m_settingsPath);
+        if (!file->valid())
+            return;
+
+        // everything is checked once here so the lookups can trust the file
+        auto size = file->size();
+        auto base = file->data();
+        auto range = [size](uint64_t offset, uint64_t bytes) { return offset <= size && bytes <= size - offset; };
+
+        SettingsFileHeader header;
+        if (size < sizeof(SettingsFileHeader))
+        {
+            LOG("Settings file was malformed: %s", m_settingsPath.c_str());
+            return;
+        }
+        memcpy(&header, base, sizeof(SettingsFileHeader));
+
+        bool valid =
+            header.magic == SettingsFileMagic &&
+            header.version == SettingsFileVersion &&
+            header.groupCount > 0 &&
+            header.groupsOffset % SettingsValueAlignment == 0 &&
+            header.entriesOffset % SettingsValueAlignment == 0 &&
+            header.dataOffset % SettingsValueAlignment == 0 &&
+            range(header.groupsOffset, static_cast<uint64_t>(header.groupCount) * sizeof(SettingsFileGroup)) &&
+            range(header.entriesOffset, static_cast<uint64_t>(header.entryCount) * sizeof(SettingEntry)) &&
+            range(header.keysOffset, header.keysBytes) &&
+            range(header.dataOffset, header.dataBytes);
+        if (!valid)
+        {
+            LOG("Settings file was malformed: %s", m_settingsPath.c_str());
+            return;
+        }
+
+        auto groups = reinterpret_cast<const SettingsFileGroup*>(base + header.groupsOffset);
+        auto entries = reinterpret_cast<SettingEntry*>(base + header.entriesOffset);
+        for (uint32_t i = 0; valid && i < header.groupCount; ++i)
+        {
+            const auto& group = groups[i];
+            valid =
+                (i == 0 || group.parent < i) &&
+                (group.childCount == 0 || group.firstChild > i) &&
+                group.firstChild <= header.groupCount && group.childCount <= header.groupCount - group.firstChild &&
+                group.firstEntry <= header.entryCount && group.entryCount <= header.entryCount - group.firstEntry &&
+                group.nameOffset <= header.keysBytes && group.nameLength <= header.keysBytes - group.nameOffset &&
+                group.keysOffset <= header.keysBytes && group.keysBytes <= header.keysBytes - group.keysOffset &&
+                group.dataOffset % SettingsValueAlignment == 0 &&
+                group.dataBytes % SettingsValueAlignment == 0 &&
+                group.dataOffset <= header.dataBytes && group.dataBytes <= header.dataBytes - group.dataOffset;
+
+            for (uint32_t e = 0; valid && e < group.entryCount; ++e)
+            {
+                const auto& entry = entries[group.firstEntry + e];
+                valid =
+                    entry.type < static_cast<uint32_t>(SettingType::Count) &&
+                    entry.offset % SettingsValueAlignment == 0 &&
+                    static_cast<uint64_t>(entry.keyOffset) + entry.keyLength <= group.keysBytes &&
+                    entry.offset <= group.dataBytes && entry.size <= group.dataBytes - entry.offset;
+
+                // the codecs read fixed size values without looking at the size
+                if (valid)
+                    visitSettingType(static_cast<SettingType>(entry.type), [&](auto tag)
+                    {
+                        valid = SettingCodec<typename decltype(tag)::type>::validSize(entry.size);
+                    });
+            }
+        }
+        if (!valid)
+        {
+            LOG("Settings file was malformed: %s", m_settingsPath.c_str());
+            return;
+        }
+
+        auto keys = reinterpret_cast<const char*>(base + header.keysOffset);
+        auto data = base + header.dataOffset;
+        engine::vector<engine::shared_ptr<SettingsContainer>> containers(header.groupCount);
+        containers[0] = m_rootNode;
+        for (uint32_t i = 0; i < header.groupCount; ++i)
+        {
+            const auto& group = groups[i];
+            if (!containers[i])
+            {
+                // every group but the root is someone's child
+                LOG("Settings file was malformed: %s", m_settingsPath.c_str());
+                m_rootNode = engine::make_shared<SettingsContainer>("root");
+                m_currentNode = m_rootNode;
+                return;
+            }
+
+            auto container = containers[i];
+            container->m_groupName = string(keys + group.nameOffset, group.nameLength);
+            container->readBinary(
+                file,
+                entries + group.firstEntry, group.entryCount,
+                keys + group.keysOffset, group.keysBytes,
+                data + group.dataOffset, group.dataBytes);
+
+            for (uint32_t c = 0; c < group.childCount; ++c)
+            {
+                const auto& childGroup = groups[group.firstChild + c];
+                auto name = string(keys + childGroup.nameOffset, childGroup.nameLength);
+                auto child = engine::make_shared<SettingsContainer>(name);
+                child->m_parent = container;
+                container->m_childs[name] = child;
+                containers[group.firstChild + c] = child;
+            }
+        }
+    }
 
 	engine::vector<string> Settings::keys() const
     {
@@ -123,6 +123,7 @@ namespace engine
         private:
             friend class implementation::PipelineImplDX12;
             friend class implementation::PipelineImplVulkan;
+            friend class implementation::PipelineImplNull;
             friend class implementation::PipelineShadersDX12;
             friend class implementation::PipelineShadersVulkan;
 
@@ -6,6 +6,7 @@ using System.Collections.Generic;
 [module: Sharpmake.Include("../darkness-externals/qt.sharpmake.cs")]
 [module: Sharpmake.Include("../darkness-externals/compressonator.sharpmake.cs")]
 [module: Sharpmake.Include("../darkness-externals/freeimage.sharpmake.cs")]
+[module: Sharpmake.Include("../darkness-externals/assimp.sharpmake.cs")]
 [module: Sharpmake.Include("../qtcustombuild.sharpmake.cs")]
 
 [Generate]
@@ -66,6 +67,7 @@ class DarknessResourceClient : DarknessExecutable
         conf.AddPublicDependency<Qt>(target);
         conf.AddPublicDependency<Compressonator>(target);
         conf.AddPublicDependency<FreeImage>(target);
+        conf.AddPublicDependency<AssImp>(target);
 
         conf.TargetPath = @"[project.SharpmakeCsPath]\bin\[target.Platform]\[conf.Name]";
         conf.ProjectPath = @"[project.SharpmakeCsPath]\ide\[target.DevEnv]";
@@ -1,37 +1,158 @@
 #include "ModelSplitter.h"
+#include "engine/rendering/Mesh.h"
 #include "platform/Uuid.h"
+#include "tools/ProcessorInfo.h"
+#include "tools/Debug.h"
+
+#include "assimp/Importer.hpp"
+#include "assimp/Exporter.hpp"
+#include "assimp/SceneCombiner.h"
+#include "assimp/scene.h"
+#include "assimp/postprocess.h"
+
+#include <algorithm>
+#include <cstring>
 
 using namespace engine;
 
 namespace resource_client
 {
+    namespace
+    {
+        // the post processing the resource task expects the meshes to have
+        constexpr unsigned int ModelImportFlags =
+            aiProcess_CalcTangentSpace |
+            aiProcess_Triangulate |
+            aiProcess_JoinIdenticalVertices |
+            aiProcess_SortByPType |
+            aiProcess_GenSmoothNormals;
+
+        // the meshes of the part with every material. part 0 also gets the node
+        // hierarchy for the prefab. the nodes keep referring to model mesh numbers.
+        engine::vector<char> exportModelPart(const aiScene* scene, const ModelPartMeshes& part, bool withNodes)
+        {
+            aiScene partScene;
+            partScene.mNumMaterials = scene->mNumMaterials;
+            partScene.mMaterials = new aiMaterial*[scene->mNumMaterials];
+            for (unsigned int material = 0; material < scene->mNumMaterials; ++material)
+                Assimp::SceneCombiner::Copy(&partScene.mMaterials[material], scene->mMaterials[material]);
+
+            partScene.mNumMeshes = part.count;
+            partScene.mMeshes = new aiMesh*[part.count];
+            for (uint32_t mesh = 0; mesh < part.count; ++mesh)
+                Assimp::SceneCombiner::Copy(&partScene.mMeshes[mesh], scene->mMeshes[part.first + mesh]);
+
+            if (withNodes && scene->mRootNode)
+                Assimp::SceneCombiner::Copy(&partScene.mRootNode, scene->mRootNode);
+            else
+                partScene.mRootNode = new aiNode();
+
+            engine::vector<char> result;
+            Assimp::Exporter exporter;
+            auto blob = exporter.ExportToBlob(&partScene, "assbin");
+            if (!blob)
+            {
+                LOG_ERROR("Could not export model part: %s", exporter.GetErrorString());
+                return result;
+            }
+            result.resize(blob->size);
+            memcpy(result.data(), blob->data, blob->size);
+            return result;
+        }
+    }
+
+    ModelSplitter::ModelSplitter()
+        : m_maxParts{ std::max(static_cast<int32_t>(engine::getProcessorInfo().processorCoreCount) - 1, 1) }
+    {
+    }
+
     engine::vector<SplitTask> ModelSplitter::splitModelTask(Task& container)
     {
+        auto modelPart = [&](int32_t partId, int32_t partCount)->SplitTask
+        {
+            SplitTask task;
+            task.type = TaskType::Model;
+            task.model.modelTargetPath = container.model.modelTargetPath;
+            task.model.assetName = container.model.assetName;
+            task.model.scale = container.model.scale;
+            task.model.rotation = container.model.rotation;
+            task.model.partId = partId;
+            task.model.partCount = partCount;
+            task.model.firstMesh = 0;
+            task.model.meshCount = 0;
+            task.progress = 0.0f;
+            task.subTaskId = platform::uuid();
+            task.taskId = container.taskId;
+            return task;
+        };
+
         engine::vector<SplitTask> result;
-        SplitTask task;
-        task.type = TaskType::Model;
-
-        task.model.modelTargetPath = container.model.modelTargetPath;
-        task.model.assetName = container.model.assetName;
-        task.model.scale = container.model.scale;
-        task.model.rotation = container.model.rotation;
-
-        task.data = move(container.data);
-        task.progress = 0.0f;
-        task.bytes = task.data.size();
-        task.subTaskId = platform::uuid();
-        task.taskId = container.taskId;
-        result.emplace_back(std::move(task));
+
+        // the model is imported once here and every part gets only it's own meshes.
+        // the parts are split by index count, a mesh is never split between parts.
+        Assimp::Importer importer;
+        auto scene = importer.ReadFileFromMemory(container.data.data(), container.data.size(), ModelImportFlags);
+        if (!scene)
+        {
+            // the task imports the source and reports the failure
+            LOG_WARNING("Could not import model: %s. %s", container.model.assetName.c_str(), importer.GetErrorString());
+            auto task = modelPart(0, 1);
+            task.data = std::move(container.data);
+            task.bytes = task.data.size();
+            result.emplace_back(std::move(task));
+            return result;
+        }
+
+        engine::vector<uint32_t> meshIndexCounts(scene->mNumMeshes);
+        engine::vector<uint32_t> meshMaterials(scene->mNumMeshes);
+        for (uint32_t mesh = 0; mesh < scene->mNumMeshes; ++mesh)
+        {
+            meshIndexCounts[mesh] = scene->mMeshes[mesh]->mNumFaces * 3;
+            meshMaterials[mesh] = scene->mMeshes[mesh]->mMaterialIndex;
+        }
+
+        auto parts = engine::splitModelParts(meshIndexCounts, static_cast<size_t>(m_maxParts));
+        auto partCount = static_cast<int32_t>(parts.size());
+        for (int32_t partId = 0; partId < partCount; ++partId)
+        {
+            auto task = modelPart(partId, partCount);
+            task.model.firstMesh = parts[partId].first;
+            task.model.meshCount = parts[partId].count;
+            task.model.meshIndexCounts = meshIndexCounts;
+            task.model.meshMaterials = meshMaterials;
+            task.data = exportModelPart(scene, parts[partId], partId == 0);
+            task.bytes = task.data.size();
+            result.emplace_back(std::move(task));
+        }
         return result;
     }
 
     TaskResult ModelSplitter::joinModelTask(engine::vector<SplitTaskResult>& results)
     {
-        ASSERT(results.size() == 1, "Multipart model messages unsupported");
         TaskResult result;
-        result.model.modelData = std::move(results[0].model.modelData);
-        result.model.prefabData = std::move(results[0].model.prefabData);
         result.type = TaskType::Model;
+        if (results.empty())
+        {
+            LOG_ERROR("Model task finished without any parts");
+            return result;
+        }
+
+        auto sortRule = [](const SplitTaskResult& a, const SplitTaskResult& b)->bool { return a.model.partId < b.model.partId; };
+        std::sort(results.begin(), results.end(), sortRule);
+        ASSERT(results.size() == static_cast<size_t>(std::max(results[0].model.partCount, 1)), "Model parts missing");
+
+        if (results.size() == 1)
+        {
+            result.model.modelData = std::move(results[0].model.modelData);
+        }
+        else
+        {
+            engine::vector<engine::vector<char>> parts;
+            for (auto&& res : results)
+                parts.emplace_back(std::move(res.model.modelData));
+            engine::mergeMeshMemory(parts, result.model.modelData);
+        }
+        result.model.prefabData = std::move(results[0].model.prefabData);
         return result;
     }
 }
@@ -5,10 +5,15 @@
 
 namespace resource_client
 {
+    // imports the model and splits it's meshes between the parts,
+    // see engine::splitModelParts. the parts are joined with engine::mergeMeshMemory
     class ModelSplitter
     {
     public:
+        ModelSplitter();
         engine::vector<SplitTask> splitModelTask(Task& container);
         TaskResult joinModelTask(engine::vector<SplitTaskResult>& results);
+    private:
+        int32_t m_maxParts;
     };
 }
@@ -121,6 +121,15 @@ namespace resource_client
     {
         engine::vector<char> modelData;
         engine::vector<char> prefabData;
+        int32_t partId;
+        int32_t partCount;
+
+        // the model meshes in data
+        uint32_t firstMesh;
+        uint32_t meshCount;
+        // index count and material of every mesh in the model
+        engine::vector<uint32_t> meshIndexCounts;
+        engine::vector<uint32_t> meshMaterials;
     };
 
     struct SplitTaskResult
@@ -151,6 +160,8 @@ namespace resource_client
         engine::string assetName;
         engine::Vector3f scale;
         engine::Quaternionf rotation;
+        int32_t partId;
+        int32_t partCount;
     };
 
     struct SplitTask
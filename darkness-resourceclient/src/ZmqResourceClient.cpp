@@ -255,6 +255,14 @@ namespace resource_client
             req.set_rotationy(task.model.rotation.y);
             req.set_rotationz(task.model.rotation.z);
             req.set_rotationw(task.model.rotation.w);
+            req.set_partid(task.model.partId);
+            req.set_partcount(task.model.partCount);
+            req.set_firstmesh(task.model.firstMesh);
+            req.set_meshcount(task.model.meshCount);
+            for (auto&& indexCount : task.model.meshIndexCounts)
+                req.add_meshindexcounts(indexCount);
+            for (auto&& material : task.model.meshMaterials)
+                req.add_meshmaterials(material);
             req.set_modeldata(task.data.data(), task.data.size());
             engine::vector<char> modelReqMsg(req.ByteSizeLong());
             if (modelReqMsg.size() > 0)
@@ -643,16 +651,21 @@ namespace resource_client
                                 if (split->subTaskId == taskRes.taskid().c_str())
                                 {
                                     split->result.type = TaskType::Model;
+                                    split->result.model.partId = taskRes.partid();
+                                    split->result.model.partCount = taskRes.partcount();
                                     split->result.model.modelData.resize(taskRes.modeldata().size());
                                     split->result.model.prefabData.resize(taskRes.prefabdata().size());
-                                    memcpy(
-                                        &split->result.model.modelData[0], 
-                                        taskRes.modeldata().data(), 
-                                        split->result.model.modelData.size());
-                                    memcpy(
-                                        &split->result.model.prefabData[0],
-                                        taskRes.prefabdata().data(),
-                                        split->result.model.prefabData.size());
+                                    // only the first part of a multipart model carries the prefab
+                                    if (split->result.model.modelData.size() > 0)
+                                        memcpy(
+                                            &split->result.model.modelData[0], 
+                                            taskRes.modeldata().data(), 
+                                            split->result.model.modelData.size());
+                                    if (split->result.model.prefabData.size() > 0)
+                                        memcpy(
+                                            &split->result.model.prefabData[0],
+                                            taskRes.prefabdata().data(),
+                                            split->result.model.prefabData.size());
 
 #ifdef ENABLE_RESOURCE_CLIENT_LOGGING
                                     LOG("Task ID: %s, Subtask ID: %s, DONE",
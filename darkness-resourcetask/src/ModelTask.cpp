@@ -5,6 +5,7 @@
 #include "tools/PathTools.h"
 #include "tools/MeshTools.h"
 #include "tools/Clusterize.h"
+#include "tools/MeshOptimize.h"
 #include "engine/primitives/Quaternion.h"
 #include "engine/primitives/Vector3.h"
 #include "engine/rendering/SubMesh.h"
@@ -30,6 +31,8 @@
 #include "containers/string.h"
 
 #include <fstream>
+#include <thread>
+#include <chrono>
 
 #include "fbxsdk.h"
 
@@ -214,7 +217,7 @@ namespace resource_task
     }
 
     void createScene(
-        engine::Mesh& mesh,
+        const engine::vector<engine::Material>& subMeshMaterials,
         engine::unordered_map<uint32_t, engine::vector<uint32_t>>& meshSplitMap,
         const engine::Vector3f& importScale,
         const engine::Quaternionf& importRotation,
@@ -266,7 +269,7 @@ namespace resource_task
                 auto meshRenderer = engine::make_shared<MeshRendererComponent>(dstPath, splitMesh);
                 meshNode->addComponent(meshRenderer);
 
-                engine::Material& mat = mesh.subMeshes()[splitMesh].out_material;
+                const engine::Material& mat = subMeshMaterials[splitMesh];
 
                 engine::MaterialTexture albedo;
                 bool hasAlbedo = findTexture(mat.textures, TextureType::Albedo, albedo);
@@ -307,7 +310,7 @@ namespace resource_task
 
         for (unsigned int i = 0; i < node->mNumChildren; ++i)
         {
-            createScene(mesh, meshSplitMap, importScale, importRotation, destinationPath, node->mChildren[i], thisNode, nodeTransform);
+            createScene(subMeshMaterials, meshSplitMap, importScale, importRotation, destinationPath, node->mChildren[i], thisNode, nodeTransform);
         }
     }
 
@@ -350,6 +353,135 @@ namespace resource_task
         LOG("Message: %s, Progress: %f", message.c_str(), progress);
     }
 
+    void updateNoProgress(
+        const engine::string& /*hostId*/,
+        const engine::string& /*taskId*/,
+        zmq::socket_t* /*socket*/,
+        float /*progress*/,
+        const engine::string& /*message*/)
+    {
+    }
+
+    engine::Material parseMaterial(const aiScene* scene, unsigned int materialIndex)
+    {
+        engine::Material result;
+        auto material = scene->mMaterials[materialIndex];
+
+        engine::vector<aiTextureType> textureTypes = {
+            aiTextureType_DIFFUSE,
+            aiTextureType_SPECULAR,
+            aiTextureType_AMBIENT,
+            aiTextureType_EMISSIVE,
+            aiTextureType_HEIGHT,
+            aiTextureType_NORMALS,
+            aiTextureType_SHININESS,
+            aiTextureType_OPACITY,
+            aiTextureType_DISPLACEMENT,
+            aiTextureType_LIGHTMAP,
+            aiTextureType_REFLECTION,
+            aiTextureType_UNKNOWN
+        };
+
+        for (auto& type : textureTypes)
+        {
+            auto count = material->GetTextureCount(type);
+            if (count != 0)
+            {
+                LOG("some type");
+            }
+        }
+
+        bool hadMaterial = false;
+        for (auto texType : textureTypes)
+        {
+            for (unsigned int texIndex = 0; texIndex < material->GetTextureCount(texType); ++texIndex)
+            {
+                aiString path;
+                aiTextureMapping textureMapping;
+                unsigned int uvIndex;
+                float blend;
+                aiTextureOp op;
+                aiTextureMapMode mode;
+                if (material->GetTexture(texType, texIndex, &path, &textureMapping,
+                    &uvIndex, &blend, &op, &mode) == aiReturn_SUCCESS)
+                {
+                    result.textures.emplace_back(MaterialTexture{
+                        engine::string(&path.data[0], path.length),
+                        mapping(textureMapping),
+                        mappingMode(mode),
+                        textureType(texType),
+                        textureOp(op),
+                        uvIndex
+                        });
+                    hadMaterial = true;
+                    LOG("Mesh has material: %s", engine::string(&path.data[0], path.length).c_str());
+                }
+            }
+        }
+        if (!hadMaterial)
+        {
+            //qDebug() << "No material for mesh found.";
+            LOG("No material for mesh found.");
+        }
+        return result;
+    }
+
+    struct ImportedModel
+    {
+        Importer importer;
+        const aiScene* scene = nullptr;
+    };
+
+    // the scene is only read after this so parts can share it between threads.
+    // model parts from the resource client are already post processed
+    // (with these same flags) and exported as assbin
+    engine::shared_ptr<ImportedModel> importModel(const char* buffer, size_t bytes, bool clientPart)
+    {
+        auto imported = engine::make_shared<ImportedModel>();
+        if (clientPart)
+        {
+            imported->scene = imported->importer.ReadFileFromMemory(buffer, bytes, 0, "assbin");
+            return imported;
+        }
+        imported->scene = imported->importer.ReadFileFromMemory(buffer, bytes,
+            aiProcess_CalcTangentSpace |
+            aiProcess_Triangulate |
+            aiProcess_JoinIdenticalVertices |
+            aiProcess_SortByPType |
+            aiProcess_GenSmoothNormals);
+        return imported;
+    }
+
+    // 65535 is not a mistake. 65535 is divisible by 3 (ie. one face) where 65536 is not.
+    constexpr uint32_t MaxIndexesPerSubMesh = 65535u;
+
+    // Every assimp mesh is broken down to submeshes of at most MaxIndexesPerSubMesh
+    // indexes. Every part gets the index counts of the whole model so they all
+    // arrive at the same list and the same submesh numbering.
+    struct ModelWorkUnit
+    {
+        uint32_t meshNum;
+        uint32_t indexCount;
+    };
+
+    engine::vector<ModelWorkUnit> modelWorkUnits(const engine::vector<uint32_t>& meshIndexCounts)
+    {
+        engine::vector<ModelWorkUnit> units;
+        for (uint32_t meshNum = 0; meshNum < static_cast<uint32_t>(meshIndexCounts.size()); ++meshNum)
+        {
+            auto meshIndexes = meshIndexCounts[meshNum];
+            auto currentIndexCount = 0u;
+            while (currentIndexCount < meshIndexes)
+            {
+                auto indexesLeft = meshIndexes - currentIndexCount;
+                auto indexCount = indexesLeft > MaxIndexesPerSubMesh ? MaxIndexesPerSubMesh : indexesLeft;
+                units.emplace_back(ModelWorkUnit{ meshNum, indexCount });
+                currentIndexCount += indexCount;
+            }
+        }
+        return units;
+    }
+
     void ModelTask::process(
         const engine::string& srcFile,
         const engine::string& dstFile)
@@ -372,10 +504,12 @@ namespace resource_task
         auto plainFilename = filename.substr(0, filename.length() - ext.length() - 1);
 
         Quaternionf rotation;
+        engine::shared_ptr<ImportedModel> imported;
 
         auto modelData = privateProcess(
             srcBuffer.data(),
             srcBuffer.size(),
+            imported,
             "",
             "",
             plainFilename,
@@ -387,6 +521,7 @@ namespace resource_task
             rotation.y,
             rotation.z,
             rotation.w,
+            ModelPart(),
             nullptr,
             updateLocalProgress);
 
@@ -396,14 +531,130 @@ namespace resource_task
         out.close();
     }
 
+    void ModelTask::benchmark(
+        const engine::string& srcFile,
+        int workers)
+    {
+        engine::vector<char> srcBuffer;
+
+        std::ifstream src;
+        src.open(srcFile.c_str(), std::ios::binary | std::ios::in);
+        if (src.is_open())
+        {
+            src.seekg(0, std::ios::end);
+            srcBuffer.resize(src.tellg());
+            src.seekg(0, std::ios::beg);
+            src.read(&srcBuffer[0], srcBuffer.size());
+            src.close();
+        }
+        if (srcBuffer.size() == 0)
+        {
+            LOG_ERROR("Could not read model file: %s", srcFile.c_str());
+            return;
+        }
+
+        auto filename = pathExtractFilename(srcFile);
+        auto ext = pathExtractExtension(filename);
+        auto plainFilename = filename.substr(0, filename.length() - ext.length() - 1);
+        workers = std::max(workers, 1);
+
+        // the parts share one import and split the meshes like the resource client does.
+        // the benchmark splits to the worker count even when the model is small.
+        auto imported = importModel(srcBuffer.data(), srcBuffer.size(), false);
+        if (!imported->scene)
+        {
+            LOG_ERROR("Could not import model file: %s", srcFile.c_str());
+            return;
+        }
+        ModelPart model;
+        for (uint32_t mesh = 0; mesh < imported->scene->mNumMeshes; ++mesh)
+        {
+            model.meshIndexCounts.emplace_back(imported->scene->mMeshes[mesh]->mNumFaces * 3);
+            model.meshMaterials.emplace_back(imported->scene->mMeshes[mesh]->mMaterialIndex);
+        }
+
+        auto runParts = [&](size_t maxParts)->engine::vector<FinishedData>
+        {
+            auto meshes = splitModelParts(model.meshIndexCounts, maxParts, 1u);
+            auto partCount = static_cast<int>(meshes.size());
+            engine::vector<FinishedData> parts(partCount);
+            engine::vector<std::thread> threads;
+            for (int partId = 0; partId < partCount; ++partId)
+            {
+                threads.emplace_back(std::thread([&, partId]()
+                {
+                    Quaternionf rotation;
+                    auto partImport = imported;
+                    auto part = model;
+                    part.partId = partId;
+                    part.partCount = partCount;
+                    part.firstMesh = meshes[partId].first;
+                    part.meshCount = meshes[partId].count;
+                    parts[partId] = privateProcess(
+                        srcBuffer.data(),
+                        srcBuffer.size(),
+                        partImport,
+                        "",
+                        "",
+                        plainFilename,
+                        srcFile,
+                        1.0f,
+                        1.0f,
+                        1.0f,
+                        rotation.x,
+                        rotation.y,
+                        rotation.z,
+                        rotation.w,
+                        part,
+                        nullptr,
+                        updateNoProgress);
+                }));
+            }
+            for (auto&& thread : threads)
+                thread.join();
+            return parts;
+        };
+
+        auto start = std::chrono::high_resolution_clock::now();
+        auto single = runParts(1);
+        auto singleDone = std::chrono::high_resolution_clock::now();
+        auto multi = runParts(static_cast<size_t>(workers));
+
+        engine::vector<engine::vector<char>> modelParts;
+        for (auto&& part : multi)
+            modelParts.emplace_back(std::move(part.modelData));
+        engine::vector<char> merged;
+        engine::mergeMeshMemory(modelParts, merged);
+        auto multiDone = std::chrono::high_resolution_clock::now();
+
+        auto singleMs = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(singleDone - start).count()) / 1000.0;
+        auto multiMs = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(multiDone - singleDone).count()) / 1000.0;
+
+        LOG_PURE("Model: %s, source bytes: %zu, output bytes: %zu", srcFile.c_str(), srcBuffer.size(), merged.size());
+        LOG_PURE("1 worker took: %f ms", singleMs);
+        LOG_PURE("%i workers (%zu parts) took: %f ms (speedup %f)", workers, multi.size(), multiMs, multiMs > 0.0 ? singleMs / multiMs : 0.0);
+        LOG_PURE("Output identical: %s", (single.size() > 0 && single[0].modelData == merged) ? "yes" : "no");
+    }
+
     ProcessorTaskModelResponse ModelTask::process(
         ProcessorTaskModelRequest& request,
         const engine::string& hostId,
         zmq::socket_t* socket)
     {
+        ModelPart part;
+        part.partId = request.partid();
+        part.partCount = std::max(request.partcount(), 1);
+        part.sceneFirstMesh = request.firstmesh();
+        part.firstMesh = request.firstmesh();
+        part.meshCount = request.meshcount();
+        part.meshIndexCounts.assign(request.meshindexcounts().begin(), request.meshindexcounts().end());
+        part.meshMaterials.assign(request.meshmaterials().begin(), request.meshmaterials().end());
+
+        engine::shared_ptr<ImportedModel> imported;
         auto res = privateProcess(
             request.modeldata().data(),
             request.modeldata().size(),
+            imported,
             request.taskid().c_str(),
             hostId,
             request.assetname().c_str(),
@@ -415,6 +666,7 @@ namespace resource_task
             request.rotationy(),
             request.rotationz(),
             request.rotationw(),
+            part,
             socket,
             updateProgress);
 
@@ -422,6 +674,8 @@ namespace resource_task
         response.set_modeldata(res.modelData.data(), res.modelData.size());
         response.set_prefabdata(res.prefabData.data(), res.prefabData.size());
         response.set_taskid(request.taskid());
+        response.set_partid(request.partid());
+        response.set_partcount(std::max(request.partcount(), 1));
         return response;
     }
 
@@ -770,6 +1024,14 @@ namespace resource_task
         return multimesh;
     }
 
+    void optimizeClusters(engine::ModelCpu& model, engine::vector<uint32_t>& clusterIndexes)
+    {
+        auto before = meshAnalyzeVertexCache(clusterIndexes.data(), clusterIndexes.size());
+        meshOptimizeClusters(model, clusterIndexes);
+        auto after = meshAnalyzeVertexCache(clusterIndexes.data(), clusterIndexes.size());
+        LOG("Submesh vertex cache. ACMR: %f -> %f, ATVR: %f -> %f", before.acmr, after.acmr, before.atvr, after.atvr);
+    }
+
     engine::SubMesh processMesh(FbxMesh* mesh)
     {
 #if 1
@@ -1294,20 +1556,34 @@ namespace resource_task
         }
 #endif
         {
-            engine::ModelPackedCpu outputData = packModel(model, vertexScale);
-
             // clusterize
+            engine::vector<uint32_t> clusterIndexes;
             {
                 //onUpdateProgress(hostId, taskId,
                 //    socket, progress(meshNum, scene->mNumMeshes),
                 //    debugMsg(meshNum, scene->mNumMeshes, "Clustering submesh"));
 
                 engine::Clusterize clusterizer;
-                auto clusterIndexes = clusterizer.clusterize(model.vertex, model.index);
-                for (auto&& index : clusterIndexes)
-                    outputData.index.emplace_back(index);
+                clusterIndexes = clusterizer.clusterize(model.vertex, model.index);
+            }
+
+            // vertex cache, overdraw and vertex fetch order. reorders the
+            // model vertexes so this needs to happen before packing
+            {
+                //onUpdateProgress(hostId, taskId,
+                //    socket, progress(meshNum, scene->mNumMeshes),
+                //    debugMsg(meshNum, scene->mNumMeshes, "Optimizing submesh clusters"));
+
+                optimizeClusters(model, clusterIndexes);
             }
 
+            engine::ModelPackedCpu outputData = packModel(model, vertexScale);
+
+            // the clusters index the clusterized index, not the one packModel copied
+            outputData.index.clear();
+            for (auto&& index : clusterIndexes)
+                outputData.index.emplace_back(index);
+
             // create submesh clusters
             {
                 //onUpdateProgress(hostId, taskId,
@@ -2499,6 +2775,7 @@ namespace resource_task
     ModelTask::FinishedData ModelTask::privateProcess(
         const char* buffer,
         size_t bytes,
+        engine::shared_ptr<ImportedModel>& imported,
         const engine::string& taskId,
         const engine::string& hostId,
         const engine::string& assetName,
@@ -2510,6 +2787,7 @@ namespace resource_task
         float rotationY,
         float rotationZ,
         float rotationW,
+        ModelPart part,
         zmq::socket_t* socket,
         std::function<void(
             const engine::string&,
@@ -2661,17 +2939,29 @@ namespace resource_task
 
 
 
-        Importer importer;
-        auto scene = importer.ReadFileFromMemory(buffer, bytes,
-            aiProcess_CalcTangentSpace |
-            aiProcess_Triangulate |
-            aiProcess_JoinIdenticalVertices |
-            aiProcess_SortByPType |
-            aiProcess_GenSmoothNormals);
+        if (!imported)
+            imported = importModel(buffer, bytes, !part.meshIndexCounts.empty());
+        auto scene = imported->scene;
 
         if(!scene)
             return {};
 
+        if (part.meshIndexCounts.empty())
+        {
+            part.sceneFirstMesh = 0;
+            part.firstMesh = 0;
+            part.meshCount = scene->mNumMeshes;
+            for (uint32_t meshNum = 0; meshNum < scene->mNumMeshes; ++meshNum)
+            {
+                part.meshIndexCounts.emplace_back(scene->mMeshes[meshNum]->mNumFaces * 3);
+                part.meshMaterials.emplace_back(scene->mMeshes[meshNum]->mMaterialIndex);
+            }
+        }
+        ASSERT(part.meshIndexCounts.size() == part.meshMaterials.size(), "Model part mesh lists don't match");
+        ASSERT(part.firstMesh >= part.sceneFirstMesh &&
+            part.firstMesh + part.meshCount <= part.sceneFirstMesh + scene->mNumMeshes &&
+            part.firstMesh + part.meshCount <= part.meshIndexCounts.size(), "Model part meshes are not in the scene");
+
         /*for (uint32_t i = 0; i < scene->mNumMaterials; ++i)
         {
             const aiMaterial* material = scene->mMaterials[i];
@@ -2686,39 +2976,78 @@ namespace resource_task
             }
         }*/
 
+#ifdef GENERATE_LODS
         Simplygon simplygon;
+#endif
 
         FinishedData finishedData;
 
-        auto debugMsg = [](size_t meshNum, size_t numMeshes, const engine::string& msg)->engine::string
+        // this part processes only it's range of the meshes.
+        // part 0 additionally writes the prefab for the whole model.
+        auto units = modelWorkUnits(part.meshIndexCounts);
+        auto meshCount = static_cast<uint32_t>(part.meshIndexCounts.size());
+
+        engine::vector<size_t> meshFirstUnit(meshCount + 1, units.size());
+        for (size_t unit = units.size(); unit > 0; --unit)
+            meshFirstUnit[units[unit - 1].meshNum] = unit - 1;
+        for (size_t meshNum = meshCount; meshNum > 0; --meshNum)
+            meshFirstUnit[meshNum - 1] = std::min(meshFirstUnit[meshNum - 1], meshFirstUnit[meshNum]);
+
+        auto partEnd = part.firstMesh + part.meshCount;
+        auto partUnits = meshFirstUnit[partEnd] - meshFirstUnit[part.firstMesh];
+        size_t processedUnits = 0;
+
+        auto debugMsg = [&](const engine::string& msg)->engine::string
         {
-            engine::string resmsg = msg;
+            engine::string resmsg = "";
+            if (part.partCount > 1)
+            {
+                resmsg += "Part ";
+                resmsg += std::to_string(part.partId + 1).c_str();
+                resmsg += "/";
+                resmsg += std::to_string(part.partCount).c_str();
+                resmsg += ": ";
+            }
+            resmsg += msg;
             resmsg += " ";
-            resmsg += std::to_string(meshNum + 1).c_str();
+            resmsg += std::to_string(std::min(processedUnits + 1, partUnits)).c_str();
             resmsg += "/";
-            resmsg += std::to_string(numMeshes).c_str();
+            resmsg += std::to_string(partUnits).c_str();
             return resmsg;
         };
-        auto progress = [](size_t meshNum, size_t numMeshes)->float
+        auto progress = [&]()->float
         {
-            return static_cast<float>(meshNum) / static_cast<float>(numMeshes);
+            if (partUnits == 0)
+                return 1.0f;
+            return static_cast<float>(processedUnits) / static_cast<float>(partUnits);
         };
 
         engine::unordered_map<uint32_t, engine::vector<uint32_t>> meshSplitMap;
+        for (size_t unit = 0; unit < units.size(); ++unit)
+            meshSplitMap[units[unit].meshNum].emplace_back(static_cast<uint32_t>(unit));
+
+        // part 0 needs the materials of every mesh for the prefab
+        engine::vector<engine::Material> meshMaterials(meshCount);
+        for (uint32_t meshNum = 0; meshNum < meshCount; ++meshNum)
+        {
+            bool meshInPart = meshNum >= part.firstMesh && meshNum < partEnd;
+            if (part.partId == 0 || meshInPart)
+                meshMaterials[meshNum] = parseMaterial(scene, part.meshMaterials[meshNum]);
+        }
 
         if (scene->HasMeshes())
         {
             engine::Mesh mesh;
             mesh.setFilename("");
 
-            for (size_t meshNum = 0; meshNum < scene->mNumMeshes; ++meshNum)
+            for (uint32_t meshNum = part.firstMesh; meshNum < partEnd; ++meshNum)
             {
                 // PROGRESS: START
                 onUpdateProgress(hostId, taskId,
-                    socket, progress(meshNum, scene->mNumMeshes),
-                    debugMsg(meshNum, scene->mNumMeshes, "Processing submesh vertice"));
+                    socket, progress(),
+                    debugMsg("Processing submesh vertice"));
 
-                auto assmesh = scene->mMeshes[meshNum];
+                auto assmesh = scene->mMeshes[meshNum - part.sceneFirstMesh];
                 auto hasTangents = assmesh->HasTangentsAndBitangents();
 
                 auto meshIndexes = assmesh->mNumFaces * 3;
@@ -2781,10 +3110,10 @@ namespace resource_task
                 while (currentIndexCount < meshIndexes)
                 {
                     auto indexesLeft = meshIndexes - currentIndexCount;
-                    auto maxIndexesPerMesh = 65535u; // this is not a mistake. 65535 is divisible by 3 (ie. one face) where 65536 is not.
 
                     auto startIndex = currentIndexCount;
-                    auto indexCount = indexesLeft > maxIndexesPerMesh ? maxIndexesPerMesh : indexesLeft;
+                    auto indexCount = indexesLeft > MaxIndexesPerSubMesh ? MaxIndexesPerSubMesh : indexesLeft;
+
                     engine::vector<engine::Vector3f> vertexBuffer;
                     engine::vector<engine::Vector3f> normalBuffer;
                     engine::vector<engine::Vector3f> tangentBuffer;
@@ -2982,25 +3311,39 @@ namespace resource_task
 
 #if 1
                     {
-                        engine::ModelPackedCpu outputData = packModel(model, vertexScale);
-
                         // clusterize
+                        engine::vector<uint32_t> clusterIndexes;
                         {
                             onUpdateProgress(hostId, taskId,
-                                socket, progress(meshNum, scene->mNumMeshes),
-                                debugMsg(meshNum, scene->mNumMeshes, "Clustering submesh"));
+                                socket, progress(),
+                                debugMsg("Clustering submesh"));
 
                             engine::Clusterize clusterizer;
-                            auto clusterIndexes = clusterizer.clusterize(model.vertex, model.index);
-                            for (auto&& index : clusterIndexes)
-                                outputData.index.emplace_back(index);
+                            clusterIndexes = clusterizer.clusterize(model.vertex, model.index);
+                        }
+
+                        // vertex cache, overdraw and vertex fetch order. reorders the
+                        // model vertexes so this needs to happen before packing
+                        {
+                            onUpdateProgress(hostId, taskId,
+                                socket, progress(),
+                                debugMsg("Optimizing submesh clusters"));
+
+                            optimizeClusters(model, clusterIndexes);
                         }
 
+                        engine::ModelPackedCpu outputData = packModel(model, vertexScale);
+
+                        // the clusters index the clusterized index, not the one packModel copied
+                        outputData.index.clear();
+                        for (auto&& index : clusterIndexes)
+                            outputData.index.emplace_back(index);
+
                         // create submesh clusters
                         {
                             onUpdateProgress(hostId, taskId,
-                                socket, progress(meshNum, scene->mNumMeshes),
-                                debugMsg(meshNum, scene->mNumMeshes, "Creating submesh clusters & BB"));
+                                socket, progress(),
+                                debugMsg("Creating submesh clusters & BB"));
 
                             auto clusterCount = outputData.index.size() / ClusterMaxSize;
                             auto extraIndices = outputData.index.size() - (clusterCount * ClusterMaxSize);
@@ -3045,8 +3388,8 @@ namespace resource_task
                         // create adjacency
                         {
                             onUpdateProgress(hostId, taskId,
-                                socket, progress(meshNum, scene->mNumMeshes),
-                                debugMsg(meshNum, scene->mNumMeshes, "Generating submesh adjacency"));
+                                socket, progress(),
+                                debugMsg("Generating submesh adjacency"));
 
                             engine::vector<uint32_t> temporaryIndex(outputData.index.size());
                             for (size_t i = 0; i < outputData.index.size(); ++i)
@@ -3070,8 +3413,8 @@ namespace resource_task
                         // clusterize
                         {
                             onUpdateProgress(hostId, taskId,
-                                socket, progress(meshNum, scene->mNumMeshes),
-                                debugMsg(meshNum, scene->mNumMeshes, "Clustering submesh"));
+                                socket, progress(),
+                                debugMsg("Clustering submesh"));
 
                             engine::Clusterize clusterizer;
                             outputData.index = clusterizer.clusterize(lod.vertex, lod.index);
@@ -3080,8 +3423,8 @@ namespace resource_task
                         // create submesh clusters
                         {
                             onUpdateProgress(hostId, taskId,
-                                socket, progress(meshNum, scene->mNumMeshes),
-                                debugMsg(meshNum, scene->mNumMeshes, "Creating submesh clusters & BB"));
+                                socket, progress(),
+                                debugMsg("Creating submesh clusters & BB"));
 
                             auto clusterCount = outputData.index.size() / ClusterMaxSize;
                             auto extraIndices = outputData.index.size() - (clusterCount * ClusterMaxSize);
@@ -3124,8 +3467,8 @@ namespace resource_task
                         // create adjacency
                         {
                             onUpdateProgress(hostId, taskId,
-                                socket, progress(meshNum, scene->mNumMeshes),
-                                debugMsg(meshNum, scene->mNumMeshes, "Generating submesh adjacency"));
+                                socket, progress(),
+                                debugMsg("Generating submesh adjacency"));
 
                             engine::vector<uint32_t> temporaryIndex(outputData.index.size());
                             for (size_t i = 0; i < outputData.index.size(); ++i)
@@ -3185,78 +3528,22 @@ namespace resource_task
                     // materials
                     {
                         onUpdateProgress(hostId, taskId,
-                            socket, progress(meshNum, scene->mNumMeshes),
-                            debugMsg(meshNum, scene->mNumMeshes, "Parsing submesh materials"));
-
-                        auto material = scene->mMaterials[assmesh->mMaterialIndex];
-
-                        engine::vector<aiTextureType> textureTypes = {
-                            aiTextureType_DIFFUSE,
-                            aiTextureType_SPECULAR,
-                            aiTextureType_AMBIENT,
-                            aiTextureType_EMISSIVE,
-                            aiTextureType_HEIGHT,
-                            aiTextureType_NORMALS,
-                            aiTextureType_SHININESS,
-                            aiTextureType_OPACITY,
-                            aiTextureType_DISPLACEMENT,
-                            aiTextureType_LIGHTMAP,
-                            aiTextureType_REFLECTION,
-                            aiTextureType_UNKNOWN
-                        };
-
-                        for (auto& type : textureTypes)
-                        {
-                            auto count = material->GetTextureCount(type);
-                            if (count != 0)
-                            {
-                                LOG("some type");
-                            }
-                        }
-
-                        bool hadMaterial = false;
-                        for (auto texType : textureTypes)
-                        {
-                            for (unsigned int texIndex = 0; texIndex < material->GetTextureCount(texType); ++texIndex)
-                            {
-                                aiString path;
-                                aiTextureMapping textureMapping;
-                                unsigned int uvIndex;
-                                float blend;
-                                aiTextureOp op;
-                                aiTextureMapMode mode;
-                                if (material->GetTexture(texType, texIndex, &path, &textureMapping,
-                                    &uvIndex, &blend, &op, &mode) == aiReturn_SUCCESS)
-                                {
-                                    subMesh.out_material.textures.emplace_back(MaterialTexture{
-                                        engine::string(&path.data[0], path.length),
-                                        mapping(textureMapping),
-                                        mappingMode(mode),
-                                        textureType(texType),
-                                        textureOp(op),
-                                        uvIndex
-                                        });
-                                    hadMaterial = true;
-                                    LOG("Mesh has material: %s", engine::string(&path.data[0], path.length).c_str());
-                                }
-                            }
-                        }
-                        if (!hadMaterial)
-                        {
-                            //qDebug() << "No material for mesh found.";
-                            LOG("No material for mesh found.");
-                        }
+                            socket, progress(),
+                            debugMsg("Parsing submesh materials"));
+                        subMesh.out_material = meshMaterials[meshNum];
                     }
-
                     mesh.subMeshes().emplace_back(subMesh);
-                    auto subMeshCount = static_cast<uint32_t>(mesh.subMeshes().size());
-                    meshSplitMap[static_cast<uint32_t>(meshNum)].emplace_back(subMeshCount > 0 ? subMeshCount - 1u : 0);
+                    ++processedUnits;
                 }
             }
             mesh.saveToMemory(finishedData.modelData);
 
-            if (scene->mRootNode)
+            if (scene->mRootNode && part.partId == 0)
             {
+                engine::vector<engine::Material> subMeshMaterials(units.size());
+                for (size_t unit = 0; unit < units.size(); ++unit)
+                    subMeshMaterials[unit] = meshMaterials[units[unit].meshNum];
+
 				engine::shared_ptr<SceneNode> node = engine::make_shared<SceneNode>();
                 node->name(assetName);
 
@@ -3267,7 +3554,7 @@ namespace resource_task
                 Quaternionf rotation{ rotationX, rotationY, rotationZ, rotationW };
 
                 Matrix4f transform;
-                createScene(mesh, meshSplitMap, scale, rotation, modelTargetPath, scene->mRootNode, node);
+                createScene(subMeshMaterials, meshSplitMap, scale, rotation, modelTargetPath, scene->mRootNode, node);
 
                 rapidjson::StringBuffer strBuffer;
                 rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(strBuffer);
@@ -3,6 +3,7 @@
 #include "containers/string.h"
 #include <functional>
 #include "containers/vector.h"
+#include "containers/memory.h"
 
 namespace engine
 {
@@ -19,6 +20,9 @@ class ProcessorTaskModelResponse;
 
 namespace resource_task
 {
+    // imported model. the benchmark shares one between the parts
+    struct ImportedModel;
+
     class ModelTask
     {
     public:
@@ -37,11 +41,35 @@ namespace resource_task
             const engine::string& srcFile,
             const engine::string& dstFile);
 
+        // processes srcFile once as a single part and once split to
+        // the given amount of parts running in parallel. logs the timings.
+        void benchmark(
+            const engine::string& srcFile,
+            int workers);
+
     private:
+        // the model meshes a part processes. the mesh lists cover the whole
+        // model, part 0 writes the prefab for the submeshes of every part.
+        // empty lists mean the imported scene is the whole model and the part
+        // processes all of it.
+        struct ModelPart
+        {
+            int partId = 0;
+            int partCount = 1;
+
+            // model mesh number of the first mesh in the imported scene
+            uint32_t sceneFirstMesh = 0;
+            uint32_t firstMesh = 0;
+            uint32_t meshCount = 0;
+            engine::vector<uint32_t> meshIndexCounts;
+            engine::vector<uint32_t> meshMaterials;
+        };
 
+        // imports the model to imported if it is empty
         FinishedData privateProcess(
             const char* buffer,
             size_t bytes,
+            engine::shared_ptr<ImportedModel>& imported,
             const engine::string& taskId,
             const engine::string& hostId,
             const engine::string& assetName,
@@ -53,6 +81,7 @@ namespace resource_task
             float rotationY,
             float rotationZ,
             float rotationW,
+            ModelPart part,
             zmq::socket_t* socket,
             std::function<void(
                 const engine::string&,
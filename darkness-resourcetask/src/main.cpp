@@ -1,6 +1,7 @@
 #include "platform/Platform.h"
 #include "tools/AssetTools.h"
 #include "tools/ArgParser.h"
+#include "tools/ProcessorInfo.h"
 #include "ResourceTask.h"
 #include "tools/Debug.h"
 #include "ImageTask.h"
@@ -28,6 +29,16 @@ int CALLBACK WinMain(
             argParser.value("hostid"));
         return task.join();
     }
+    else if (argParser.flag("benchmark") && argParser.isSet("src"))
+    {
+        // DarknessResourceTask.exe --benchmark --src=model.fbx --workers=8
+        auto workers = argParser.isSet("workers") ?
+            std::stoi(argParser.value("workers").c_str()) :
+            std::max(static_cast<int>(engine::getProcessorInfo().processorCoreCount) - 1, 1);
+
+        ModelTask modelTask;
+        modelTask.benchmark(argParser.value("src"), workers);
+    }
     else if (argParser.isSet("src") && argParser.isSet("dst"))
     {
         if (engine::isModelFormat(argParser.value("src")))
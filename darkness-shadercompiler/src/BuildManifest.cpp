@@ -0,0 +1,183 @@
+#include "BuildManifest.h"
+#include "ShaderCompilerCommon.h"
+#include "tools/PathTools.h"
+#include "tools/StringTools.h"
+#include "tools/Debug.h"
+#include "platform/File.h"
+#include <fstream>
+#include <sstream>
+
+namespace shadercompiler
+{
+    // bump when the meaning of the stored hashes changes
+    constexpr const char* ManifestVersion = "darkness-shader-manifest 1";
+
+    BuildManifest::BuildManifest(const engine::string& path)
+        : m_path{ path }
+        , m_changed{ false }
+    {
+        load();
+    }
+
+    void BuildManifest::load()
+    {
+        if (!engine::fileExists(m_path))
+            return;
+
+        std::ifstream file(m_path);
+        if (!file.is_open())
+            return;
+
+        std::string line;
+        if (!std::getline(file, line) || line != ManifestVersion)
+            return;
+
+        // source <tab> key <tab> file <tab> hash ...
+        // output <tab> path <tab> hash
+        while (std::getline(file, line))
+        {
+            auto parts = engine::tokenize(line, { '\t', '\r' });
+            if (parts.size() == 0)
+                continue;
+
+            if (parts[0] == "source" && parts.size() >= 2 && parts.size() % 2 == 0)
+            {
+                auto& files = m_sources[parts[1]];
+                for (size_t i = 2; i < parts.size(); i += 2)
+                    files.emplace_back(FileHash{ parts[i], parts[i + 1] });
+            }
+            else if (parts[0] == "output" && parts.size() == 3)
+                m_outputs[parts[1]] = parts[2];
+        }
+    }
+
+    void BuildManifest::save()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_changed)
+            return;
+
+        std::ofstream file(m_path + "temporary", std::ios::out | std::ios::trunc);
+        ASSERT(file.is_open(), "Could not write shader build manifest: %s", m_path.c_str());
+
+        file << ManifestVersion << "\n";
+        for (auto&& source : m_sources)
+        {
+            file << "source\t" << source.first;
+            for (auto&& f : source.second)
+                file << "\t" << f.path << "\t" << f.hash;
+            file << "\n";
+        }
+        for (auto&& output : m_outputs)
+            file << "output\t" << output.first << "\t" << output.second << "\n";
+        file.close();
+
+        if (engine::fileExists(m_path))
+            engine::fileDelete(m_path);
+        engine::fileCopy(m_path + "temporary", m_path);
+        engine::fileDelete(m_path + "temporary");
+        m_changed = false;
+    }
+
+    engine::string BuildManifest::fileHash(const engine::string& path)
+    {
+        auto key = engine::pathClean(path);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto cached = m_fileHashes.find(key);
+            if (cached != m_fileHashes.end())
+                return cached->second;
+        }
+
+        // missing files hash to empty so they never match a stored hash
+        engine::string hash;
+        std::ifstream file(key, std::ios::in | std::ios::binary);
+        if (file.is_open())
+        {
+            std::stringstream content;
+            content << file.rdbuf();
+            hash = sha1(content.str());
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fileHashes[key] = hash;
+        return hash;
+    }
+
+    bool BuildManifest::hasSource(const engine::string& key)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_sources.find(engine::pathClean(key)) != m_sources.end();
+    }
+
+    bool BuildManifest::sourceChanged(const engine::string& key)
+    {
+        engine::vector<FileHash> files;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto source = m_sources.find(engine::pathClean(key));
+            if (source == m_sources.end())
+                return true;
+            files = source->second;
+        }
+
+        for (auto&& f : files)
+        {
+            if (fileHash(f.path) != f.hash)
+                return true;
+        }
+        return false;
+    }
+
+    void BuildManifest::updateSource(const engine::string& key, const engine::vector<engine::string>& files)
+    {
+        auto cleanKey = engine::pathClean(key);
+
+        engine::vector<FileHash> hashes;
+        for (auto&& f : files)
+        {
+            auto path = engine::pathClean(f);
+            bool duplicate = false;
+            for (auto&& existing : hashes)
+            {
+                if (existing.path == path)
+                {
+                    duplicate = true;
+                    break;
+                }
+            }
+            if (!duplicate)
+                hashes.emplace_back(FileHash{ path, fileHash(path) });
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_failed.find(cleanKey) != m_failed.end())
+            return;
+        m_sources[cleanKey] = hashes;
+        m_changed = true;
+    }
+
+    void BuildManifest::failSource(const engine::string& key)
+    {
+        auto cleanKey = engine::pathClean(key);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_failed[cleanKey] = true;
+        m_sources.erase(cleanKey);
+        m_changed = true;
+    }
+
+    bool BuildManifest::outputChanged(const engine::string& output, const engine::string& hash)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto stored = m_outputs.find(engine::pathClean(output));
+        return stored == m_outputs.end() || stored->second != hash;
+    }
+
+    void BuildManifest::updateOutput(const engine::string& output, const engine::string& hash)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_outputs[engine::pathClean(output)] = hash;
+        m_changed = true;
+    }
+}
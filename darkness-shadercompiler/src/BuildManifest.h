@@ -0,0 +1,58 @@
+#pragma once
+
+#include "containers/string.h"
+#include "containers/vector.h"
+#include "containers/unordered_map.h"
+#include <mutex>
+
+namespace shadercompiler
+{
+    // content hashes of the previous build.
+    //
+    // sources: a key (shader source, template set) and the hashes of every
+    //          file it was built from. changed when any of those files changed.
+    // outputs: an output file and the hash of everything it is built from
+    //          (preprocessed source, compiler arguments, templates).
+    //
+    // timestamps only tell that something was touched. hashes tell that it
+    // changed, so saving a file without edits or editing a shared include
+    // that a permutation does not see won't recompile anything.
+    class BuildManifest
+    {
+    public:
+        BuildManifest(const engine::string& path);
+
+        void save();
+
+        // hash of the file contents. cached for the lifetime of the manifest
+        engine::string fileHash(const engine::string& path);
+
+        bool hasSource(const engine::string& key);
+        bool sourceChanged(const engine::string& key);
+        void updateSource(const engine::string& key, const engine::vector<engine::string>& files);
+
+        // a failed source is not recorded by updateSource during this run
+        void failSource(const engine::string& key);
+
+        bool outputChanged(const engine::string& output, const engine::string& hash);
+        void updateOutput(const engine::string& output, const engine::string& hash);
+
+    private:
+        struct FileHash
+        {
+            engine::string path;
+            engine::string hash;
+        };
+
+        engine::string m_path;
+        bool m_changed;
+
+        std::mutex m_mutex;
+        engine::unordered_map<engine::string, engine::vector<FileHash>> m_sources;
+        engine::unordered_map<engine::string, engine::string> m_outputs;
+        engine::unordered_map<engine::string, engine::string> m_fileHashes;
+        engine::unordered_map<engine::string, bool> m_failed;
+
+        void load();
+    };
+}
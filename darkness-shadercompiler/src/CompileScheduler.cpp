@@ -0,0 +1,107 @@
+#include "CompileScheduler.h"
+#include "tools/Debug.h"
+#include <algorithm>
+#include <chrono>
+
+namespace shadercompiler
+{
+    CompileScheduler::CompileScheduler(int workerCount)
+        : m_jobsAdded{ 0 }
+        , m_jobsDone{ 0 }
+        , m_alive{ true }
+    {
+        if (workerCount <= 0)
+            workerCount = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+
+        for (int i = 0; i < workerCount; ++i)
+            m_workers.emplace_back([this]() { this->worker(); });
+    }
+
+    CompileScheduler::~CompileScheduler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_alive = false;
+        }
+        m_jobAvailable.notify_all();
+        for (auto&& worker : m_workers)
+            worker.join();
+    }
+
+    void CompileScheduler::add(Job job, bool priority)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (priority)
+                m_priorityJobs.push(job);
+            else
+                m_jobs.push(job);
+            ++m_jobsAdded;
+        }
+        m_jobAvailable.notify_one();
+    }
+
+    void CompileScheduler::worker()
+    {
+        while (true)
+        {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_jobAvailable.wait(lock, [&]() { return !m_alive || m_priorityJobs.size() > 0 || m_jobs.size() > 0; });
+                if (!m_alive)
+                    return;
+
+                if (m_priorityJobs.size() > 0)
+                {
+                    job = m_priorityJobs.front();
+                    m_priorityJobs.pop();
+                }
+                else
+                {
+                    job = m_jobs.front();
+                    m_jobs.pop();
+                }
+            }
+
+            job();
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                ++m_jobsDone;
+            }
+            m_jobDone.notify_all();
+        }
+    }
+
+    void CompileScheduler::wait(const char* name, LogLevel logLevel)
+    {
+        bool logProgress =
+            logLevel != LogLevel::None &&
+            static_cast<int>(LogLevel::Progress) <= static_cast<int>(logLevel);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        int jobs = 0;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!m_jobDone.wait_for(lock, std::chrono::seconds(1), [&]() { return m_jobsDone == m_jobsAdded; }))
+            {
+                if (logProgress)
+                    LOG_PURE("    %s %i / %i", name, m_jobsDone, m_jobsAdded);
+            }
+            jobs = m_jobsAdded;
+            m_jobsAdded = 0;
+            m_jobsDone = 0;
+        }
+
+        if (logProgress && jobs > 0)
+        {
+            auto seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+            LOG_PURE("    %s %i jobs on %i workers, %.1f jobs/s",
+                name,
+                jobs,
+                workerCount(),
+                seconds > 0.0 ? static_cast<double>(jobs) / seconds : 0.0);
+        }
+    }
+}
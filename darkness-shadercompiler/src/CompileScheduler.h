@@ -0,0 +1,53 @@
+#pragma once
+
+#include "containers/vector.h"
+#include "containers/queue.h"
+#include "CompileSharedTypes.h"
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace shadercompiler
+{
+    // runs compiler invocations on a fixed number of workers.
+    //
+    // every job usually waits for an external compiler process, so the worker
+    // count is also the number of compiler processes running at once.
+    // priority jobs (shaders the engine is waiting for) are picked first.
+    class CompileScheduler
+    {
+    public:
+        using Job = std::function<void()>;
+
+        // workerCount 0 uses one worker per hardware thread
+        CompileScheduler(int workerCount);
+        ~CompileScheduler();
+
+        CompileScheduler(const CompileScheduler&) = delete;
+        CompileScheduler(CompileScheduler&&) = delete;
+        CompileScheduler& operator=(const CompileScheduler&) = delete;
+        CompileScheduler& operator=(CompileScheduler&&) = delete;
+
+        // thread safe
+        void add(Job job, bool priority = false);
+
+        // blocks until all added jobs have finished.
+        // progress is logged about once a second and the throughput at the end.
+        void wait(const char* name, LogLevel logLevel);
+
+        int workerCount() const { return static_cast<int>(m_workers.size()); }
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_jobAvailable;
+        std::condition_variable m_jobDone;
+        engine::queue<Job> m_priorityJobs;
+        engine::queue<Job> m_jobs;
+        int m_jobsAdded;
+        int m_jobsDone;
+        bool m_alive;
+        engine::vector<std::thread> m_workers;
+
+        void worker();
+    };
+}
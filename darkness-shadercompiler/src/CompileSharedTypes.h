@@ -1,5 +1,7 @@
 #pragma once
 
+#include "containers/string.h"
+
 namespace shadercompiler
 {
     enum class GraphicsApi
@@ -16,4 +18,24 @@ namespace shadercompiler
         Progress,
         All
     };
+
+    enum class PreprocessorType
+    {
+        InProcess,  // HlslPreprocessor
+        Dxc         // dxc -P with compilerPathDX12. slow, kept for comparing
+    };
+
+    struct CompilerSettings
+    {
+        engine::string compilerPathDX12;
+        engine::string compilerPathVulkan;
+
+        // compiler processes running at once. 0 uses one per hardware thread
+        int workerCount = 0;
+
+        // permutations compiled one after another by a single job
+        int batchSize = 4;
+
+        PreprocessorType preprocessor = PreprocessorType::InProcess;
+    };
 }
@@ -6,6 +6,7 @@
 #include "tools/Debug.h"
 #include "tools/PathTools.h"
 #include "ShaderLocator.h"
+#include "ShaderCompilerCommon.h"
 #include "platform/Directory.h"
 #include "platform/File.h"
 #include "tools/Process.h"
@@ -15,6 +16,8 @@
 #include <sstream>
 #include <iomanip>
 #include <filesystem>
+#include <functional>
+#include <chrono>
 
 namespace fs = std::filesystem;
 
@@ -27,8 +30,16 @@ namespace fs = std::filesystem;
 
 namespace shadercompiler
 {
-    CompileTask::CompileTask(ShaderLocator& locator, bool optimization, LogLevel logLevel)
+    CompileTask::CompileTask(ShaderLocator& locator, bool optimization, LogLevel logLevel, const CompilerSettings& settings)
         : m_logLevel{ logLevel }
+        , m_settings{ settings }
+        , m_scheduler{ settings.workerCount }
+        , m_rootSignaturesCompiled{ 0 }
+        , m_rootSignaturesSkipped{ 0 }
+        , m_shadersCompiled{ 0 }
+        , m_shadersSkipped{ 0 }
+        , m_interfacesWritten{ 0 }
+        , m_interfacesSkipped{ 0 }
     {
         m_shaderProfiles["Compute"] = "cs_6_2";
         m_shaderProfiles["Domain"] = "ds_6_2";
@@ -44,26 +55,55 @@ namespace shadercompiler
         m_shaderProfiles["Amplification"] = "as_6_5";
         m_shaderProfiles["Mesh"] = "ms_6_5";
 
-        if(doLog(LogLevel::Progress)) LOG_PURE("Preprocess and get resources (2/8)");
-        preprocessAndGetResources(locator);
+        auto phase = [&](const char* name, std::function<void()> work)
+        {
+            if (doLog(LogLevel::Progress)) LOG_PURE("%s", name);
+            auto start = std::chrono::high_resolution_clock::now();
+            work();
+            auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start);
+            if (doLog(LogLevel::Progress)) LOG_PURE("    took %i ms", static_cast<int>(milliseconds.count()));
+        };
 
-        if(doLog(LogLevel::Progress)) LOG_PURE("Write root signatures (3/8)");
-        writeRootSignatures(locator);
+        phase("Preprocess and get resources (2/8)", [&]() { preprocessAndGetResources(locator); });
+        phase("Write root signatures (3/8)", [&]() { writeRootSignatures(locator); });
+        phase("Update resource registers (4/8)", [&]() { updateResourceRegisters(locator); });
+        phase("Compile DX12 shaders (5/8)", [&]() { compile(locator, optimization); });
+        phase("Patch Vulkan shader registers (6/8)", [&]() { patchVulkanRegisters(locator); });
+        phase("Compile Vulkan shaders (7/8)", [&]() { compile(locator, optimization, GraphicsApi::Vulkan); });
+        phase("Create c++ interfaces (8/8)", [&]() { createCodeInterfaces(locator); });
 
-        if(doLog(LogLevel::Progress)) LOG_PURE("Update resource registers (4/8)");
-        updateResourceRegisters(locator);
+        updateManifest(locator);
 
-        if(doLog(LogLevel::Progress)) LOG_PURE("Compile DX12 shaders (5/8)");
-        compile(locator, optimization);
+        if (doLog(LogLevel::Progress))
+        {
+            LOG_PURE("Shaders: %i compiled, %i up to date", m_shadersCompiled.load(), m_shadersSkipped.load());
+            LOG_PURE("Root signatures: %i compiled, %i up to date", m_rootSignaturesCompiled.load(), m_rootSignaturesSkipped.load());
+            LOG_PURE("C++ interfaces: %i written, %i up to date", m_interfacesWritten.load(), m_interfacesSkipped.load());
+        }
+    }
+
+    void CompileTask::updateManifest(ShaderLocator& locator)
+    {
+        auto& manifest = locator.manifest();
+        for (auto&& pipeline : locator.pipelines())
+        {
+            for (auto&& stage : pipeline.stages)
+            {
+                if (!stage.buildShaderBinary)
+                    continue;
 
-        if(doLog(LogLevel::Progress)) LOG_PURE("Patch Vulkan shader registers (6/8)");
-        patchVulkanRegisters(locator);
+                // ignored for stages that failed to compile so they are retried
+                engine::vector<engine::string> files{ stage.filename };
+                files.insert(files.end(), stage.shaderIncludeDepencyPaths.begin(), stage.shaderIncludeDepencyPaths.end());
+                manifest.updateSource(stage.filename, files);
+            }
+        }
 
-        if(doLog(LogLevel::Progress)) LOG_PURE("Compile Vulkan shaders (7/8)");
-        compile(locator, optimization, GraphicsApi::Vulkan);
+        // a single file build does not update every interface
+        if (!locator.singleFile())
+            manifest.updateSource(ShaderLocator::InterfaceTemplatesKey, locator.interfaceTemplates());
 
-        if(doLog(LogLevel::Progress)) LOG_PURE("Create c++ interfaces (8/8)");
-        createCodeInterfaces(locator);
+        manifest.save();
     }
 
     bool CompileTask::doLog(LogLevel level) const
@@ -103,9 +143,10 @@ namespace shadercompiler
 
     void CompileTask::preprocessAndGetResources(ShaderLocator& locator)
     {
+        // permutations share the include cache which locks, so no par_unseq
 #ifdef MULTITHREADED_PREPROCESS
         std::for_each(
-            std::execution::par_unseq,
+            std::execution::par,
             locator.pipelines().begin(),
             locator.pipelines().end(),
             [](auto&& pipeline)
@@ -209,7 +250,7 @@ namespace shadercompiler
 
 #ifdef MULTITHREADED_PREPROCESS
             std::for_each(
-                std::execution::par_unseq,
+                std::execution::par,
                 pipeline.stages.begin(),
                 pipeline.stages.end(),
                 [&](auto&& stage)
@@ -217,7 +258,7 @@ namespace shadercompiler
             for (auto&& stage : pipeline.stages)
 #endif
             {
-                shadercompiler::Preprocessor preprocessor(stage.filename);
+                shadercompiler::Preprocessor preprocessor(stage.filename, m_settings.preprocessor, m_settings.compilerPathDX12);
                 stage.enums = preprocessor.enums();
                 stage.options = preprocessor.options();
                 stage.permutations = permute(preprocessor.options(), preprocessor.enums());
@@ -249,7 +290,7 @@ namespace shadercompiler
                     stage.itemMutex = engine::make_shared<std::mutex>();
 #ifdef MULTITHREADED_PREPROCESS
                     std::for_each(
-                        std::execution::par_unseq,
+                        std::execution::par,
                         stage.permutations.begin(),
                         stage.permutations.end(),
                         [&](auto&& permutation)
@@ -275,7 +316,11 @@ namespace shadercompiler
                         {
                             std::lock_guard<std::mutex> lock(*stage.itemMutex);
                             stage.items.emplace_back(item);
-                            stage.shaderIncludeDepencyPaths = shaderIncludeDepencyPaths;
+
+                            // permutations can see different includes. keep them all
+                            for (auto&& dependency : shaderIncludeDepencyPaths)
+                                if (std::find(stage.shaderIncludeDepencyPaths.begin(), stage.shaderIncludeDepencyPaths.end(), dependency) == stage.shaderIncludeDepencyPaths.end())
+                                    stage.shaderIncludeDepencyPaths.emplace_back(dependency);
                         }
                     }
 #ifdef MULTITHREADED_PREPROCESS
@@ -293,7 +338,7 @@ namespace shadercompiler
 #endif
     }
 
-    void CompileTask::writeRootSignatures(ShaderLocator& locator) const
+    void CompileTask::writeRootSignatures(ShaderLocator& locator)
     {
 #ifdef MULTITHREADED_WRITEROOTSIGNATURES
         std::for_each(
@@ -351,7 +396,27 @@ namespace shadercompiler
 
                     //std::this_thread::sleep_for(std::chrono::milliseconds(1000));
 
-                    compileRootSignature(rootSignaturePath, engine::pathReplaceExtension(rootSignaturePath, "rso"));
+                    auto rootSignatureBinary = engine::pathReplaceExtension(rootSignaturePath, "rso");
+                    auto rootSignatureData = FileAccessSerializer::instance().readFile(rootSignaturePath, true);
+                    auto rootSignatureHash = sha1(engine::string(rootSignatureData.begin(), rootSignatureData.end()));
+
+                    if (!locator.forceCompileAll() &&
+                        engine::fileExists(rootSignatureBinary) &&
+                        !locator.manifest().outputChanged(rootSignatureBinary, rootSignatureHash))
+                    {
+                        ++m_rootSignaturesSkipped;
+                    }
+                    else
+                    {
+                        ++m_rootSignaturesCompiled;
+                        m_scheduler.add([this, &locator, &stage, rootSignaturePath, rootSignatureBinary, rootSignatureHash]()
+                        {
+                            if (compileRootSignature(rootSignaturePath, rootSignatureBinary))
+                                locator.manifest().updateOutput(rootSignatureBinary, rootSignatureHash);
+                            else
+                                locator.manifest().failSource(stage.filename);
+                        }, stage.priority);
+                    }
                 }
             }
 #ifdef MULTITHREADED_WRITEROOTSIGNATURES
@@ -361,11 +426,12 @@ namespace shadercompiler
 #ifdef MULTITHREADED_WRITEROOTSIGNATURES
         );
 #endif
+        m_scheduler.wait("Root signatures", m_logLevel);
     }
 
-    void CompileTask::compileRootSignature(const engine::string& rs, const engine::string& rso) const
+    bool CompileTask::compileRootSignature(const engine::string& rs, const engine::string& rso) const
     {
-        auto dxcPath = engine::pathClean("C:/Program Files (x86)/Windows Kits/10/bin/10.0.19041.0/x86/dxc.exe");
+        auto dxcPath = engine::pathClean(m_settings.compilerPathDX12);
         {
             // in it's own scope so we wait for the execution to finish
             engine::string arguments = " /Vd /T rootsig_1_1 " + rs + " /Fo " + rso;
@@ -396,6 +462,7 @@ namespace shadercompiler
                 if (!done)
                     std::this_thread::sleep_for(std::chrono::milliseconds(100));
             }
+            return error > 0;
         }
     }
 
@@ -839,9 +906,9 @@ namespace shadercompiler
         {
             engine::string dxcPath;
             if(api == GraphicsApi::DX12)
-                dxcPath = engine::pathClean("C:/Program Files (x86)/Windows Kits/10/bin/10.0.19041.0/x86/dxc.exe");
+                dxcPath = engine::pathClean(m_settings.compilerPathDX12);
             else if(api == GraphicsApi::Vulkan)
-                dxcPath = engine::pathClean("C:/VulkanSDK/1.3.239.0/Bin/dxc.exe"); 
+                dxcPath = engine::pathClean(m_settings.compilerPathVulkan);
 
 #ifdef MULTITHREADED_SHADERCOMPILE
             std::for_each(
@@ -976,15 +1043,10 @@ namespace shadercompiler
                         return s;
                     };
 
-#ifdef MULTITHREADED_SHADERCOMPILE
-                    std::for_each(
-                        std::execution::par_unseq,
-                        stage.items.begin(),
-                        stage.items.end(),
-                        [&](auto&& item)
-#else
-                    for (auto&& item : stage.items)
-#endif
+                    auto profile = m_shaderProfiles[stage.name];
+
+                    // runs on the scheduler after this stage has been walked
+                    auto compileItem = [=, this, &locator, &stage](ShaderPipelineStageItem& item)
                     {
                         auto folder = engine::pathExtractFolder(binaryTarget);
                         auto permFile = engine::pathExtractFilename(item.permutationPath);
@@ -996,48 +1058,83 @@ namespace shadercompiler
                         engine::string supportString;
                         if (api == GraphicsApi::DX12)
                         {
-                            arguments = " /T " + m_shaderProfiles[stage.name] + " " + path + " " + outputFlags + " " + outputpath + " /Fd " + outputsymbols + " /setrootsignature " + rootSignaturePath;
+                            arguments = " /T " + profile + " " + path + " " + outputFlags + " " + outputpath + " /Fd " + outputsymbols + " /setrootsignature " + rootSignaturePath;
                             supportString = "dx12";
                         }
                         else if (api == GraphicsApi::Vulkan)
                         {
-                            arguments = " -T " + m_shaderProfiles[stage.name] + " " + path + " " + outputFlags + " " + outputpath;
+                            arguments = " -T " + profile + " " + path + " " + outputFlags + " " + outputpath;
                             supportString = "vulkan";
                         }
 
-                        if (m_logLevel == LogLevel::Recompile) LOG_PURE("Compiling %s", outputpath.c_str());
+                        // everything that goes into the binary
+                        auto sourceData = FileAccessSerializer::instance().readFile(path, true);
+                        auto outputHash = sha1(engine::string(sourceData.begin(), sourceData.end()));
+                        outputHash += dxcPath + arguments;
+                        if (api == GraphicsApi::DX12)
+                        {
+                            auto rootSignatureData = FileAccessSerializer::instance().readFile(engine::pathReplaceExtension(rootSignaturePath, "rs"), true);
+                            outputHash += sha1(engine::string(rootSignatureData.begin(), rootSignatureData.end()));
+                        }
+                        outputHash = sha1(outputHash);
+
+                        bool upToDate =
+                            !locator.forceCompileAll() &&
+                            engine::fileExists(outputpath) &&
+                            !locator.manifest().outputChanged(outputpath, outputHash);
 
-                        engine::Process process(dxcPath, arguments, engine::pathExtractFolder(engine::getExecutableDirectory()), [&](const engine::string& msg)
+                        if (upToDate)
+                            ++m_shadersSkipped;
+                        else
+                        {
+                            ++m_shadersCompiled;
+                            if (m_logLevel == LogLevel::Recompile) LOG_PURE("Compiling %s", outputpath.c_str());
+
+                            bool failed = false;
                             {
-                                auto cleanupMessage = [](const engine::string& msg)->engine::string
-                                {
-                                    auto lines = engine::tokenize(msg, { '\n' });
-                                    int removeLast = 0;
-                                    // remove uninteresting crud
-                                    for (auto line = lines.rbegin(); line != lines.rend(); ++line)
-                                    {
-                                        if (line->empty() || 
-                                            *line == "\n" || 
-                                            *line == "\r" ||
-                                            *line == "Exit code")
-                                            ++removeLast;
-                                        else
-                                            break;
-                                    }
-                                    lines.erase(lines.end() - removeLast, lines.end());
-
-                                    // remove too lengthy paths
-                                    for (auto&& line : lines)
+                                // in it's own scope so we wait for the execution to finish
+                                engine::Process process(dxcPath, arguments, engine::pathExtractFolder(engine::getExecutableDirectory()), [&](const engine::string& msg)
                                     {
-                                        auto testStr = engine::string("C:\\work\\darkness\\darkness-engine\\data\\shaders\\");
-                                        if (line.find(testStr) == 0)
-                                            line = line.substr(testStr.length(), line.length() - testStr.length());
-                                    }
-
-                                    return engine::join(lines, '\n');
-                                };
-                                if (doLog(LogLevel::Error)) LOG_PURE("%s", cleanupMessage(msg).c_str());
-                            });
+                                        if (msg.find("error") != engine::string::npos)
+                                            failed = true;
+
+                                        auto cleanupMessage = [](const engine::string& msg)->engine::string
+                                        {
+                                            auto lines = engine::tokenize(msg, { '\n' });
+                                            int removeLast = 0;
+                                            // remove uninteresting crud
+                                            for (auto line = lines.rbegin(); line != lines.rend(); ++line)
+                                            {
+                                                if (line->empty() || 
+                                                    *line == "\n" || 
+                                                    *line == "\r" ||
+                                                    *line == "Exit code")
+                                                    ++removeLast;
+                                                else
+                                                    break;
+                                            }
+                                            lines.erase(lines.end() - removeLast, lines.end());
+
+                                            // remove too lengthy paths
+                                            for (auto&& line : lines)
+                                            {
+                                                auto testStr = engine::string("C:\\work\\darkness\\darkness-engine\\data\\shaders\\");
+                                                if (line.find(testStr) == 0)
+                                                    line = line.substr(testStr.length(), line.length() - testStr.length());
+                                            }
+
+                                            return engine::join(lines, '\n');
+                                        };
+                                        if (doLog(LogLevel::Error)) LOG_PURE("%s", cleanupMessage(msg).c_str());
+                                    });
+                            }
+
+                            if (!failed && engine::fileExists(outputpath))
+                                locator.manifest().updateOutput(outputpath, outputHash);
+                            else
+                                locator.manifest().failSource(stage.filename);
+                        }
+
                         writeSupportFile(
                             engine::pathReplaceExtension(outputpath, "support"),
                             addSlash(outputpath),
@@ -1049,10 +1146,20 @@ namespace shadercompiler
                             addSlash(item.sourcePath),
                             stage.shaderIncludeDepencyPaths,
                             m_logLevel);
+                    };
+
+                    // dxc takes one input per process. batch permutations per job
+                    // so a small stage doesn't queue a job per permutation
+                    auto batchSize = static_cast<size_t>(std::max(m_settings.batchSize, 1));
+                    for (size_t first = 0; first < stage.items.size(); first += batchSize)
+                    {
+                        auto last = std::min(first + batchSize, stage.items.size());
+                        m_scheduler.add([&stage, compileItem, first, last]()
+                        {
+                            for (size_t i = first; i < last; ++i)
+                                compileItem(stage.items[i]);
+                        }, stage.priority);
                     }
-#ifdef MULTITHREADED_SHADERCOMPILE
-                    );
-#endif
                 }
             }// stage
 #ifdef MULTITHREADED_SHADERCOMPILE
@@ -1062,6 +1169,7 @@ namespace shadercompiler
 #ifdef MULTITHREADED_SHADERCOMPILE
         );
 #endif
+        m_scheduler.wait(api == GraphicsApi::DX12 ? "DX12 shaders" : "Vulkan shaders", m_logLevel);
     }
 
     void CompileTask::patchVulkanRegisters(ShaderLocator& locator)
@@ -1182,6 +1290,15 @@ namespace shadercompiler
 
     void CompileTask::createCodeInterfaces(ShaderLocator& locator)
     {
+        // the template processor skips outputs whose template data did not change
+        auto count = [&](bool written)
+        {
+            if (written)
+                ++m_interfacesWritten;
+            else
+                ++m_interfacesSkipped;
+        };
+
 #ifdef MULTITHREADED_CODEINTERFACES
         std::for_each(
             std::execution::par_unseq,
@@ -1223,21 +1340,21 @@ namespace shadercompiler
 
                     if (doLog(LogLevel::All)) LOG_PURE("Creating C++ Load interfaces for %s", engine::pathJoin(binFolderRelative, engine::pathExtractFilename(stage.filename)).c_str());
 
-                    shadercompiler::TemplateProcessor::ProcessShaderLoadInterfaces(
+                    count(shadercompiler::TemplateProcessor::ProcessShaderLoadInterfaces(
                         locator,
                         stage.filename,
                         locator.shaderLoadInterfaceTemplateHeader(),
                         hppFile,
                         stage,
-                        m_logLevel);
+                        m_logLevel));
 
-                    shadercompiler::TemplateProcessor::ProcessShaderLoadInterfaces(
+                    count(shadercompiler::TemplateProcessor::ProcessShaderLoadInterfaces(
                         locator,
                         stage.filename,
                         locator.shaderLoadInterfaceTemplateSource(),
                         cppFile,
                         stage,
-                        m_logLevel);
+                        m_logLevel));
                 }
             }
 #ifdef MULTITHREADED_CODEINTERFACES
@@ -1255,17 +1372,19 @@ namespace shadercompiler
 
                 if (doLog(LogLevel::All)) LOG_PURE("Creating C++ Pipeline interfaces for %s", engine::pathJoin(binFolderRelative, pipeline.pipelineName).c_str());
 
-                shadercompiler::TemplateProcessor::ProcessPipelineInterfaces(
+                count(shadercompiler::TemplateProcessor::ProcessPipelineInterfaces(
+                    locator,
                     locator.shaderPipelineInterfaceTemplateHeader(),
                     pipeline,
                     hppFile,
-                    m_logLevel);
+                    m_logLevel));
 
-                shadercompiler::TemplateProcessor::ProcessPipelineInterfaces(
+                count(shadercompiler::TemplateProcessor::ProcessPipelineInterfaces(
+                    locator,
                     locator.shaderPipelineInterfaceTemplateSource(),
                     pipeline,
                     cppFile,
-                    m_logLevel);
+                    m_logLevel));
             }
         }
 #ifdef MULTITHREADED_CODEINTERFACES
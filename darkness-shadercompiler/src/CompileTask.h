@@ -4,6 +4,8 @@
 #include "containers/unordered_map.h"
 #include "containers/string.h"
 #include "CompileSharedTypes.h"
+#include "CompileScheduler.h"
+#include <atomic>
 
 namespace shadercompiler
 {
@@ -12,21 +14,32 @@ namespace shadercompiler
     class CompileTask
     {
     public:
-        CompileTask(ShaderLocator& locator, bool optimization, LogLevel logLevel);
+        CompileTask(ShaderLocator& locator, bool optimization, LogLevel logLevel, const CompilerSettings& settings);
 
     private:
         void preprocessAndGetResources(ShaderLocator& locator);
-        void writeRootSignatures(ShaderLocator& locator) const;
+        void writeRootSignatures(ShaderLocator& locator);
         void writeRootSignature(std::ofstream& stream, const ShaderPipelineStage& stage) const;
-        void compileRootSignature(const engine::string& rs, const engine::string& rso) const;
+        bool compileRootSignature(const engine::string& rs, const engine::string& rso) const;
         void updateResourceRegisters(ShaderLocator& locator);
         void compile(ShaderLocator& locator, bool optimization, GraphicsApi api = GraphicsApi::DX12);
         void patchVulkanRegisters(ShaderLocator& locator);
         void createCodeInterfaces(ShaderLocator& locator);
+        void updateManifest(ShaderLocator& locator);
 
         LogLevel m_logLevel;
+        CompilerSettings m_settings;
+        CompileScheduler m_scheduler;
         engine::unordered_map<engine::string, engine::string> m_shaderProfiles;
 
+        // what the build manifest let us skip
+        std::atomic<int> m_rootSignaturesCompiled;
+        std::atomic<int> m_rootSignaturesSkipped;
+        std::atomic<int> m_shadersCompiled;
+        std::atomic<int> m_shadersSkipped;
+        std::atomic<int> m_interfacesWritten;
+        std::atomic<int> m_interfacesSkipped;
+
         bool doLog(LogLevel level) const;
     };
 }
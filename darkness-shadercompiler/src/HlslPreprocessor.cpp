@@ -0,0 +1,1210 @@
+#include "HlslPreprocessor.h"
+#include "Helpers.h"
+#include "tools/PathTools.h"
+#include "tools/Debug.h"
+#include "platform/File.h"
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+
+namespace shadercompiler
+{
+    namespace
+    {
+        constexpr int MaxIncludeDepth = 200;
+
+        const char* Punctuators[] = {
+            ">>=", "<<=", "...",
+            "->", "++", "--", "<<", ">>", "<=", ">=", "==", "!=", "&&", "||",
+            "*=", "/=", "%=", "+=", "-=", "&=", "^=", "|=", "##", "::" };
+
+        bool isIdentifierStart(char c)
+        {
+            return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+        }
+
+        bool isIdentifierChar(char c)
+        {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+        }
+
+        bool isDigit(char c)
+        {
+            return std::isdigit(static_cast<unsigned char>(c)) != 0;
+        }
+
+        bool isPunctuator(const SourceToken& token, const char* text)
+        {
+            return token.type == SourceTokenType::Punctuator && token.text == text;
+        }
+
+        SourceTokenType classify(const engine::string& text)
+        {
+            if (text.empty())
+                return SourceTokenType::Other;
+            if (isIdentifierStart(text[0]))
+                return SourceTokenType::Identifier;
+            if (isDigit(text[0]) || (text[0] == '.' && text.size() > 1 && isDigit(text[1])))
+                return SourceTokenType::Number;
+            if (text[0] == '"' || text[0] == '\'')
+                return SourceTokenType::String;
+            if (strchr("!%&*+,-./:;<=>?[]^{|}~()#", text[0]))
+                return SourceTokenType::Punctuator;
+            return SourceTokenType::Other;
+        }
+
+        struct SourceChar
+        {
+            char ch;
+            int line;
+            int column;
+        };
+
+        // drops carriage returns and joins lines ending with a backslash
+        engine::vector<SourceChar> spliceLines(const engine::vector<char>& data)
+        {
+            engine::vector<SourceChar> result;
+            result.reserve(data.size());
+            int line = 1;
+            int column = 1;
+            for (size_t i = 0; i < data.size() && data[i] != 0; ++i)
+            {
+                char c = data[i];
+                if (c == '\r')
+                    continue;
+                if (c == '\\')
+                {
+                    size_t next = i + 1;
+                    if (next < data.size() && data[next] == '\r')
+                        ++next;
+                    if (next < data.size() && data[next] == '\n')
+                    {
+                        i = next;
+                        ++line;
+                        column = 1;
+                        continue;
+                    }
+                }
+                result.emplace_back(SourceChar{ c, line, column });
+                if (c == '\n')
+                {
+                    ++line;
+                    column = 1;
+                }
+                else
+                    ++column;
+            }
+            return result;
+        }
+
+        engine::shared_ptr<SourceFile> tokenize(const engine::string& path, engine::vector<char>&& data)
+        {
+            auto file = engine::make_shared<SourceFile>();
+            file->path = path;
+            file->data = std::move(data);
+
+            auto chars = spliceLines(file->data);
+            auto at = [&](size_t index)->char { return index < chars.size() ? chars[index].ch : 0; };
+
+            SourceLine current{ {}, false };
+            bool space = false;
+            auto endLine = [&]()
+            {
+                if (current.tokens.size() > 0)
+                {
+                    current.directive = isPunctuator(current.tokens[0], "#");
+                    file->lines.emplace_back(std::move(current));
+                    current = SourceLine{ {}, false };
+                }
+                space = false;
+            };
+
+            size_t i = 0;
+            while (i < chars.size())
+            {
+                char c = chars[i].ch;
+                if (c == '\n')
+                {
+                    endLine();
+                    ++i;
+                    continue;
+                }
+                if (c == ' ' || c == '\t' || c == '\v' || c == '\f')
+                {
+                    space = true;
+                    ++i;
+                    continue;
+                }
+                if (c == '/' && at(i + 1) == '/')
+                {
+                    while (i < chars.size() && chars[i].ch != '\n')
+                        ++i;
+                    space = true;
+                    continue;
+                }
+                if (c == '/' && at(i + 1) == '*')
+                {
+                    // newlines inside the comment do not end the line
+                    i += 2;
+                    while (i < chars.size() && !(chars[i].ch == '*' && at(i + 1) == '/'))
+                        ++i;
+                    i = std::min(i + 2, chars.size());
+                    space = true;
+                    continue;
+                }
+
+                SourceToken token{
+                    SourceTokenType::Other, "",
+                    chars[i].line, chars[i].column,
+                    space, current.tokens.size() == 0, false, {} };
+
+                size_t start = i;
+                if (isIdentifierStart(c))
+                {
+                    while (isIdentifierChar(at(i)))
+                        ++i;
+                    token.type = SourceTokenType::Identifier;
+                }
+                else if (isDigit(c) || (c == '.' && isDigit(at(i + 1))))
+                {
+                    // pp-number
+                    ++i;
+                    while (true)
+                    {
+                        char n = at(i);
+                        char p = at(i - 1);
+                        if ((n == '+' || n == '-') && (p == 'e' || p == 'E' || p == 'p' || p == 'P'))
+                            ++i;
+                        else if (isIdentifierChar(n) || n == '.')
+                            ++i;
+                        else
+                            break;
+                    }
+                    token.type = SourceTokenType::Number;
+                }
+                else if (c == '"' || c == '\'')
+                {
+                    ++i;
+                    while (i < chars.size() && chars[i].ch != c && chars[i].ch != '\n')
+                    {
+                        if (chars[i].ch == '\\' && at(i + 1) != '\n')
+                            ++i;
+                        ++i;
+                    }
+                    if (at(i) == c)
+                        ++i;
+                    token.type = SourceTokenType::String;
+                }
+                else
+                {
+                    size_t length = 1;
+                    for (auto&& punctuator : Punctuators)
+                    {
+                        size_t punctuatorLength = strlen(punctuator);
+                        size_t k = 0;
+                        while (k < punctuatorLength && at(i + k) == punctuator[k])
+                            ++k;
+                        if (k == punctuatorLength)
+                        {
+                            length = punctuatorLength;
+                            break;
+                        }
+                    }
+                    i += length;
+                    token.type = classify(engine::string(1, c));
+                }
+
+                token.text.reserve(i - start);
+                for (size_t k = start; k < i; ++k)
+                    token.text += chars[k].ch;
+
+                current.tokens.emplace_back(std::move(token));
+                space = false;
+            }
+            endLine();
+
+            // clang places the end of file token after the last newline
+            file->lastLine = 1;
+            if (chars.size() > 0)
+                file->lastLine = chars.back().line + (chars.back().ch == '\n' ? 1 : 0);
+            return file;
+        }
+
+        engine::vector<SourceToken> tokenizeText(const engine::string& text)
+        {
+            auto file = tokenize("", engine::vector<char>(text.begin(), text.end()));
+            if (file->lines.size() == 0)
+                return {};
+            return file->lines[0].tokens;
+        }
+
+        engine::string escape(const engine::string& text)
+        {
+            engine::string result;
+            result.reserve(text.size());
+            for (auto&& c : text)
+            {
+                if (c == '\\' || c == '"')
+                    result += '\\';
+                result += c;
+            }
+            return result;
+        }
+
+        SourceToken numberToken(int64_t value, const SourceToken& location)
+        {
+            return SourceToken{
+                SourceTokenType::Number, std::to_string(value),
+                location.line, location.column,
+                location.space, location.startOfLine, location.expanded, {} };
+        }
+
+        bool hidden(const SourceToken& token, const engine::string& name)
+        {
+            return std::find(token.hide.begin(), token.hide.end(), name) != token.hide.end();
+        }
+
+        // #if expressions. identifiers left after macro expansion are zero.
+        struct ExpressionParser
+        {
+            const engine::vector<SourceToken>& tokens;
+            size_t index;
+            bool error;
+
+            bool accept(const char* text)
+            {
+                if (index < tokens.size() && isPunctuator(tokens[index], text))
+                {
+                    ++index;
+                    return true;
+                }
+                return false;
+            }
+
+            int64_t number(const engine::string& text)
+            {
+                if (text[0] == '\'')
+                {
+                    if (text.size() > 3 && text[1] == '\\')
+                    {
+                        switch (text[2])
+                        {
+                            case 'n': return '\n';
+                            case 't': return '\t';
+                            case 'r': return '\r';
+                            case '0': return 0;
+                            default: return text[2];
+                        }
+                    }
+                    return text.size() > 2 ? text[1] : 0;
+                }
+                auto digits = text;
+                while (digits.size() > 0 && strchr("uUlL", digits.back()))
+                    digits.pop_back();
+                char* end = nullptr;
+                auto value = static_cast<int64_t>(strtoull(digits.c_str(), &end, 0));
+                if (!end || *end != 0)
+                    error = true;
+                return value;
+            }
+
+            int64_t primary()
+            {
+                if (index >= tokens.size())
+                {
+                    error = true;
+                    return 0;
+                }
+                auto& token = tokens[index++];
+                if (isPunctuator(token, "("))
+                {
+                    auto value = conditional();
+                    if (!accept(")"))
+                        error = true;
+                    return value;
+                }
+                if (token.type == SourceTokenType::Number || (token.type == SourceTokenType::String && token.text[0] == '\''))
+                    return number(token.text);
+                if (token.type == SourceTokenType::Identifier)
+                    return token.text == "true" ? 1 : 0;
+                error = true;
+                return 0;
+            }
+
+            int64_t unary()
+            {
+                if (accept("!")) return !unary();
+                if (accept("~")) return ~unary();
+                if (accept("-")) return -unary();
+                if (accept("+")) return unary();
+                return primary();
+            }
+
+            static int precedence(const engine::string& op)
+            {
+                if (op == "*" || op == "/" || op == "%") return 10;
+                if (op == "+" || op == "-") return 9;
+                if (op == "<<" || op == ">>") return 8;
+                if (op == "<" || op == ">" || op == "<=" || op == ">=") return 7;
+                if (op == "==" || op == "!=") return 6;
+                if (op == "&") return 5;
+                if (op == "^") return 4;
+                if (op == "|") return 3;
+                if (op == "&&") return 2;
+                if (op == "||") return 1;
+                return 0;
+            }
+
+            static int64_t apply(const engine::string& op, int64_t a, int64_t b)
+            {
+                if (op == "*") return a * b;
+                if (op == "/") return b != 0 ? a / b : 0;
+                if (op == "%") return b != 0 ? a % b : 0;
+                if (op == "+") return a + b;
+                if (op == "-") return a - b;
+                if (op == "<<") return a << b;
+                if (op == ">>") return a >> b;
+                if (op == "<") return a < b;
+                if (op == ">") return a > b;
+                if (op == "<=") return a <= b;
+                if (op == ">=") return a >= b;
+                if (op == "==") return a == b;
+                if (op == "!=") return a != b;
+                if (op == "&") return a & b;
+                if (op == "^") return a ^ b;
+                if (op == "|") return a | b;
+                if (op == "&&") return a && b;
+                return a || b;
+            }
+
+            int64_t binary(int minimum)
+            {
+                auto left = unary();
+                while (index < tokens.size() && tokens[index].type == SourceTokenType::Punctuator)
+                {
+                    const auto& op = tokens[index].text;
+                    auto opPrecedence = precedence(op);
+                    if (opPrecedence == 0 || opPrecedence < minimum)
+                        break;
+                    ++index;
+                    auto right = binary(opPrecedence + 1);
+                    left = apply(op, left, right);
+                }
+                return left;
+            }
+
+            int64_t conditional()
+            {
+                auto condition = binary(1);
+                if (accept("?"))
+                {
+                    auto a = conditional();
+                    if (!accept(":"))
+                        error = true;
+                    auto b = conditional();
+                    return condition ? a : b;
+                }
+                return condition;
+            }
+        };
+    }
+
+    engine::shared_ptr<const SourceFile> SourceFileCache::file(const engine::string& path)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto existing = m_files.find(path);
+            if (existing != m_files.end())
+                return existing->second;
+        }
+
+        if (!engine::fileExists(path))
+            return nullptr;
+
+        // tokenized outside of the lock. if two threads race the first one wins
+        engine::shared_ptr<const SourceFile> file = tokenize(path, FileAccessSerializer::instance().readFile(path));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto existing = m_files.find(path);
+        if (existing != m_files.end())
+            return existing->second;
+        m_files[path] = file;
+        return file;
+    }
+
+    class HlslPreprocessor::Context
+    {
+    public:
+        Context(const HlslPreprocessor& preprocessor)
+            : m_preprocessor{ preprocessor }
+            , m_macros{ preprocessor.m_macros }
+            , m_currentLine{ 1 }
+            , m_initialized{ false }
+            , m_emittedTokens{ false }
+            , m_emittedDirective{ false }
+            , m_depth{ 0 }
+            , m_previous{ SourceTokenType::Other, "", 0, 0, false, false, false, {} }
+            , m_previousPrevious{ m_previous }
+        {}
+
+        engine::vector<engine::string> run(const engine::string& filepath)
+        {
+            auto path = engine::pathClean(filepath);
+            auto file = SourceFileCache::instance().file(path);
+            if (!file)
+            {
+                LOG_PURE("%s: error: could not open file", filepath.c_str());
+                return {};
+            }
+
+            enterFile(filepath, 0);
+            processFile(*file);
+
+            // end of file token
+            if (m_emittedDirective)
+            {
+                startNewLineIfNeeded(true);
+                moveToLine(file->lastLine);
+            }
+            moveToLine(file->lastLine);
+            m_output += '\n';
+
+            return readLines(m_output);
+        }
+
+    private:
+        using TokenQueue = std::deque<SourceToken>;
+
+        const HlslPreprocessor& m_preprocessor;
+        engine::unordered_map<engine::string, Macro> m_macros;
+        engine::unordered_map<engine::string, bool> m_once;
+
+        // output state, see clang PrintPreprocessedOutput
+        engine::string m_output;
+        engine::string m_filename;
+        int m_currentLine;
+        bool m_initialized;
+        bool m_emittedTokens;
+        bool m_emittedDirective;
+        int m_depth;
+        SourceToken m_previous;
+        SourceToken m_previousPrevious;
+
+        static engine::vector<engine::string> readLines(const engine::string& text)
+        {
+            engine::vector<engine::string> lines;
+            size_t start = 0;
+            while (start < text.size())
+            {
+                auto end = text.find('\n', start);
+                if (end == engine::string::npos)
+                    end = text.size() - 1;
+                lines.emplace_back(text.substr(start, end - start + 1));
+                start = end + 1;
+            }
+            return lines;
+        }
+
+        bool startNewLineIfNeeded(bool updateLine)
+        {
+            if (m_emittedTokens || m_emittedDirective)
+            {
+                m_output += '\n';
+                m_emittedTokens = false;
+                m_emittedDirective = false;
+                if (updateLine)
+                    ++m_currentLine;
+                return true;
+            }
+            return false;
+        }
+
+        void writeLineInfo(int line)
+        {
+            startNewLineIfNeeded(false);
+            m_output += "#line " + std::to_string(line) + " \"" + m_filename + "\"\n";
+        }
+
+        bool moveToLine(int line)
+        {
+            // unsigned like clang so that moving backwards writes a marker
+            auto distance = static_cast<unsigned>(line) - static_cast<unsigned>(m_currentLine);
+            if (distance <= 8)
+            {
+                if (distance == 0)
+                    return false;
+                m_output.append(distance, '\n');
+            }
+            else
+                writeLineInfo(line);
+            m_currentLine = line;
+            return true;
+        }
+
+        void enterFile(const engine::string& path, int includeLine)
+        {
+            if (includeLine > 0)
+                moveToLine(includeLine);
+            m_currentLine = 1;
+            m_filename = escape(path);
+
+            // the main file gets a single marker
+            if (!m_initialized)
+            {
+                m_initialized = true;
+                writeLineInfo(1);
+                return;
+            }
+            writeLineInfo(1);
+        }
+
+        void exitFile(const engine::string& filename, int line)
+        {
+            m_currentLine = line;
+            m_filename = filename;
+            writeLineInfo(line);
+        }
+
+        bool avoidConcat(const SourceToken& token) const
+        {
+            // tokens read from the source without a space were adjacent
+            if (!m_previous.expanded && !token.expanded)
+                return false;
+
+            const auto& previous = m_previous.text;
+            char first = token.text.size() > 0 ? token.text[0] : 0;
+            switch (m_previous.type)
+            {
+                case SourceTokenType::Identifier:
+                    return isIdentifierChar(first);
+                case SourceTokenType::Number:
+                {
+                    char last = previous.back();
+                    return isIdentifierChar(first) || first == '.' ||
+                        ((first == '+' || first == '-') && (last == 'e' || last == 'E' || last == 'p' || last == 'P'));
+                }
+                case SourceTokenType::Punctuator:
+                {
+                    if (previous == ".") return (first == '.' && isPunctuator(m_previousPrevious, ".")) || isDigit(first) || first == '*';
+                    if (previous == "&") return first == '&' || first == '=';
+                    if (previous == "+") return first == '+' || first == '=';
+                    if (previous == "-") return first == '-' || first == '=' || first == '>';
+                    if (previous == "/") return first == '=' || first == '*' || first == '/';
+                    if (previous == "<") return first == '<' || first == '=' || first == ':' || first == '%';
+                    if (previous == ">") return first == '>' || first == '=';
+                    if (previous == "|") return first == '|' || first == '=';
+                    if (previous == ":") return first == ':' || first == '>';
+                    if (previous == "#") return first == '#' || first == '@' || first == '%';
+                    if (previous == "%") return first == '>' || first == '=' || first == ':';
+                    if (previous == "*" || previous == "!" || previous == "^" || previous == "=") return first == '=';
+                    if (previous == "<<" || previous == ">>") return first == '=';
+                    if (previous == "->") return first == '*';
+                    return false;
+                }
+                default:
+                    return false;
+            }
+        }
+
+        bool handleFirstTokenOnLine(const SourceToken& token)
+        {
+            if (!moveToLine(token.line))
+                return false;
+
+            auto column = token.column;
+            if (column == 1 && token.space)
+                column = 2;
+            if (column <= 1 && token.text == "#")
+                m_output += ' ';
+            if (column > 1)
+                m_output.append(static_cast<size_t>(column - 1), ' ');
+            return true;
+        }
+
+        void printToken(const SourceToken& token)
+        {
+            if (m_emittedDirective)
+            {
+                startNewLineIfNeeded(true);
+                moveToLine(token.line);
+            }
+
+            if (token.startOfLine && handleFirstTokenOnLine(token))
+            {
+            }
+            else if (token.space || (m_emittedTokens && avoidConcat(token)))
+                m_output += ' ';
+
+            m_output += token.text;
+            m_emittedTokens = true;
+            m_previousPrevious = std::move(m_previous);
+            m_previous = token;
+        }
+
+        SourceToken stringify(const engine::vector<SourceToken>& tokens, const SourceToken& hash) const
+        {
+            engine::string text = "\"";
+            for (size_t i = 0; i < tokens.size(); ++i)
+            {
+                if (i > 0 && tokens[i].space)
+                    text += ' ';
+                if (tokens[i].type == SourceTokenType::String)
+                    text += escape(tokens[i].text);
+                else
+                    text += tokens[i].text;
+            }
+            text += '"';
+            return SourceToken{ SourceTokenType::String, text, hash.line, hash.column, hash.space, false, true, {} };
+        }
+
+        engine::vector<SourceToken> substitute(
+            const Macro& macro,
+            const engine::vector<engine::vector<SourceToken>>& arguments,
+            const engine::vector<engine::vector<SourceToken>>& expandedArguments) const
+        {
+            auto parameter = [&](const SourceToken& token)->int
+            {
+                if (!macro.function || token.type != SourceTokenType::Identifier)
+                    return -1;
+                for (size_t i = 0; i < macro.parameters.size(); ++i)
+                    if (macro.parameters[i] == token.text)
+                        return static_cast<int>(i);
+                return -1;
+            };
+
+            engine::vector<SourceToken> result;
+
+            // left side of a ## was an empty argument
+            bool pasteEmpty = false;
+
+            auto& body = macro.body;
+            for (size_t i = 0; i < body.size(); ++i)
+            {
+                auto& token = body[i];
+                bool pasteNext = i + 1 < body.size() && isPunctuator(body[i + 1], "##");
+
+                if (macro.function && isPunctuator(token, "#") && i + 1 < body.size() && parameter(body[i + 1]) >= 0)
+                {
+                    result.emplace_back(stringify(arguments[parameter(body[i + 1])], token));
+                    pasteEmpty = false;
+                    ++i;
+                    continue;
+                }
+
+                if (isPunctuator(token, "##") && i + 1 < body.size())
+                {
+                    auto& next = body[i + 1];
+                    ++i;
+
+                    engine::vector<SourceToken> right;
+                    auto index = parameter(next);
+                    if (index >= 0)
+                        right = arguments[index];
+                    else
+                        right.emplace_back(next);
+
+                    if (right.empty())
+                        continue;
+                    if (pasteEmpty || result.empty())
+                    {
+                        pasteEmpty = false;
+                        result.insert(result.end(), right.begin(), right.end());
+                        continue;
+                    }
+                    result.back().text += right[0].text;
+                    result.back().type = classify(result.back().text);
+                    result.insert(result.end(), right.begin() + 1, right.end());
+                    continue;
+                }
+
+                auto index = parameter(token);
+                if (index >= 0)
+                {
+                    auto& tokens = pasteNext ? arguments[index] : expandedArguments[index];
+                    pasteEmpty = pasteNext && arguments[index].empty();
+                    auto first = result.size();
+                    result.insert(result.end(), tokens.begin(), tokens.end());
+                    if (result.size() > first)
+                        result[first].space = token.space;
+                    continue;
+                }
+
+                pasteEmpty = false;
+                result.emplace_back(token);
+            }
+            return result;
+        }
+
+        // collects the arguments of a function like macro invocation.
+        // pending[0] is the opening parenthesis. returns the count of tokens
+        // used or zero if the invocation did not end.
+        size_t collectArguments(
+            const Macro& macro,
+            TokenQueue& pending,
+            const std::function<bool()>& pull,
+            engine::vector<engine::vector<SourceToken>>& arguments) const
+        {
+            arguments.clear();
+            arguments.emplace_back();
+            int depth = 0;
+            size_t index = 1;
+            while (true)
+            {
+                if (index >= pending.size())
+                {
+                    if (!pull())
+                        return 0;
+                    continue;
+                }
+
+                auto& token = pending[index];
+                if (isPunctuator(token, "("))
+                    ++depth;
+                else if (isPunctuator(token, ")"))
+                {
+                    if (depth == 0)
+                        return index + 1;
+                    --depth;
+                }
+                else if (isPunctuator(token, ",") && depth == 0 &&
+                    !(macro.variadic && arguments.size() == macro.parameters.size()))
+                {
+                    arguments.emplace_back();
+                    ++index;
+                    continue;
+                }
+                arguments.back().emplace_back(token);
+                ++index;
+            }
+        }
+
+        // expands the macros of pending and hands out the result. pull is
+        // called when a function like macro invocation continues on the
+        // next line.
+        void expand(
+            TokenQueue& pending,
+            const std::function<bool()>& pull,
+            const std::function<void(const SourceToken&)>& emit)
+        {
+            engine::vector<engine::vector<SourceToken>> arguments;
+            while (pending.size() > 0)
+            {
+                SourceToken token = std::move(pending.front());
+                pending.pop_front();
+
+                if (token.type != SourceTokenType::Identifier)
+                {
+                    emit(token);
+                    continue;
+                }
+
+                auto macro = m_macros.find(token.text);
+                if (macro == m_macros.end())
+                {
+                    if (token.text == "__LINE__")
+                        token = numberToken(token.line, token);
+                    else if (token.text == "__FILE__")
+                    {
+                        token.text = "\"" + m_filename + "\"";
+                        token.type = SourceTokenType::String;
+                    }
+                    emit(token);
+                    continue;
+                }
+                if (hidden(token, token.text))
+                {
+                    emit(token);
+                    continue;
+                }
+
+                engine::vector<SourceToken> replacement;
+                if (macro->second.function)
+                {
+                    // the invocation may start on the next line
+                    if (pending.empty())
+                        pull();
+                    if (pending.empty() || !isPunctuator(pending.front(), "("))
+                    {
+                        emit(token);
+                        continue;
+                    }
+
+                    auto used = collectArguments(macro->second, pending, pull, arguments);
+                    if (used == 0)
+                    {
+                        LOG_PURE("%s(%i): error: unterminated function-like macro invocation of %s",
+                            m_filename.c_str(), token.line, token.text.c_str());
+                        emit(token);
+                        continue;
+                    }
+
+                    auto& parameters = macro->second.parameters;
+                    if (parameters.size() == 0 && arguments.size() == 1 && arguments[0].empty())
+                        arguments.clear();
+                    if (macro->second.variadic && arguments.size() + 1 == parameters.size())
+                        arguments.emplace_back();
+                    if (arguments.size() != parameters.size())
+                    {
+                        LOG_PURE("%s(%i): error: macro %s expects %i arguments, %i given",
+                            m_filename.c_str(), token.line, token.text.c_str(),
+                            static_cast<int>(parameters.size()), static_cast<int>(arguments.size()));
+                        emit(token);
+                        continue;
+                    }
+                    pending.erase(pending.begin(), pending.begin() + used);
+
+                    engine::vector<engine::vector<SourceToken>> expandedArguments;
+                    for (auto&& argument : arguments)
+                        expandedArguments.emplace_back(expandIsolated(argument));
+
+                    replacement = substitute(macro->second, arguments, expandedArguments);
+                }
+                else
+                    replacement = substitute(macro->second, {}, {});
+
+                for (auto&& result : replacement)
+                {
+                    result.line = token.line;
+                    result.column = token.column;
+                    result.startOfLine = false;
+                    result.expanded = true;
+                    result.hide.insert(result.hide.end(), token.hide.begin(), token.hide.end());
+                    result.hide.emplace_back(token.text);
+                }
+
+                if (replacement.size() > 0)
+                {
+                    replacement[0].startOfLine = token.startOfLine;
+                    replacement[0].space = token.space;
+                    pending.insert(pending.begin(), replacement.begin(), replacement.end());
+                }
+                else if (pending.size() > 0)
+                {
+                    // an empty expansion leaves its whitespace to the next token
+                    pending.front().startOfLine = pending.front().startOfLine || token.startOfLine;
+                    pending.front().space = pending.front().space || token.space;
+                }
+            }
+        }
+
+        engine::vector<SourceToken> expandIsolated(const engine::vector<SourceToken>& tokens)
+        {
+            TokenQueue pending(tokens.begin(), tokens.end());
+            engine::vector<SourceToken> result;
+            expand(pending, []() { return false; }, [&](const SourceToken& token) { result.emplace_back(token); });
+            return result;
+        }
+
+        bool evaluate(const engine::vector<SourceToken>& tokens)
+        {
+            engine::vector<SourceToken> expression;
+            for (size_t i = 2; i < tokens.size(); ++i)
+            {
+                if (tokens[i].text == "defined")
+                {
+                    bool parenthesis = i + 1 < tokens.size() && isPunctuator(tokens[i + 1], "(");
+                    size_t name = i + (parenthesis ? 2 : 1);
+                    bool defined = name < tokens.size() && m_macros.find(tokens[name].text) != m_macros.end();
+                    expression.emplace_back(numberToken(defined ? 1 : 0, tokens[i]));
+                    i = name + (parenthesis ? 1 : 0);
+                    continue;
+                }
+                expression.emplace_back(tokens[i]);
+            }
+
+            expression = expandIsolated(expression);
+            ExpressionParser parser{ expression, 0, false };
+            auto value = parser.conditional();
+            if (parser.error || parser.index != expression.size())
+            {
+                LOG_PURE("%s(%i): error: invalid preprocessor expression", m_filename.c_str(), tokens[0].line);
+                return false;
+            }
+            return value != 0;
+        }
+
+        void define(const engine::vector<SourceToken>& tokens)
+        {
+            if (tokens.size() < 3 || tokens[2].type != SourceTokenType::Identifier)
+            {
+                LOG_PURE("%s(%i): error: macro name missing", m_filename.c_str(), tokens[0].line);
+                return;
+            }
+
+            Macro macro{ false, false, {}, {} };
+            size_t index = 3;
+            if (index < tokens.size() && isPunctuator(tokens[index], "(") && !tokens[index].space)
+            {
+                macro.function = true;
+                ++index;
+                while (index < tokens.size() && !isPunctuator(tokens[index], ")"))
+                {
+                    auto& token = tokens[index];
+                    if (isPunctuator(token, "..."))
+                    {
+                        macro.variadic = true;
+                        macro.parameters.emplace_back("__VA_ARGS__");
+                    }
+                    else if (token.type == SourceTokenType::Identifier)
+                    {
+                        macro.parameters.emplace_back(token.text);
+                        if (index + 1 < tokens.size() && isPunctuator(tokens[index + 1], "..."))
+                        {
+                            macro.variadic = true;
+                            ++index;
+                        }
+                    }
+                    ++index;
+                }
+                ++index;
+            }
+
+            if (index < tokens.size())
+                macro.body.assign(tokens.begin() + index, tokens.end());
+            for (auto&& token : macro.body)
+                token.startOfLine = false;
+
+            m_macros[tokens[2].text] = std::move(macro);
+        }
+
+        engine::string resolve(const engine::string& include, bool angled, const engine::string& current) const
+        {
+            if (!angled)
+            {
+                auto candidate = engine::pathClean(engine::pathJoin(engine::pathExtractFolder(current), include));
+                if (engine::fileExists(candidate))
+                    return candidate;
+            }
+            for (auto&& includePath : m_preprocessor.m_includePaths)
+            {
+                auto candidate = engine::pathClean(engine::pathJoin(includePath, include));
+                if (engine::fileExists(candidate))
+                    return candidate;
+            }
+            return "";
+        }
+
+        void include(const engine::vector<SourceToken>& tokens, const SourceFile& file)
+        {
+            engine::vector<SourceToken> operand(tokens.begin() + std::min(tokens.size(), static_cast<size_t>(2)), tokens.end());
+            if (operand.size() > 0 && operand[0].type != SourceTokenType::String && !isPunctuator(operand[0], "<"))
+                operand = expandIsolated(operand);
+
+            engine::string name;
+            bool angled = false;
+            if (operand.size() > 0 && operand[0].type == SourceTokenType::String && operand[0].text.size() >= 2)
+                name = operand[0].text.substr(1, operand[0].text.size() - 2);
+            else if (operand.size() > 0 && isPunctuator(operand[0], "<"))
+            {
+                angled = true;
+                for (size_t i = 1; i < operand.size() && !isPunctuator(operand[i], ">"); ++i)
+                {
+                    if (i > 1 && operand[i].space)
+                        name += ' ';
+                    name += operand[i].text;
+                }
+            }
+            if (name.empty())
+            {
+                LOG_PURE("%s(%i): error: expected \"FILENAME\" or <FILENAME>", m_filename.c_str(), tokens[0].line);
+                return;
+            }
+
+            auto path = resolve(name, angled, file.path);
+            auto source = path.empty() ? nullptr : SourceFileCache::instance().file(path);
+            if (!source)
+            {
+                LOG_PURE("%s(%i): fatal error: '%s' file not found", m_filename.c_str(), tokens[0].line, name.c_str());
+                return;
+            }
+            if (m_once.find(path) != m_once.end())
+                return;
+            if (m_depth >= MaxIncludeDepth)
+            {
+                LOG_PURE("%s(%i): fatal error: #include nested too deeply", m_filename.c_str(), tokens[0].line);
+                return;
+            }
+
+            ++m_depth;
+            auto parent = m_filename;
+            enterFile(path, tokens[0].line);
+            processFile(*source);
+            exitFile(parent, tokens.back().line + 1);
+            --m_depth;
+        }
+
+        void pragma(const engine::vector<SourceToken>& tokens, const SourceFile& file)
+        {
+            if (tokens.size() > 2 && tokens[2].text == "once")
+            {
+                m_once[file.path] = true;
+                return;
+            }
+
+            // unknown pragmas are passed on for the compiler
+            startNewLineIfNeeded(true);
+            moveToLine(tokens[0].line);
+            m_output += "#pragma";
+            for (size_t i = 2; i < tokens.size(); ++i)
+            {
+                if (tokens[i].space)
+                    m_output += ' ';
+                m_output += tokens[i].text;
+            }
+            m_emittedDirective = true;
+        }
+
+        engine::string directiveText(const engine::vector<SourceToken>& tokens) const
+        {
+            engine::string text;
+            for (size_t i = 2; i < tokens.size(); ++i)
+            {
+                if (i > 2 && tokens[i].space)
+                    text += ' ';
+                text += tokens[i].text;
+            }
+            return text;
+        }
+
+        void processText(const SourceFile& file, size_t& index)
+        {
+            auto& tokens = file.lines[index].tokens;
+            TokenQueue pending(tokens.begin(), tokens.end());
+            expand(pending,
+                [&]()->bool
+                {
+                    if (index + 1 >= file.lines.size() || file.lines[index + 1].directive)
+                        return false;
+                    ++index;
+                    auto& next = file.lines[index].tokens;
+                    pending.insert(pending.end(), next.begin(), next.end());
+                    return true;
+                },
+                [&](const SourceToken& token) { printToken(token); });
+        }
+
+        void processFile(const SourceFile& file)
+        {
+            struct Conditional
+            {
+                bool parentActive;
+                bool active;
+                bool taken;
+                bool sawElse;
+            };
+            engine::vector<Conditional> conditionals;
+            auto active = [&]() { return conditionals.empty() || conditionals.back().active; };
+
+            for (size_t index = 0; index < file.lines.size(); ++index)
+            {
+                auto& line = file.lines[index];
+                if (!line.directive)
+                {
+                    if (active())
+                        processText(file, index);
+                    continue;
+                }
+
+                auto& tokens = line.tokens;
+                auto lineNumber = tokens[0].line;
+                engine::string name = tokens.size() > 1 ? tokens[1].text : "";
+
+                if (name == "if" || name == "ifdef" || name == "ifndef")
+                {
+                    bool parentActive = active();
+                    bool value = false;
+                    if (parentActive)
+                    {
+                        if (name == "if")
+                            value = evaluate(tokens);
+                        else
+                        {
+                            bool defined = tokens.size() > 2 && m_macros.find(tokens[2].text) != m_macros.end();
+                            value = (name == "ifdef") == defined;
+                        }
+                    }
+                    conditionals.emplace_back(Conditional{ parentActive, value, value, false });
+                    continue;
+                }
+                if (name == "elif" || name == "else" || name == "endif")
+                {
+                    if (conditionals.empty())
+                    {
+                        LOG_PURE("%s(%i): error: #%s without #if", m_filename.c_str(), lineNumber, name.c_str());
+                        continue;
+                    }
+                    auto& conditional = conditionals.back();
+                    if (name == "endif")
+                        conditionals.pop_back();
+                    else if (conditional.sawElse)
+                        LOG_PURE("%s(%i): error: #%s after #else", m_filename.c_str(), lineNumber, name.c_str());
+                    else if (name == "elif")
+                    {
+                        conditional.active = conditional.parentActive && !conditional.taken && evaluate(tokens);
+                        conditional.taken = conditional.taken || conditional.active;
+                    }
+                    else
+                    {
+                        conditional.active = conditional.parentActive && !conditional.taken;
+                        conditional.taken = true;
+                        conditional.sawElse = true;
+                    }
+                    continue;
+                }
+                if (!active())
+                    continue;
+
+                if (name == "define")
+                    define(tokens);
+                else if (name == "undef")
+                {
+                    if (tokens.size() > 2)
+                        m_macros.erase(tokens[2].text);
+                }
+                else if (name == "include")
+                    include(tokens, file);
+                else if (name == "pragma")
+                    pragma(tokens, file);
+                else if (name == "error")
+                    LOG_PURE("%s(%i): error: %s", m_filename.c_str(), lineNumber, directiveText(tokens).c_str());
+                else if (name == "warning")
+                    LOG_PURE("%s(%i): warning: %s", m_filename.c_str(), lineNumber, directiveText(tokens).c_str());
+                else if (name == "line")
+                    LOG_PURE("%s(%i): warning: #line is ignored", m_filename.c_str(), lineNumber);
+                else if (name != "")
+                    LOG_PURE("%s(%i): error: invalid preprocessing directive #%s", m_filename.c_str(), lineNumber, name.c_str());
+            }
+
+            if (conditionals.size() > 0)
+                LOG_PURE("%s: error: unterminated conditional directive", m_filename.c_str());
+        }
+    };
+
+    HlslPreprocessor::HlslPreprocessor(
+        const engine::vector<engine::string>& includePaths,
+        const engine::vector<engine::string>& defines)
+        : m_includePaths{ includePaths }
+    {
+        // what dxc defines without a target profile
+        m_macros["__hlsl_dx_compiler"] = Macro{ false, false, {}, tokenizeText("1") };
+        m_macros["__HLSL_VERSION"] = Macro{ false, false, {}, tokenizeText("2018") };
+
+        // NAME or NAME=VALUE like -D
+        for (auto&& define : defines)
+        {
+            auto separator = define.find('=');
+            auto name = define.substr(0, separator);
+            auto value = separator == engine::string::npos ? engine::string("1") : define.substr(separator + 1);
+            m_macros[name] = Macro{ false, false, {}, tokenizeText(value) };
+        }
+    }
+
+    engine::vector<engine::string> HlslPreprocessor::process(const engine::string& filepath) const
+    {
+        Context context(*this);
+        return context.run(filepath);
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "containers/string.h"
+#include "containers/vector.h"
+#include "containers/unordered_map.h"
+#include "containers/memory.h"
+#include <mutex>
+
+namespace shadercompiler
+{
+    enum class SourceTokenType
+    {
+        Identifier,
+        Number,
+        String,
+        Punctuator,
+        Other
+    };
+
+    struct SourceToken
+    {
+        SourceTokenType type;
+        engine::string text;
+        int line;               // 1 based. expansion line for macro expanded tokens
+        int column;             // 1 based, a tab is one column like in clang
+        bool space;             // whitespace or a comment before the token
+        bool startOfLine;
+        bool expanded;          // produced by a macro expansion
+
+        // macros that must not expand this token again
+        engine::vector<engine::string> hide;
+    };
+
+    // one logical line. continued lines are joined and comments removed.
+    struct SourceLine
+    {
+        engine::vector<SourceToken> tokens;
+        bool directive;
+    };
+
+    struct SourceFile
+    {
+        engine::string path;
+        engine::vector<char> data;
+        engine::vector<SourceLine> lines;
+        int lastLine;
+    };
+
+    // tokenized source files shared by every permutation and pipeline.
+    // files are read once per process.
+    class SourceFileCache
+    {
+    public:
+        static SourceFileCache& instance()
+        {
+            static SourceFileCache _instance;
+            return _instance;
+        }
+
+        // path must be cleaned. returns null if the file does not exist
+        engine::shared_ptr<const SourceFile> file(const engine::string& path);
+
+    private:
+        std::mutex m_mutex;
+        engine::unordered_map<engine::string, engine::shared_ptr<const SourceFile>> m_files;
+    };
+
+    // in-process replacement for dxc -P. supports object and function like
+    // macros, conditionals, includes and #pragma once. the output is laid out
+    // like clang prints preprocessed output, including the #line markers
+    // that the include dependencies are read from.
+    class HlslPreprocessor
+    {
+    public:
+        HlslPreprocessor(
+            const engine::vector<engine::string>& includePaths,
+            const engine::vector<engine::string>& defines);
+
+        // returns the output lines, each ending with a newline
+        engine::vector<engine::string> process(const engine::string& filepath) const;
+
+    private:
+        class Context;
+
+        struct Macro
+        {
+            bool function;
+            bool variadic;
+            engine::vector<engine::string> parameters;
+            engine::vector<SourceToken> body;
+        };
+
+        engine::vector<engine::string> m_includePaths;
+        engine::unordered_map<engine::string, Macro> m_macros;
+    };
+}
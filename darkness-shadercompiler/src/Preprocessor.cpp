@@ -9,6 +9,7 @@
 #include <mutex>
 #include "containers/unordered_map.h"
 #include "Helpers.h"
+#include "HlslPreprocessor.h"
 
 #define SHADER_SOURCE_PREPROCESS
 
@@ -26,9 +27,11 @@ namespace shadercompiler
 
     engine::vector<engine::string> readLinesRecursive(const engine::string& file)
     {
-        engine::vector<char> data = FileAccessSerializer::instance().readFile(file);
+        auto source = SourceFileCache::instance().file(engine::pathClean(file));
+        if (!source)
+            return {};
 
-        auto lines = readLines(data);
+        auto lines = readLines(source->data);
         engine::vector<engine::string> result;
         for (auto&& line : lines)
         {
@@ -51,7 +54,12 @@ namespace shadercompiler
         return result;
     }
 
-    Preprocessor::Preprocessor(const engine::string& filepath)
+    Preprocessor::Preprocessor(
+        const engine::string& filepath,
+        PreprocessorType type,
+        const engine::string& dxcPath)
+        : m_type{ type }
+        , m_dxcPath{ dxcPath }
     {
         auto lines = readLinesRecursive(filepath);
         for (auto&& line : lines)
@@ -65,7 +73,23 @@ namespace shadercompiler
         const engine::string& outputPath,
         engine::vector<engine::string>& shaderIncludeDepencyPaths) const
     {
-        auto dxcPath = engine::pathClean("C:/Program Files (x86)/Windows Kits/10/bin/10.0.19041.0/x86/dxc.exe");
+        engine::vector<engine::string> lines;
+        if (m_type == PreprocessorType::Dxc)
+            lines = processDxc(filepath, includePaths, defines, outputPath);
+        else
+            lines = HlslPreprocessor(includePaths, defines).process(filepath);
+
+        removePreprocessorIncludes(filepath, lines, shaderIncludeDepencyPaths);
+        return lines;
+    }
+
+    engine::vector<engine::string> Preprocessor::processDxc(
+        const engine::string& filepath,
+        const engine::vector<engine::string>& includePaths,
+        const engine::vector<engine::string>& defines,
+        const engine::string& outputPath) const
+    {
+        auto dxcPath = engine::pathClean(m_dxcPath);
 
         auto shaSeed = outputPath;
         for (auto&& define : defines)
@@ -79,7 +103,8 @@ namespace shadercompiler
         {
             arguments += " -D" + def;
         }
-        
+        for (auto&& include : includePaths)
+            arguments += " -I " + include;
 
         {
             // in it's own scope so we wait for the execution to finish
@@ -125,29 +150,7 @@ namespace shadercompiler
                 engine::fileDelete(tempPath);
         }
 
-        auto lines = readLines(data);
-        auto dataSize = removePreprocessorIncludes(filepath, lines, shaderIncludeDepencyPaths);
-
-        /*engine::string m_data;
-        m_data.resize(dataSize);
-        auto ptr = m_data.data();
-        int index = 0;
-        for (auto&& line : lines)
-        {
-            memcpy(ptr, line.data(), line.size());
-            ptr += line.size();
-        }
-
-        // write out preprocessed file
-        std::ofstream finalpreprocessedFile;
-        finalpreprocessedFile.open(outputPath, std::ios::out);
-        if (finalpreprocessedFile.is_open())
-        {
-            finalpreprocessedFile.write(m_data.data(), m_data.size());
-            finalpreprocessedFile.close();
-        }*/
-
-        return lines;
+        return readLines(data);
     }
 
     engine::vector<engine::string> Preprocessor::readLines(const engine::vector<char>& data) const
@@ -3,6 +3,7 @@
 #include "containers/string.h"
 #include "containers/vector.h"
 #include "containers/unordered_map.h"
+#include "CompileSharedTypes.h"
 
 namespace shadercompiler
 {
@@ -17,7 +18,11 @@ namespace shadercompiler
     class Preprocessor
     {
     public:
-        Preprocessor(const engine::string& filepath);
+        // dxcPath is only used with PreprocessorType::Dxc
+        Preprocessor(
+            const engine::string& filepath,
+            PreprocessorType type = PreprocessorType::InProcess,
+            const engine::string& dxcPath = "");
 
         engine::vector<engine::string> process(
             const engine::string& filepath,
@@ -36,6 +41,14 @@ namespace shadercompiler
             return m_enums;
         }
     private:
+        PreprocessorType m_type;
+        engine::string m_dxcPath;
+
+        engine::vector<engine::string> processDxc(
+            const engine::string& filepath,
+            const engine::vector<engine::string>& includePaths,
+            const engine::vector<engine::string>& defines,
+            const engine::string& outputPath) const;
         engine::vector<engine::string> readLines(const engine::vector<char>& data) const;
         int removePreprocessorIncludes(
             const engine::string& thisFile,
@@ -107,6 +107,9 @@ namespace shadercompiler
         , m_shaderPipelineInterfaceTemplateHeader{ parameters.shaderPipelineInterfaceTemplateHeader }
         , m_shaderPipelineInterfaceTemplateSource{ parameters.shaderPipelineInterfaceTemplateSource }
         , m_commonPath{ getCommonParent(m_shaderRootPath, m_shaderBinaryPathDX12) }
+        , m_forceCompileAll{ parameters.forceCompileAll }
+        , m_singleFile{ !parameters.singleFile.empty() }
+        , m_manifest{ engine::pathJoin(parameters.shaderBinaryPathDX12, "shaders.manifest") }
     {
         auto lookForOtherStagesInPipeline = [](const engine::string& sourceFile)->engine::vector<ShaderPipelineStage>
         {
@@ -166,9 +169,45 @@ namespace shadercompiler
             conf.path = engine::pathExtractFolder(parameters.singleFile);
             conf.pipelineName = pipelineNameFromFilename(parameters.singleFile);
             conf.buildCodeInterface = false;
+            conf.priority = true;
             conf.stages = allStages;
             m_pipelineVector.emplace_back(conf);
         }
+
+        if (parameters.priorityFiles.size() > 0)
+        {
+            engine::vector<engine::string> priorityFiles;
+            for (auto&& file : parameters.priorityFiles)
+                priorityFiles.emplace_back(engine::pathClean(file));
+
+            for (auto&& pipeline : m_pipelineVector)
+                for (auto&& stage : pipeline.stages)
+                    if (std::find(priorityFiles.begin(), priorityFiles.end(), engine::pathClean(stage.filename)) != priorityFiles.end())
+                        stage.priority = pipeline.priority = true;
+
+            // priority pipelines first
+            std::stable_partition(
+                m_pipelineVector.begin(),
+                m_pipelineVector.end(),
+                [](const ShaderPipelineConfiguration& pipeline) { return pipeline.priority; });
+        }
+
+        // a single file compile without a priority list waits for all stages
+        for (auto&& pipeline : m_pipelineVector)
+        {
+            if (pipeline.priority && std::none_of(pipeline.stages.begin(), pipeline.stages.end(), [](const ShaderPipelineStage& stage) { return stage.priority; }))
+                for (auto&& stage : pipeline.stages)
+                    stage.priority = true;
+        }
+    }
+
+    engine::vector<engine::string> ShaderLocator::interfaceTemplates() const
+    {
+        return {
+            m_shaderLoadInterfaceTemplateHeader,
+            m_shaderLoadInterfaceTemplateSource,
+            m_shaderPipelineInterfaceTemplateHeader,
+            m_shaderPipelineInterfaceTemplateSource };
     }
 
     using OnAddFile = std::function<void(const engine::string&)>;
@@ -238,6 +277,8 @@ namespace shadercompiler
         //      - rebuild shader binary
         //      - rebuild c++ interfaces
         // 
+        // "older" is decided by content hashes from the build manifest. timestamps
+        // are only used for files the manifest has not seen yet.
 
         auto shaderLoadTemplateHeaderTimestamp = fs::last_write_time(shaderLoadInterfaceTemplateHeader());
         auto shaderLoadTemplateSourceTimestamp = fs::last_write_time(shaderLoadInterfaceTemplateSource());
@@ -245,6 +286,9 @@ namespace shadercompiler
         auto shaderPipelineTemplateSourceTimestamp = fs::last_write_time(shaderPipelineInterfaceTemplateSource());
         std::atomic_bool anyInterfaceChange = false;
 
+        bool templatesRecorded = m_manifest.hasSource(InterfaceTemplatesKey);
+        bool templatesChanged = templatesRecorded && m_manifest.sourceChanged(InterfaceTemplatesKey);
+
 #ifdef MULTITHREADED_REMOVEUNCHANGED
         std::for_each(
             std::execution::par_unseq,
@@ -265,16 +309,6 @@ namespace shadercompiler
             for (auto&& stage : pipeline.stages)
 #endif
             {
-                // get the most recent timestamp for HLSL source and it's includes
-                stage.sourceTimestamp = fs::last_write_time(stage.filename);
-                auto includes = collectIncludes(stage.filename);
-                for (auto&& include : includes)
-                {
-                    fs::file_time_type includeTime = fs::last_write_time(include);
-                    if (includeTime > stage.sourceTimestamp)
-                        stage.sourceTimestamp = includeTime;
-                }
-
                 // get the shader binary timestamp
                 auto binFolderRelative = stage.filename.substr(shaderRootPath().length(), stage.filename.length() - shaderRootPath().length());
                         
@@ -296,12 +330,27 @@ namespace shadercompiler
                         binaryExists = engine::fileExists(binaryPath);
                     }
 
-                    if (binaryExists)
+                    if (!binaryExists)
+                        stage.buildShaderBinary = true;
+                    else if (m_manifest.hasSource(stage.filename))
+                    {
+                        // the source and every include it saw last time
+                        stage.buildShaderBinary = m_manifest.sourceChanged(stage.filename);
+                    }
+                    else
                     {
+                        // not in the manifest yet. fall back to timestamps
                         stage.binaryTimestamp = fs::last_write_time(binaryPath);
+                        stage.sourceTimestamp = fs::last_write_time(stage.filename);
+                        auto includes = collectIncludes(stage.filename);
+                        for (auto&& include : includes)
+                        {
+                            fs::file_time_type includeTime = fs::last_write_time(include);
+                            if (includeTime > stage.sourceTimestamp)
+                                stage.sourceTimestamp = includeTime;
+                        }
+                        stage.buildShaderBinary = stage.binaryTimestamp < stage.sourceTimestamp;
                     }
-
-                    stage.buildShaderBinary = stage.binaryTimestamp < stage.sourceTimestamp;
                 }
 
                 // check for shader load interface timestamps
@@ -310,17 +359,22 @@ namespace shadercompiler
                     auto binaryTarget = engine::pathJoin(shaderInterfacePath(), binFolderRelative);
                     auto hppFile = engine::pathReplaceExtension(binaryTarget, "h");
 
+                    bool interfaceChange = true;
                     if (engine::fileExists(hppFile))
                     {
-                        stage.codeInterfacesTimestamp = fs::last_write_time(hppFile);
+                        if (templatesRecorded)
+                            interfaceChange = templatesChanged;
+                        else
+                        {
+                            stage.codeInterfacesTimestamp = fs::last_write_time(hppFile);
+                            interfaceChange =
+                                stage.codeInterfacesTimestamp < shaderLoadTemplateHeaderTimestamp ||
+                                stage.codeInterfacesTimestamp < shaderLoadTemplateSourceTimestamp ||
+                                stage.codeInterfacesTimestamp < shaderPipelineTemplateHeaderTimestamp ||
+                                stage.codeInterfacesTimestamp < shaderPipelineTemplateSourceTimestamp;
+                        }
                     }
 
-                    auto interfaceChange =
-                        stage.codeInterfacesTimestamp < shaderLoadTemplateHeaderTimestamp ||
-                        stage.codeInterfacesTimestamp < shaderLoadTemplateSourceTimestamp ||
-                        stage.codeInterfacesTimestamp < shaderPipelineTemplateHeaderTimestamp ||
-                        stage.codeInterfacesTimestamp < shaderPipelineTemplateSourceTimestamp;
-
                     if (interfaceChange)
                     {
                         anyInterfaceChange = true;
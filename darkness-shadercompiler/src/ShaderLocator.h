@@ -6,6 +6,7 @@
 #include "ResourceMap.h"
 #include "containers/memory.h"
 #include "Preprocessor.h"
+#include "BuildManifest.h"
 #include <mutex>
 #include <filesystem>
 
@@ -71,6 +72,9 @@ namespace shadercompiler
 
         bool buildShaderBinary;
         bool buildCodeInterface;
+
+        // the engine is waiting for this stage (hot reload)
+        bool priority = false;
     };
 
     struct ShaderPipelineConfiguration
@@ -78,6 +82,9 @@ namespace shadercompiler
         engine::string path;
         engine::string pipelineName;
         bool buildCodeInterface;
+
+        // the engine is waiting for this pipeline (hot reload)
+        bool priority = false;
         engine::vector<ShaderPipelineStage> stages;
     };
 
@@ -94,6 +101,9 @@ namespace shadercompiler
         const engine::string& shaderPipelineInterfaceTemplateSource;
         engine::string singleFile = "";
         bool forceCompileAll = false;
+
+        // sources of stages that are compiled before the others
+        engine::vector<engine::string> priorityFiles = {};
     };
 
     class ShaderLocator
@@ -117,6 +127,14 @@ namespace shadercompiler
         const engine::string& shaderPipelineInterfaceTemplateSource() const { return m_shaderPipelineInterfaceTemplateSource; }
         const engine::string& commonPath() const { return m_commonPath; }
 
+        // manifest key of the c++ interface templates
+        static constexpr const char* InterfaceTemplatesKey = "interface_templates";
+        engine::vector<engine::string> interfaceTemplates() const;
+
+        BuildManifest& manifest() { return m_manifest; }
+        bool forceCompileAll() const { return m_forceCompileAll; }
+        bool singleFile() const { return m_singleFile; }
+
     private:
         engine::string m_shaderRootPath;
         engine::string m_shaderBinaryPathDX12;
@@ -128,6 +146,9 @@ namespace shadercompiler
         engine::string m_shaderPipelineInterfaceTemplateHeader;
         engine::string m_shaderPipelineInterfaceTemplateSource;
         engine::string m_commonPath;
+        bool m_forceCompileAll;
+        bool m_singleFile;
+        BuildManifest m_manifest;
         void locatePipelines();
         engine::unordered_map<engine::string, ShaderPipelineConfiguration> m_pipelines;
         engine::vector<ShaderPipelineConfiguration> m_pipelineVector;
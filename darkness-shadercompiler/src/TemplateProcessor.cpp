@@ -5,7 +5,13 @@
 #include "tools/PathTools.h"
 #include "ShaderPathTools.h"
 #include "ShaderLocator.h"
+#include "ShaderCompilerCommon.h"
 #include "Helpers.h"
+#include "platform/File.h"
+#include "containers/memory.h"
+#include <fstream>
+#include <sstream>
+#include <mutex>
 
 namespace shadercompiler
 {
@@ -287,7 +293,71 @@ namespace shadercompiler
 		j.at("set_count").get_to(p.set_count);
 	}
 
-    void TemplateProcessor::ProcessShaderLoadInterfaces(
+	// templates are parsed once per run and shared by every interface
+	struct ParsedTemplate
+	{
+		inja::Environment environment;
+		inja::Template parsed;
+		engine::string hash;
+	};
+
+	engine::shared_ptr<ParsedTemplate> parsedTemplate(const engine::string& templatePath)
+	{
+		static std::mutex mutex;
+		static engine::unordered_map<engine::string, engine::shared_ptr<ParsedTemplate>> templates;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		auto cached = templates.find(templatePath);
+		if (cached != templates.end())
+			return cached->second;
+
+		std::ifstream file(templatePath, std::ios::in | std::ios::binary);
+		ASSERT(file.is_open(), "Failed to open template file! %s", templatePath.c_str());
+		std::stringstream source;
+		source << file.rdbuf();
+
+		auto result = engine::make_shared<ParsedTemplate>();
+		result->parsed = result->environment.parse(source.str());
+		result->hash = sha1(source.str());
+		templates[templatePath] = result;
+		return result;
+	}
+
+	// renders only when the template or the data changed since the last run.
+	// returns true if the output was rendered.
+	bool renderInterface(
+		ShaderLocator& locator,
+		const engine::string& templatePath,
+		const inja::json& data,
+		const engine::string& outputPath,
+		const char* updateMessage,
+		LogLevel logLevel)
+	{
+		auto tmpl = parsedTemplate(templatePath);
+		auto hash = sha1(tmpl->hash + data.dump());
+
+		if (!locator.forceCompileAll() &&
+			engine::fileExists(outputPath) &&
+			!locator.manifest().outputChanged(outputPath, hash))
+			return false;
+
+		auto result = tmpl->environment.render(tmpl->parsed, data);
+
+		std::fstream outputFile;
+		outputFile.open(outputPath + "temporary", std::ios::out);
+		outputFile.write(result.c_str(), result.length());
+		outputFile.close();
+		if (compareAndReplace(outputPath + "temporary", outputPath))
+		{
+			if (logLevel == shadercompiler::LogLevel::Recompile)
+				LOG_PURE(updateMessage, engine::pathExtractFilenameWithoutExtension(outputPath).c_str());
+		}
+
+		locator.manifest().updateOutput(outputPath, hash);
+		return true;
+	}
+
+    bool TemplateProcessor::ProcessShaderLoadInterfaces(
 		ShaderLocator& locator,
 		const engine::string& originalPath,
 		const engine::string& templatePath, 
@@ -526,36 +596,7 @@ namespace shadercompiler
 		templateData.set_start_index = std::to_string(stage.setStart);
 		templateData.set_count = std::to_string(stage.setCount());
 
-		inja::json jsondata = templateData;
-
-		engine::vector<char> templateSource;
-		{
-			std::fstream preprocessedFile;
-			preprocessedFile.open(templatePath);
-			ASSERT(preprocessedFile.is_open(), "Failed to open template file!");
-
-			preprocessedFile.seekg(0, std::ios::end);
-			auto fileSize = static_cast<size_t>(preprocessedFile.tellg());
-			preprocessedFile.seekg(0, std::ios::beg);
-
-			templateSource.resize(fileSize);
-			preprocessedFile.read(templateSource.data(), fileSize);
-			preprocessedFile.close();
-		}
-
-		auto result = inja::render(templateSource.data(), jsondata);
-
-		{
-			std::fstream outputFile;
-			outputFile.open(outputPath + "temporary", std::ios::out);
-			outputFile.write(result.c_str(), result.length());
-			outputFile.close();
-			if(compareAndReplace(outputPath + "temporary", outputPath))
-			{
-				if (logLevel == shadercompiler::LogLevel::Recompile)
-					LOG_PURE("Updated shader load interface for %s", engine::pathExtractFilenameWithoutExtension(outputPath).c_str());
-			}
-		}
+		return renderInterface(locator, templatePath, templateData, outputPath, "Updated shader load interface for %s", logLevel);
     }
 
 	struct PipelineTemplateData
@@ -716,7 +757,8 @@ namespace shadercompiler
 		j.at("pipeline_interface_filepath").get_to(p.pipelineInterfaceFilePath);
 	}
 
-	void TemplateProcessor::ProcessPipelineInterfaces(
+	bool TemplateProcessor::ProcessPipelineInterfaces(
+		ShaderLocator& locator,
 		const engine::string& templatePath,
 		const ShaderPipelineConfiguration& pipeline,
 		const engine::string& targetPath,
@@ -793,35 +835,6 @@ namespace shadercompiler
 		templateData.pipelineTypeName = pipeline.pipelineName;
 		templateData.pipelineInterfaceFilePath = engine::pathExtractFilename(engine::pathReplaceExtension(targetPath, "h"));
 
-		inja::json jsondata = templateData;
-
-		engine::vector<char> templateSource;
-		{
-			std::fstream preprocessedFile;
-			preprocessedFile.open(templatePath);
-			ASSERT(preprocessedFile.is_open(), "Failed to open template file!");
-
-			preprocessedFile.seekg(0, std::ios::end);
-			auto fileSize = static_cast<size_t>(preprocessedFile.tellg());
-			preprocessedFile.seekg(0, std::ios::beg);
-
-			templateSource.resize(fileSize);
-			preprocessedFile.read(templateSource.data(), fileSize);
-			preprocessedFile.close();
-		}
-
-		auto result = inja::render(templateSource.data(), jsondata);
-
-		{
-			std::fstream outputFile;
-			outputFile.open(targetPath + "temporary", std::ios::out);
-			outputFile.write(result.c_str(), result.length());
-			outputFile.close();
-			if(compareAndReplace(targetPath + "temporary", targetPath))
-			{
-				if (logLevel == shadercompiler::LogLevel::Recompile)
-					LOG_PURE("Updated pipeline interface for %s", engine::pathExtractFilenameWithoutExtension(targetPath).c_str());
-			}
-		}
+		return renderInterface(locator, templatePath, templateData, targetPath, "Updated pipeline interface for %s", logLevel);
 	}
 }
\ No newline at end of file
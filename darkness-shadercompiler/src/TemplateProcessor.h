@@ -12,7 +12,9 @@ namespace shadercompiler
     class TemplateProcessor
     {
     public:
-        static void ProcessShaderLoadInterfaces(
+        // both return true if the output was rendered. outputs whose template
+        // and data are unchanged since the last run are skipped.
+        static bool ProcessShaderLoadInterfaces(
             ShaderLocator& locator,
             const engine::string& originalPath,
             const engine::string& templatePath, 
@@ -20,7 +22,8 @@ namespace shadercompiler
             ShaderPipelineStage& stage,
             LogLevel logLevel);
 
-        static void ProcessPipelineInterfaces(
+        static bool ProcessPipelineInterfaces(
+            ShaderLocator& locator,
             const engine::string& templatePath,
             const ShaderPipelineConfiguration& pipeline,
             const engine::string& targetPath,
@@ -4,6 +4,7 @@
 #include "CompileTask.h"
 #include "tools/Debug.h"
 #include "tools/PathTools.h"
+#include "tools/StringTools.h"
 #include "platform/Environment.h"
 
 #include <chrono>
@@ -24,6 +25,12 @@ void DoWork(engine::ArgParser& args)
         LOG_PURE("darknessshadercompiler.exe -log=all               # show all messages");
         LOG_PURE("darknessshadercompiler.exe -optimization=release  # compile release binaries (default)");
         LOG_PURE("darknessshadercompiler.exe -optimization=debug    # compile debug binaries");
+        LOG_PURE("darknessshadercompiler.exe -jobs=8                # compiler processes running at once (default: hardware threads)");
+        LOG_PURE("darknessshadercompiler.exe -batch=4               # permutations compiled per job (default: 4)");
+        LOG_PURE("darknessshadercompiler.exe -dxc=C:\\dxc\\dxc.exe      # DX12 shader compiler executable");
+        LOG_PURE("darknessshadercompiler.exe -dxcvulkan=/usr/bin/dxc  # Vulkan shader compiler executable");
+        LOG_PURE("darknessshadercompiler.exe -preprocess=dxc        # preprocess with dxc -P instead of in process (default: inprocess)");
+        LOG_PURE("darknessshadercompiler.exe -priority=C:\\...\\A.cs.hlsl;C:\\...\\B.cs.hlsl  # compile these shaders first (hot reload passes the edited one)");
         return;
     }
 
@@ -58,6 +65,18 @@ void DoWork(engine::ArgParser& args)
     bool releaseBinaries = true;
     if (args.value("optimization") == "debug") releaseBinaries = false;
 
+    shadercompiler::CompilerSettings settings;
+    settings.compilerPathDX12 = "C:/Program Files (x86)/Windows Kits/10/bin/10.0.19041.0/x86/dxc.exe";
+    settings.compilerPathVulkan = "C:/VulkanSDK/1.3.239.0/Bin/dxc.exe";
+    if (!args.value("dxc").empty()) settings.compilerPathDX12 = args.value("dxc");
+    if (!args.value("dxcvulkan").empty()) settings.compilerPathVulkan = args.value("dxcvulkan");
+    if (!args.value("jobs").empty()) settings.workerCount = std::stoi(args.value("jobs"));
+    if (!args.value("batch").empty()) settings.batchSize = std::stoi(args.value("batch"));
+    if (args.value("preprocess") == "dxc") settings.preprocessor = shadercompiler::PreprocessorType::Dxc;
+
+    for (auto&& file : engine::tokenize(args.value("priority"), { ';' }))
+        params.priorityFiles.emplace_back(file);
+
     // compile All shaders
     if(args.value("input").empty())
     {
@@ -69,7 +88,7 @@ void DoWork(engine::ArgParser& args)
             if (static_cast<int>(logLevel) >= static_cast<int>(shadercompiler::LogLevel::Progress)) LOG_PURE("No changes. Exiting.");
         }
         else
-            shadercompiler::CompileTask task(locator, releaseBinaries, logLevel);
+            shadercompiler::CompileTask task(locator, releaseBinaries, logLevel, settings);
     }
     else
     {
@@ -81,7 +100,7 @@ void DoWork(engine::ArgParser& args)
             if (static_cast<int>(logLevel) >= static_cast<int>(shadercompiler::LogLevel::Progress)) LOG_PURE("No changes. Exiting.");
         }
         else
-            shadercompiler::CompileTask task(locator, releaseBinaries, logLevel);
+            shadercompiler::CompileTask task(locator, releaseBinaries, logLevel, settings);
     }
 
     auto after = std::chrono::high_resolution_clock::now();
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Vector3.h"
+#include "Vector4.h"
+#include "Matrix4.h"
+#include <cstddef>
+
+namespace engine
+{
+    // array versions of the hot matrix operations. they give the same
+    // results as the operators on each element but keep the loop in one
+    // place where the vector unit can run through it.
+    //
+    // result may alias the input it replaces.
+
+    // result[i] = a[i] * b[i]
+    void multiply(const Matrix4f* a, const Matrix4f* b, Matrix4f* result, size_t count);
+
+    // result[i] = parent * local[i]
+    void multiply(const Matrix4f& parent, const Matrix4f* local, Matrix4f* result, size_t count);
+
+    // result[i] = (matrix * Vector4f(points[i], 1)).xyz()
+    void transformPoints(const Matrix4f& matrix, const Vector3f* points, Vector3f* result, size_t count);
+
+    // result[i] = matrix * vectors[i]
+    void transformVectors(const Matrix4f& matrix, const Vector4f* vectors, Vector4f* result, size_t count);
+
+    // result[i] = matrices[i].inverse().transpose()
+    void normalMatrices(const Matrix4f* matrices, Matrix4f* result, size_t count);
+}
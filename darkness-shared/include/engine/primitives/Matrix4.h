@@ -4,6 +4,7 @@
 #include "Vector4.h"
 #include "Matrix3.h"
 #include "Math.h"
+#include "Simd.h"
 
 #include "containers/memory.h"
 
@@ -639,6 +640,151 @@ namespace engine
         }
     };
 
+#if defined(DARKNESS_SIMD)
+    namespace simd
+    {
+        // the matrices are row major. products add in the same order as the
+        // scalar code so they give the same bits
+        inline void multiply4x4(const float* a, const float* b, float* result)
+        {
+            float4 b0 = load(b);
+            float4 b1 = load(b + 4);
+            float4 b2 = load(b + 8);
+            float4 b3 = load(b + 12);
+            for (int row = 0; row < 4; ++row)
+            {
+                float4 r = load(a + row * 4);
+                store(result + row * 4, add(add(add(
+                    mul(splat<0>(r), b0),
+                    mul(splat<1>(r), b1)),
+                    mul(splat<2>(r), b2)),
+                    mul(splat<3>(r), b3)));
+            }
+        }
+
+        inline float4 transform4x4(const float* m, float4 vec)
+        {
+            float4 c0 = load(m);
+            float4 c1 = load(m + 4);
+            float4 c2 = load(m + 8);
+            float4 c3 = load(m + 12);
+            transpose(c0, c1, c2, c3);
+            return add(add(add(
+                mul(c0, splat<0>(vec)),
+                mul(c1, splat<1>(vec))),
+                mul(c2, splat<2>(vec))),
+                mul(c3, splat<3>(vec)));
+        }
+
+        inline void transpose4x4(const float* m, float* result)
+        {
+            float4 r0 = load(m);
+            float4 r1 = load(m + 4);
+            float4 r2 = load(m + 8);
+            float4 r3 = load(m + 12);
+            transpose(r0, r1, r2, r3);
+            store(result, r0);
+            store(result + 4, r1);
+            store(result + 8, r2);
+            store(result + 12, r3);
+        }
+
+        // cofactors from the 2x2 minors of the other row pair. the minors
+        // come in the order the lanes need them. the result isn't bit exact
+        // with the scalar inverse, the products are grouped differently
+        inline void minors2x2(float4 a, float4 b, float4& first, float4& second, float4& third)
+        {
+            float4 a1000 = shuffle<1, 0, 0, 0>(a);
+            float4 b1000 = shuffle<1, 0, 0, 0>(b);
+            float4 a2211 = shuffle<2, 2, 1, 1>(a);
+            float4 b2211 = shuffle<2, 2, 1, 1>(b);
+            float4 a3332 = shuffle<3, 3, 3, 2>(a);
+            float4 b3332 = shuffle<3, 3, 3, 2>(b);
+            first = sub(mul(a2211, b3332), mul(b2211, a3332));
+            second = sub(mul(a1000, b3332), mul(b1000, a3332));
+            third = sub(mul(a1000, b2211), mul(b1000, a2211));
+        }
+
+        inline float4 cofactors(float4 row, float4 first, float4 second, float4 third, float4 sign)
+        {
+            return mul(sign, add(sub(
+                mul(shuffle<1, 0, 0, 0>(row), first),
+                mul(shuffle<2, 2, 1, 1>(row), second)),
+                mul(shuffle<3, 3, 3, 2>(row), third)));
+        }
+
+        // false when the matrix is singular. the cofactors come out as
+        // columns so the transposed inverse skips a transpose
+        inline bool inverse4x4(const float* m, float* result, bool transposed = false)
+        {
+            float4 r0 = load(m);
+            float4 r1 = load(m + 4);
+            float4 r2 = load(m + 8);
+            float4 r3 = load(m + 12);
+
+            float4 bottom0, bottom1, bottom2;
+            minors2x2(r2, r3, bottom0, bottom1, bottom2);
+            float4 top0, top1, top2;
+            minors2x2(r0, r1, top0, top1, top2);
+
+            float4 positive = set(1.0f, -1.0f, 1.0f, -1.0f);
+            float4 negative = set(-1.0f, 1.0f, -1.0f, 1.0f);
+            float4 c0 = cofactors(r1, bottom0, bottom1, bottom2, positive);
+            float4 c1 = cofactors(r0, bottom0, bottom1, bottom2, negative);
+            float4 c2 = cofactors(r3, top0, top1, top2, positive);
+            float4 c3 = cofactors(r2, top0, top1, top2, negative);
+
+            float products[4];
+            store(products, mul(r0, c0));
+            double det = products[0] + products[1] + products[2] + products[3];
+            if (det == 0)
+                return false;
+
+            float4 scale = splat(static_cast<float>(1.0 / det));
+            if (!transposed)
+                transpose(c0, c1, c2, c3);
+            store(result, mul(c0, scale));
+            store(result + 4, mul(c1, scale));
+            store(result + 8, mul(c2, scale));
+            store(result + 12, mul(c3, scale));
+            return true;
+        }
+    }
+
+    template<>
+    inline Vector4<float> Matrix4<float>::operator*(const Vector4<float> vec) const
+    {
+        Vector4<float> result;
+        simd::store(&result.x, simd::transform4x4(&m00, simd::load(&vec.x)));
+        return result;
+    }
+
+    template<>
+    inline Matrix4<float> Matrix4<float>::operator*(const Matrix4<float>& mat) const
+    {
+        Matrix4<float> result;
+        simd::multiply4x4(&m00, &mat.m00, &result.m00);
+        return result;
+    }
+
+    template<>
+    inline Matrix4<float> Matrix4<float>::transpose()
+    {
+        Matrix4<float> result;
+        simd::transpose4x4(&m00, &result.m00);
+        return result;
+    }
+
+    template<>
+    inline Matrix4<float> Matrix4<float>::inverse() const
+    {
+        Matrix4<float> result;
+        if (!simd::inverse4x4(&m00, &result.m00))
+            return Matrix4<float>();
+        return result;
+    }
+#endif
+
     using Matrix4f = Matrix4<float>;
     using Matrix4d = Matrix4<double>;
 }
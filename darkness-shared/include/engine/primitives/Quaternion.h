@@ -5,6 +5,7 @@
 #include "Matrix3.h"
 #include "Matrix4.h"
 #include "Math.h"
+#include "Simd.h"
 
 namespace engine
 {
@@ -376,6 +377,26 @@ namespace engine
         return result;
     }
 
+#if defined(DARKNESS_SIMD)
+    // same additions in the same order as the scalar product
+    template<>
+    inline Quaternion<float> Quaternion<float>::product(const Quaternion<float>& val) const
+    {
+        simd::float4 a = simd::load(&x);
+        simd::float4 b = simd::load(&val.x);
+        simd::float4 t1 = simd::mul(simd::shuffle<1, 2, 0, 3>(a), simd::shuffle<2, 0, 1, 3>(b));
+        simd::float4 t2 = simd::mul(simd::shuffle<2, 0, 1, 0>(a), simd::shuffle<1, 2, 0, 0>(b));
+        simd::float4 t3 = simd::mul(simd::shuffle<0, 1, 2, 1>(a), simd::shuffle<3, 3, 3, 1>(b));
+        simd::float4 t4 = simd::mul(simd::shuffle<3, 3, 3, 2>(a), simd::shuffle<0, 1, 2, 2>(b));
+
+        // the real part subtracts the last two terms
+        simd::float4 sign = simd::set(1.0f, 1.0f, 1.0f, -1.0f);
+        Quaternion<float> result;
+        simd::store(&result.x, simd::add(simd::add(simd::sub(t1, t2), simd::mul(t3, sign)), simd::mul(t4, sign)));
+        return result;
+    }
+#endif
+
     using Quaternionf = Quaternion<float>;
     using Quaterniond = Quaternion<double>;
 }
@@ -0,0 +1,121 @@
+#pragma once
+
+// four wide float vectors for the math primitives.
+//
+// the primitives only use the functions below so a new instruction set
+// needs nothing but another branch here. DARKNESS_SIMD is left undefined
+// when there is no vector unit and the scalar templates are used as is.
+
+#if defined(DARKNESS_NO_SIMD)
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+#define DARKNESS_SIMD
+#define DARKNESS_SIMD_NEON
+#include <arm_neon.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DARKNESS_SIMD
+#define DARKNESS_SIMD_SSE
+#include <emmintrin.h>
+#endif
+
+#if defined(DARKNESS_SIMD)
+namespace engine
+{
+    namespace simd
+    {
+#if defined(DARKNESS_SIMD_SSE)
+        using float4 = __m128;
+
+        inline float4 load(const float* src) { return _mm_loadu_ps(src); }
+        inline void store(float* dst, float4 v) { _mm_storeu_ps(dst, v); }
+        inline float4 splat(float value) { return _mm_set1_ps(value); }
+        inline float4 set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+        inline float4 add(float4 a, float4 b) { return _mm_add_ps(a, b); }
+        inline float4 sub(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+        inline float4 mul(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+        inline float4 div(float4 a, float4 b) { return _mm_div_ps(a, b); }
+        inline float4 sqrt(float4 v) { return _mm_sqrt_ps(v); }
+
+        // a lane that is NaN in a gives the lane of b
+        inline float4 min(float4 a, float4 b) { return _mm_min_ps(a, b); }
+        inline float4 max(float4 a, float4 b) { return _mm_max_ps(a, b); }
+
+        // bit i is set when the comparison holds for lane i
+        inline int greaterEqual(float4 a, float4 b) { return _mm_movemask_ps(_mm_cmpge_ps(a, b)); }
+        inline int less(float4 a, float4 b) { return _mm_movemask_ps(_mm_cmplt_ps(a, b)); }
+
+        // lanes where mask is set come from a, the others from b
+        inline float4 select(int mask, float4 a, float4 b)
+        {
+            __m128 m = _mm_castsi128_ps(_mm_setr_epi32(
+                (mask & 1) ? -1 : 0, (mask & 2) ? -1 : 0, (mask & 4) ? -1 : 0, (mask & 8) ? -1 : 0));
+            return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+        }
+
+        // result lane i is v[lane i]
+        template<int X, int Y, int Z, int W>
+        inline float4 shuffle(float4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(W, Z, Y, X)); }
+
+        template<int Lane>
+        inline float4 splat(float4 v) { return shuffle<Lane, Lane, Lane, Lane>(v); }
+
+        inline float first(float4 v) { return _mm_cvtss_f32(v); }
+
+        inline void transpose(float4& r0, float4& r1, float4& r2, float4& r3)
+        {
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        }
+#elif defined(DARKNESS_SIMD_NEON)
+        using float4 = float32x4_t;
+
+        inline float4 load(const float* src) { return vld1q_f32(src); }
+        inline void store(float* dst, float4 v) { vst1q_f32(dst, v); }
+        inline float4 splat(float value) { return vdupq_n_f32(value); }
+        inline float4 set(float x, float y, float z, float w) { float v[4] = { x, y, z, w }; return vld1q_f32(v); }
+        inline float4 add(float4 a, float4 b) { return vaddq_f32(a, b); }
+        inline float4 sub(float4 a, float4 b) { return vsubq_f32(a, b); }
+        inline float4 mul(float4 a, float4 b) { return vmulq_f32(a, b); }
+        inline float4 div(float4 a, float4 b) { return vdivq_f32(a, b); }
+        inline float4 sqrt(float4 v) { return vsqrtq_f32(v); }
+
+        inline float4 min(float4 a, float4 b) { return vbslq_f32(vcltq_f32(a, b), a, b); }
+        inline float4 max(float4 a, float4 b) { return vbslq_f32(vcgtq_f32(a, b), a, b); }
+
+        inline int mask(uint32x4_t m)
+        {
+            const int32x4_t shift = { 0, 1, 2, 3 };
+            return static_cast<int>(vaddvq_u32(vshlq_u32(vshrq_n_u32(m, 31), shift)));
+        }
+        inline int greaterEqual(float4 a, float4 b) { return mask(vcgeq_f32(a, b)); }
+        inline int less(float4 a, float4 b) { return mask(vcltq_f32(a, b)); }
+
+        inline float4 select(int m, float4 a, float4 b)
+        {
+            const uint32x4_t lanes = { 1, 2, 4, 8 };
+            uint32x4_t bits = vtstq_u32(vdupq_n_u32(static_cast<uint32_t>(m)), lanes);
+            return vbslq_f32(bits, a, b);
+        }
+
+        template<int X, int Y, int Z, int W>
+        inline float4 shuffle(float4 v)
+        {
+            return set(vgetq_lane_f32(v, X), vgetq_lane_f32(v, Y), vgetq_lane_f32(v, Z), vgetq_lane_f32(v, W));
+        }
+
+        template<int Lane>
+        inline float4 splat(float4 v) { return vdupq_n_f32(vgetq_lane_f32(v, Lane)); }
+
+        inline float first(float4 v) { return vgetq_lane_f32(v, 0); }
+
+        inline void transpose(float4& r0, float4& r1, float4& r2, float4& r3)
+        {
+            float32x4x2_t a = vtrnq_f32(r0, r1);
+            float32x4x2_t b = vtrnq_f32(r2, r3);
+            r0 = vcombine_f32(vget_low_f32(a.val[0]), vget_low_f32(b.val[0]));
+            r1 = vcombine_f32(vget_low_f32(a.val[1]), vget_low_f32(b.val[1]));
+            r2 = vcombine_f32(vget_high_f32(a.val[0]), vget_high_f32(b.val[0]));
+            r3 = vcombine_f32(vget_high_f32(a.val[1]), vget_high_f32(b.val[1]));
+        }
+#endif
+    }
+}
+#endif
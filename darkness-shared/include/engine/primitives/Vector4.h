@@ -2,6 +2,7 @@
 
 #include "Vector3.h"
 #include "Vector2.h"
+#include "Simd.h"
 
 namespace engine
 {
@@ -399,5 +400,47 @@ namespace engine
         }
     };
 
+#if defined(DARKNESS_SIMD)
+    template<>
+    inline Vector4<float> Vector4<float>::operator+(const Vector4<float>& vec) const
+    {
+        Vector4<float> result;
+        simd::store(&result.x, simd::add(simd::load(&x), simd::load(&vec.x)));
+        return result;
+    }
+
+    template<>
+    inline Vector4<float> Vector4<float>::operator-(const Vector4<float>& vec) const
+    {
+        Vector4<float> result;
+        simd::store(&result.x, simd::sub(simd::load(&x), simd::load(&vec.x)));
+        return result;
+    }
+
+    template<>
+    inline Vector4<float> Vector4<float>::operator*(const Vector4<float>& vec) const
+    {
+        Vector4<float> result;
+        simd::store(&result.x, simd::mul(simd::load(&x), simd::load(&vec.x)));
+        return result;
+    }
+
+    template<>
+    inline Vector4<float> Vector4<float>::operator/(const Vector4<float>& vec) const
+    {
+        Vector4<float> result;
+        simd::store(&result.x, simd::div(simd::load(&x), simd::load(&vec.x)));
+        return result;
+    }
+
+    template<>
+    inline Vector4<float> Vector4<float>::operator*(float val) const
+    {
+        Vector4<float> result;
+        simd::store(&result.x, simd::mul(simd::load(&x), simd::splat(val)));
+        return result;
+    }
+#endif
+
     using Vector4f = Vector4<float>;
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "containers/string.h"
+#include <cstdint>
+#include <cstddef>
 
 namespace engine
 {
@@ -8,4 +10,27 @@ namespace engine
     bool fileCopy(const engine::string& src, const engine::string& dst, bool overWriteIfExists = true);
     bool fileDelete(const engine::string& file);
     void fileRename(const engine::string& from, const engine::string& to);
+
+    // whole file mapped copy-on-write. writes through data() stay
+    // in this process and never reach the file.
+    class MappedFile
+    {
+    public:
+        MappedFile(const engine::string& filename);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile(MappedFile&&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile& operator=(MappedFile&&) = delete;
+
+        bool valid() const { return m_data != nullptr; }
+        uint8_t* data() { return m_data; }
+        const uint8_t* data() const { return m_data; }
+        size_t size() const { return m_size; }
+    private:
+        uint8_t* m_data;
+        size_t m_size;
+        void* m_mapping;
+    };
 }
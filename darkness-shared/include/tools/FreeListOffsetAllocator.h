@@ -4,6 +4,7 @@
 //#include "containers/vector.h"
 #include "containers/unordered_map.h"
 #include <stack>
+#include <mutex>
 #include "tools/ByteRange.h"
 
 namespace tools
@@ -40,6 +41,8 @@ namespace tools
         void free(ContinousHandle block);
 
     private:
+        // descriptors are allocated from command list recording threads
+        std::mutex m_mutex;
         size_t m_maximumSize;
         size_t m_currentBlock;
         engine::unordered_map<size_t, std::stack<size_t>> m_map;
@@ -0,0 +1,116 @@
+#include "engine/primitives/MathBatch.h"
+
+namespace engine
+{
+    void multiply(const Matrix4f* a, const Matrix4f* b, Matrix4f* result, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+#if defined(DARKNESS_SIMD)
+            simd::multiply4x4(&a[i].m00, &b[i].m00, &result[i].m00);
+#else
+            result[i] = a[i] * b[i];
+#endif
+        }
+    }
+
+    void multiply(const Matrix4f& parent, const Matrix4f* local, Matrix4f* result, size_t count)
+    {
+#if defined(DARKNESS_SIMD)
+        // the parent rows are splatted once for all the children
+        simd::float4 p[16];
+        for (int i = 0; i < 16; ++i)
+            p[i] = simd::splat(parent[i]);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float* l = &local[i].m00;
+            simd::float4 l0 = simd::load(l);
+            simd::float4 l1 = simd::load(l + 4);
+            simd::float4 l2 = simd::load(l + 8);
+            simd::float4 l3 = simd::load(l + 12);
+
+            float* r = &result[i].m00;
+            for (int row = 0; row < 4; ++row)
+            {
+                const simd::float4* pr = &p[row * 4];
+                simd::store(r + row * 4, simd::add(simd::add(simd::add(
+                    simd::mul(pr[0], l0),
+                    simd::mul(pr[1], l1)),
+                    simd::mul(pr[2], l2)),
+                    simd::mul(pr[3], l3)));
+            }
+        }
+#else
+        for (size_t i = 0; i < count; ++i)
+            result[i] = parent * local[i];
+#endif
+    }
+
+    void transformPoints(const Matrix4f& matrix, const Vector3f* points, Vector3f* result, size_t count)
+    {
+#if defined(DARKNESS_SIMD)
+        simd::float4 c0 = simd::load(&matrix.m00);
+        simd::float4 c1 = simd::load(&matrix.m10);
+        simd::float4 c2 = simd::load(&matrix.m20);
+        simd::float4 c3 = simd::load(&matrix.m30);
+        simd::transpose(c0, c1, c2, c3);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            // w is one but still multiplied so the bits match the operator
+            simd::float4 p = simd::add(simd::add(simd::add(
+                simd::mul(c0, simd::splat(points[i].x)),
+                simd::mul(c1, simd::splat(points[i].y))),
+                simd::mul(c2, simd::splat(points[i].z))),
+                simd::mul(c3, simd::splat(1.0f)));
+
+            float out[4];
+            simd::store(out, p);
+            result[i] = { out[0], out[1], out[2] };
+        }
+#else
+        for (size_t i = 0; i < count; ++i)
+            result[i] = matrix * points[i];
+#endif
+    }
+
+    void transformVectors(const Matrix4f& matrix, const Vector4f* vectors, Vector4f* result, size_t count)
+    {
+#if defined(DARKNESS_SIMD)
+        simd::float4 c0 = simd::load(&matrix.m00);
+        simd::float4 c1 = simd::load(&matrix.m10);
+        simd::float4 c2 = simd::load(&matrix.m20);
+        simd::float4 c3 = simd::load(&matrix.m30);
+        simd::transpose(c0, c1, c2, c3);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            simd::float4 v = simd::load(&vectors[i].x);
+            simd::store(&result[i].x, simd::add(simd::add(simd::add(
+                simd::mul(c0, simd::splat<0>(v)),
+                simd::mul(c1, simd::splat<1>(v))),
+                simd::mul(c2, simd::splat<2>(v))),
+                simd::mul(c3, simd::splat<3>(v))));
+        }
+#else
+        for (size_t i = 0; i < count; ++i)
+            result[i] = matrix * vectors[i];
+#endif
+    }
+
+    void normalMatrices(const Matrix4f* matrices, Matrix4f* result, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+#if defined(DARKNESS_SIMD)
+            Matrix4f normal;
+            if (!simd::inverse4x4(&matrices[i].m00, &normal.m00, true))
+                normal = Matrix4f();
+            result[i] = normal;
+#else
+            result[i] = matrices[i].inverse().transpose();
+#endif
+        }
+    }
+}
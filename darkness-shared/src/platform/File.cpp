@@ -2,6 +2,15 @@
 #include <fstream>
 #include <filesystem>
 
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 using namespace std;
 
 namespace engine
@@ -35,4 +44,72 @@ namespace engine
     {
         std::filesystem::rename(from, to);
     }
+
+#ifdef _WIN32
+    MappedFile::MappedFile(const engine::string& filename)
+        : m_data{ nullptr }
+        , m_size{ 0 }
+        , m_mapping{ nullptr }
+    {
+        HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+            return;
+
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        {
+            // the mapping keeps the file open
+            m_mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+            if (m_mapping)
+            {
+                m_data = static_cast<uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_COPY, 0, 0, 0));
+                if (m_data)
+                    m_size = static_cast<size_t>(size.QuadPart);
+                else
+                {
+                    CloseHandle(m_mapping);
+                    m_mapping = nullptr;
+                }
+            }
+        }
+        CloseHandle(file);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (m_data)
+            UnmapViewOfFile(m_data);
+        if (m_mapping)
+            CloseHandle(m_mapping);
+    }
+#else
+    MappedFile::MappedFile(const engine::string& filename)
+        : m_data{ nullptr }
+        , m_size{ 0 }
+        , m_mapping{ nullptr }
+    {
+        int file = open(filename.c_str(), O_RDONLY);
+        if (file < 0)
+            return;
+
+        struct stat info;
+        if (fstat(file, &info) == 0 && info.st_size > 0)
+        {
+            void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+            if (data != MAP_FAILED)
+            {
+                m_data = static_cast<uint8_t*>(data);
+                m_size = static_cast<size_t>(info.st_size);
+                m_mapping = data;
+            }
+        }
+        close(file);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (m_mapping)
+            munmap(m_mapping, m_size);
+    }
+#endif
 }
@@ -49,6 +49,7 @@ namespace tools
 
     ContinousHandle FreeListContinuousOffsetAllocator::allocate()
     {
+        std::lock_guard<std::mutex> lock(m_mutex);
         auto existing = m_map.find(1);
         if (existing != m_map.end() && existing->second.size() > 0)
         {
@@ -65,6 +66,7 @@ namespace tools
 
     ContinousHandle FreeListContinuousOffsetAllocator::allocate(size_t blocks)
     {
+        std::lock_guard<std::mutex> lock(m_mutex);
         auto existing = m_map.find(blocks);
         if (existing != m_map.end() && existing->second.size() > 0)
         {
@@ -81,6 +83,7 @@ namespace tools
 
     void FreeListContinuousOffsetAllocator::free(ContinousHandle block)
     {
+        std::lock_guard<std::mutex> lock(m_mutex);
         /*auto existing = m_map.find(block.length);
         if (existing != m_map.end())
         {
@@ -11,6 +11,13 @@ public class DarknessTests : DarknessExecutable
     {
         Name = "DarknessTests";
         SourceRootPath = @"[project.SharpmakeCsPath]/src";
+
+        // the shader compiler is an executable. TestPreprocessor builds the preprocessor sources in
+        SourceFiles.Add(
+            @"[project.SharpmakeCsPath]/../darkness-shadercompiler/src/Preprocessor.cpp",
+            @"[project.SharpmakeCsPath]/../darkness-shadercompiler/src/HlslPreprocessor.cpp",
+            @"[project.SharpmakeCsPath]/../darkness-shadercompiler/src/Helpers.cpp",
+            @"[project.SharpmakeCsPath]/../darkness-shadercompiler/src/ShaderCompilerCommon.cpp");
     }
 
     [Configure]
@@ -28,6 +35,7 @@ public class DarknessTests : DarknessExecutable
         conf.ProjectFileName = @"[project.Name].[target.DevEnv]";
 
         conf.IncludePaths.Add(@"[project.SourceRootPath]/.");
+        conf.IncludePaths.Add(@"[project.SharpmakeCsPath]/../darkness-shadercompiler/src");
 
         conf.AddPublicDependency<DarknessEngine>(target);
         conf.Options.Add(Options.Vc.Linker.SubSystem.Console);
@@ -0,0 +1,24 @@
+#include "Preprocessor.hlsli"
+#include "Preprocessor.hlsli"
+
+#ifdef OPTION_SHADOWS
+#define SHADOW_SAMPLES 8
+#else
+#define SHADOW_SAMPLES 1
+#endif
+
+cbuffer Constants
+{
+    float4 lights[LIGHT_COUNT];
+};
+
+float4 main(float4 position : SV_Position) : SV_Target
+{
+    float shadow = 0.0f;
+    for (int i = 0; i < SHADOW_SAMPLES; ++i)
+        shadow += 1.0f / SHADOW_SAMPLES;
+#ifdef OPTION_SHADOWS
+    shadow *= 0.5f;
+#endif
+    return float4(scaled(lights[0].xyz), shadow); /* both permutations */
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#define LIGHT_COUNT 4
+#define SCALE(x) ((x) * 2.0f)
+
+float3 scaled(float3 value)
+{
+    return SCALE(value);
+}
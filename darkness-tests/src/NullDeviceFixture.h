@@ -0,0 +1,44 @@
+#pragma once
+
+#include "gtest/gtest.h"
+
+#include "engine/graphics/Device.h"
+#include "engine/graphics/null/NullDevice.h"
+#include "engine/graphics/null/NullStatistics.h"
+#include "containers/memory.h"
+
+// fixture for the tests that need a device but no window or gpu.
+// every test gets its own null device and can check what the
+// code under test asked the device to do from statistics()
+class NullDeviceTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_device = engine::make_unique<engine::Device>(nullptr, "NullDeviceTest", engine::GraphicsApi::Null);
+        statistics().reset();
+    }
+
+    void TearDown() override
+    {
+        m_device = nullptr;
+    }
+
+    engine::Device& device()
+    {
+        return *m_device;
+    }
+
+    engine::implementation::DeviceImplNull& nullDevice()
+    {
+        return *static_cast<engine::implementation::DeviceImplNull*>(m_device->native());
+    }
+
+    engine::implementation::NullStatistics& statistics()
+    {
+        return nullDevice().statistics();
+    }
+
+private:
+    engine::unique_ptr<engine::Device> m_device;
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "engine/primitives/Matrix4.h"
+#include <cmath>
+
+// the projection Camera::perspectiveMatrix() builds, without a camera.
+// right handed with reversed depth, near maps to 1 and far to 0
+inline engine::Matrix4f cameraPerspective(float fov, float aspect, float nearPlane, float farPlane)
+{
+    float zn = farPlane;
+    float zf = nearPlane;
+    float yScale = 1.0f / std::tan(DEG_TO_RAD * fov * 0.5f);
+    float xScale = yScale / aspect;
+
+    engine::Matrix4f m;
+    m.m00 = xScale;
+    m.m11 = yScale;
+    m.m22 = zf / (zn - zf);
+    m.m23 = zn * zf / (zn - zf);
+    m.m32 = -1.0f;
+    return m;
+}
@@ -0,0 +1,45 @@
+#include "gtest/gtest.h"
+#include "engine/font/Font.h"
+#include "containers/vector.h"
+#include "containers/string.h"
+
+using namespace engine;
+
+namespace
+{
+    engine::vector<uint32_t> decode(const engine::string& text)
+    {
+        engine::vector<uint32_t> result;
+        for (size_t i = 0; i < text.size();)
+            result.emplace_back(Font::decodeUtf8(text.data(), text.size(), i));
+        return result;
+    }
+}
+
+TEST(TestFont, DecodesUtf8)
+{
+    EXPECT_EQ(decode("abc"), (engine::vector<uint32_t>{ 'a', 'b', 'c' }));
+    EXPECT_EQ(decode("\xc3\xa9t\xc3\xa9"), (engine::vector<uint32_t>{ 0xe9, 't', 0xe9 }));
+    EXPECT_EQ(decode("\xe2\x82\xac"), (engine::vector<uint32_t>{ 0x20ac }));
+    EXPECT_EQ(decode("\xf0\x9f\x98\x80!"), (engine::vector<uint32_t>{ 0x1f600, '!' }));
+}
+
+TEST(TestFont, InvalidUtf8IsLatin1)
+{
+    // a lone latin-1 byte
+    EXPECT_EQ(decode("caf\xe9"), (engine::vector<uint32_t>{ 'c', 'a', 'f', 0xe9 }));
+
+    // truncated sequence
+    EXPECT_EQ(decode("\xe2\x82"), (engine::vector<uint32_t>{ 0xe2, 0x82 }));
+
+    // overlong forms
+    EXPECT_EQ(decode("\xc0\xaf"), (engine::vector<uint32_t>{ 0xc0, 0xaf }));
+    EXPECT_EQ(decode("\xe0\x80\xaf"), (engine::vector<uint32_t>{ 0xe0, 0x80, 0xaf }));
+
+    // surrogate and past the last codepoint
+    EXPECT_EQ(decode("\xed\xa0\x80"), (engine::vector<uint32_t>{ 0xed, 0xa0, 0x80 }));
+    EXPECT_EQ(decode("\xf4\x90\x80\x80"), (engine::vector<uint32_t>{ 0xf4, 0x90, 0x80, 0x80 }));
+
+    // continuation byte where a lead byte is expected
+    EXPECT_EQ(decode("\xa9" "a"), (engine::vector<uint32_t>{ 0xa9, 'a' }));
+}
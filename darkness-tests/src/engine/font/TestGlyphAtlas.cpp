@@ -0,0 +1,73 @@
+#include "NullDeviceFixture.h"
+#include "engine/font/GlyphAtlas.h"
+#include "containers/vector.h"
+#include <algorithm>
+#include <utility>
+
+using namespace engine;
+
+class TestGlyphAtlas : public NullDeviceTest
+{
+};
+
+TEST_F(TestGlyphAtlas, AddsPagesUpToTheLimit)
+{
+    // four cells per page
+    GlyphAtlas atlas(device(), 64, 64, 128, 2);
+    EXPECT_EQ(atlas.pageCount(), 1u);
+
+    engine::vector<GlyphAtlas::Cell> cells(8);
+    for (size_t i = 0; i < cells.size(); ++i)
+    {
+        ASSERT_TRUE(atlas.allocate(cells[i]));
+        EXPECT_EQ(cells[i].page, static_cast<int>(i / 4));
+    }
+    EXPECT_EQ(atlas.pageCount(), 2u);
+
+    // no two cells on a page overlap
+    engine::vector<std::pair<int, std::pair<int, int>>> positions;
+    for (auto&& cell : cells)
+        positions.push_back({ cell.page, { cell.allocation.x, cell.allocation.y } });
+    std::sort(positions.begin(), positions.end());
+    EXPECT_TRUE(std::adjacent_find(positions.begin(), positions.end()) == positions.end());
+
+    GlyphAtlas::Cell full;
+    EXPECT_FALSE(atlas.allocate(full));
+    EXPECT_EQ(atlas.pageCount(), 2u);
+
+    ASSERT_TRUE(atlas.allocate(full, true));
+    EXPECT_EQ(full.page, 2);
+    EXPECT_EQ(atlas.pageCount(), 3u);
+}
+
+TEST_F(TestGlyphAtlas, PagesKeepTheirSize)
+{
+    // the page size rounds up to a power of two
+    GlyphAtlas atlas(device(), 20, 30, 100, 2);
+    EXPECT_EQ(atlas.pageSize(), 128);
+
+    GlyphAtlas::Cell cell;
+    while (atlas.pageCount() < 2)
+        ASSERT_TRUE(atlas.allocate(cell));
+    for (size_t i = 0; i < atlas.pageCount(); ++i)
+    {
+        EXPECT_EQ(atlas.page(i).width(), 128u);
+        EXPECT_EQ(atlas.page(i).height(), 128u);
+    }
+}
+
+TEST_F(TestGlyphAtlas, FreedCellIsReused)
+{
+    GlyphAtlas atlas(device(), 64, 64, 128, 2);
+    engine::vector<GlyphAtlas::Cell> cells(8);
+    for (auto&& cell : cells)
+        ASSERT_TRUE(atlas.allocate(cell));
+
+    atlas.free(cells[2]);
+    GlyphAtlas::Cell reused;
+    ASSERT_TRUE(atlas.allocate(reused));
+    EXPECT_EQ(reused.page, cells[2].page);
+    EXPECT_EQ(reused.allocation.x, cells[2].allocation.x);
+    EXPECT_EQ(reused.allocation.y, cells[2].allocation.y);
+    EXPECT_EQ(atlas.pageCount(), 2u);
+}
@@ -0,0 +1,118 @@
+#include "gtest/gtest.h"
+#include "engine/font/TextLayoutCache.h"
+#include "containers/string.h"
+#include <cstring>
+
+using namespace engine;
+
+namespace
+{
+    TextLayoutCache::Key key(const char* text)
+    {
+        return { nullptr, 24.0f, TextLayoutCache::hash(text, strlen(text)) };
+    }
+
+    // one node per character, marked with its position in the text
+    void insert(TextLayoutCache& cache, const char* text)
+    {
+        auto& nodes = cache.insert(key(text), text, strlen(text), strlen(text));
+        for (size_t i = 0; i < nodes.size(); ++i)
+            nodes[i].dstPosition = { static_cast<float>(i), 0.0f };
+    }
+
+    bool cached(TextLayoutCache& cache, const char* text)
+    {
+        return cache.find(key(text), text, strlen(text)) != nullptr;
+    }
+}
+
+TEST(TestTextLayoutCache, EvictsLeastRecentlyUsedRun)
+{
+    TextLayoutCache cache(3, 1000);
+    insert(cache, "first");
+    insert(cache, "second");
+    insert(cache, "third");
+
+    // first is used again so second is the oldest
+    EXPECT_TRUE(cached(cache, "first"));
+    insert(cache, "fourth");
+
+    EXPECT_EQ(cache.runCount(), 3u);
+    EXPECT_FALSE(cached(cache, "second"));
+    EXPECT_TRUE(cached(cache, "first"));
+    EXPECT_TRUE(cached(cache, "third"));
+    EXPECT_TRUE(cached(cache, "fourth"));
+
+    // the finds above used first before the others
+    insert(cache, "fifth");
+    EXPECT_FALSE(cached(cache, "first"));
+    EXPECT_EQ(cache.glyphCount(), strlen("third") + strlen("fourth") + strlen("fifth"));
+}
+
+TEST(TestTextLayoutCache, GlyphLimitEvictsOldest)
+{
+    TextLayoutCache cache(100, 10);
+    insert(cache, "abcd");
+    insert(cache, "efgh");
+    EXPECT_EQ(cache.glyphCount(), 8u);
+
+    insert(cache, "ijk");
+    EXPECT_EQ(cache.runCount(), 2u);
+    EXPECT_EQ(cache.glyphCount(), 7u);
+    EXPECT_FALSE(cached(cache, "abcd"));
+    EXPECT_TRUE(cached(cache, "efgh"));
+
+    // a run bigger than the limit still gets cached on its own
+    insert(cache, "abcdefghijkl");
+    EXPECT_EQ(cache.runCount(), 1u);
+    EXPECT_TRUE(cached(cache, "abcdefghijkl"));
+}
+
+TEST(TestTextLayoutCache, ReturnsTheStoredNodes)
+{
+    TextLayoutCache cache;
+    insert(cache, "hello");
+    auto nodes = cache.find(key("hello"), "hello", 5);
+    ASSERT_NE(nodes, nullptr);
+    ASSERT_EQ(nodes->size(), 5u);
+    for (size_t i = 0; i < nodes->size(); ++i)
+        EXPECT_EQ((*nodes)[i].dstPosition.x, static_cast<float>(i));
+
+    // utf-8 strings have fewer glyphs than bytes
+    const char* euro = "\xe2\x82\xac";
+    EXPECT_EQ(cache.insert(key(euro), euro, 3, 1).size(), 1u);
+    EXPECT_EQ(cache.glyphCount(), 6u);
+}
+
+TEST(TestTextLayoutCache, HashCollisionIsAMiss)
+{
+    TextLayoutCache cache;
+    insert(cache, "hello");
+
+    // same key, different text
+    EXPECT_EQ(cache.find(key("hello"), "world", 5), nullptr);
+    EXPECT_EQ(cache.misses(), 1u);
+
+    // inserting under the key replaces the run
+    cache.insert(key("hello"), "world", 5, 5);
+    EXPECT_EQ(cache.runCount(), 1u);
+    EXPECT_EQ(cache.glyphCount(), 5u);
+    EXPECT_NE(cache.find(key("hello"), "world", 5), nullptr);
+    EXPECT_EQ(cache.find(key("hello"), "hello", 5), nullptr);
+    EXPECT_EQ(cache.hits(), 1u);
+}
+
+TEST(TestTextLayoutCache, ClearDropsEverything)
+{
+    TextLayoutCache cache;
+    insert(cache, "first");
+    insert(cache, "second");
+    cache.clear();
+    EXPECT_EQ(cache.runCount(), 0u);
+    EXPECT_EQ(cache.glyphCount(), 0u);
+    EXPECT_FALSE(cached(cache, "first"));
+
+    // runs are reused after a clear
+    insert(cache, "third");
+    EXPECT_TRUE(cached(cache, "third"));
+}
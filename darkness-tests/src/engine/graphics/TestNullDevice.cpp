@@ -0,0 +1,164 @@
+#include "NullDeviceFixture.h"
+#include "engine/graphics/Resources.h"
+#include "engine/graphics/CommandList.h"
+#include "containers/vector.h"
+#include <numeric>
+#include <cstring>
+
+using namespace engine;
+
+class TestNullDevice : public NullDeviceTest
+{
+protected:
+    engine::vector<uint32_t> testData(size_t elements, uint32_t first)
+    {
+        engine::vector<uint32_t> data(elements);
+        std::iota(data.begin(), data.end(), first);
+        return data;
+    }
+
+    BufferDescription bufferDescription(size_t elements)
+    {
+        return BufferDescription()
+            .elementSize(sizeof(uint32_t))
+            .elements(elements)
+            .name("TestNullDevice buffer");
+    }
+
+    TextureDescription textureDescription(size_t width, size_t height)
+    {
+        return TextureDescription()
+            .width(width)
+            .height(height)
+            .format(Format::R32_UINT)
+            .name("TestNullDevice texture")
+            .dimension(ResourceDimension::Texture2D);
+    }
+};
+
+TEST_F(TestNullDevice, CreatesWithoutAWindow)
+{
+    EXPECT_EQ(device().api(), GraphicsApi::Null);
+    EXPECT_EQ(device().width(), implementation::NullDeviceDefaultWidth);
+    EXPECT_EQ(device().height(), implementation::NullDeviceDefaultHeight);
+
+    auto cmd = device().createCommandList("TestNullDevice");
+    device().submitBlocking(cmd);
+    EXPECT_EQ(statistics().commandListsSubmitted.load(), 1u);
+}
+
+TEST_F(TestNullDevice, BufferInitialDataMaps)
+{
+    auto data = testData(256, 1u);
+    auto buffer = device().createBuffer(bufferDescription(data.size())
+        .setInitialData(BufferDescription::InitialData(data)));
+
+    EXPECT_EQ(statistics().buffers.load(), 1u);
+    EXPECT_EQ(statistics().bufferBytes.load(), data.size() * sizeof(uint32_t));
+    EXPECT_EQ(statistics().uploadBytes.load(), data.size() * sizeof(uint32_t));
+
+    auto mapped = static_cast<const uint32_t*>(buffer.resource().map(device()));
+    ASSERT_NE(mapped, nullptr);
+    for (size_t i = 0; i < data.size(); ++i)
+        EXPECT_EQ(mapped[i], data[i]);
+    buffer.resource().unmap(device());
+}
+
+TEST_F(TestNullDevice, MappedWritesReachCopies)
+{
+    auto src = device().createBuffer(bufferDescription(64));
+    auto dst = device().createBuffer(bufferDescription(64).usage(ResourceUsage::GpuToCpu));
+
+    auto data = testData(64, 100u);
+    auto srcMapped = static_cast<uint32_t*>(src.resource().map(device()));
+    memcpy(srcMapped, data.data(), data.size() * sizeof(uint32_t));
+    src.resource().unmap(device());
+
+    // the middle half of the source to the start of the destination
+    auto cmd = device().createCommandList("TestNullDevice copy");
+    cmd.copyBuffer(src.resource(), dst.resource(), 32, 16, 0);
+    device().submitBlocking(cmd);
+
+    auto dstMapped = static_cast<const uint32_t*>(dst.resource().map(device()));
+    for (size_t i = 0; i < 32; ++i)
+        EXPECT_EQ(dstMapped[i], data[i + 16]);
+    for (size_t i = 32; i < 64; ++i)
+        EXPECT_EQ(dstMapped[i], 0u);
+    dst.resource().unmap(device());
+
+    EXPECT_EQ(statistics().copies.load(), 1u);
+    EXPECT_EQ(statistics().copyBytes.load(), 32 * sizeof(uint32_t));
+}
+
+TEST_F(TestNullDevice, ClearBufferRange)
+{
+    auto data = testData(64, 1u);
+    auto buffer = device().createBuffer(bufferDescription(data.size())
+        .usage(ResourceUsage::GpuReadWrite)
+        .setInitialData(BufferDescription::InitialData(data)));
+    auto uav = device().createBufferUAV(buffer);
+
+    auto cmd = device().createCommandList("TestNullDevice clear");
+    cmd.clearBuffer(uav.resource(), 0xdeadbeef, 8, 16);
+    device().submitBlocking(cmd);
+
+    auto mapped = static_cast<const uint32_t*>(buffer.resource().map(device()));
+    for (size_t i = 0; i < data.size(); ++i)
+        EXPECT_EQ(mapped[i], (i >= 8 && i < 24) ? 0xdeadbeef : data[i]) << "at element " << i;
+    buffer.resource().unmap(device());
+}
+
+TEST_F(TestNullDevice, TextureInitialDataMaps)
+{
+    const size_t width = 16;
+    const size_t height = 8;
+    auto pixels = testData(width * height, 1u);
+    auto texture = device().createTexture(textureDescription(width, height)
+        .setInitialData(TextureDescription::InitialData(
+            pixels,
+            width * sizeof(uint32_t),
+            width * height * sizeof(uint32_t))));
+
+    EXPECT_EQ(statistics().textures.load(), 1u);
+    EXPECT_EQ(statistics().textureBytes.load(), pixels.size() * sizeof(uint32_t));
+
+    auto mapped = static_cast<const uint32_t*>(texture.resource().map(device()));
+    ASSERT_NE(mapped, nullptr);
+    for (size_t i = 0; i < pixels.size(); ++i)
+        EXPECT_EQ(mapped[i], pixels[i]);
+    texture.resource().unmap(device());
+}
+
+TEST_F(TestNullDevice, TextureUploadAndReadback)
+{
+    const size_t width = 16;
+    const size_t height = 16;
+    auto texture = device().createTexture(textureDescription(width, height));
+    auto textureSrv = device().createTextureSRV(texture);
+
+    // an 8x4 block into the texture at 4, 2
+    auto block = testData(8 * 4, 1000u);
+    auto upload = device().createBuffer(bufferDescription(block.size())
+        .usage(ResourceUsage::Upload)
+        .setInitialData(BufferDescription::InitialData(block)));
+    auto readback = device().createBuffer(bufferDescription(width * height)
+        .usage(ResourceUsage::GpuToCpu));
+    auto readbackSrv = device().createBufferSRV(readback);
+
+    auto cmd = device().createCommandList("TestNullDevice texture");
+    cmd.copyTexture(upload.resource(), 0, 8, 4, 8 * sizeof(uint32_t), texture.resource(), 4, 2, 0, 0, 1);
+    cmd.copyTexture(textureSrv.resource(), readbackSrv.resource());
+    device().submitBlocking(cmd);
+
+    auto mapped = static_cast<const uint32_t*>(readback.resource().map(device()));
+    for (size_t y = 0; y < height; ++y)
+    {
+        for (size_t x = 0; x < width; ++x)
+        {
+            bool inside = x >= 4 && x < 12 && y >= 2 && y < 6;
+            auto expected = inside ? block[(y - 2) * 8 + (x - 4)] : 0u;
+            EXPECT_EQ(mapped[y * width + x], expected) << "at " << x << ", " << y;
+        }
+    }
+    readback.resource().unmap(device());
+}
@@ -0,0 +1,59 @@
+#include "NullDeviceFixture.h"
+#include "engine/graphics/Pipeline.h"
+#include "engine/graphics/PipelinePrewarm.h"
+#include "shaders/core/cull/OcclusionCull.h"
+#include "shaders/core/cull/ClustersToIndexExpand.h"
+#include "shaders/core/cull/ClustersToIndexExpandCreateArguments.h"
+#include "shaders/core/tools/copytexturertv/CopyTextureRTV2df.h"
+#include "tools/JobSystem.h"
+
+using namespace engine;
+
+class TestPipelinePrewarm : public NullDeviceTest
+{
+};
+
+TEST_F(TestPipelinePrewarm, ComputePipelinesAreCreatedOnTheJobs)
+{
+    auto occlusionCull = device().createPipeline<shaders::OcclusionCull>();
+    auto indexExpand = device().createPipeline<shaders::ClustersToIndexExpand>();
+    auto createArguments = device().createPipeline<shaders::ClustersToIndexExpandCreateArguments>();
+
+    JobSystem jobs(2);
+    PipelinePrewarm prewarm(jobs);
+    prewarm.add([&]() { occlusionCull.prewarm(); });
+    prewarm.add([&]() { indexExpand.prewarm(); });
+    prewarm.add([&]() { createArguments.prewarm(); });
+    prewarm.wait();
+
+    EXPECT_EQ(statistics().pipelinesPrewarmed.load(), 3u);
+    EXPECT_EQ(statistics().pipelineBinds.load(), 0u);
+}
+
+TEST_F(TestPipelinePrewarm, EveryPermutationOfAJob)
+{
+    auto occlusionCull = device().createPipeline<shaders::OcclusionCull>();
+
+    PipelinePrewarm prewarm;
+    prewarm.add([&]()
+    {
+        occlusionCull.cs.emitAll = false;
+        occlusionCull.prewarm();
+        occlusionCull.cs.emitAll = true;
+        occlusionCull.prewarm();
+    });
+    prewarm.wait();
+
+    EXPECT_EQ(statistics().pipelinesPrewarmed.load(), 2u);
+}
+
+TEST_F(TestPipelinePrewarm, GraphicsPipelinesWaitForTheirFirstBind)
+{
+    auto copy = device().createPipeline<shaders::CopyTextureRTV2df>();
+
+    PipelinePrewarm prewarm;
+    prewarm.add([&]() { copy.prewarm(); });
+    prewarm.wait();
+
+    EXPECT_EQ(statistics().pipelinesPrewarmed.load(), 0u);
+}
@@ -0,0 +1,265 @@
+#include "gtest/gtest.h"
+#include "engine/primitives/Matrix4.h"
+#include "engine/primitives/Quaternion.h"
+#include "engine/primitives/MathBatch.h"
+#include "containers/vector.h"
+#include "tools/Debug.h"
+#include <chrono>
+#include <random>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+using namespace engine;
+
+namespace
+{
+    // the scalar code the vector versions replace. written out here
+    // because Matrix4f itself now takes the vector path
+    Matrix4f scalarMultiply(const Matrix4f& a, const Matrix4f& b)
+    {
+        Matrix4f r;
+        for (int row = 0; row < 4; ++row)
+            for (int col = 0; col < 4; ++col)
+                (&r.m00)[row * 4 + col] =
+                    a[row * 4 + 0] * b[0 + col] +
+                    a[row * 4 + 1] * b[4 + col] +
+                    a[row * 4 + 2] * b[8 + col] +
+                    a[row * 4 + 3] * b[12 + col];
+        return r;
+    }
+
+    Vector4f scalarTransform(const Matrix4f& m, const Vector4f& v)
+    {
+        return {
+            m.m00 * v.x + m.m01 * v.y + m.m02 * v.z + m.m03 * v.w,
+            m.m10 * v.x + m.m11 * v.y + m.m12 * v.z + m.m13 * v.w,
+            m.m20 * v.x + m.m21 * v.y + m.m22 * v.z + m.m23 * v.w,
+            m.m30 * v.x + m.m31 * v.y + m.m32 * v.z + m.m33 * v.w };
+    }
+
+    Quaternionf scalarProduct(const Quaternionf& a, const Quaternionf& b)
+    {
+        return {
+            a.y * b.z - a.z * b.y + a.x * b.w + a.w * b.x,
+            a.z * b.x - a.x * b.z + a.y * b.w + a.w * b.y,
+            a.x * b.y - a.y * b.x + a.z * b.w + a.w * b.z,
+            a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z };
+    }
+
+    Matrix4d toDouble(const Matrix4f& m)
+    {
+        Matrix4d r;
+        for (int i = 0; i < 16; ++i)
+            (&r.m00)[i] = static_cast<double>(m[i]);
+        return r;
+    }
+
+    bool sameBits(const float* a, const float* b, int count)
+    {
+        return memcmp(a, b, sizeof(float) * count) == 0;
+    }
+
+    // translation, rotation and scale like the scene transforms
+    Matrix4f randomTransform(std::mt19937& random)
+    {
+        std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+        std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> scale(0.1f, 10.0f);
+        return
+            Matrix4f::translate(position(random), position(random), position(random)) *
+            Matrix4f::rotation(angle(random), angle(random), angle(random)) *
+            Matrix4f::scale(scale(random), scale(random), scale(random));
+    }
+
+    Matrix4f randomMatrix(std::mt19937& random)
+    {
+        std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+        Matrix4f m;
+        for (int i = 0; i < 16; ++i)
+            (&m.m00)[i] = value(random);
+        return m;
+    }
+}
+
+TEST(TestSimdMath, MatrixProductIsBitExact)
+{
+    std::mt19937 random(1234);
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto a = randomMatrix(random);
+        auto b = randomMatrix(random);
+        auto simd = a * b;
+        auto scalar = scalarMultiply(a, b);
+        EXPECT_TRUE(sameBits(&simd.m00, &scalar.m00, 16));
+    }
+}
+
+TEST(TestSimdMath, MatrixVectorIsBitExact)
+{
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto m = randomMatrix(random);
+        Vector4f v{ value(random), value(random), value(random), value(random) };
+        auto simd = m * v;
+        auto scalar = scalarTransform(m, v);
+        EXPECT_TRUE(sameBits(&simd.x, &scalar.x, 4));
+
+        Vector3f p{ v.x, v.y, v.z };
+        auto simdPoint = m * p;
+        auto scalarPoint = scalarTransform(m, Vector4f(p, 1.0f));
+        EXPECT_TRUE(sameBits(&simdPoint.x, &scalarPoint.x, 3));
+    }
+}
+
+TEST(TestSimdMath, TransposeIsExact)
+{
+    std::mt19937 random(1234);
+    auto m = randomMatrix(random);
+    auto t = m.transpose();
+    for (int row = 0; row < 4; ++row)
+        for (int col = 0; col < 4; ++col)
+            EXPECT_EQ(m[row * 4 + col], t[col * 4 + row]);
+}
+
+TEST(TestSimdMath, InverseWithinUlps)
+{
+    // the vector inverse groups the products differently so it isn't bit
+    // exact. the error is measured against a double precision inverse in
+    // ulps of the largest element since small elements come out of
+    // cancellation in both versions
+    constexpr float MaxUlps = 16.0f;
+
+    std::mt19937 random(1234);
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto m = randomTransform(random);
+        auto inverse = m.inverse();
+        auto reference = toDouble(m).inverse();
+
+        double largest = 0.0;
+        for (int e = 0; e < 16; ++e)
+            largest = std::max(largest, fabs(reference[e]));
+        float ulp = std::nextafter(static_cast<float>(largest), INFINITY) - static_cast<float>(largest);
+
+        for (int e = 0; e < 16; ++e)
+            EXPECT_LE(fabs(static_cast<double>(inverse[e]) - reference[e]), MaxUlps * ulp);
+    }
+
+    // singular matrices give the zero matrix like before
+    Matrix4f zero;
+    auto singular = zero.inverse();
+    EXPECT_TRUE(sameBits(&singular.m00, &zero.m00, 16));
+}
+
+TEST(TestSimdMath, QuaternionProductIsBitExact)
+{
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    for (int i = 0; i < 1000; ++i)
+    {
+        Quaternionf a{ value(random), value(random), value(random), value(random) };
+        Quaternionf b{ value(random), value(random), value(random), value(random) };
+        auto simd = a * b;
+        auto scalar = scalarProduct(a, b);
+        EXPECT_TRUE(sameBits(&simd.x, &scalar.x, 4));
+    }
+}
+
+TEST(TestSimdMath, BatchKernelsMatchOperators)
+{
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+    constexpr size_t Count = 257;
+
+    auto parent = randomTransform(random);
+    engine::vector<Matrix4f> a(Count);
+    engine::vector<Matrix4f> b(Count);
+    engine::vector<Vector3f> points(Count);
+    engine::vector<Vector4f> vectors(Count);
+    for (size_t i = 0; i < Count; ++i)
+    {
+        a[i] = randomTransform(random);
+        b[i] = randomTransform(random);
+        points[i] = { value(random), value(random), value(random) };
+        vectors[i] = { value(random), value(random), value(random), value(random) };
+    }
+
+    engine::vector<Matrix4f> matrices(Count);
+    multiply(a.data(), b.data(), matrices.data(), Count);
+    for (size_t i = 0; i < Count; ++i)
+    {
+        auto expected = a[i] * b[i];
+        EXPECT_TRUE(sameBits(&matrices[i].m00, &expected.m00, 16));
+    }
+
+    multiply(parent, b.data(), matrices.data(), Count);
+    for (size_t i = 0; i < Count; ++i)
+    {
+        auto expected = parent * b[i];
+        EXPECT_TRUE(sameBits(&matrices[i].m00, &expected.m00, 16));
+    }
+
+    // in place
+    matrices = b;
+    multiply(parent, matrices.data(), matrices.data(), Count);
+    for (size_t i = 0; i < Count; ++i)
+    {
+        auto expected = parent * b[i];
+        EXPECT_TRUE(sameBits(&matrices[i].m00, &expected.m00, 16));
+    }
+
+    engine::vector<Vector3f> transformedPoints(Count);
+    transformPoints(parent, points.data(), transformedPoints.data(), Count);
+    for (size_t i = 0; i < Count; ++i)
+    {
+        auto expected = parent * points[i];
+        EXPECT_TRUE(sameBits(&transformedPoints[i].x, &expected.x, 3));
+    }
+
+    engine::vector<Vector4f> transformedVectors(Count);
+    transformVectors(parent, vectors.data(), transformedVectors.data(), Count);
+    for (size_t i = 0; i < Count; ++i)
+    {
+        auto expected = parent * vectors[i];
+        EXPECT_TRUE(sameBits(&transformedVectors[i].x, &expected.x, 4));
+    }
+
+    normalMatrices(a.data(), matrices.data(), Count);
+    for (size_t i = 0; i < Count; ++i)
+    {
+        auto expected = a[i].inverse().transpose();
+        EXPECT_TRUE(sameBits(&matrices[i].m00, &expected.m00, 16));
+    }
+}
+
+TEST(TestSimdMath, DISABLED_MatrixPerformance)
+{
+    constexpr size_t Count = 100000;
+    constexpr int Rounds = 20;
+
+    std::mt19937 random(1234);
+    auto parent = randomTransform(random);
+    engine::vector<Matrix4f> local(Count);
+    for (auto&& m : local)
+        m = randomTransform(random);
+    engine::vector<Matrix4f> result(Count);
+
+    auto measure = [&](const char* name, auto&& work)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int round = 0; round < Rounds; ++round)
+            work();
+        auto stop = std::chrono::high_resolution_clock::now();
+        LOG_INFO("%s = %05.5f ms", name, std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count() / 1000000.0 / Rounds);
+    };
+
+    measure("scalar multiply", [&]() { for (size_t i = 0; i < Count; ++i) result[i] = scalarMultiply(parent, local[i]); });
+    measure("operator multiply", [&]() { for (size_t i = 0; i < Count; ++i) result[i] = parent * local[i]; });
+    measure("batch multiply", [&]() { multiply(parent, local.data(), result.data(), Count); });
+    measure("operator normal matrix", [&]() { for (size_t i = 0; i < Count; ++i) result[i] = local[i].inverse().transpose(); });
+    measure("batch normal matrix", [&]() { normalMatrices(local.data(), result.data(), Count); });
+    measure("scalar inverse (double)", [&]() { for (size_t i = 0; i < Count; ++i) { auto d = toDouble(local[i]).inverse(); result[i].m00 = static_cast<float>(d.m00); } });
+}
@@ -0,0 +1,327 @@
+#include "gtest/gtest.h"
+#include "ProjectionTools.h"
+#include "engine/rendering/culling/CpuCuller.h"
+#include "engine/graphics/Common.h"
+#include "tools/ToolsCommon.h"
+#include "containers/vector.h"
+#include "tools/Debug.h"
+#include <random>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+using namespace engine;
+
+namespace
+{
+    constexpr int Width = 640;
+    constexpr int Height = 360;
+    constexpr float NearPlane = 0.1f;
+    constexpr float FarPlane = 200.0f;
+
+    float depthAt(const Matrix4f& projection, float viewZ)
+    {
+        return (projection.m22 * viewZ + projection.m23) / -viewZ;
+    }
+
+    struct TestScene
+    {
+        engine::vector<TransformHistory> transforms;
+        engine::vector<LodBinding> instanceLods;
+        engine::vector<InstanceMaterial> materials;
+        engine::vector<SubMeshUVLod> lods;
+        engine::vector<SubMeshData> subMeshes;
+        engine::vector<::BoundingBox> subMeshBoxes;
+        engine::vector<::BoundingBox> clusterBoxes;
+        engine::vector<Vector4f> cones;
+        CpuClusterTracking tracking;
+
+        CpuCullingScene scene() const
+        {
+            return CpuCullingScene{
+                transforms.data(), instanceLods.data(), materials.data(), transforms.size(),
+                lods.data(), subMeshes.data(), subMeshBoxes.data(),
+                clusterBoxes.data(), cones.data() };
+        }
+    };
+
+    ::BoundingBox box(Vector3f min, Vector3f max)
+    {
+        ::BoundingBox b;
+        b.min = min;
+        b.max = max;
+        b.padding1 = 0.0f;
+        b.padding2 = 0.0f;
+        return b;
+    }
+
+    // every instance shares two lods of a unit cube.
+    // lod 0 has 8 clusters, lod 1 has one. the tracking covers both
+    TestScene createScene(size_t instanceCount, uint32_t seed)
+    {
+        TestScene s;
+
+        uint32_t clusterPointer = 0;
+        for (int z = 0; z < 2; ++z)
+            for (int y = 0; y < 2; ++y)
+                for (int x = 0; x < 2; ++x)
+                {
+                    Vector3f min{ -0.5f + 0.5f * x, -0.5f + 0.5f * y, -0.5f + 0.5f * z };
+                    s.clusterBoxes.emplace_back(box(min, min + Vector3f{ 0.5f, 0.5f, 0.5f }));
+                    s.cones.emplace_back(Vector4f{ 0.0f, 0.0f, 1.0f, 1.0f });
+                }
+        s.clusterBoxes.emplace_back(box({ -0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, 0.5f }));
+        s.cones.emplace_back(Vector4f{ 0.0f, 0.0f, 1.0f, 1.0f });
+
+        s.subMeshes.emplace_back(SubMeshData{ clusterPointer, 8u, 0u, 0u });
+        s.subMeshes.emplace_back(SubMeshData{ clusterPointer + 8u, 1u, 0u, 0u });
+        s.subMeshBoxes.emplace_back(box({ -0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, 0.5f }));
+        s.subMeshBoxes.emplace_back(box({ -0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, 0.5f }));
+        s.lods.emplace_back(SubMeshUVLod{ 0u, 0u, 0u, 0u });
+        s.lods.emplace_back(SubMeshUVLod{ 1u, 0u, 0u, 0u });
+
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> horizontal(-60.0f, 60.0f);
+        std::uniform_real_distribution<float> distance(-150.0f, 10.0f);
+        std::uniform_real_distribution<float> scale(0.5f, 6.0f);
+        const uint32_t materialSets[4] = { 0u, 0x20u, 0x40u, 0x80u };
+
+        uint32_t trackingOffset = 0;
+        for (size_t i = 0; i < instanceCount; ++i)
+        {
+            float size = scale(random);
+            TransformHistory transform;
+            transform.transform =
+                Matrix4f::translate(horizontal(random), horizontal(random) * 0.3f, distance(random)) *
+                Matrix4f::rotation(0.0f, static_cast<float>(i % 90), 0.0f) *
+                Matrix4f::scale(size, size, size);
+            transform.previousTransform = transform.transform;
+            transform.inverseTransform = transform.transform.inverse();
+            s.transforms.emplace_back(transform);
+
+            s.instanceLods.emplace_back(LodBinding{ 0u, 2u, 0u, 0u });
+
+            InstanceMaterial material = {};
+            material.materialSet = materialSets[random() % 4];
+            s.materials.emplace_back(material);
+
+            s.tracking.instanceOffset.emplace_back(trackingOffset);
+            trackingOffset += 9;
+        }
+        s.tracking.bits.resize((trackingOffset + 31) / 32, 0u);
+        return s;
+    }
+
+    CpuCullingView createView()
+    {
+        CpuCullingView view;
+        view.viewMatrix = Matrix4f::identity();
+        view.projectionMatrix = cameraPerspective(60.0f, static_cast<float>(Width) / static_cast<float>(Height), NearPlane, FarPlane);
+        view.cameraPosition = { 0.0f, 0.0f, 0.0f };
+        view.farPlaneDistance = FarPlane;
+        auto planes = extractFrustumPlanes(view.projectionMatrix * view.viewMatrix);
+        for (int i = 0; i < 6; ++i)
+            view.planes[i] = planes[i];
+        view.size = Vector2f{ static_cast<float>(Width), static_cast<float>(Height) };
+        view.pow2size = Vector2f{ static_cast<float>(roundUpToPow2(Width)), static_cast<float>(roundUpToPow2(Height)) };
+        return view;
+    }
+
+    // a wall at viewZ over the left half of the screen
+    engine::vector<float> createDepth(const CpuCullingView& view, float viewZ)
+    {
+        engine::vector<float> depth(Width * Height, 0.0f);
+        float wall = depthAt(view.projectionMatrix, viewZ);
+        for (int y = 0; y < Height; ++y)
+            for (int x = 0; x < Width / 2; ++x)
+                depth[y * Width + x] = wall;
+        return depth;
+    }
+
+    // the shader code written out with the vector operators
+    Vector3f corner(const Vector3f& bbmin, const Vector3f& bbmax, int i)
+    {
+        const Vector3f corners[8] = {
+            bbmin,
+            { bbmin.x, bbmax.y, bbmax.z },
+            { bbmin.x, bbmin.y, bbmax.z },
+            { bbmin.x, bbmax.y, bbmin.z },
+            bbmax,
+            { bbmax.x, bbmin.y, bbmin.z },
+            { bbmax.x, bbmax.y, bbmin.z },
+            { bbmax.x, bbmin.y, bbmax.z } };
+        return corners[i];
+    }
+
+    bool referenceFrustum(const ::BoundingBox& bb, const Matrix4f& transform, const CpuCullingView& view)
+    {
+        Vector3f d[8];
+        for (int c = 0; c < 8; ++c)
+        {
+            Vector4f p = transform * Vector4f(corner(bb.min, bb.max, c), 1.0f);
+            d[c] = Vector3f{ p.x, p.y, p.z } - view.cameraPosition;
+        }
+        for (int i = 0; i < 5; ++i)
+        {
+            bool hit = false;
+            for (int c = 0; c < 8; ++c)
+                hit |= view.planes[i].x * d[c].x + view.planes[i].y * d[c].y + view.planes[i].z * d[c].z >= 0.0f;
+            if (!hit)
+                return false;
+        }
+        for (int c = 0; c < 8; ++c)
+            if (std::sqrt(d[c].x * d[c].x + d[c].y * d[c].y + d[c].z * d[c].z) < view.farPlaneDistance)
+                return true;
+        return false;
+    }
+
+    bool referenceOcclusion(
+        const ::BoundingBox& bb, const Matrix4f& transform,
+        const CpuCullingView& view, const SoftwareDepthPyramid& depth)
+    {
+        Matrix4f viewProj = view.projectionMatrix * (view.viewMatrix * transform);
+        Vector2f minXY{ FLT_MAX, FLT_MAX };
+        Vector2f maxXY{ -1000000.0f, -1000000.0f };
+        float maxDepth = -1000000.0f;
+        for (int c = 0; c < 8; ++c)
+        {
+            Vector4f p = viewProj * Vector4f(corner(bb.min, bb.max, c), 1.0f);
+            float x = p.x / p.w;
+            float y = p.y / p.w;
+            float z = p.z / p.w;
+            if (z < 0.0f)
+                z = 1.0f;
+            x = ((x * 0.5f) + 0.5f) * view.size.x;
+            y = (1.0f - ((y * 0.5f) + 0.5f)) * view.size.y;
+            minXY.x = x < minXY.x ? x : minXY.x;
+            minXY.y = y < minXY.y ? y : minXY.y;
+            maxXY.x = x > maxXY.x ? x : maxXY.x;
+            maxXY.y = y > maxXY.y ? y : maxXY.y;
+            maxDepth = z > maxDepth ? z : maxDepth;
+        }
+
+        Vector2f qSize = (maxXY - minXY) / 4.0f;
+        float mipLevel = std::min(std::log2(std::max(qSize.x, qSize.y)) + 1.0f, static_cast<float>(depth.mipLevels() - 1));
+        uint32_t mip = mipLevel > 0.0f ? static_cast<uint32_t>(mipLevel) : 0u;
+        for (int x = 0; x < 4; ++x)
+        {
+            for (int y = 0; y < 4; ++y)
+            {
+                Vector2f localMinXY = minXY + Vector2f(qSize.x * x, qSize.y * y);
+                Vector2f localMaxXY = localMinXY + qSize;
+                Vector2f uvMin = localMinXY / view.pow2size;
+                Vector2f uvMax = localMaxXY / view.pow2size;
+                float minBlockDepth = std::min(
+                    std::min(depth.sample(uvMin.x, uvMin.y, mip), depth.sample(uvMax.x, uvMin.y, mip)),
+                    std::min(depth.sample(uvMin.x, uvMax.y, mip), depth.sample(uvMax.x, uvMax.y, mip)));
+                if (maxDepth >= minBlockDepth)
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    bool sameClusters(const engine::vector<ClusterInstanceData>& a, const engine::vector<ClusterInstanceData>& b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (size_t i = 0; i < a.size(); ++i)
+            if (a[i].clusterPointer != b[i].clusterPointer ||
+                a[i].instancePointer != b[i].instancePointer ||
+                a[i].lodPointer != b[i].lodPointer)
+                return false;
+        return true;
+    }
+}
+
+TEST(TestCpuCulling, DepthPyramidKeepsMinimum)
+{
+    SoftwareDepthPyramid pyramid(5, 3);
+    EXPECT_EQ(pyramid.widthPow2(), 8);
+    EXPECT_EQ(pyramid.heightPow2(), 4);
+    EXPECT_EQ(pyramid.mipLevels(), 4u);
+
+    engine::vector<float> depth(5 * 3, 1.0f);
+    depth[1 * 5 + 3] = 0.25f;
+    pyramid.update(depth.data(), 5);
+
+    // outside of the depth buffer is far
+    EXPECT_EQ(pyramid.sample(0.99f, 0.1f, 0), 0.0f);
+    EXPECT_EQ(pyramid.sample(0.1f, 0.1f, 0), 1.0f);
+    EXPECT_EQ(pyramid.sample(0.4f, 0.3f, 1), 0.25f);
+    EXPECT_EQ(pyramid.sample(0.1f, 0.1f, 3), 0.0f);
+
+    // clamped addressing
+    EXPECT_EQ(pyramid.sample(-1.0f, -1.0f, 0), 1.0f);
+    EXPECT_EQ(pyramid.sample(0.1f, 0.1f, 10), 0.0f);
+}
+
+TEST(TestCpuCulling, SurvivorsMatchShaderLogic)
+{
+    auto s = createScene(3000, 1234);
+    auto scene = s.scene();
+    auto view = createView();
+
+    auto depthBuffer = createDepth(view, -40.0f);
+    SoftwareDepthPyramid depth(Width, Height);
+    depth.update(depthBuffer.data(), Width);
+
+    CpuCuller culler;
+    engine::vector<FrustumCullingOutput> instances;
+    culler.instanceCull(view, scene, &depth, instances);
+
+    // instance pass
+    engine::vector<uint32_t> expectedInstances;
+    for (uint32_t i = 0; i < scene.instanceCount; ++i)
+    {
+        const auto& transform = s.transforms[i].transform;
+        Vector2f minXY, maxXY;
+        float maxDepth;
+        culling::screenMinMaxXYZ(view.viewMatrix, view.projectionMatrix, transform,
+            s.subMeshBoxes[0].min, s.subMeshBoxes[0].max, view.size, minXY, maxXY, maxDepth);
+        uint32_t lod = std::min(culling::lodFromScreenSize(maxXY - minXY), 1u);
+        const auto& bb = s.subMeshBoxes[s.lods[lod].submeshPointer];
+        if (referenceFrustum(bb, transform, view) && referenceOcclusion(s.subMeshBoxes[0], transform, view, depth))
+            expectedInstances.emplace_back(i);
+    }
+    ASSERT_EQ(instances.size(), expectedInstances.size());
+    for (size_t i = 0; i < instances.size(); ++i)
+        EXPECT_EQ(instances[i].instancePointer, expectedInstances[i]);
+    EXPECT_GT(instances.size(), 0u);
+    EXPECT_LT(instances.size(), scene.instanceCount);
+
+    // cluster pass
+    engine::vector<ClusterInstanceData> clusters;
+    CpuCuller::expandClusters(instances, clusters);
+
+    CpuClusterOutput frustumOutput;
+    culler.clusterCull(view, scene, clusters, s.tracking, frustumOutput);
+    EXPECT_EQ(
+        frustumOutput.opaque.size() + frustumOutput.alphaClipped.size() +
+        frustumOutput.transparent.size() + frustumOutput.terrain.size(), clusters.size());
+
+    // occlusion pass against the tracking of the pass above
+    CpuClusterOutput occlusionOutput;
+    culler.occlusionCull(view, scene, depth, clusters, s.tracking, occlusionOutput);
+
+    engine::vector<ClusterInstanceData> expectedClusters;
+    for (auto&& cluster : clusters)
+    {
+        const auto& transform = s.transforms[cluster.instancePointer].transform;
+        const auto& bb = s.clusterBoxes[cluster.clusterPointer];
+        if (referenceFrustum(bb, transform, view) && referenceOcclusion(bb, transform, view, depth))
+            expectedClusters.emplace_back(cluster);
+    }
+    EXPECT_TRUE(sameClusters(occlusionOutput.all, expectedClusters));
+
+    // everything was drawn by the cluster pass
+    EXPECT_EQ(occlusionOutput.opaque.size(), 0u);
+    EXPECT_EQ(occlusionOutput.alphaClipped.size(), 0u);
+
+    const auto& stats = culler.statistics();
+    EXPECT_EQ(stats.instancesTested, scene.instanceCount);
+    EXPECT_EQ(stats.instancesPassed, instances.size());
+    EXPECT_EQ(stats.instancesTested, stats.instancesPassed + stats.instancesFrustumCulled + stats.instancesOcclusionCulled);
+    EXPECT_GT(stats.instanceEfficiency(), 0.0);
+    EXPECT_LT(stats.instanceEfficiency(), 1.0);
+}
@@ -0,0 +1,186 @@
+#include "gtest/gtest.h"
+#include "ProjectionTools.h"
+#include "engine/rendering/LightBinning.h"
+#include "engine/rendering/LightData.h"
+#include "components/LightComponent.h"
+#include "containers/vector.h"
+#include "tools/Debug.h"
+#include <random>
+#include <cmath>
+
+using namespace engine;
+
+namespace
+{
+    constexpr float NearPlane = 0.1f;
+    constexpr float FarPlane = 1000.0f;
+    constexpr float Pi = 3.14159265f;
+
+    // camera at the origin looking down -z
+    LightBinningView view(int width, int height)
+    {
+        return LightBinningView{
+            Matrix4f::identity(),
+            cameraPerspective(60.0f, static_cast<float>(width) / static_cast<float>(height), NearPlane, FarPlane),
+            width, height, NearPlane, FarPlane };
+    }
+
+    bool inView(const LightBinningView& view, const Vector3f& position)
+    {
+        float depth = -position.z;
+        if (depth <= NearPlane || depth >= FarPlane)
+            return false;
+        float x = view.projectionMatrix.m00 * position.x / depth;
+        float y = view.projectionMatrix.m11 * position.y / depth;
+        return std::abs(x) < 1.0f && std::abs(y) < 1.0f;
+    }
+
+    FlatSceneLightNode light(LightType type, const Vector3f& position, const Vector3f& direction, float range)
+    {
+        auto component = engine::make_shared<LightComponent>();
+        component->lightType(type);
+        component->range(range);
+
+        FlatSceneLightNode node{};
+        node.transform = Matrix4f::translate(position);
+        node.position = position;
+        node.direction = direction;
+        node.range = range;
+        node.type = type;
+        node.light = component;
+        return node;
+    }
+
+    // every fourth light is a spot
+    engine::vector<FlatSceneLightNode> randomLights(size_t count, uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> side(-200.0f, 200.0f);
+        std::uniform_real_distribution<float> height(-20.0f, 20.0f);
+        std::uniform_real_distribution<float> depth(-400.0f, -1.0f);
+        std::uniform_real_distribution<float> range(2.0f, 10.0f);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+        engine::vector<FlatSceneLightNode> lights;
+        for (size_t i = 0; i < count; ++i)
+        {
+            Vector3f position{ side(random), height(random), depth(random) };
+            if (i % 4 == 0)
+            {
+                Vector3f direction{ unit(random), unit(random), unit(random) };
+                if (direction.magnitude() < 0.1f)
+                    direction = Vector3f{ 0.0f, 0.0f, 1.0f };
+                lights.emplace_back(light(LightType::Spot, position, direction.normalize(), range(random)));
+            }
+            else
+                lights.emplace_back(light(LightType::Point, position, Vector3f{ 0.0f, 0.0f, 1.0f }, range(random)));
+        }
+        return lights;
+    }
+}
+
+TEST(TestLightBinning, LightsAtPosition)
+{
+    auto lights = engine::vector<FlatSceneLightNode>{
+        light(LightType::Point, Vector3f{ 0.0f, 0.0f, -20.0f }, Vector3f{ 0.0f, 0.0f, 1.0f }, 5.0f),
+        light(LightType::Point, Vector3f{ 100.0f, 0.0f, -20.0f }, Vector3f{ 0.0f, 0.0f, 1.0f }, 2.0f),
+        light(LightType::Spot, Vector3f{ 0.0f, 0.0f, -40.0f }, Vector3f{ 0.0f, 0.0f, 1.0f }, 20.0f),
+        light(LightType::Directional, Vector3f{ 0.0f, 0.0f, 0.0f }, Vector3f{ 0.0f, -1.0f, 0.0f }, 1.0f) };
+    LightData data;
+    data.stage(lights);
+
+    JobSystem serial(0);
+    LightBinning binning(16, serial);
+    binning.update(view(1920, 1080), data);
+    EXPECT_EQ(binning.binsX(), 240u);
+    EXPECT_EQ(binning.binsY(), 135u);
+    EXPECT_EQ(binning.statistics().lightsBinned, 2u);
+    EXPECT_EQ(binning.statistics().lightsOutside, 1u);
+
+    EXPECT_TRUE(binning.lightsAt(Vector3f{ 0.0f, 0.0f, -20.0f }).contains(0));
+    EXPECT_TRUE(binning.lightsAt(Vector3f{ 3.0f, 0.0f, -23.0f }).contains(0));
+    EXPECT_FALSE(binning.lightsAt(Vector3f{ 0.0f, 0.0f, -40.0f }).contains(0));
+
+    // the spot shines against its direction
+    EXPECT_TRUE(binning.lightsAt(Vector3f{ 0.0f, 0.0f, -50.0f }).contains(2));
+    EXPECT_FALSE(binning.lightsAt(Vector3f{ -25.0f, 0.0f, -50.0f }).contains(2));
+    EXPECT_FALSE(binning.lightsAt(Vector3f{ 0.0f, 0.0f, -20.0f }).contains(2));
+
+    EXPECT_EQ(binning.lightsAt(Vector3f{ 0.0f, 0.0f, 10.0f }).count, 0u);
+    for (uint32_t slice = 0; slice < binning.slices(); ++slice)
+        EXPECT_FALSE(binning.lights(120, 67, slice).contains(3));
+}
+
+TEST(TestLightBinning, LightsAreFoundInsideTheirVolume)
+{
+    auto lights = randomLights(1000, 1234);
+    LightData data;
+    data.stage(lights);
+
+    auto binningView = view(1280, 720);
+    JobSystem serial(0);
+    LightBinning binning(16, serial);
+    binning.update(binningView, data);
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    size_t tested = 0;
+    for (uint32_t i = 0; i < lights.size(); ++i)
+    {
+        const auto& node = lights[i];
+        for (int sample = 0; sample < 32; ++sample)
+        {
+            Vector3f position;
+            if (node.type == LightType::Point)
+            {
+                Vector3f offset{ unit(random) * 2.0f - 1.0f, unit(random) * 2.0f - 1.0f, unit(random) * 2.0f - 1.0f };
+                if (offset.magnitude() > 1.0f)
+                    continue;
+                position = node.position + offset * node.range;
+            }
+            else
+            {
+                Vector3f axis = node.direction * -1.0f;
+                Vector3f side = std::abs(axis.y) < 0.9f ? Vector3f{ 0.0f, 1.0f, 0.0f } : Vector3f{ 1.0f, 0.0f, 0.0f };
+                Vector3f u = axis.cross(side).normalize();
+                Vector3f v = axis.cross(u);
+
+                float along = unit(random) * node.range;
+                float radius = along * std::tan(node.light->outerConeAngle() * Pi / 180.0f) * unit(random);
+                float angle = unit(random) * 2.0f * Pi;
+                position = node.position + axis * along + u * (radius * std::cos(angle)) + v * (radius * std::sin(angle));
+            }
+
+            if (!inView(binningView, position))
+                continue;
+
+            ASSERT_TRUE(binning.lightsAt(position).contains(i)) << "light " << i;
+            ++tested;
+        }
+    }
+    EXPECT_GT(tested, 1000u);
+}
+
+TEST(TestLightBinning, ClusterListsAreSorted)
+{
+    auto lights = randomLights(2000, 99);
+    LightData data;
+    data.stage(lights);
+
+    LightBinning binning(16);
+    binning.update(view(1280, 720), data);
+
+    EXPECT_GT(binning.statistics().entries, 0u);
+    for (uint32_t slice = 0; slice < binning.slices(); ++slice)
+    {
+        for (uint32_t y = 0; y < binning.binsY(); ++y)
+        {
+            for (uint32_t x = 0; x < binning.binsX(); ++x)
+            {
+                auto list = binning.lights(x, y, slice);
+                for (uint32_t i = 1; i < list.count; ++i)
+                    ASSERT_LT(list.first[i - 1], list.first[i]);
+            }
+        }
+    }
+}
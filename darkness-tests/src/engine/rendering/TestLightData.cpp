@@ -0,0 +1,152 @@
+#include "gtest/gtest.h"
+#include "engine/rendering/LightData.h"
+#include "components/LightComponent.h"
+#include "containers/vector.h"
+#include "tools/Debug.h"
+#include <chrono>
+
+using namespace engine;
+
+namespace
+{
+    FlatSceneLightNode lightNode(engine::shared_ptr<LightComponent> light, const Vector3f& position)
+    {
+        FlatSceneLightNode node{};
+        node.transform = Matrix4f::translate(position);
+        node.position = position;
+        node.direction = Vector3f{ 0.0f, 0.0f, 1.0f };
+        node.range = light->range();
+        node.type = light->lightType();
+        node.shadowCaster = false;
+        node.positionChanged = true;
+        node.rotationChanged = true;
+        node.light = light;
+        return node;
+    }
+
+    engine::vector<FlatSceneLightNode> createLights(size_t count)
+    {
+        engine::vector<FlatSceneLightNode> lights;
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto light = engine::make_shared<LightComponent>();
+            light->lightType(i % 4 == 0 ? LightType::Spot : LightType::Point);
+            lights.emplace_back(lightNode(light, Vector3f{ static_cast<float>(i), 0.0f, 0.0f }));
+        }
+        return lights;
+    }
+
+    void move(FlatSceneLightNode& node, float offset)
+    {
+        node.position.y += offset;
+        node.transform = Matrix4f::translate(node.position);
+    }
+}
+
+TEST(TestLightData, IndicesStayWhenLightsAreRemoved)
+{
+    auto lights = createLights(4);
+    LightData data;
+    data.stage(lights);
+    EXPECT_EQ(data.count(), 4u);
+    EXPECT_EQ(data.spotCount(), 1u);
+    EXPECT_EQ(data.pointCount(), 3u);
+
+    auto third = lights[2].light;
+    auto fourth = lights[3].light;
+    lights.erase(lights.begin() + 1);
+    data.stage(lights);
+
+    EXPECT_EQ(data.count(), 4u);
+    EXPECT_EQ(data.activeCount(), 3u);
+    EXPECT_EQ(data.index(third.get()), 2u);
+    EXPECT_EQ(data.index(fourth.get()), 3u);
+    EXPECT_EQ(data.engineTypes()[1], LightData::FreeLightType);
+    EXPECT_EQ(data.cpuranges()[1], 0.0f);
+    EXPECT_EQ(data.pointCount(), 2u);
+    EXPECT_EQ(data.uploadStatistics().lightsRemoved, 1u);
+
+    // a new light takes the free slot
+    auto added = createLights(1);
+    lights.emplace_back(added[0]);
+    data.stage(lights);
+    EXPECT_EQ(data.count(), 4u);
+    EXPECT_EQ(data.index(added[0].light.get()), 1u);
+
+    // free slots at the end go away
+    lights.pop_back();
+    lights.pop_back();
+    data.stage(lights);
+    EXPECT_EQ(data.count(), 3u);
+    EXPECT_EQ(data.activeCount(), 2u);
+    EXPECT_EQ(data.index(fourth.get()), LightData::InvalidLightIndex);
+}
+
+TEST(TestLightData, OnlyChangedLightsAreUploaded)
+{
+    auto lights = createLights(1000);
+    LightData data;
+    data.stage(lights);
+    EXPECT_EQ(data.uploadStatistics().lightsAdded, 1000u);
+    EXPECT_GT(data.uploadStatistics().bytes, 1000u * sizeof(Matrix4f));
+    EXPECT_TRUE(data.changeHappened());
+
+    // the scene flags every light as moved every frame
+    data.stage(lights);
+    EXPECT_EQ(data.uploadStatistics().uploads, 0u);
+    EXPECT_EQ(data.uploadStatistics().bytes, 0u);
+    EXPECT_FALSE(data.changeHappened());
+
+    // point lights close to each other go out in one copy per buffer
+    move(lights[9], 1.0f);
+    move(lights[11], 1.0f);
+    data.stage(lights);
+    EXPECT_EQ(data.uploadStatistics().lightsChanged, 2u);
+    EXPECT_EQ(data.uploadStatistics().uploads, 2u);
+    EXPECT_EQ(data.uploadStatistics().bytes, 3u * (sizeof(Matrix4f) + sizeof(Vector4f)));
+    EXPECT_EQ(data.positions()[9].y, 1.0f);
+
+    // spot lights also update their packed transform and range
+    move(lights[8], 1.0f);
+    data.stage(lights);
+    EXPECT_EQ(data.uploadStatistics().uploads, 4u);
+    EXPECT_EQ(data.uploadStatistics().bytes, 2u * sizeof(Matrix4f) + sizeof(Vector4f) + sizeof(float));
+
+    lights[501].light->range(42.0f);
+    data.stage(lights);
+    EXPECT_TRUE(data.changeHappened());
+    EXPECT_EQ(data.cpuranges()[501], 42.0f);
+    EXPECT_EQ(data.cpupointranges()[501 - 501 / 4 - 1], 42.0f);
+}
+
+TEST(TestLightData, DISABLED_LightUpdatePerformance)
+{
+    for (size_t count : { 10000u, 100000u })
+    {
+        for (size_t dynamicEvery : { 1u, 10u, 100u })
+        {
+            auto lights = createLights(count);
+            LightData data;
+            data.stage(lights);
+
+            const int frames = 20;
+            double ms = 0.0;
+            size_t bytes = 0;
+            size_t uploads = 0;
+            for (int frame = 0; frame < frames; ++frame)
+            {
+                for (size_t i = 0; i < lights.size(); i += dynamicEvery)
+                    move(lights[i], 0.01f);
+
+                auto start = std::chrono::high_resolution_clock::now();
+                data.stage(lights);
+                ms += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+                bytes += data.uploadStatistics().bytes;
+                uploads += data.uploadStatistics().uploads;
+            }
+
+            LOG_INFO("LightData %zu lights, every %zu. moving. %f ms, %zu bytes in %zu copies per frame",
+                count, dynamicEvery, ms / frames, bytes / frames, uploads / frames);
+        }
+    }
+}
@@ -0,0 +1,309 @@
+#include "gtest/gtest.h"
+#include "engine/rendering/MeshletCompression.h"
+#include "engine/rendering/ModelCpu.h"
+#include "tools/Debug.h"
+#include "containers/vector.h"
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+
+using namespace engine;
+
+namespace
+{
+    constexpr float Pi = 3.14159265f;
+
+    // wavy grid with every stream a model from ModelTask has
+    ModelCpu testModel(uint32_t columns, uint32_t rows, float size)
+    {
+        ModelCpu model;
+        model.uv.resize(2);
+        model.color.resize(1);
+
+        Vector3f minPos{ 0.0f, 0.0f, 0.0f };
+        Vector3f maxPos{ 0.0f, 0.0f, 0.0f };
+        for (uint32_t y = 0; y <= rows; ++y)
+        {
+            for (uint32_t x = 0; x <= columns; ++x)
+            {
+                float u = static_cast<float>(x) / static_cast<float>(columns);
+                float v = static_cast<float>(y) / static_cast<float>(rows);
+                float height = std::sin(u * 8.0f * Pi) * std::cos(v * 6.0f * Pi) * size * 0.05f;
+                Vector3f position{ (u - 0.5f) * size, height, (v - 0.5f) * size };
+
+                float dx = std::cos(u * 8.0f * Pi) * std::cos(v * 6.0f * Pi) * 8.0f * Pi * 0.05f;
+                float dz = -std::sin(u * 8.0f * Pi) * std::sin(v * 6.0f * Pi) * 6.0f * Pi * 0.05f;
+
+                model.vertex.emplace_back(position);
+                model.normal.emplace_back(Vector3f{ -dx, 1.0f, -dz }.normalize());
+                model.tangent.emplace_back(Vector3f{ 1.0f, dx, 0.0f }.normalize());
+                model.uv[0].emplace_back(Vector2f{ u, v });
+                model.uv[1].emplace_back(Vector2f{ u * 16.0f - 8.0f, v * 4.0f });
+                model.color[0].emplace_back(Vector4f{ u, v, 1.0f - u, 1.0f });
+
+                minPos = Vector3f{ std::min(minPos.x, position.x), std::min(minPos.y, position.y), std::min(minPos.z, position.z) };
+                maxPos = Vector3f{ std::max(maxPos.x, position.x), std::max(maxPos.y, position.y), std::max(maxPos.z, position.z) };
+            }
+        }
+
+        // 8x4 quad tiles, about what the clustering in ModelTask gives
+        for (uint32_t tileY = 0; tileY < rows; tileY += 4)
+        {
+            for (uint32_t tileX = 0; tileX < columns; tileX += 8)
+            {
+                for (uint32_t y = tileY; y < std::min(tileY + 4, rows); ++y)
+                {
+                    for (uint32_t x = tileX; x < std::min(tileX + 8, columns); ++x)
+                    {
+                        uint32_t i0 = y * (columns + 1) + x;
+                        uint32_t i1 = i0 + 1;
+                        uint32_t i2 = i0 + columns + 1;
+                        uint32_t i3 = i2 + 1;
+                        model.index.insert(model.index.end(), { i0, i2, i1, i1, i2, i3 });
+                    }
+                }
+            }
+        }
+        model.boundingBox = engine::BoundingBox(minPos, maxPos);
+        return model;
+    }
+
+    size_t modelBytes(const ModelCpu& model)
+    {
+        size_t bytes =
+            model.vertex.size() * sizeof(Vector3f) +
+            model.normal.size() * sizeof(Vector3f) +
+            model.tangent.size() * sizeof(Vector3f) +
+            model.index.size() * sizeof(uint32_t);
+        for (auto&& channel : model.uv)
+            bytes += channel.size() * sizeof(Vector2f);
+        for (auto&& channel : model.color)
+            bytes += channel.size() * sizeof(Vector4f);
+        return bytes;
+    }
+
+    // ModelPackedCpu of the same model
+    size_t packedModelBytes(const ModelCpu& model)
+    {
+        return
+            model.vertex.size() * (sizeof(Vector2<uint32_t>) + 2 * sizeof(Vector2f) + 2 * sizeof(Vector2f) + sizeof(Vector4<unsigned char>)) +
+            model.index.size() * sizeof(uint16_t);
+    }
+
+    // in doubles, acos of a float dot can't resolve angles this small
+    double angleDegrees(const Vector3f& a, const Vector3f& b)
+    {
+        double ax = a.x, ay = a.y, az = a.z;
+        double bx = b.x, by = b.y, bz = b.z;
+        double cx = ay * bz - az * by;
+        double cy = az * bx - ax * bz;
+        double cz = ax * by - ay * bx;
+        return std::atan2(std::sqrt(cx * cx + cy * cy + cz * cz), ax * bx + ay * by + az * bz) * 180.0 / 3.14159265358979;
+    }
+}
+
+TEST(TestMeshletCompression, HalfFloat)
+{
+    for (float value : { 0.0f, 1.0f, -2.0f, 0.5f, 65504.0f, 6.1035156e-05f, 5.9604645e-08f })
+        EXPECT_EQ(halfToFloat(floatToHalf(value)), value);
+
+    EXPECT_TRUE(std::isinf(halfToFloat(floatToHalf(100000.0f))));
+    EXPECT_TRUE(std::isnan(halfToFloat(floatToHalf(std::nanf("")))));
+    EXPECT_EQ(halfToFloat(floatToHalf(1e-9f)), 0.0f);
+
+    // rounding to nearest even
+    EXPECT_EQ(halfToFloat(floatToHalf(1.0f + 1.0f / 2048.0f)), 1.0f);
+    EXPECT_EQ(halfToFloat(floatToHalf(1.0f + 3.0f / 2048.0f)), 1.0f + 2.0f / 1024.0f);
+}
+
+TEST(TestMeshletCompression, MeshletLimits)
+{
+    auto model = testModel(100, 80, 10.0f);
+    auto mesh = compressMeshlets(model);
+
+    EXPECT_EQ(mesh.triangleCount(), model.index.size() / 3);
+    size_t triangles = 0;
+    for (size_t i = 0; i < mesh.meshlets.size(); ++i)
+    {
+        const auto& meshlet = mesh.meshlets[i];
+        EXPECT_GT(meshlet.triangleCount, 0u);
+        EXPECT_LE(meshlet.triangleCount, MeshletMaxTriangles);
+        EXPECT_LE(meshlet.vertexCount, MeshletMaxVertices);
+        EXPECT_EQ(meshlet.triangleStart, triangles);
+        triangles += meshlet.triangleCount;
+    }
+    EXPECT_EQ(triangles, mesh.triangleCount());
+    EXPECT_LT(mesh.sizeBytes(), packedModelBytes(model));
+}
+
+TEST(TestMeshletCompression, DecodeIsWithinErrorBounds)
+{
+    auto model = testModel(100, 80, 1000.0f);
+    auto mesh = compressMeshlets(model);
+    auto decoded = decompressMeshlets(mesh);
+
+    ASSERT_EQ(decoded.index.size(), model.index.size());
+    ASSERT_EQ(decoded.uv.size(), model.uv.size());
+    ASSERT_EQ(decoded.color.size(), model.color.size());
+
+    double maxNormalError = 0.0;
+    double maxTangentError = 0.0;
+    for (size_t m = 0; m < mesh.meshlets.size(); ++m)
+    {
+        const auto& meshlet = mesh.meshlets[m];
+        // quantisation step plus the float math of the decode
+        Vector3f bound = meshletPositionError(meshlet) * 1.01f + Vector3f{ 1e-4f, 1e-4f, 1e-4f };
+
+        for (uint32_t i = meshlet.triangleStart * 3; i < (meshlet.triangleStart + meshlet.triangleCount) * 3; ++i)
+        {
+            auto original = model.index[i];
+            auto vertex = decoded.index[i];
+
+            EXPECT_NEAR(decoded.vertex[vertex].x, model.vertex[original].x, bound.x);
+            EXPECT_NEAR(decoded.vertex[vertex].y, model.vertex[original].y, bound.y);
+            EXPECT_NEAR(decoded.vertex[vertex].z, model.vertex[original].z, bound.z);
+
+            maxNormalError = std::max(maxNormalError, angleDegrees(decoded.normal[vertex], model.normal[original]));
+            maxTangentError = std::max(maxTangentError, angleDegrees(decoded.tangent[vertex], model.tangent[original]));
+
+            // half floats keep 11 bits of the value
+            for (size_t channel = 0; channel < model.uv.size(); ++channel)
+            {
+                const auto& uv = model.uv[channel][original];
+                const auto& decodedUv = decoded.uv[channel][vertex];
+                EXPECT_NEAR(decodedUv.x, uv.x, std::max(std::abs(uv.x), 6.1e-5f) / 2048.0f);
+                EXPECT_NEAR(decodedUv.y, uv.y, std::max(std::abs(uv.y), 6.1e-5f) / 2048.0f);
+            }
+
+            EXPECT_NEAR(decoded.color[0][vertex].x, model.color[0][original].x, 0.5f / 255.0f + 1e-6f);
+            EXPECT_NEAR(decoded.color[0][vertex].w, model.color[0][original].w, 0.5f / 255.0f + 1e-6f);
+        }
+    }
+    EXPECT_LT(maxNormalError, 0.01);
+    EXPECT_LT(maxTangentError, 0.01);
+}
+
+TEST(TestMeshletCompression, PackRoundTrip)
+{
+    auto model = testModel(60, 40, 10.0f);
+    model.tangent.clear();
+    model.color.clear();
+    auto mesh = compressMeshlets(model);
+
+    for (bool entropyCode : { false, true })
+    {
+        auto packed = packMeshlets(mesh, entropyCode);
+
+        CompressedMesh unpacked;
+        ASSERT_TRUE(unpackMeshlets(packed, unpacked));
+        EXPECT_EQ(unpacked.meshlets.size(), mesh.meshlets.size());
+        EXPECT_EQ(unpacked.position, mesh.position);
+        EXPECT_EQ(unpacked.normal, mesh.normal);
+        EXPECT_TRUE(unpacked.tangent.empty());
+        EXPECT_EQ(unpacked.uv, mesh.uv);
+        EXPECT_TRUE(unpacked.color.empty());
+        EXPECT_EQ(unpacked.index, mesh.index);
+        EXPECT_EQ(unpacked.boundingBox.max.x, mesh.boundingBox.max.x);
+        for (size_t i = 0; i < mesh.meshlets.size(); ++i)
+        {
+            EXPECT_EQ(unpacked.meshlets[i].vertexStart, mesh.meshlets[i].vertexStart);
+            EXPECT_EQ(unpacked.meshlets[i].boundsMin.y, mesh.meshlets[i].boundsMin.y);
+        }
+    }
+
+    auto packed = packMeshlets(mesh, false);
+    packed.resize(packed.size() - 5);
+    CompressedMesh unpacked;
+    EXPECT_FALSE(unpackMeshlets(packed, unpacked));
+}
+
+TEST(TestMeshletCompression, UnpackRejectsMalformedEntropyCoding)
+{
+    auto mesh = compressMeshlets(testModel(20, 20, 10.0f));
+    const auto packed = packMeshlets(mesh, true);
+
+    // byte offsets into the 64 byte blob header
+    const size_t vertexCountOffset = 16;
+    const size_t uvChannelsOffset = 24;
+    const size_t payloadBytesOffset = 56;
+    const size_t headerBytes = 64;
+
+    auto rejected = [](const engine::vector<char>& data)
+    {
+        CompressedMesh unpacked;
+        bool result = unpackMeshlets(data, unpacked);
+        EXPECT_TRUE(unpacked.meshlets.empty());
+        return !result;
+    };
+
+    CompressedMesh unpacked;
+    ASSERT_TRUE(unpackMeshlets(packed, unpacked));
+
+    // not a zstd frame
+    auto data = packed;
+    data[headerBytes] = 0;
+    EXPECT_TRUE(rejected(data));
+
+    // the payload size does not match the counts
+    data = packed;
+    uint64_t payloadBytes;
+    memcpy(&payloadBytes, data.data() + payloadBytesOffset, sizeof(uint64_t));
+    payloadBytes += 8;
+    memcpy(data.data() + payloadBytesOffset, &payloadBytes, sizeof(uint64_t));
+    EXPECT_TRUE(rejected(data));
+
+    // counts that would need gigabytes
+    data = packed;
+    uint32_t vertexCount = 0xffffffff;
+    memcpy(data.data() + vertexCountOffset, &vertexCount, sizeof(uint32_t));
+    EXPECT_TRUE(rejected(data));
+
+    data = packed;
+    uint32_t uvChannels = 0xffffffff;
+    memcpy(data.data() + uvChannelsOffset, &uvChannels, sizeof(uint32_t));
+    EXPECT_TRUE(rejected(data));
+
+    // the frame header is fine but the frame is cut short
+    data = packed;
+    data.resize(data.size() - 16);
+    EXPECT_TRUE(rejected(data));
+
+    data = packed;
+    data.resize(headerBytes + 2);
+    EXPECT_TRUE(rejected(data));
+}
+
+TEST(TestMeshletCompression, DISABLED_SizeAndDecodePerformance)
+{
+    for (uint32_t side : { 128u, 512u, 1024u })
+    {
+        auto model = testModel(side, side, 100.0f);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        auto mesh = compressMeshlets(model);
+        double compressMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        auto raw = packMeshlets(mesh, false);
+        auto entropyCoded = packMeshlets(mesh, true);
+
+        const int rounds = 10;
+        double decodeMs = 0.0;
+        size_t vertexes = 0;
+        for (int i = 0; i < rounds; ++i)
+        {
+            start = std::chrono::high_resolution_clock::now();
+            auto decoded = decompressMeshlets(mesh);
+            decodeMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+            vertexes += decoded.vertex.size();
+        }
+        decodeMs /= rounds;
+
+        size_t triangles = mesh.triangleCount();
+        LOG_INFO("Meshlets %zu triangles, %zu meshlets, %zu vertexes (%zu in the model). float: %zu bytes, packed: %zu bytes, meshlets: %zu bytes, entropy coded: %zu bytes",
+            triangles, mesh.meshlets.size(), mesh.vertexCount(), model.vertex.size(),
+            modelBytes(model), packedModelBytes(model), raw.size(), entropyCoded.size());
+        LOG_INFO("Meshlets compress: %f ms, decode: %f ms, %f M triangles/s (%zu)",
+            compressMs, decodeMs, static_cast<double>(triangles) / (decodeMs * 1000.0), vertexes);
+    }
+}
@@ -0,0 +1,90 @@
+#include "gtest/gtest.h"
+#include "engine/rendering/Mesh.h"
+#include "containers/vector.h"
+
+using namespace engine;
+
+namespace
+{
+    uint64_t partIndexes(const engine::vector<uint32_t>& meshIndexCounts, const ModelPartMeshes& part)
+    {
+        uint64_t indexes = 0;
+        for (auto mesh = part.first; mesh < part.first + part.count; ++mesh)
+            indexes += meshIndexCounts[mesh];
+        return indexes;
+    }
+
+    void expectContiguous(const engine::vector<uint32_t>& meshIndexCounts, const engine::vector<ModelPartMeshes>& parts)
+    {
+        uint32_t next = 0;
+        for (auto&& part : parts)
+        {
+            EXPECT_EQ(part.first, next);
+            EXPECT_GT(part.count, 0u);
+            next = part.first + part.count;
+        }
+        EXPECT_EQ(next, static_cast<uint32_t>(meshIndexCounts.size()));
+    }
+}
+
+TEST(TestModelParts, SmallModelIsOnePart)
+{
+    engine::vector<uint32_t> meshIndexCounts{ 3000, 60000, 9000 };
+    auto parts = splitModelParts(meshIndexCounts, 8);
+
+    ASSERT_EQ(parts.size(), 1u);
+    EXPECT_EQ(parts[0].first, 0u);
+    EXPECT_EQ(parts[0].count, 3u);
+}
+
+TEST(TestModelParts, PartsFollowTheIndexCount)
+{
+    engine::vector<uint32_t> meshIndexCounts(16, static_cast<uint32_t>(ModelPartIndexes / 4));
+    auto parts = splitModelParts(meshIndexCounts, 8);
+
+    ASSERT_EQ(parts.size(), 4u);
+    expectContiguous(meshIndexCounts, parts);
+    for (auto&& part : parts)
+        EXPECT_EQ(partIndexes(meshIndexCounts, part), ModelPartIndexes);
+}
+
+TEST(TestModelParts, NoMorePartsThanMeshesOrWorkers)
+{
+    engine::vector<uint32_t> twoMeshes{ static_cast<uint32_t>(ModelPartIndexes * 3), static_cast<uint32_t>(ModelPartIndexes) };
+    auto parts = splitModelParts(twoMeshes, 8);
+    ASSERT_EQ(parts.size(), 2u);
+    expectContiguous(twoMeshes, parts);
+
+    engine::vector<uint32_t> manyMeshes(32, static_cast<uint32_t>(ModelPartIndexes));
+    parts = splitModelParts(manyMeshes, 3);
+    ASSERT_EQ(parts.size(), 3u);
+    expectContiguous(manyMeshes, parts);
+}
+
+TEST(TestModelParts, OneLargeMeshDoesNotEmptyTheOtherParts)
+{
+    engine::vector<uint32_t> meshIndexCounts{ static_cast<uint32_t>(ModelPartIndexes * 4), 300, 300, 300 };
+    auto parts = splitModelParts(meshIndexCounts, 4);
+
+    ASSERT_EQ(parts.size(), 4u);
+    expectContiguous(meshIndexCounts, parts);
+    EXPECT_EQ(parts[0].count, 1u);
+}
+
+TEST(TestModelParts, EmptyModel)
+{
+    auto parts = splitModelParts({}, 4);
+    ASSERT_EQ(parts.size(), 1u);
+    EXPECT_EQ(parts[0].count, 0u);
+}
+
+TEST(TestModelParts, SmallerPartsWhenAsked)
+{
+    engine::vector<uint32_t> meshIndexCounts{ 300, 600, 300, 600 };
+    auto parts = splitModelParts(meshIndexCounts, 2, 1u);
+
+    ASSERT_EQ(parts.size(), 2u);
+    expectContiguous(meshIndexCounts, parts);
+    EXPECT_EQ(partIndexes(meshIndexCounts, parts[0]), 900u);
+    EXPECT_EQ(partIndexes(meshIndexCounts, parts[1]), 900u);
+}
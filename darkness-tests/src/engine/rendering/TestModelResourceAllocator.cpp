@@ -0,0 +1,122 @@
+#include "NullDeviceFixture.h"
+#include "engine/rendering/ModelResourceAllocator.h"
+#include "engine/graphics/CommandList.h"
+#include "engine/graphics/Resources.h"
+#include "tools/ByteRange.h"
+#include "tools/Debug.h"
+#include "containers/vector.h"
+#include <algorithm>
+#include <chrono>
+
+using namespace engine;
+
+class TestModelResourceAllocator : public NullDeviceTest
+{
+};
+
+TEST_F(TestModelResourceAllocator, GrowingKeepsBuffersAndData)
+{
+    ModelResourceAllocator allocator(
+        device(),
+        64,
+        engine::vector<Format>{ Format::R32G32B32_FLOAT, Format::R32_UINT },
+        "TestModelResourceAllocator",
+        engine::vector<ExtraView>{ ExtraView{ ExtraViewType::Vertex, 0, 1 }, ExtraView{ ExtraViewType::Index, 1, 1 } });
+    ASSERT_TRUE(allocator.reserved());
+    EXPECT_GT(allocator.reservedElements(), 64u);
+
+    auto srv = allocator.gpuBuffers()[1];
+    auto ibv = allocator.gpuIndexBuffers()[0];
+    auto vbv = allocator.gpuVertexBuffers()[0];
+    auto srvId = srv.resourceId();
+
+    auto first = allocator.allocate(32);
+    engine::vector<uint32_t> indexes;
+    for (uint32_t i = 0; i < 32; ++i)
+        indexes.emplace_back(i * 3 + 1);
+    auto cmd = device().createCommandList("TestModelResourceAllocator");
+    device().uploadBuffer(cmd, allocator.gpuBuffers()[1], tools::ByteRange(indexes), static_cast<uint32_t>(first.gpuIndex));
+
+    statistics().reset();
+    engine::vector<ModelResourceAllocation> allocations{ first };
+    for (int i = 0; i < 1000; ++i)
+        allocations.emplace_back(allocator.allocate(100));
+    EXPECT_GE(allocator.elements(), 100032u);
+    EXPECT_EQ(allocator.usedElements(), 100032u);
+
+    // growing only committed pages
+    EXPECT_GT(statistics().commits, 0u);
+    EXPECT_EQ(statistics().copies, 0u);
+    EXPECT_EQ(statistics().copyBytes, 0u);
+    EXPECT_EQ(statistics().buffers, 0u);
+    EXPECT_EQ(statistics().views, 0u);
+    EXPECT_EQ(statistics().commandListsSubmitted, 0u);
+
+    EXPECT_TRUE(allocator.gpuBuffers()[1] == srv);
+    EXPECT_EQ(allocator.gpuBuffers()[1].resourceId(), srvId);
+    EXPECT_TRUE(allocator.gpuIndexBuffers()[0] == ibv);
+    EXPECT_TRUE(allocator.gpuVertexBuffers()[0] == vbv);
+
+    auto buffer = allocator.gpuBufferOwnersUAV()[1].resource().buffer();
+    EXPECT_GE(buffer.committedBytes(), allocator.elements() * sizeof(uint32_t));
+    auto data = static_cast<const uint32_t*>(buffer.map(device()));
+    for (uint32_t i = 0; i < 32; ++i)
+        EXPECT_EQ(data[first.gpuIndex + i], indexes[i]);
+    buffer.unmap(device());
+
+    std::sort(allocations.begin(), allocations.end(), [](const ModelResourceAllocation& a, const ModelResourceAllocation& b)
+    {
+        return a.gpuIndex < b.gpuIndex;
+    });
+    for (size_t i = 1; i < allocations.size(); ++i)
+        EXPECT_LE(allocations[i - 1].gpuIndex + allocations[i - 1].elements, allocations[i].gpuIndex);
+    EXPECT_LE(allocations.back().gpuIndex + allocations.back().elements, allocator.elements());
+}
+
+TEST_F(TestModelResourceAllocator, OnlyUsedPagesHaveMemory)
+{
+    ModelResourceAllocator allocator(
+        device(),
+        0,
+        engine::vector<size_t>{ 16, 64 },
+        "TestModelResourceAllocator");
+    EXPECT_EQ(allocator.gpuBuffers().size(), 0u);
+
+    auto allocation = allocator.allocate(10);
+    EXPECT_EQ(allocation.gpuIndex, 0u);
+    ASSERT_EQ(allocator.gpuBuffers().size(), 2u);
+    EXPECT_EQ(allocator.elementSizeBytes(), 80u);
+
+    // the address space is reserved but the memory is a page per stream
+    auto structured = allocator.gpuBufferOwnersUAV()[1].resource().buffer();
+    EXPECT_EQ(structured.description().elements, allocator.reservedElements());
+    EXPECT_EQ(structured.committedBytes(), ReservedBufferPageBytes);
+    EXPECT_EQ(statistics().committedBytes, 2u * ReservedBufferPageBytes);
+    EXPECT_EQ(statistics().copies, 0u);
+}
+
+TEST_F(TestModelResourceAllocator, DISABLED_GrowthPerformance)
+{
+    for (size_t allocationSize : { 100u, 1000u, 10000u })
+    {
+        ModelResourceAllocator allocator(
+            device(),
+            1024,
+            engine::vector<Format>{ Format::R32G32B32_FLOAT, Format::R32G32B32_FLOAT, Format::R32G32_FLOAT, Format::R32_UINT },
+            "TestModelResourceAllocator",
+            engine::vector<ExtraView>{ ExtraView{ ExtraViewType::Index, 3, 1 } });
+        statistics().reset();
+
+        const size_t elements = 4u * 1024u * 1024u;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t allocated = 0; allocated < elements; allocated += allocationSize)
+            allocator.allocate(allocationSize);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        LOG_INFO("ModelResourceAllocator %zu elements in allocations of %zu: %f ms, %zu commits, %zu bytes committed, %zu bytes copied",
+            allocator.elements(), allocationSize, ms,
+            static_cast<size_t>(statistics().commits),
+            static_cast<size_t>(statistics().committedBytes),
+            static_cast<size_t>(statistics().copyBytes));
+    }
+}
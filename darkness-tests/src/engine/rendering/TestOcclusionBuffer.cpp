@@ -0,0 +1,153 @@
+#include "gtest/gtest.h"
+#include "ProjectionTools.h"
+#include "engine/rendering/culling/OcclusionBuffer.h"
+#include "containers/vector.h"
+#include "tools/Debug.h"
+#include <random>
+#include <cmath>
+
+using namespace engine;
+
+namespace
+{
+    constexpr float Aspect = 16.0f / 9.0f;
+    constexpr float NearPlane = 0.1f;
+    constexpr float FarPlane = 1000.0f;
+
+    Matrix4f perspective(float fov)
+    {
+        return cameraPerspective(fov, Aspect, NearPlane, FarPlane);
+    }
+
+    // looking down -z from position
+    Matrix4f viewProjection(const Vector3f& position)
+    {
+        Matrix4f view = Matrix4f::identity();
+        view.m03 = -position.x;
+        view.m13 = -position.y;
+        view.m23 = -position.z;
+        return perspective(60.0f) * view;
+    }
+
+    engine::BoundingBox box(Vector3f min, Vector3f max)
+    {
+        return engine::BoundingBox{ min, max };
+    }
+
+    // a street grid of buildings, the camera stands on the middle street
+    struct City
+    {
+        engine::vector<engine::BoundingBox> buildings;
+        engine::vector<engine::BoundingBox> props;
+    };
+
+    City createCity(int blocks, uint32_t seed)
+    {
+        City city;
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> height(8.0f, 60.0f);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        const float blockSize = 20.0f;
+        const float street = 8.0f;
+        for (int z = 0; z < blocks; ++z)
+        {
+            for (int x = -blocks / 2; x < blocks / 2; ++x)
+            {
+                float x0 = static_cast<float>(x) * (blockSize + street) + street * 0.5f;
+                float z0 = -static_cast<float>(z + 1) * (blockSize + street);
+                city.buildings.emplace_back(box(
+                    Vector3f{ x0, 0.0f, z0 },
+                    Vector3f{ x0 + blockSize, height(random), z0 + blockSize }));
+
+                // small things behind and around the building
+                for (int p = 0; p < 8; ++p)
+                {
+                    float px = x0 - street * 0.5f + unit(random) * (blockSize + street);
+                    float pz = z0 - street * 0.5f + unit(random) * (blockSize + street);
+                    city.props.emplace_back(box(
+                        Vector3f{ px, 0.0f, pz },
+                        Vector3f{ px + 1.0f, 1.5f, pz + 1.0f }));
+                }
+            }
+        }
+        return city;
+    }
+
+    void renderCity(OcclusionBuffer& buffer, const City& city)
+    {
+        buffer.begin(viewProjection(Vector3f{ 0.0f, 1.8f, 0.0f }));
+        for (auto&& building : city.buildings)
+            buffer.addOccluder(building, Matrix4f::identity());
+        buffer.render();
+    }
+}
+
+TEST(TestOcclusionBuffer, WallOccludesWhatIsBehindIt)
+{
+    JobSystem serial(0);
+    OcclusionBuffer buffer(256, 128, serial);
+    buffer.begin(viewProjection(Vector3f{ 0.0f, 0.0f, 0.0f }));
+    buffer.addOccluder(box(Vector3f{ -5.0f, -5.0f, -10.5f }, Vector3f{ 5.0f, 5.0f, -10.0f }), Matrix4f::identity());
+    buffer.render();
+
+    EXPECT_EQ(buffer.statistics().occluders, 1u);
+    EXPECT_EQ(buffer.statistics().triangles, 12u);
+
+    EXPECT_TRUE(buffer.isOccluded(box(Vector3f{ -1.0f, -1.0f, -21.0f }, Vector3f{ 1.0f, 1.0f, -19.0f })));
+
+    // in front of the wall
+    EXPECT_FALSE(buffer.isOccluded(box(Vector3f{ -1.0f, -1.0f, -6.0f }, Vector3f{ 1.0f, 1.0f, -4.0f })));
+
+    // next to the wall and over its edge
+    EXPECT_FALSE(buffer.isOccluded(box(Vector3f{ 14.0f, -1.0f, -21.0f }, Vector3f{ 16.0f, 1.0f, -19.0f })));
+    EXPECT_FALSE(buffer.isOccluded(box(Vector3f{ 8.0f, -1.0f, -21.0f }, Vector3f{ 12.0f, 1.0f, -19.0f })));
+
+    // around and behind the camera
+    EXPECT_FALSE(buffer.isOccluded(box(Vector3f{ -1.0f, -1.0f, -1.0f }, Vector3f{ 1.0f, 1.0f, 1.0f })));
+    EXPECT_FALSE(buffer.isOccluded(box(Vector3f{ -1.0f, -1.0f, 19.0f }, Vector3f{ 1.0f, 1.0f, 21.0f })));
+
+    // the transform moves the box from behind the wall to the side of it
+    Matrix4f transform = Matrix4f::identity();
+    transform.m03 = 15.0f;
+    EXPECT_FALSE(buffer.isOccluded(box(Vector3f{ -1.0f, -1.0f, -21.0f }, Vector3f{ 1.0f, 1.0f, -19.0f }), transform));
+}
+
+TEST(TestOcclusionBuffer, HullOccluder)
+{
+    const Vector3f vertices[4] = {
+        Vector3f{ -10.0f, -10.0f, 0.0f }, Vector3f{ 10.0f, -10.0f, 0.0f },
+        Vector3f{ 10.0f, 10.0f, 0.0f }, Vector3f{ -10.0f, 10.0f, 0.0f } };
+    const uint32_t indices[6] = { 0, 1, 2, 0, 2, 3 };
+
+    Matrix4f transform = Matrix4f::identity();
+    transform.m23 = -10.0f;
+
+    JobSystem serial(0);
+    OcclusionBuffer buffer(256, 128, serial);
+    buffer.begin(viewProjection(Vector3f{ 0.0f, 0.0f, 0.0f }));
+    buffer.addOccluder(vertices, 4, indices, 6, transform);
+    buffer.render();
+
+    EXPECT_TRUE(buffer.isOccluded(box(Vector3f{ -1.0f, -1.0f, -21.0f }, Vector3f{ 1.0f, 1.0f, -19.0f })));
+    EXPECT_FALSE(buffer.isOccluded(box(Vector3f{ -1.0f, -1.0f, -9.0f }, Vector3f{ 1.0f, 1.0f, -8.0f })));
+
+    // the quad covers the middle of the screen, the depth there is the quad depth
+    float expected = (perspective(60.0f).m22 * -10.0f + perspective(60.0f).m23) / 10.0f;
+    EXPECT_NEAR(buffer.depth(buffer.width() / 2, buffer.height() / 2), expected, 1e-5f);
+    EXPECT_EQ(buffer.depth(0, 0), 0.0f);
+}
+
+TEST(TestOcclusionBuffer, FrontRowHidesTheCity)
+{
+    auto city = createCity(16, 1234);
+    OcclusionBuffer buffer(256, 128);
+    renderCity(buffer, city);
+
+    size_t occluded = 0;
+    for (auto&& prop : city.props)
+        occluded += buffer.isOccluded(prop) ? 1u : 0u;
+
+    // the buildings of the first row hide most of the city
+    EXPECT_GT(occluded, city.props.size() / 2);
+}
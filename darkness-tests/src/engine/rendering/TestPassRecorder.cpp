@@ -0,0 +1,176 @@
+#include "NullDeviceFixture.h"
+#include "engine/rendering/PassRecorder.h"
+#include "engine/graphics/CommandList.h"
+#include "engine/graphics/Resources.h"
+#include "tools/JobSystem.h"
+#include "tools/Debug.h"
+#include "containers/vector.h"
+#include "containers/string.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace engine;
+
+class TestPassRecorder : public NullDeviceTest
+{
+protected:
+    static constexpr int StageCount = 3;
+    const int passCounts[StageCount] = { 4, 1, 6 };
+
+    // pass names are not copied by the recorder
+    engine::vector<engine::string> names;
+    std::atomic<int> recorded[StageCount] = {};
+
+    // every pass checks that the stage before it has been recorded. the
+    // first passes of a stage sleep the longest so they finish last
+    void addPasses(PassRecorder& recorder, std::thread::id caller)
+    {
+        for (int stage = 0; stage < StageCount; ++stage)
+        {
+            for (int pass = 0; pass < passCounts[stage]; ++pass)
+                names.emplace_back("Stage " + std::to_string(stage) + " pass " + std::to_string(pass));
+        }
+
+        size_t name = 0;
+        for (int stage = 0; stage < StageCount; ++stage)
+        {
+            recorder.stage();
+            for (int pass = 0; pass < passCounts[stage]; ++pass)
+            {
+                // the second pass of every stage has to stay on this thread
+                auto thread = pass == 1 ? PassThread::Main : PassThread::Any;
+                recorder.pass(names[name++].c_str(), [this, stage, pass, thread, caller](CommandList&)
+                {
+                    if (stage > 0)
+                        EXPECT_EQ(recorded[stage - 1].load(), passCounts[stage - 1]);
+                    if (thread == PassThread::Main)
+                        EXPECT_EQ(std::this_thread::get_id(), caller);
+                    std::this_thread::sleep_for(std::chrono::microseconds(200 * (passCounts[stage] - pass)));
+                    ++recorded[stage];
+                }, thread);
+            }
+        }
+    }
+
+    void checkTimings(const PassRecorder& recorder)
+    {
+        auto& timings = recorder.timings();
+        ASSERT_EQ(timings.size(), names.size());
+        size_t index = 0;
+        for (int stage = 0; stage < StageCount; ++stage)
+        {
+            EXPECT_EQ(recorded[stage].load(), passCounts[stage]);
+            for (int pass = 0; pass < passCounts[stage]; ++pass)
+            {
+                EXPECT_EQ(engine::string(timings[index].name), names[index]);
+                EXPECT_EQ(timings[index].stage, static_cast<size_t>(stage));
+                if (pass < 2)
+                    EXPECT_FALSE(timings[index].worker);
+                ++index;
+            }
+        }
+    }
+};
+
+TEST_F(TestPassRecorder, ParallelRecordingKeepsPassOrder)
+{
+    JobSystem jobs(3);
+    PassRecorder recorder(device(), jobs);
+    nullDevice().logSubmits(true);
+
+    addPasses(recorder, std::this_thread::get_id());
+    auto cmd = device().createCommandList("Frame");
+    recorder.record(cmd, true);
+    checkTimings(recorder);
+
+    // the frame list goes first, then one list per pass in the order
+    // the passes were added
+    auto submits = nullDevice().submits();
+    ASSERT_EQ(submits.size(), names.size() + 1);
+    EXPECT_EQ(submits[0], "Frame");
+    for (size_t i = 0; i < names.size(); ++i)
+        EXPECT_EQ(submits[i + 1], names[i]);
+    EXPECT_EQ(engine::string(cmd.name()), "Frame");
+
+    bool anyWorker = false;
+    for (auto&& timing : recorder.timings())
+        anyWorker |= timing.worker;
+    EXPECT_TRUE(anyWorker);
+}
+
+TEST_F(TestPassRecorder, ParallelRecordingWithoutWorkers)
+{
+    JobSystem jobs(0);
+    PassRecorder recorder(device(), jobs);
+    nullDevice().logSubmits(true);
+
+    addPasses(recorder, std::this_thread::get_id());
+    auto cmd = device().createCommandList("Frame");
+    recorder.record(cmd, true);
+    checkTimings(recorder);
+
+    auto submits = nullDevice().submits();
+    ASSERT_EQ(submits.size(), names.size() + 1);
+    for (size_t i = 0; i < names.size(); ++i)
+        EXPECT_EQ(submits[i + 1], names[i]);
+    for (auto&& timing : recorder.timings())
+        EXPECT_FALSE(timing.worker);
+}
+
+TEST_F(TestPassRecorder, SerialRecordingUsesTheFrameList)
+{
+    JobSystem jobs(3);
+    PassRecorder recorder(device(), jobs);
+    nullDevice().logSubmits(true);
+
+    addPasses(recorder, std::this_thread::get_id());
+    auto cmd = device().createCommandList("Frame");
+    recorder.record(cmd, false);
+    checkTimings(recorder);
+
+    EXPECT_EQ(nullDevice().submits().size(), 0u);
+    for (auto&& timing : recorder.timings())
+        EXPECT_FALSE(timing.worker);
+}
+
+TEST_F(TestPassRecorder, DISABLED_RecordingPerformance)
+{
+    // passes that clear render targets of their own. the null device
+    // clears in cpu memory so recording them costs real time
+    const int passCount = 8;
+    engine::vector<TextureRTVOwner> targets;
+    for (int i = 0; i < passCount; ++i)
+        targets.emplace_back(device().createTextureRTV(TextureDescription()
+            .width(1024)
+            .height(1024)
+            .format(Format::R16G16B16A16_FLOAT)
+            .usage(ResourceUsage::GpuRenderTargetReadWrite)
+            .name("TestPassRecorder target")
+            .dimension(ResourceDimension::Texture2D)));
+
+    PassRecorder recorder(device());
+    for (bool parallel : { false, true })
+    {
+        const int rounds = 20;
+        double ms = 0.0;
+        for (int round = 0; round < rounds; ++round)
+        {
+            recorder.stage();
+            for (int i = 0; i < passCount; ++i)
+            {
+                recorder.pass("TestPassRecorder pass", [&targets, i](CommandList& cmd)
+                {
+                    for (int clear = 0; clear < 4; ++clear)
+                        cmd.clearRenderTargetView(targets[i], { 0.0f, 0.0f, 0.0f, static_cast<float>(clear) });
+                });
+            }
+            auto cmd = device().createCommandList("TestPassRecorder");
+            recorder.record(cmd, parallel);
+            device().submit(cmd);
+            ms += recorder.milliseconds();
+        }
+        LOG_INFO("PassRecorder %d passes, parallel: %s, workers: %zu: %f ms",
+            passCount, parallel ? "true" : "false", recorder.workerCount(), ms / rounds);
+    }
+}
@@ -0,0 +1,159 @@
+#include "NullDeviceFixture.h"
+#include "engine/rendering/ResidencyManager.h"
+#include "engine/graphics/Resources.h"
+#include "containers/vector.h"
+#include <numeric>
+
+using namespace engine;
+
+namespace
+{
+    // small enough that the uploads below wrap it many times
+    constexpr size_t TestRingBytes = 64u * 1024u;
+}
+
+class TestResidencyManager : public NullDeviceTest
+{
+protected:
+    BufferOwner createBuffer(size_t elements)
+    {
+        return device().createBuffer(BufferDescription()
+            .elementSize(sizeof(uint32_t))
+            .elements(elements)
+            .name("TestResidencyManager buffer"));
+    }
+};
+
+TEST_F(TestResidencyManager, UploadsWrapAFullRing)
+{
+    ResidencyManagerV2 residency(device(), TestRingBytes);
+
+    // a buffer many times the ring and small ones queued behind it
+    const size_t bigElements = TestRingBytes;
+    const size_t smallElements = 1024;
+    const size_t smallCount = 32;
+    auto buffer = createBuffer(bigElements + smallElements * smallCount);
+
+    engine::vector<uint32_t> data(bigElements + smallElements * smallCount);
+    std::iota(data.begin(), data.end(), 1u);
+
+    engine::vector<ResidencyManagerV2::ResidencyFuture> futures;
+    futures.emplace_back(residency.uploadTemp(buffer.resource(), 0, data.data(), bigElements * sizeof(uint32_t)));
+    for (size_t i = 0; i < smallCount; ++i)
+    {
+        auto start = bigElements + i * smallElements;
+        futures.emplace_back(residency.uploadTemp(
+            buffer.resource(), start * sizeof(uint32_t),
+            &data[start], smallElements * sizeof(uint32_t),
+            ResidencyPriority::Background));
+    }
+    for (auto&& future : futures)
+    {
+        future.blockUntilUploaded();
+        EXPECT_TRUE(future.uploaded());
+        EXPECT_FALSE(future.failed());
+    }
+
+    auto stats = residency.statistics();
+    EXPECT_EQ(stats.failedTasks, 0u);
+    EXPECT_EQ(stats.bytes, data.size() * sizeof(uint32_t));
+    EXPECT_GT(stats.batches, data.size() * sizeof(uint32_t) / TestRingBytes);
+
+    auto gpu = static_cast<const uint32_t*>(buffer.resource().map(device()));
+    for (size_t i = 0; i < data.size(); ++i)
+        ASSERT_EQ(gpu[i], data[i]) << "at element " << i;
+    buffer.resource().unmap(device());
+}
+
+TEST_F(TestResidencyManager, PieceBiggerThanTheRingFails)
+{
+    ResidencyManagerV2 residency(device(), TestRingBytes);
+
+    // texture pieces are 128x128 pixels, 256 KB in this format
+    auto texture = device().createTexture(TextureDescription()
+        .width(256)
+        .height(256)
+        .format(Format::R32G32B32A32_FLOAT)
+        .name("TestResidencyManager texture")
+        .dimension(ResourceDimension::Texture2D));
+    engine::vector<float> pixels(256 * 256 * 4, 1.0f);
+
+    auto textureUpload = residency.upload(pixels.data(), 256, 256, texture.resource(), 0, 0, 0, 0, 1);
+    textureUpload.blockUntilUploaded();
+    EXPECT_TRUE(textureUpload.uploaded());
+    EXPECT_TRUE(textureUpload.failed());
+
+    // the manager keeps working after the failure
+    auto buffer = createBuffer(1024);
+    engine::vector<uint32_t> data(1024);
+    std::iota(data.begin(), data.end(), 7u);
+    auto bufferUpload = residency.uploadTemp(buffer.resource(), 0, data.data(), data.size() * sizeof(uint32_t));
+    bufferUpload.blockUntilUploaded();
+    EXPECT_FALSE(bufferUpload.failed());
+
+    auto gpu = static_cast<const uint32_t*>(buffer.resource().map(device()));
+    for (size_t i = 0; i < data.size(); ++i)
+        EXPECT_EQ(gpu[i], data[i]);
+    buffer.resource().unmap(device());
+
+    EXPECT_EQ(residency.statistics().failedTasks, 1u);
+}
+
+TEST_F(TestResidencyManager, TexturePiecesFitTheDefaultRing)
+{
+    ResidencyManagerV2 residency(device());
+    auto texture = device().createTexture(TextureDescription()
+        .width(512)
+        .height(512)
+        .format(Format::R32G32B32A32_FLOAT)
+        .name("TestResidencyManager texture")
+        .dimension(ResourceDimension::Texture2D));
+    engine::vector<float> pixels(512 * 512 * 4, 1.0f);
+
+    auto upload = residency.upload(pixels.data(), 512, 512, texture.resource(), 0, 0, 0, 0, 1);
+    upload.blockUntilUploaded();
+    EXPECT_FALSE(upload.failed());
+    EXPECT_EQ(residency.statistics().failedTasks, 0u);
+}
+
+TEST_F(TestResidencyManager, GatheredUploadIsOneTask)
+{
+    ResidencyManagerV2 residency(device(), TestRingBytes);
+    auto first = createBuffer(1024);
+    auto second = createBuffer(1024);
+
+    // three ranges of one source with a gap, the last one bigger than a batch piece
+    const size_t bigElements = TestRingBytes / ResidencyBatchRingDivisor;
+    auto big = createBuffer(bigElements);
+    engine::vector<uint32_t> data(256 + 16 + 512 + bigElements);
+    std::iota(data.begin(), data.end(), 1u);
+
+    engine::vector<ResidencyBufferCopy> copies;
+    copies.emplace_back(ResidencyBufferCopy{ first.resource(), 64 * sizeof(uint32_t), 0, 256 * sizeof(uint32_t) });
+    copies.emplace_back(ResidencyBufferCopy{ second.resource(), 0, (256 + 16) * sizeof(uint32_t), 512 * sizeof(uint32_t) });
+    copies.emplace_back(ResidencyBufferCopy{ big.resource(), 0, (256 + 16 + 512) * sizeof(uint32_t), bigElements * sizeof(uint32_t) });
+
+    auto upload = residency.uploadTemp(data.data(), std::move(copies));
+    upload.blockUntilUploaded();
+    EXPECT_FALSE(upload.failed());
+
+    auto stats = residency.statistics();
+    EXPECT_EQ(stats.tasks, 1u);
+    EXPECT_EQ(stats.failedTasks, 0u);
+    EXPECT_EQ(stats.bytes, data.size() * sizeof(uint32_t));
+
+    auto gpu = static_cast<const uint32_t*>(first.resource().map(device()));
+    for (size_t i = 0; i < 256; ++i)
+        ASSERT_EQ(gpu[64 + i], data[i]) << "at element " << i;
+    first.resource().unmap(device());
+
+    gpu = static_cast<const uint32_t*>(second.resource().map(device()));
+    for (size_t i = 0; i < 512; ++i)
+        ASSERT_EQ(gpu[i], data[256 + 16 + i]) << "at element " << i;
+    second.resource().unmap(device());
+
+    gpu = static_cast<const uint32_t*>(big.resource().map(device()));
+    for (size_t i = 0; i < bigElements; ++i)
+        ASSERT_EQ(gpu[i], data[256 + 16 + 512 + i]) << "at element " << i;
+    big.resource().unmap(device());
+}
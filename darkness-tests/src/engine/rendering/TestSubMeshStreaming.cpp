@@ -0,0 +1,364 @@
+#include "GlobalTestFixture.h"
+#include "engine/rendering/SubMesh.h"
+#include "engine/rendering/SubMeshStreaming.h"
+#include "engine/rendering/MeshStreaming.h"
+#include "engine/rendering/Mesh.h"
+#include "engine/rendering/ModelResources.h"
+#include "tools/CompressedFile.h"
+
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <filesystem>
+
+using namespace engine;
+
+namespace
+{
+    struct MockUpload
+    {
+        SubMeshStream stream;
+        size_t dstIndexBytes;
+        const uint8_t* src;
+        engine::vector<uint8_t> data;
+    };
+
+    struct MockCopy
+    {
+        SubMeshStream stream;
+        size_t dstIndexBytes;
+        size_t stagingOffset;
+        size_t bytes;
+    };
+
+    class MockUploadBatch : public SubMeshUploadBatch
+    {
+    public:
+        MockUploadBatch(engine::vector<MockUpload>& uploads, int& submits, bool& landed)
+            : m_uploads{ uploads }
+            , m_submits{ submits }
+            , m_landed{ landed }
+        {}
+
+        void upload(SubMeshStream stream, size_t dstIndexBytes, size_t stagingOffset, size_t bytes) override
+        {
+            m_copies.emplace_back(MockCopy{ stream, dstIndexBytes, stagingOffset, bytes });
+        }
+
+        void submit(const uint8_t* staging) override
+        {
+            ++m_submits;
+            for (auto&& copy : m_copies)
+            {
+                auto ptr = staging + copy.stagingOffset;
+                m_uploads.emplace_back(MockUpload{ copy.stream, copy.dstIndexBytes, ptr, engine::vector<uint8_t>(ptr, ptr + copy.bytes) });
+            }
+            m_copies.clear();
+        }
+
+        bool uploaded() override { return m_landed; }
+        void blockUntilUploaded() override { m_landed = true; }
+    private:
+        engine::vector<MockUpload>& m_uploads;
+        engine::vector<MockCopy> m_copies;
+        int& m_submits;
+        bool& m_landed;
+    };
+
+    class MockUploadBackend : public SubMeshUploadBackend
+    {
+    public:
+        ModelResourceAllocation allocate(SubMeshAllocator allocator, size_t elements) override
+        {
+            auto& next = m_next[static_cast<int>(allocator)];
+            ModelResourceAllocation res = {};
+            res.gpuIndex = next;
+            res.elements = elements;
+            next += elements + 100;
+            return res;
+        }
+
+        engine::unique_ptr<SubMeshUploadBatch> createBatch() override
+        {
+            ++batches;
+            return engine::make_unique<MockUploadBatch>(uploads, submits, landed);
+        }
+
+        engine::vector<MockUpload> uploads;
+        bool landed = false;
+        int batches = 0;
+        int submits = 0;
+
+        const MockUpload* find(SubMeshStream stream) const
+        {
+            for (auto&& upload : uploads)
+                if (upload.stream == stream)
+                    return &upload;
+            return nullptr;
+        }
+    private:
+        size_t m_next[7] = { 1000, 2000, 3000, 4000, 5000, 6000, 7000 };
+    };
+
+    SubMesh createTestSubMesh()
+    {
+        SubMesh subMesh;
+        subMesh.outputData.resize(1);
+        auto& out = subMesh.outputData[0];
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            out.vertex.emplace_back(Vector2<uint32_t>{ i, i * 2 });
+            out.normal.emplace_back(Vector2f{ static_cast<float>(i), 1.0f });
+            out.tangent.emplace_back(Vector2f{ 1.0f, static_cast<float>(i) });
+        }
+        out.uv.resize(1);
+        for (uint32_t i = 0; i < 8; ++i)
+            out.uv[0].emplace_back(Vector2f{ 0.5f, static_cast<float>(i) });
+        for (uint16_t i = 0; i < 12; ++i)
+            out.index.emplace_back(static_cast<uint16_t>(i % 8));
+
+        out.clusterIndexStarts = { 0, 6 };
+        out.clusterVertexStarts = { 0, 4 };
+        out.clusterIndexCount = { 6, 6 };
+        out.clusterBounds.resize(2);
+        out.clusterCones = { Vector4f{ 0.0f, 1.0f, 0.0f, 0.5f }, Vector4f{ 1.0f, 0.0f, 0.0f, 0.5f } };
+        return subMesh;
+    }
+
+    engine::string writeTestMesh(const char* filename)
+    {
+        auto path = engine::string((std::filesystem::temp_directory_path() / filename).string().c_str());
+        Mesh mesh;
+        mesh.subMeshes().emplace_back(createTestSubMesh());
+        mesh.setFilename(path);
+        mesh.save();
+        return path;
+    }
+
+    // waits for the reader to finish count requests that update() has not taken
+    bool waitForReads(const MeshStreamer& streamer, size_t count)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        while (streamer.statistics().read < count)
+        {
+            if (std::chrono::high_resolution_clock::now() - start > std::chrono::seconds(10))
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+}
+
+TEST(TestSubMeshStreaming, StagesWholeSubMeshAndUploadsWithoutWaiting)
+{
+    auto source = createTestSubMesh();
+    engine::vector<char> mem;
+    {
+        CompressedFile file;
+        file.open(mem, std::ios::out | std::ios::binary);
+        source.save(file);
+        file.close();
+    }
+
+    MockUploadBackend backend;
+    SubMesh subMesh;
+    {
+        CompressedFile file;
+        file.open(mem, std::ios::in | std::ios::binary);
+        EXPECT_TRUE(subMesh.load(backend, file));
+        file.close();
+    }
+
+    // everything went out in one request and nothing has landed yet
+    EXPECT_EQ(backend.batches, 1);
+    EXPECT_EQ(backend.submits, 1);
+    EXPECT_FALSE(subMesh.resident());
+
+    // vertex, normal, tangent, uv, index and 3 cluster, 4 submesh and 1 lod table
+    EXPECT_EQ(backend.uploads.size(), 13u);
+
+    // all uploads come from one staging allocation
+    const uint8_t* lowest = backend.uploads[0].src;
+    const uint8_t* highest = backend.uploads[0].src;
+    size_t totalBytes = 0;
+    for (auto&& upload : backend.uploads)
+    {
+        lowest = std::min(lowest, upload.src);
+        highest = std::max(highest, upload.src + upload.data.size());
+        totalBytes += upload.data.size();
+    }
+    EXPECT_GE(static_cast<size_t>(highest - lowest), totalBytes);
+    EXPECT_LT(static_cast<size_t>(highest - lowest), totalBytes + 16u * backend.uploads.size());
+
+    auto vertex = backend.find(SubMeshStream::Vertex);
+    auto normal = backend.find(SubMeshStream::Normal);
+    ASSERT_NE(vertex, nullptr);
+    ASSERT_NE(normal, nullptr);
+    EXPECT_EQ(vertex->data.size(), sizeof(Vector2<uint32_t>) * 8);
+    EXPECT_EQ(memcmp(vertex->data.data(), source.outputData[0].vertex.data(), vertex->data.size()), 0);
+
+    // normal shares the vertex data range
+    EXPECT_EQ(vertex->dstIndexBytes / sizeof(Vector2<uint32_t>), normal->dstIndexBytes / sizeof(Vector2f));
+    EXPECT_EQ(subMesh.gpuData.size(), 1u);
+    EXPECT_EQ(subMesh.gpuData[0].vertexData.modelResource.gpuIndex, 1000u);
+
+    // cluster table points to the allocated vertex and index ranges
+    auto clusters = backend.find(SubMeshStream::ClusterBinding);
+    ASSERT_NE(clusters, nullptr);
+    ASSERT_EQ(clusters->data.size(), sizeof(ClusterData) * 2);
+    auto cData = reinterpret_cast<const ClusterData*>(clusters->data.data());
+    EXPECT_EQ(cData[0].vertexPointer, 1000u);
+    EXPECT_EQ(cData[1].vertexPointer, 1004u);
+    EXPECT_EQ(cData[0].indexPointer, 3000u);
+    EXPECT_EQ(cData[1].indexPointer, 3006u);
+    EXPECT_EQ(cData[1].indexCount, 6u);
+
+    auto lod = backend.find(SubMeshStream::Lod);
+    ASSERT_NE(lod, nullptr);
+    auto lodBinding = reinterpret_cast<const SubMeshUVLod*>(lod->data.data());
+    EXPECT_EQ(lodBinding->submeshPointer, 6000u);
+    EXPECT_EQ(lodBinding->uvPointer, 2000u);
+
+    backend.landed = true;
+    EXPECT_TRUE(subMesh.resident());
+}
+
+TEST(TestSubMeshStreaming, StreamerReadsOnItsOwnThread)
+{
+    auto path = writeTestMesh("TestSubMeshStreaming_read.mesh");
+    MockUploadBackend backend;
+    MeshStreamer streamer;
+
+    auto request = streamer.request(path);
+    ASSERT_TRUE(waitForReads(streamer, 1));
+
+    // read but nothing uploaded before update
+    EXPECT_EQ(request->state(), MeshRequestState::Read);
+    EXPECT_EQ(request->mesh(), nullptr);
+    EXPECT_EQ(backend.batches, 0);
+    EXPECT_GT(streamer.statistics().readBytes, 0u);
+
+    EXPECT_EQ(streamer.update(backend), 1u);
+    ASSERT_TRUE(request->ready());
+    ASSERT_EQ(request->mesh()->subMeshes().size(), 1u);
+    EXPECT_EQ(backend.batches, 1);
+    EXPECT_EQ(streamer.statistics().readBytes, 0u);
+
+    // the uploads are in flight until the backend says they landed
+    EXPECT_FALSE(request->mesh()->resident());
+    backend.landed = true;
+    EXPECT_TRUE(request->mesh()->resident());
+    std::filesystem::remove(path.c_str());
+}
+
+TEST(TestSubMeshStreaming, StreamerReadAheadStopsAtTheBudget)
+{
+    auto path = writeTestMesh("TestSubMeshStreaming_budget.mesh");
+    MockUploadBackend backend;
+
+    // every mesh fills the read-ahead so the reader waits after each one
+    MeshStreamer streamer(1);
+    engine::vector<engine::shared_ptr<MeshRequest>> requests;
+    for (int i = 0; i < 3; ++i)
+        requests.emplace_back(streamer.request(path));
+
+    for (size_t i = 0; i < requests.size(); ++i)
+    {
+        ASSERT_TRUE(waitForReads(streamer, 1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        auto stats = streamer.statistics();
+        EXPECT_EQ(stats.read, 1u);
+        EXPECT_EQ(stats.queued, requests.size() - i - 1);
+        EXPECT_EQ(streamer.update(backend), 1u);
+        EXPECT_TRUE(requests[i]->ready());
+    }
+    std::filesystem::remove(path.c_str());
+}
+
+TEST(TestSubMeshStreaming, StreamerReadsMostUrgentFirst)
+{
+    auto path = writeTestMesh("TestSubMeshStreaming_priority.mesh");
+    MockUploadBackend backend;
+    MeshStreamer streamer(1);
+
+    // the first request is read right away and fills the read-ahead
+    auto first = streamer.request(path, ResidencyPriority::Background);
+    ASSERT_TRUE(waitForReads(streamer, 1));
+
+    auto background = streamer.request(path, ResidencyPriority::Background);
+    auto prefetch = streamer.request(path, ResidencyPriority::Prefetch);
+    auto raised = streamer.request(path, ResidencyPriority::Background);
+    auto visible = streamer.request(path, ResidencyPriority::Visible);
+    raised->priority(ResidencyPriority::Visible);
+
+    // same priority goes in request order
+    engine::vector<MeshRequest*> expected = { first.get(), raised.get(), visible.get(), prefetch.get(), background.get() };
+    engine::vector<MeshRequest*> order;
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        ASSERT_TRUE(waitForReads(streamer, 1));
+        streamer.update(backend);
+        for (auto&& request : { first.get(), visible.get(), raised.get(), prefetch.get(), background.get() })
+            if (request->ready() && std::find(order.begin(), order.end(), request) == order.end())
+                order.emplace_back(request);
+    }
+    EXPECT_EQ(order, expected);
+    std::filesystem::remove(path.c_str());
+}
+
+TEST(TestSubMeshStreaming, StreamerBlockUntilReady)
+{
+    auto path = writeTestMesh("TestSubMeshStreaming_block.mesh");
+    MockUploadBackend backend;
+    MeshStreamer streamer(1);
+
+    // the waiter schedules what is in the way of its request
+    auto before = streamer.request(path, ResidencyPriority::Visible);
+    auto request = streamer.request(path, ResidencyPriority::Background);
+    streamer.blockUntilReady(*request, backend);
+    EXPECT_TRUE(before->ready());
+    EXPECT_TRUE(request->ready());
+
+    auto missing = streamer.request(path + ".missing");
+    streamer.blockUntilReady(*missing, backend);
+    EXPECT_TRUE(missing->failed());
+    EXPECT_EQ(missing->mesh(), nullptr);
+    std::filesystem::remove(path.c_str());
+}
+
+TEST(TestSubMeshStreaming, StreamerCancelFailsWhatWasNotScheduled)
+{
+    auto path = writeTestMesh("TestSubMeshStreaming_cancel.mesh");
+    MockUploadBackend backend;
+    MeshStreamer streamer(1);
+
+    auto scheduled = streamer.request(path);
+    ASSERT_TRUE(waitForReads(streamer, 1));
+    streamer.update(backend);
+    ASSERT_TRUE(scheduled->ready());
+
+    // one is read and waiting for update, the other one is queued behind it
+    auto read = streamer.request(path);
+    ASSERT_TRUE(waitForReads(streamer, 1));
+    auto queued = streamer.request(path);
+
+    streamer.cancel();
+    EXPECT_TRUE(read->failed());
+    EXPECT_TRUE(queued->failed());
+    EXPECT_EQ(read->mesh(), nullptr);
+    EXPECT_TRUE(scheduled->ready());
+
+    auto stats = streamer.statistics();
+    EXPECT_EQ(stats.queued, 0u);
+    EXPECT_EQ(stats.read, 0u);
+    EXPECT_EQ(stats.readBytes, 0u);
+    EXPECT_EQ(streamer.update(backend), 0u);
+    EXPECT_EQ(backend.batches, 1);
+
+    // the streamer keeps working after a cancel
+    auto after = streamer.request(path);
+    streamer.blockUntilReady(*after, backend);
+    EXPECT_TRUE(after->ready());
+    std::filesystem::remove(path.c_str());
+}
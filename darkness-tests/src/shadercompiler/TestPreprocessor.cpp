@@ -0,0 +1,155 @@
+#include "gtest/gtest.h"
+#include "Preprocessor.h"
+#include "platform/Directory.h"
+#include "platform/Environment.h"
+#include "platform/File.h"
+#include "tools/PathTools.h"
+#include "tools/Debug.h"
+#include "containers/vector.h"
+#include "containers/string.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iterator>
+
+using namespace engine;
+
+namespace
+{
+    const char* DefaultDxcPath = "C:/Program Files (x86)/Windows Kits/10/bin/10.0.19041.0/x86/dxc.exe";
+
+    engine::string dxcPath()
+    {
+        auto path = std::getenv("DARKNESS_DXC");
+        return path ? engine::string(path) : engine::string(DefaultDxcPath);
+    }
+
+    // the test binary is in darkness-tests/bin/<platform>/<config>
+    engine::string shaderRootPath()
+    {
+        return engine::pathClean(engine::pathJoin(
+            engine::pathExtractFolder(engine::getExecutableDirectory()),
+            "..\\..\\..\\..\\darkness-engine\\shaders"));
+    }
+
+    // shader with committed expected output, next to the test data
+    engine::string testShaderPath()
+    {
+        return engine::pathClean(engine::pathJoin(
+            engine::pathExtractFolder(engine::getExecutableDirectory()),
+            "..\\..\\..\\data\\shadercompiler\\Preprocessor.hlsl"));
+    }
+
+    engine::vector<engine::string> readExpected(const engine::string& path)
+    {
+        std::ifstream file(path.c_str(), std::ios::binary);
+        engine::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        data.emplace_back(0);
+        return shadercompiler::readLines(data);
+    }
+
+    void walkDirectory(const engine::string& path, std::function<void(const engine::string&)> onFile)
+    {
+        engine::Directory dir(path);
+        for (auto&& d : dir.directories())
+            walkDirectory(engine::pathJoin(path, d), onFile);
+        for (auto&& f : dir.files())
+            onFile(engine::pathJoin(path, f));
+    }
+
+    // blank lines and trailing whitespace depend on how many #line
+    // markers were removed around them. the rest has to match
+    engine::vector<engine::string> significantLines(const engine::vector<engine::string>& lines)
+    {
+        engine::vector<engine::string> result;
+        for (auto&& line : lines)
+        {
+            auto end = line.find_last_not_of(" \t\r\n");
+            if (end != engine::string::npos)
+                result.emplace_back(line.substr(0, end + 1));
+        }
+        return result;
+    }
+}
+
+// every shader in the tree, without defines and with each permutation
+// define on its own. starts dxc for every one of them so it takes a while
+TEST(TestPreprocessor, InProcessMatchesDxc)
+{
+    auto dxc = dxcPath();
+    if (!engine::fileExists(dxc))
+        GTEST_SKIP() << "dxc not found at " << dxc.c_str() << ". Set DARKNESS_DXC to compare against dxc";
+
+    engine::vector<engine::string> shaders{ testShaderPath() };
+    walkDirectory(shaderRootPath(), [&](const engine::string& file)
+    {
+        if (file.ends_with(".hlsl"))
+            shaders.emplace_back(file);
+    });
+    ASSERT_GT(shaders.size(), 1u);
+
+    for (auto&& shader : shaders)
+    {
+        shadercompiler::Preprocessor inProcess(shader);
+        shadercompiler::Preprocessor external(shader, shadercompiler::PreprocessorType::Dxc, dxc);
+
+        engine::vector<engine::vector<engine::string>> defineSets{ {} };
+        for (auto&& option : inProcess.options())
+            defineSets.push_back({ option.define });
+        for (auto&& enumeration : inProcess.enums())
+            for (auto&& value : enumeration.second)
+                defineSets.push_back({ value.define });
+
+        for (auto&& defines : defineSets)
+        {
+            auto output = engine::pathJoin(engine::pathExtractFolder(shader), "TestPreprocessor.preprocessed");
+            engine::vector<engine::string> inProcessDependencies;
+            engine::vector<engine::string> dxcDependencies;
+            auto inProcessLines = significantLines(inProcess.process(shader, {}, defines, output, inProcessDependencies));
+            auto dxcLines = significantLines(external.process(shader, {}, defines, output, dxcDependencies));
+
+            auto permutation = shader + (defines.empty() ? engine::string("") : " -D" + defines[0]);
+            EXPECT_EQ(inProcessDependencies, dxcDependencies) << permutation;
+            EXPECT_EQ(inProcessLines.size(), dxcLines.size()) << permutation;
+            for (size_t i = 0; i < std::min(inProcessLines.size(), dxcLines.size()); ++i)
+            {
+                if (inProcessLines[i] != dxcLines[i])
+                {
+                    ADD_FAILURE() << permutation << " line " << i << "\n"
+                        << "  in process: " << inProcessLines[i] << "\n"
+                        << "  dxc:        " << dxcLines[i];
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// the expected files hold the -P output of the test shader without blank
+// lines. runs without dxc so there is always something checked
+TEST(TestPreprocessor, InProcessMatchesExpected)
+{
+    auto shader = testShaderPath();
+    shadercompiler::Preprocessor preprocessor(shader);
+    ASSERT_EQ(preprocessor.options().size(), 1u);
+    EXPECT_EQ(preprocessor.options()[0].define, "OPTION_SHADOWS");
+
+    for (auto&& define : { engine::string(""), engine::string("OPTION_SHADOWS") })
+    {
+        engine::vector<engine::string> defines;
+        if (!define.empty())
+            defines.emplace_back(define);
+        auto expectedPath = engine::pathReplaceExtension(shader, define.empty() ? "expected" : define + ".expected");
+        auto expected = significantLines(readExpected(expectedPath));
+        ASSERT_GT(expected.size(), 0u) << expectedPath.c_str();
+
+        engine::vector<engine::string> dependencies;
+        auto output = engine::pathJoin(engine::pathExtractFolder(shader), "TestPreprocessor.preprocessed");
+        auto lines = significantLines(preprocessor.process(shader, {}, defines, output, dependencies));
+        EXPECT_EQ(lines, expected) << define.c_str();
+
+        ASSERT_EQ(dependencies.size(), 1u);
+        EXPECT_TRUE(dependencies[0].ends_with("Preprocessor.hlsli")) << dependencies[0].c_str();
+    }
+}
@@ -0,0 +1,104 @@
+#include "gtest/gtest.h"
+#include "tools/JobSystem.h"
+#include "containers/vector.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace engine;
+
+TEST(TestJobSystem, ParallelForRunsEveryIndexOnce)
+{
+    for (size_t workerCount : { 0u, 1u, 4u })
+    {
+        JobSystem jobs(workerCount);
+        engine::vector<int> hits(1000, 0);
+        jobs.parallelFor(hits.size(), [&](size_t i) { ++hits[i]; });
+        for (auto&& hit : hits)
+            EXPECT_EQ(hit, 1);
+    }
+}
+
+TEST(TestJobSystem, GroupWaitsForItsJobs)
+{
+    JobSystem jobs(3);
+    std::atomic<int> done{ 0 };
+    {
+        JobGroup group(jobs);
+        for (int i = 0; i < 64; ++i)
+            group.run([&]()
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                ++done;
+            });
+        group.wait();
+        EXPECT_EQ(done.load(), 64);
+
+        // a group can be used again after wait
+        group.run([&]() { ++done; });
+    }
+    EXPECT_EQ(done.load(), 65);
+}
+
+TEST(TestJobSystem, WithoutWorkersWaitRunsTheJobs)
+{
+    JobSystem jobs(0);
+    auto caller = std::this_thread::get_id();
+    int done = 0;
+    JobGroup group(jobs);
+    for (int i = 0; i < 8; ++i)
+        group.run([&]()
+        {
+            EXPECT_EQ(std::this_thread::get_id(), caller);
+            ++done;
+        });
+    EXPECT_EQ(done, 0);
+    group.wait();
+    EXPECT_EQ(done, 8);
+}
+
+TEST(TestJobSystem, NestedParallelForDoesNotDeadlock)
+{
+    // every worker ends up waiting for an inner group. the waiters run
+    // their own jobs so this finishes even with a single worker
+    for (size_t workerCount : { 1u, 2u })
+    {
+        JobSystem jobs(workerCount);
+        std::atomic<int> done{ 0 };
+        jobs.parallelFor(8, [&](size_t)
+        {
+            jobs.parallelFor(8, [&](size_t) { ++done; });
+        });
+        EXPECT_EQ(done.load(), 64);
+    }
+}
+
+TEST(TestJobSystem, WaitDoesNotRunOtherGroups)
+{
+    JobSystem jobs(1);
+    std::atomic<bool> release{ false };
+    std::atomic<bool> longJobStarted{ false };
+
+    // the long job keeps the only worker busy. waiting for the short
+    // group must not pick up the second long job
+    JobGroup slow(jobs);
+    for (int i = 0; i < 2; ++i)
+        slow.run([&]()
+        {
+            longJobStarted = true;
+            while (!release)
+                std::this_thread::yield();
+        });
+    while (!longJobStarted)
+        std::this_thread::yield();
+
+    auto caller = std::this_thread::get_id();
+    bool ranOnCaller = false;
+    JobGroup fast(jobs);
+    fast.run([&]() { ranOnCaller = std::this_thread::get_id() == caller; });
+    fast.wait();
+    EXPECT_TRUE(ranOnCaller);
+
+    release = true;
+    slow.wait();
+}
@@ -0,0 +1,208 @@
+#include "gtest/gtest.h"
+#include "tools/MeshOptimize.h"
+#include "engine/rendering/ModelCpu.h"
+#include "engine/rendering/BufferSettings.h"
+#include "tools/Debug.h"
+#include "containers/vector.h"
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <random>
+
+using namespace engine;
+
+namespace
+{
+    constexpr float Pi = 3.14159265f;
+
+    // closed torus without seams. the triangles are in 8x4 quad tiles,
+    // about what Clusterize gives, but in a random order inside every
+    // cluster like an index that was never optimised
+    ModelCpu shuffledTorus(uint32_t columns, uint32_t rows)
+    {
+        ModelCpu model;
+        model.uv.resize(1);
+        for (uint32_t y = 0; y < rows; ++y)
+        {
+            for (uint32_t x = 0; x < columns; ++x)
+            {
+                float u = static_cast<float>(x) / static_cast<float>(columns) * 2.0f * Pi;
+                float v = static_cast<float>(y) / static_cast<float>(rows) * 2.0f * Pi;
+                Vector3f normal{ std::cos(u) * std::cos(v), std::sin(v), std::sin(u) * std::cos(v) };
+                model.vertex.emplace_back(Vector3f{ std::cos(u) * 3.0f, 0.0f, std::sin(u) * 3.0f } + normal);
+                model.normal.emplace_back(normal);
+                model.uv[0].emplace_back(Vector2f{ static_cast<float>(x) / static_cast<float>(columns), static_cast<float>(y) / static_cast<float>(rows) });
+            }
+        }
+
+        engine::vector<std::array<uint32_t, 3>> triangles;
+        for (uint32_t tileY = 0; tileY < rows; tileY += 4)
+        {
+            for (uint32_t tileX = 0; tileX < columns; tileX += 8)
+            {
+                for (uint32_t y = tileY; y < std::min(tileY + 4, rows); ++y)
+                {
+                    for (uint32_t x = tileX; x < std::min(tileX + 8, columns); ++x)
+                    {
+                        uint32_t i0 = y * columns + x;
+                        uint32_t i1 = y * columns + (x + 1) % columns;
+                        uint32_t i2 = ((y + 1) % rows) * columns + x;
+                        uint32_t i3 = ((y + 1) % rows) * columns + (x + 1) % columns;
+                        triangles.push_back({ i0, i2, i1 });
+                        triangles.push_back({ i1, i2, i3 });
+                    }
+                }
+            }
+        }
+        std::mt19937 random(1);
+        auto clusterTriangles = ClusterMaxSize / 3;
+        for (size_t start = 0; start < triangles.size(); start += clusterTriangles)
+            std::shuffle(triangles.begin() + start, triangles.begin() + std::min(start + clusterTriangles, triangles.size()), random);
+        for (auto&& triangle : triangles)
+            model.index.insert(model.index.end(), triangle.begin(), triangle.end());
+        return model;
+    }
+
+    // triangles as vertex positions, independent of the vertex order
+    engine::vector<std::array<float, 9>> trianglePositions(const ModelCpu& model, const uint32_t* index, size_t indexCount)
+    {
+        engine::vector<std::array<float, 9>> result;
+        for (size_t i = 0; i < indexCount; i += 3)
+        {
+            std::array<float, 9> triangle;
+            for (int c = 0; c < 3; ++c)
+            {
+                const auto& pos = model.vertex[index[i + c]];
+                triangle[c * 3 + 0] = pos.x;
+                triangle[c * 3 + 1] = pos.y;
+                triangle[c * 3 + 2] = pos.z;
+            }
+            result.emplace_back(triangle);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+}
+
+TEST(TestMeshOptimize, VertexCacheReducesAcmr)
+{
+    auto model = shuffledTorus(64, 32);
+    auto index = model.index;
+    auto before = meshAnalyzeVertexCache(index.data(), index.size());
+
+    meshOptimizeVertexCache(index.data(), index.size());
+    auto after = meshAnalyzeVertexCache(index.data(), index.size());
+
+    EXPECT_GT(before.acmr, 2.0f);
+    EXPECT_LT(after.acmr, 0.8f);
+    EXPECT_LT(after.atvr, 1.6f);
+    EXPECT_EQ(trianglePositions(model, model.index.data(), model.index.size()), trianglePositions(model, index.data(), index.size()));
+}
+
+TEST(TestMeshOptimize, OverdrawDrawsOutwardFacingFirst)
+{
+    auto model = shuffledTorus(64, 32);
+    auto index = model.index;
+    meshOptimizeVertexCache(index.data(), index.size());
+    auto cacheOptimised = meshAnalyzeVertexCache(index.data(), index.size());
+
+    meshOptimizeOverdraw(index.data(), index.size(), model.vertex);
+    auto after = meshAnalyzeVertexCache(index.data(), index.size());
+    EXPECT_LT(after.acmr, cacheOptimised.acmr * 1.25f);
+    EXPECT_EQ(trianglePositions(model, model.index.data(), model.index.size()), trianglePositions(model, index.data(), index.size()));
+
+    // the torus center is at the origin. the outer side occludes the
+    // inner one, so the start of the index faces away from the center
+    auto facing = [&](size_t triangle)
+    {
+        const auto& p0 = model.vertex[index[triangle * 3 + 0]];
+        const auto& p1 = model.vertex[index[triangle * 3 + 1]];
+        const auto& p2 = model.vertex[index[triangle * 3 + 2]];
+        Vector3f normal = (p1 - p0).cross(p2 - p0);
+        return normal.dot((p0 + p1 + p2) / 3.0f);
+    };
+    auto triangleCount = index.size() / 3;
+    size_t outwardFirst = 0;
+    size_t outwardLast = 0;
+    for (size_t t = 0; t < triangleCount / 4; ++t)
+    {
+        outwardFirst += facing(t) > 0.0f ? 1 : 0;
+        outwardLast += facing(triangleCount - 1 - t) > 0.0f ? 1 : 0;
+    }
+    EXPECT_GT(outwardFirst, outwardLast);
+}
+
+TEST(TestMeshOptimize, VertexFetchOrdersByFirstUse)
+{
+    auto model = shuffledTorus(32, 16);
+    auto original = model;
+    auto index = model.index;
+
+    meshOptimizeVertexFetch(model, index);
+
+    uint32_t next = 0;
+    for (auto&& v : index)
+    {
+        EXPECT_LE(v, next);
+        if (v == next)
+            ++next;
+    }
+    EXPECT_EQ(next, model.vertex.size());
+    EXPECT_EQ(index, model.index);
+    for (size_t i = 0; i < index.size(); ++i)
+    {
+        EXPECT_EQ(model.vertex[index[i]], original.vertex[original.index[i]]);
+        EXPECT_EQ(model.normal[index[i]], original.normal[original.index[i]]);
+        EXPECT_EQ(model.uv[0][index[i]].x, original.uv[0][original.index[i]].x);
+    }
+}
+
+TEST(TestMeshOptimize, ClustersKeepTheirTriangles)
+{
+    auto model = shuffledTorus(64, 32);
+    auto original = model;
+    auto clusterIndex = model.index;
+    auto before = meshAnalyzeVertexCache(clusterIndex.data(), clusterIndex.size());
+
+    JobSystem workers(2);
+    meshOptimizeClusters(model, clusterIndex, workers);
+    auto after = meshAnalyzeVertexCache(clusterIndex.data(), clusterIndex.size());
+    EXPECT_GT(before.acmr, 2.0f);
+    EXPECT_LT(after.acmr, 0.85f);
+
+    for (size_t start = 0; start < clusterIndex.size(); start += ClusterMaxSize)
+    {
+        auto count = std::min(static_cast<size_t>(ClusterMaxSize), clusterIndex.size() - start);
+        EXPECT_EQ(
+            trianglePositions(original, original.index.data() + start, count),
+            trianglePositions(model, clusterIndex.data() + start, count));
+    }
+}
+
+TEST(TestMeshOptimize, DISABLED_OptimizePerformance)
+{
+    for (uint32_t side : { 128u, 512u, 1024u })
+    {
+        auto model = shuffledTorus(side, side / 2);
+        auto clusterIndex = model.index;
+        auto triangles = clusterIndex.size() / 3;
+        auto before = meshAnalyzeVertexCache(clusterIndex.data(), clusterIndex.size());
+
+        auto start = std::chrono::high_resolution_clock::now();
+        meshOptimizeClusters(model, clusterIndex);
+        double clusterMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        auto clusters = meshAnalyzeVertexCache(clusterIndex.data(), clusterIndex.size());
+
+        auto index = model.index;
+        start = std::chrono::high_resolution_clock::now();
+        meshOptimizeVertexCache(index.data(), index.size());
+        double meshMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        auto mesh = meshAnalyzeVertexCache(index.data(), index.size());
+
+        LOG_INFO("Clusters of %zu triangles: ACMR %f -> %f, ATVR %f -> %f, %f ms, %f M triangles/s",
+            triangles, before.acmr, clusters.acmr, before.atvr, clusters.atvr, clusterMs, static_cast<double>(triangles) / (clusterMs * 1000.0));
+        LOG_INFO("Whole mesh of %zu triangles: ACMR %f, ATVR %f, %f ms, %f M triangles/s",
+            triangles, mesh.acmr, mesh.atvr, meshMs, static_cast<double>(triangles) / (meshMs * 1000.0));
+    }
+}
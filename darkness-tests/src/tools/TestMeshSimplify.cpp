@@ -0,0 +1,249 @@
+#include "gtest/gtest.h"
+#include "tools/MeshSimplify.h"
+#include "engine/rendering/ModelCpu.h"
+#include "tools/Debug.h"
+#include "containers/vector.h"
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <map>
+
+using namespace engine;
+
+namespace
+{
+    constexpr float Pi = 3.14159265f;
+
+    // triangles in 8x4 quad tiles, about what Clusterize gives
+    void addGridTriangles(ModelCpu& model, uint32_t columns, uint32_t rows)
+    {
+        for (uint32_t tileY = 0; tileY < rows; tileY += 4)
+        {
+            for (uint32_t tileX = 0; tileX < columns; tileX += 8)
+            {
+                for (uint32_t y = tileY; y < std::min(tileY + 4, rows); ++y)
+                {
+                    for (uint32_t x = tileX; x < std::min(tileX + 8, columns); ++x)
+                    {
+                        uint32_t i0 = y * (columns + 1) + x;
+                        uint32_t i1 = i0 + 1;
+                        uint32_t i2 = i0 + columns + 1;
+                        uint32_t i3 = i2 + 1;
+                        model.index.insert(model.index.end(), { i0, i2, i1, i1, i2, i3 });
+                    }
+                }
+            }
+        }
+    }
+
+    void updateBoundingBox(ModelCpu& model)
+    {
+        model.boundingBox.min = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+        model.boundingBox.max = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+        for (auto&& v : model.vertex)
+        {
+            model.boundingBox.min = Vector3f{ std::min(model.boundingBox.min.x, v.x), std::min(model.boundingBox.min.y, v.y), std::min(model.boundingBox.min.z, v.z) };
+            model.boundingBox.max = Vector3f{ std::max(model.boundingBox.max.x, v.x), std::max(model.boundingBox.max.y, v.y), std::max(model.boundingBox.max.z, v.z) };
+        }
+    }
+
+    // closed genus one surface. the wrap around vertexes are duplicated
+    // like an uv seam in an imported model
+    ModelCpu torus(uint32_t columns, uint32_t rows)
+    {
+        ModelCpu model;
+        model.uv.resize(1);
+        for (uint32_t y = 0; y <= rows; ++y)
+        {
+            for (uint32_t x = 0; x <= columns; ++x)
+            {
+                float u = static_cast<float>(x % columns) / static_cast<float>(columns) * 2.0f * Pi;
+                float v = static_cast<float>(y % rows) / static_cast<float>(rows) * 2.0f * Pi;
+                Vector3f normal{ std::cos(u) * std::cos(v), std::sin(v), std::sin(u) * std::cos(v) };
+                model.vertex.emplace_back(Vector3f{ std::cos(u) * 3.0f, 0.0f, std::sin(u) * 3.0f } + normal);
+                model.normal.emplace_back(normal);
+                model.uv[0].emplace_back(Vector2f{ static_cast<float>(x) / static_cast<float>(columns), static_cast<float>(y) / static_cast<float>(rows) });
+            }
+        }
+        addGridTriangles(model, columns, rows);
+        updateBoundingBox(model);
+        return model;
+    }
+
+    ModelCpu wavyGrid(uint32_t columns, uint32_t rows)
+    {
+        ModelCpu model;
+        for (uint32_t y = 0; y <= rows; ++y)
+        {
+            for (uint32_t x = 0; x <= columns; ++x)
+            {
+                float u = static_cast<float>(x) / static_cast<float>(columns);
+                float v = static_cast<float>(y) / static_cast<float>(rows);
+                model.vertex.emplace_back(Vector3f{ u, std::sin(u * 4.0f * Pi) * std::cos(v * 3.0f * Pi) * 0.05f, v });
+            }
+        }
+        addGridTriangles(model, columns, rows);
+        updateBoundingBox(model);
+        return model;
+    }
+
+    // edges between vertex positions, with the direction they are used in
+    struct Topology
+    {
+        size_t vertexes;
+        size_t edges;
+        size_t triangles;
+        size_t openEdges;
+        size_t badEdges;
+
+        int eulerCharacteristic() const
+        {
+            return static_cast<int>(vertexes) - static_cast<int>(edges) + static_cast<int>(triangles);
+        }
+    };
+
+    Topology topology(const ModelCpu& model, const engine::vector<uint32_t>& index)
+    {
+        std::map<std::tuple<float, float, float>, uint32_t> welds;
+        auto weld = [&](uint32_t v)->uint32_t
+        {
+            const auto& p = model.vertex[v];
+            return welds.emplace(std::make_tuple(p.x, p.y, p.z), static_cast<uint32_t>(welds.size())).first->second;
+        };
+
+        // forward and backward uses of each undirected edge
+        std::map<std::pair<uint32_t, uint32_t>, std::pair<int, int>> edges;
+        for (size_t t = 0; t < index.size(); t += 3)
+        {
+            for (int e = 0; e < 3; ++e)
+            {
+                auto a = weld(index[t + e]);
+                auto b = weld(index[t + (e + 1) % 3]);
+                if (a < b) ++edges[{ a, b }].first;
+                else ++edges[{ b, a }].second;
+            }
+        }
+
+        Topology res{ welds.size(), edges.size(), index.size() / 3, 0, 0 };
+        for (auto&& edge : edges)
+        {
+            if (edge.second.first + edge.second.second == 1)
+                ++res.openEdges;
+            else if (edge.second.first != 1 || edge.second.second != 1)
+                ++res.badEdges;
+        }
+        return res;
+    }
+
+}
+
+TEST(TestMeshSimplify, KeepsClosedTopology)
+{
+    auto model = torus(64, 32);
+    auto before = topology(model, model.index);
+    EXPECT_EQ(before.openEdges, 0u);
+    EXPECT_EQ(before.badEdges, 0u);
+    EXPECT_EQ(before.eulerCharacteristic(), 0);
+
+    SimplifySettings settings;
+    settings.targetTriangleCount = model.index.size() / 3 / 10;
+    settings.normalWeight = 0.1f;
+    settings.uvWeight = 0.1f;
+    auto result = meshSimplify(model, model.index, settings);
+
+    auto after = topology(model, result.index);
+    EXPECT_LT(after.triangles, before.triangles / 4);
+    // the last collapse can take the count one triangle under the target
+    EXPECT_GE(after.triangles + 1, settings.targetTriangleCount);
+    EXPECT_EQ(after.openEdges, 0u);
+    EXPECT_EQ(after.badEdges, 0u);
+    EXPECT_EQ(after.eulerCharacteristic(), 0);
+    EXPECT_GT(result.error, 0.0f);
+
+    // the remaining vertexes still have their own attributes
+    for (auto&& vertex : result.index)
+        EXPECT_LT(vertex, model.vertex.size());
+}
+
+TEST(TestMeshSimplify, LocksBorder)
+{
+    auto model = wavyGrid(40, 40);
+    auto before = topology(model, model.index);
+    EXPECT_EQ(before.openEdges, 160u);
+
+    engine::vector<uint8_t> border(model.vertex.size(), 0);
+    for (uint32_t y = 0; y <= 40; ++y)
+        for (uint32_t x = 0; x <= 40; ++x)
+            border[y * 41 + x] = x == 0 || y == 0 || x == 40 || y == 40;
+
+    SimplifySettings settings;
+    auto result = meshSimplify(model, model.index, settings);
+    auto after = topology(model, result.index);
+    EXPECT_LT(after.triangles, before.triangles / 2);
+    EXPECT_EQ(after.openEdges, before.openEdges);
+    EXPECT_EQ(after.badEdges, 0u);
+    EXPECT_EQ(after.eulerCharacteristic(), 1);
+
+    engine::vector<uint8_t> used(model.vertex.size(), 0);
+    for (auto&& vertex : result.index)
+        used[vertex] = 1;
+    for (size_t v = 0; v < model.vertex.size(); ++v)
+    {
+        if (border[v])
+        {
+            EXPECT_TRUE(used[v]);
+        }
+    }
+
+    // without the lock the border simplifies too but stays one open loop
+    settings.lockBorder = false;
+    auto unlocked = meshSimplify(model, model.index, settings);
+    auto unlockedTopology = topology(model, unlocked.index);
+    EXPECT_LT(unlockedTopology.triangles, after.triangles);
+    EXPECT_LT(unlockedTopology.openEdges, before.openEdges);
+    EXPECT_EQ(unlockedTopology.badEdges, 0u);
+    EXPECT_EQ(unlockedTopology.eulerCharacteristic(), 1);
+}
+
+TEST(TestMeshSimplify, StopsAtTargetError)
+{
+    // a flat grid collapses with no error at all
+    auto flat = wavyGrid(32, 32);
+    for (auto&& v : flat.vertex)
+        v.y = 0.0f;
+    SimplifySettings settings;
+    settings.targetError = 1e-6f;
+    auto flatResult = meshSimplify(flat, flat.index, settings);
+    EXPECT_LT(flatResult.index.size(), flat.index.size() / 8);
+    EXPECT_LE(flatResult.error, 1e-6f);
+
+    auto model = torus(64, 32);
+    for (float targetError : { 0.001f, 0.01f, 0.1f })
+    {
+        settings.targetError = targetError;
+        auto result = meshSimplify(model, model.index, settings);
+        EXPECT_LE(result.error, targetError);
+        EXPECT_LT(result.index.size(), model.index.size());
+    }
+}
+
+TEST(TestMeshSimplify, DISABLED_SimplifyPerformance)
+{
+    for (uint32_t side : { 128u, 512u, 1024u })
+    {
+        auto model = torus(side, side / 2);
+        auto triangles = model.index.size() / 3;
+
+        SimplifySettings settings;
+        settings.targetTriangleCount = triangles / 10;
+        settings.normalWeight = 0.1f;
+        settings.uvWeight = 0.1f;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        auto result = meshSimplify(model, model.index, settings);
+        double simplifyMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        LOG_INFO("Simplify %zu -> %zu triangles, error %f: %f ms, %f M triangles/s",
+            triangles, result.index.size() / 3, result.error, simplifyMs, static_cast<double>(triangles) / (simplifyMs * 1000.0));
+    }
+}
@@ -1,6 +1,14 @@
 #include "gtest/gtest.h"
 #include "tools/PathTools.h"
 #include "tools/Settings.h"
+#include "tools/Debug.h"
+#include "platform/File.h"
+#include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <string>
 
 using namespace engine;
 using namespace tools;
@@ -96,3 +104,348 @@ TEST(TestSettings, Settings_Groups)
     }
 
 }
+
+namespace
+{
+    engine::string settingsTestPath(const char* filename)
+    {
+        return engine::string((std::filesystem::temp_directory_path() / filename).string().c_str());
+    }
+
+    void writeEveryType(Settings& settings)
+    {
+        settings.set("bool", true);
+        settings.set("char", static_cast<char>(-12));
+        settings.set("short", static_cast<short>(-1234));
+        settings.set("int", -123456);
+        settings.set("int64", static_cast<int64_t>(-1234567890123ll));
+        settings.set("uchar", static_cast<unsigned char>(200));
+        settings.set("ushort", static_cast<unsigned short>(60000));
+        settings.set("uint", 4000000000u);
+        settings.set("uint64", static_cast<uint64_t>(12345678901234567ull));
+        settings.set("float", 1.25f);
+        settings.set("double", 3.0625);
+        settings.set("string", engine::string("some string"));
+        settings.set("empty string", engine::string(""));
+
+        settings.set("bools", engine::vector<bool>{ true, false, true });
+        settings.set("chars", engine::vector<char>{ 1, -2, 3 });
+        settings.set("shorts", engine::vector<short>{ -300, 300 });
+        settings.set("ints", engine::vector<int>{ 1, 2, 3, 4, 5 });
+        settings.set("int64s", engine::vector<int64_t>{ -1, 1ll << 40 });
+        settings.set("uchars", engine::vector<unsigned char>{ 0, 255 });
+        settings.set("ushorts", engine::vector<unsigned short>{ 1, 65535 });
+        settings.set("uints", engine::vector<unsigned int>{ 7, 4000000000u });
+        settings.set("uint64s", engine::vector<uint64_t>{ 1ull << 50 });
+        settings.set("floats", engine::vector<float>{ 0.5f, -0.25f });
+        settings.set("doubles", engine::vector<double>{ 0.125, 1e10 });
+        settings.set("strings", engine::vector<engine::string>{ "a", "", "ccc" });
+        settings.set("empty ints", engine::vector<int>{});
+
+        // same key, another type
+        settings.set("int", 0.5f);
+
+        settings.beginGroup("group");
+        settings.set("int", 1);
+        settings.beginGroup("child");
+        settings.set("string", engine::string("child string"));
+        settings.endGroup();
+        settings.endGroup();
+
+        settings.beginGroup("empty group");
+        settings.endGroup();
+    }
+
+    void expectEveryType(Settings& settings)
+    {
+        EXPECT_EQ(settings.get<bool>("bool"), true);
+        EXPECT_EQ(settings.get<char>("char"), static_cast<char>(-12));
+        EXPECT_EQ(settings.get<short>("short"), static_cast<short>(-1234));
+        EXPECT_EQ(settings.get<int>("int"), -123456);
+        EXPECT_EQ(settings.get<int64_t>("int64"), static_cast<int64_t>(-1234567890123ll));
+        EXPECT_EQ(settings.get<unsigned char>("uchar"), static_cast<unsigned char>(200));
+        EXPECT_EQ(settings.get<unsigned short>("ushort"), static_cast<unsigned short>(60000));
+        EXPECT_EQ(settings.get<unsigned int>("uint"), 4000000000u);
+        EXPECT_EQ(settings.get<uint64_t>("uint64"), static_cast<uint64_t>(12345678901234567ull));
+        EXPECT_EQ(settings.get<float>("float"), 1.25f);
+        EXPECT_EQ(settings.get<double>("double"), 3.0625);
+        EXPECT_EQ(settings.get<engine::string>("string"), engine::string("some string"));
+        EXPECT_TRUE(settings.get<engine::string>("empty string").empty());
+
+        EXPECT_EQ(settings.get<engine::vector<bool>>("bools"), (engine::vector<bool>{ true, false, true }));
+        EXPECT_EQ(settings.get<engine::vector<char>>("chars"), (engine::vector<char>{ 1, -2, 3 }));
+        EXPECT_EQ(settings.get<engine::vector<short>>("shorts"), (engine::vector<short>{ -300, 300 }));
+        EXPECT_EQ(settings.get<engine::vector<int>>("ints"), (engine::vector<int>{ 1, 2, 3, 4, 5 }));
+        EXPECT_EQ(settings.get<engine::vector<int64_t>>("int64s"), (engine::vector<int64_t>{ -1, 1ll << 40 }));
+        EXPECT_EQ(settings.get<engine::vector<unsigned char>>("uchars"), (engine::vector<unsigned char>{ 0, 255 }));
+        EXPECT_EQ(settings.get<engine::vector<unsigned short>>("ushorts"), (engine::vector<unsigned short>{ 1, 65535 }));
+        EXPECT_EQ(settings.get<engine::vector<unsigned int>>("uints"), (engine::vector<unsigned int>{ 7, 4000000000u }));
+        EXPECT_EQ(settings.get<engine::vector<uint64_t>>("uint64s"), (engine::vector<uint64_t>{ 1ull << 50 }));
+        EXPECT_EQ(settings.get<engine::vector<float>>("floats"), (engine::vector<float>{ 0.5f, -0.25f }));
+        EXPECT_EQ(settings.get<engine::vector<double>>("doubles"), (engine::vector<double>{ 0.125, 1e10 }));
+        EXPECT_EQ(settings.get<engine::vector<engine::string>>("strings"), (engine::vector<engine::string>{ "a", "", "ccc" }));
+        EXPECT_TRUE(settings.get<engine::vector<int>>("empty ints").empty());
+        EXPECT_EQ(settings.get<float>("int"), 0.5f);
+        EXPECT_EQ(settings.keys().size(), 27);
+
+        EXPECT_EQ(settings.groups().size(), 2);
+        settings.beginGroup("group");
+        EXPECT_EQ(settings.get<int>("int"), 1);
+        settings.beginGroup("child");
+        EXPECT_EQ(settings.get<engine::string>("string"), engine::string("child string"));
+        settings.endGroup();
+        settings.endGroup();
+
+        settings.beginGroup("empty group");
+        EXPECT_EQ(settings.keys().size(), 0);
+        settings.endGroup();
+    }
+}
+
+TEST(TestSettings, Settings_JsonBinaryRoundTrip)
+{
+    auto jsonPath = settingsTestPath("SettingsRoundTrip.json");
+    auto binaryPath = settingsTestPath("SettingsRoundTrip.dat");
+    auto jsonAgainPath = settingsTestPath("SettingsRoundTripAgain.json");
+    {
+        Settings settings(jsonPath);
+        writeEveryType(settings);
+    }
+    {
+        Settings settings(jsonPath);
+        expectEveryType(settings);
+        settings.save(binaryPath, SettingsBackend::Binary);
+    }
+    {
+        Settings settings(binaryPath, SettingsBackend::Binary);
+        expectEveryType(settings);
+        settings.save(jsonAgainPath, SettingsBackend::Json);
+    }
+    {
+        Settings settings(jsonAgainPath);
+        expectEveryType(settings);
+    }
+}
+
+TEST(TestSettings, Settings_BinaryChanges)
+{
+    auto path = settingsTestPath("SettingsBinaryChanges.dat");
+    {
+        Settings settings(path, SettingsBackend::Binary);
+        writeEveryType(settings);
+    }
+    {
+        // values grow, shrink and get added to the mapped file
+        Settings settings(path, SettingsBackend::Binary);
+        settings.set("string", engine::string("a string that does not fit where the old one was"));
+        settings.set("ints", engine::vector<int>{ 9 });
+        settings.set("new key", 5);
+        settings.beginGroup("new group");
+        settings.set("new key", 6);
+        settings.endGroup();
+    }
+    {
+        Settings settings(path, SettingsBackend::Binary);
+        EXPECT_EQ(settings.get<engine::string>("string"), engine::string("a string that does not fit where the old one was"));
+        EXPECT_EQ(settings.get<engine::vector<int>>("ints"), engine::vector<int>{ 9 });
+        EXPECT_EQ(settings.get<int>("new key"), 5);
+        EXPECT_EQ(settings.get<double>("double"), 3.0625);
+        settings.beginGroup("new group");
+        EXPECT_EQ(settings.get<int>("new key"), 6);
+        settings.endGroup();
+        EXPECT_EQ(settings.groups().size(), 3);
+    }
+}
+
+TEST(TestSettings, Settings_MalformedBinaryIsEmpty)
+{
+    auto path = settingsTestPath("SettingsMalformed.dat");
+    {
+        std::ofstream out(path.c_str(), std::ios::binary);
+        engine::vector<char> garbage(1000, 7);
+        out.write(garbage.data(), garbage.size());
+    }
+
+    Settings settings(path, SettingsBackend::Binary);
+    EXPECT_EQ(settings.keys().size(), 0);
+    EXPECT_EQ(settings.groups().size(), 0);
+}
+
+namespace
+{
+    // writes a binary settings file with one int and overwrites a field of it
+    void writePatchedSettings(const engine::string& path, size_t fieldOffset, uint64_t fieldValue, size_t fieldBytes)
+    {
+        engine::fileDelete(path);
+        {
+            Settings settings(path, SettingsBackend::Binary);
+            settings.set("value", 5);
+        }
+
+        engine::vector<char> file;
+        {
+            std::ifstream in(path.c_str(), std::ios::binary);
+            file.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        ASSERT_GE(file.size(), fieldOffset + fieldBytes);
+        memcpy(file.data() + fieldOffset, &fieldValue, fieldBytes);
+        std::ofstream out(path.c_str(), std::ios::binary);
+        out.write(file.data(), file.size());
+    }
+
+    uint64_t settingsFileField(const engine::string& path, size_t offset)
+    {
+        std::ifstream in(path.c_str(), std::ios::binary);
+        in.seekg(offset);
+        uint64_t value = 0;
+        in.read(reinterpret_cast<char*>(&value), sizeof(uint64_t));
+        return value;
+    }
+
+    // offsets in the file header, the group and the entry
+    constexpr size_t HeaderGroupsOffset = 16;
+    constexpr size_t HeaderEntriesOffset = 24;
+    constexpr size_t GroupDataBytes = 56;
+    constexpr size_t EntrySize = 20;
+}
+
+TEST(TestSettings, Settings_MalformedBinaryGroupDataSize)
+{
+    auto path = settingsTestPath("SettingsMalformedGroup.dat");
+    writePatchedSettings(path, 0, 0, 0);
+    auto groupsOffset = settingsFileField(path, HeaderGroupsOffset);
+
+    // the int fits but the group data is not whole values
+    writePatchedSettings(path, groupsOffset + GroupDataBytes, 4, sizeof(uint64_t));
+    {
+        Settings settings(path, SettingsBackend::Binary);
+        EXPECT_EQ(settings.keys().size(), 0);
+
+        settings.set("new key", 7);
+        EXPECT_EQ(settings.get<int>("new key"), 7);
+    }
+}
+
+TEST(TestSettings, Settings_MalformedBinaryEntrySize)
+{
+    auto path = settingsTestPath("SettingsMalformedEntry.dat");
+    writePatchedSettings(path, 0, 0, 0);
+    auto entriesOffset = settingsFileField(path, HeaderEntriesOffset);
+
+    for (uint32_t size : { 0u, 2u, 8u })
+    {
+        writePatchedSettings(path, entriesOffset + EntrySize, size, sizeof(uint32_t));
+        Settings settings(path, SettingsBackend::Binary);
+        EXPECT_EQ(settings.keys().size(), 0);
+    }
+
+    writePatchedSettings(path, entriesOffset + EntrySize, 4, sizeof(uint32_t));
+    Settings settings(path, SettingsBackend::Binary);
+    EXPECT_EQ(settings.get<int>("value"), 5);
+}
+
+TEST(TestSettings, Settings_Handles)
+{
+    auto path = settingsTestPath("SettingsHandles.dat");
+    engine::fileDelete(path);
+    {
+        Settings settings(path, SettingsBackend::Binary);
+        settings.set("existing", 2.5f);
+
+        auto existing = settings.handle<float>("existing");
+        auto added = settings.handle<int>("added", 7);
+        EXPECT_EQ(existing.get(), 2.5f);
+        EXPECT_EQ(added.get(), 7);
+
+        // adding keys moves the values but not the handles
+        for (int i = 0; i < 100; ++i)
+            settings.set(std::to_string(i).c_str(), i);
+        EXPECT_EQ(existing.get(), 2.5f);
+
+        added.set(8);
+        EXPECT_EQ(settings.get<int>("added"), 8);
+        settings.set("added", 9);
+        EXPECT_EQ(added.get(), 9);
+    }
+    {
+        Settings settings(path, SettingsBackend::Binary);
+        EXPECT_EQ(settings.get<int>("added"), 9);
+
+        auto flag = settings.handle<bool>("flag", true);
+        auto added = settings.handle<int>("added");
+        EXPECT_TRUE(flag.get());
+
+        // writes through a handle are saved like the others
+        added.set(10);
+        settings.save();
+        added.set(11);
+        EXPECT_EQ(added.get(), 11);
+    }
+    {
+        Settings settings(path, SettingsBackend::Binary);
+        EXPECT_EQ(settings.get<int>("added"), 11);
+        EXPECT_TRUE(settings.get<bool>("flag"));
+    }
+}
+
+TEST(TestSettings, DISABLED_Settings_LoadPerformance)
+{
+    auto jsonPath = settingsTestPath("SettingsPerformance.json");
+    auto binaryPath = settingsTestPath("SettingsPerformance.dat");
+    const int groups = 100;
+    const int keysPerGroup = 1000;
+    {
+        Settings settings(jsonPath);
+        for (int group = 0; group < groups; ++group)
+        {
+            settings.beginGroup(std::to_string(group).c_str());
+            for (int key = 0; key < keysPerGroup; ++key)
+            {
+                auto name = "setting " + std::to_string(key);
+                if (key % 2 == 0)
+                    settings.set(name.c_str(), static_cast<float>(key));
+                else
+                    settings.set(name.c_str(), engine::string(name.c_str()));
+            }
+            settings.endGroup();
+        }
+        settings.save();
+        settings.save(binaryPath, SettingsBackend::Binary);
+    }
+
+    for (auto backend : { SettingsBackend::Json, SettingsBackend::Binary })
+    {
+        const int rounds = 10;
+        double ms = 0.0;
+        float sum = 0.0f;
+        for (int i = 0; i < rounds; ++i)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            Settings settings(backend == SettingsBackend::Json ? jsonPath : binaryPath, backend);
+            settings.beginGroup("50");
+            sum += settings.get<float>("setting 500");
+            settings.endGroup();
+            ms += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        }
+        LOG_INFO("Settings %s load of %i values: %f ms (%f)",
+            backend == SettingsBackend::Json ? "json" : "binary", groups * keysPerGroup, ms / rounds, sum);
+    }
+
+    Settings settings(binaryPath, SettingsBackend::Binary);
+    settings.beginGroup("50");
+    const int gets = 1000000;
+    float sum = 0.0f;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < gets; ++i)
+        sum += settings.get<float>("setting 500");
+    double getMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    auto handle = settings.handle<float>("setting 500");
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < gets; ++i)
+        sum += handle.get();
+    double handleMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    settings.endGroup();
+
+    LOG_INFO("Settings %i gets: %f ms by key, %f ms by handle (%f)", gets, getMs, handleMs, sum);
+}
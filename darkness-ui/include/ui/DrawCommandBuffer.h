@@ -7,12 +7,11 @@
 #include "engine/graphics/ResourceOwners.h"
 #include "engine/graphics/CommandList.h"
 #include "tools/image/ImageIf.h"
-#include "shaders/core/ui/DrawRectangle.h"
+#include "shaders/core/ui/DrawColoredRectangles.h"
 #include "shaders/core/ui/DrawRectangles.h"
 #include "shaders/core/ui/DrawImage.h"
 #include "shaders/core/ui/DrawImageUint.h"
 #include "shaders/core/ui/DrawText.h"
-#include "shaders/core/ui/DrawTextSimple.h"
 #include "containers/unordered_map.h"
 #include "tools/image/ImageIf.h"
 #include "engine/font/Font.h"
@@ -51,6 +50,36 @@ namespace ui
 
 		void reset();
 
+		// retained rendering. a frame that hasn't changed replays the packets
+		// it recorded earlier instead of painting again
+		class Recording;
+		size_t recordingMark() const { return m_commands.size(); }
+
+		// copies the packets recorded after mark. false if they can't be replayed
+		bool capture(size_t mark, Recording& recording) const;
+		void replay(const Recording& recording);
+
+		// true when the buffer can be recorded again without a reset
+		bool replayable() const { return m_commandListPackets == 0; }
+
+		struct RetainedStatistics
+		{
+			uint32_t recorded;
+			uint32_t replayed;
+		};
+		RetainedStatistics& retainedStatistics() { return m_retainedStatistics; }
+		const RetainedStatistics& retainedStatistics() const { return m_retainedStatistics; }
+
+		// counted by the last recordCommands
+		struct DrawStatistics
+		{
+			uint32_t packets;
+			uint32_t batches;
+			uint32_t drawCalls;
+			uint32_t pipelineBinds;
+		};
+		const DrawStatistics& drawStatistics() const { return m_drawStatistics; }
+
 		struct RenderCommandList
 		{
 			engine::CommandList cmdList;
@@ -214,6 +243,27 @@ namespace ui
 		};
 		#pragma pack(pop)
 
+	public:
+		class Recording
+		{
+		public:
+			void clear()
+			{
+				m_packets.clear();
+				m_texts.clear();
+			}
+			bool empty() const { return m_packets.empty(); }
+
+		private:
+			friend class DrawCommandBuffer;
+			engine::vector<CommandPacket> m_packets;
+
+			// text packets point to the string buffer which is reset every frame
+			engine::vector<engine::string> m_texts;
+		};
+
+	private:
+
 		struct RectangleItem
 		{
 			float2 position;
@@ -222,7 +272,38 @@ namespace ui
 			uint3 padding;
 		};
 
+		struct ColoredRectangleItem
+		{
+			float2 position;
+			float2 size;
+			float4 color;
+		};
+
+		// packets that end up in one draw. rectangles and glyphs are clipped
+		// on the cpu so packets with different scissors can share a draw
+		enum class BatchType : unsigned char
+		{
+			Rectangles,
+			Glyphs,
+			Image,
+			CommandList
+		};
+
+		struct Batch
+		{
+			BatchType type;
+			engine::Rectangle bounds;
+			engine::TextureSRV texture;
+			engine::vector<ColoredRectangleItem> rectangles;
+			engine::vector<engine::Font::GlyphRenderNodeData> glyphs;
+			engine::vector<engine::Vector2f> glyphPositions;
+			CommandPacket* packet;
+		};
+		void buildBatches(engine::vector<Batch>& batches);
+
 		engine::vector<CommandPacket> m_commands;
+		size_t m_commandListPackets;
+		RetainedStatistics m_retainedStatistics;
 
 		std::stack<GlobalTransform> m_transformStack;
 
@@ -230,21 +311,20 @@ namespace ui
 		engine::vector<char> m_stringBuffer;
 		size_t m_stringBufferIndex;
 
-		void recordRectangle(engine::CommandList& cmd, engine::TextureRTV rtv, const CommandPacket& packet);
+		void recordRectangles(engine::CommandList& cmd, engine::TextureRTV rtv, const Batch& batch);
 		void recordImage(engine::CommandList& cmd, engine::TextureRTV rtv, const CommandPacket& packet);
-		void recordText(engine::CommandList& cmd, engine::TextureRTV rtv, const CommandPacket& packet);
+		void recordGlyphs(engine::CommandList& cmd, engine::TextureRTV rtv, const Batch& batch);
 		void recordText(
 			engine::CommandList& cmd, 
 			engine::TextureRTV rtv, 
 			const engine::vector<PacketText>& textPackets, 
 			const engine::vector<engine::Rectangle>& scissors);
 
-		engine::Pipeline<engine::shaders::DrawRectangle> m_drawRectangle;
+		engine::Pipeline<engine::shaders::DrawColoredRectangles> m_drawColoredRectangles;
 		engine::Pipeline<engine::shaders::DrawRectangles> m_drawRectangles;
 		engine::Pipeline<engine::shaders::DrawImage> m_drawImage;
 		engine::Pipeline<engine::shaders::DrawImageUint> m_drawImageUint;
 		engine::Pipeline<engine::shaders::DrawText> m_drawText;
-		engine::Pipeline<engine::shaders::DrawTextSimple> m_drawTextSimple;
 
 		engine::unordered_map<engine::image::ImageIf*, engine::TextureSRVOwner> m_textures;
 
@@ -264,6 +344,13 @@ namespace ui
 		RectangleItem* m_rectanglesUploadPtr;
 		tools::RingBuffer m_rectanglesUploadRing;
 
+		engine::BufferOwner m_coloredRectanglesUploadBuffer;
+		engine::BufferSRVOwner m_coloredRectanglesUploadBufferSRV;
+		ColoredRectangleItem* m_coloredRectanglesUploadPtr;
+		tools::RingBuffer m_coloredRectanglesUploadRing;
+
+		DrawStatistics m_drawStatistics;
+
 		engine::TextureRTVOwner m_glyphScissorMaskRTV;
 		engine::TextureSRVOwner m_glyphScissorMaskSRV;
 		void resizeGlyphScissorMask(uint32_t width, uint32_t height);
@@ -47,13 +47,24 @@ namespace ui
 
 
 		bool drawBackground() const { return m_drawBackground; }
-		void drawBackground(bool val) { m_drawBackground = val; }
+		void drawBackground(bool val);
 
 		void reparent(Frame* parent);
 		Frame* getParent();
 		Frame* getParentRootFrame();
 		void invalidate();
 
+		// the frame records its draw commands again on the next invalidate.
+		// position, size, child and theme changes do this automatically
+		void markDirty();
+
+		// frames that paint something different every time turn this off
+		bool retained() const { return m_retained; }
+		void retained(bool val);
+
+		// how many frames were recorded and replayed on the last invalidate
+		DrawCommandBuffer::RetainedStatistics retainedStatistics() const;
+
 		RootFrame* getRootFrame() { return m_rootFrame.get(); }
 
 		void themeSet(bool value);
@@ -76,6 +87,10 @@ namespace ui
 		UiPoint getGlobalPosition() const;
 		UiPoint getGlobalPositionToLastRootFrame() const;
 
+		void onLayoutChange() override;
+		void onLayerOrderChange() override;
+		void onChildsChanged() override;
+
 	private:
 		engine::shared_ptr<GridImage> m_frameThemeImages;
 		engine::shared_ptr<GridImage> m_frameTabThemeImages;
@@ -113,10 +128,20 @@ namespace ui
 
 		//void render(std::queue<RenderList>& renderList, RenderList* item, engine::Rectangle clientRect);
 		void render(DrawCommandBuffer* cmd);
+		void submit(DrawCommandBuffer* cmd);
 		void recreateWindowHandles(Frame* frame);
 		void repositionSystemWindows(Frame* frame);
 
 		bool m_themeSet;
 		bool m_canFocus = false;
+
+		// retained rendering
+		bool m_dirty = true;
+		bool m_retained = true;
+		bool m_volatile = true;
+		uint32_t m_themeGeneration = 0;
+		DrawCommandBuffer::GlobalTransform m_recordedTransform = {};
+		DrawCommandBuffer::Recording m_recording;
+		bool canReplay(const DrawCommandBuffer::GlobalTransform& transform) const;
 	};
 }
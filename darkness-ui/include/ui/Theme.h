@@ -3,6 +3,7 @@
 #include "engine/primitives/Vector4.h"
 #include "containers/string.h"
 #include "containers/memory.h"
+#include <cstdint>
 
 namespace tools
 {
@@ -23,9 +24,13 @@ namespace ui
 		
 		engine::string image(const engine::string& assetName);
 		engine::Vector4f color(const engine::string& colorName);
+
+		// changes every time a theme is loaded
+		uint32_t generation() const { return m_generation; }
 	private:
 		Theme() {};
 		engine::shared_ptr<tools::Settings> m_settings;
+		uint32_t m_generation = 0;
 	};
 }
 
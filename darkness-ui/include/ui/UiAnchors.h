@@ -82,6 +82,10 @@ namespace ui
         void addAnchor(UiAnchor anchor);
         void removeAnchor(UiAnchor anchor);
 
+    protected:
+        // position or size changed
+        virtual void onLayoutChange() {};
+
     private:
         engine::vector<UiAnchor> m_anchors;
         void propagateChanges(unsigned int changes);
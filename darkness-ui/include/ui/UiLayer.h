@@ -11,5 +11,8 @@ namespace ui
         void moveUp();
         void moveDown();
         void moveToBottom();
+
+    protected:
+        virtual void onLayerOrderChange() {};
     };
 }
@@ -12,18 +12,20 @@
 #include "platform/Environment.h"
 #include "tools/PathTools.h"
 #include <algorithm>
+#include <cmath>
 
 namespace ui
 {
 	DrawCommandBuffer::DrawCommandBuffer(engine::Device& device)
 		: m_device{ device }
 		, m_open{ false }
-		, m_drawRectangle{ device.createPipeline<engine::shaders::DrawRectangle>() }
+		, m_commandListPackets{ 0 }
+		, m_retainedStatistics{}
+		, m_drawColoredRectangles{ device.createPipeline<engine::shaders::DrawColoredRectangles>() }
 		, m_drawRectangles{ device.createPipeline<engine::shaders::DrawRectangles>() }
 		, m_drawImage{ device.createPipeline<engine::shaders::DrawImage>() }
 		, m_drawImageUint{ device.createPipeline<engine::shaders::DrawImageUint>() }
 		, m_drawText{ device.createPipeline<engine::shaders::DrawText>() }
-		, m_drawTextSimple{ device.createPipeline<engine::shaders::DrawTextSimple>() }
 		, m_font{ nullptr }
 		, m_uploadRing{ tools::ByteRange{ 
 			reinterpret_cast<uint8_t*>(0), 
@@ -34,10 +36,20 @@ namespace ui
 		, m_rectanglesUploadRing{ tools::ByteRange{
 			reinterpret_cast<uint8_t*>(0), 
 			reinterpret_cast<uint8_t*>(MaxRectanglesInFlight) } }
+		, m_coloredRectanglesUploadRing{ tools::ByteRange{
+			reinterpret_cast<uint8_t*>(0),
+			reinterpret_cast<uint8_t*>(MaxRectanglesInFlight) } }
+		, m_drawStatistics{}
 	{
 		m_stringBuffer.resize(655360);
 		//m_font = m_device.fontManager().loadFont("C:\\work\\darkness\\darkness-editor-v2\\data\\Roboto\\Roboto-Regular.ttf");
 		m_font = m_device.fontManager().loadFont(engine::pathClean(engine::pathJoin(engine::getExecutableDirectory(), "..\\..\\..\\..\\data\\SegoeUI.ttf")));
+
+		// printable ascii gets rasterized in the background while the ui loads
+		engine::string printable;
+		for (char c = 32; c < 127; ++c)
+			printable += c;
+		m_font->prefetch(printable);
 		
 
 		engine::DepthStencilOpDescription front;
@@ -52,9 +64,9 @@ namespace ui
 		back.StencilPassOp = engine::StencilOp::Keep;
 		back.StencilFunc = engine::ComparisonFunction::Always;
 
-		m_drawRectangle.setPrimitiveTopologyType(engine::PrimitiveTopologyType::TriangleStrip);
-		m_drawRectangle.setRasterizerState(engine::RasterizerDescription().cullMode(engine::CullMode::None).fillMode(engine::FillMode::Solid)); // TODO
-		m_drawRectangle.setDepthStencilState(engine::DepthStencilDescription()
+		m_drawColoredRectangles.setPrimitiveTopologyType(engine::PrimitiveTopologyType::TriangleList);
+		m_drawColoredRectangles.setRasterizerState(engine::RasterizerDescription().cullMode(engine::CullMode::None).fillMode(engine::FillMode::Solid));
+		m_drawColoredRectangles.setDepthStencilState(engine::DepthStencilDescription()
 			.depthEnable(false)
 			.depthWriteMask(engine::DepthWriteMask::All)
 			.depthFunc(engine::ComparisonFunction::GreaterEqual)
@@ -115,32 +127,6 @@ namespace ui
 			.renderTargetWriteMask(1 | 2 | 4 | 8)
 		));
 
-		m_drawTextSimple.setPrimitiveTopologyType(engine::PrimitiveTopologyType::TriangleList);
-		m_drawTextSimple.setRasterizerState(engine::RasterizerDescription().frontCounterClockwise(false)
-			.cullMode(engine::CullMode::None)
-			.fillMode(engine::FillMode::Solid)); // TODO
-		m_drawTextSimple.setDepthStencilState(engine::DepthStencilDescription()
-			.depthEnable(false)
-			.depthWriteMask(engine::DepthWriteMask::All)
-			.depthFunc(engine::ComparisonFunction::GreaterEqual)
-			.frontFace(front)
-			.backFace(back));
-		m_drawTextSimple.ps.imageSampler = device.createSampler(engine::SamplerDescription().filter(engine::Filter::Bilinear).textureAddressMode(engine::TextureAddressMode::Clamp));
-		m_drawTextSimple.setBlendState(engine::BlendDescription().renderTarget(
-			0, engine::RenderTargetBlendDescription()
-			.blendEnable(true)
-
-			.srcBlend(engine::Blend::SrcAlpha)
-			.dstBlend(engine::Blend::InvSrcAlpha)
-			.blendOp(engine::BlendOperation::Add)
-
-			.srcBlendAlpha(engine::Blend::InvSrcAlpha)
-			.dstBlendAlpha(engine::Blend::Zero)
-			.blendOpAlpha(engine::BlendOperation::Add)
-
-			.renderTargetWriteMask(1 | 2 | 4 | 8)
-		));
-
 		m_uploadBuffer = m_device.createBuffer(engine::BufferDescription()
 				.usage(engine::ResourceUsage::Upload)
 				.elementSize(sizeof(engine::Font::GlyphRenderNodeData))
@@ -167,6 +153,15 @@ namespace ui
 			.name("Rectangles UploadBuffer"));
 		m_rectanglesUploadBufferSRV = m_device.createBufferSRV(m_rectanglesUploadBuffer);
 		m_rectanglesUploadPtr = reinterpret_cast<RectangleItem*>(m_rectanglesUploadBuffer.resource().map(m_device));
+
+		m_coloredRectanglesUploadBuffer = m_device.createBuffer(engine::BufferDescription()
+			.usage(engine::ResourceUsage::Upload)
+			.elementSize(sizeof(ColoredRectangleItem))
+			.elements(MaxRectanglesInFlight)
+			.structured(true)
+			.name("Colored rectangles UploadBuffer"));
+		m_coloredRectanglesUploadBufferSRV = m_device.createBufferSRV(m_coloredRectanglesUploadBuffer);
+		m_coloredRectanglesUploadPtr = reinterpret_cast<ColoredRectangleItem*>(m_coloredRectanglesUploadBuffer.resource().map(m_device));
 	}
 
 	DrawCommandBuffer::~DrawCommandBuffer()
@@ -286,12 +281,48 @@ namespace ui
 		packet.type = CommandType::CommandList;
 		packet.data = cmdListData;
 		m_commands.emplace_back(std::move(packet));
+		++m_commandListPackets;
 	}
 
 	void DrawCommandBuffer::reset()
 	{
 		m_stringBufferIndex = 0;
 		m_commands.clear();
+		m_commandListPackets = 0;
+	}
+
+	bool DrawCommandBuffer::capture(size_t mark, Recording& recording) const
+	{
+		recording.clear();
+		for (size_t i = mark; i < m_commands.size(); ++i)
+		{
+			const auto& packet = m_commands[i];
+			if (packet.type == CommandType::CommandList)
+			{
+				// api command lists are consumed when recorded
+				recording.clear();
+				return false;
+			}
+
+			recording.m_packets.emplace_back(packet);
+			if (packet.type == CommandType::Text)
+			{
+				recording.m_texts.emplace_back(static_cast<PacketText*>(packet.data)->text);
+				static_cast<PacketText*>(recording.m_packets.back().data)->text = nullptr;
+			}
+		}
+		return true;
+	}
+
+	void DrawCommandBuffer::replay(const Recording& recording)
+	{
+		size_t text = 0;
+		for (auto&& packet : recording.m_packets)
+		{
+			m_commands.emplace_back(packet);
+			if (packet.type == CommandType::Text)
+				static_cast<PacketText*>(m_commands.back().data)->text = allocateFromStringBuffer(recording.m_texts[text++]);
+		}
 	}
 
 	const char* DrawCommandBuffer::allocateFromStringBuffer(const engine::string& text)
@@ -333,44 +364,51 @@ namespace ui
 			ListInUse = false;
 		};
 
+		m_drawStatistics = {};
+		m_drawStatistics.packets = static_cast<uint32_t>(m_commands.size());
+
+		engine::vector<Batch> batches;
+		buildBatches(batches);
+		m_drawStatistics.batches = static_cast<uint32_t>(batches.size());
+
 		TakeListInUse();
 		currentList.clearRenderTargetView(renderSetup->currentRTV(), { 0.0f, 0.0f, 0.0f, 1.0f });
+		currentList.setRenderTargets({ rtv });
 
 		//CPU_MARKER(apiCmd.api(), "UI Draw command buffer");
 		//GPU_MARKER(apiCmd, "UI Draw command buffer");
 
-		//engine::vector<PacketText> textPackets;
-		//engine::vector<engine::Rectangle> scissors;
-		for (auto&& packet : m_commands)
+		for (auto&& batch : batches)
 		{
-			switch (packet.type)
+			if (batch.type != BatchType::CommandList && !ListInUse)
 			{
-				case CommandType::Rectangle:
+				TakeListInUse();
+				currentList.setRenderTargets({ rtv });
+			}
+
+			switch (batch.type)
+			{
+				case BatchType::Rectangles:
 				{
-					if (!ListInUse) TakeListInUse();
-					recordRectangle(currentList, rtv, packet);
+					recordRectangles(currentList, rtv, batch);
 					break;
 				}
-				case CommandType::Image:
+				case BatchType::Glyphs:
 				{
-					if (!ListInUse) TakeListInUse();
-					recordImage(currentList, rtv, packet);
+					recordGlyphs(currentList, rtv, batch);
 					break;
 				}
-				case CommandType::Text:
+				case BatchType::Image:
 				{
-					if (!ListInUse) TakeListInUse();
-					recordText(currentList, rtv, packet);
-					//textPackets.emplace_back(packet.text);
-					//scissors.emplace_back(packet.scissor);
+					recordImage(currentList, rtv, *batch.packet);
 					break;
 				}
-				case CommandType::CommandList:
+				case BatchType::CommandList:
 				{
 					if (ListInUse) EndList();
 					RenderCommandList renderCommandList;
-					renderCommandList.cmdList = std::move(static_cast<PacketCommandList*>(packet.data)->cmdList);
-					renderCommandList.renderer = std::move(static_cast<PacketCommandList*>(packet.data)->renderer);
+					renderCommandList.cmdList = std::move(static_cast<PacketCommandList*>(batch.packet->data)->cmdList);
+					renderCommandList.renderer = std::move(static_cast<PacketCommandList*>(batch.packet->data)->renderer);
 					lists.emplace_back(std::move(renderCommandList));
 					break;
 				}
@@ -458,25 +496,6 @@ namespace ui
 		return m_transformStack.top();
 	}
 
-	void DrawCommandBuffer::recordRectangle(engine::CommandList& cmd, engine::TextureRTV rtv, const CommandPacket& packet)
-	{
-		CPU_MARKER(cmd.api(), "UI Rectangle");
-		GPU_MARKER(cmd, "UI Rectangle");
-
-		auto p = static_cast<PacketRectangle*>(packet.data);
-
-		cmd.setRenderTargets({ rtv });
-		cmd.setScissorRects({ packet.scissor });
-		m_drawRectangle.vs.screenSize = { static_cast<float>(rtv.width()), static_cast<float>(rtv.height()) };
-		m_drawRectangle.vs.x = p->x;
-		m_drawRectangle.vs.y = p->y;
-		m_drawRectangle.vs.width = p->width;
-		m_drawRectangle.vs.height = p->height;
-		m_drawRectangle.ps.color = { p->r, p->g, p->b, p->a };
-		cmd.bindPipe(m_drawRectangle);
-		cmd.draw(4);
-	}
-
 	void DrawCommandBuffer::recordImage(engine::CommandList& cmd, engine::TextureRTV rtv, const CommandPacket& packet)
 	{
 		CPU_MARKER(cmd.api(), "UI Image");
@@ -528,6 +547,8 @@ namespace ui
 			m_drawImage.ps.image = src;
 			cmd.bindPipe(m_drawImage);
 			cmd.draw(4);
+			++m_drawStatistics.pipelineBinds;
+			++m_drawStatistics.drawCalls;
 		}
 		else
 		{
@@ -542,6 +563,8 @@ namespace ui
 			m_drawImageUint.ps.size = { static_cast<float>(p->image->width()), static_cast<float>(p->image->height()) };
 			cmd.bindPipe(m_drawImageUint);
 			cmd.draw(4);
+			++m_drawStatistics.pipelineBinds;
+			++m_drawStatistics.drawCalls;
 		}
 	}
 
@@ -673,52 +696,233 @@ namespace ui
 #endif
 	}
 
-	void DrawCommandBuffer::recordText(engine::CommandList& cmd, engine::TextureRTV rtv, const CommandPacket& packet)
+	void DrawCommandBuffer::buildBatches(engine::vector<Batch>& batches)
 	{
-		CPU_MARKER(cmd.api(), "UI Text");
-		GPU_MARKER(cmd, "UI Text");
+		// a packet can join an earlier batch of the same kind when nothing
+		// drawn after that batch overlaps it. the look back is bounded so
+		// deep interleaving doesn't go quadratic
+		constexpr size_t MaxBatchLookBack = 32;
 
-		auto p = static_cast<PacketText*>(packet.data);
+		auto overlaps = [](const engine::Rectangle& a, const engine::Rectangle& b)->bool
+		{
+			return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+		};
 
-		if (!p->text || strlen(p->text) == 0 || p->text[0] == '\n')
-			return;
+		auto grow = [](engine::Rectangle& bounds, const engine::Rectangle& rect)
+		{
+			bounds.left = std::min(bounds.left, rect.left);
+			bounds.top = std::min(bounds.top, rect.top);
+			bounds.right = std::max(bounds.right, rect.right);
+			bounds.bottom = std::max(bounds.bottom, rect.bottom);
+		};
 
-		//engine::vector<engine::Font::GlyphRenderNodeData> allGlyphs;
-		engine::vector<engine::Vector2f> glyphPositions;
-		auto grenderData = m_font->renderText(p->text);
-		// handle changed texture
-		//allGlyphs.reserve(allGlyphs.size() + std::distance(grenderData.nodes.begin(), grenderData.nodes.end()));
-		//allGlyphs.insert(allGlyphs.end(), grenderData.nodes.begin(), grenderData.nodes.end());
+		auto findBatch = [&](BatchType type, const engine::TextureSRV& texture, const engine::Rectangle& bounds)->Batch&
+		{
+			for (size_t i = 0; i < batches.size() && i < MaxBatchLookBack; ++i)
+			{
+				auto& batch = batches[batches.size() - 1 - i];
+				if (batch.type == type && batch.texture == texture)
+				{
+					grow(batch.bounds, bounds);
+					return batch;
+				}
+				if (batch.type == BatchType::CommandList || overlaps(batch.bounds, bounds))
+					break;
+			}
+			batches.emplace_back(Batch{ type, bounds, texture });
+			return batches.back();
+		};
 
-		glyphPositions.reserve(glyphPositions.size() + grenderData.nodeCount);
-		for (int i = 0; i < grenderData.nodeCount; ++i)
-			glyphPositions.insert(glyphPositions.end(), engine::Vector2f{ static_cast<float>(p->x), static_cast<float>(p->y) });
+		// lay out all the strings in one go
+		auto validText = [](const PacketText* p)->bool
+		{
+			return p->text && strlen(p->text) > 0 && p->text[0] != '\n';
+		};
+		engine::vector<const char*> texts;
+		for (auto&& packet : m_commands)
+			if (packet.type == CommandType::Text && validText(static_cast<PacketText*>(packet.data)))
+				texts.emplace_back(static_cast<PacketText*>(packet.data)->text);
+		engine::vector<engine::Font::GlyphRenderData> textRuns;
+		engine::vector<uint32_t> textFirstRun;
+		if (texts.size() > 0)
+			m_font->renderTexts(texts.data(), texts.size(), textRuns, textFirstRun);
+		size_t textIndex = 0;
 
-		auto alloc = m_uploadRing.allocate(grenderData.nodeCount);
+		for (auto&& packet : m_commands)
+		{
+			switch (packet.type)
+			{
+				case CommandType::Rectangle:
+				{
+					// solid rectangles are clipped here so they don't need a scissor
+					auto p = static_cast<PacketRectangle*>(packet.data);
+					engine::Rectangle rect = engine::Rectangle{ p->x, p->y, p->x + p->width, p->y + p->height }.intersect(packet.scissor);
+					if (rect.left >= rect.right || rect.top >= rect.bottom)
+						break;
+
+					auto& batch = findBatch(BatchType::Rectangles, engine::TextureSRV(), rect);
+					batch.rectangles.emplace_back(ColoredRectangleItem{
+						float2{ static_cast<float>(rect.left), static_cast<float>(rect.top) },
+						float2{ static_cast<float>(rect.right - rect.left), static_cast<float>(rect.bottom - rect.top) },
+						float4{ p->r, p->g, p->b, p->a } });
+					break;
+				}
+				case CommandType::Image:
+				{
+					auto p = static_cast<PacketImage*>(packet.data);
+					engine::Rectangle rect = engine::Rectangle{ p->x, p->y, p->x + p->width, p->y + p->height }.intersect(packet.scissor);
+					if (rect.left >= rect.right || rect.top >= rect.bottom)
+						break;
+
+					batches.emplace_back(Batch{ BatchType::Image, rect });
+					batches.back().packet = &packet;
+					break;
+				}
+				case CommandType::Text:
+				{
+					auto p = static_cast<PacketText*>(packet.data);
+					if (!validText(p))
+						break;
+
+					// one run per atlas page the string uses
+					auto firstRun = textFirstRun[textIndex];
+					auto lastRun = textFirstRun[textIndex + 1];
+					++textIndex;
+					for (auto run = firstRun; run < lastRun; ++run)
+					{
+						auto& grenderData = textRuns[run];
+
+						// glyph quads are clipped to the scissor. uvs follow the clipped edges
+						engine::vector<engine::Font::GlyphRenderNodeData> glyphs;
+						glyphs.reserve(grenderData.nodeCount);
+						engine::Rectangle bounds{ packet.scissor.right, packet.scissor.bottom, packet.scissor.left, packet.scissor.top };
+						for (int i = 0; i < grenderData.nodeCount; ++i)
+						{
+							auto glyph = grenderData.nodes[i];
+
+							// same placement as DrawText.vs.hlsl
+							float left = glyph.dstPosition.x * 0.5f + static_cast<float>(p->x) + 2.0f;
+							float top = glyph.dstPosition.y * 0.5f + static_cast<float>(p->y) - 2.0f;
+							float width = glyph.size.x * 0.5f;
+							float height = glyph.size.y * 0.5f;
+							if (width <= 0.0f || height <= 0.0f)
+								continue;
+
+							float clipLeft = std::max(left, static_cast<float>(packet.scissor.left));
+							float clipTop = std::max(top, static_cast<float>(packet.scissor.top));
+							float clipRight = std::min(left + width, static_cast<float>(packet.scissor.right));
+							float clipBottom = std::min(top + height, static_cast<float>(packet.scissor.bottom));
+							if (clipLeft >= clipRight || clipTop >= clipBottom)
+								continue;
+
+							auto uvSize = glyph.uvBottomRight - glyph.uvTopLeft;
+							engine::Vector2f uvTopLeft{
+								glyph.uvTopLeft.x + uvSize.x * ((clipLeft - left) / width),
+								glyph.uvTopLeft.y + uvSize.y * ((clipTop - top) / height) };
+							engine::Vector2f uvBottomRight{
+								glyph.uvTopLeft.x + uvSize.x * ((clipRight - left) / width),
+								glyph.uvTopLeft.y + uvSize.y * ((clipBottom - top) / height) };
+
+							glyph.uvTopLeft = uvTopLeft;
+							glyph.uvBottomRight = uvBottomRight;
+							glyph.size = { (clipRight - clipLeft) * 2.0f, (clipBottom - clipTop) * 2.0f };
+							glyph.dstPosition = {
+								(clipLeft - static_cast<float>(p->x) - 2.0f) * 2.0f,
+								(clipTop - static_cast<float>(p->y) + 2.0f) * 2.0f };
+							glyphs.emplace_back(glyph);
+
+							grow(bounds, engine::Rectangle{
+								static_cast<int>(std::floor(clipLeft)), static_cast<int>(std::floor(clipTop)),
+								static_cast<int>(std::ceil(clipRight)), static_cast<int>(std::ceil(clipBottom)) });
+						}
+						if (glyphs.size() == 0)
+							continue;
+
+						auto& batch = findBatch(BatchType::Glyphs, grenderData.texture, bounds);
+						batch.glyphs.insert(batch.glyphs.end(), glyphs.begin(), glyphs.end());
+						batch.glyphPositions.insert(batch.glyphPositions.end(), glyphs.size(),
+							engine::Vector2f{ static_cast<float>(p->x), static_cast<float>(p->y) });
+					}
+					break;
+				}
+				case CommandType::CommandList:
+				{
+					batches.emplace_back(Batch{ BatchType::CommandList, packet.scissor });
+					batches.back().packet = &packet;
+					break;
+				}
+			}
+		}
+	}
+
+	void DrawCommandBuffer::recordRectangles(engine::CommandList& cmd, engine::TextureRTV rtv, const Batch& batch)
+	{
+		CPU_MARKER(cmd.api(), "UI Rectangles");
+		GPU_MARKER(cmd, "UI Rectangles");
+
+		auto count = batch.rectangles.size();
+		auto alloc = m_coloredRectanglesUploadRing.allocate(count);
+		ASSERT(alloc.size > 0, "Ran out of UI rectangle upload space");
+		auto offset = m_coloredRectanglesUploadRing.offset(alloc.ptr);
+		memcpy(
+			m_coloredRectanglesUploadPtr + offset,
+			batch.rectangles.data(),
+			sizeof(ColoredRectangleItem) * count);
+
+		cmd.setScissorRects({ engine::Rectangle{ 0, 0, static_cast<int>(rtv.width()), static_cast<int>(rtv.height()) } });
+		m_drawColoredRectangles.vs.rectangles = m_coloredRectanglesUploadBufferSRV;
+		m_drawColoredRectangles.vs.screenSize = { static_cast<float>(rtv.width()), static_cast<float>(rtv.height()) };
+		m_drawColoredRectangles.vs.startIndex = static_cast<uint32_t>(offset);
+		cmd.bindPipe(m_drawColoredRectangles);
+		cmd.draw(6 * count);
+		++m_drawStatistics.pipelineBinds;
+		++m_drawStatistics.drawCalls;
+
+		m_coloredRectanglesUploadRing.free(alloc);
+	}
+
+	void DrawCommandBuffer::recordGlyphs(engine::CommandList& cmd, engine::TextureRTV rtv, const Batch& batch)
+	{
+		CPU_MARKER(cmd.api(), "UI Text");
+		GPU_MARKER(cmd, "UI Text");
+
+		auto count = batch.glyphs.size();
+		auto alloc = m_uploadRing.allocate(count);
+		ASSERT(alloc.size > 0, "Ran out of UI glyph upload space");
 		auto offset = m_uploadRing.offset(alloc.ptr);
 		memcpy(
 			m_uploadPtr + offset,
-			&grenderData.nodes[0],
-			sizeof(engine::Font::GlyphRenderNodeData) * grenderData.nodeCount);
-
-		cmd.setRenderTargets({ rtv });
-		cmd.setScissorRects({ packet.scissor });
-		m_drawTextSimple.vs.screenSize = { static_cast<float>(rtv.width()), static_cast<float>(rtv.height()) };
-		m_drawTextSimple.vs.x = 0;
-		m_drawTextSimple.vs.y = 0;
-		m_drawTextSimple.vs.width = static_cast<float>(grenderData.texture.width());
-		m_drawTextSimple.vs.height = static_cast<float>(grenderData.texture.height());
-		m_drawTextSimple.vs.flipUV = { 0, 0 };
-		m_drawTextSimple.vs.startIndex.x = static_cast<uint32_t>(offset);
-		m_drawTextSimple.vs.startIndex.y = 0;
-		m_drawTextSimple.vs.glyphs = m_uploadBufferSRV;
-		m_drawTextSimple.vs.position = float2{ static_cast<float>(p->x), static_cast<float>(p->y) };
-
-		m_drawTextSimple.ps.image = grenderData.texture;
-		m_drawTextSimple.ps.color = { 1.0f, 1.0f, 1.0f, 1.0f };
-		cmd.bindPipe(m_drawTextSimple);
-		cmd.draw(6 * grenderData.nodeCount);
+			batch.glyphs.data(),
+			sizeof(engine::Font::GlyphRenderNodeData) * count);
+
+		auto positionAlloc = m_glyphPositionsUploadRing.allocate(count);
+		ASSERT(positionAlloc.size > 0, "Ran out of UI glyph position upload space");
+		auto positionOffset = m_glyphPositionsUploadRing.offset(positionAlloc.ptr);
+		memcpy(
+			m_glyphPositionsUploadPtr + positionOffset,
+			batch.glyphPositions.data(),
+			sizeof(engine::Vector2f) * count);
+
+		cmd.setScissorRects({ engine::Rectangle{ 0, 0, static_cast<int>(rtv.width()), static_cast<int>(rtv.height()) } });
+		m_drawText.vs.screenSize = { static_cast<float>(rtv.width()), static_cast<float>(rtv.height()) };
+		m_drawText.vs.x = 0;
+		m_drawText.vs.y = 0;
+		m_drawText.vs.width = static_cast<float>(batch.texture.width());
+		m_drawText.vs.height = static_cast<float>(batch.texture.height());
+		m_drawText.vs.flipUV = { 0, 0 };
+		m_drawText.vs.startIndex.x = static_cast<uint32_t>(offset);
+		m_drawText.vs.startIndex.y = static_cast<uint32_t>(positionOffset);
+		m_drawText.vs.glyphs = m_uploadBufferSRV;
+		m_drawText.vs.glyphPositions = m_glyphPositionsUploadBufferSRV;
+
+		m_drawText.ps.image = batch.texture;
+		m_drawText.ps.color = { 1.0f, 1.0f, 1.0f, 1.0f };
+		cmd.bindPipe(m_drawText);
+		cmd.draw(6 * count);
+		++m_drawStatistics.pipelineBinds;
+		++m_drawStatistics.drawCalls;
 
 		m_uploadRing.free(alloc);
+		m_glyphPositionsUploadRing.free(positionAlloc);
 	}
 }
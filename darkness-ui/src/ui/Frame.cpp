@@ -60,9 +60,53 @@ namespace ui
 
 	void Frame::themeSet(bool value)
 	{
+		if (m_themeSet != value)
+			markDirty();
 		m_themeSet = value;
 	}
 
+	void Frame::drawBackground(bool val)
+	{
+		if (m_drawBackground != val)
+			markDirty();
+		m_drawBackground = val;
+	}
+
+	void Frame::markDirty()
+	{
+		// all the way up. a parent replays the commands of its childs
+		for (auto frame = this; frame; frame = frame->getParent())
+			frame->m_dirty = true;
+	}
+
+	void Frame::retained(bool val)
+	{
+		m_retained = val;
+		markDirty();
+	}
+
+	DrawCommandBuffer::RetainedStatistics Frame::retainedStatistics() const
+	{
+		if (m_rootFrame && m_rootFrame->cmd)
+			return m_rootFrame->cmd->retainedStatistics();
+		return {};
+	}
+
+	void Frame::onLayoutChange()
+	{
+		markDirty();
+	}
+
+	void Frame::onLayerOrderChange()
+	{
+		markDirty();
+	}
+
+	void Frame::onChildsChanged()
+	{
+		markDirty();
+	}
+
 	engine::Device& Frame::device()
 	{
 		if (m_rootFrame && m_rootFrame->rendering)
@@ -140,11 +184,13 @@ namespace ui
 
 	void Frame::backgroundColor(const engine::Vector3f& color)
 	{
-		m_backgroundColor = engine::Vector4f(color, 1.0f);
+		backgroundColor(engine::Vector4f(color, 1.0f));
 	}
 
 	void Frame::backgroundColor(const engine::Vector4f& color)
 	{
+		if (m_backgroundColor != color)
+			markDirty();
 		m_backgroundColor = color;
 	}
 
@@ -312,25 +358,48 @@ namespace ui
 	void Frame::render(DrawCommandBuffer* cmd)
 	{
 		bool pushedTransform = false;
-		if (m_rootFrame && m_rootFrame->rendering)
+		bool renderingRoot = m_rootFrame && m_rootFrame->rendering;
+		if (renderingRoot)
 		{
 			cmd = m_rootFrame->cmd.get();
 			ASSERT(!cmd->isOpen(), "Trying to reuse a commandlist that is already in use");
 			cmd->open();
-			cmd->reset();
+			cmd->retainedStatistics() = {};
 
 			auto gp = getGlobalPositionToLastRootFrame();
-			cmd->pushTransform(DrawCommandBuffer::GlobalTransform{ 
+			DrawCommandBuffer::GlobalTransform transform{
 				gp.x, gp.y, this->width(), this->height(),
-				gp.x, gp.y, this->width(), this->height() });
+				gp.x, gp.y, this->width(), this->height() };
+
+			if (canReplay(transform) && cmd->replayable())
+			{
+				// nothing changed. last frames commands are still in the buffer
+				++cmd->retainedStatistics().replayed;
+				submit(cmd);
+				return;
+			}
+
+			cmd->reset();
+			cmd->pushTransform(transform);
 			pushedTransform = true;
 		}
+		else if (canReplay(cmd->currentTransform()))
+		{
+			cmd->replay(m_recording);
+			++cmd->retainedStatistics().replayed;
+			return;
+		}
 		else if (m_rootFrame)
 		{
 			//auto gp = getGlobalPosition();
 			//cmd->pushTransform(DrawCommandBuffer::GlobalTransform{ gp.x, gp.y, this->width(), this->height() });
 		}
 
+		auto recordedTransform = cmd->currentTransform();
+		auto recordingMark = cmd->recordingMark();
+		bool volatileContent = !m_retained;
+		++cmd->retainedStatistics().recorded;
+
 #if 1
 		//auto gp = (m_rootFrame && !m_rootFrame->rendering) ? getGlobalPosition() : getGlobalPositionToLastRootFrame();
 		//engine::Rectangle clientScissor{ 
@@ -383,6 +452,11 @@ namespace ui
 			{
 
 				frame->render(cmd);
+
+				// child windows with their own device render and blit every frame
+				if (frame->m_volatile || (frame->m_rootFrame && frame->m_rootFrame->rendering))
+					volatileContent = true;
+
 				//#ifdef SINGLE_THREADED_ENGINE_FRAME
 				if (api() == frame->api() && frame->m_rootFrame && frame->m_rootFrame->rendering)
 				{
@@ -439,25 +513,20 @@ namespace ui
 			cmd->popTransform();
 		}
 
-		if (m_rootFrame && m_rootFrame->rendering)
-		{
-			// close and present the client commandlist
-			cmd->close();
-			auto apiCommandLists = cmd->recordCommands(m_rootFrame->rendering.get(), m_rootFrame->rendering->currentRTV());
+		if (!renderingRoot && !volatileContent)
+			volatileContent = !cmd->capture(recordingMark, m_recording);
+		else if (renderingRoot && !volatileContent)
+			volatileContent = !cmd->replayable();
 
-			for (auto&& apiCmd : apiCommandLists)
-			{
-				if (apiCmd.renderer)
-				{
-					apiCmd.renderer->submit(apiCmd.cmdList);
-					apiCmd.renderer->present(true);
-				}
-				else
-					m_rootFrame->rendering->submitBlocking(apiCmd.cmdList);
-			}
+		m_volatile = volatileContent;
+		m_dirty = volatileContent;
+		m_recordedTransform = recordedTransform;
+		m_themeGeneration = Theme::instance().generation();
+		if (volatileContent)
+			m_recording.clear();
 
-			m_rootFrame->rendering->present(false);
-		}
+		if (renderingRoot)
+			submit(cmd);
 		//else
 		//	return cmd;
 
@@ -471,4 +540,44 @@ namespace ui
 			//cmd->popTransform();
 		}
 	}
+
+	void Frame::submit(DrawCommandBuffer* cmd)
+	{
+		// close and present the client commandlist
+		cmd->close();
+		auto apiCommandLists = cmd->recordCommands(m_rootFrame->rendering.get(), m_rootFrame->rendering->currentRTV());
+
+		for (auto&& apiCmd : apiCommandLists)
+		{
+			if (apiCmd.renderer)
+			{
+				apiCmd.renderer->submit(apiCmd.cmdList);
+				apiCmd.renderer->present(true);
+			}
+			else
+				m_rootFrame->rendering->submitBlocking(apiCmd.cmdList);
+		}
+
+		m_rootFrame->rendering->present(false);
+	}
+
+	bool Frame::canReplay(const DrawCommandBuffer::GlobalTransform& transform) const
+	{
+		if (m_dirty || !m_retained || m_volatile)
+			return false;
+
+		if (m_themeGeneration != Theme::instance().generation())
+			return false;
+
+		// recorded packets are in root frame coordinates and clipped
+		return
+			m_recordedTransform.objectX == transform.objectX &&
+			m_recordedTransform.objectY == transform.objectY &&
+			m_recordedTransform.objectWidth == transform.objectWidth &&
+			m_recordedTransform.objectHeight == transform.objectHeight &&
+			m_recordedTransform.clipX == transform.clipX &&
+			m_recordedTransform.clipY == transform.clipY &&
+			m_recordedTransform.clipWidth == transform.clipWidth &&
+			m_recordedTransform.clipHeight == transform.clipHeight;
+	}
 }
@@ -8,6 +8,7 @@ namespace ui
 	void Theme::loadSettings(const engine::string& themeFilePath)
 	{
 		m_settings = engine::make_shared<tools::Settings>(themeFilePath);
+		++m_generation;
 	}
 
 	engine::string Theme::image(const engine::string& assetName)
@@ -89,8 +89,11 @@ namespace ui
             area().position().x != point.x ||
             area().position().y != point.y;
         area().position(point);
-        if(positionChange)
+        if (positionChange)
+        {
+            onLayoutChange();
             onMove(point.x, point.y);
+        }
     }
 
     void UiAnchors::position(int x, int y)
@@ -99,8 +102,11 @@ namespace ui
             area().position().x != x ||
             area().position().y != y;
         area().position(x, y);
-        if(positionChange)
+        if (positionChange)
+        {
+            onLayoutChange();
             onMove(x, y);
+        }
     }
 
     void UiAnchors::size(const UiPoint& size)
@@ -112,7 +118,8 @@ namespace ui
             localSize.y = m_minimumSize.y;
 
         area().size(localSize);
-        
+        onLayoutChange();
+
         propagateChanges(
             static_cast<unsigned int>(AnchorType::Right) |
             static_cast<unsigned int>(AnchorType::Bottom) |
@@ -130,7 +137,10 @@ namespace ui
         area().x(val);
 
         if (positionChange)
+        {
+            onLayoutChange();
             onMove(val, area().position().y);
+        }
     }
 
     void UiAnchors::y(int val)
@@ -139,12 +149,16 @@ namespace ui
         area().y(val);
 
         if (positionChange)
+        {
+            onLayoutChange();
             onMove(area().position().x, val);
+        }
     }
 
     void UiAnchors::width(int val)
     {
         area().width(val);
+        onLayoutChange();
         propagateChanges(
             static_cast<unsigned int>(AnchorType::Right) |
             static_cast<unsigned int>(AnchorType::Left));
@@ -157,6 +171,7 @@ namespace ui
     void UiAnchors::height(int val)
     {
         area().height(val);
+        onLayoutChange();
         propagateChanges(
             static_cast<unsigned int>(AnchorType::Bottom) |
             static_cast<unsigned int>(AnchorType::Top));
@@ -169,18 +184,21 @@ namespace ui
     void UiAnchors::left(int val)
     {
         area().left(val);
+        onLayoutChange();
         //propagateChanges(static_cast<unsigned int>(AnchorType::Left));
     }
 
     void UiAnchors::top(int val)
     {
         area().top(val);
+        onLayoutChange();
         //propagateChanges(static_cast<unsigned int>(AnchorType::Top));
     }
 
     void UiAnchors::right(int val)
     {
         area().right(val);
+        onLayoutChange();
         propagateChanges(
             static_cast<unsigned int>(AnchorType::Right) |
             static_cast<unsigned int>(AnchorType::Left));
@@ -193,6 +211,7 @@ namespace ui
     void UiAnchors::bottom(int val)
     {
         area().bottom(val);
+        onLayoutChange();
         propagateChanges(
             static_cast<unsigned int>(AnchorType::Bottom) |
             static_cast<unsigned int>(AnchorType::Top));
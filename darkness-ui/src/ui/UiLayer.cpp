@@ -38,6 +38,7 @@ namespace ui
             auto alwaysOntopIndex = IndexOfBeginningOfAlwaysOntop();
             MoveSelfToIndex(alwaysOntopIndex);
         }
+        onLayerOrderChange();
 
         
 
@@ -103,6 +104,7 @@ namespace ui
                 }
             }
         }
+        onLayerOrderChange();
     }
 
     void UiBaseLayer::moveDown()
@@ -119,6 +121,7 @@ namespace ui
                 m_parent->childs().insert(m_parent->childs().begin() + i - 1, temp);
             }
         }
+        onLayerOrderChange();
     }
 
     void UiBaseLayer::moveToBottom()
@@ -135,6 +138,6 @@ namespace ui
                 m_parent->childs().insert(m_parent->childs().begin(), temp);
             }
         }
-        
+        onLayerOrderChange();
     }
 }
@@ -337,7 +337,7 @@ namespace ui
 
                     if (item)
                     {
-                        item->area().y(static_cast<int>(drawPosition));
+                        item->y(static_cast<int>(drawPosition));
 
                         if (color)
                             item->backgroundColor(engine::Vector3f{ 0.133f, 0.137f, 0.141f });
@@ -21,6 +21,8 @@ namespace ui
 
 	void UiScrollBarHandle::setHover(bool hover)
 	{
+		if (m_hover != hover)
+			markDirty();
 		m_hover = hover;
 	}
 